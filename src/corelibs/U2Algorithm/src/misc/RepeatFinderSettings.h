@@ -32,7 +32,8 @@ class DNAAlphabet;
 enum RFAlgorithm {
     RFAlgorithm_Auto,
     RFAlgorithm_Diagonal,
-    RFAlgorithm_Suffix
+    RFAlgorithm_Suffix,
+    RFAlgorithm_KMer
 };
 
 enum RepeatsFilterAlgorithm
@@ -21,6 +21,7 @@
 
 #include "VanDerWaalsSurface.h"
 #include "MolecularSurfaceFactoryRegistry.h"
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -42,6 +43,7 @@ bool MolecularSurfaceFactoryRegistry::registerSurfaceFactory( MolecularSurfaceFa
         return false;
     }
     surfMap.insert(surfId, surf);
+    PluginSupport::reportRegistry("MolecularSurfaceFactoryRegistry");
     return true;
 
 }
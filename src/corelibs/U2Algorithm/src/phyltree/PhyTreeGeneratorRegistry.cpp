@@ -20,6 +20,7 @@
  */
 
 #include <U2Algorithm/PhyTreeGeneratorRegistry.h>
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -39,6 +40,7 @@ namespace U2 {
             return false;
         }
         genMap.insert(gen_id, generator);
+        PluginSupport::reportRegistry("PhyTreeGeneratorRegistry");
         return true;
 
     }
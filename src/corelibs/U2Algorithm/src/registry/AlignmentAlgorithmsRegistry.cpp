@@ -25,6 +25,7 @@
 #include "../msa_alignment/SimpleAddingToAlignment.h"
 
 #include <QtCore/QMutexLocker>
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -43,6 +44,7 @@ bool AlignmentAlgorithmsRegistry::registerAlgorithm(AlignmentAlgorithm* alg) {
         return false;
     }
     algorithms.insert(alg->getId(), alg);
+    PluginSupport::reportRegistry("AlignmentAlgorithmsRegistry");
     return true;
 
 }
@@ -22,6 +22,7 @@
 #include "DnaAssemblyAlgRegistry.h"
 
 #include <U2Algorithm/DnaAssemblyTask.h>
+#include <U2Core/PluginModel.h>
 #include <U2View/DnaAssemblyGUIExtension.h>
 
 namespace U2 {
@@ -64,6 +65,7 @@ bool DnaAssemblyAlgRegistry::registerAlgorithm(DnaAssemblyAlgorithmEnv* algo) {
         return false;
     }
     algorithms.insert(algo->getId(), algo);
+    PluginSupport::reportRegistry("DnaAssemblyAlgRegistry");
     return true;
 
 }
@@ -20,6 +20,7 @@
  */
 
 #include "GenomeAssemblyRegistry.h"
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -83,6 +84,7 @@ bool GenomeAssemblyAlgRegistry::registerAlgorithm(GenomeAssemblyAlgorithmEnv* al
         return false;
     }
     algorithms.insert(algo->getId(), algo);
+    PluginSupport::reportRegistry("GenomeAssemblyAlgRegistry");
     return true;
 
 }
@@ -24,6 +24,8 @@
 #include <QMutexLocker>
 #include <QStringList>
 
+#include <U2Core/PluginModel.h>
+
 
 namespace U2 {
 
@@ -48,6 +50,7 @@ bool RepeatFinderTaskFactoryRegistry::registerFactory(
         return false;
     }
     factories[factoryId] = factory;
+    PluginSupport::reportRegistry("RepeatFinderTaskFactoryRegistry");
     return true;
 }
 
@@ -22,6 +22,7 @@
 #include <U2Algorithm/SecStructPredictTask.h>
 #include "SecStructPredictAlgRegistry.h"
 #include <QtCore/QStringList>
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -46,6 +47,7 @@ bool SecStructPredictAlgRegistry::registerAlgorithm( SecStructPredictTaskFactory
         return false;
     }
     algMap.insert(algId, alg);
+    PluginSupport::reportRegistry("SecStructPredictAlgRegistry");
     return true;
 
 }
@@ -21,6 +21,7 @@
 
 #include "SplicedAlignmentTaskRegistry.h"
 #include "SplicedAlignmentTask.h"
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -45,6 +46,7 @@ bool SplicedAlignmentTaskRegistry::registerTaskFactory( SplicedAlignmentTaskFact
         return false;
     }
     algMap.insert(algId, alg);
+    PluginSupport::reportRegistry("SplicedAlignmentTaskRegistry");
     return true;
 
 }
@@ -32,6 +32,14 @@ class SmithWatermanTaskFactory {            //for ADV search only
 public:
     virtual Task* getTaskInstance(const SmithWatermanSettings& config,
                                   const QString& taskName) const = 0;
+    // Returns one task running all the searches described by @configs with a shared set of threads.
+    // Each search keeps only @maxResults best results (0 - all of them).
+    // NULL means the realization has no bulk mode and the searches should be run one by one
+    virtual Task* getBulkTaskInstance(const QList<SmithWatermanSettings>& configs, int maxResults,
+                                      const QString& taskName) const {
+        Q_UNUSED(configs); Q_UNUSED(maxResults); Q_UNUSED(taskName);
+        return NULL;
+    }
     virtual bool hasAdvancedSettings() const { return false; }
     virtual void execAdvancedDialog() {}
     virtual ~SmithWatermanTaskFactory() {}
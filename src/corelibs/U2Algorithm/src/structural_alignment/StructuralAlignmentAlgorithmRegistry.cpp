@@ -21,6 +21,7 @@
 
 #include "StructuralAlignmentAlgorithmRegistry.h"
 #include "StructuralAlignmentAlgorithmFactory.h"
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -40,6 +41,7 @@ StructuralAlignmentAlgorithmRegistry::~StructuralAlignmentAlgorithmRegistry() {
 void StructuralAlignmentAlgorithmRegistry::registerAlgorithmFactory(StructuralAlignmentAlgorithmFactory *factory, const QString &id) {
     assert(!factories.contains(id));
     factories.insert(id, factory);
+    PluginSupport::reportRegistry("StructuralAlignmentAlgorithmRegistry");
 }
 
 StructuralAlignmentAlgorithmFactory* StructuralAlignmentAlgorithmRegistry::getAlgorithmFactory(const QString &id) {
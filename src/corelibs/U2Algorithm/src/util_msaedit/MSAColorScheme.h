@@ -136,6 +136,9 @@ public:
     MSAColorScheme(QObject* p, MSAColorSchemeFactory* f, MAlignmentObject* o);
     //Get color for symbol "c" on position [seq, pos]. Variable "c" has been added for optimization.
     virtual QColor getColor(int seq, int pos, char c) = 0;
+    //Returns colors indexed by symbol code if the color doesn't depend on the symbol position, otherwise an empty vector.
+    //Renderers use it as a lookup table instead of calling "getColor" for every symbol.
+    virtual QVector<QColor> getColorsPerChar() const {return QVector<QColor>();}
     MSAColorSchemeFactory* getFactory() const {return factory;}
 
     static const QString EMPTY_NUCL;
@@ -170,6 +173,7 @@ class U2ALGORITHM_EXPORT MSAColorSchemeStatic : public MSAColorScheme {
 public:
     MSAColorSchemeStatic(QObject* p, MSAColorSchemeFactory* f, MAlignmentObject* o, const QVector<QColor>& colorsPerChar);
     virtual QColor getColor(int seq, int pos, char c);
+    virtual QVector<QColor> getColorsPerChar() const {return colorsPerChar;}
 private:
 
     QVector<QColor> colorsPerChar;
@@ -21,21 +21,45 @@
 
 #include "ORFAlgorithmTask.h"
 
+#include <U2Core/AppResources.h>
 #include <U2Core/TextUtils.h>
 #include <U2Core/DNATranslation.h>
 #include <U2Core/Counter.h>
+#include <U2Core/U2SafePoints.h>
 
 namespace U2 {
 
+const qint64 ORFFindTask::CHUNK_SIZE = 4 * 1024 * 1024;
+
 ORFFindTask::ORFFindTask(const ORFAlgorithmSettings& s,const U2EntityRef& _entityRef)
-: Task (tr("ORF find"), TaskFlag_None),config(s),entityRef(_entityRef)
+: Task (tr("ORF find"), TaskFlags_FOSE_COSC),config(s),entityRef(_entityRef),resultsCount(0)
 {
     GCOUNTER( cvar, tvar, "ORFFindTask" );
     tpm = Progress_Manual;
     assert(config.proteinTT && config.proteinTT->isThree2One());
 }
 
+void ORFFindTask::prepare() {
+    CHECK(config.searchRegion.length >= 2 * CHUNK_SIZE, );
+
+    tpm = Progress_SubTasksBased;
+    for (qint64 pos = config.searchRegion.startPos; pos < config.searchRegion.endPos(); pos += CHUNK_SIZE) {
+        const U2Region chunk(pos, qMin(CHUNK_SIZE, config.searchRegion.endPos() - pos));
+        chunkTasks << new ORFFindChunkTask(this, entityRef, chunk);
+        addSubTask(chunkTasks.last());
+    }
+    setMaxParallelSubtasks(AppResourcePool::instance()->getIdealThreadCount());
+}
+
 void ORFFindTask::run(){
+    if (!chunkTasks.isEmpty()) {
+        QList<ORFChunkBorders> borders;
+        foreach (ORFFindChunkTask* chunkTask, chunkTasks) {
+            borders << chunkTask->getBorders();
+        }
+        ORFFindAlgorithm::joinChunks(this, config, entityRef, borders, stateInfo.cancelFlag);
+        return;
+    }
     ORFFindAlgorithm::find(dynamic_cast<ORFFindResultsListener*>(this),
     config,
     entityRef,
@@ -44,14 +68,15 @@ void ORFFindTask::run(){
 }
 
 void ORFFindTask::onResult(const ORFFindResult& r, U2OpStatus& os) {
-    QMutexLocker locker(&lock);
-    if(config.isResultsLimited){
-        if (newResults.size() >= config.maxResult2Search) {
+    // every chunk checks the same counter, so the limit is common for the whole search
+    if (config.isResultsLimited && resultsCount.fetchAndAddOrdered(1) >= config.maxResult2Search) {
+        if (!os.isCanceled()) {
             os.setCanceled(true);
             algoLog.info(QString("Max result {%1} is achieved").arg(config.maxResult2Search));
-            return;
         }
+        return;
     }
+    QMutexLocker locker(&lock);
     assert((r.region.length + r.joinedRegion.length) % 3 == 0);
     newResults.append(r);
 }
@@ -64,5 +89,21 @@ QList<ORFFindResult> ORFFindTask::popResults() {
     return res;
 }
 
+ORFFindChunkTask::ORFFindChunkTask(ORFFindTask* _parentTask, const U2EntityRef& _entityRef, const U2Region& _chunk)
+: Task(tr("ORF find in region %1").arg(_chunk.toString()), TaskFlag_None), parentTask(_parentTask), entityRef(_entityRef), chunk(_chunk)
+{
+    tpm = Progress_Manual;
+}
+
+void ORFFindChunkTask::run() {
+    ORFFindAlgorithm::findInChunk(parentTask,
+        parentTask->getSettings(),
+        entityRef,
+        chunk,
+        borders,
+        stateInfo.cancelFlag,
+        stateInfo.progress);
+}
+
 } //namespace
 
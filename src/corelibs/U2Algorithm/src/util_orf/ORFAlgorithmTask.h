@@ -28,26 +28,51 @@
 
 #include "ORFFinder.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QMutex>
 
 namespace U2 {
 
+class ORFFindChunkTask;
+
 class U2ALGORITHM_EXPORT ORFFindTask : public Task, public ORFFindResultsListener {
     Q_OBJECT
 public:
     ORFFindTask(const ORFAlgorithmSettings& s,const U2EntityRef& entityRef);
 
+    virtual void prepare();
     virtual void run();
     virtual void onResult(const ORFFindResult& r, U2OpStatus& oss);
 
     QList<ORFFindResult> popResults();
 
     const ORFAlgorithmSettings& getSettings() const {return config;}
+
+    // long regions are split into chunks that are searched in parallel
+    static const qint64 CHUNK_SIZE;
+
 private:
     ORFAlgorithmSettings config;
     U2EntityRef entityRef;
     QList<ORFFindResult> newResults;
     QMutex lock;
+    // results of all chunks, popResults() doesn't reset it
+    QAtomicInt resultsCount;
+    QList<ORFFindChunkTask*> chunkTasks;
+};
+
+class U2ALGORITHM_EXPORT ORFFindChunkTask : public Task {
+    Q_OBJECT
+public:
+    ORFFindChunkTask(ORFFindTask* parentTask, const U2EntityRef& entityRef, const U2Region& chunk);
+
+    virtual void run();
+    const ORFChunkBorders& getBorders() const {return borders;}
+private:
+    ORFFindTask* parentTask;
+    U2EntityRef entityRef;
+    U2Region chunk;
+    ORFChunkBorders borders;
 };
 
 
@@ -41,6 +41,12 @@ const QString ORFAlgorithmSettings::STRAND_BOTH("both strands");
 const QString ORFAlgorithmSettings::STRAND_DIRECT("direct");
 const QString ORFAlgorithmSettings::STRAND_COMPL("complement");
 
+ORFStrandBorders::ORFStrandBorders() {
+    for (int frame = 0; frame < 3; frame++) {
+        firstStop[frame] = -1;
+    }
+}
+
 static bool isDirect(ORFAlgorithmStrand s) {
     return s == ORFAlgorithmStrand_Both || s == ORFAlgorithmStrand_Direct;
 }
@@ -49,6 +55,367 @@ static bool isComplement(ORFAlgorithmStrand s) {
     return s == ORFAlgorithmStrand_Both || s == ORFAlgorithmStrand_Complement;
 }
 
+namespace {
+
+const int BLOCK_READ_FROM_DB = 128000;
+
+enum CodonRole {
+    CodonRole_Start = 1,
+    CodonRole_Stop = 2
+};
+
+/* Roles of all the 64 ACGT codons are computed once, so a codon is checked with a single table lookup */
+class CodonRolesTable {
+public:
+    CodonRolesTable(const DNATranslation3to1Impl* aTT, const DNATranslation* complementTT, bool allowAltStart)
+        : aTT(aTT), complementTT(complementTT), allowAltStart(allowAltStart)
+    {
+        static const char NUCLEOTIDES[] = "ACGT";
+        qFill(codeByChar, codeByChar + 256, -1);
+        for (int i = 0; i < 4; i++) {
+            codeByChar[(uchar)NUCLEOTIDES[i]] = i;
+        }
+        for (int c = 0; c < 64; c++) {
+            const char codon[3] = {NUCLEOTIDES[c >> 4], NUCLEOTIDES[(c >> 2) & 3], NUCLEOTIDES[c & 3]};
+            directRoles[c] = getRoles(codon[0], codon[1], codon[2]);
+            complementRoles[c] = (complementTT != NULL) ? getComplementRoles(codon) : 0;
+        }
+    }
+
+    /* roles[i] is the roles of the codon seq[i..i+2] */
+    void markDirect(const char* seq, int len, quint8* roles) const {
+        for (int i = 0; i + 2 < len; i++) {
+            const int c1 = codeByChar[(uchar)seq[i]];
+            const int c2 = codeByChar[(uchar)seq[i + 1]];
+            const int c3 = codeByChar[(uchar)seq[i + 2]];
+            roles[i] = ((c1 | c2 | c3) >= 0) ? directRoles[(c1 << 4) | (c2 << 2) | c3] : getRoles(seq[i], seq[i + 1], seq[i + 2]);
+        }
+        for (int i = qMax(0, len - 2); i < len; i++) {
+            roles[i] = 0;
+        }
+    }
+
+    /* roles[i] is the roles of the complementary codon that is read backward from seq[i] to seq[i-2] */
+    void markComplement(const char* seq, int len, quint8* roles) const {
+        for (int i = 0; i < qMin(2, len); i++) {
+            roles[i] = 0;
+        }
+        for (int i = 2; i < len; i++) {
+            const int c1 = codeByChar[(uchar)seq[i - 2]];
+            const int c2 = codeByChar[(uchar)seq[i - 1]];
+            const int c3 = codeByChar[(uchar)seq[i]];
+            roles[i] = ((c1 | c2 | c3) >= 0) ? complementRoles[(c1 << 4) | (c2 << 2) | c3] : getComplementRoles(seq + i - 2);
+        }
+    }
+
+private:
+    quint8 getRoles(char c1, char c2, char c3) const {
+        quint8 roles = 0;
+        if (aTT->isStartCodon(c1, c2, c3) || (allowAltStart && aTT->isCodon(DNATranslationRole_Start_Alternative, c1, c2, c3))) {
+            roles |= CodonRole_Start;
+        }
+        if (aTT->isStopCodon(c1, c2, c3)) {
+            roles |= CodonRole_Stop;
+        }
+        return roles;
+    }
+
+    /* @seq points to three symbols of the direct strand, the codon is their reverse complement */
+    quint8 getComplementRoles(const char* seq) const {
+        char codon[3] = {seq[2], seq[1], seq[0]};
+        complementTT->translate(codon, 3);
+        return getRoles(codon[0], codon[1], codon[2]);
+    }
+
+    const DNATranslation3to1Impl* aTT;
+    const DNATranslation* complementTT;
+    bool allowAltStart;
+    qint8 codeByChar[256];
+    quint8 directRoles[64];
+    quint8 complementRoles[64];
+};
+
+/* Reads the search region by blocks and gives the roles of the codon at any position of the region */
+class CodonRolesReader {
+public:
+    CodonRolesReader(const U2SequenceObject& seq, const CodonRolesTable& table, bool complement, const U2Region& region, bool ascending)
+        : seq(seq), table(table), complement(complement), region(region), ascending(ascending), dataStart(0)
+    {
+
+    }
+
+    quint8 get(qint64 pos, U2OpStatus& os) {
+        if (!block.contains(pos)) {
+            load(pos, os);
+            CHECK_OP(os, 0);
+        }
+        return roles[int(pos - dataStart)];
+    }
+
+private:
+    void load(qint64 pos, U2OpStatus& os) {
+        block = ascending ? U2Region(pos, qMin(region.endPos() - pos, (qint64)BLOCK_READ_FROM_DB))
+                          : U2Region(qMax(region.startPos, pos - BLOCK_READ_FROM_DB + 1), 0);
+        if (!ascending) {
+            block.length = pos + 1 - block.startPos;
+        }
+
+        // codons of the direct strand need two symbols after the block, codons of the complement strand need two symbols before it
+        const qint64 dataEnd = complement ? block.endPos() : qMin(block.endPos() + 2, region.endPos());
+        dataStart = complement ? qMax(region.startPos, block.startPos - 2) : block.startPos;
+        const QByteArray data = seq.getSequenceData(U2Region(dataStart, dataEnd - dataStart), os);
+        CHECK_OP_EXT(os, block = U2Region(), );
+
+        roles.resize(data.length());
+        if (complement) {
+            table.markComplement(data.constData(), data.length(), roles.data());
+        } else {
+            table.markDirect(data.constData(), data.length(), roles.data());
+        }
+    }
+
+    const U2SequenceObject& seq;
+    const CodonRolesTable& table;
+    const bool complement;
+    const U2Region region;
+    const bool ascending;
+    U2Region block;
+    qint64 dataStart;
+    QVector<quint8> roles;
+};
+
+class ORFSearchProgress {
+public:
+    ORFSearchProgress(int& percentsCompleted, qint64 totalLength)
+        : percentsCompleted(percentsCompleted), onePercentLen(qMax(totalLength / 100, (qint64)1)), leftTillPercent(onePercentLen)
+    {
+        percentsCompleted = 0;
+    }
+
+    void step() {
+        if (--leftTillPercent == 0) {
+            percentsCompleted = qMin(percentsCompleted + 1, 100);
+            leftTillPercent = onePercentLen;
+        }
+    }
+
+private:
+    int& percentsCompleted;
+    const qint64 onePercentLen;
+    qint64 leftTillPercent;
+};
+
+/* Reports the direct strand ORFs of @initiators that are terminated by the stop codon at @stopPos */
+void reportDirectOrfs(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const QList<int>& initiators, qint64 stopPos, int frame, U2OpStatus& os) {
+    const int minLen = qMax(cfg.minLen, 3);
+    foreach (int initiator, initiators) {
+        qint64 len = stopPos - initiator;
+        if (cfg.includeStopCodon) {
+            len += 3;
+        }
+        if (len >= minLen && !os.isCoR()) {
+            rl->onResult(ORFFindResult(U2Region(initiator, len), frame), os);
+        }
+    }
+}
+
+/* Reports the complement strand ORFs of @initiators that are terminated by the stop codon which last base is at @stopPos */
+void reportComplementOrfs(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const QList<int>& initiators, qint64 stopPos, int frame, U2OpStatus& os) {
+    const int minLen = qMax(cfg.minLen, 3);
+    foreach (int initiator, initiators) {
+        qint64 len = initiator - stopPos;
+        qint64 ind = stopPos;
+        if (cfg.includeStopCodon) {
+            ind -= 3;
+            len += 3;
+        }
+        if (len >= minLen && !os.isCoR()) {
+            rl->onResult(ORFFindResult(U2Region(ind + 1, len), frame - 3), os);
+        }
+    }
+}
+
+/* Appends the start codons found after @initiators in the strand order, the same way as the scan does */
+void appendInitiators(const ORFAlgorithmSettings& cfg, const QList<int>& starts, QList<int>& initiators) {
+    foreach (int start, starts) {
+        if ((initiators.isEmpty() || cfg.allowOverlap) && (initiators.isEmpty() || initiators.last() != start)) {
+            initiators.append(start);
+        }
+    }
+}
+
+/**
+ * Reports the direct strand ORFs that are terminated by a stop codon in @chunk, only the bases of the chunk are read.
+ * If the chunk is not at the search region start, its initiators are unknown till the first stop codon of each frame:
+ * the ORFs terminated by it are not reported, the stop codon and the start codons before it are stored in @borders instead.
+ * Non-terminated ORFs are left in @start.
+ */
+void findDirectInChunk(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq, const CodonRolesTable& table,
+                       const U2Region& chunk, QList<int>* start, ORFStrandBorders* borders, int& stopFlag, ORFSearchProgress& progress, U2OpStatus& os)
+{
+    const U2Region& region = cfg.searchRegion;
+    const bool knownInitiators = (chunk.startPos == region.startPos);
+    SAFE_POINT_EXT(knownInitiators || NULL != borders, os.setError("The chunk borders are not set"), );
+
+    bool deferStop[3];
+    for (int frame = 0; frame < 3; frame++) {
+        deferStop[frame] = !knownInitiators;
+        start[frame].clear();
+        if (knownInitiators && !cfg.mustInit) {
+            start[frame].append(region.startPos + ((frame - region.startPos % 3) + 3) % 3);
+        }
+    }
+
+    CodonRolesReader reader(dnaSeq, table, false, region, true);
+    for (qint64 i = chunk.startPos; i < chunk.endPos() && !stopFlag && !os.isCoR(); i++) {
+        progress.step();
+        const quint8 roles = reader.get(i, os);
+        CHECK_OP(os, );
+        CHECK_OPERATION(0 != roles, continue);
+
+        const int frame = i % 3;
+        QList<int>* initiators = start + frame;
+        if ((roles & CodonRole_Stop) && (deferStop[frame] || !initiators->isEmpty())) {
+            if (deferStop[frame]) {
+                deferStop[frame] = false;
+                borders->firstStop[frame] = i;
+                borders->headStarts[frame] = *initiators;
+            } else {
+                reportDirectOrfs(rl, cfg, *initiators, i, frame, os);
+            }
+            initiators->clear();
+            if (!cfg.mustInit) {
+                initiators->append(i + 3);
+            }
+        } else if ((initiators->isEmpty() || cfg.allowOverlap) && (roles & CodonRole_Start)) {
+            if (initiators->isEmpty() || initiators->last() != i) {
+                initiators->append(i);
+            }
+        }
+    }
+
+    CHECK(NULL != borders, );
+    for (int frame = 0; frame < 3; frame++) {
+        if (deferStop[frame]) {
+            borders->headStarts[frame] = start[frame];
+        }
+        borders->tailInitiators[frame] = start[frame];
+    }
+}
+
+/* The same as findDirectInChunk, but the complement strand is scanned from the chunk end to the chunk start */
+void findComplementInChunk(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq, const CodonRolesTable& table,
+                           const U2Region& chunk, QList<int>* start, ORFStrandBorders* borders, int& stopFlag, ORFSearchProgress& progress, U2OpStatus& os)
+{
+    const U2Region& region = cfg.searchRegion;
+    const bool knownInitiators = (chunk.endPos() == region.endPos());
+    SAFE_POINT_EXT(knownInitiators || NULL != borders, os.setError("The chunk borders are not set"), );
+
+    bool deferStop[3];
+    for (int frame = 0; frame < 3; frame++) {
+        deferStop[frame] = !knownInitiators;
+        start[frame].clear();
+        if (knownInitiators && !cfg.mustInit) {
+            start[frame].append(region.endPos() - 1 - (((region.endPos() - frame) % 3) + 3) % 3);
+        }
+    }
+
+    CodonRolesReader reader(dnaSeq, table, true, region, false);
+    for (qint64 i = chunk.endPos() - 1; i >= chunk.startPos && !stopFlag && !os.isCoR(); i--) {
+        progress.step();
+        const quint8 roles = reader.get(i, os);
+        CHECK_OP(os, );
+        CHECK_OPERATION(0 != roles, continue);
+
+        const int frame = (i + 1) % 3;
+        QList<int>* initiators = start + frame;
+        if ((roles & CodonRole_Stop) && (deferStop[frame] || !initiators->isEmpty())) {
+            if (deferStop[frame]) {
+                deferStop[frame] = false;
+                borders->firstStop[frame] = i;
+                borders->headStarts[frame] = *initiators;
+            } else {
+                reportComplementOrfs(rl, cfg, *initiators, i, frame, os);
+            }
+            initiators->clear();
+            if (!cfg.mustInit) {
+                initiators->append(i - 3);
+            }
+        } else if ((initiators->isEmpty() || cfg.allowOverlap) && (roles & CodonRole_Start)) {
+            if (initiators->isEmpty() || initiators->last() != i) {
+                initiators->append(i);
+            }
+        }
+    }
+
+    CHECK(NULL != borders, );
+    for (int frame = 0; frame < 3; frame++) {
+        if (deferStop[frame]) {
+            borders->headStarts[frame] = start[frame];
+        }
+        borders->tailInitiators[frame] = start[frame];
+    }
+}
+
+/**
+ * Restores the initiators of one strand at the end of the search region from the chunk borders given in the strand order
+ * and reports the ORFs terminated by the first stop codons of the chunks
+ */
+void joinStrandChunks(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, bool complement, const QList<const ORFStrandBorders*>& chunks, QList<int>* start, U2OpStatus& os) {
+    for (int frame = 0; frame < 3; frame++) {
+        start[frame].clear();
+    }
+    for (int c = 0; c < chunks.size() && !os.isCoR(); c++) {
+        const ORFStrandBorders* borders = chunks[c];
+        for (int frame = 0; frame < 3; frame++) {
+            if (0 == c) {
+                // the initiators of the first chunk are known, nothing is deferred
+                start[frame] = borders->tailInitiators[frame];
+                continue;
+            }
+            appendInitiators(cfg, borders->headStarts[frame], start[frame]);
+            CHECK_OPERATION(borders->firstStop[frame] >= 0, continue);
+            if (complement) {
+                reportComplementOrfs(rl, cfg, start[frame], borders->firstStop[frame], frame, os);
+            } else {
+                reportDirectOrfs(rl, cfg, start[frame], borders->firstStop[frame], frame, os);
+            }
+            start[frame] = borders->tailInitiators[frame];
+        }
+    }
+}
+
+/* Reports ORFs that are not terminated till the end of the search region */
+void reportDirectRemainder(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const QList<int>* start, U2OpStatus& os) {
+    const int minLen = qMax(cfg.minLen, 3);
+    for (int i = 0; i < 3; i++) {
+        foreach (int initiator, start[i]) {
+            int len = cfg.searchRegion.endPos() - initiator;
+            len -= len % 3;
+            if (len >= minLen && !os.isCoR()) {
+                rl->onResult(ORFFindResult(U2Region(initiator, len), i + 1), os);
+            }
+        }
+    }
+}
+
+/* Reports ORFs that are not terminated till the start of the search region */
+void reportComplementRemainder(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const QList<int>* start, U2OpStatus& os) {
+    const int minLen = qMax(cfg.minLen, 3);
+    for (int i = 0; i < 3; i++) {
+        foreach (int initiator, start[i]) {
+            int ind = cfg.searchRegion.startPos + i % 3;
+            int len = initiator - ind + 1;
+            len -= len % 3;
+            if (len >= minLen && !os.isCoR()) {
+                rl->onResult(ORFFindResult(U2Region(ind, len), i - 3), os);
+            }
+        }
+    }
+}
+
+}
+
 void ORFFindAlgorithm::find(
                             ORFFindResultsListener* rl,
                             const ORFAlgorithmSettings& cfg,
@@ -62,266 +429,240 @@ void ORFFindAlgorithm::find(
     TaskStateInfo os;
     U2SequenceObject dnaSeq("sequence",entityRef);
 
-    const int BLOCK_READ_FROM_DB = 128000;
-    int seqPointer = 0;
-    QByteArray sequence("");
+    DNATranslation3to1Impl* aTT = dynamic_cast<DNATranslation3to1Impl*>(cfg.proteinTT);
+    SAFE_POINT(aTT != NULL, "Cannot convert DNATranslation to DNATranslation3to1Impl!", );
+    CHECK(cfg.searchRegion.length >= qMax(cfg.minLen, 3), );
+
+    const CodonRolesTable table(aTT, isComplement(cfg.strand) ? cfg.complementTT : NULL, cfg.allowAltStart);
+    ORFSearchProgress progress(percentsCompleted, cfg.strand == ORFAlgorithmStrand_Both ? 2 * cfg.searchRegion.length : cfg.searchRegion.length);
+
+    if (isDirect(cfg.strand)) {
+        QList<int> start[3];
+        findDirectInChunk(rl, cfg, dnaSeq, table, cfg.searchRegion, start, NULL, stopFlag, progress, os);
+        SAFE_POINT_OP(os, );
+        finishDirect(rl, cfg, dnaSeq, start, stopFlag, os);
+    }
+
+    if (isComplement(cfg.strand)) {
+        assert(cfg.complementTT && cfg.complementTT->isOne2One());
+        QList<int> start[3];
+        findComplementInChunk(rl, cfg, dnaSeq, table, cfg.searchRegion, start, NULL, stopFlag, progress, os);
+        SAFE_POINT_OP(os, );
+        finishComplement(rl, cfg, dnaSeq, start, stopFlag, os);
+    }
+}
+
+void ORFFindAlgorithm::findInChunk(ORFFindResultsListener* rl,
+                                   const ORFAlgorithmSettings& cfg,
+                                   U2EntityRef& entityRef,
+                                   const U2Region& chunk,
+                                   ORFChunkBorders& borders,
+                                   int& stopFlag,
+                                   int& percentsCompleted)
+{
+    SAFE_POINT(cfg.maxResult2Search >= 0, "Invalid max results count!", );
+    SAFE_POINT(cfg.proteinTT && cfg.proteinTT->isThree2One(), "Amino translation is not 3to1 translation!", );
+    SAFE_POINT(cfg.searchRegion.contains(chunk), "The chunk is out of the search region!", );
+
+    TaskStateInfo os;
+    U2SequenceObject dnaSeq("sequence", entityRef);
 
     DNATranslation3to1Impl* aTT = dynamic_cast<DNATranslation3to1Impl*>(cfg.proteinTT);
     SAFE_POINT(aTT != NULL, "Cannot convert DNATranslation to DNATranslation3to1Impl!", );
-    bool mustFit = cfg.mustFit;
-    bool mustInit = cfg.mustInit;
-    bool allowAltStart = cfg.allowAltStart;
-    bool allowOverlap = cfg.allowOverlap;
-    bool circularSearch = cfg.circularSearch && (cfg.searchRegion.endPos() == dnaSeq.getSequenceLength());
-    int minLen = qMax(cfg.minLen, 3);
-    CHECK(cfg.searchRegion.length >= minLen, );
-
-    int onePercentLen = cfg.searchRegion.length/100;
-    if (cfg.strand == ORFAlgorithmStrand_Both) onePercentLen /=2;
-    int leftTillPercent = onePercentLen;
-    percentsCompleted = 0;
+    CHECK(cfg.searchRegion.length >= qMax(cfg.minLen, 3), );
+
+    const CodonRolesTable table(aTT, isComplement(cfg.strand) ? cfg.complementTT : NULL, cfg.allowAltStart);
+    ORFSearchProgress progress(percentsCompleted, cfg.strand == ORFAlgorithmStrand_Both ? 2 * chunk.length : chunk.length);
+
+    if (isDirect(cfg.strand)) {
+        QList<int> start[3];
+        findDirectInChunk(rl, cfg, dnaSeq, table, chunk, start, &borders.direct, stopFlag, progress, os);
+        SAFE_POINT_OP(os, );
+    }
+
+    if (isComplement(cfg.strand)) {
+        SAFE_POINT(cfg.complementTT && cfg.complementTT->isOne2One(), "Invalid complement translation!", );
+        QList<int> start[3];
+        findComplementInChunk(rl, cfg, dnaSeq, table, chunk, start, &borders.complement, stopFlag, progress, os);
+        SAFE_POINT_OP(os, );
+    }
+}
+
+void ORFFindAlgorithm::joinChunks(ORFFindResultsListener* rl,
+                                  const ORFAlgorithmSettings& cfg,
+                                  U2EntityRef& entityRef,
+                                  const QList<ORFChunkBorders>& chunks,
+                                  int& stopFlag)
+{
+    SAFE_POINT(!chunks.isEmpty(), "No chunks to join!", );
+    CHECK(cfg.searchRegion.length >= qMax(cfg.minLen, 3), );
+
+    TaskStateInfo os;
+    U2SequenceObject dnaSeq("sequence", entityRef);
 
     if (isDirect(cfg.strand)) {
+        QList<const ORFStrandBorders*> strandChunks;
+        foreach (const ORFChunkBorders& borders, chunks) {
+            strandChunks.append(&borders.direct);
+        }
+        QList<int> start[3];
+        joinStrandChunks(rl, cfg, false, strandChunks, start, os);
+        CHECK(!stopFlag && !os.isCoR(), );
+        finishDirect(rl, cfg, dnaSeq, start, stopFlag, os);
+    }
+
+    if (isComplement(cfg.strand)) {
+        QList<const ORFStrandBorders*> strandChunks;
+        foreach (const ORFChunkBorders& borders, chunks) {
+            strandChunks.prepend(&borders.complement);
+        }
         QList<int> start[3];
-        if (!mustInit) {
-            for (int i = 0; i < 3; i++) {
-                int frame = (cfg.searchRegion.startPos + i) % 3;
-                start[frame].append(cfg.searchRegion.startPos + i);
+        joinStrandChunks(rl, cfg, true, strandChunks, start, os);
+        CHECK(!stopFlag && !os.isCoR(), );
+        finishComplement(rl, cfg, dnaSeq, start, stopFlag, os);
+    }
+}
+
+void ORFFindAlgorithm::finishDirect(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq,
+                                    QList<int>* start, int& stopFlag, TaskStateInfo& os)
+{
+    DNATranslation3to1Impl* aTT = dynamic_cast<DNATranslation3to1Impl*>(cfg.proteinTT);
+    SAFE_POINT(aTT != NULL, "Cannot convert DNATranslation to DNATranslation3to1Impl!", );
+    const bool mustFit = cfg.mustFit;
+    const bool circularSearch = cfg.circularSearch && (cfg.searchRegion.endPos() == dnaSeq.getSequenceLength());
+    const int minLen = qMax(cfg.minLen, 3);
+    const qint64 end = cfg.searchRegion.endPos();
+    int seqPointer = 0;
+    QByteArray sequence("");
+
+    if(circularSearch && !stopFlag && !os.isCoR()){
+        //circular
+        addStartCodonsFromJunction(dnaSeq, cfg, ORFAlgorithmStrand_Direct, start);
+
+        qint64 regLen = end - cfg.searchRegion.startPos;
+        qint64 minInitiator = end;
+        bool initiatorsRemain = false;
+        for (int i=0; i<3;i++) {
+            foreach(int initiator, start[i]) {
+                if(initiator < minInitiator) {
+                    minInitiator = initiator;
+                    initiatorsRemain = true;
+                }
+
             }
         }
-        qint64 end = cfg.searchRegion.endPos();
-        for(qint64 i = cfg.searchRegion.startPos; i < end && !stopFlag && !os.isCoR(); i++, leftTillPercent--,++seqPointer) {
-            if((seqPointer % BLOCK_READ_FROM_DB) == 0){ // query to db
+
+        checkStopCodonOnJunction(dnaSeq, cfg, ORFAlgorithmStrand_Direct, rl, start, os);
+        SAFE_POINT_OP(os, );
+
+        seqPointer = 0;
+        for(qint64 i = cfg.searchRegion.startPos; i < minInitiator && !stopFlag && initiatorsRemain && !os.isCoR(); i++,++seqPointer) {
+            if( (seqPointer % BLOCK_READ_FROM_DB) == 0){ // query to db
                 sequence.clear();
-                qint64 regLen = qMin(end - i, (qint64)BLOCK_READ_FROM_DB + 3);
+                qint64 regLen = qMin((qint64)minInitiator - i, (qint64)BLOCK_READ_FROM_DB + 3);
                 sequence.append(dnaSeq.getSequenceData(U2Region(i, regLen), os));
                 SAFE_POINT_OP(os, );
                 seqPointer = 0;
             }
             int frame = i % 3;
-            QList<int>* initiators = start + frame;
+            // NOTE: frames of the start and the end of circular region are not equal!
+            int startFrame = (dnaSeq.getSequenceLength() - (3- frame) % 3) % 3;
+            QList<int>* initiators = start + startFrame;
             if (!initiators->isEmpty() && aTT->isStopCodon(sequence.data() + seqPointer)) {
                 foreach(int initiator, *initiators) {
-                    qint64 len = i - initiator;
-                    if (cfg.includeStopCodon) {
-                        len += 3;
-                    }
-                    if (len >= minLen && !os.isCoR()) {
-                        rl->onResult(ORFFindResult(U2Region(initiator, len), frame),os);
+                    int len = regLen + i - initiator;
+                    if (len>=minLen && !os.isCoR()){
+                        if (i == cfg.searchRegion.startPos && !cfg.includeStopCodon) {
+                            // stop codon is on junction, not included
+                            rl->onResult(ORFFindResult(U2Region(initiator, end - initiator), frame), os);
+                        } else {
+                            rl->onResult(ORFFindResult(U2Region(initiator, end - initiator),
+                                                       U2Region(cfg.searchRegion.startPos,
+                                                                i + 3 * cfg.includeStopCodon), frame),os);
+                        }
                     }
                 }
                 initiators->clear();
-                if (!mustInit) {
-                    initiators->append(i+3);
-                }
-            } else if (initiators->isEmpty() || allowOverlap) {
-                if (aTT->isStartCodon(sequence.data() + seqPointer)
-                    || (allowAltStart && aTT->isCodon(DNATranslationRole_Start_Alternative, sequence.data() + seqPointer))
-                   ) {
-                    if (initiators->isEmpty() || initiators->last() != i) {
-                        initiators->append(i);
-                    }
-                }
-            }
-            if (leftTillPercent == 0) {
-                percentsCompleted = qMin(percentsCompleted+1,100);
-                leftTillPercent = onePercentLen;
             }
         }
+    }
 
-        if(circularSearch && !stopFlag && !os.isCoR()){
-            //circular
-            addStartCodonsFromJunction(dnaSeq, cfg, ORFAlgorithmStrand_Direct, start);
+    if (!mustFit && !stopFlag && !circularSearch) {
+        //check if non-terminated ORFs remained
+        reportDirectRemainder(rl, cfg, start, os);
+    }
+}
 
-            qint64 regLen = end - cfg.searchRegion.startPos;
-            qint64 minInitiator = end;
-            bool initiatorsRemain = false;
-            for (int i=0; i<3;i++) {
-                foreach(int initiator, start[i]) {
-                    if(initiator < minInitiator) {
-                        minInitiator = initiator;
-                        initiatorsRemain = true;
-                    }
+void ORFFindAlgorithm::finishComplement(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq,
+                                        QList<int>* start, int& stopFlag, TaskStateInfo& os)
+{
+    DNATranslation3to1Impl* aTT = dynamic_cast<DNATranslation3to1Impl*>(cfg.proteinTT);
+    SAFE_POINT(aTT != NULL, "Cannot convert DNATranslation to DNATranslation3to1Impl!", );
+    const bool mustFit = cfg.mustFit;
+    const bool circularSearch = cfg.circularSearch && (cfg.searchRegion.endPos() == dnaSeq.getSequenceLength());
+    const int minLen = qMax(cfg.minLen, 3);
+    const qint64 end = cfg.searchRegion.startPos;
+    int seqPointer = 0;
+    QByteArray sequence("");
 
+    if(circularSearch && !stopFlag && !os.isCoR()){
+        addStartCodonsFromJunction(dnaSeq, cfg, ORFAlgorithmStrand_Complement, start);
+
+        int regLen = cfg.searchRegion.endPos() - cfg.searchRegion.startPos;
+        int maxInitiator = -1;
+        bool initiatorsRemain = false;
+        for (int i=0; i<3;i++) {
+            foreach(int initiator, start[i]) {
+                if(initiator > maxInitiator){
+                    maxInitiator = initiator;
+                    initiatorsRemain = true;
                 }
-            }
 
-            checkStopCodonOnJunction(dnaSeq, cfg, ORFAlgorithmStrand_Direct, rl, start, os);
-            SAFE_POINT_OP(os, );
-
-            seqPointer = 0;
-            for(qint64 i = cfg.searchRegion.startPos; i < minInitiator && !stopFlag && initiatorsRemain && !os.isCoR(); i++,++seqPointer) {
-                if( (seqPointer % BLOCK_READ_FROM_DB) == 0){ // query to db
-                    sequence.clear();
-                    qint64 regLen = qMin((qint64)minInitiator - i, (qint64)BLOCK_READ_FROM_DB + 3);
-                    sequence.append(dnaSeq.getSequenceData(U2Region(i, regLen), os));
-                    SAFE_POINT_OP(os, );
-                    seqPointer = 0;
-                }
-                int frame = i % 3;
-                // NOTE: frames of the start and the end of circular region are not equal!
-                int startFrame = (dnaSeq.getSequenceLength() - (3- frame) % 3) % 3;
-                QList<int>* initiators = start + startFrame;
-                if (!initiators->isEmpty() && aTT->isStopCodon(sequence.data() + seqPointer)) {
-                    foreach(int initiator, *initiators) {
-                        int len = regLen + i - initiator;
-                        if (len>=minLen && !os.isCoR()){
-                            if (i == cfg.searchRegion.startPos && !cfg.includeStopCodon) {
-                                // stop codon is on junction, not included
-                                rl->onResult(ORFFindResult(U2Region(initiator, end - initiator), frame), os);
-                            } else {
-                                rl->onResult(ORFFindResult(U2Region(initiator, end - initiator),
-                                                           U2Region(cfg.searchRegion.startPos,
-                                                                    i + 3 * cfg.includeStopCodon), frame),os);
-                            }
-                        }
-                    }
-                    initiators->clear();
-                }
             }
         }
 
-        if (!mustFit && !stopFlag && !circularSearch) {
-            //check if non-terminated ORFs remained
-            for (int i = 0; i < 3; i++) {
-                foreach (int initiator, start[i]) {
-                    int len = end - initiator;
-                    len -= len % 3;
-                    if (len >= minLen && !os.isCoR()) {
-                        rl->onResult(ORFFindResult(U2Region(initiator, len), i + 1),os);
-                    }
-                }
-            }
-         }
-    }
-
-    if (isComplement(cfg.strand)) {
-        assert(cfg.complementTT && cfg.complementTT->isOne2One());
-
-        QList<int> start[3];
-        if (!mustInit) {
-            for (int i = 0; i < 3; i++) {
-                int frame = (cfg.searchRegion.endPos() - i) % 3;
-                start[frame].append(cfg.searchRegion.endPos() - 1 - i);
-            }
-        }
+        checkStopCodonOnJunction(dnaSeq, cfg, ORFAlgorithmStrand_Complement, rl, start, os);
 
-        qint64 end = cfg.searchRegion.startPos;
         seqPointer = 0;
-        for(int i = cfg.searchRegion.endPos()-1; i >= end && !stopFlag && !os.isCoR();i--, leftTillPercent--,seqPointer++) {
+        for(qint64 i = cfg.searchRegion.endPos()-1; i >= maxInitiator && !stopFlag && initiatorsRemain && !os.isCoR(); i--,seqPointer++) {
             if((seqPointer % BLOCK_READ_FROM_DB) == 0){// query to db
                 sequence.clear();
                 QByteArray tmp;
-                qint64 regStart = qMax(end, (qint64)i - (BLOCK_READ_FROM_DB + 3));
-                qint64 regLen = qMin(i - end + 1, (qint64)BLOCK_READ_FROM_DB + 3 + 1);
+                qint64 regStart = qMax((qint64)maxInitiator, i - (BLOCK_READ_FROM_DB + 3));
+                qint64 regLen = qMin(i - maxInitiator + 1, (qint64)BLOCK_READ_FROM_DB + 3 + 1);
                 tmp.append(dnaSeq.getSequenceData(U2Region(regStart, regLen), os));
                 SAFE_POINT_OP(os, );
                 sequence.append(tmp,tmp.size());
                 cfg.complementTT->translate(tmp,tmp.size(),sequence.data(),sequence.size());
-                TextUtils::reverse(sequence.data(),sequence.size());
+                TextUtils::reverse(sequence.data(), sequence.size());
                 seqPointer = 0;
             }
             int frame = (i + 1) % 3;
-            QList<int>* initiators = start + frame;
+            // NOTE: frames of the start and the end of circular region are not equal!
+            int startFrame =  (3 - ((dnaSeq.getSequenceLength() - frame) % 3)) % 3;
+            QList<int>* initiators = start + startFrame;
             if (!initiators->isEmpty() && aTT->isStopCodon(sequence.data()+seqPointer)) {
                 foreach(int initiator, *initiators) {
-                    int len = initiator - i;
-                    int ind = i;
-                    if (cfg.includeStopCodon) {
-                        ind -= 3;
-                        len += 3;
-                    }
-                    if (len>=minLen && !os.isCoR()) {
-                        rl->onResult(ORFFindResult(U2Region(ind+1, len), frame - 3),os);
-                    }
-                }
-                initiators->clear();
-                if (!mustInit) {
-                    initiators->append(i-3);
-                }
-            } else if (initiators->isEmpty() || allowOverlap) {
-                if (aTT->isStartCodon(sequence.data()+seqPointer)
-                    || (allowAltStart && aTT->isCodon(DNATranslationRole_Start_Alternative, sequence.data()+seqPointer))
-                   ) {
-                    if (initiators->isEmpty() || initiators->last() != i) {
-                        initiators->append(i);
-                    }
-                }
-            }
-            if (leftTillPercent == 0) {
-                percentsCompleted = qMin(percentsCompleted+1,100);
-                leftTillPercent = onePercentLen;
-            }
-        }
-        if(circularSearch && !stopFlag && !os.isCoR()){
-            addStartCodonsFromJunction(dnaSeq, cfg, ORFAlgorithmStrand_Complement, start);
-
-            int regLen = cfg.searchRegion.endPos() - cfg.searchRegion.startPos;
-            int maxInitiator = -1;
-            bool initiatorsRemain = false;
-            for (int i=0; i<3;i++) {
-                foreach(int initiator, start[i]) {
-                    if(initiator > maxInitiator){
-                        maxInitiator = initiator;
-                        initiatorsRemain = true;
-                    }
-
-                }
-            }
-
-            checkStopCodonOnJunction(dnaSeq, cfg, ORFAlgorithmStrand_Complement, rl, start, os);
-
-            seqPointer = 0;
-            for(qint64 i = cfg.searchRegion.endPos()-1; i >= maxInitiator && !stopFlag && initiatorsRemain && !os.isCoR(); i--,seqPointer++) {
-                if((seqPointer % BLOCK_READ_FROM_DB) == 0){// query to db
-                    sequence.clear();
-                    QByteArray tmp;
-                    qint64 regStart = qMax((qint64)maxInitiator, i - (BLOCK_READ_FROM_DB + 3));
-                    qint64 regLen = qMin(i - maxInitiator + 1, (qint64)BLOCK_READ_FROM_DB + 3 + 1);
-                    tmp.append(dnaSeq.getSequenceData(U2Region(regStart, regLen), os));
-                    SAFE_POINT_OP(os, );
-                    sequence.append(tmp,tmp.size());
-                    cfg.complementTT->translate(tmp,tmp.size(),sequence.data(),sequence.size());
-                    TextUtils::reverse(sequence.data(), sequence.size());
-                    seqPointer = 0;
-                }
-                int frame = (i + 1) % 3;
-                // NOTE: frames of the start and the end of circular region are not equal!
-                int startFrame =  (3 - ((dnaSeq.getSequenceLength() - frame) % 3)) % 3;
-                QList<int>* initiators = start + startFrame;
-                if (!initiators->isEmpty() && aTT->isStopCodon(sequence.data()+seqPointer)) {
-                    foreach(int initiator, *initiators) {
-                        int len = regLen + initiator - i ;
-                        if (len >= minLen && !os.isCoR()){
-                            if (cfg.searchRegion.endPos() == i + 1 && !cfg.includeStopCodon) {
-                                rl->onResult(ORFFindResult(U2Region(end, initiator + 1), frame - 3), os);
-                            } else {
-                                rl->onResult(ORFFindResult(U2Region(i + 1 - 3 * cfg.includeStopCodon,
-                                                                    cfg.searchRegion.endPos() - (i + 1 - 3 * cfg.includeStopCodon)),
-                                                           U2Region(end, initiator + 1), frame - 3), os);
-                            }
+                    int len = regLen + initiator - i ;
+                    if (len >= minLen && !os.isCoR()){
+                        if (cfg.searchRegion.endPos() == i + 1 && !cfg.includeStopCodon) {
+                            rl->onResult(ORFFindResult(U2Region(end, initiator + 1), frame - 3), os);
+                        } else {
+                            rl->onResult(ORFFindResult(U2Region(i + 1 - 3 * cfg.includeStopCodon,
+                                                                cfg.searchRegion.endPos() - (i + 1 - 3 * cfg.includeStopCodon)),
+                                                       U2Region(end, initiator + 1), frame - 3), os);
                         }
                     }
-                    initiators->clear();
-                }
-            }
-        }
-
-        if (!mustFit && !stopFlag && !circularSearch) {
-            //check if non-terminated ORFs remained
-            for (int i = 0; i < 3; i++) {
-                foreach (int initiator, start[i]) {
-                    int ind = end + i % 3;
-                    int len = initiator - ind + 1;
-                    len -= len % 3;
-                    if (len >= minLen && !os.isCoR()) {
-                        rl->onResult(ORFFindResult(U2Region(ind, len), i - 3),os);
-                    }
                 }
+                initiators->clear();
             }
         }
     }
 
+    if (!mustFit && !stopFlag && !circularSearch) {
+        //check if non-terminated ORFs remained
+        reportComplementRemainder(rl, cfg, start, os);
+    }
 }
 
 void ORFFindAlgorithm::addStartCodonsFromJunction(const U2SequenceObject &dnaSeq,
@@ -132,6 +132,27 @@ public:
     static ORFAlgorithmStrand   getStrandByStringId(const QString& id);
 };
 
+/**
+ * The search state of one strand at the borders of a chunk, see ORFFindAlgorithm::findInChunk().
+ * The arrays are indexed by the frame.
+ */
+class U2ALGORITHM_EXPORT ORFStrandBorders {
+public:
+    ORFStrandBorders();
+
+    /* The first stop codon of the frame in the order of the strand, -1 if there is no stop codon */
+    qint64 firstStop[3];
+    /* Start codons before the first stop codon, all start codons of the frame if there is no stop codon */
+    QList<int> headStarts[3];
+    /* Initiators that are not terminated in the chunk */
+    QList<int> tailInitiators[3];
+};
+
+class U2ALGORITHM_EXPORT ORFChunkBorders {
+public:
+    ORFStrandBorders direct;
+    ORFStrandBorders complement;
+};
 
 class U2ALGORITHM_EXPORT ORFFindAlgorithm {
 public:
@@ -141,7 +162,36 @@ public:
         U2EntityRef& entityRef,
         int& stopFlag,
         int& percentsCompleted);
+
+    /**
+     * Finds ORFs that are terminated in @chunk of the search region reading only the chunk, so chunks of one region
+     * can be processed in parallel. The initiators that come from the previous chunk of the strand are unknown,
+     * so the ORFs terminated by the first stop codon of each frame are left for joinChunks() in @borders.
+     */
+    static void findInChunk(
+        ORFFindResultsListener* rl,
+        const ORFAlgorithmSettings& config,
+        U2EntityRef& entityRef,
+        const U2Region& chunk,
+        ORFChunkBorders& borders,
+        int& stopFlag,
+        int& percentsCompleted);
+
+    /**
+     * Reports the ORFs that cross the borders of the chunks, the ORFs that are not terminated in the search region
+     * and the ORFs that go through the junction of a circular sequence. @chunks cover the search region in its order.
+     */
+    static void joinChunks(
+        ORFFindResultsListener* rl,
+        const ORFAlgorithmSettings& config,
+        U2EntityRef& entityRef,
+        const QList<ORFChunkBorders>& chunks,
+        int& stopFlag);
 private:
+    static void finishDirect(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq,
+                             QList<int>* start, int& stopFlag, TaskStateInfo& os);
+    static void finishComplement(ORFFindResultsListener* rl, const ORFAlgorithmSettings& cfg, const U2SequenceObject& dnaSeq,
+                                 QList<int>* start, int& stopFlag, TaskStateInfo& os);
     static void addStartCodonsFromJunction(const U2SequenceObject &seq,
                                            const ORFAlgorithmSettings &cfg,
                                            ORFAlgorithmStrand strand,
@@ -83,11 +83,13 @@ HEADERS += src/cmdline/CMDLineCoreOptions.h \
            src/globals/BaseDocumentFormats.h \
            src/globals/ClipboardController.h \
            src/globals/Counter.h \
+           src/globals/CountersExporter.h \
            src/globals/CredentialsAsker.h \
            src/globals/DataBaseRegistry.h \
            src/globals/DataPathRegistry.h \
            src/globals/DBXRefRegistry.h \
            src/globals/ExternalToolRegistry.h \
+           src/globals/ExternalToolResourcePlanner.h \
            src/globals/FormatSettings.h \
            src/globals/global.h \
            src/globals/GUrl.h \
@@ -292,11 +294,13 @@ SOURCES += src/cmdline/CMDLineCoreOptions.cpp \
            src/globals/BaseDocumentFormats.cpp \
            src/globals/ClipboardController.cpp \
            src/globals/Counter.cpp \
+           src/globals/CountersExporter.cpp \
            src/globals/CredentialsAsker.cpp \
            src/globals/DataBaseRegistry.cpp \
            src/globals/DataPathRegistry.cpp \
            src/globals/DBXRefRegistry.cpp \
            src/globals/ExternalToolRegistry.cpp \
+           src/globals/ExternalToolResourcePlanner.cpp \
            src/globals/FormatSettings.cpp \
            src/globals/GUrl.cpp \
            src/globals/Log.cpp \
@@ -48,6 +48,11 @@ const QString CMDLineCoreOptions::LAUNCH_GUI_TEST_CRAZY_USER = "gui-test-crazy-u
 const QString CMDLineCoreOptions::USAGE         = "usage";
 const QString CMDLineCoreOptions::TMP_DIR       = "tmp-dir";
 const QString CMDLineCoreOptions::SESSION_DB    = "session-db";
+const QString CMDLineCoreOptions::METRICS_FILE  = "metrics-file";
+const QString CMDLineCoreOptions::METRICS_INTERVAL = "metrics-interval";
+const QString CMDLineCoreOptions::LAZY_PLUGINS  = "lazy-plugins";
+const QString CMDLineCoreOptions::DAEMON        = "daemon";
+const QString CMDLineCoreOptions::DAEMON_SUBMIT = "daemon-submit";
 
 
 void CMDLineCoreOptions::initHelp() {
@@ -88,11 +93,51 @@ void CMDLineCoreOptions::initHelp() {
         "The session database file is removed after closing of UGENE."),
         tr( "<path_to_file>" ));
 
+    CMDLineHelpProvider * metricsFileSection = new CMDLineHelpProvider(
+        METRICS_FILE,
+        tr("Path to the file for performance counters"),
+        tr("Values of the performance counters are periodically written to the file\n"
+        "in the Prometheus text exposition format. The file is updated atomically."),
+        tr( "<path_to_file>" ));
+
+    CMDLineHelpProvider * metricsIntervalSection = new CMDLineHelpProvider(
+        METRICS_INTERVAL,
+        tr("Interval between writes of the performance counters file, in seconds"),
+        "",
+        tr( "<seconds>" ));
+
+    CMDLineHelpProvider * lazyPluginsSection = new CMDLineHelpProvider(
+        LAZY_PLUGINS,
+        tr("Loads plugins on demand"),
+        tr("Plugins whose document formats and workflow elements are known from the previous runs\n"
+        "are loaded only when one of them is requested. It makes start-up of the console UGENE faster."),
+        "");
+
+    CMDLineHelpProvider * daemonSection = new CMDLineHelpProvider(
+        DAEMON,
+        tr("Runs UGENE as a workflow server"),
+        tr("UGENE is initialized once and then waits for workflows submitted with the --%1 option\n"
+        "to the local socket with the specified name. The submitted workflows are run concurrently.").arg(DAEMON_SUBMIT),
+        tr( "<socket_name>" ));
+
+    CMDLineHelpProvider * daemonSubmitSection = new CMDLineHelpProvider(
+        DAEMON_SUBMIT,
+        tr("Runs the workflow in the UGENE server"),
+        tr("The workflow and its parameters are sent to the UGENE server started with the --%1 option.\n"
+        "The progress is printed while the workflow is running, the exit code is the workflow result.\n"
+        "Relative paths in the parameters are resolved against the current folder.").arg(DAEMON),
+        tr( "<socket_name>" ));
+
     cmdLineRegistry->registerCMDLineHelpProvider( helpSection );
     cmdLineRegistry->registerCMDLineHelpProvider( loadSettingsFileSection );
     cmdLineRegistry->registerCMDLineHelpProvider( translSection );
     cmdLineRegistry->registerCMDLineHelpProvider( tmpDirSection );
     cmdLineRegistry->registerCMDLineHelpProvider( sessionDatabaseSection);
+    cmdLineRegistry->registerCMDLineHelpProvider( metricsFileSection );
+    cmdLineRegistry->registerCMDLineHelpProvider( metricsIntervalSection );
+    cmdLineRegistry->registerCMDLineHelpProvider( lazyPluginsSection );
+    cmdLineRegistry->registerCMDLineHelpProvider( daemonSection );
+    cmdLineRegistry->registerCMDLineHelpProvider( daemonSubmitSection );
 }
 
 } // U2
@@ -52,6 +52,11 @@ public:
     static const QString USAGE;
     static const QString TMP_DIR;
     static const QString SESSION_DB;
+    static const QString METRICS_FILE;
+    static const QString METRICS_INTERVAL;
+    static const QString LAZY_PLUGINS;
+    static const QString DAEMON;
+    static const QString DAEMON_SUBMIT;
 
 public:
     // initialize help for core cmdline options
@@ -19,6 +19,9 @@
  * MA 02110-1301, USA.
  */
 
+#include <U2Core/AppContext.h>
+#include <U2Core/PluginModel.h>
+
 #include "CMDLineRegistry.h"
 #include "CMDLineHelpProvider.h"
 #include "CMDLineCoreOptions.h"
@@ -66,7 +69,8 @@ static bool tryParseSingleDashParameter(const QString& argument, const QString&
     return true;
 }
 
-CMDLineRegistry::CMDLineRegistry(const QStringList& arguments) {
+CMDLineRegistry::CMDLineRegistry(const QStringList& arguments)
+: arguments(arguments) {
     int sz = arguments.size();
     for( int i = 0; i < sz; i++ ) {
         const QString& argument = arguments.at( i );
@@ -101,6 +105,10 @@ const QList<StringPair> & CMDLineRegistry::getParameters() const {
     return params;
 }
 
+const QStringList & CMDLineRegistry::getArguments() const {
+    return arguments;
+}
+
 QStringList CMDLineRegistry::getOrderedParameterNames() const {
     QStringList res;
     QList<StringPair>::const_iterator it = params.constBegin();
@@ -139,6 +147,10 @@ static bool providerNameComparator(const CMDLineHelpProvider* p1, const CMDLineH
 
 void CMDLineRegistry::registerCMDLineHelpProvider(CMDLineHelpProvider* provider) {
     helpProviders.append(provider);
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps) {
+        ps->addCapability(PluginCapability_CmdlineOption, provider->getHelpSectionFullName());
+    }
     qStableSort(helpProviders.begin(), helpProviders.end(), providerNameComparator);
 }
 
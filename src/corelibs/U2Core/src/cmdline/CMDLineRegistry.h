@@ -45,6 +45,8 @@ public:
     virtual ~CMDLineRegistry();
 
     const QList<StringPair> & getParameters() const;
+    // the arguments the registry is built from
+    const QStringList & getArguments() const;
     // as they were in cmdline. Empty keys also here
     QStringList getOrderedParameterNames() const;
 
@@ -59,6 +61,7 @@ public:
     const QList<CMDLineHelpProvider* >& listCMDLineHelpProviders() const { return helpProviders; }
 
 private:
+    QStringList                         arguments;
     QList<StringPair>                   params; // pairs (paramName, paramValue) ordered as in the cmdline
     QList<CMDLineHelpProvider* >        helpProviders; // sorted by section name
 
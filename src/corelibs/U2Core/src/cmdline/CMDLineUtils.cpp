@@ -29,8 +29,12 @@ namespace U2 {
 * CMDLineRegistryUtils
 ***************************************************/
 int CMDLineRegistryUtils::getParameterIndex( const QString & paramName, int startWith ) {
+    return getParameterIndex( AppContext::getCMDLineRegistry(), paramName, startWith );
+}
+
+int CMDLineRegistryUtils::getParameterIndex( const CMDLineRegistry * cmdLine, const QString & paramName, int startWith ) {
     QList<StringPair> params;
-    setCMDLineParams( params );
+    setCMDLineParams( params, cmdLine );
     int sz = params.size();
     for( int i = qMax( 0, startWith ); i < sz; ++i ) {
         if( params[i].first == paramName ) {
@@ -70,8 +74,12 @@ QStringList CMDLineRegistryUtils::getParameterValuesByWords( const QString & par
 }
 
 QStringList CMDLineRegistryUtils::getPureValues( int startWithIdx ) {
+    return getPureValues( AppContext::getCMDLineRegistry(), startWithIdx );
+}
+
+QStringList CMDLineRegistryUtils::getPureValues( const CMDLineRegistry * cmdLine, int startWithIdx ) {
     QList<StringPair> params;
-    setCMDLineParams( params );
+    setCMDLineParams( params, cmdLine );
     QStringList res;
     int sz = params.size();
     for( int i = qMax( 0, startWithIdx ); i < sz; ++i ) {
@@ -85,8 +93,8 @@ QStringList CMDLineRegistryUtils::getPureValues( int startWithIdx ) {
     return res;
 }
 
-void CMDLineRegistryUtils::setCMDLineParams( QList<StringPair> & to ) {
-    CMDLineRegistry * cmdlineRegistry = AppContext::getCMDLineRegistry();
+void CMDLineRegistryUtils::setCMDLineParams( QList<StringPair> & to, const CMDLineRegistry * cmdLine ) {
+    const CMDLineRegistry * cmdlineRegistry = ( cmdLine != NULL ) ? cmdLine : AppContext::getCMDLineRegistry();
     if( cmdlineRegistry != NULL ) {
         to = cmdlineRegistry->getParameters();
     }
@@ -42,8 +42,12 @@ public:
     // by default, search starts at 1 because at params[0] is usually ("", programName) pair
     static QStringList getPureValues( int startWithIdx = 1 );
 
+    // the same for the command line that is not the one of the current process
+    static int getParameterIndex( const CMDLineRegistry * cmdLine, const QString & paramName, int startWith = 0 );
+    static QStringList getPureValues( const CMDLineRegistry * cmdLine, int startWithIdx = 1 );
+
 private:
-    static void setCMDLineParams( QList<StringPair> & to );
+    static void setCMDLineParams( QList<StringPair> & to, const CMDLineRegistry * cmdLine = NULL );
 
 }; // CMDLineRegistryUtils
 
@@ -252,6 +252,10 @@ char MAlignmentRow::charAt(int pos) const {
     return MsaRowUtils::charAt(sequence.seq, gaps, pos);
 }
 
+QByteArray MAlignmentRow::getRowSpan(int pos, int count) const {
+    return MsaRowUtils::getRowSpan(sequence.seq, gaps, pos, count);
+}
+
 void MAlignmentRow::insertGaps(int pos, int count, U2OpStatus& os) {
     if (count < 0) {
         coreLog.trace(QString("Internal error: incorrect parameters were passed to MAlignmentRow::insertGaps,"
@@ -147,6 +147,12 @@ public:
      */
     char charAt(int pos) const;
 
+    /**
+     * Returns 'count' characters of the row starting from 'pos', gaps included.
+     * Positions outside the row bounds are returned as gaps.
+     */
+    QByteArray getRowSpan(int pos, int count) const;
+
     /** Length of the sequence without gaps */
     inline int getUngappedLength() const;
 
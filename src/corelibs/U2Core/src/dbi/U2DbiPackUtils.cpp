@@ -65,6 +65,78 @@ bool PackUtils::unpackGaps(const QByteArray &str, QList<U2MsaGap> &gaps) {
     return true;
 }
 
+namespace {
+
+void writeVarint(QByteArray &result, quint64 value) {
+    while (value >= 0x80) {
+        result.append(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    result.append(char(value));
+}
+
+bool readVarint(const QByteArray &data, int &pos, quint64 &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        CHECK(pos < data.size(), false);
+        const quint8 byte = static_cast<quint8>(data.at(pos++));
+        value |= quint64(byte & 0x7F) << shift;
+        if (0 == (byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Gaps of a normalized model are sorted, so the deltas are non-negative; the zigzag encoding keeps unsorted models valid
+quint64 zigzag(qint64 value) {
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+qint64 unzigzag(quint64 value) {
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+}
+
+QByteArray PackUtils::packGapModel(const QList<U2MsaGap> &gaps) {
+    QByteArray result;
+    CHECK(!gaps.isEmpty(), result);
+    result.reserve(1 + 4 * gaps.size());
+
+    writeVarint(result, gaps.size());
+    qint64 prevEnd = 0;
+    foreach (const U2MsaGap &gap, gaps) {
+        writeVarint(result, zigzag(gap.offset - prevEnd));
+        writeVarint(result, gap.gap);
+        prevEnd = gap.offset + gap.gap;
+    }
+    return result;
+}
+
+bool PackUtils::unpackGapModel(const QByteArray &blob, QList<U2MsaGap> &gaps) {
+    CHECK(!blob.isEmpty(), true);
+
+    int pos = 0;
+    quint64 count = 0;
+    CHECK(readVarint(blob, pos, count), false);
+    // every gap takes at least two bytes
+    CHECK(count <= quint64(blob.size() - pos) / 2, false);
+    gaps.reserve(gaps.size() + int(count));
+
+    qint64 prevEnd = 0;
+    for (quint64 i = 0; i < count; i++) {
+        quint64 delta = 0;
+        quint64 length = 0;
+        CHECK(readVarint(blob, pos, delta), false);
+        CHECK(readVarint(blob, pos, length), false);
+        U2MsaGap gap(prevEnd + unzigzag(delta), qint64(length));
+        gaps << gap;
+        prevEnd = gap.offset + gap.gap;
+    }
+    return pos == blob.size();
+}
+
 QByteArray PackUtils::packGapDetails(qint64 rowId, const QList<U2MsaGap> &oldGaps, const QList<U2MsaGap> &newGaps) {
     QByteArray result = VERSION;
     result += SEP;
@@ -37,6 +37,13 @@ public:
     static QByteArray packGaps(const QList<U2MsaGap> &gaps);
     static bool unpackGaps(const QByteArray &str, QList<U2MsaGap> &gaps);
 
+    /**
+     * Gap model of a row as it is stored in the database: a compact binary blob.
+     * Every gap is written as two varints: the distance from the end of the previous gap and the gap length.
+     */
+    static QByteArray packGapModel(const QList<U2MsaGap> &gaps);
+    static bool unpackGapModel(const QByteArray &blob, QList<U2MsaGap> &gaps);
+
     /** Gaps details */
     static QByteArray packGapDetails(qint64 rowId, const QList<U2MsaGap> &oldGaps, const QList<U2MsaGap> &newGaps);
     static bool unpackGapDetails(const QByteArray &modDetails, qint64 &rowId, QList<U2MsaGap> &oldGaps, QList<U2MsaGap> &newGaps);
@@ -31,6 +31,7 @@
 #include <U2Core/GUrlUtils.h>
 #include <U2Core/U2SafePoints.h>
 #include <U2Core/U2DbiUtils.h>
+#include <U2Core/PluginModel.h>
 #include "U2DbiRegistry.h"
 
 #include <U2Formats/MysqlDbiUtils.h>
@@ -253,6 +254,7 @@ bool U2DbiRegistry::registerDbiFactory(U2DbiFactory *factory) {
         return false;
     }
     factories.insert(factory->getId(), factory);
+    PluginSupport::reportRegistry("U2DbiRegistry");
     return true;
 }
 
@@ -22,6 +22,7 @@
 #ifndef _U2_MSA_DBI_H_
 #define _U2_MSA_DBI_H_
 
+#include <U2Core/DNASequence.h>
 #include <U2Core/U2Type.h>
 #include <U2Core/U2Dbi.h>
 #include <U2Core/U2Msa.h>
@@ -48,6 +49,12 @@ public:
     /** Return a row with the specified ID */
     virtual U2MsaRow getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os) = 0;
 
+    /**
+     * Returns the sequences of the MSA rows: the name of the sequence object and the [gstart, gend) region of its data.
+     * The result has the same order as @rows. Intended for reading the whole alignment at once.
+     */
+    virtual QList<DNASequence> getRowsSequences(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os) = 0;
+
     /** Returns the list of rows IDs in the database for the specified MSA (in increasing order) */
     virtual QList<qint64> getRowsOrder(const U2DataId& msaId, U2OpStatus& os) = 0;
 
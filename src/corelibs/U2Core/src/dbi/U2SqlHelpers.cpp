@@ -22,6 +22,7 @@
 #include "U2SqlHelpers.h"
 
 #include <U2Core/Log.h>
+#include <U2Core/Timer.h>
 #include <U2Core/U2DbiUtils.h>
 #include <U2Core/U2SafePoints.h>
 
@@ -166,6 +167,7 @@ bool SQLiteQuery::step() {
     }
     assert(st != NULL);
 
+    GTIMER(cvar, tvar, "SQLiteQuery::step");
     int rc = sqlite3_step(st);
     if (rc == SQLITE_DONE || rc == SQLITE_READONLY) {
         return false;
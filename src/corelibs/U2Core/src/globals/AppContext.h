@@ -60,6 +60,7 @@ class CudaGpuRegistry;
 class OpenCLGpuRegistry;
 class RecentlyDownloadedCache;
 class ProtocolInfoRegistry;
+class LocalTaskFactoryRegistry;
 class RemoteMachineMonitor;
 class PhyTreeGeneratorRegistry;
 class CMDLineRegistry;
@@ -176,6 +177,8 @@ public:
 
     static RemoteMachineMonitor * getRemoteMachineMonitor() { return getInstance()->_getRemoteMachineMonitor(); }
 
+    static LocalTaskFactoryRegistry * getLocalTaskFactoryRegistry() { return getInstance()->_getLocalTaskFactoryRegistry(); }
+
     static PhyTreeGeneratorRegistry *getPhyTreeGeneratorRegistry() {return getInstance()->_getPhyTreeGeneratorRegistry();}
 
     static CMDLineRegistry* getCMDLineRegistry() {return getInstance()->_getCMDLineRegistry();}
@@ -295,6 +298,7 @@ protected:
     virtual RecentlyDownloadedCache*    _getRecentlyDownloadedCache() const = 0;
     virtual ProtocolInfoRegistry *      _getProtocolInfoRegistry() const = 0;
     virtual RemoteMachineMonitor *      _getRemoteMachineMonitor() const = 0;
+    virtual LocalTaskFactoryRegistry *  _getLocalTaskFactoryRegistry() const = 0;
     virtual PhyTreeGeneratorRegistry *  _getPhyTreeGeneratorRegistry() const = 0;
     virtual CMDLineRegistry*            _getCMDLineRegistry() const  = 0;
     virtual MSAConsensusAlgorithmRegistry* _getMSAConsensusAlgorithmRegistry() const = 0;
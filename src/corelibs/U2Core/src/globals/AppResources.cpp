@@ -24,6 +24,7 @@
 #include <U2Core/AppContext.h>
 #include <U2Core/Settings.h>
 #include <U2Core/AppSettings.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Core/U2SafePoints.h>
 #include <U2Test/GTest.h>
 
@@ -72,9 +73,15 @@ AppResourcePool::AppResourcePool() {
 
     listenLogInGTest = new AppResourceReadWriteLock(RESOURCE_LISTEN_LOG_IN_TESTS, "LogInTests");
     registerResource(listenLogInGTest);
+
+    externalToolCpuResource = new AppResourceSemaphore(RESOURCE_EXTERNAL_TOOL_CPU, idealThreadCount, tr("External tools CPU cores"));
+    registerResource(externalToolCpuResource);
+
+    externalToolPlanner = new ExternalToolResourcePlanner(externalToolCpuResource, memResource);
 }
 
 AppResourcePool::~AppResourcePool() {
+    delete externalToolPlanner;
     qDeleteAll(resources.values());
 }
 
@@ -139,6 +146,7 @@ void AppResourcePool::setIdealThreadCount(int n) {
 
     n = qBound(1, n, threadResource->maxUse());
     idealThreadCount = n;
+    externalToolCpuResource->setMaxUse(idealThreadCount);
     AppContext::getSettings()->setValue(SETTINGS_ROOT + "idealThreadCount", idealThreadCount);
 }
 
@@ -246,6 +254,25 @@ AppResource* AppResourcePool::getResource(int id) const {
 }
 
 
+void AppResourcePool::registerMemoryReclaimer(MemoryReclaimer *reclaimer) {
+    QMutexLocker locker(&reclaimersMutex);
+    SAFE_POINT(!reclaimers.contains(reclaimer), "The memory reclaimer is already registered", );
+    reclaimers << reclaimer;
+}
+
+void AppResourcePool::unregisterMemoryReclaimer(MemoryReclaimer *reclaimer) {
+    QMutexLocker locker(&reclaimersMutex);
+    reclaimers.removeOne(reclaimer);
+}
+
+void AppResourcePool::reclaimMemory(int memoryMb) {
+    QMutexLocker locker(&reclaimersMutex);
+    foreach (MemoryReclaimer *reclaimer, reclaimers) {
+        CHECK(memResource->available() < memoryMb, );
+        reclaimer->reclaimMemory(memoryMb);
+    }
+}
+
 AppResourcePool* AppResourcePool::instance() {
     return AppContext::getAppSettings() ? AppContext::getAppSettings()->getAppResourcePool() : NULL;
 }
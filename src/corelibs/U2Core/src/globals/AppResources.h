@@ -25,12 +25,16 @@
 #include <U2Core/global.h>
 #include <U2Core/U2SafePoints.h>
 #include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QSemaphore>
 #include <QtCore/QReadWriteLock>
 #include <U2Core/U2OpStatus.h>
 
 namespace U2 {
 
+class ExternalToolResourcePlanner;
+
 /** Thread resource - number of threads */
 #define RESOURCE_THREAD     1
 
@@ -49,6 +53,9 @@ namespace U2 {
 */
 #define RESOURCE_PROJECT    5
 
+/** External tool CPU resource - number of CPU cores that the running external tools occupy */
+#define RESOURCE_EXTERNAL_TOOL_CPU  6
+
 #define LOG_TRACE(METHOD) \
     coreLog.trace(QString("AppResource %1 ::" #METHOD " %2, available %3").arg(name).arg(n).arg(available()));
 
@@ -255,6 +262,18 @@ private:
 
 #define MIN_MEMORY_SIZE 200
 
+/**
+ * Keeps the memory resource for the data that can be dropped, e.g. for the cached unused data.
+ * The pool asks it to release the memory when the memory resource can not be acquired.
+ */
+class U2CORE_EXPORT MemoryReclaimer {
+public:
+    virtual ~MemoryReclaimer() {}
+
+    /** Releases the kept memory until @memoryMb megabytes of the memory resource are available or nothing is kept */
+    virtual void reclaimMemory(int memoryMb) = 0;
+};
+
 class U2CORE_EXPORT AppResourcePool : public QObject {
     Q_OBJECT
 public:
@@ -277,6 +296,13 @@ public:
     void registerResource(AppResource* r);
     AppResource* getResource(int id) const;
 
+    void registerMemoryReclaimer(MemoryReclaimer *reclaimer);
+    void unregisterMemoryReclaimer(MemoryReclaimer *reclaimer);
+    /** Asks the reclaimers to release the kept memory until @memoryMb megabytes are available */
+    void reclaimMemory(int memoryMb);
+
+    ExternalToolResourcePlanner* getExternalToolResourcePlanner() const {return externalToolPlanner;}
+
     static AppResourcePool* instance();
 
     static int getTotalPhysicalMemory();
@@ -295,7 +321,12 @@ private:
     AppResourceSemaphore* threadResource;
     AppResourceSemaphore* memResource;
     AppResourceSemaphore* projectResouce;
+    AppResourceSemaphore* externalToolCpuResource;
     AppResourceReadWriteLock* listenLogInGTest;
+    ExternalToolResourcePlanner* externalToolPlanner;
+
+    QMutex reclaimersMutex;
+    QList<MemoryReclaimer*> reclaimers;
 };
 
 
@@ -343,6 +374,10 @@ public:
             int diff = needMB - lockedMB;
             CHECK_EXT(NULL != resource, if (os) os->setError("MemoryLocker - Resource error"), false);
             bool ok = resource->tryAcquire(diff, memoryLockType);
+            if (!ok && NULL != AppResourcePool::instance()) {
+                AppResourcePool::instance()->reclaimMemory(diff);
+                ok = resource->tryAcquire(diff, memoryLockType);
+            }
             if (ok) {
                 lockedMB = needMB;
             } else {
@@ -19,25 +19,55 @@
  * MA 02110-1301, USA.
  */
 
+#include <QtCore/QMutexLocker>
+
 #include "Counter.h"
 
 namespace U2 {
 
+// counters are created during static initialization, so the lock is created on demand
+static QMutex & getCountersListLock() {
+    static QMutex lock;
+    return lock;
+}
+
 QList<GCounter*>& GCounter::getCounters() {
     static GCounterList counters;
     return counters.list;
 }
 
-GCounter::GCounter(const QString& _name, const QString& s, double scale) : name(_name), suffix(s), totalCount(0), counterScale(scale), destroyMe(false) {
+QList<GCounter*> GCounter::allCounters() {
+    QMutexLocker locker(&getCountersListLock());
+    return getCounters();
+}
+
+GCounter::GCounter(const QString& _name, const QString& s, double scale)
+    : name(_name), suffix(s), counterScale(scale), destroyMe(false), baseValue(0), bucketsCount(0)
+{
     assert(counterScale > 0);
+    QMutexLocker locker(&getCountersListLock());
+    getCounters().append(this);
+}
+
+GCounter::GCounter(const QString& _name, const QString& s, double scale, int _bucketsCount)
+    : name(_name), suffix(s), counterScale(scale), destroyMe(false), baseValue(0), bucketsCount(_bucketsCount),
+      baseBuckets(_bucketsCount, 0)
+{
+    assert(counterScale > 0);
+    QMutexLocker locker(&getCountersListLock());
     getCounters().append(this);
 }
 
 GCounter::~GCounter() {
-    getCounters().removeOne(this);
+    {
+        QMutexLocker locker(&getCountersListLock());
+        getCounters().removeOne(this);
+    }
+    qDeleteAll(shards);
 }
 
 GCounter *GCounter::getCounter(const QString &name, const QString &suffix) {
+    QMutexLocker locker(&getCountersListLock());
     foreach (GCounter *counter, getCounters()) {
         if (name == counter->name && suffix == counter->suffix) {
             return counter;
@@ -46,6 +76,70 @@ GCounter *GCounter::getCounter(const QString &name, const QString &suffix) {
     return NULL;
 }
 
+void GCounter::observe(qint64 value) {
+    add(value);
+}
+
+qint64 GCounter::getTotal() const {
+    QMutexLocker locker(&shardsLock);
+    qint64 result = baseValue;
+    foreach (const GCounterShard *shard, shards) {
+        result += shard->value.get();
+    }
+    return result;
+}
+
+void GCounter::setTotal(qint64 value) {
+    QMutexLocker locker(&shardsLock);
+    qint64 shardsValue = 0;
+    foreach (const GCounterShard *shard, shards) {
+        shardsValue += shard->value.get();
+    }
+    baseValue = value - shardsValue;
+}
+
+QVector<qint64> GCounter::getBucketsTotal() const {
+    QMutexLocker locker(&shardsLock);
+    QVector<qint64> result = baseBuckets;
+    foreach (const GCounterShard *shard, shards) {
+        for (int i = 0; i < bucketsCount; i++) {
+            result[i] += shard->buckets[i].get();
+        }
+    }
+    return result;
+}
+
+GCounterShard * GCounter::createShard() {
+    GCounterShard *shard = new GCounterShard(bucketsCount);
+    {
+        QMutexLocker locker(&shardsLock);
+        shards << shard;
+    }
+    GCounterShardRef &ref = threadShard.localData();
+    ref.counter = this;
+    ref.shard = shard;
+    return shard;
+}
+
+void GCounter::releaseShard(GCounterShard *shard) {
+    {
+        QMutexLocker locker(&shardsLock);
+        baseValue += shard->value.get();
+        for (int i = 0; i < bucketsCount; i++) {
+            baseBuckets[i] += shard->buckets[i].get();
+        }
+        shards.removeOne(shard);
+    }
+    delete shard;
+}
+
+GCounterShardRef::~GCounterShardRef() {
+    // QThreadStorage doesn't destroy values of other threads when the counter is deleted
+    if (NULL != shard) {
+        counter->releaseShard(shard);
+    }
+}
+
 GReportableCounter::GReportableCounter(const QString& name, const QString& suffix, double scale /* = 1 */) :
 GCounter(name, suffix, scale) {
 }
@@ -60,4 +154,76 @@ GCounterList::~GCounterList() {
     }
 }
 
+/************************************************************************/
+/* GGauge */
+/************************************************************************/
+GGauge::GGauge(const QString& name, const QString& suffix, double scale)
+    : GCounter(name, suffix, scale)
+{
+
+}
+
+void GGauge::set(qint64 value) {
+    setTotal(value);
+}
+
+/************************************************************************/
+/* GHistogram */
+/************************************************************************/
+const int GHistogram::BUCKETS_COUNT = 48;
+
+GHistogram::GHistogram(const QString& name, const QString& suffix, double scale)
+    : GCounter(name, suffix, scale, BUCKETS_COUNT)
+{
+
+}
+
+void GHistogram::observe(qint64 value) {
+    // the smallest bucket with value <= 2^bucket
+    int bucket = 0;
+    for (qint64 rest = value - 1; rest > 0 && bucket < BUCKETS_COUNT - 1; rest >>= 1) {
+        bucket++;
+    }
+    GCounterShard *shard = getShard();
+    shard->value.add(value);
+    shard->buckets[bucket].add(1);
+}
+
+qint64 GHistogram::getObservationsCount() const {
+    qint64 result = 0;
+    foreach (qint64 count, getBuckets()) {
+        result += count;
+    }
+    return result;
+}
+
+QVector<qint64> GHistogram::getBuckets() const {
+    return getBucketsTotal();
+}
+
+double GHistogram::getPercentile(double percent) const {
+    const QVector<qint64> buckets = getBuckets();
+    qint64 total = 0;
+    foreach (qint64 count, buckets) {
+        total += count;
+    }
+    if (0 == total) {
+        return 0;
+    }
+
+    const qint64 rank = qMax(qint64(1), qint64(total * qBound(0.0, percent, 100.0) / 100 + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < BUCKETS_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return getBucketUpperBound(i);
+        }
+    }
+    return getBucketUpperBound(BUCKETS_COUNT - 1);
+}
+
+double GHistogram::getBucketUpperBound(int bucket) const {
+    return (qint64(1) << bucket) / counterScale;
+}
+
 } //namespace
@@ -25,29 +25,116 @@
 #include <U2Core/global.h>
 
 #include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#if (QT_VERSION >= 0x050300)
+#include <QtCore/QAtomicInteger>
+#endif
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
 
 namespace U2 {
 
+/* A 64-bit value that is changed by one thread and read by other threads */
+class GCounterValue {
+public:
+    GCounterValue() : value(0) {}
+
+#if (QT_VERSION >= 0x050300)
+    void add(qint64 delta) {value.store(value.load() + delta);}
+    qint64 get() const {return value.load();}
+
+private:
+    QAtomicInteger<qint64> value;
+#else
+    void add(qint64 delta) {QMutexLocker locker(&lock); value += delta;}
+    qint64 get() const {QMutexLocker locker(&lock); return value;}
+
+private:
+    mutable QMutex lock;
+    qint64 value;
+#endif
+};
+
+/* A part of the counter value that is changed by one thread only */
+class GCounterShard {
+public:
+    GCounterShard(int bucketsCount) : buckets(new GCounterValue[bucketsCount]) {}
+    ~GCounterShard() {delete[] buckets;}
+
+    GCounterValue value;
+    GCounterValue *buckets;
+
+private:
+    Q_DISABLE_COPY(GCounterShard)
+};
+
+class GCounter;
+
+/* Folds the shard into the counter when the thread finishes */
+class U2CORE_EXPORT GCounterShardRef {
+public:
+    GCounterShardRef() : counter(NULL), shard(NULL) {}
+    ~GCounterShardRef();
+
+    GCounter *counter;
+    GCounterShard *shard;
+};
+
+/**
+ * The counter value is sharded by threads: a thread changes its own shard without contention,
+ * readers sum all shards. Shards of finished threads are folded into the base value.
+ */
 class U2CORE_EXPORT GCounter : public QObject {
     Q_OBJECT
 public:
     GCounter(const QString& name, const QString& suffix, double scale = 1);
     virtual ~GCounter();
 
-    static const QList<GCounter*>& allCounters() {return getCounters();}
+    /* Thread-safe: returns a copy of the counters list */
+    static QList<GCounter*> allCounters();
     static GCounter *getCounter(const QString &name, const QString &suffix);
 
+    /* Thread-safe */
+    void add(qint64 value = 1) {getShard()->value.add(value);}
+    /* Thread-safe, the default implementation adds the value */
+    virtual void observe(qint64 value);
+    qint64 getTotal() const;
+
     QString name;
     QString suffix;
-    qint64  totalCount;
     double  counterScale;
     bool    destroyMe; //true if counter should be deleted by counter list
 
-    double scaledTotal() const {return totalCount / counterScale;}
+    double scaledTotal() const {return getTotal() / counterScale;}
 
 protected:
+    GCounter(const QString& name, const QString& suffix, double scale, int bucketsCount);
+
+    GCounterShard * getShard() {
+        GCounterShardRef &ref = threadShard.localData();
+        return (NULL != ref.shard) ? ref.shard : createShard();
+    }
+    /* Sums the buckets of all shards */
+    QVector<qint64> getBucketsTotal() const;
+    /* Shards keep their values, the base value is adjusted */
+    void setTotal(qint64 value);
 
     static QList<GCounter*>& getCounters();
+
+private:
+    friend class GCounterShardRef;
+
+    GCounterShard * createShard();
+    void releaseShard(GCounterShard *shard);
+
+    mutable QMutex shardsLock;
+    qint64 baseValue;
+    const int bucketsCount;
+    QVector<qint64> baseBuckets;
+    // shards of running threads only
+    QList<GCounterShard *> shards;
+    QThreadStorage<GCounterShardRef> threadShard;
 };
 
 class GCounterList {
@@ -57,6 +144,37 @@ public:
     QList<GCounter *> list;
 };
 
+/**
+ * A value that can go up and down, e.g. a queue length or a memory usage.
+ */
+class U2CORE_EXPORT GGauge : public GCounter {
+    Q_OBJECT
+public:
+    GGauge(const QString& name, const QString& suffix, double scale = 1);
+
+    void set(qint64 value);
+};
+
+/**
+ * Keeps the distribution of observed values (e.g. latencies) in power of two buckets,
+ * the counter value is the sum of the observed values.
+ */
+class U2CORE_EXPORT GHistogram : public GCounter {
+    Q_OBJECT
+public:
+    GHistogram(const QString& name, const QString& suffix, double scale = 1);
+
+    virtual void observe(qint64 value);
+
+    qint64 getObservationsCount() const;
+    /* Observations count in each bucket, bucket i contains values not greater than getBucketUpperBound(i) */
+    QVector<qint64> getBuckets() const;
+    /* Returns the scaled upper bound of the bucket containing the percentile (0..100) */
+    double getPercentile(double percent) const;
+    double getBucketUpperBound(int bucket) const;
+
+    static const int BUCKETS_COUNT;
+};
 
 //Marks that counter will be reported by Shtirlitz
 //TODO: implement GPerformanceCounter for plugin_perf_monitor?
@@ -70,7 +188,7 @@ public:
 class U2CORE_EXPORT SimpleEventCounter {
 public:
     SimpleEventCounter(GCounter* tc) : totalCounter(tc), eventCount(1){ assert(tc!=NULL);}
-    virtual ~SimpleEventCounter() {totalCounter->totalCount+=eventCount;}
+    virtual ~SimpleEventCounter() {totalCounter->add(eventCount);}
 private:
     GCounter*   totalCounter;
     qint64      eventCount;
@@ -88,6 +206,9 @@ private:
     } \
     SimpleEventCounter tvar(cvar)
 
+#define GGAUGE(cvar, name, suffix) \
+    static GGauge cvar(name, suffix, 1)
+
 
 } //namespace
 
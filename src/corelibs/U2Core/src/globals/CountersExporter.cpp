@@ -0,0 +1,164 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtCore/QRegExp>
+#include <QtCore/QTextStream>
+
+#include <U2Core/Counter.h>
+#include <U2Core/L10n.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "CountersExporter.h"
+
+namespace U2 {
+
+const int CountersExporter::DEFAULT_INTERVAL_SECONDS = 10;
+
+CountersExporter::CountersExporter(const QString &url, int intervalSeconds, QObject *parent)
+    : QObject(parent), url(url)
+{
+    connect(&timer, SIGNAL(timeout()), SLOT(sl_dump()));
+    timer.start(1000 * qMax(1, intervalSeconds));
+}
+
+void CountersExporter::sl_dump() {
+    U2OpStatus2Log os;
+    dump(os);
+}
+
+void CountersExporter::dump(U2OpStatus &os) {
+    const QString tmpUrl = url + ".tmp";
+    QFile file(tmpUrl);
+    CHECK_EXT(file.open(QIODevice::WriteOnly | QIODevice::Truncate), os.setError(L10N::errorOpeningFileWrite(tmpUrl)), );
+    const QByteArray data = formatCounters().toUtf8();
+    CHECK_EXT(file.write(data) == data.size(), os.setError(L10N::errorWritingFile(tmpUrl)), );
+    file.close();
+
+    QFile::remove(url);
+    CHECK_EXT(QFile::rename(tmpUrl, url), os.setError(L10N::errorWritingFile(url)), );
+}
+
+namespace {
+
+QString toMetricName(const GCounter *counter) {
+    QString result = "ugene_" + counter->name;
+    if (!counter->suffix.isEmpty()) {
+        result += "_" + counter->suffix;
+    }
+    result.replace(QRegExp("[^a-zA-Z0-9_]+"), "_");
+    return result.toLower();
+}
+
+QString formatValue(double value) {
+    return QString::number(value, 'g', 12);
+}
+
+/* Counters with the same metric name are merged */
+class Metric {
+public:
+    Metric() : type(Counter), total(0), count(0) {}
+
+    enum Type {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    QStringList names;
+    Type type;
+    double total;
+    qint64 count;
+    QVector<qint64> buckets;
+    QVector<double> bounds;
+};
+
+}
+
+QString CountersExporter::formatCounters() {
+    QMap<QString, Metric> metrics;
+    foreach (const GCounter *counter, GCounter::allCounters()) {
+        Metric &metric = metrics[toMetricName(counter)];
+        if (!metric.names.contains(counter->name)) {
+            metric.names << counter->name;
+        }
+        metric.total += counter->scaledTotal();
+
+        const GHistogram *histogram = qobject_cast<const GHistogram *>(counter);
+        if (NULL != histogram) {
+            metric.type = Metric::Histogram;
+            const QVector<qint64> buckets = histogram->getBuckets();
+            if (metric.buckets.isEmpty()) {
+                metric.buckets.fill(0, buckets.size());
+                for (int i = 0; i < buckets.size(); i++) {
+                    metric.bounds << histogram->getBucketUpperBound(i);
+                }
+            }
+            for (int i = 0; i < buckets.size() && i < metric.buckets.size(); i++) {
+                metric.buckets[i] += buckets[i];
+                metric.count += buckets[i];
+            }
+        } else if (NULL != qobject_cast<const GGauge *>(counter)) {
+            metric.type = Metric::Gauge;
+        }
+    }
+
+    QString result;
+    QTextStream stream(&result);
+    foreach (const QString &name, metrics.keys()) {
+        const Metric &metric = metrics[name];
+        stream << "# HELP " << name << " " << metric.names.join(", ") << "\n";
+        switch (metric.type) {
+        case Metric::Counter:
+            stream << "# TYPE " << name << " counter\n";
+            stream << name << " " << formatValue(metric.total) << "\n";
+            break;
+        case Metric::Gauge:
+            stream << "# TYPE " << name << " gauge\n";
+            stream << name << " " << formatValue(metric.total) << "\n";
+            break;
+        case Metric::Histogram: {
+            stream << "# TYPE " << name << " histogram\n";
+            int lastBucket = metric.buckets.size() - 1;
+            while (lastBucket > 0 && 0 == metric.buckets[lastBucket]) {
+                lastBucket--;
+            }
+            qint64 cumulative = 0;
+            for (int i = 0; i <= lastBucket; i++) {
+                cumulative += metric.buckets[i];
+                stream << name << "_bucket{le=\"" << formatValue(metric.bounds[i]) << "\"} " << cumulative << "\n";
+            }
+            stream << name << "_bucket{le=\"+Inf\"} " << metric.count << "\n";
+            stream << name << "_sum " << formatValue(metric.total) << "\n";
+            stream << name << "_count " << metric.count << "\n";
+            break;
+        }
+        }
+    }
+    stream.flush();
+    return result;
+}
+
+} // U2
@@ -0,0 +1,58 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_COUNTERS_EXPORTER_H_
+#define _U2_COUNTERS_EXPORTER_H_
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <U2Core/U2OpStatus.h>
+
+namespace U2 {
+
+/**
+ * Periodically writes values of all counters to a file in the Prometheus text exposition format.
+ * The file is replaced atomically, so it can be read by a monitoring agent at any moment.
+ */
+class U2CORE_EXPORT CountersExporter : public QObject {
+    Q_OBJECT
+public:
+    CountersExporter(const QString &url, int intervalSeconds, QObject *parent = NULL);
+
+    void dump(U2OpStatus &os);
+
+    static QString formatCounters();
+
+    static const int DEFAULT_INTERVAL_SECONDS;
+
+private slots:
+    void sl_dump();
+
+private:
+    const QString url;
+    QTimer timer;
+};
+
+} // U2
+
+#endif // _U2_COUNTERS_EXPORTER_H_
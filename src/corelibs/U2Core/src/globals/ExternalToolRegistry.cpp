@@ -27,6 +27,7 @@
 #include <U2Core/U2SafePoints.h>
 
 #include <U2Core/Log.h>
+#include <U2Core/PluginModel.h>
 namespace U2 {
 
 ////////////////////////////////////////
@@ -109,6 +110,7 @@ bool ExternalToolRegistry::registerEntry(ExternalTool *t){
     } else {
         registryOrder.append(t);
         registry.insert(t->getName(), t);
+        PluginSupport::reportRegistry("ExternalToolRegistry");
         return true;
     }
 }
@@ -0,0 +1,205 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <math.h>
+
+#include <QtCore/QFile>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/Log.h>
+#include <U2Core/Settings.h>
+#include <U2Core/U2SafePoints.h>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+#include "ExternalToolResourcePlanner.h"
+
+namespace U2 {
+
+#define SETTINGS_ROOT QString("external_tool_usage/")
+#define MEMORY_KEY "/memory"
+#define CORES_KEY "/cores_per_thread"
+
+namespace {
+
+QString settingsGroup(const QString &toolName) {
+    return SETTINGS_ROOT + QString(toolName).replace('/', '_');
+}
+
+}
+
+/************************************************************************/
+/* ExternalToolResourcePlanner */
+/************************************************************************/
+ExternalToolResourcePlanner::ExternalToolResourcePlanner(AppResourceSemaphore *cpuResource, AppResourceSemaphore *memoryResource)
+    : cpuResource(cpuResource), memoryResource(memoryResource)
+{
+
+}
+
+int ExternalToolResourcePlanner::getThreadsQuota(int requestedThreads) const {
+    return qBound(1, requestedThreads, cpuResource->maxUse());
+}
+
+QList<TaskResourceUsage> ExternalToolResourcePlanner::planResources(const QString &toolName, int threadsCount) {
+    const UsageEstimation estimation = getEstimation(toolName);
+    QList<TaskResourceUsage> result;
+
+    // a tool often does not load all its threads, e.g. while it reads the input
+    int cores = threadsCount;
+    if (estimation.coresPerThread > 0) {
+        cores = (int)ceil(estimation.coresPerThread * threadsCount);
+    }
+    cores = qBound(1, cores, cpuResource->maxUse());
+    result << TaskResourceUsage(RESOURCE_EXTERNAL_TOOL_CPU, cores, false);
+
+    const int memoryMb = qMin(estimation.memoryMb, memoryResource->maxTaskUse());
+    if (memoryMb > 0) {
+        result << TaskResourceUsage(RESOURCE_MEMORY, memoryMb, false);
+    }
+
+    coreLog.trace(QString("%1 is planned to use %2 cores and %3 Mb of memory").arg(toolName).arg(cores).arg(memoryMb));
+    return result;
+}
+
+void ExternalToolResourcePlanner::registerUsage(const QString &toolName, int threadsCount, int peakMemoryMb, double cpuSeconds, double wallSeconds) {
+    QMutexLocker locker(&mutex);
+    UsageEstimation estimation = estimations.contains(toolName) ? estimations[toolName] : UsageEstimation();
+
+    // the estimation follows the growth at once and goes down slowly
+    if (peakMemoryMb > estimation.memoryMb) {
+        estimation.memoryMb = peakMemoryMb;
+    } else {
+        estimation.memoryMb = (3 * estimation.memoryMb + peakMemoryMb) / 4;
+    }
+
+    // too short runs do not show the real load
+    if (wallSeconds >= 1 && threadsCount > 0) {
+        const double coresPerThread = cpuSeconds / wallSeconds / threadsCount;
+        estimation.coresPerThread = (estimation.coresPerThread > 0) ? (estimation.coresPerThread + coresPerThread) / 2 : coresPerThread;
+    }
+    estimations[toolName] = estimation;
+
+    Settings *settings = AppContext::getSettings();
+    CHECK(NULL != settings, );
+    settings->setValue(settingsGroup(toolName) + MEMORY_KEY, estimation.memoryMb);
+    settings->setValue(settingsGroup(toolName) + CORES_KEY, estimation.coresPerThread);
+}
+
+ExternalToolResourcePlanner::UsageEstimation ExternalToolResourcePlanner::getEstimation(const QString &toolName) {
+    QMutexLocker locker(&mutex);
+    if (!estimations.contains(toolName)) {
+        UsageEstimation estimation;
+        Settings *settings = AppContext::getSettings();
+        if (NULL != settings) {
+            estimation.memoryMb = settings->getValue(settingsGroup(toolName) + MEMORY_KEY, 0).toInt();
+            estimation.coresPerThread = settings->getValue(settingsGroup(toolName) + CORES_KEY, 0).toDouble();
+        }
+        estimations[toolName] = estimation;
+    }
+    return estimations[toolName];
+}
+
+/************************************************************************/
+/* ExternalToolUsageMonitor */
+/************************************************************************/
+ExternalToolUsageMonitor::ExternalToolUsageMonitor(qint64 pid)
+    : pid(pid), lastSampleTime(0), sampled(false), peakMemoryMb(0), cpuSeconds(0)
+{
+    timer.start();
+}
+
+void ExternalToolUsageMonitor::update() {
+    const int now = timer.elapsed();
+    if (sampled && now - lastSampleTime < 1000) {
+        return;
+    }
+    lastSampleTime = now;
+    sample();
+}
+
+bool ExternalToolUsageMonitor::hasStatistics() const {
+    return sampled;
+}
+
+int ExternalToolUsageMonitor::getPeakMemoryMb() const {
+    return peakMemoryMb;
+}
+
+double ExternalToolUsageMonitor::getCpuSeconds() const {
+    return cpuSeconds;
+}
+
+double ExternalToolUsageMonitor::getWallSeconds() const {
+    return timer.elapsed() / 1000.0;
+}
+
+int ExternalToolUsageMonitor::parsePeakMemoryMb(const QByteArray &status) {
+    // the line is "VmHWM:    123456 kB"
+    foreach (const QByteArray &line, status.split('\n')) {
+        if (line.startsWith("VmHWM:")) {
+            const QList<QByteArray> values = line.mid(6).simplified().split(' ');
+            bool ok = false;
+            const qint64 kb = values.first().toLongLong(&ok);
+            return ok ? int(kb / 1024) : -1;
+        }
+    }
+    return -1;
+}
+
+qint64 ExternalToolUsageMonitor::parseCpuTicks(const QByteArray &stat) {
+    // the process name can contain spaces, the fields go after the closing bracket: state is the 3rd field, utime and stime are the 14th and 15th ones
+    const int nameEnd = stat.lastIndexOf(')');
+    CHECK(nameEnd >= 0, -1);
+    const QList<QByteArray> fields = stat.mid(nameEnd + 2).split(' ');
+    CHECK(fields.size() > 12, -1);
+    bool userOk = false;
+    bool systemOk = false;
+    const qint64 ticks = fields[11].toLongLong(&userOk) + fields[12].toLongLong(&systemOk);
+    CHECK(userOk && systemOk, -1);
+    return ticks;
+}
+
+void ExternalToolUsageMonitor::sample() {
+#if defined(Q_OS_LINUX)
+    const QString procDir = QString("/proc/%1/").arg(pid);
+
+    QFile status(procDir + "status");
+    CHECK(status.open(QIODevice::ReadOnly), );
+    peakMemoryMb = qMax(peakMemoryMb, parsePeakMemoryMb(status.readAll()));
+    status.close();
+
+    QFile stat(procDir + "stat");
+    CHECK(stat.open(QIODevice::ReadOnly), );
+    const qint64 ticks = parseCpuTicks(stat.readAll());
+    stat.close();
+    CHECK(ticks >= 0, );
+    const double ticksPerSecond = sysconf(_SC_CLK_TCK);
+    CHECK(ticksPerSecond > 0, );
+    cpuSeconds = ticks / ticksPerSecond;
+    sampled = true;
+#endif
+}
+
+} // U2
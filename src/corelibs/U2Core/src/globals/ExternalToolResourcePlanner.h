@@ -0,0 +1,103 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_EXTERNAL_TOOL_RESOURCE_PLANNER_H_
+#define _U2_EXTERNAL_TOOL_RESOURCE_PLANNER_H_
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QTime>
+
+#include <U2Core/Task.h>
+
+namespace U2 {
+
+class AppResourceSemaphore;
+
+/**
+ * Shares the CPU cores and the memory between the external tools that are running at the same time.
+ * A tool run locks its cores and its memory estimation as task resources,
+ * so the task scheduler postpones the launch until the budget is available.
+ * The estimations are refined by the resources that the previous runs of the tool really used.
+ */
+class U2CORE_EXPORT ExternalToolResourcePlanner {
+public:
+    ExternalToolResourcePlanner(AppResourceSemaphore *cpuResource, AppResourceSemaphore *memoryResource);
+
+    /** The number of threads that a tool can start: the request bounded by the cores budget */
+    int getThreadsQuota(int requestedThreads) const;
+
+    /** The resources that a run of the tool with the given threads count locks */
+    QList<TaskResourceUsage> planResources(const QString &toolName, int threadsCount);
+
+    void registerUsage(const QString &toolName, int threadsCount, int peakMemoryMb, double cpuSeconds, double wallSeconds);
+
+private:
+    class UsageEstimation {
+    public:
+        UsageEstimation() : memoryMb(0), coresPerThread(0) {}
+        int memoryMb;
+        double coresPerThread;
+    };
+
+    UsageEstimation getEstimation(const QString &toolName);
+
+    AppResourceSemaphore *cpuResource;
+    AppResourceSemaphore *memoryResource;
+    QMutex mutex;
+    QHash<QString, UsageEstimation> estimations;
+};
+
+/**
+ * Samples the peak memory and the CPU time of a running process.
+ * The statistics are available only on Linux.
+ */
+class U2CORE_EXPORT ExternalToolUsageMonitor {
+public:
+    ExternalToolUsageMonitor(qint64 pid);
+
+    /** Takes a new sample if the previous one is older than a second */
+    void update();
+
+    bool hasStatistics() const;
+    int getPeakMemoryMb() const;
+    double getCpuSeconds() const;
+    double getWallSeconds() const;
+
+    /** Returns the peak resident memory from the content of /proc/<pid>/status or -1 if there is no VmHWM line */
+    static int parsePeakMemoryMb(const QByteArray &status);
+    /** Returns the user and system CPU time ticks from the content of /proc/<pid>/stat or -1 if it is malformed */
+    static qint64 parseCpuTicks(const QByteArray &stat);
+
+private:
+    void sample();
+
+    qint64 pid;
+    QTime timer;
+    int lastSampleTime;
+    bool sampled;
+    int peakMemoryMb;
+    double cpuSeconds;
+};
+
+} // U2
+
+#endif // _U2_EXTERNAL_TOOL_RESOURCE_PLANNER_H_
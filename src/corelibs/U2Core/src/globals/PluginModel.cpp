@@ -19,6 +19,8 @@
  * MA 02110-1301, USA.
  */
 
+#include <U2Core/AppContext.h>
+
 #include "PluginModel.h"
 
 namespace U2 {
@@ -43,4 +45,11 @@ void Plugin::setId(const QString &value) {
     id = value;
 }
 
+void PluginSupport::reportRegistry(const QString& registryName) {
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps) {
+        ps->addCapability(PluginCapability_Registry, registryName);
+    }
+}
+
 }//namespace
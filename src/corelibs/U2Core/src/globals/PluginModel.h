@@ -47,6 +47,15 @@ enum PluginState {
     PluginState_FailedToLoad
 };
 
+// kinds of objects that plugins register and that can be requested before the plugin is loaded
+enum PluginCapability {
+    PluginCapability_DocumentFormat,
+    PluginCapability_WorkflowActor,
+    PluginCapability_CmdlineOption,
+    // a registry that can't load a plugin on demand, the plugin populating it is always loaded at start-up
+    PluginCapability_Registry
+};
+
 class U2CORE_EXPORT Plugin : public QObject {
     Q_OBJECT
 public:
@@ -101,6 +110,17 @@ public:
     virtual void setLicenseAccepted(Plugin* p) = 0;
     virtual bool isAllPluginsLoaded() const = 0;
 
+    // registries report the registered objects, they are remembered for the plugin being loaded
+    virtual void addCapability(PluginCapability type, const QString& id) = 0;
+    // registries call it if the requested object is not found: the not loaded plugin that provides it is loaded
+    // returns true if a plugin has been loaded
+    virtual bool loadPluginProviding(PluginCapability type, const QString& id) = 0;
+    // loads all the not loaded plugins that provide objects of @type, e.g. before every format checks a file
+    virtual void loadPluginsProviding(PluginCapability type) = 0;
+
+    // registries that can't load plugins on demand report themselves when they are populated
+    static void reportRegistry(const QString& registryName);
+
 signals:
     void si_pluginAdded(Plugin*);
     void si_pluginRemoveFlagChanged(Plugin*);
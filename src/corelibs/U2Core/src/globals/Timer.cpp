@@ -53,7 +53,7 @@ static qint64 getCorrection() {
     tc.start(); tc.stop();
     tc.start(); tc.stop();
 
-    qint64 correction = totalCounter.totalCount / 4;
+    qint64 correction = totalCounter.getTotal() / 4;
     return correction;
 }
 
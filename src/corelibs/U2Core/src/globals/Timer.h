@@ -79,7 +79,7 @@ private:
 };
 
 #define GTIMER(cvar, tvar, name) \
-    static GCounter cvar(name, TimeCounter::getCounterSuffix(), TimeCounter::getCounterScale()); \
+    static GHistogram cvar(name, TimeCounter::getCounterSuffix(), TimeCounter::getCounterScale()); \
     TimeCounter tvar(&cvar, true)
 
 
@@ -123,7 +123,7 @@ void TimeCounter::start() {
 void TimeCounter::stop() {
     assert(started);
     qint64 endTime = getCounter();
-    totalCounter->totalCount += endTime - startTime - correction;
+    totalCounter->observe(endTime - startTime - correction);
     started = false;
 }
 
@@ -24,9 +24,19 @@
 
 #include <U2Core/U2SafePoints.h>
 #include <U2Core/DocumentModel.h>
+#include <U2Core/Timer.h>
 
 namespace U2 {
 
+static GCounter bytesReadCounter("LocalFileAdapter::bytesRead", "bytes");
+static GCounter bytesWrittenCounter("LocalFileAdapter::bytesWritten", "bytes");
+
+// Both buffered and direct reads are reported by one histogram: counter names must be unique
+static GHistogram & getReadLatency() {
+    static GHistogram readLatency("LocalFileAdapter::read", TimeCounter::getCounterSuffix(), TimeCounter::getCounterScale());
+    return readLatency;
+}
+
 LocalFileAdapterFactory::LocalFileAdapterFactory(QObject* o) : IOAdapterFactory(o) {
     name = tr("Local file");
 }
@@ -100,6 +110,7 @@ qint64 LocalFileAdapter::readBlock(char* data, qint64 size) {
         qint64 copySize = 0;
         while (l < size) {
             if (currentPos == bufLen) {
+                TimeCounter readTimer(&getReadLatency());
                 bufLen = f->read(bufData, BUF_SIZE);
                 if (bufLen == -1){
                     //error
@@ -116,14 +127,25 @@ qint64 LocalFileAdapter::readBlock(char* data, qint64 size) {
             currentPos += copySize;
         }
     } else {
+        TimeCounter readTimer(&getReadLatency());
         l = f->read(data, size);
     }
+    if (l > 0) {
+        bytesReadCounter.add(l);
+    }
     return l;
 }
 
 qint64 LocalFileAdapter::writeBlock(const char* data, qint64 size) {
     SAFE_POINT(isOpen(), "Adapter is not opened!",-1);
-    qint64 l = f->write(data, size);
+    qint64 l = 0;
+    {
+        GTIMER(cvar, tvar, "LocalFileAdapter::write");
+        l = f->write(data, size);
+    }
+    if (l > 0) {
+        bytesWrittenCounter.add(l);
+    }
     fileSize += size;
     return l;
 }
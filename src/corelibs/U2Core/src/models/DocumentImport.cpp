@@ -21,6 +21,7 @@
 
 #include <U2Core/DocumentImport.h>
 #include <U2Core/Log.h>
+#include <U2Core/PluginModel.h>
 
 namespace U2 {
 
@@ -40,6 +41,7 @@ DocumentImporter* DocumentImportersRegistry::getDocumentImporter(const QString&
 
 void DocumentImportersRegistry::addDocumentImporter(DocumentImporter* i) {
     importers << i;
+    PluginSupport::reportRegistry("DocumentImportersRegistry");
     if (i->getImporterDescription().isEmpty()) {
         coreLog.trace("Warn! Importer has no description: " + i->getImporterName());
     }
@@ -28,6 +28,7 @@
 #include <U2Core/IOAdapterUtils.h>
 #include <U2Core/MAlignmentObject.h>
 #include <U2Core/MSAUtils.h>
+#include <U2Core/PluginModel.h>
 #include <U2Core/ProjectModel.h>
 #include <U2Core/SequenceUtils.h>
 #include <U2Core/U2SafePoints.h>
@@ -89,6 +90,12 @@ static void placeOrderedByScore(const FormatDetectionResult& info, QList<FormatD
 QList<FormatDetectionResult> DocumentUtils::detectFormat( const QByteArray& rawData, const QString& ext,
                                                      const GUrl& url, const FormatDetectionConfig& conf)
 {
+    // every format checks the data: the formats of the plugins that are not loaded yet are needed too
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps) {
+        ps->loadPluginsProviding(PluginCapability_DocumentFormat);
+    }
+
     DocumentFormatRegistry* fr = AppContext::getDocumentFormatRegistry();
     QList< DocumentFormatId > allFormats = fr->getRegisteredFormats();
 
@@ -23,9 +23,11 @@
 
 #include <U2Core/AnnotationTableObject.h>
 #include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
 #include <U2Core/AppSettings.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/ExternalToolRegistry.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Core/GUrlUtils.h>
 #include <U2Core/IOAdapter.h>
 #include <U2Core/L10n.h>
@@ -33,6 +35,7 @@
 #include <U2Core/SaveDocumentTask.h>
 #include <U2Core/UserApplicationsSettings.h>
 #include <U2Core/ScriptingToolRegistry.h>
+#include <U2Core/U2OpStatusUtils.h>
 #include <U2Core/U2SafePoints.h>
 
 #include <QtCore/QDir>
@@ -52,6 +55,16 @@ namespace U2 {
 
 #define WIN_LAUNCH_CMD_COMMAND "cmd /C "
 #define START_WAIT_MSEC 3000
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
+////////////////////////////////////////
+//ExternalToolOutputConsumer
+ExternalToolOutputConsumer::~ExternalToolOutputConsumer() {
+
+}
+
+////////////////////////////////////////
+//ExternalToolRunTask
 
 ExternalToolRunTask::ExternalToolRunTask(const QString &_toolName, const QStringList &_arguments,
 ExternalToolLogParser *_logParser, const QString &_workingDirectory, const QStringList &_additionalPaths,
@@ -66,7 +79,8 @@ const QString &_additionalProcessToKill, bool parseOutputFile)
   helper(NULL),
   listener(NULL),
   additionalProcessToKill(_additionalProcessToKill),
-  parseOutputFile(parseOutputFile)
+  parseOutputFile(parseOutputFile),
+  threadsCount(0)
 {
     coreLog.trace("Creating run task for: " + toolName);
     if (NULL != logParser) {
@@ -120,12 +134,24 @@ void ExternalToolRunTask::run(){
         }
         return;
     }
-    while(!externalToolProcess->waitForFinished(1000)){
-        if (isCanceled()) {
-            killProcess();
-            algoLog.details(tr("Tool %1 is cancelled").arg(toolName));
-            return;
+#if (!defined(Q_OS_WIN32) && !defined(Q_OS_WINCE)) || defined(qdoc)
+    ExternalToolUsageMonitor usageMonitor(externalToolProcess->pid());
+#else
+    ExternalToolUsageMonitor usageMonitor(externalToolProcess->pid()->dwProcessId);
+#endif
+    usageMonitor.update();
+    if (outputConsumer.isNull()) {
+        while(!externalToolProcess->waitForFinished(1000)){
+            usageMonitor.update();
+            if (isCanceled()) {
+                killProcess();
+                algoLog.details(tr("Tool %1 is cancelled").arg(toolName));
+                return;
+            }
         }
+    } else {
+        consumeStandartOutput(usageMonitor);
+        CHECK(!isCanceled() && QProcess::NotRunning == externalToolProcess->state(), );
     }
 
     {
@@ -139,7 +165,37 @@ void ExternalToolRunTask::run(){
             setError(error.isEmpty() ? tr("%1 tool exited with code %2").arg(toolName).arg(exitCode) : error);
         } else {
             algoLog.details(tr("Tool %1 finished successfully").arg(toolName));
+            registerUsage(usageMonitor);
+        }
+    }
+
+    if (!outputConsumer.isNull() && !hasError()) {
+        outputConsumer->finish(stateInfo);
+    }
+}
+
+void ExternalToolRunTask::consumeStandartOutput(ExternalToolUsageMonitor &usageMonitor) {
+    QByteArray buffer(OUTPUT_BUFFER_SIZE, 0);
+    U2OpStatusImpl consumerOs;
+    forever {
+        usageMonitor.update();
+        // the log helper switches the channel to read the error output
+        externalToolProcess->setReadChannel(QProcess::StandardOutput);
+        const qint64 readBytes = externalToolProcess->read(buffer.data(), buffer.size());
+        if (readBytes > 0) {
+            outputConsumer->consume(buffer.constData(), readBytes, consumerOs);
+            CHECK_EXT(!consumerOs.hasError(), killProcess(); setError(consumerOs.getError()), );
+            continue;
+        }
+        if (isCanceled()) {
+            killProcess();
+            algoLog.details(tr("Tool %1 is cancelled").arg(toolName));
+            return;
+        }
+        if (QProcess::NotRunning == externalToolProcess->state()) {
+            return;
         }
+        externalToolProcess->waitForReadyRead(1000);
     }
 }
 
@@ -204,6 +260,25 @@ void ExternalToolRunTask::addOutputListener(ExternalToolListener* outputListener
     listener = outputListener;
 }
 
+void ExternalToolRunTask::reserveResources(int _threadsCount) {
+    SAFE_POINT(isNew(), "Resources can be reserved only for a new task", );
+    threadsCount = _threadsCount;
+    ExternalToolResourcePlanner *planner = AppResourcePool::instance()->getExternalToolResourcePlanner();
+    foreach (const TaskResourceUsage &usage, planner->planResources(toolName, threadsCount)) {
+        addTaskResource(usage);
+    }
+}
+
+void ExternalToolRunTask::registerUsage(const ExternalToolUsageMonitor &usageMonitor) {
+    CHECK(threadsCount > 0 && usageMonitor.hasStatistics(), );
+    ExternalToolResourcePlanner *planner = AppResourcePool::instance()->getExternalToolResourcePlanner();
+    planner->registerUsage(toolName, threadsCount, usageMonitor.getPeakMemoryMb(), usageMonitor.getCpuSeconds(), usageMonitor.getWallSeconds());
+}
+
+void ExternalToolRunTask::setStandartOutputConsumer(ExternalToolOutputConsumer *consumer) {
+    outputConsumer.reset(consumer);
+}
+
 void ExternalToolRunTask::parseStandartOutputFile(QString &filepath) {
     QFile f(filepath);
     if (!f.open(QIODevice::ReadOnly)) {
@@ -240,7 +315,9 @@ ExternalToolRunTaskHelper::ExternalToolRunTaskHelper(ExternalToolRunTask* t)
 : process(t->externalToolProcess), logParser(t->logParser), os(t->stateInfo), listener(NULL)
 {
     logData.resize(1000);
-    connect(process, SIGNAL(readyReadStandardOutput()), SLOT(sl_onReadyToReadLog()));
+    if (t->outputConsumer.isNull()) {
+        connect(process, SIGNAL(readyReadStandardOutput()), SLOT(sl_onReadyToReadLog()));
+    }
     connect(process, SIGNAL(readyReadStandardError()), SLOT(sl_onReadyToReadErrLog()));
 }
 
@@ -34,6 +34,7 @@ class ExternalToolLogParser;
 class ExternalToolRunTaskHelper;
 class SaveDocumentTask;
 class ExternalToolListener;
+class ExternalToolUsageMonitor;
 
 //using namespace Workflow;
 
@@ -46,6 +47,20 @@ public:
     QStringList arguments;
 };
 
+/**
+ * Receives the standard output of an external tool while the tool is running.
+ * The tool output is not read until consume() returns, so the tool waits for a slow consumer
+ * instead of accumulating its output in memory or in a temporary file.
+ */
+class U2CORE_EXPORT ExternalToolOutputConsumer {
+public:
+    virtual ~ExternalToolOutputConsumer();
+
+    virtual void consume(const char *data, int size, U2OpStatus &os) = 0;
+    /** Is called when the tool has successfully finished and all its output is consumed */
+    virtual void finish(U2OpStatus &os) = 0;
+};
+
 class U2CORE_EXPORT ExternalToolRunTask: public Task {
     Q_OBJECT
     Q_DISABLE_COPY(ExternalToolRunTask)
@@ -65,12 +80,21 @@ public:
 
     void setStandartInputFile(const QString& file) { inputFile = file; }
     void setStandartOutputFile(const QString& file) { outputFile = file; }
+    /** The task takes the ownership of the consumer. The standard output is not parsed as a log in this case */
+    void setStandartOutputConsumer(ExternalToolOutputConsumer *consumer);
     void setAdditionalEnvVariables(const  QMap<QString, QString> &envVariable) {additionalEnvVariables = envVariable; }
+    /**
+     * The tool will run with @threadsCount threads: the launch is postponed
+     * until the external tools CPU and memory budget allows it. Call it before the task is started.
+     */
+    void reserveResources(int threadsCount);
 
 private:
     void killProcess() const;
     QList<long> getChildPidsRecursive(long parentPid) const;
     void parseStandartOutputFile(QString &filepath);
+    void consumeStandartOutput(ExternalToolUsageMonitor &usageMonitor);
+    void registerUsage(const ExternalToolUsageMonitor &usageMonitor);
 
     QStringList             arguments;
     ExternalToolLogParser*  logParser;
@@ -82,9 +106,11 @@ private:
     QMap <QString, QString> additionalEnvVariables;
     QProcess*               externalToolProcess;
     QScopedPointer<ExternalToolRunTaskHelper> helper;
+    QScopedPointer<ExternalToolOutputConsumer> outputConsumer;
     ExternalToolListener*   listener;
     QString                 additionalProcessToKill;
     bool                    parseOutputFile;
+    int                     threadsCount;
 };
 
 class U2CORE_EXPORT ExternalToolSupportTask: public Task{
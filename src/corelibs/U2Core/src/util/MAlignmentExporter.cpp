@@ -48,7 +48,7 @@ MAlignment MAlignmentExporter::getAlignment(const U2DbiRef& dbiRef, const U2Data
     QList<U2MsaRow> rows = exportRows(msaId, os);
     CHECK_OP(os, MAlignment());
 
-    QList<DNASequence> sequences = exportSequencesOfRows(rows, os);
+    QList<DNASequence> sequences = exportSequencesOfAllRows(msaId, rows, os);
     CHECK_OP(os, MAlignment());
 
     SAFE_POINT(rows.count() == sequences.count(), ROWS_SEQS_COUNT_MISMATCH_ERROR, MAlignment());
@@ -155,6 +155,13 @@ QList<DNASequence> MAlignmentExporter::exportSequencesOfRows(QList<U2MsaRow> row
     return sequences;
 }
 
+QList<DNASequence> MAlignmentExporter::exportSequencesOfAllRows(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os) const {
+    U2MsaDbi* msaDbi = con.dbi->getMsaDbi();
+    SAFE_POINT(NULL != msaDbi, NULL_MSA_DBI_ERROR, QList<DNASequence>());
+
+    return msaDbi->getRowsSequences(msaId, rows, os);
+}
+
 QVariantMap MAlignmentExporter::exportAlignmentInfo(const U2DataId& msaId, U2OpStatus& os) const {
     U2AttributeDbi* attrDbi = con.dbi->getAttributeDbi();
     SAFE_POINT(NULL != attrDbi, "NULL Attribute Dbi during exporting an alignment info!", QVariantMap());
@@ -53,6 +53,7 @@ private:
     QList<U2MsaRow>                     exportRows(const U2DataId&, U2OpStatus&) const;
     QList<U2MsaRow>                     exportRows(const U2DataId&, const QList<qint64> rowIds, U2OpStatus&) const;
     QList<DNASequence>                  exportSequencesOfRows(QList<U2MsaRow>, U2OpStatus&) const;
+    QList<DNASequence>                  exportSequencesOfAllRows(const U2DataId&, const QList<U2MsaRow>&, U2OpStatus&) const;
     QVariantMap                         exportAlignmentInfo(const U2DataId&, U2OpStatus&) const;
     U2Msa                               exportAlignmentObject(const U2DataId&, U2OpStatus&) const;
 
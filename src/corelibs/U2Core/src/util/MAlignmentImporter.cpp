@@ -51,6 +51,9 @@ MAlignmentObject * MAlignmentImporter::createAlignment(const U2DbiRef &dbiRef, c
     SAFE_POINT_EXT(NULL != con.dbi, os.setError(L10N::nullPointerError("Destination database")), NULL);
 
     TmpDbiObjects objs(dbiRef, os); // remove the MSA object if opStatus is incorrect
+    DbiOperationsBlock opBlock(dbiRef, os); // import the object, the sequences and the rows in one transaction
+    CHECK_OP(os, NULL);
+    Q_UNUSED(opBlock);
 
     // MSA object and info
     U2Msa msa = importMsaObject(con, folder, al, os);
@@ -74,6 +74,35 @@ char MsaRowUtils::charAt(const QByteArray &seq, const QList<U2MsaGap> &gaps, int
     return seq[index];
 }
 
+QByteArray MsaRowUtils::getRowSpan(const QByteArray &seq, const QList<U2MsaGap> &gaps, int pos, int count) {
+    QByteArray result(qMax(count, 0), MAlignment_GapChar);
+    CHECK(count > 0, result);
+
+    const qint64 spanEnd = (qint64)pos + count;
+    qint64 rowPos = 0;
+    int seqPos = 0;
+    QList<U2MsaGap>::const_iterator gap = gaps.constBegin();
+    while (seqPos < seq.length() && rowPos < spanEnd) {
+        // Sequence characters lay in [rowPos, segmentEnd), the next gap (if any) starts at 'segmentEnd'
+        qint64 segmentEnd = rowPos + seq.length() - seqPos;
+        if (gap != gaps.constEnd()) {
+            segmentEnd = qBound(rowPos, (qint64)gap->offset, segmentEnd);
+        }
+
+        const qint64 copyStart = qMax(rowPos, (qint64)pos);
+        const qint64 copyEnd = qMin(segmentEnd, spanEnd);
+        if (copyStart < copyEnd) {
+            memcpy(result.data() + (copyStart - pos), seq.constData() + seqPos + (copyStart - rowPos), copyEnd - copyStart);
+        }
+        seqPos += segmentEnd - rowPos;
+
+        CHECK_BREAK(gap != gaps.constEnd());
+        rowPos = segmentEnd + gap->gap;
+        ++gap;
+    }
+    return result;
+}
+
 qint64 MsaRowUtils::getRowLengthWithoutTrailing(const QByteArray &seq, const QList<U2MsaGap> &gaps) {
     int rowLength = getRowLength(seq, gaps);
     int rowLengthWithoutTrailingGap = rowLength;
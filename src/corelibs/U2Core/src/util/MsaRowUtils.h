@@ -32,6 +32,11 @@ public:
     static int getRowLength(const QByteArray &seq, const QList<U2MsaGap> &gaps);
     static int getGapsLength(const QList<U2MsaGap> &gaps);
     static char charAt(const QByteArray &seq, const QList<U2MsaGap> &gaps, int pos);
+    /**
+     * Returns 'count' characters of the row starting from 'pos' in MSA coordinates.
+     * The gap model is walked only once, positions outside the row are filled with gaps.
+     */
+    static QByteArray getRowSpan(const QByteArray &seq, const QList<U2MsaGap> &gaps, int pos, int count);
     static qint64 getRowLengthWithoutTrailing(const QByteArray &seq, const QList<U2MsaGap> &gaps);
     /**
      * The method maps `pos` in MSA coordinates to a character position in 'seq', i.e. gaps aren't taken into account.
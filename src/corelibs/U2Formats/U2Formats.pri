@@ -22,6 +22,7 @@ win32-msvc2013 {
 }
 
 QT += sql
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
 
 # Force re-linking when lib changes
 unix:POST_TARGETDEPS += ../../_release/libsamtools.a
@@ -16,6 +16,10 @@ HEADERS += src/ABIFormat.h \
            src/EMBLGenbankAbstractDocument.h \
            src/EMBLPlainTextFormat.h \
            src/FastaFormat.h \
+           src/FastaIndex.h \
+           src/FastaIndexDbi.h \
+           src/FastqBatchProcessor.h \
+           src/FastqBatchReader.h \
            src/FastqFormat.h \
            src/FpkmTrackingFormat.h \
            src/GenbankLocationParser.h \
@@ -34,6 +38,7 @@ HEADERS += src/ABIFormat.h \
            src/PlainTextFormat.h \
            src/RawDNASequenceFormat.h \
            src/SAMFormat.h \
+           src/SamToBamStreamConverter.h \
            src/SCFFormat.h \
            src/SNPDatabaseUtils.h \
            src/SimpleSNPVariationFormat.h \
@@ -92,13 +97,16 @@ HEADERS += src/ABIFormat.h \
            src/sqlite_dbi/assembly/SingleTableAssemblyAdapter.h \
            src/sqlite_dbi/util/SqliteUpgrader.h \
            src/sqlite_dbi/util/SqliteUpgraderFrom_0_To_1_13.cpp \
+           src/sqlite_dbi/util/SqliteUpgraderFrom_1_13_To_1_23.h \
            src/tasks/BgzipTask.h \
            src/tasks/ConvertAssemblyToSamTask.h \
            src/tasks/ConvertFileTask.h \
            src/tasks/MergeBamTask.h \
            src/tasks/MysqlUpgradeTask.h \
+           src/tasks/ReadIndexedFastaTask.h \
            src/util/AssemblyAdapter.h \
-           src/util/AssemblyPackAlgorithm.h
+           src/util/AssemblyPackAlgorithm.h \
+           src/util/BAMSorter.h
 SOURCES += src/ABIFormat.cpp \
            src/AbstractVariationFormat.cpp \
            src/ASNFormat.cpp \
@@ -114,6 +122,10 @@ SOURCES += src/ABIFormat.cpp \
            src/EMBLGenbankAbstractDocument.cpp \
            src/EMBLPlainTextFormat.cpp \
            src/FastaFormat.cpp \
+           src/FastaIndex.cpp \
+           src/FastaIndexDbi.cpp \
+           src/FastqBatchProcessor.cpp \
+           src/FastqBatchReader.cpp \
            src/FastqFormat.cpp \
            src/FpkmTrackingFormat.cpp \
            src/GenbankLocationParser.cpp \
@@ -130,6 +142,7 @@ SOURCES += src/ABIFormat.cpp \
            src/PlainTextFormat.cpp \
            src/RawDNASequenceFormat.cpp \
            src/SAMFormat.cpp \
+           src/SamToBamStreamConverter.cpp \
            src/SCFFormat.cpp \
            src/SimpleSNPVariationFormat.cpp \
            src/SNPDatabaseUtils.cpp \
@@ -188,12 +201,15 @@ SOURCES += src/ABIFormat.cpp \
            src/sqlite_dbi/assembly/SingleTableAssemblyAdapter.cpp \
            src/sqlite_dbi/util/SqliteUpgrader.cpp \
            src/sqlite_dbi/util/SqliteUpgraderFrom_0_To_1_13.cpp \
+           src/sqlite_dbi/util/SqliteUpgraderFrom_1_13_To_1_23.cpp \
            src/tasks/BgzipTask.cpp \
            src/tasks/ConvertAssemblyToSamTask.cpp \
            src/tasks/ConvertFileTask.cpp \
            src/tasks/MergeBamTask.cpp \
            src/tasks/MysqlUpgradeTask.cpp \
-           src/util/AssemblyPackAlgorithm.cpp
+           src/tasks/ReadIndexedFastaTask.cpp \
+           src/util/AssemblyPackAlgorithm.cpp \
+           src/util/BAMSorter.cpp
 RESOURCES += U2Formats.qrc
 TRANSLATIONS += transl/english.ts \
                 transl/russian.ts
@@ -60,6 +60,7 @@ extern "C" {
 #include <SamtoolsAdapter.h>
 
 #include "BAMUtils.h"
+#include "util/BAMSorter.h"
 
 namespace U2 {
 
@@ -127,18 +128,6 @@ namespace {
             os.setError(truncatedError(fileName));
         }
     }
-    QList<QByteArray> convertStringList(const QStringList& sList){
-        QList<QByteArray> result;
-        for(int i = 0; i < sList.size(); i++){
-            result.append(sList.at(i).toLocal8Bit());
-        }
-        return result;
-    }
-    void convertByteArray(const QList<QByteArray>& byteArray, char ** charArray){
-        for(int i = 0; i < byteArray.size(); i++){
-            charArray[i] = const_cast<char*>(byteArray[i].constData());
-        }
-    }
 }
 
 #define SAMTOOL_CHECK(cond, msg, ret) \
@@ -297,14 +286,14 @@ inline static qint64 mB2bytes(int mb) {
 #define INITIAL_SAMTOOLS_MEM_SIZE_MB 500
 #define SAMTOOLS_MEM_BOOST 5
 
-GUrl BAMUtils::sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2OpStatus &os) {
+GUrl BAMUtils::sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2OpStatus &os, int maxMemoryMb, bool buildIndex) {
     const QByteArray &bamFileName = bamUrl.getURLString().toLocal8Bit();
 
     QString baseName = sortedBamBaseName;
     if(baseName.endsWith(".bam")){
         baseName = baseName.left(baseName.size() - QString(".bam").size());
     }
-    QByteArray sortedFileName = baseName.toLocal8Bit() + ".bam";
+    const QString sortedFileName = baseName + ".bam";
 
 
     // get memory resource
@@ -318,14 +307,15 @@ GUrl BAMUtils::sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2O
     qint64 fileSizeBytes = info.size();
     CHECK_EXT(fileSizeBytes >= 0, os.setError(QString("Unknown file size: %1").arg(bamFileName.constData())), QString());
 
-    int maxMemMB = INITIAL_SAMTOOLS_MEM_SIZE_MB;
+    const int memLimitMB = (maxMemoryMb > 0) ? maxMemoryMb : INITIAL_SAMTOOLS_MEM_SIZE_MB;
+    int maxMemMB = memLimitMB;
     int fileSizeMB = bytes2MB(fileSizeBytes);
     if( fileSizeMB < 10 ) {
         maxMemMB = fileSizeMB;
     } else if( fileSizeMB < 100 ) {
         maxMemMB = fileSizeMB / SAMTOOLS_MEM_BOOST;
     }
-    maxMemMB = qMin( maxMemMB, INITIAL_SAMTOOLS_MEM_SIZE_MB);
+    maxMemMB = qMin( maxMemMB, memLimitMB);
     while (!memory->tryAcquire(maxMemMB)) {
         // reduce used memory
         maxMemMB = maxMemMB * 2 / 3;
@@ -334,27 +324,21 @@ GUrl BAMUtils::sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2O
     // sort bam
     {
         coreLog.details(BAMUtils::tr("Sort bam file: \"%1\" using %2 Mb of memory. Result sorted file is: \"%3\"")
-            .arg(QString(bamFileName)).arg(maxMemMB).arg(QString(sortedFileName)));
-        size_t maxMemBytes = (size_t)(mB2bytes(maxMemMB)); // maxMemMB < 500 Mb, so the conversation is correct!
-        bam_sort_core(0, bamFileName.constData(), baseName.toLocal8Bit().constData(), maxMemBytes); //maxMemBytes
+            .arg(QString(bamFileName)).arg(maxMemMB).arg(sortedFileName));
+        BAMSorter sorter(mB2bytes(maxMemMB), buildIndex);
+        sorter.sort(bamUrl.getURLString(), sortedFileName, os);
     }
     memory->release(maxMemMB);
 
-    return QString(sortedFileName);
+    return sortedFileName;
 }
 
-GUrl BAMUtils::mergeBam(const QStringList &bamUrls, const QString &mergetBamTargetUrl, U2OpStatus &/*os*/){
+GUrl BAMUtils::mergeBam(const QStringList &bamUrls, const QString &mergetBamTargetUrl, U2OpStatus &os, bool buildIndex){
     coreLog.details(BAMUtils::tr("Merging BAM files: \"%1\". Resulting merged file is: \"%2\"")
         .arg(QString(bamUrls.join(","))).arg(QString(mergetBamTargetUrl)));
 
-    int urlsSize = bamUrls.size();
-    char** mergeArgv = new char*[urlsSize];
-    QList<QByteArray> byteArray = convertStringList(bamUrls);
-    convertByteArray(byteArray, mergeArgv);
-
-    bam_merge_core(0, mergetBamTargetUrl.toLocal8Bit().constData(), 0, urlsSize, mergeArgv, 0, 0);
-
-    delete mergeArgv;
+    BAMSorter sorter(0, buildIndex);
+    sorter.merge(bamUrls, mergetBamTargetUrl, os);
 
     return QString(mergetBamTargetUrl);
 }
@@ -53,10 +53,16 @@ public:
     /**
      * @sortedBamBaseName is the result file path without extension.
      * Returns @sortedBamBaseName.bam
+     * @maxMemoryMb limits the memory used for sorting, the default limit is used if it is not positive.
+     * If @buildIndex is true, the index is built while the result is written.
      */
-    static GUrl sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2OpStatus &os);
+    static GUrl sortBam(const GUrl &bamUrl, const QString &sortedBamBaseName, U2OpStatus &os, int maxMemoryMb = 0, bool buildIndex = false);
 
-    static GUrl mergeBam(const QStringList &bamUrl, const QString &mergetBamTargetUrl, U2OpStatus &os);
+    /**
+     * The input files must be sorted.
+     * If @buildIndex is true, the index is built while the result is written.
+     */
+    static GUrl mergeBam(const QStringList &bamUrl, const QString &mergetBamTargetUrl, U2OpStatus &os, bool buildIndex = false);
 
     //deprecated because hangs up on big files
     static GUrl rmdupBam(const QString &bamUrl, const QString &rmdupBamTargetUrl, U2OpStatus &os, bool removeSingleEnd = false, bool treatReads = false);
@@ -0,0 +1,433 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppSettings.h>
+#include <U2Core/IOAdapter.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/Log.h>
+#include <U2Core/TextUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+#include <U2Core/UserApplicationsSettings.h>
+
+#include "FastaFormat.h"
+#include "FastaIndex.h"
+
+namespace U2 {
+
+FastaIndexEntry::FastaIndexEntry()
+    : length(0), offset(0), lineBases(0), lineWidth(0)
+{
+
+}
+
+bool FastaIndexEntry::isRegular() const {
+    return lineBases > 0 || 0 == length;
+}
+
+namespace {
+    const qint64 READ_BLOCK_SIZE = 4 * 1024 * 1024;
+    const qint64 MAX_HEADER_LENGTH = 64 * 1024;
+    const QString FAI_EXTENSION = ".fai";
+    const QString CACHE_FOLDER = "fasta_index";
+
+    /* Collects index entries from lines of the FASTA file */
+    class FastaIndexBuilder {
+    public:
+        FastaIndexBuilder(const GUrl &url)
+            : url(url), hasEntry(false), shortLineFound(false), irregular(false)
+        {
+
+        }
+
+        /* @contentLength doesn't include the line break, @basesCount doesn't include any whitespaces */
+        void processLine(qint64 lineStart, qint64 contentLength, qint64 basesCount, qint64 width, char firstChar, const QByteArray &line, U2OpStatus &os) {
+            if (FastaFormat::FASTA_HEADER_START_SYMBOL == firstChar) {
+                finishEntry();
+                startEntry(line, lineStart + width);
+                return;
+            }
+            if (!hasEntry) {
+                CHECK(0 != contentLength && FastaFormat::FASTA_COMMENT_START_SYMBOL != firstChar, );
+                os.setError(FastaFormat::tr("First line is not a FASTA header"));
+                return;
+            }
+            if (FastaFormat::FASTA_COMMENT_START_SYMBOL == firstChar) {
+                irregular = true;
+                return;
+            }
+            if (0 == basesCount) {
+                shortLineFound = true;
+                return;
+            }
+            if (basesCount != contentLength) {
+                // Positions can't be converted to offsets if there are whitespaces inside lines
+                irregular = true;
+            }
+
+            if (0 == entry.lineBases) {
+                entry.lineBases = int(contentLength);
+                entry.lineWidth = int(width);
+            } else if (shortLineFound || contentLength > entry.lineBases || width - contentLength != entry.lineWidth - entry.lineBases) {
+                irregular = true;
+            } else if (contentLength < entry.lineBases) {
+                shortLineFound = true;
+            }
+            entry.length += basesCount;
+        }
+
+        QList<FastaIndexEntry> finish() {
+            finishEntry();
+            return entries;
+        }
+
+    private:
+        void startEntry(const QByteArray &header, qint64 offset) {
+            const QByteArray name = header.mid(1).trimmed();
+            int nameLength = 0;
+            while (nameLength < name.length() && !TextUtils::WHITES[uchar(name[nameLength])]) {
+                nameLength++;
+            }
+
+            entry = FastaIndexEntry();
+            entry.name = QString::fromLatin1(name.constData(), nameLength);
+            entry.offset = offset;
+            hasEntry = true;
+            shortLineFound = false;
+            irregular = false;
+        }
+
+        void finishEntry() {
+            CHECK(hasEntry, );
+            if (irregular) {
+                coreLog.trace(QString("FASTA record '%1' has lines of different length: %2").arg(entry.name).arg(url.getURLString()));
+                entry.lineBases = 0;
+                entry.lineWidth = 0;
+            }
+            entries << entry;
+            hasEntry = false;
+        }
+
+        const GUrl url;
+        QList<FastaIndexEntry> entries;
+        FastaIndexEntry entry;
+        bool hasEntry;
+        bool shortLineFound;
+        bool irregular;
+    };
+}
+
+bool FastaIndex::isEmpty() const {
+    return entries.isEmpty();
+}
+
+bool FastaIndex::isRegular() const {
+    foreach (const FastaIndexEntry &entry, entries) {
+        CHECK(entry.isRegular(), false);
+    }
+    return true;
+}
+
+const QList<FastaIndexEntry> & FastaIndex::getEntries() const {
+    return entries;
+}
+
+const FastaIndexEntry * FastaIndex::findEntry(const QString &name) const {
+    QHash<QString, int>::ConstIterator it = entriesByName.constFind(name);
+    CHECK(it != entriesByName.constEnd(), NULL);
+    return &entries[it.value()];
+}
+
+void FastaIndex::addEntry(const FastaIndexEntry &entry) {
+    // SAMtools uses the first record if there are several records with the same name
+    if (!entriesByName.contains(entry.name)) {
+        entriesByName.insert(entry.name, entries.size());
+    }
+    entries << entry;
+}
+
+FastaIndex FastaIndex::build(const GUrl &fastaUrl, U2OpStatus &os) {
+    QFile file(fastaUrl.getURLString());
+    CHECK_EXT(file.open(QIODevice::ReadOnly), os.setError(L10N::errorOpeningFileRead(fastaUrl)), FastaIndex());
+    const qint64 fileSize = file.size();
+
+    FastaIndexBuilder builder(fastaUrl);
+    QByteArray block(int(READ_BLOCK_SIZE), 0);
+    QByteArray line;  // only header lines are collected
+    qint64 lineStart = 0;
+    qint64 lineLength = 0;
+    qint64 lineWhites = 0;
+    char firstChar = 0;
+    char lastChar = 0;
+
+    forever {
+        const qint64 read = file.read(block.data(), READ_BLOCK_SIZE);
+        CHECK_EXT(read >= 0, os.setError(L10N::errorReadingFile(fastaUrl)), FastaIndex());
+        CHECK_BREAK(read > 0);
+
+        const char *data = block.constData();
+        qint64 pos = 0;
+        while (pos < read) {
+            if (0 == lineLength) {
+                firstChar = data[pos];
+            }
+            const char *lineEnd = static_cast<const char *>(memchr(data + pos, '\n', read - pos));
+            const qint64 end = (NULL != lineEnd) ? lineEnd - data : read;
+            if (end > pos) {
+                lastChar = data[end - 1];
+                if (FastaFormat::FASTA_HEADER_START_SYMBOL == firstChar) {
+                    line.append(data + pos, int(end - pos));
+                } else {
+                    for (qint64 i = pos; i < end; i++) {
+                        lineWhites += TextUtils::WHITES[uchar(data[i])] ? 1 : 0;
+                    }
+                }
+                lineLength += end - pos;
+            }
+            CHECK_BREAK(NULL != lineEnd);
+
+            const qint64 contentLength = (lineLength > 0 && '\r' == lastChar) ? lineLength - 1 : lineLength;
+            builder.processLine(lineStart, contentLength, lineLength - lineWhites, lineLength + 1, firstChar, line, os);
+            CHECK_OP(os, FastaIndex());
+            lineStart += lineLength + 1;
+            lineLength = 0;
+            lineWhites = 0;
+            firstChar = 0;
+            line.clear();
+            pos = end + 1;
+        }
+        CHECK_OP(os, FastaIndex());
+        os.setProgress(int(100 * file.pos() / qMax(fileSize, qint64(1))));
+    }
+
+    if (lineLength > 0) {
+        const qint64 contentLength = ('\r' == lastChar) ? lineLength - 1 : lineLength;
+        builder.processLine(lineStart, contentLength, lineLength - lineWhites, lineLength + 1, firstChar, line, os);
+        CHECK_OP(os, FastaIndex());
+    }
+
+    FastaIndex result;
+    foreach (const FastaIndexEntry &entry, builder.finish()) {
+        result.addEntry(entry);
+    }
+    return result;
+}
+
+FastaIndex FastaIndex::load(const GUrl &faiUrl, U2OpStatus &os) {
+    QFile file(faiUrl.getURLString());
+    CHECK_EXT(file.open(QIODevice::ReadOnly), os.setError(L10N::errorOpeningFileRead(faiUrl)), FastaIndex());
+
+    FastaIndex result;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        CHECK_OPERATION(!line.isEmpty(), continue);
+
+        const QList<QByteArray> columns = line.split('\t');
+        CHECK_EXT(5 == columns.size(), os.setError(FastaFormat::tr("Invalid FASTA index line: %1").arg(QString::fromLatin1(line))), FastaIndex());
+
+        FastaIndexEntry entry;
+        bool ok[4] = {false, false, false, false};
+        entry.name = QString::fromLatin1(columns[0]);
+        entry.length = columns[1].toLongLong(&ok[0]);
+        entry.offset = columns[2].toLongLong(&ok[1]);
+        entry.lineBases = columns[3].toInt(&ok[2]);
+        entry.lineWidth = columns[4].toInt(&ok[3]);
+        CHECK_EXT(ok[0] && ok[1] && ok[2] && ok[3], os.setError(FastaFormat::tr("Invalid FASTA index line: %1").arg(QString::fromLatin1(line))), FastaIndex());
+        result.addEntry(entry);
+    }
+    return result;
+}
+
+void FastaIndex::save(const GUrl &faiUrl, U2OpStatus &os) const {
+    SAFE_POINT_EXT(isRegular(), os.setError("The FASTA index with irregular records can't be saved"), );
+    QFile file(faiUrl.getURLString());
+    CHECK_EXT(file.open(QIODevice::WriteOnly | QIODevice::Truncate), os.setError(L10N::errorOpeningFileWrite(faiUrl)), );
+
+    QTextStream stream(&file);
+    foreach (const FastaIndexEntry &entry, entries) {
+        stream << entry.name << '\t' << entry.length << '\t' << entry.offset << '\t' << entry.lineBases << '\t' << entry.lineWidth << '\n';
+    }
+    stream.flush();
+    CHECK_EXT(QFile::NoError == file.error(), os.setError(L10N::errorWritingFile(faiUrl)), );
+}
+
+FastaIndex FastaIndex::getIndex(const GUrl &fastaUrl, U2OpStatus &os) {
+    CHECK_EXT(canBeIndexed(fastaUrl), os.setError(FastaFormat::tr("Only uncompressed local FASTA files can be indexed: %1").arg(fastaUrl.getURLString())), FastaIndex());
+
+    FastaIndex index;
+    CHECK(!loadIfNewer(getIndexUrl(fastaUrl), fastaUrl, index), index);
+    const GUrl cachedUrl = getCachedIndexUrl(fastaUrl);
+    CHECK(cachedUrl.isEmpty() || !loadIfNewer(cachedUrl, fastaUrl, index), index);
+
+    index = build(fastaUrl, os);
+    CHECK_OP(os, FastaIndex());
+    if (index.isRegular() && !cachedUrl.isEmpty()) {
+        // The index is still usable if it can't be saved
+        U2OpStatus2Log saveOs;
+        QDir().mkpath(QFileInfo(cachedUrl.getURLString()).absolutePath());
+        index.save(cachedUrl, saveOs);
+    }
+    return index;
+}
+
+bool FastaIndex::loadIfNewer(const GUrl &faiUrl, const GUrl &fastaUrl, FastaIndex &index) {
+    const QFileInfo faiInfo(faiUrl.getURLString());
+    CHECK(faiInfo.exists() && faiInfo.lastModified() >= QFileInfo(fastaUrl.getURLString()).lastModified(), false);
+
+    U2OpStatusImpl loadOs;
+    index = load(faiUrl, loadOs);
+    if (loadOs.hasError()) {
+        coreLog.details(FastaFormat::tr("The FASTA index will be rebuilt: %1").arg(loadOs.getError()));
+        index = FastaIndex();
+        return false;
+    }
+    return true;
+}
+
+GUrl FastaIndex::getIndexUrl(const GUrl &fastaUrl) {
+    return GUrl(fastaUrl.getURLString() + FAI_EXTENSION);
+}
+
+GUrl FastaIndex::getCachedIndexUrl(const GUrl &fastaUrl) {
+    CHECK(NULL != AppContext::getAppSettings(), GUrl());
+    UserAppsSettings *settings = AppContext::getAppSettings()->getUserAppsSettings();
+    CHECK(NULL != settings, GUrl());
+
+    const QFileInfo fastaInfo(fastaUrl.getURLString());
+    const QString key = QString("%1|%2|%3").arg(fastaInfo.absoluteFilePath()).arg(fastaInfo.size()).arg(fastaInfo.lastModified().toMSecsSinceEpoch());
+    const QString hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex();
+    return GUrl(settings->getUserTemporaryDirPath() + "/" + CACHE_FOLDER + "/" + hash + FAI_EXTENSION);
+}
+
+bool FastaIndex::canBeIndexed(const GUrl &fastaUrl) {
+    return fastaUrl.isLocalFile() && BaseIOAdapters::LOCAL_FILE == IOAdapterUtils::url2io(fastaUrl);
+}
+
+/************************************************************************/
+/* FastaIndexedReader */
+/************************************************************************/
+const qint64 FastaIndexedReader::MAX_REGION_LENGTH = 1024 * 1024 * 1024;
+
+FastaIndexedReader::FastaIndexedReader(const GUrl &fastaUrl, const FastaIndex &index)
+    : file(fastaUrl.getURLString()), index(index)
+{
+
+}
+
+const FastaIndex & FastaIndexedReader::getIndex() const {
+    return index;
+}
+
+bool FastaIndexedReader::open(U2OpStatus &os) {
+    CHECK(!file.isOpen(), true);
+    CHECK_EXT(file.open(QIODevice::ReadOnly), os.setError(L10N::errorOpeningFileRead(file.fileName())), false);
+    return true;
+}
+
+QByteArray FastaIndexedReader::read(const QString &sequenceName, const U2Region &region, U2OpStatus &os) {
+    const FastaIndexEntry *entry = index.findEntry(sequenceName);
+    CHECK_EXT(NULL != entry, os.setError(FastaFormat::tr("Sequence is not found in the FASTA index: %1").arg(sequenceName)), QByteArray());
+    return read(*entry, region, os);
+}
+
+QByteArray FastaIndexedReader::read(const FastaIndexEntry &entry, const U2Region &region, U2OpStatus &os) {
+    CHECK_EXT(region.startPos >= 0 && region.endPos() <= entry.length, os.setError(FastaFormat::tr("Region %1 is out of the sequence '%2' bounds")
+              .arg(region.toString()).arg(entry.name)), QByteArray());
+    CHECK(!region.isEmpty(), QByteArray());
+    CHECK_EXT(region.length <= MAX_REGION_LENGTH, os.setError(FastaFormat::tr("Region %1 of the sequence '%2' is too long to be read at once")
+              .arg(region.toString()).arg(entry.name)), QByteArray());
+    CHECK(open(os), QByteArray());
+    CHECK(entry.isRegular(), readIrregular(entry, region, os));
+
+    const qint64 startOffset = entry.offset + (region.startPos / entry.lineBases) * entry.lineWidth + region.startPos % entry.lineBases;
+    const qint64 lastPos = region.endPos() - 1;
+    const qint64 endOffset = entry.offset + (lastPos / entry.lineBases) * entry.lineWidth + lastPos % entry.lineBases + 1;
+
+    CHECK_EXT(file.seek(startOffset), os.setError(L10N::errorReadingFile(file.fileName())), QByteArray());
+    QByteArray result;
+    result.reserve(int(region.length));
+    QByteArray block;
+    for (qint64 offset = startOffset; offset < endOffset; offset += block.length()) {
+        block = file.read(qMin(READ_BLOCK_SIZE, endOffset - offset));
+        CHECK_EXT(!block.isEmpty(), os.setError(L10N::errorReadingFile(file.fileName())), QByteArray());
+        const int basesCount = TextUtils::remove(block.data(), block.length(), TextUtils::WHITES);
+        CHECK_EXT(result.length() + basesCount <= region.length, os.setError(FastaFormat::tr("The FASTA index doesn't match the file: %1").arg(file.fileName())), QByteArray());
+        result.append(block.constData(), basesCount);
+    }
+    CHECK_EXT(result.length() == region.length, os.setError(FastaFormat::tr("The FASTA index doesn't match the file: %1").arg(file.fileName())), QByteArray());
+    return result;
+}
+
+QString FastaIndexedReader::readHeader(const FastaIndexEntry &entry, U2OpStatus &os) {
+    CHECK(open(os), QString());
+    // The header is the last line before the first base: read backwards by growing windows
+    QByteArray data;
+    int lineStart = -1;
+    for (qint64 window = 256; lineStart <= 0; window *= 4) {
+        const qint64 startOffset = qMax(entry.offset - qMin(window, MAX_HEADER_LENGTH), qint64(0));
+        CHECK_EXT(file.seek(startOffset), os.setError(L10N::errorReadingFile(file.fileName())), QString());
+        data = file.read(entry.offset - startOffset);
+        CHECK_EXT(data.length() == entry.offset - startOffset, os.setError(L10N::errorReadingFile(file.fileName())), QString());
+
+        while (data.endsWith('\n') || data.endsWith('\r')) {
+            data.chop(1);
+        }
+        lineStart = data.lastIndexOf('\n') + 1;
+        CHECK_BREAK(0 != startOffset && window < MAX_HEADER_LENGTH);
+    }
+    CHECK_EXT(lineStart < data.length() && FastaFormat::FASTA_HEADER_START_SYMBOL == data[lineStart],
+              os.setError(FastaFormat::tr("The FASTA index doesn't match the file: %1").arg(file.fileName())), QString());
+    return QString(data.mid(lineStart + 1)).trimmed();
+}
+
+QByteArray FastaIndexedReader::readIrregular(const FastaIndexEntry &entry, const U2Region &region, U2OpStatus &os) {
+    CHECK_EXT(file.seek(entry.offset), os.setError(L10N::errorReadingFile(file.fileName())), QByteArray());
+
+    QByteArray result;
+    result.reserve(int(region.length));
+    qint64 basesCount = 0;
+    while (!file.atEnd() && result.length() < region.length) {
+        QByteArray line = file.readLine();
+        CHECK_BREAK(!line.startsWith(FastaFormat::FASTA_HEADER_START_SYMBOL));
+        CHECK_OPERATION(!line.startsWith(FastaFormat::FASTA_COMMENT_START_SYMBOL), continue);
+        line.resize(TextUtils::remove(line.data(), line.length(), TextUtils::WHITES));
+
+        const qint64 lineStart = basesCount;
+        basesCount += line.length();
+        CHECK_OPERATION(basesCount > region.startPos, continue);
+        const qint64 from = qMax(region.startPos - lineStart, qint64(0));
+        const qint64 to = qMin(region.endPos() - lineStart, qint64(line.length()));
+        result.append(line.constData() + from, int(to - from));
+    }
+    CHECK_EXT(result.length() == region.length, os.setError(FastaFormat::tr("The FASTA index doesn't match the file: %1").arg(file.fileName())), QByteArray());
+    return result;
+}
+
+} // U2
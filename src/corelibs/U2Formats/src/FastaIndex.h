@@ -0,0 +1,116 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_FASTA_INDEX_H_
+#define _U2_FASTA_INDEX_H_
+
+#include <QFile>
+#include <QHash>
+
+#include <U2Core/GUrl.h>
+#include <U2Core/U2OpStatus.h>
+#include <U2Core/U2Region.h>
+
+namespace U2 {
+
+/**
+ * A record of the FASTA index in the SAMtools "fai" format.
+ */
+class U2FORMATS_EXPORT FastaIndexEntry {
+public:
+    FastaIndexEntry();
+
+    /* All lines (except the last one) have the same length, so any position can be located without reading */
+    bool isRegular() const;
+
+    /* The header up to the first whitespace */
+    QString name;
+    qint64 length;
+    /* The file offset of the first base */
+    qint64 offset;
+    /* Bases per line; 0 if lines have different lengths */
+    int lineBases;
+    /* Bytes per line including the line break */
+    int lineWidth;
+};
+
+class U2FORMATS_EXPORT FastaIndex {
+public:
+    bool isEmpty() const;
+    bool isRegular() const;
+    const QList<FastaIndexEntry> & getEntries() const;
+    /* Returns NULL if there is no such sequence */
+    const FastaIndexEntry * findEntry(const QString &name) const;
+
+    /* Builds the index in one pass over the file */
+    static FastaIndex build(const GUrl &fastaUrl, U2OpStatus &os);
+    static FastaIndex load(const GUrl &faiUrl, U2OpStatus &os);
+    /* Only regular indexes can be saved: they are compatible with SAMtools */
+    void save(const GUrl &faiUrl, U2OpStatus &os) const;
+
+    /**
+     * Loads "<fastaUrl>.fai" if it is newer than the FASTA file (e.g. made by SAMtools),
+     * otherwise loads or builds the index in the UGENE temporary folder.
+     * Nothing is written near the FASTA file.
+     */
+    static FastaIndex getIndex(const GUrl &fastaUrl, U2OpStatus &os);
+    static GUrl getIndexUrl(const GUrl &fastaUrl);
+    /* The index in the UGENE temporary folder, the name depends on the file path, size and modification time */
+    static GUrl getCachedIndexUrl(const GUrl &fastaUrl);
+    /* Only uncompressed local files can be indexed */
+    static bool canBeIndexed(const GUrl &fastaUrl);
+
+private:
+    void addEntry(const FastaIndexEntry &entry);
+    static bool loadIfNewer(const GUrl &faiUrl, const GUrl &fastaUrl, FastaIndex &index);
+
+    QList<FastaIndexEntry> entries;
+    QHash<QString, int> entriesByName;
+};
+
+/**
+ * Reads sequence regions from an indexed FASTA file without parsing other records.
+ */
+class U2FORMATS_EXPORT FastaIndexedReader {
+public:
+    FastaIndexedReader(const GUrl &fastaUrl, const FastaIndex &index);
+
+    const FastaIndex & getIndex() const;
+    /* Returns bases of the region, whitespaces are removed. The region length is limited by MAX_REGION_LENGTH */
+    QByteArray read(const FastaIndexEntry &entry, const U2Region &region, U2OpStatus &os);
+    QByteArray read(const QString &sequenceName, const U2Region &region, U2OpStatus &os);
+    /* Returns the whole header line of the record without '>' */
+    QString readHeader(const FastaIndexEntry &entry, U2OpStatus &os);
+
+    static const qint64 MAX_REGION_LENGTH;
+
+private:
+    bool open(U2OpStatus &os);
+    QByteArray readIrregular(const FastaIndexEntry &entry, const U2Region &region, U2OpStatus &os);
+
+    QFile file;
+    FastaIndex index;
+};
+
+} // U2
+
+#endif // _U2_FASTA_INDEX_H_
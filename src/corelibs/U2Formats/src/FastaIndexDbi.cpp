@@ -0,0 +1,399 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QFileInfo>
+
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/DNASequenceObject.h>
+#include <U2Core/DbiConnection.h>
+#include <U2Core/U2AlphabetUtils.h>
+#include <U2Core/U2DbiRegistry.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "FastaFormat.h"
+#include "FastaIndexDbi.h"
+
+namespace U2 {
+
+/************************************************************************/
+/* FastaIndexDbi */
+/************************************************************************/
+FastaIndexDbi::FastaIndexDbi()
+    : U2AbstractDbi(FastaIndexDbiFactory::ID)
+{
+
+}
+
+void FastaIndexDbi::init(const QHash<QString, QString> &properties, const QVariantMap & /*persistentData*/, U2OpStatus &os) {
+    CHECK_EXT(U2DbiState_Void == state, os.setError(FastaFormat::tr("Invalid DBI state")), );
+    state = U2DbiState_Starting;
+
+    url = GUrl(properties.value(U2DbiOptions::U2_DBI_OPTION_URL));
+    CHECK_EXT(!url.isEmpty(), os.setError(FastaFormat::tr("URL is not specified")); cleanup(), );
+    CHECK_EXT(FastaIndex::canBeIndexed(url), os.setError(FastaFormat::tr("Only uncompressed local FASTA files can be indexed: %1").arg(url.getURLString())); cleanup(), );
+    index = FastaIndex::getIndex(url, os);
+    CHECK_OP_EXT(os, cleanup(), );
+
+    objectDbi.reset(new FastaIndexObjectDbi(*this));
+    sequenceDbi.reset(new FastaIndexSequenceDbi(*this));
+    attributeDbi.reset(new FastaIndexAttributeDbi(*this));
+
+    initProperties = properties;
+    features.insert(U2DbiFeature_ReadSequence);
+    dbiId = url.getURLString();
+    state = U2DbiState_Ready;
+}
+
+QVariantMap FastaIndexDbi::shutdown(U2OpStatus & /*os*/) {
+    cleanup();
+    return QVariantMap();
+}
+
+void FastaIndexDbi::cleanup() {
+    objectDbi.reset();
+    sequenceDbi.reset();
+    attributeDbi.reset();
+    index = FastaIndex();
+    state = U2DbiState_Void;
+}
+
+U2DataType FastaIndexDbi::getEntityTypeById(const U2DataId &id) const {
+    U2OpStatusImpl os;
+    CHECK(NULL != getEntry(id, os), U2Type::Unknown);
+    return U2Type::Sequence;
+}
+
+U2ObjectDbi * FastaIndexDbi::getObjectDbi() {
+    return U2DbiState_Ready == state ? objectDbi.data() : NULL;
+}
+
+U2SequenceDbi * FastaIndexDbi::getSequenceDbi() {
+    return U2DbiState_Ready == state ? sequenceDbi.data() : NULL;
+}
+
+U2AttributeDbi * FastaIndexDbi::getAttributeDbi() {
+    return U2DbiState_Ready == state ? attributeDbi.data() : NULL;
+}
+
+bool FastaIndexDbi::isReadOnly() const {
+    return true;
+}
+
+const GUrl & FastaIndexDbi::getUrl() const {
+    return url;
+}
+
+const FastaIndex & FastaIndexDbi::getIndex() const {
+    return index;
+}
+
+QList<U2DataId> FastaIndexDbi::getSequenceIds() const {
+    QList<U2DataId> result;
+    const QList<FastaIndexEntry> &entries = index.getEntries();
+    for (int i = 0; i < entries.size(); i++) {
+        CHECK_OPERATION(0 != entries[i].length, continue);
+        result << QByteArray::number(i);
+    }
+    return result;
+}
+
+const FastaIndexEntry * FastaIndexDbi::getEntry(const U2DataId &sequenceId, U2OpStatus &os) const {
+    CHECK_EXT(U2DbiState_Ready == state, os.setError(FastaFormat::tr("Invalid DBI state")), NULL);
+    bool ok = false;
+    const int entryIndex = sequenceId.toInt(&ok);
+    const QList<FastaIndexEntry> &entries = index.getEntries();
+    CHECK_EXT(ok && entryIndex >= 0 && entryIndex < entries.size() && 0 != entries[entryIndex].length,
+              os.setError(FastaFormat::tr("Object not found")), NULL);
+    return &entries[entryIndex];
+}
+
+U2DataId FastaIndexDbi::getSequenceId(const QString &sequenceName, U2OpStatus &os) const {
+    CHECK_EXT(U2DbiState_Ready == state, os.setError(FastaFormat::tr("Invalid DBI state")), U2DataId());
+    const QList<FastaIndexEntry> &entries = index.getEntries();
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].name == sequenceName && 0 != entries[i].length) {
+            return QByteArray::number(i);
+        }
+    }
+    os.setError(FastaFormat::tr("Sequence is not found in the FASTA index: %1").arg(sequenceName));
+    return U2DataId();
+}
+
+U2SequenceObject * FastaIndexDbi::createSequenceObject(const GUrl &fastaUrl, const QString &sequenceName, U2OpStatus &os) {
+    const U2DbiRef dbiRef(FastaIndexDbiFactory::ID, fastaUrl.getURLString());
+    DbiConnection con(dbiRef, os);
+    CHECK_OP(os, NULL);
+    FastaIndexDbi *dbi = dynamic_cast<FastaIndexDbi *>(con.dbi);
+    SAFE_POINT_EXT(NULL != dbi, os.setError("Unexpected DBI type"), NULL);
+
+    const U2DataId sequenceId = dbi->getSequenceId(sequenceName, os);
+    CHECK_OP(os, NULL);
+    const U2Sequence sequence = dbi->getSequenceDbi()->getSequenceObject(sequenceId, os);
+    CHECK_OP(os, NULL);
+    return new U2SequenceObject(sequence.visualName, U2EntityRef(dbi->getDbiRef(), sequenceId));
+}
+
+/************************************************************************/
+/* FastaIndexObjectDbi */
+/************************************************************************/
+FastaIndexObjectDbi::FastaIndexObjectDbi(FastaIndexDbi &dbi)
+    : U2SimpleObjectDbi(&dbi), dbi(dbi)
+{
+
+}
+
+qint64 FastaIndexObjectDbi::countObjects(U2OpStatus &os) {
+    return countObjects(U2Type::Sequence, os);
+}
+
+qint64 FastaIndexObjectDbi::countObjects(U2DataType type, U2OpStatus &os) {
+    return getObjects(type, 0, U2DbiOptions::U2_DBI_NO_LIMIT, os).size();
+}
+
+QHash<U2DataId, QString> FastaIndexObjectDbi::getObjectNames(qint64 offset, qint64 count, U2OpStatus &os) {
+    QHash<U2DataId, QString> result;
+    foreach (const U2DataId &id, getObjects(offset, count, os)) {
+        const FastaIndexEntry *entry = dbi.getEntry(id, os);
+        CHECK_OP(os, result);
+        result.insert(id, entry->name);
+    }
+    return result;
+}
+
+void FastaIndexObjectDbi::getObject(U2Object &object, const U2DataId &id, U2OpStatus &os) {
+    object = dbi.getSequenceDbi()->getSequenceObject(id, os);
+}
+
+QList<U2DataId> FastaIndexObjectDbi::getObjects(qint64 offset, qint64 count, U2OpStatus &os) {
+    return getObjects(U2Type::Sequence, offset, count, os);
+}
+
+QList<U2DataId> FastaIndexObjectDbi::getObjects(U2DataType type, qint64 offset, qint64 count, U2OpStatus &os) {
+    CHECK_EXT(U2DbiState_Ready == dbi.getState(), os.setError(FastaFormat::tr("Invalid DBI state")), QList<U2DataId>());
+    CHECK(U2Type::Sequence == type, QList<U2DataId>());
+    const QList<U2DataId> ids = dbi.getSequenceIds();
+    return ids.mid(int(offset), U2DbiOptions::U2_DBI_NO_LIMIT == count ? -1 : int(count));
+}
+
+QList<U2DataId> FastaIndexObjectDbi::getParents(const U2DataId & /*entityId*/, U2OpStatus &os) {
+    CHECK_EXT(U2DbiState_Ready == dbi.getState(), os.setError(FastaFormat::tr("Invalid DBI state")), QList<U2DataId>());
+    return QList<U2DataId>();
+}
+
+QStringList FastaIndexObjectDbi::getFolders(U2OpStatus &os) {
+    CHECK_EXT(U2DbiState_Ready == dbi.getState(), os.setError(FastaFormat::tr("Invalid DBI state")), QStringList());
+    return QStringList(U2ObjectDbi::ROOT_FOLDER);
+}
+
+qint64 FastaIndexObjectDbi::countObjects(const QString &folder, U2OpStatus &os) {
+    CHECK_EXT(U2ObjectDbi::ROOT_FOLDER == folder, os.setError(FastaFormat::tr("No such folder: %1").arg(folder)), 0);
+    return countObjects(os);
+}
+
+QList<U2DataId> FastaIndexObjectDbi::getObjects(const QString &folder, qint64 offset, qint64 count, U2OpStatus &os) {
+    CHECK_EXT(U2ObjectDbi::ROOT_FOLDER == folder, os.setError(FastaFormat::tr("No such folder: %1").arg(folder)), QList<U2DataId>());
+    return getObjects(offset, count, os);
+}
+
+QStringList FastaIndexObjectDbi::getObjectFolders(const U2DataId &objectId, U2OpStatus &os) {
+    CHECK(NULL != dbi.getEntry(objectId, os), QStringList());
+    return QStringList(U2ObjectDbi::ROOT_FOLDER);
+}
+
+qint64 FastaIndexObjectDbi::getObjectVersion(const U2DataId &objectId, U2OpStatus &os) {
+    dbi.getEntry(objectId, os);
+    return 0;
+}
+
+qint64 FastaIndexObjectDbi::getFolderLocalVersion(const QString &folder, U2OpStatus &os) {
+    CHECK_EXT(U2ObjectDbi::ROOT_FOLDER == folder, os.setError(FastaFormat::tr("No such folder: %1").arg(folder)), 0);
+    return 0;
+}
+
+qint64 FastaIndexObjectDbi::getFolderGlobalVersion(const QString &folder, U2OpStatus &os) {
+    CHECK_EXT(U2ObjectDbi::ROOT_FOLDER == folder, os.setError(FastaFormat::tr("No such folder: %1").arg(folder)), 0);
+    return 0;
+}
+
+U2DbiIterator<U2DataId> * FastaIndexObjectDbi::getObjectsByVisualName(const QString &visualName, U2DataType type, U2OpStatus &os) {
+    QList<U2DataId> result;
+    foreach (const U2DataId &id, getObjects(type, 0, U2DbiOptions::U2_DBI_NO_LIMIT, os)) {
+        const U2Sequence sequence = dbi.getSequenceDbi()->getSequenceObject(id, os);
+        CHECK_OP(os, NULL);
+        CHECK_OPERATION(sequence.visualName == visualName, continue);
+        result << id;
+    }
+    return new BufferedDbiIterator<U2DataId>(result);
+}
+
+void FastaIndexObjectDbi::renameObject(const U2DataId & /*id*/, const QString & /*newName*/, U2OpStatus &os) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteSequence, getRootDbi(), os);
+}
+
+void FastaIndexObjectDbi::setObjectRank(const U2DataId & /*objectId*/, U2DbiObjectRank /*newRank*/, U2OpStatus &os) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteSequence, getRootDbi(), os);
+}
+
+/************************************************************************/
+/* FastaIndexSequenceDbi */
+/************************************************************************/
+const qint64 FastaIndexSequenceDbi::ALPHABET_SAMPLE_LENGTH = 64 * 1024;
+
+FastaIndexSequenceDbi::FastaIndexSequenceDbi(FastaIndexDbi &dbi)
+    : U2SequenceDbi(&dbi), dbi(dbi)
+{
+
+}
+
+namespace {
+
+/* Bases out of the sample could be any symbols of the alphabet type */
+const DNAAlphabet * extendAlphabet(const DNAAlphabet *alphabet) {
+    QString alphabetId = alphabet->getId();
+    if (alphabet->isAmino()) {
+        alphabetId = BaseDNAAlphabetIds::AMINO_EXTENDED();
+    } else if (alphabet->isNucleic()) {
+        alphabetId = alphabet->isRNA() ? BaseDNAAlphabetIds::NUCL_RNA_EXTENDED() : BaseDNAAlphabetIds::NUCL_DNA_EXTENDED();
+    }
+    return U2AlphabetUtils::getById(alphabetId);
+}
+
+}
+
+U2Sequence FastaIndexSequenceDbi::getSequenceObject(const U2DataId &sequenceId, U2OpStatus &os) {
+    const FastaIndexEntry *entry = dbi.getEntry(sequenceId, os);
+    CHECK_OP(os, U2Sequence());
+
+    FastaIndexedReader reader(dbi.getUrl(), dbi.getIndex());
+    const QString header = reader.readHeader(*entry, os);
+    CHECK_OP(os, U2Sequence());
+    const qint64 sampleLength = qMin(entry->length, ALPHABET_SAMPLE_LENGTH);
+    const QByteArray sample = reader.read(*entry, U2Region(0, sampleLength), os);
+    CHECK_OP(os, U2Sequence());
+    const DNAAlphabet *alphabet = U2AlphabetUtils::findBestAlphabet(sample);
+    CHECK_EXT(NULL != alphabet, os.setError(FastaFormat::tr("Can't detect the alphabet of the sequence: %1").arg(entry->name)), U2Sequence());
+    if (sampleLength < entry->length) {
+        alphabet = extendAlphabet(alphabet);
+        SAFE_POINT_EXT(NULL != alphabet, os.setError("The extended alphabet is not found"), U2Sequence());
+    }
+
+    U2Sequence sequence(sequenceId, dbi.getDbiId(), 0);
+    sequence.visualName = header.isEmpty() ? entry->name : header;
+    sequence.alphabet = alphabet->getId();
+    sequence.length = entry->length;
+    sequence.circular = false;
+    return sequence;
+}
+
+QByteArray FastaIndexSequenceDbi::getSequenceData(const U2DataId &sequenceId, const U2Region &region, U2OpStatus &os) {
+    const FastaIndexEntry *entry = dbi.getEntry(sequenceId, os);
+    CHECK_OP(os, QByteArray());
+    const U2Region readRegion = region.intersect(U2Region(0, entry->length));
+    CHECK(!readRegion.isEmpty(), QByteArray());
+
+    FastaIndexedReader reader(dbi.getUrl(), dbi.getIndex());
+    return reader.read(*entry, readRegion, os);
+}
+
+void FastaIndexSequenceDbi::createSequenceObject(U2Sequence & /*sequence*/, const QString & /*folder*/, U2OpStatus &os, U2DbiObjectRank /*rank*/) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteSequence, getRootDbi(), os);
+}
+
+void FastaIndexSequenceDbi::updateSequenceObject(U2Sequence & /*sequence*/, U2OpStatus &os) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteSequence, getRootDbi(), os);
+}
+
+void FastaIndexSequenceDbi::updateSequenceData(const U2DataId & /*sequenceId*/, const U2Region & /*regionToReplace*/, const QByteArray & /*dataToInsert*/, const QVariantMap & /*hints*/, U2OpStatus &os) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteSequence, getRootDbi(), os);
+}
+
+/************************************************************************/
+/* FastaIndexAttributeDbi */
+/************************************************************************/
+FastaIndexAttributeDbi::FastaIndexAttributeDbi(FastaIndexDbi &dbi)
+    : U2SimpleAttributeDbi(&dbi)
+{
+
+}
+
+QStringList FastaIndexAttributeDbi::getAvailableAttributeNames(U2OpStatus & /*os*/) {
+    return QStringList();
+}
+
+QList<U2DataId> FastaIndexAttributeDbi::getObjectAttributes(const U2DataId & /*objectId*/, const QString & /*attributeName*/, U2OpStatus & /*os*/) {
+    return QList<U2DataId>();
+}
+
+QList<U2DataId> FastaIndexAttributeDbi::getObjectPairAttributes(const U2DataId & /*objectId*/, const U2DataId & /*childId*/, const QString & /*attributeName*/, U2OpStatus & /*os*/) {
+    return QList<U2DataId>();
+}
+
+U2IntegerAttribute FastaIndexAttributeDbi::getIntegerAttribute(const U2DataId & /*attributeId*/, U2OpStatus & /*os*/) {
+    return U2IntegerAttribute();
+}
+
+U2RealAttribute FastaIndexAttributeDbi::getRealAttribute(const U2DataId & /*attributeId*/, U2OpStatus & /*os*/) {
+    return U2RealAttribute();
+}
+
+U2StringAttribute FastaIndexAttributeDbi::getStringAttribute(const U2DataId & /*attributeId*/, U2OpStatus & /*os*/) {
+    return U2StringAttribute();
+}
+
+U2ByteArrayAttribute FastaIndexAttributeDbi::getByteArrayAttribute(const U2DataId & /*attributeId*/, U2OpStatus & /*os*/) {
+    return U2ByteArrayAttribute();
+}
+
+QList<U2DataId> FastaIndexAttributeDbi::sort(const U2DbiSortConfig & /*sc*/, qint64 /*offset*/, qint64 /*count*/, U2OpStatus &os) {
+    U2DbiUtils::logNotSupported(U2DbiFeature_WriteAttributes, getRootDbi(), os);
+    return QList<U2DataId>();
+}
+
+/************************************************************************/
+/* FastaIndexDbiFactory */
+/************************************************************************/
+const U2DbiFactoryId FastaIndexDbiFactory::ID = "FastaIndexDbi";
+
+FastaIndexDbiFactory::FastaIndexDbiFactory()
+    : U2DbiFactory()
+{
+
+}
+
+U2Dbi * FastaIndexDbiFactory::createDbi() {
+    return new FastaIndexDbi();
+}
+
+U2DbiFactoryId FastaIndexDbiFactory::getId() const {
+    return ID;
+}
+
+FormatCheckResult FastaIndexDbiFactory::isValidDbi(const QHash<QString, QString> & /*properties*/, const QByteArray & /*rawData*/, U2OpStatus & /*os*/) const {
+    return FormatDetection_NotMatched;
+}
+
+bool FastaIndexDbiFactory::isDbiExists(const U2DbiId &id) const {
+    return QFileInfo(id).isFile();
+}
+
+} // U2
@@ -0,0 +1,157 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_FASTA_INDEX_DBI_H_
+#define _U2_FASTA_INDEX_DBI_H_
+
+#include <QScopedPointer>
+
+#include <U2Core/U2AbstractDbi.h>
+#include <U2Core/U2SequenceDbi.h>
+
+#include "FastaIndex.h"
+
+namespace U2 {
+
+class FastaIndexDbi;
+class U2SequenceObject;
+
+class FastaIndexObjectDbi : public U2SimpleObjectDbi {
+public:
+    FastaIndexObjectDbi(FastaIndexDbi &dbi);
+
+    virtual qint64 countObjects(U2OpStatus &os);
+    virtual qint64 countObjects(U2DataType type, U2OpStatus &os);
+    virtual QHash<U2DataId, QString> getObjectNames(qint64 offset, qint64 count, U2OpStatus &os);
+    virtual void getObject(U2Object &object, const U2DataId &id, U2OpStatus &os);
+    virtual QList<U2DataId> getObjects(qint64 offset, qint64 count, U2OpStatus &os);
+    virtual QList<U2DataId> getObjects(U2DataType type, qint64 offset, qint64 count, U2OpStatus &os);
+    virtual QList<U2DataId> getParents(const U2DataId &entityId, U2OpStatus &os);
+    virtual QStringList getFolders(U2OpStatus &os);
+    virtual qint64 countObjects(const QString &folder, U2OpStatus &os);
+    virtual QList<U2DataId> getObjects(const QString &folder, qint64 offset, qint64 count, U2OpStatus &os);
+    virtual QStringList getObjectFolders(const U2DataId &objectId, U2OpStatus &os);
+    virtual qint64 getObjectVersion(const U2DataId &objectId, U2OpStatus &os);
+    virtual qint64 getFolderLocalVersion(const QString &folder, U2OpStatus &os);
+    virtual qint64 getFolderGlobalVersion(const QString &folder, U2OpStatus &os);
+    virtual U2DbiIterator<U2DataId> * getObjectsByVisualName(const QString &visualName, U2DataType type, U2OpStatus &os);
+    virtual void renameObject(const U2DataId &id, const QString &newName, U2OpStatus &os);
+    virtual void setObjectRank(const U2DataId &objectId, U2DbiObjectRank newRank, U2OpStatus &os);
+
+private:
+    FastaIndexDbi &dbi;
+};
+
+class FastaIndexSequenceDbi : public U2SequenceDbi {
+public:
+    FastaIndexSequenceDbi(FastaIndexDbi &dbi);
+
+    virtual U2Sequence getSequenceObject(const U2DataId &sequenceId, U2OpStatus &os);
+    /* The region is read from the file, the part out of the sequence bounds is ignored */
+    virtual QByteArray getSequenceData(const U2DataId &sequenceId, const U2Region &region, U2OpStatus &os);
+
+    /**
+     * Unsupported methods
+     */
+    virtual void createSequenceObject(U2Sequence &sequence, const QString &folder, U2OpStatus &os, U2DbiObjectRank rank = U2DbiObjectRank_TopLevel);
+    virtual void updateSequenceObject(U2Sequence &sequence, U2OpStatus &os);
+    virtual void updateSequenceData(const U2DataId &sequenceId, const U2Region &regionToReplace, const QByteArray &dataToInsert, const QVariantMap &hints, U2OpStatus &os);
+
+    /* The alphabet is detected on this number of first bases and then extended */
+    static const qint64 ALPHABET_SAMPLE_LENGTH;
+
+private:
+    FastaIndexDbi &dbi;
+};
+
+/* FASTA records have no attributes */
+class FastaIndexAttributeDbi : public U2SimpleAttributeDbi {
+public:
+    FastaIndexAttributeDbi(FastaIndexDbi &dbi);
+
+    virtual QStringList getAvailableAttributeNames(U2OpStatus &os);
+    virtual QList<U2DataId> getObjectAttributes(const U2DataId &objectId, const QString &attributeName, U2OpStatus &os);
+    virtual QList<U2DataId> getObjectPairAttributes(const U2DataId &objectId, const U2DataId &childId, const QString &attributeName, U2OpStatus &os);
+    virtual U2IntegerAttribute getIntegerAttribute(const U2DataId &attributeId, U2OpStatus &os);
+    virtual U2RealAttribute getRealAttribute(const U2DataId &attributeId, U2OpStatus &os);
+    virtual U2StringAttribute getStringAttribute(const U2DataId &attributeId, U2OpStatus &os);
+    virtual U2ByteArrayAttribute getByteArrayAttribute(const U2DataId &attributeId, U2OpStatus &os);
+    virtual QList<U2DataId> sort(const U2DbiSortConfig &sc, qint64 offset, qint64 count, U2OpStatus &os);
+};
+
+/**
+ * A read-only DBI over a local FASTA file: every not empty record is a sequence object
+ * which regions are read from the file through the FASTA index (see FastaIndex::getIndex()).
+ * Nothing is imported, so opening a sequence of a huge multi-FASTA file costs only the index loading.
+ * The DBI is shared by connections of different threads: the index is not changed after the initialization
+ * and every read opens its own file handle.
+ */
+class U2FORMATS_EXPORT FastaIndexDbi : public U2AbstractDbi {
+public:
+    FastaIndexDbi();
+
+    virtual void init(const QHash<QString, QString> &properties, const QVariantMap &persistentData, U2OpStatus &os);
+    virtual QVariantMap shutdown(U2OpStatus &os);
+    virtual QHash<QString, QString> getDbiMetaInfo(U2OpStatus &) {return QHash<QString, QString>();}
+    virtual U2DataType getEntityTypeById(const U2DataId &id) const;
+    virtual U2ObjectDbi * getObjectDbi();
+    virtual U2SequenceDbi * getSequenceDbi();
+    virtual U2AttributeDbi * getAttributeDbi();
+    virtual bool isReadOnly() const;
+
+    const GUrl & getUrl() const;
+    const FastaIndex & getIndex() const;
+    QList<U2DataId> getSequenceIds() const;
+    /* Returns NULL and sets the error if there is no such not empty record */
+    const FastaIndexEntry * getEntry(const U2DataId &sequenceId, U2OpStatus &os) const;
+    U2DataId getSequenceId(const QString &sequenceName, U2OpStatus &os) const;
+
+    /* Returns the object which data are read from the file on demand, the caller owns it */
+    static U2SequenceObject * createSequenceObject(const GUrl &fastaUrl, const QString &sequenceName, U2OpStatus &os);
+
+private:
+    void cleanup();
+
+    GUrl url;
+    FastaIndex index;
+    QScopedPointer<FastaIndexObjectDbi> objectDbi;
+    QScopedPointer<FastaIndexSequenceDbi> sequenceDbi;
+    QScopedPointer<FastaIndexAttributeDbi> attributeDbi;
+};
+
+class U2FORMATS_EXPORT FastaIndexDbiFactory : public U2DbiFactory {
+public:
+    FastaIndexDbiFactory();
+
+    virtual U2Dbi * createDbi();
+    virtual U2DbiFactoryId getId() const;
+    /* FASTA files are opened with FastaFormat, the DBI is used only explicitly */
+    virtual FormatCheckResult isValidDbi(const QHash<QString, QString> &properties, const QByteArray &rawData, U2OpStatus &os) const;
+    virtual GUrl id2Url(const U2DbiId &id) const {return GUrl(id, GUrl_File);}
+    virtual bool isDbiExists(const U2DbiId &id) const;
+
+    static const U2DbiFactoryId ID;
+};
+
+} // U2
+
+#endif // _U2_FASTA_INDEX_DBI_H_
@@ -0,0 +1,253 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QScopedPointer>
+#include <QThread>
+
+#include <3rdparty/zlib/zlib.h>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/BaseIOAdapters.h>
+#include <U2Core/IOAdapter.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "FastqBatchProcessor.h"
+#include "FastqBatchReader.h"
+#include "FastqFormat.h"
+
+namespace U2 {
+
+namespace {
+    QByteArray compressGzipMember(const QByteArray &data, U2OpStatus &os) {
+        CHECK(!data.isEmpty(), QByteArray());
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        int ret = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + 15, 8, Z_DEFAULT_STRATEGY);
+        CHECK_EXT(Z_OK == ret, os.setError(FastqFormat::tr("Can't initialize the gzip compression")), QByteArray());
+
+        QByteArray result(int(deflateBound(&stream, uLong(data.size()))), Qt::Uninitialized);
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+        stream.avail_in = uInt(data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(result.data());
+        stream.avail_out = uInt(result.size());
+        ret = deflate(&stream, Z_FINISH);
+        deflateEnd(&stream);
+        CHECK_EXT(Z_STREAM_END == ret, os.setError(FastqFormat::tr("Gzip compression error")), QByteArray());
+
+        result.resize(int(stream.total_out));
+        return result;
+    }
+}
+
+/************************************************************************/
+/* FastqBatchWorkerThread */
+/************************************************************************/
+class FastqBatchWorkerThread : public QThread {
+public:
+    FastqBatchWorkerThread(FastqBatchProcessor *processor)
+        : processor(processor)
+    {
+
+    }
+
+protected:
+    void run() {
+        processor->processBatches();
+    }
+
+private:
+    FastqBatchProcessor *processor;
+};
+
+/************************************************************************/
+/* FastqBatchProcessor */
+/************************************************************************/
+const int FastqBatchProcessor::MAX_PENDING_BATCHES_PER_THREAD = 2;
+const int FastqBatchProcessor::WAIT_TIMEOUT_MS = 100;
+
+FastqBatchProcessor::FastqBatchProcessor(FastqBatchTransformer *transformer, int threadsCount)
+    : transformer(transformer), threadsCount(threadsCount), maxPendingBatches(0), compress(false),
+      inputRecordsCount(0), outputRecordsCount(0), reader(NULL), takenBatches(0),
+      writtenBatches(0), runningWorkers(0), stopped(false)
+{
+    if (this->threadsCount <= 0) {
+        this->threadsCount = AppResourcePool::instance()->getIdealThreadCount();
+    }
+    this->threadsCount = qMax(1, this->threadsCount);
+    maxPendingBatches = MAX_PENDING_BATCHES_PER_THREAD * this->threadsCount;
+}
+
+void FastqBatchProcessor::run(const QStringList &inputUrls, const QString &outputUrl, U2OpStatus &os) {
+    SAFE_POINT_EXT(NULL != transformer, os.setError(L10N::nullPointerError("FASTQ batch transformer")), );
+    inputRecordsCount = 0;
+    outputRecordsCount = 0;
+
+    // Compressed members are written as is, so a plain file adapter is used for gzipped output
+    compress = (BaseIOAdapters::GZIPPED_LOCAL_FILE == IOAdapterUtils::url2io(outputUrl));
+    IOAdapterFactory *iof = NULL;
+    if (compress) {
+        iof = AppContext::getIOAdapterRegistry()->getIOAdapterFactoryById(BaseIOAdapters::LOCAL_FILE);
+        SAFE_POINT_EXT(NULL != iof, os.setError(L10N::nullPointerError("IOAdapterFactory")), );
+    }
+    QScopedPointer<IOAdapter> io(IOAdapterUtils::open(outputUrl, os, IOAdapterMode_Append, iof));
+    CHECK_OP(os, );
+
+    for (int i = 0; i < inputUrls.size(); i++) {
+        processFile(inputUrls[i], io.data(), i, inputUrls.size(), os);
+        CHECK_OP(os, );
+    }
+}
+
+qint64 FastqBatchProcessor::getInputRecordsCount() const {
+    return inputRecordsCount;
+}
+
+qint64 FastqBatchProcessor::getOutputRecordsCount() const {
+    return outputRecordsCount;
+}
+
+void FastqBatchProcessor::appendRecord(QByteArray &output, const char *header, int headerLength,
+                                       const char *sequence, const char *quality, int length) {
+    output.reserve(output.size() + headerLength + 2 * length + 6);
+    output.append('@').append(header, headerLength).append('\n');
+    output.append(sequence, length).append("\n+\n");
+    output.append(quality, length).append('\n');
+}
+
+void FastqBatchProcessor::processFile(const QString &inputUrl, IOAdapter *io, int fileIndex, int filesCount, U2OpStatus &os) {
+    takenBatches = 0;
+    writtenBatches = 0;
+    runningWorkers = threadsCount;
+    stopped = false;
+    error.clear();
+    results.clear();
+
+    ThreadedFastqBatchReader fileReader(inputUrl, threadsCount + 1);
+    reader = &fileReader;
+
+    QList<FastqBatchWorkerThread *> workers;
+    for (int i = 0; i < threadsCount; i++) {
+        workers << new FastqBatchWorkerThread(this);
+        workers.last()->start();
+    }
+
+    writeResults(io, fileIndex, filesCount, os);
+
+    stop();
+    foreach (FastqBatchWorkerThread *worker, workers) {
+        worker->wait();
+    }
+    qDeleteAll(workers);
+    results.clear();
+    reader = NULL;
+}
+
+void FastqBatchProcessor::writeResults(IOAdapter *io, int fileIndex, int filesCount, U2OpStatus &os) {
+    forever {
+        BatchResult result;
+        {
+            QMutexLocker locker(&mutex);
+            while (!results.contains(writtenBatches) && runningWorkers > 0 && error.isEmpty() && !os.isCoR()) {
+                resultReady.wait(&mutex, WAIT_TIMEOUT_MS);
+            }
+            CHECK_EXT(error.isEmpty(), os.setError(error), );
+            CHECK(!os.isCoR(), );
+            // all workers are finished and all results are written
+            CHECK(results.contains(writtenBatches), );
+            result = results.take(writtenBatches);
+        }
+
+        if (!result.data.isEmpty()) {
+            const qint64 written = io->writeBlock(result.data);
+            CHECK_EXT(written == result.data.size(), os.setError(L10N::errorWritingFile(io->getURL())), );
+        }
+        inputRecordsCount += result.inputCount;
+        outputRecordsCount += result.outputCount;
+        os.setProgress((100 * fileIndex + reader->getProgress()) / filesCount);
+
+        QMutexLocker locker(&mutex);
+        writtenBatches++;
+        resultWritten.wakeAll();
+    }
+}
+
+void FastqBatchProcessor::processBatches() {
+    U2OpStatusImpl os;
+    forever {
+        int index = 0;
+        FastqRecordBatch *batch = takeBatch(index, os);
+        CHECK_BREAK(NULL != batch);
+
+        BatchResult result;
+        result.inputCount = batch->size();
+        result.outputCount = transformer->transform(*batch, result.data, os);
+        reader->releaseBatch(batch);
+        CHECK_OP_BREAK(os);
+        if (compress) {
+            result.data = compressGzipMember(result.data, os);
+            CHECK_OP_BREAK(os);
+        }
+
+        QMutexLocker locker(&mutex);
+        results.insert(index, result);
+        resultReady.wakeAll();
+    }
+
+    QMutexLocker locker(&mutex);
+    if (os.hasError() && error.isEmpty()) {
+        error = os.getError();
+    }
+    runningWorkers--;
+    resultReady.wakeAll();
+}
+
+FastqRecordBatch * FastqBatchProcessor::takeBatch(int &index, U2OpStatus &os) {
+    // Batches are numbered in the order they are read, the lock keeps numbers and batches consistent
+    QMutexLocker readLocker(&readMutex);
+    {
+        QMutexLocker locker(&mutex);
+        while (takenBatches - writtenBatches >= maxPendingBatches && !stopped && error.isEmpty()) {
+            resultWritten.wait(&mutex);
+        }
+        CHECK(!stopped && error.isEmpty(), NULL);
+    }
+
+    FastqRecordBatch *batch = reader->takeBatch(os);
+    index = takenBatches++;
+    return batch;
+}
+
+void FastqBatchProcessor::stop() {
+    {
+        QMutexLocker locker(&mutex);
+        stopped = true;
+        resultWritten.wakeAll();
+    }
+    reader->cancel();
+}
+
+} // U2
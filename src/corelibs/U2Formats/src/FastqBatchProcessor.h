@@ -0,0 +1,122 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_FASTQ_BATCH_PROCESSOR_H_
+#define _U2_FASTQ_BATCH_PROCESSOR_H_
+
+#include <QMap>
+#include <QMutex>
+#include <QStringList>
+#include <QWaitCondition>
+
+#include <U2Core/U2OpStatus.h>
+
+namespace U2 {
+
+class FastqRecordBatch;
+class IOAdapter;
+class ThreadedFastqBatchReader;
+
+/**
+ * The per-read part of a FASTQ processing.
+ * It is called from several threads at once, so it must not change any shared state.
+ */
+class U2FORMATS_EXPORT FastqBatchTransformer {
+public:
+    virtual ~FastqBatchTransformer() {}
+
+    /* Appends the FASTQ text of the output records of @batch to @output and returns their count */
+    virtual int transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &os) = 0;
+};
+
+/**
+ * Reads FASTQ files by batches, transforms the batches by a pool of threads
+ * and appends the results to the output file in the input order.
+ * If the output file is gzipped, every batch is compressed by its worker thread
+ * into a separate gzip member, the result is a valid multi-member gzip file.
+ */
+class U2FORMATS_EXPORT FastqBatchProcessor {
+public:
+    /**
+     * If @threadsCount is not positive, the ideal threads count is used.
+     * The worker threads are started in addition to the calling one, so a task
+     * that runs the processor should reserve @threadsCount of RESOURCE_THREAD.
+     */
+    FastqBatchProcessor(FastqBatchTransformer *transformer, int threadsCount = 0);
+
+    /* Processes @inputUrls one by one, the output is appended to @outputUrl */
+    void run(const QStringList &inputUrls, const QString &outputUrl, U2OpStatus &os);
+
+    qint64 getInputRecordsCount() const;
+    qint64 getOutputRecordsCount() const;
+
+    /* Appends a record in the same form as FastqFormat::writeEntry without cutting lines */
+    static void appendRecord(QByteArray &output, const char *header, int headerLength,
+                             const char *sequence, const char *quality, int length);
+
+private:
+    friend class FastqBatchWorkerThread;
+
+    class BatchResult {
+    public:
+        BatchResult() : inputCount(0), outputCount(0) {}
+
+        QByteArray data;
+        int inputCount;
+        int outputCount;
+    };
+
+    void processFile(const QString &inputUrl, IOAdapter *io, int fileIndex, int filesCount, U2OpStatus &os);
+    void writeResults(IOAdapter *io, int fileIndex, int filesCount, U2OpStatus &os);
+    /* Workers loop */
+    void processBatches();
+    FastqRecordBatch * takeBatch(int &index, U2OpStatus &os);
+    void stop();
+
+    FastqBatchTransformer *transformer;
+    int threadsCount;
+    int maxPendingBatches;
+    bool compress;
+    qint64 inputRecordsCount;
+    qint64 outputRecordsCount;
+
+    ThreadedFastqBatchReader *reader;
+    // Guards reading and numbering of batches
+    QMutex readMutex;
+    int takenBatches;
+
+    QMutex mutex;
+    QWaitCondition resultReady;
+    QWaitCondition resultWritten;
+    QMap<int, BatchResult> results;
+    int writtenBatches;
+    int runningWorkers;
+    bool stopped;
+    QString error;
+
+    static const int MAX_PENDING_BATCHES_PER_THREAD;
+    static const int WAIT_TIMEOUT_MS;
+};
+
+} // U2
+
+#endif // _U2_FASTQ_BATCH_PROCESSOR_H_
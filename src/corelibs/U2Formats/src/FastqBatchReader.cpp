@@ -0,0 +1,440 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QThread>
+
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/IOAdapter.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/TextUtils.h>
+#include <U2Core/U2AlphabetUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "FastqBatchReader.h"
+#include "FastqFormat.h"
+
+namespace U2 {
+
+/************************************************************************/
+/* FastqRecordBatch */
+/************************************************************************/
+FastqRecordBatch::FastqRecordBatch()
+    : headersSize(0), sequencesSize(0), qualitiesSize(0)
+{
+
+}
+
+int FastqRecordBatch::size() const {
+    return records.size();
+}
+
+bool FastqRecordBatch::isEmpty() const {
+    return records.isEmpty();
+}
+
+void FastqRecordBatch::clear() {
+    // QVector::resize() to a smaller size does not release memory
+    records.resize(0);
+    headersSize = 0;
+    sequencesSize = 0;
+    qualitiesSize = 0;
+}
+
+QByteArray FastqRecordBatch::getHeader(int i) const {
+    return QByteArray(getHeaderData(i), getHeaderLength(i));
+}
+
+QByteArray FastqRecordBatch::getName(int i) const {
+    return QByteArray(getHeaderData(i), records[i].nameLength);
+}
+
+QByteArray FastqRecordBatch::getComment(int i) const {
+    const Record &record = records[i];
+    const int commentStart = qMin(record.nameLength + 1, record.headerLength);
+    return QByteArray(getHeaderData(i) + commentStart, record.headerLength - commentStart).trimmed();
+}
+
+int FastqRecordBatch::getSequenceLength(int i) const {
+    return records[i].sequenceLength;
+}
+
+const char * FastqRecordBatch::getSequenceData(int i) const {
+    return sequences.constData() + records[i].sequenceOffset;
+}
+
+const char * FastqRecordBatch::getQualityData(int i) const {
+    return qualities.constData() + records[i].sequenceOffset;
+}
+
+const char * FastqRecordBatch::getHeaderData(int i) const {
+    return headers.constData() + records[i].headerOffset;
+}
+
+int FastqRecordBatch::getHeaderLength(int i) const {
+    return records[i].headerLength;
+}
+
+int FastqRecordBatch::getNameLength(int i) const {
+    return records[i].nameLength;
+}
+
+QByteArray FastqRecordBatch::getSequence(int i) const {
+    return QByteArray(getSequenceData(i), getSequenceLength(i));
+}
+
+QByteArray FastqRecordBatch::getQuality(int i) const {
+    return QByteArray(getQualityData(i), getSequenceLength(i));
+}
+
+DNASequence FastqRecordBatch::toDNASequence(int i) const {
+    DNASequence result(QString::fromLatin1(getHeaderData(i), getHeaderLength(i)), getSequence(i));
+    result.quality = DNAQuality(getQuality(i));
+    result.alphabet = U2AlphabetUtils::getById(BaseDNAAlphabetIds::NUCL_DNA_EXTENDED());
+    return result;
+}
+
+qint64 FastqRecordBatch::getBasesCount() const {
+    return sequencesSize;
+}
+
+void FastqRecordBatch::truncate(int recordsCount) {
+    CHECK(recordsCount < records.size(), );
+    headersSize = records[recordsCount].headerOffset;
+    sequencesSize = records[recordsCount].sequenceOffset;
+    qualitiesSize = qMin(qualitiesSize, sequencesSize);
+    records.resize(recordsCount);
+}
+
+void FastqRecordBatch::append(QByteArray &arena, qint64 &used, const char *data, int length) {
+    static const int MIN_ARENA_SIZE = 4096;
+    if (used + length > arena.size()) {
+        arena.resize(int(qMax(used + length, qMax(qint64(MIN_ARENA_SIZE), 2 * qint64(arena.size())))));
+    }
+    memcpy(arena.data() + used, data, length);
+    used += length;
+}
+
+/************************************************************************/
+/* FastqBatchReader */
+/************************************************************************/
+const int FastqBatchReader::DEFAULT_BATCH_RECORDS = 10000;
+const qint64 FastqBatchReader::DEFAULT_BATCH_BASES = 16 * 1024 * 1024;
+const int FastqBatchReader::SKIPPED_RECORDS_LIMIT = 50;
+
+namespace {
+    const int READ_BUFFER_SIZE = 4 * 1024 * 1024;
+
+    void trim(const char *&line, int &length) {
+        while (length > 0 && TextUtils::WHITES[uchar(line[0])]) {
+            line++;
+            length--;
+        }
+        while (length > 0 && TextUtils::WHITES[uchar(line[length - 1])]) {
+            length--;
+        }
+    }
+
+    void setIncompleteRecordError(U2OpStatus &os, const QByteArray &header) {
+        CHECK(!os.hasError(), );
+        os.setError(FastqFormat::tr("Unexpected end of file, the record is incomplete: %1").arg(QString::fromLatin1(header)));
+    }
+}
+
+FastqBatchReader::FastqBatchReader(const GUrl &url, U2OpStatus &os)
+    : io(NULL), ownIo(true), url(url), bufferStart(0), bufferEnd(0), ioEof(false), ioFailed(false), recordsCount(0),
+      upperCase(true), skipBadRecords(false), lookForHeader(false)
+{
+    io = IOAdapterUtils::open(url, os);
+    CHECK_OP_EXT(os, ioEof = true, );
+    buffer.resize(READ_BUFFER_SIZE);
+}
+
+FastqBatchReader::FastqBatchReader(IOAdapter *io)
+    : io(io), ownIo(false), bufferStart(0), bufferEnd(0), ioEof(false), ioFailed(false), recordsCount(0),
+      upperCase(true), skipBadRecords(false), lookForHeader(false)
+{
+    SAFE_POINT_EXT(NULL != io && io->isOpen(), ioEof = true, );
+    url = io->getURL();
+    buffer.resize(READ_BUFFER_SIZE);
+}
+
+FastqBatchReader::~FastqBatchReader() {
+    if (ownIo) {
+        delete io;
+    }
+}
+
+bool FastqBatchReader::readBatch(FastqRecordBatch &batch, U2OpStatus &os, int maxRecords, qint64 maxBases) {
+    batch.clear();
+    while (batch.size() < maxRecords && batch.getBasesCount() < maxBases) {
+        if (!skipBadRecords) {
+            CHECK_BREAK(readRecord(batch, os));
+            continue;
+        }
+        const int recordsBefore = batch.size();
+        U2OpStatusImpl recordOs;
+        const bool read = readRecord(batch, recordOs);
+        if (recordOs.hasError() && !ioFailed) {
+            const QByteArray header = batch.size() > recordsBefore ? batch.getHeader(recordsBefore) : QByteArray();
+            if (skippedRecords.size() < SKIPPED_RECORDS_LIMIT) {
+                skippedRecords << QString::fromLatin1(header) + ": " + recordOs.getError();
+            }
+            batch.truncate(recordsBefore);
+            lookForHeader = true;
+            continue;
+        }
+        CHECK_EXT_BREAK(!recordOs.hasError(), os.setError(recordOs.getError()));
+        CHECK_BREAK(read);
+    }
+    CHECK_OP_EXT(os, batch.clear(), false);
+    return !batch.isEmpty();
+}
+
+bool FastqBatchReader::readRecord(FastqRecordBatch &batch, U2OpStatus &os) {
+    const char *line = NULL;
+    int length = 0;
+
+    do {
+        CHECK(readLine(line, length, os), false);
+        trim(line, length);
+    } while (0 == length || (lookForHeader && '@' != line[0]));
+    lookForHeader = false;
+    CHECK_EXT('@' == line[0], os.setError(FastqFormat::tr("Error while trying to find sequence name start")), false);
+
+    // The record is added at once to be able to report errors with its header
+    FastqRecordBatch::Record newRecord;
+    newRecord.headerOffset = batch.headersSize;
+    newRecord.headerLength = length - 1;
+    newRecord.nameLength = 0;
+    while (newRecord.nameLength < newRecord.headerLength && !TextUtils::WHITES[uchar(line[1 + newRecord.nameLength])]) {
+        newRecord.nameLength++;
+    }
+    newRecord.sequenceOffset = batch.sequencesSize;
+    newRecord.sequenceLength = 0;
+    FastqRecordBatch::append(batch.headers, batch.headersSize, line + 1, newRecord.headerLength);
+    batch.records << newRecord;
+    FastqRecordBatch::Record &record = batch.records.last();
+    const int recordIndex = batch.size() - 1;
+
+    forever {
+        CHECK_EXT(readLine(line, length, os), setIncompleteRecordError(os, batch.getHeader(recordIndex)), false);
+        trim(line, length);
+        CHECK_BREAK(0 == length || '+' != line[0]);
+        const qint64 start = batch.sequencesSize;
+        FastqRecordBatch::append(batch.sequences, batch.sequencesSize, line, length);
+        if (upperCase) {
+            TextUtils::translate(TextUtils::UPPER_CASE_MAP, batch.sequences.data() + start, length);
+        }
+    }
+    if (length > 1) {
+        const QByteArray qualityHeader(line + 1, length - 1);
+        CHECK_EXT(qualityHeader == batch.getHeader(recordIndex), os.setError(FastqFormat::tr("Sequence name differs from quality scores name: %1 and %2")
+                  .arg(QString::fromLatin1(batch.getHeader(recordIndex))).arg(QString::fromLatin1(qualityHeader))), false);
+    }
+    record.sequenceLength = int(batch.sequencesSize - record.sequenceOffset);
+
+    while (batch.qualitiesSize - record.sequenceOffset < record.sequenceLength) {
+        CHECK_EXT(readLine(line, length, os), setIncompleteRecordError(os, batch.getHeader(recordIndex)), false);
+        trim(line, length);
+        FastqRecordBatch::append(batch.qualities, batch.qualitiesSize, line, length);
+    }
+    CHECK_EXT(batch.qualitiesSize == batch.sequencesSize, os.setError(FastqFormat::tr("Bad quality scores: inconsistent size.")), false);
+
+    recordsCount++;
+    return true;
+}
+
+bool FastqBatchReader::readLine(const char *&line, int &length, U2OpStatus &os) {
+    forever {
+        const char *start = buffer.constData() + bufferStart;
+        const char *end = static_cast<const char *>(memchr(start, '\n', bufferEnd - bufferStart));
+        if (NULL != end || (ioEof && bufferStart < bufferEnd)) {
+            length = (NULL != end) ? int(end - start) : bufferEnd - bufferStart;
+            bufferStart += (NULL != end) ? length + 1 : length;
+            line = start;
+            return true;
+        }
+        CHECK(!ioEof, false);
+        CHECK(fillBuffer(os), false);
+    }
+}
+
+bool FastqBatchReader::fillBuffer(U2OpStatus &os) {
+    const int rest = bufferEnd - bufferStart;
+    if (bufferStart > 0) {
+        memmove(buffer.data(), buffer.constData() + bufferStart, rest);
+        bufferStart = 0;
+        bufferEnd = rest;
+    }
+    if (bufferEnd == buffer.size()) {
+        // The line is longer than the buffer
+        buffer.resize(2 * buffer.size());
+    }
+
+    const qint64 read = io->readBlock(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+    CHECK_EXT(read >= 0, ioFailed = true; ioEof = true; os.setError(L10N::errorReadingFile(url)), false);
+    bufferEnd += int(read);
+    ioEof = (0 == read);
+    return true;
+}
+
+bool FastqBatchReader::isEnd() const {
+    return ioEof && bufferStart == bufferEnd;
+}
+
+int FastqBatchReader::getProgress() const {
+    CHECK(NULL != io, 100);
+    return io->getProgress();
+}
+
+qint64 FastqBatchReader::getRecordsCount() const {
+    return recordsCount;
+}
+
+const GUrl & FastqBatchReader::getUrl() const {
+    return url;
+}
+
+void FastqBatchReader::setUpperCase(bool value) {
+    upperCase = value;
+}
+
+void FastqBatchReader::setSkipBadRecords(bool skip) {
+    skipBadRecords = skip;
+}
+
+const QStringList & FastqBatchReader::getSkippedRecords() const {
+    return skippedRecords;
+}
+
+/************************************************************************/
+/* ThreadedFastqBatchReader */
+/************************************************************************/
+class FastqParserThread : public QThread {
+public:
+    FastqParserThread(ThreadedFastqBatchReader *reader)
+        : reader(reader)
+    {
+
+    }
+
+protected:
+    void run() {
+        reader->parse();
+    }
+
+private:
+    ThreadedFastqBatchReader *reader;
+};
+
+const int ThreadedFastqBatchReader::DEFAULT_QUEUE_SIZE = 4;
+
+ThreadedFastqBatchReader::ThreadedFastqBatchReader(const GUrl &url, int queueSize, int maxRecords, qint64 maxBases)
+    : url(url), maxRecords(maxRecords), maxBases(maxBases), finished(false), canceled(false), progress(0), thread(NULL)
+{
+    for (int i = 0; i < qMax(1, queueSize); i++) {
+        batches << new FastqRecordBatch();
+    }
+    freeBatches << batches;
+
+    thread = new FastqParserThread(this);
+    thread->start();
+}
+
+ThreadedFastqBatchReader::~ThreadedFastqBatchReader() {
+    cancel();
+    thread->wait();
+    delete thread;
+    qDeleteAll(batches);
+}
+
+void ThreadedFastqBatchReader::parse() {
+    U2OpStatusImpl os;
+    FastqBatchReader reader(url, os);
+    while (!os.hasError()) {
+        FastqRecordBatch *batch = NULL;
+        {
+            QMutexLocker locker(&mutex);
+            while (freeBatches.isEmpty() && !canceled) {
+                batchReleased.wait(&mutex);
+            }
+            CHECK_BREAK(!canceled);
+            batch = freeBatches.dequeue();
+        }
+
+        const bool read = reader.readBatch(*batch, os, maxRecords, maxBases);
+
+        QMutexLocker locker(&mutex);
+        progress = reader.getProgress();
+        if (!read) {
+            freeBatches.enqueue(batch);
+            break;
+        }
+        parsedBatches.enqueue(batch);
+        batchParsed.wakeAll();
+    }
+
+    QMutexLocker locker(&mutex);
+    if (os.hasError()) {
+        error = os.getError();
+    }
+    finished = true;
+    batchParsed.wakeAll();
+}
+
+FastqRecordBatch * ThreadedFastqBatchReader::takeBatch(U2OpStatus &os) {
+    QMutexLocker locker(&mutex);
+    while (parsedBatches.isEmpty() && !finished && !canceled) {
+        batchParsed.wait(&mutex);
+    }
+    if (!parsedBatches.isEmpty()) {
+        return parsedBatches.dequeue();
+    }
+    if (!error.isEmpty()) {
+        os.setError(error);
+    }
+    return NULL;
+}
+
+void ThreadedFastqBatchReader::releaseBatch(FastqRecordBatch *batch) {
+    SAFE_POINT(batches.contains(batch), "Unknown FASTQ batch", );
+    QMutexLocker locker(&mutex);
+    batch->clear();
+    freeBatches.enqueue(batch);
+    batchReleased.wakeAll();
+}
+
+void ThreadedFastqBatchReader::cancel() {
+    QMutexLocker locker(&mutex);
+    canceled = true;
+    batchReleased.wakeAll();
+    batchParsed.wakeAll();
+}
+
+int ThreadedFastqBatchReader::getProgress() const {
+    QMutexLocker locker(&mutex);
+    return progress;
+}
+
+} // U2
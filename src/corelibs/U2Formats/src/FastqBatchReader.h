@@ -0,0 +1,213 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_FASTQ_BATCH_READER_H_
+#define _U2_FASTQ_BATCH_READER_H_
+
+#include <QMutex>
+#include <QQueue>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <U2Core/DNASequence.h>
+#include <U2Core/GUrl.h>
+#include <U2Core/U2OpStatus.h>
+
+class QThread;
+
+namespace U2 {
+
+class IOAdapter;
+
+/**
+ * A block of FASTQ records. Headers, bases and qualities of all records
+ * are stored contiguously, records only keep offsets into these arenas.
+ * The batch keeps its memory when it is cleared, so a reused batch does not allocate.
+ */
+class U2FORMATS_EXPORT FastqRecordBatch {
+public:
+    FastqRecordBatch();
+
+    int size() const;
+    bool isEmpty() const;
+    /* Removes all records, allocated memory is kept */
+    void clear();
+
+    /* The whole header line without '@' */
+    QByteArray getHeader(int i) const;
+    /* The header up to the first whitespace */
+    QByteArray getName(int i) const;
+    /* The header after the first whitespace */
+    QByteArray getComment(int i) const;
+
+    int getSequenceLength(int i) const;
+    /* The pointers are valid until the batch is cleared */
+    const char * getSequenceData(int i) const;
+    const char * getQualityData(int i) const;
+    const char * getHeaderData(int i) const;
+    int getHeaderLength(int i) const;
+    int getNameLength(int i) const;
+
+    QByteArray getSequence(int i) const;
+    QByteArray getQuality(int i) const;
+    /* Creates a detached sequence: the same as FastqFormat::loadSequence returns */
+    DNASequence toDNASequence(int i) const;
+
+    /* Bases count in the batch */
+    qint64 getBasesCount() const;
+
+private:
+    friend class FastqBatchReader;
+
+    class Record {
+    public:
+        qint64 headerOffset;
+        int headerLength;
+        int nameLength;
+        qint64 sequenceOffset;
+        int sequenceLength;
+    };
+
+    static void append(QByteArray &arena, qint64 &used, const char *data, int length);
+    /* Removes the records starting from @recordsCount */
+    void truncate(int recordsCount);
+
+    QByteArray headers;
+    QByteArray sequences;
+    QByteArray qualities;
+    qint64 headersSize;
+    qint64 sequencesSize;
+    qint64 qualitiesSize;
+    QVector<Record> records;
+};
+
+/**
+ * Reads FASTQ files (including gzipped) by blocks of records.
+ * Supports multiline sequences and qualities the same way FastqFormat does.
+ */
+class U2FORMATS_EXPORT FastqBatchReader {
+public:
+    /* Opens the file, the adapter is chosen by the file extension */
+    FastqBatchReader(const GUrl &url, U2OpStatus &os);
+    /* The adapter must be opened, it is not owned by the reader */
+    FastqBatchReader(IOAdapter *io);
+    ~FastqBatchReader();
+
+    /**
+     * Clears the batch and fills it with the next records.
+     * The batch is finished when @maxRecords are read or the bases count exceeds @maxBases.
+     * Returns false if there are no more records.
+     */
+    bool readBatch(FastqRecordBatch &batch, U2OpStatus &os, int maxRecords = DEFAULT_BATCH_RECORDS, qint64 maxBases = DEFAULT_BATCH_BASES);
+
+    bool isEnd() const;
+    int getProgress() const;
+    qint64 getRecordsCount() const;
+    const GUrl & getUrl() const;
+
+    /* Bases are converted to upper case by default */
+    void setUpperCase(bool upperCase);
+    /**
+     * Malformed records are skipped instead of failing the reading, the same way FastqFormat does.
+     * The reading is continued from the next line starting with '@'. Reading errors still fail.
+     */
+    void setSkipBadRecords(bool skip);
+    /* "header: error" messages of the skipped records, at most SKIPPED_RECORDS_LIMIT of them are kept */
+    const QStringList & getSkippedRecords() const;
+
+    static const int DEFAULT_BATCH_RECORDS;
+    static const qint64 DEFAULT_BATCH_BASES;
+    static const int SKIPPED_RECORDS_LIMIT;
+
+private:
+    bool readRecord(FastqRecordBatch &batch, U2OpStatus &os);
+    /* Returns the next line without the line break; the data is valid until the next call */
+    bool readLine(const char *&line, int &length, U2OpStatus &os);
+    bool fillBuffer(U2OpStatus &os);
+
+    IOAdapter *io;
+    bool ownIo;
+    GUrl url;
+    QByteArray buffer;
+    int bufferStart;
+    int bufferEnd;
+    bool ioEof;
+    bool ioFailed;
+    qint64 recordsCount;
+    bool upperCase;
+    bool skipBadRecords;
+    // the previous record is skipped: the lines before the next header are skipped too
+    bool lookForHeader;
+    QStringList skippedRecords;
+};
+
+/**
+ * Runs FastqBatchReader in a separate thread.
+ * Parsed batches are passed to the consumer through a bounded queue:
+ * the parser waits when all batches are taken, so the memory is limited by @queueSize batches.
+ */
+class U2FORMATS_EXPORT ThreadedFastqBatchReader {
+public:
+    ThreadedFastqBatchReader(const GUrl &url, int queueSize = DEFAULT_QUEUE_SIZE,
+                             int maxRecords = FastqBatchReader::DEFAULT_BATCH_RECORDS, qint64 maxBases = FastqBatchReader::DEFAULT_BATCH_BASES);
+    ~ThreadedFastqBatchReader();
+
+    /**
+     * Blocks until the next batch is parsed.
+     * Returns NULL when there are no more batches or an error occurred.
+     * The batch must be returned back with releaseBatch().
+     */
+    FastqRecordBatch * takeBatch(U2OpStatus &os);
+    void releaseBatch(FastqRecordBatch *batch);
+
+    /* Stops the parser thread */
+    void cancel();
+    int getProgress() const;
+
+    static const int DEFAULT_QUEUE_SIZE;
+
+private:
+    friend class FastqParserThread;
+    void parse();
+
+    GUrl url;
+    int maxRecords;
+    qint64 maxBases;
+    QList<FastqRecordBatch*> batches;
+
+    mutable QMutex mutex;
+    QWaitCondition batchParsed;
+    QWaitCondition batchReleased;
+    QQueue<FastqRecordBatch*> freeBatches;
+    QQueue<FastqRecordBatch*> parsedBatches;
+    bool finished;
+    bool canceled;
+    QString error;
+    int progress;
+
+    QThread *thread;
+};
+
+} // U2
+
+#endif // _U2_FASTQ_BATCH_READER_H_
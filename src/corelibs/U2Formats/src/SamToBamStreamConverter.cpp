@@ -0,0 +1,457 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include <QHash>
+
+extern "C" {
+#include <bam.h>
+}
+
+#include <U2Core/GUrl.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "BAMUtils.h"
+#include "SamToBamStreamConverter.h"
+
+namespace U2 {
+
+namespace {
+
+const int SAM_MANDATORY_FIELDS = 11;
+// the bin of the reads without a position
+const quint32 UNMAPPED_BIN = 4680;
+
+class Field {
+public:
+    Field() : data(NULL), length(0) {}
+    Field(const char *data, int length) : data(data), length(length) {}
+
+    bool isMissed() const {
+        return 1 == length && '*' == data[0];
+    }
+
+    qint64 toInt(bool &ok) const {
+        return QByteArray::fromRawData(data, length).toLongLong(&ok);
+    }
+
+    QByteArray toByteArray() const {
+        return QByteArray(data, length);
+    }
+
+    const char *data;
+    int length;
+};
+
+template<class T>
+inline void appendValue(QByteArray &data, T value) {
+    data.append((const char *)&value, sizeof(T));
+}
+
+int cigarOperation(char c) {
+    switch (c) {
+    case 'M': return BAM_CMATCH;
+    case 'I': return BAM_CINS;
+    case 'D': return BAM_CDEL;
+    case 'N': return BAM_CREF_SKIP;
+    case 'S': return BAM_CSOFT_CLIP;
+    case 'H': return BAM_CHARD_CLIP;
+    case 'P': return BAM_CPAD;
+    case '=': return BAM_CEQUAL;
+    case 'X': return BAM_CDIFF;
+    default: return -1;
+    }
+}
+
+bool consumesReference(int operation) {
+    return BAM_CMATCH == operation || BAM_CDEL == operation || BAM_CREF_SKIP == operation
+        || BAM_CEQUAL == operation || BAM_CDIFF == operation;
+}
+
+QString parseError(qint64 lineNumber, const QString &message) {
+    return BAMUtils::tr("Can not parse the SAM line %1: %2").arg(lineNumber).arg(message);
+}
+
+}
+
+/************************************************************************/
+/* BamStreamWriter */
+/************************************************************************/
+/** Encodes SAM records as they come and writes them to a BAM file */
+class BamStreamWriter {
+public:
+    BamStreamWriter();
+    ~BamStreamWriter();
+
+    void open(const QString &url, const QByteArray &headerText, U2OpStatus &os);
+    void write(const char *line, int length, qint64 lineNumber, U2OpStatus &os);
+    void close(U2OpStatus &os);
+
+private:
+    bool getReferenceId(const Field &name, int &id) const;
+    void encodeCigar(const Field &cigar, bam1_core_t &core, qint64 &referenceLength, qint64 lineNumber, U2OpStatus &os);
+    void encodeSequence(const Field &sequence, const Field &quality, bam1_core_t &core, qint64 lineNumber, U2OpStatus &os);
+    void encodeTag(const Field &tag, qint64 lineNumber, U2OpStatus &os);
+
+    QString url;
+    bamFile file;
+    bam_header_t *header;
+    QHash<QByteArray, int> referenceIds;
+    QByteArray data;
+};
+
+BamStreamWriter::BamStreamWriter()
+    : file(NULL), header(NULL)
+{
+
+}
+
+BamStreamWriter::~BamStreamWriter() {
+    U2OpStatusImpl os;
+    close(os);
+}
+
+void BamStreamWriter::open(const QString &url, const QByteArray &headerText, U2OpStatus &os) {
+    this->url = url;
+    header = bam_header_init();
+    header->l_text = headerText.size();
+    header->text = (char *)malloc(headerText.size() + 1);
+    CHECK_EXT(NULL != header->text, os.setError(L10N::outOfMemory()), );
+    memcpy(header->text, headerText.constData(), headerText.size() + 1);
+    sam_header_parse(header);
+    for (int i = 0; i < header->n_targets; i++) {
+        referenceIds.insert(QByteArray(header->target_name[i]), i);
+    }
+
+    file = bam_open(url.toLocal8Bit().constData(), "w");
+    CHECK_EXT(NULL != file, os.setError(L10N::errorOpeningFileWrite(url)), );
+    CHECK_EXT(0 == bam_header_write(file, header), os.setError(L10N::errorWritingFile(url)), );
+}
+
+void BamStreamWriter::write(const char *line, int length, qint64 lineNumber, U2OpStatus &os) {
+    Field fields[SAM_MANDATORY_FIELDS];
+    const char *end = line + length;
+    const char *fieldStart = line;
+    for (int i = 0; i < SAM_MANDATORY_FIELDS; i++) {
+        CHECK_EXT(fieldStart <= end, os.setError(parseError(lineNumber, BAMUtils::tr("not enough fields"))), );
+        const char *fieldEnd = (const char *)memchr(fieldStart, '\t', end - fieldStart);
+        if (NULL == fieldEnd) {
+            fieldEnd = end;
+        }
+        fields[i] = Field(fieldStart, fieldEnd - fieldStart);
+        fieldStart = fieldEnd + 1;
+    }
+
+    bam1_core_t core;
+    memset(&core, 0, sizeof(bam1_core_t));
+    bool ok = true;
+    bool parsed = true;
+
+    const Field &name = fields[0];
+    CHECK_EXT(name.length > 0 && name.length < 255, os.setError(parseError(lineNumber, BAMUtils::tr("invalid read name"))), );
+    data.resize(0);
+    data.append(name.data, name.length);
+    data.append('\0');
+    core.l_qname = name.length + 1;
+
+    core.flag = fields[1].toInt(ok);
+    parsed = parsed && ok;
+    parsed = parsed && getReferenceId(fields[2], core.tid);
+    core.pos = fields[3].toInt(ok) - 1;
+    parsed = parsed && ok;
+    core.qual = fields[4].toInt(ok);
+    parsed = parsed && ok;
+    CHECK_EXT(parsed, os.setError(parseError(lineNumber, BAMUtils::tr("invalid flag, reference or position"))), );
+
+    qint64 referenceLength = 0;
+    encodeCigar(fields[5], core, referenceLength, lineNumber, os);
+    CHECK_OP(os, );
+    if (core.pos < 0) {
+        core.bin = UNMAPPED_BIN;
+    } else {
+        core.bin = bam_reg2bin(core.pos, qMax(core.pos + referenceLength, qint64(core.pos) + 1));
+    }
+
+    if (1 == fields[6].length && '=' == fields[6].data[0]) {
+        core.mtid = core.tid;
+    } else {
+        parsed = parsed && getReferenceId(fields[6], core.mtid);
+    }
+    core.mpos = fields[7].toInt(ok) - 1;
+    parsed = parsed && ok;
+    core.isize = fields[8].toInt(ok);
+    parsed = parsed && ok;
+    CHECK_EXT(parsed, os.setError(parseError(lineNumber, BAMUtils::tr("invalid mate reference or position"))), );
+
+    encodeSequence(fields[9], fields[10], core, lineNumber, os);
+    CHECK_OP(os, );
+
+    while (fieldStart < end) {
+        const char *fieldEnd = (const char *)memchr(fieldStart, '\t', end - fieldStart);
+        if (NULL == fieldEnd) {
+            fieldEnd = end;
+        }
+        encodeTag(Field(fieldStart, fieldEnd - fieldStart), lineNumber, os);
+        CHECK_OP(os, );
+        fieldStart = fieldEnd + 1;
+    }
+
+    CHECK_EXT(bam_write1_core(file, &core, data.size(), (uint8_t *)data.data()) > 0, os.setError(L10N::errorWritingFile(url)), );
+}
+
+void BamStreamWriter::close(U2OpStatus &os) {
+    if (NULL != file) {
+        if (0 != bam_close(file)) {
+            os.setError(L10N::errorWritingFile(url));
+        }
+        file = NULL;
+    }
+    if (NULL != header) {
+        bam_header_destroy(header);
+        header = NULL;
+    }
+}
+
+bool BamStreamWriter::getReferenceId(const Field &name, int &id) const {
+    if (name.isMissed()) {
+        id = -1;
+        return true;
+    }
+    id = referenceIds.value(QByteArray::fromRawData(name.data, name.length), -1);
+    return -1 != id;
+}
+
+void BamStreamWriter::encodeCigar(const Field &cigar, bam1_core_t &core, qint64 &referenceLength, qint64 lineNumber, U2OpStatus &os) {
+    referenceLength = 0;
+    CHECK(!cigar.isMissed(), );
+
+    quint32 length = 0;
+    bool hasLength = false;
+    for (int i = 0; i < cigar.length; i++) {
+        const char c = cigar.data[i];
+        if (c >= '0' && c <= '9') {
+            length = length * 10 + (c - '0');
+            hasLength = true;
+            continue;
+        }
+        const int operation = cigarOperation(c);
+        CHECK_EXT(-1 != operation && hasLength, os.setError(parseError(lineNumber, BAMUtils::tr("invalid CIGAR"))), );
+        appendValue<quint32>(data, length << BAM_CIGAR_SHIFT | operation);
+        if (consumesReference(operation)) {
+            referenceLength += length;
+        }
+        core.n_cigar++;
+        length = 0;
+        hasLength = false;
+    }
+    CHECK_EXT(!hasLength, os.setError(parseError(lineNumber, BAMUtils::tr("invalid CIGAR"))), );
+}
+
+void BamStreamWriter::encodeSequence(const Field &sequence, const Field &quality, bam1_core_t &core, qint64 lineNumber, U2OpStatus &os) {
+    CHECK(!sequence.isMissed(), );
+    CHECK_EXT(quality.isMissed() || quality.length == sequence.length,
+        os.setError(parseError(lineNumber, BAMUtils::tr("sequence and quality are inconsistent"))), );
+
+    core.l_qseq = sequence.length;
+    const int packedStart = data.size();
+    data.append(QByteArray((sequence.length + 1) / 2, '\0'));
+    uchar *packed = (uchar *)data.data() + packedStart;
+    for (int i = 0; i < sequence.length; i++) {
+        packed[i / 2] |= bam_nt16_table[(uchar)sequence.data[i]] << 4 * (1 - i % 2);
+    }
+
+    if (quality.isMissed()) {
+        data.append(QByteArray(sequence.length, '\xff'));
+    } else {
+        const int qualityStart = data.size();
+        data.append(quality.data, quality.length);
+        char *codes = data.data() + qualityStart;
+        for (int i = 0; i < quality.length; i++) {
+            codes[i] -= 33;
+        }
+    }
+}
+
+void BamStreamWriter::encodeTag(const Field &tag, qint64 lineNumber, U2OpStatus &os) {
+    CHECK(tag.length > 0, );
+    CHECK_EXT(tag.length >= 5 && ':' == tag.data[2] && ':' == tag.data[4],
+        os.setError(parseError(lineNumber, BAMUtils::tr("invalid tag"))), );
+    const Field value(tag.data + 5, tag.length - 5);
+    data.append(tag.data, 2);
+    bool ok = true;
+    switch (tag.data[3]) {
+    case 'A':
+        CHECK_EXT(1 == value.length, os.setError(parseError(lineNumber, BAMUtils::tr("invalid tag"))), );
+        data.append('A');
+        data.append(value.data[0]);
+        break;
+    case 'i': {
+        const qint64 number = value.toInt(ok);
+        if (number < 0) {
+            if (number >= -128) {
+                data.append('c');
+                appendValue<qint8>(data, number);
+            } else if (number >= -32768) {
+                data.append('s');
+                appendValue<qint16>(data, number);
+            } else {
+                data.append('i');
+                appendValue<qint32>(data, number);
+            }
+        } else {
+            if (number <= 255) {
+                data.append('C');
+                appendValue<quint8>(data, number);
+            } else if (number <= 65535) {
+                data.append('S');
+                appendValue<quint16>(data, number);
+            } else {
+                data.append('I');
+                appendValue<quint32>(data, number);
+            }
+        }
+        break;
+    }
+    case 'f':
+        data.append('f');
+        appendValue<float>(data, QByteArray::fromRawData(value.data, value.length).toFloat(&ok));
+        break;
+    case 'Z':
+    case 'H':
+        data.append(tag.data[3]);
+        data.append(value.data, value.length);
+        data.append('\0');
+        break;
+    case 'B': {
+        CHECK_EXT(value.length > 0, os.setError(parseError(lineNumber, BAMUtils::tr("invalid tag"))), );
+        const char type = value.data[0];
+        const QList<QByteArray> numbers = value.toByteArray().mid(2).split(',');
+        const qint32 count = value.length > 2 ? numbers.size() : 0;
+        data.append('B');
+        data.append(type);
+        appendValue<qint32>(data, count);
+        for (int i = 0; i < count && ok; i++) {
+            switch (type) {
+            case 'c': appendValue<qint8>(data, numbers[i].toInt(&ok)); break;
+            case 'C': appendValue<quint8>(data, numbers[i].toUInt(&ok)); break;
+            case 's': appendValue<qint16>(data, numbers[i].toInt(&ok)); break;
+            case 'S': appendValue<quint16>(data, numbers[i].toUInt(&ok)); break;
+            case 'i': appendValue<qint32>(data, numbers[i].toInt(&ok)); break;
+            case 'I': appendValue<quint32>(data, numbers[i].toUInt(&ok)); break;
+            case 'f': appendValue<float>(data, numbers[i].toFloat(&ok)); break;
+            default: ok = false;
+            }
+        }
+        break;
+    }
+    default:
+        ok = false;
+    }
+    CHECK_EXT(ok, os.setError(parseError(lineNumber, BAMUtils::tr("invalid tag"))), );
+}
+
+/************************************************************************/
+/* SamToBamStreamConverter */
+/************************************************************************/
+SamToBamStreamConverter::SamToBamStreamConverter(const QString &bamUrl)
+    : bamUrl(bamUrl), writer(NULL), linesCount(0), readsCount(0)
+{
+
+}
+
+SamToBamStreamConverter::~SamToBamStreamConverter() {
+    delete writer;
+}
+
+void SamToBamStreamConverter::consume(const char *data, int size, U2OpStatus &os) {
+    const char *end = data + size;
+    const char *lineStart = data;
+    while (lineStart < end) {
+        const char *lineEnd = (const char *)memchr(lineStart, '\n', end - lineStart);
+        if (NULL == lineEnd) {
+            incompleteLine.append(lineStart, end - lineStart);
+            return;
+        }
+        if (incompleteLine.isEmpty()) {
+            processLine(lineStart, lineEnd - lineStart, os);
+        } else {
+            incompleteLine.append(lineStart, lineEnd - lineStart);
+            processLine(incompleteLine.constData(), incompleteLine.size(), os);
+            incompleteLine.resize(0);
+        }
+        CHECK_OP(os, );
+        lineStart = lineEnd + 1;
+    }
+}
+
+void SamToBamStreamConverter::finish(U2OpStatus &os) {
+    if (!incompleteLine.isEmpty()) {
+        processLine(incompleteLine.constData(), incompleteLine.size(), os);
+        incompleteLine.clear();
+        CHECK_OP(os, );
+    }
+    if (NULL == writer) {
+        startBam(os);
+        CHECK_OP(os, );
+    }
+    writer->close(os);
+}
+
+qint64 SamToBamStreamConverter::getReadsCount() const {
+    return readsCount;
+}
+
+bool SamToBamStreamConverter::isBamUrl(const QString &url) {
+    return GUrl(url).lastFileSuffix().toLower() == "bam";
+}
+
+void SamToBamStreamConverter::processLine(const char *line, int length, U2OpStatus &os) {
+    linesCount++;
+    if (length > 0 && '\r' == line[length - 1]) {
+        length--;
+    }
+    CHECK(length > 0, );
+
+    if ('@' == line[0]) {
+        CHECK_EXT(NULL == writer, os.setError(parseError(linesCount, BAMUtils::tr("the header line goes after the reads"))), );
+        headerText.append(line, length);
+        headerText.append('\n');
+        return;
+    }
+
+    if (NULL == writer) {
+        startBam(os);
+        CHECK_OP(os, );
+    }
+    writer->write(line, length, linesCount, os);
+    readsCount++;
+}
+
+void SamToBamStreamConverter::startBam(U2OpStatus &os) {
+    writer = new BamStreamWriter();
+    writer->open(bamUrl, headerText, os);
+    headerText.clear();
+}
+
+} // U2
@@ -0,0 +1,62 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_SAM_TO_BAM_STREAM_CONVERTER_H_
+#define _U2_SAM_TO_BAM_STREAM_CONVERTER_H_
+
+#include <U2Core/ExternalToolRunTask.h>
+
+namespace U2 {
+
+class BamStreamWriter;
+
+/**
+ * Converts SAM text printed by an external tool to a BAM file while the tool is running.
+ * Only the current incomplete line is kept in memory, the SAM is never written to disk.
+ */
+class U2FORMATS_EXPORT SamToBamStreamConverter : public ExternalToolOutputConsumer {
+public:
+    SamToBamStreamConverter(const QString &bamUrl);
+    ~SamToBamStreamConverter();
+
+    void consume(const char *data, int size, U2OpStatus &os);
+    void finish(U2OpStatus &os);
+
+    qint64 getReadsCount() const;
+
+    /** Aligners use the BAM stream conversion if the result file has the "bam" extension */
+    static bool isBamUrl(const QString &url);
+
+private:
+    void processLine(const char *line, int length, U2OpStatus &os);
+    void startBam(U2OpStatus &os);
+
+    const QString bamUrl;
+    QByteArray headerText;
+    QByteArray incompleteLine;
+    BamStreamWriter *writer;
+    qint64 linesCount;
+    qint64 readsCount;
+};
+
+} // U2
+
+#endif // _U2_SAM_TO_BAM_STREAM_CONVERTER_H_
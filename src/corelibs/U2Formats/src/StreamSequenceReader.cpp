@@ -20,11 +20,13 @@
  */
 
 #include <U2Core/AppContext.h>
+#include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/DocumentModel.h>
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/IOAdapter.h>
 #include <U2Core/Timer.h>
 
+#include "FastqBatchReader.h"
 #include "StreamSequenceReader.h"
 
 namespace U2 {
@@ -39,7 +41,7 @@ DNASequence* StreamSequenceReader::getNextSequenceObject() {
 }
 
 StreamSequenceReader::StreamSequenceReader()
-: currentReaderIndex(-1), currentSeq(NULL), errorOccured(false), lookupPerformed(false)
+: currentReaderIndex(-1), currentSeq(NULL), fastqBatch(new FastqRecordBatch()), fastqBatchPos(0), errorOccured(false), lookupPerformed(false)
 {
 
 }
@@ -56,7 +58,7 @@ bool StreamSequenceReader::hasNext() {
 
         while (currentReaderIndex < readers.count()) {
             ReaderContext ctx = readers.at(currentReaderIndex);
-            DNASequence *newSeq = ctx.format->loadSequence(ctx.io, taskInfo);
+            DNASequence *newSeq = (NULL != ctx.fastqReader) ? readFastqSequence(ctx) : ctx.format->loadSequence(ctx.io, taskInfo);
             currentSeq.reset(newSeq);
             if (NULL == newSeq) {
                 ++currentReaderIndex;
@@ -93,6 +95,9 @@ bool StreamSequenceReader::init( const QList<GUrl>& urls ) {
             break;
         }
         ctx.io = io;
+        if (BaseDocumentFormats::FASTQ == ctx.format->getFormatId()) {
+            ctx.fastqReader = new FastqBatchReader(io);
+        }
         readers.append(ctx);
     }
 
@@ -125,8 +130,20 @@ int StreamSequenceReader::getProgress() {
     return progress;
 }
 
+DNASequence* StreamSequenceReader::readFastqSequence(ReaderContext& ctx) {
+    if (fastqBatchPos >= fastqBatch->size()) {
+        fastqBatchPos = 0;
+        if (!ctx.fastqReader->readBatch(*fastqBatch, taskInfo)) {
+            return NULL;
+        }
+    }
+    return new DNASequence(fastqBatch->toDNASequence(fastqBatchPos++));
+}
+
 StreamSequenceReader::~StreamSequenceReader() {
     for(int i =0; i < readers.size(); ++i) {
+        delete readers[i].fastqReader;
+        readers[i].fastqReader = NULL;
         delete readers[i].io;
         readers[i].io = NULL;
     }
@@ -34,6 +34,8 @@ namespace U2 {
 
 class Document;
 class DocumentFormat;
+class FastqBatchReader;
+class FastqRecordBatch;
 class IOAdapter;
 
 /**
@@ -49,13 +51,17 @@ class IOAdapter;
 
 class U2FORMATS_EXPORT StreamSequenceReader {
     struct ReaderContext {
-        ReaderContext() : io(NULL), format(NULL) {}
+        ReaderContext() : io(NULL), format(NULL), fastqReader(NULL) {}
         IOAdapter* io;
         DocumentFormat* format;
+        // FASTQ files are parsed by batches
+        FastqBatchReader* fastqReader;
     };
     QList<ReaderContext> readers;
     int currentReaderIndex;
     QScopedPointer<DNASequence> currentSeq;
+    QScopedPointer<FastqRecordBatch> fastqBatch;
+    int fastqBatchPos;
     bool errorOccured;
     bool lookupPerformed;
     QString errorMessage;
@@ -70,6 +76,9 @@ public:
     int getProgress();
     QString getErrorMessage();
     DNASequence* getNextSequenceObject();
+
+private:
+    DNASequence* readFastqSequence(ReaderContext& ctx);
 };
 
 
@@ -192,6 +192,22 @@ U2MsaRow MysqlMsaDbi::getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os
     return res;
 }
 
+QList<DNASequence> MysqlMsaDbi::getRowsSequences(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os) {
+    Q_UNUSED(msaId);
+    QList<DNASequence> res;
+    U2SequenceDbi* sequenceDbi = dbi->getSequenceDbi();
+    foreach (const U2MsaRow& row, rows) {
+        const QByteArray seqData = sequenceDbi->getSequenceData(row.sequenceId, U2Region(row.gstart, row.gend - row.gstart), os);
+        CHECK_OP(os, QList<DNASequence>());
+
+        const U2Sequence seqObj = sequenceDbi->getSequenceObject(row.sequenceId, os);
+        CHECK_OP(os, QList<DNASequence>());
+
+        res << DNASequence(seqObj.visualName, seqData);
+    }
+    return res;
+}
+
 QList<qint64> MysqlMsaDbi::getRowsOrder(const U2DataId& msaId, U2OpStatus& os) {
     QList<qint64> res;
 
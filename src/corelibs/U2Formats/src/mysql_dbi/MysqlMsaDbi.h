@@ -52,6 +52,9 @@ public:
     /** Returns a row with the specified ID */
     virtual U2MsaRow getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
 
+    /** Reads the rows sequences one by one */
+    virtual QList<DNASequence> getRowsSequences(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os);
+
     /** Returns the list of rows IDs in the database for the specified MSA (in increasing order) */
     virtual QList<qint64> getRowsOrder(const U2DataId& msaId, U2OpStatus& os);
 
@@ -28,10 +28,17 @@
 #include <SamtoolsAdapter.h>
 
 #include <QtCore/QVarLengthArray>
+#if (QT_VERSION < 0x050000) //Qt 5
+#include <QtCore/QtConcurrentMap>
+#else
+#include <QtConcurrent/QtConcurrentMap>
+#endif
 
 #include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
 #include <U2Core/Timer.h>
 #include <U2Core/U2AssemblyUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
 #include <U2Core/U2SqlHelpers.h>
 #include <U2Core/U2SafePoints.h>
 
@@ -452,6 +459,67 @@ QByteArray SQLiteAssemblyUtils::packData(SQLiteAssemblyDataMethod method, const
     return res;
 }
 
+namespace {
+
+struct ReadsDataPackerJob {
+    U2Region region;
+    QString error;
+};
+
+/** Packs the reads of the job region into the corresponding part of the result */
+class ReadsDataPacker {
+public:
+    ReadsDataPacker(const QList<U2AssemblyRead> &reads, QByteArray *result)
+        : reads(reads), result(result) {}
+
+    typedef void result_type;
+
+    void operator()(ReadsDataPackerJob &job) const {
+        U2OpStatusImpl os;
+        for (qint64 i = job.region.startPos; i < job.region.endPos() && !os.hasError(); i++) {
+            result[i] = SQLiteAssemblyUtils::packData(SQLiteAssemblyDataMethod_NSCQ, reads.at(i), os);
+        }
+        job.error = os.getError();
+    }
+
+private:
+    const QList<U2AssemblyRead> &reads;
+    QByteArray *result;
+};
+
+const int MIN_READS_PER_PACKER_JOB = 5000;
+
+}
+
+QVector<QByteArray> SQLiteAssemblyUtils::packReadsData(const QList<U2AssemblyRead> &reads, U2OpStatus& os) {
+    const int nReads = reads.size();
+    QVector<QByteArray> res(nReads);
+    // the vector is detached here: jobs write to the disjoint parts of the same buffer
+    QByteArray *data = res.data();
+
+    const int nJobs = qBound(1, nReads / MIN_READS_PER_PACKER_JOB, AppResourcePool::instance()->getIdealThreadCount());
+    if (nJobs == 1) {
+        for (int i = 0; i < nReads && !os.isCoR(); i++) {
+            data[i] = packData(SQLiteAssemblyDataMethod_NSCQ, reads.at(i), os);
+        }
+        return res;
+    }
+
+    QVector<ReadsDataPackerJob> jobs;
+    const int readsPerJob = (nReads + nJobs - 1) / nJobs;
+    for (int start = 0; start < nReads; start += readsPerJob) {
+        ReadsDataPackerJob job;
+        job.region = U2Region(start, qMin(readsPerJob, nReads - start));
+        jobs << job;
+    }
+    // the jobs run in the global thread pool that is shared by all concurrent computations
+    QtConcurrent::blockingMap(jobs, ReadsDataPacker(reads, data));
+    foreach (const ReadsDataPackerJob &job, jobs) {
+        CHECK_EXT(job.error.isEmpty(), os.setError(job.error), res);
+    }
+    return res;
+}
+
 void SQLiteAssemblyUtils::unpackData(const QByteArray& packedData, U2AssemblyRead &read, U2OpStatus& os) {
     QByteArray &name = read->name;
     QByteArray &sequence = read->readSequence;
@@ -157,10 +157,16 @@ enum SQLiteAssemblyDataMethod {
     SQLiteAssemblyDataMethod_NSCQ = 1
 };
 
-class SQLiteAssemblyUtils {
+class U2FORMATS_EXPORT SQLiteAssemblyUtils {
 public:
     static QByteArray packData(SQLiteAssemblyDataMethod method, const U2AssemblyRead &read, U2OpStatus& os);
 
+    /**
+     * Packs data of all reads with SQLiteAssemblyDataMethod_NSCQ method.
+     * Big lists are split between several threads, the result has the same order as the reads.
+     */
+    static QVector<QByteArray> packReadsData(const QList<U2AssemblyRead> &reads, U2OpStatus& os);
+
     static void unpackData(const QByteArray& packed, U2AssemblyRead &read, U2OpStatus& os);
 
     static void calculateCoverage(SQLiteQuery& q, const U2Region& r, U2AssemblyCoverageStat& c, U2OpStatus& os);
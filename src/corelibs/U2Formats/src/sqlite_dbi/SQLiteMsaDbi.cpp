@@ -50,26 +50,16 @@ void SQLiteMsaDbi::initSqlSchema(U2OpStatus& os) {
      //   gstart   - offset of the first element in the sequence
      //   gend     - offset of the last element in the sequence (non-inclusive)
      //   length   - sequence and gaps length (trailing gap are not taken into account)
+     //   gaps     - gap model of the row packed with PackUtils::packGapModel, NULL if the row has no gaps.
+     //              Gap coordinates are relative to the gstart coordinate of the row
     SQLiteQuery("CREATE TABLE MsaRow (msa INTEGER NOT NULL, rowId INTEGER NOT NULL, sequence INTEGER NOT NULL,"
-        " pos INTEGER NOT NULL, gstart INTEGER NOT NULL, gend INTEGER NOT NULL, length INTEGER NOT NULL,"
+        " pos INTEGER NOT NULL, gstart INTEGER NOT NULL, gend INTEGER NOT NULL, length INTEGER NOT NULL, gaps BLOB,"
         " PRIMARY KEY(msa, rowId),"
         " FOREIGN KEY(msa) REFERENCES Msa(object) ON DELETE CASCADE, "
         " FOREIGN KEY(sequence) REFERENCES Sequence(object) ON DELETE CASCADE)", db, os).execute();
     SQLiteQuery("CREATE INDEX MsaRow_msa_rowId ON MsaRow(msa, rowId)", db, os).execute();
     SQLiteQuery("CREATE INDEX MsaRow_length ON MsaRow(length)", db, os).execute();
     SQLiteQuery("CREATE INDEX MsaRow_sequence ON MsaRow(sequence)", db, os).execute();
-
-     // Gap info for a MSA row:
-     //   msa       - msa object id
-     //   rowId     - id of the row in the msa
-     //   gapStart  - start of the gap, the coordinate is relative to the gstart coordinate of the row
-     //   gapEnd    - end of the gap, the coordinate is relative to the gstart coordinate of the row (non-inclusive)
-     // Note! there is invariant: gend - gstart (of the row) == gapEnd - gapStart
-    SQLiteQuery("CREATE TABLE MsaRowGap (msa INTEGER NOT NULL, rowId INTEGER NOT NULL, "
-        "gapStart INTEGER NOT NULL, gapEnd INTEGER NOT NULL, "
-        "FOREIGN KEY(msa, rowId) REFERENCES MsaRow(msa, rowId) ON DELETE CASCADE)",
-        db, os).execute();
-    SQLiteQuery("CREATE INDEX MsaRowGap_msa_rowId ON MsaRowGap(msa, rowId)", db, os).execute();
 }
 
 U2DataId SQLiteMsaDbi::createMsaObject(const QString& folder, const QString& name, const U2AlphabetId& alphabet, U2OpStatus& os) {
@@ -146,31 +136,20 @@ void SQLiteMsaDbi::createMsaRow(const U2DataId& msaId, qint64 posInMsa, U2MsaRow
     qint64 rowLength = calculateRowLength(msaRow.gend - msaRow.gstart, msaRow.gaps);
 
     // Insert the data
-    SQLiteQuery q("INSERT INTO MsaRow(msa, rowId, sequence, pos, gstart, gend, length)"
-        " VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7)", db, os);
-    CHECK_OP(os, );
-
-    q.bindDataId(1, msaId);
-    q.bindInt64(2, msaRow.rowId);
-    q.bindDataId(3, msaRow.sequenceId);
-    q.bindInt64(4, posInMsa);
-    q.bindInt64(5, msaRow.gstart);
-    q.bindInt64(6, msaRow.gend);
-    q.bindInt64(7, rowLength);
-    q.insert();
-}
-
-void SQLiteMsaDbi::createMsaRowGap(const U2DataId& msaId, qint64 msaRowId, const U2MsaGap& msaGap, U2OpStatus& os) {
     SQLiteTransaction t(db, os);
-
-    static const QString queryString("INSERT INTO MsaRowGap(msa, rowId, gapStart, gapEnd) VALUES(?1, ?2, ?3, ?4)");
+    static const QString queryString("INSERT INTO MsaRow(msa, rowId, sequence, pos, gstart, gend, length, gaps)"
+        " VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)");
     QSharedPointer<SQLiteQuery> q = t.getPreparedQuery(queryString, db, os);
     CHECK_OP(os, );
 
     q->bindDataId(1, msaId);
-    q->bindInt64(2, msaRowId);
-    q->bindInt64(3, msaGap.offset);
-    q->bindInt64(4, msaGap.offset + msaGap.gap);
+    q->bindInt64(2, msaRow.rowId);
+    q->bindDataId(3, msaRow.sequenceId);
+    q->bindInt64(4, posInMsa);
+    q->bindInt64(5, msaRow.gstart);
+    q->bindInt64(6, msaRow.gend);
+    q->bindInt64(7, rowLength);
+    bindGapModel(*q, 8, msaRow.gaps);
     q->insert();
 }
 
@@ -178,11 +157,6 @@ void SQLiteMsaDbi::addMsaRowAndGaps(const U2DataId& msaId, qint64 posInMsa, U2Ms
     createMsaRow(msaId, posInMsa, row, os);
     CHECK_OP(os, );
 
-    foreach (const U2MsaGap& gap, row.gaps) {
-        createMsaRowGap(msaId, row.rowId, gap, os);
-        CHECK_OP(os, );
-    }
-
     dbi->getSQLiteObjectDbi()->setParent(msaId, row.sequenceId, os);
 }
 
@@ -413,17 +387,6 @@ void SQLiteMsaDbi::removeRecordFromMsaRow(const U2DataId& msaId, qint64 rowId, U
     q->update(1);
 }
 
-void SQLiteMsaDbi::removeRecordsFromMsaRowGap(const U2DataId& msaId, qint64 rowId, U2OpStatus& os) {
-    SQLiteTransaction t(db, os);
-    static const QString queryString("DELETE FROM MsaRowGap WHERE msa = ?1 AND rowId = ?2");
-    QSharedPointer<SQLiteQuery> q = t.getPreparedQuery(queryString, db, os);
-    CHECK_OP(os, );
-
-    q->bindDataId(1, msaId);
-    q->bindInt64(2, rowId);
-    q->update();
-}
-
 void SQLiteMsaDbi::removeRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os) {
     SQLiteTransaction t(db, os);
     ModificationAction updateAction(dbi, msaId);
@@ -491,7 +454,6 @@ void SQLiteMsaDbi::removeMsaRowAndGaps(const U2DataId& msaId, qint64 rowId, bool
     U2DataId sequenceId = getSequenceIdByRowId(msaId, rowId, os);
     CHECK_OP(os, );
 
-    removeRecordsFromMsaRowGap(msaId, rowId, os);
     removeRecordFromMsaRow(msaId, rowId, os);
 
     dbi->getSQLiteObjectDbi()->removeParent(msaId, sequenceId, removeSequence, os);
@@ -571,10 +533,9 @@ qint64 SQLiteMsaDbi::getMaximumRowId(const U2DataId& msaId, U2OpStatus& os) {
 
 QList<U2MsaRow> SQLiteMsaDbi::getRows(const U2DataId& msaId, U2OpStatus& os) {
     QList<U2MsaRow> res;
-    SQLiteQuery q("SELECT rowId, sequence, gstart, gend, length FROM MsaRow WHERE msa = ?1 ORDER BY pos", db, os);
+    SQLiteQuery q("SELECT rowId, sequence, gstart, gend, length, gaps FROM MsaRow WHERE msa = ?1 ORDER BY pos", db, os);
     q.bindDataId(1, msaId);
 
-    SQLiteQuery gapQ("SELECT gapStart, gapEnd FROM MsaRowGap WHERE msa = ?1 AND rowId = ?2 ORDER BY gapStart", db, os);
     while (q.step()) {
         U2MsaRow row;
         row.rowId = q.getInt64(0);
@@ -582,18 +543,9 @@ QList<U2MsaRow> SQLiteMsaDbi::getRows(const U2DataId& msaId, U2OpStatus& os) {
         row.gstart = q.getInt64(2);
         row.gend = q.getInt64(3);
         row.length = q.getInt64(4);
-
-        gapQ.reset();
-        gapQ.bindDataId(1, msaId);
-        gapQ.bindInt64(2, row.rowId);
-        while (gapQ.step()) {
-            U2MsaGap gap;
-            gap.offset = gapQ.getInt64(0);
-            gap.gap = gapQ.getInt64(1) - gap.offset;
-            row.gaps.append(gap);
-        }
-
+        getGapModel(q, 5, row.gaps, os);
         SAFE_POINT_OP(os, res);
+
         res.append(row);
     }
     return res;
@@ -601,7 +553,7 @@ QList<U2MsaRow> SQLiteMsaDbi::getRows(const U2DataId& msaId, U2OpStatus& os) {
 
 U2MsaRow SQLiteMsaDbi::getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os) {
     U2MsaRow res;
-    SQLiteQuery q("SELECT sequence, gstart, gend, length FROM MsaRow WHERE msa = ?1 AND rowId = ?2", db, os);
+    SQLiteQuery q("SELECT sequence, gstart, gend, length, gaps FROM MsaRow WHERE msa = ?1 AND rowId = ?2", db, os);
     SAFE_POINT_OP(os, res);
 
     q.bindDataId(1, msaId);
@@ -612,24 +564,48 @@ U2MsaRow SQLiteMsaDbi::getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& o
         res.gstart = q.getInt64(1);
         res.gend = q.getInt64(2);
         res.length = q.getInt64(3);
+        getGapModel(q, 4, res.gaps, os);
+        SAFE_POINT_OP(os, res);
         q.ensureDone();
     } else if (!os.hasError()) {
         os.setError(U2DbiL10n::tr("Msa row not found!"));
         SAFE_POINT_OP(os, res);
     }
 
-    SQLiteQuery gapQ("SELECT gapStart, gapEnd FROM MsaRowGap WHERE msa = ?1 AND rowId = ?2 ORDER BY gapStart", db, os);
+    return res;
+}
+
+QList<DNASequence> SQLiteMsaDbi::getRowsSequences(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os) {
+    QList<DNASequence> res;
+
+    QHash<U2DataId, QString> names;
+    SQLiteQuery nameQ("SELECT o.id, o.name FROM MsaRow AS r, Object AS o WHERE r.msa = ?1 AND o.id = r.sequence", db, os);
+    SAFE_POINT_OP(os, res);
+
+    nameQ.bindDataId(1, msaId);
+    while (nameQ.step()) {
+        names.insert(nameQ.getDataId(0, U2Type::Sequence), nameQ.getString(1));
+    }
+    CHECK_OP(os, res);
+
+    // Sequence data chunks adjoin each other, so the whole sequence is a concatenation of its ordered chunks
+    QHash<U2DataId, QByteArray> data;
+    SQLiteQuery dataQ("SELECT sd.sequence, sd.data FROM MsaRow AS r, SequenceData AS sd "
+        "WHERE r.msa = ?1 AND sd.sequence = r.sequence ORDER BY sd.sequence, sd.sstart", db, os);
     SAFE_POINT_OP(os, res);
 
-    gapQ.bindDataId(1, msaId);
-    gapQ.bindInt64(2, rowId);
-    while (gapQ.step()) {
-        U2MsaGap gap;
-        gap.offset = gapQ.getInt64(0);
-        gap.gap = gapQ.getInt64(1) - gap.offset;
-        res.gaps.append(gap);
+    dataQ.bindDataId(1, msaId);
+    while (dataQ.step()) {
+        data[dataQ.getDataId(0, U2Type::Sequence)].append(dataQ.getBlob(1));
     }
+    CHECK_OP(os, res);
 
+    res.reserve(rows.size());
+    foreach (const U2MsaRow& row, rows) {
+        CHECK_EXT(names.contains(row.sequenceId), os.setError(U2DbiL10n::tr("Msa row not found!")), QList<DNASequence>());
+        const QByteArray& seqData = data[row.sequenceId];
+        res << DNASequence(names[row.sequenceId], seqData.mid(row.gstart, row.gend - row.gstart));
+    }
     return res;
 }
 
@@ -740,6 +716,20 @@ qint64 SQLiteMsaDbi::calculateRowLength(qint64 seqLength, const QList<U2MsaGap>&
     return res;
 }
 
+void SQLiteMsaDbi::bindGapModel(SQLiteQuery &q, int index, const QList<U2MsaGap> &gaps) {
+    if (gaps.isEmpty()) {
+        q.bindNull(index);
+    } else {
+        q.bindBlob(index, PackUtils::packGapModel(gaps));
+    }
+}
+
+void SQLiteMsaDbi::getGapModel(SQLiteQuery &q, int column, QList<U2MsaGap> &gaps, U2OpStatus &os) {
+    // NULL is read as an empty blob, i.e. a row without gaps
+    bool ok = PackUtils::unpackGapModel(q.getBlob(column), gaps);
+    CHECK_EXT(ok, os.setError(U2DbiL10n::tr("Invalid gap model of a MSA row")), );
+}
+
 qint64 SQLiteMsaDbi::getRowSequenceLength(const U2DataId& msaId, qint64 rowId, U2OpStatus& os) {
     qint64 res = 0;
     SQLiteQuery q("SELECT gstart, gend FROM MsaRow WHERE msa = ?1 AND rowId = ?2", db, os);
@@ -760,16 +750,6 @@ qint64 SQLiteMsaDbi::getRowSequenceLength(const U2DataId& msaId, qint64 rowId, U
     return res;
 }
 
-void SQLiteMsaDbi::updateRowLength(const U2DataId& msaId, qint64 rowId, qint64 newLength, U2OpStatus& os) {
-    SQLiteQuery q("UPDATE MsaRow SET length = ?1 WHERE msa = ?2 AND rowId = ?3", db, os);
-    CHECK_OP(os, );
-
-    q.bindInt64(1, newLength);
-    q.bindDataId(2, msaId);
-    q.bindInt64(3, rowId);
-    q.update(1);
-}
-
 void SQLiteMsaDbi::updateMsaLengthCore(const U2DataId &msaId, qint64 length, U2OpStatus &os) {
     SQLiteTransaction t(db, os);
     SQLiteQuery q("UPDATE Msa SET length = ?1 WHERE object = ?2", db, os);
@@ -910,23 +890,19 @@ void SQLiteMsaDbi::redo(const U2DataId& msaId, qint64 modType, const QByteArray&
 /************************************************************************/
 void SQLiteMsaDbi::updateGapModelCore(const U2DataId &msaId, qint64 msaRowId, const QList<U2MsaGap> &gapModel, U2OpStatus &os) {
     SQLiteTransaction t(db, os);
-    // Remove obsolete gaps of the row
-    removeRecordsFromMsaRowGap(msaId, msaRowId, os);
-    CHECK_OP(os, );
-
-    // Store the new gap model
-    foreach (const U2MsaGap& gap, gapModel) {
-        createMsaRowGap(msaId, msaRowId, gap, os);
-        CHECK_OP(os, );
-    }
-
-    // Update the row length (without trailing gaps)
     qint64 rowSequenceLength = getRowSequenceLength(msaId, msaRowId, os);
     CHECK_OP(os, );
 
-    qint64 newRowLength = calculateRowLength(rowSequenceLength, gapModel);
-    updateRowLength(msaId, msaRowId, newRowLength, os);
+    // Store the new gap model together with the row length (without trailing gaps)
+    static const QString queryString("UPDATE MsaRow SET gaps = ?1, length = ?2 WHERE msa = ?3 AND rowId = ?4");
+    QSharedPointer<SQLiteQuery> q = t.getPreparedQuery(queryString, db, os);
     CHECK_OP(os, );
+
+    bindGapModel(*q, 1, gapModel);
+    q->bindInt64(2, calculateRowLength(rowSequenceLength, gapModel));
+    q->bindDataId(3, msaId);
+    q->bindInt64(4, msaRowId);
+    q->update(1);
 }
 
 void SQLiteMsaDbi::addRowSubcore(const U2DataId &msaId, qint64 numOfRows, const QList<qint64> &rowsOrder, U2OpStatus &os) {
@@ -49,6 +49,9 @@ public:
     /** Returns a row with the specified ID */
     virtual U2MsaRow getRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
 
+    /** Reads the names and the data of all rows sequences with two queries */
+    virtual QList<DNASequence> getRowsSequences(const U2DataId& msaId, const QList<U2MsaRow>& rows, U2OpStatus& os);
+
     /** Returns the list of rows IDs in the database for the specified MSA (in increasing order) */
     virtual QList<qint64> getRowsOrder(const U2DataId& msaId, U2OpStatus& os);
 
@@ -177,27 +180,18 @@ public:
 
 private:
     /**
-     * Creates new records in MsaRow and MsaRowGap tables for the added row, and
+     * Creates a new record in MsaRow table for the added row, and
      * sets the parent of the sequence object to the MSA object.
      * Sets the assigned ID to the passed U2MsaRow instance.
      */
     void addMsaRowAndGaps(const U2DataId& msaId, qint64 posInMsa, U2MsaRow& row, U2OpStatus& os);
 
-    /**
-     * Adds a new MSA row into database.
-     * To add a gap for the row, use the "createMsaRowGap" method.
-     */
+    /** Adds a new MSA row with its packed gap model into database. */
     void createMsaRow(const U2DataId& msaId, qint64 posInMsa, U2MsaRow& msa, U2OpStatus& os);
 
-    /** Adds a new gap for a MSA row into database. */
-    void createMsaRowGap(const U2DataId& msaId, qint64 msaRowId, const U2MsaGap& msaGap, U2OpStatus& os);
-
-    /** Removes records from MsaRow and MsaRowGap tables for the row. */
+    /** Removes the record from MsaRow table for the row (the gap model is stored in the same record). */
     void removeMsaRowAndGaps(const U2DataId& msaId, qint64 rowId, bool removeSequence, U2OpStatus& os);
 
-    /** Removes all records about the row gaps from the database. */
-    void removeRecordsFromMsaRowGap(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
-
     /** Removes a record about the row from the database. */
     void removeRecordFromMsaRow(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
 
@@ -216,8 +210,11 @@ private:
     /** Gets length of the sequence in the row (without gaps) */
     qint64 getRowSequenceLength(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
 
-    /** Updates 'length' field in MsaRow for specified */
-    void updateRowLength(const U2DataId& msaId, qint64 rowId, qint64 newLength, U2OpStatus& os);
+    /** Binds the packed gap model to the query parameter, an empty model is stored as NULL */
+    static void bindGapModel(SQLiteQuery &q, int index, const QList<U2MsaGap> &gaps);
+
+    /** Reads the packed gap model from the query column */
+    static void getGapModel(SQLiteQuery &q, int column, QList<U2MsaGap> &gaps, U2OpStatus &os);
 
     /** Gets a sequence ID for the row */
     U2DataId getSequenceIdByRowId(const U2DataId& msaId, qint64 rowId, U2OpStatus& os);
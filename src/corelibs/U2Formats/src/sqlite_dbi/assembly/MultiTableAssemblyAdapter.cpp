@@ -453,24 +453,42 @@ void MultiTableAssemblyAdapter::addReads(U2DbiIterator<U2AssemblyRead>* it, U2As
 
         int nRows = readsGrid.size();
         if(lastIteration || readsInGrid > N_READS_TO_FLUSH_TOTAL) {
-            for (int rowPos = 0; rowPos < nRows && !os.isCoR(); rowPos++) {
-                for (int elenPos = 0; elenPos < nElens && !os.isCoR(); elenPos++) {
-                    QList<U2AssemblyRead>& rangeReads = readsGrid[rowPos][elenPos];
+            // pack data of all flushed ranges at once to keep all packer threads busy
+            QList<QPair<int, int> > flushedRanges;
+            QList<U2AssemblyRead> flushedReads;
+            for (int rowPos = 0; rowPos < nRows; rowPos++) {
+                for (int elenPos = 0; elenPos < nElens; elenPos++) {
+                    const QList<U2AssemblyRead>& rangeReads = readsGrid[rowPos][elenPos];
                     int nRangeReads = rangeReads.size();
                     if (nRangeReads == 0 || (!lastIteration && nRangeReads < N_READS_TO_FLUSH_PER_RANGE)) {
                         continue;
                     }
-                    MTASingleTableAdapter* adapter = getAdapterByRowAndElenRange(rowPos, elenPos, true, os);
-                    U2AssemblyReadsImportInfo rangeReadsImportInfo;
-                    // pass the same coverage info through all adapters to accumulate coverage
-                    rangeReadsImportInfo.coverageInfo = ii.coverageInfo;
-                    BufferedDbiIterator<U2AssemblyRead> rangeReadsIterator(rangeReads);
-                    adapter->singleTableAdapter->addReads(&rangeReadsIterator, rangeReadsImportInfo, os);
-                    ii.coverageInfo = rangeReadsImportInfo.coverageInfo;
-                    readsInGrid -= rangeReads.size();
-                    rangeReads.clear();
+                    flushedRanges << qMakePair(rowPos, elenPos);
+                    flushedReads << rangeReads;
                 }
             }
+            QVector<QByteArray> packedData = SQLiteAssemblyUtils::packReadsData(flushedReads, os);
+            flushedReads.clear();
+            CHECK_OP(os, );
+
+            // all tables are filled in a single transaction per flush
+            SQLiteTransaction t(db, os);
+            int packedDataOffset = 0;
+            for (int i = 0; i < flushedRanges.size() && !os.isCoR(); i++) {
+                int rowPos = flushedRanges[i].first;
+                int elenPos = flushedRanges[i].second;
+                QList<U2AssemblyRead>& rangeReads = readsGrid[rowPos][elenPos];
+                MTASingleTableAdapter* adapter = getAdapterByRowAndElenRange(rowPos, elenPos, true, os);
+                CHECK_OP(os, );
+                U2AssemblyReadsImportInfo rangeReadsImportInfo;
+                // pass the same coverage info through all adapters to accumulate coverage
+                rangeReadsImportInfo.coverageInfo = ii.coverageInfo;
+                adapter->singleTableAdapter->addPackedReads(rangeReads, packedData.mid(packedDataOffset, rangeReads.size()), rangeReadsImportInfo, os);
+                ii.coverageInfo = rangeReadsImportInfo.coverageInfo;
+                packedDataOffset += rangeReads.size();
+                readsInGrid -= rangeReads.size();
+                rangeReads.clear();
+            }
         }
         if (lastIteration) {
             break;
@@ -574,7 +592,11 @@ void MultiTableAssemblyAdapter::calculateCoverage(const U2Region& region, U2Asse
 //////////////////////////////////////////////////////////////////////////
 // pack adapter
 
-MultiTablePackAlgorithmAdapter::MultiTablePackAlgorithmAdapter(MultiTableAssemblyAdapter* ma) {
+#define MIGRATION_TABLE "tmp_mig_reads"
+
+MultiTablePackAlgorithmAdapter::MultiTablePackAlgorithmAdapter(MultiTableAssemblyAdapter* ma)
+    : insertMigrationQuery(NULL)
+{
     multiTableAdapter = ma;
     DbRef* db = multiTableAdapter->getDbRef();
     int nElens = multiTableAdapter->getNumberOfElenRanges();
@@ -601,9 +623,15 @@ U2DbiIterator<PackAlgorithmData>* MultiTablePackAlgorithmAdapter::selectAllReads
 }
 
 MultiTablePackAlgorithmAdapter::~MultiTablePackAlgorithmAdapter() {
+    dropMigrationData();
     qDeleteAll(packAdapters);
 }
 
+void MultiTablePackAlgorithmAdapter::assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os) {
+    SQLiteTransaction t(multiTableAdapter->getDbRef(), os);
+    PackAlgorithmAdapter::assignProws(rows, os);
+}
+
 void MultiTablePackAlgorithmAdapter::assignProw(const U2DataId& readId, qint64 prow, U2OpStatus& os) {
     int elenPos = multiTableAdapter->getElenRangePosById(readId);
     int oldRowPos = multiTableAdapter->getRowRangePosById(readId);
@@ -631,93 +659,106 @@ void MultiTablePackAlgorithmAdapter::assignProw(const U2DataId& readId, qint64 p
         packAdaptersGrid[newRowPos][elenPos] = sa;
     }
 
-    QVector<SQLiteReadTableMigrationData>& newTableData = migrations[newA];
-    newTableData.append(SQLiteReadTableMigrationData(U2DbiUtils::toDbiId(readId), oldA, prow));
-    //TODO: add mem check here!
+    int migrationIndex = getMigrationIndex(oldA, newA, os);
+    CHECK_OP(os, );
+    insertMigrationQuery->setOpStatus(os);
+    insertMigrationQuery->reset();
+    insertMigrationQuery->bindInt32(1, migrationIndex);
+    insertMigrationQuery->bindInt64(2, U2DbiUtils::toDbiId(readId));
+    insertMigrationQuery->bindInt64(3, prow);
+    insertMigrationQuery->execute();
+    CHECK_OP(os, );
+    migrations[migrationIndex].nReads++;
+}
+
+int MultiTablePackAlgorithmAdapter::getMigrationIndex(MTASingleTableAdapter* oldA, MTASingleTableAdapter* newA, U2OpStatus& os) {
+    QPair<MTASingleTableAdapter*, MTASingleTableAdapter*> tables(oldA, newA);
+    if (migrationIndexes.contains(tables)) {
+        return migrationIndexes.value(tables);
+    }
+    DbRef* db = multiTableAdapter->getDbRef();
+    if (migrations.isEmpty()) {
+        SQLiteQuery(QString("CREATE TEMPORARY TABLE %1(mig INTEGER NOT NULL, id INTEGER NOT NULL, prow INTEGER NOT NULL)").arg(MIGRATION_TABLE), db, os).execute();
+        CHECK_OP(os, -1);
+    }
+    if (insertMigrationQuery == NULL) {
+        insertMigrationQuery = new SQLiteQuery(QString("INSERT INTO %1(mig, id, prow) VALUES(?1, ?2, ?3)").arg(MIGRATION_TABLE), db, os);
+        CHECK_OP(os, -1);
+    }
+    int migrationIndex = migrations.size();
+    migrations << SQLiteReadTableMigration(oldA, newA);
+    migrationIndexes[tables] = migrationIndex;
+    return migrationIndex;
 }
 
 void MultiTablePackAlgorithmAdapter::releaseDbResources() {
     foreach(SingleTablePackAlgorithmAdapter* a, packAdapters) {
         a->releaseDbResources();
     }
+    delete insertMigrationQuery;
+    insertMigrationQuery = NULL;
 }
 
-void MultiTablePackAlgorithmAdapter::migrate(MTASingleTableAdapter* newA, const QVector<SQLiteReadTableMigrationData>& data, qint64 migratedBefore, qint64 totalMigrationCount, U2OpStatus& os) {
-    SAFE_POINT_OP(os,);
-    //delete reads from old tables, and insert into new one
-    QHash<MTASingleTableAdapter*, QVector<SQLiteReadTableMigrationData> > readsByOldTable;
-    foreach(const SQLiteReadTableMigrationData& d, data) {
-        readsByOldTable[d.oldTable].append(d);
+void MultiTablePackAlgorithmAdapter::dropMigrationData() {
+    delete insertMigrationQuery;
+    insertMigrationQuery = NULL;
+    if (!migrations.isEmpty()) {
+        U2OpStatusImpl osStub; // using stub here -> this operation must be performed even if any of internal queries failed
+        SQLiteQuery(QString("DROP TABLE IF EXISTS %1").arg(MIGRATION_TABLE), multiTableAdapter->getDbRef(), osStub).execute();
     }
-    DbRef* db = multiTableAdapter->getDbRef();
-    foreach(MTASingleTableAdapter* oldA, readsByOldTable.keys()) {
+    migrations.clear();
+    migrationIndexes.clear();
+}
 
-        const QVector<SQLiteReadTableMigrationData>& migData  = readsByOldTable[oldA];
-        if (migData.isEmpty()) {
-            continue;
-        }
-        QString oldTable = oldA->singleTableAdapter->getReadsTableName();
-        QString newTable = newA->singleTableAdapter->getReadsTableName();
-        QString idsTable = "tmp_mig_" + oldTable; //TODO
+void MultiTablePackAlgorithmAdapter::migrate(int migrationIndex, qint64 migratedBefore, qint64 totalMigrationCount, U2OpStatus& os) {
+    SAFE_POINT_OP(os,);
+    //delete reads from old table, and insert into new one
+    const SQLiteReadTableMigration& migration = migrations[migrationIndex];
+    DbRef* db = multiTableAdapter->getDbRef();
+    QString oldTable = migration.oldTable->singleTableAdapter->getReadsTableName();
+    QString newTable = migration.newTable->singleTableAdapter->getReadsTableName();
 
 #ifdef _DEBUG
-        qint64 nOldReads1 = SQLiteQuery("SELECT COUNT(*) FROM " + oldTable, db, os).selectInt64();
-        qint64 nNewReads1 = SQLiteQuery("SELECT COUNT(*) FROM " + newTable, db, os).selectInt64();
-        int readsMoved = migData.size();
-        int rowsPerRange = multiTableAdapter->getRowsPerRange();
-        U2Region newProwRegion(newA->rowPos * rowsPerRange, rowsPerRange);
+    qint64 nOldReads1 = SQLiteQuery("SELECT COUNT(*) FROM " + oldTable, db, os).selectInt64();
+    qint64 nNewReads1 = SQLiteQuery("SELECT COUNT(*) FROM " + newTable, db, os).selectInt64();
+    qint64 readsMoved = migration.nReads;
 #endif
 
-        perfLog.trace(QString("Assembly: running reads migration from %1 to %2 number of reads: %3").arg(oldTable).arg(newTable).arg(migData.size()));
-        quint64 t0 = GTimer::currentTimeMicros();
-
-        { //nested block is needed to ensure all queries are finalized
-
-            SQLiteQuery(QString("CREATE TEMPORARY TABLE %1(id INTEGER PRIMARY KEY, prow INTEGER NOT NULL)").arg(idsTable), db, os).execute();
-            SQLiteQuery insertIds(QString("INSERT INTO %1(id, prow) VALUES(?1, ?2)").arg(idsTable), db, os);
-            foreach(const SQLiteReadTableMigrationData& d, migData) {
-                insertIds.reset(false);
-                insertIds.bindInt64(1, d.readId);
-                insertIds.bindInt32(2, d.newProw);
-                assert(newProwRegion.contains(d.newProw));
-                insertIds.execute();
-                if (os.hasError()) {
-                    break;
-                }
-            }
-
-            SQLiteQuery(QString("INSERT INTO %1(prow, name, gstart, elen, flags, mq, data) "
-                "SELECT %3.prow, name, gstart, elen, flags, mq, data FROM %2, %3 WHERE %2.id = %3.id")
-                .arg(newTable).arg(oldTable).arg(idsTable), db, os).execute();
+    perfLog.trace(QString("Assembly: running reads migration from %1 to %2 number of reads: %3").arg(oldTable).arg(newTable).arg(migration.nReads));
+    quint64 t0 = GTimer::currentTimeMicros();
 
-            SQLiteQuery(QString("DELETE FROM %1 WHERE id IN (SELECT id FROM %2)").arg(oldTable).arg(idsTable), db, os).execute();
+    { //nested block is needed to ensure all queries are finalized
+        SQLiteTransaction t(db, os);
+        SQLiteQuery insertReads(QString("INSERT INTO %1(prow, name, gstart, elen, flags, mq, data) "
+            "SELECT %3.prow, name, gstart, elen, flags, mq, data FROM %2, %3 WHERE %3.mig = ?1 AND %2.id = %3.id")
+            .arg(newTable).arg(oldTable).arg(MIGRATION_TABLE), db, os);
+        insertReads.bindInt32(1, migrationIndex);
+        insertReads.execute();
 
-        }
-        U2OpStatusImpl osStub; // using stub here -> this operation must be performed even if any of internal queries failed
-        SQLiteQuery(QString("DROP TABLE IF EXISTS %1").arg(idsTable), db, osStub).execute();
+        SQLiteQuery deleteReads(QString("DELETE FROM %1 WHERE id IN (SELECT id FROM %2 WHERE mig = ?1)").arg(oldTable).arg(MIGRATION_TABLE), db, os);
+        deleteReads.bindInt32(1, migrationIndex);
+        deleteReads.execute();
+    }
 
-        qint64 nMigrated = migratedBefore + migData.size();
-        perfLog.trace(QString("Assembly: reads migration from %1 to %2 finished, time %3 seconds, progress: %4/%5 (%6%)")
-            .arg(oldTable).arg(newTable).arg((GTimer::currentTimeMicros() - t0)/float(1000*1000))
-            .arg(nMigrated).arg(totalMigrationCount).arg(100*nMigrated/totalMigrationCount));
+    qint64 nMigrated = migratedBefore + migration.nReads;
+    perfLog.trace(QString("Assembly: reads migration from %1 to %2 finished, time %3 seconds, progress: %4/%5 (%6%)")
+        .arg(oldTable).arg(newTable).arg((GTimer::currentTimeMicros() - t0)/float(1000*1000))
+        .arg(nMigrated).arg(totalMigrationCount).arg(100*nMigrated/totalMigrationCount));
 
 #ifdef _DEBUG
-        qint64 nOldReads2 = SQLiteQuery("SELECT COUNT(*) FROM " + oldTable, db, os).selectInt64();
-        qint64 nNewReads2 = SQLiteQuery("SELECT COUNT(*) FROM " + newTable, db, os).selectInt64();
-        assert(nOldReads1 + nNewReads1 == nOldReads2 + nNewReads2);
-        assert(nNewReads1 + readsMoved == nNewReads2);
+    qint64 nOldReads2 = SQLiteQuery("SELECT COUNT(*) FROM " + oldTable, db, os).selectInt64();
+    qint64 nNewReads2 = SQLiteQuery("SELECT COUNT(*) FROM " + newTable, db, os).selectInt64();
+    assert(nOldReads1 + nNewReads1 == nOldReads2 + nNewReads2);
+    assert(nNewReads1 + readsMoved == nNewReads2);
 #endif
-
-    }
 }
 
 void MultiTablePackAlgorithmAdapter::migrateAll(U2OpStatus& os) {
     SAFE_POINT_OP(os,);
 
     qint64 nReadsToMigrate = 0;
-    foreach(MTASingleTableAdapter* newTable, migrations.keys()) {
-        const QVector<SQLiteReadTableMigrationData>& data = migrations[newTable];
-        nReadsToMigrate+=data.size();
+    foreach(const SQLiteReadTableMigration& migration, migrations) {
+        nReadsToMigrate += migration.nReads;
     }
     if (nReadsToMigrate == 0) {
         return;
@@ -737,13 +778,13 @@ void MultiTablePackAlgorithmAdapter::migrateAll(U2OpStatus& os) {
     }
 
     SAFE_POINT_OP(os, );
-    int nMigrated = 0;
-    foreach(MTASingleTableAdapter* newTable, migrations.keys()) {
-        const QVector<SQLiteReadTableMigrationData>& data = migrations[newTable];
-        migrate(newTable, data, nMigrated, nReadsToMigrate, os);
-        nMigrated+=data.size();
+    SQLiteQuery(QString("CREATE INDEX %1_mig ON %1(mig, id)").arg(MIGRATION_TABLE), multiTableAdapter->getDbRef(), os).execute();
+    qint64 nMigrated = 0;
+    for (int i = 0; i < migrations.size() && !os.hasError(); i++) {
+        migrate(i, nMigrated, nReadsToMigrate, os);
+        nMigrated += migrations[i].nReads;
     }
-    migrations.clear();
+    dropMigrationData();
 }
 
 
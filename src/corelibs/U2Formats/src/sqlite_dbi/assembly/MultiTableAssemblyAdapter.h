@@ -131,15 +131,16 @@ protected:
     QReadWriteLock                              tablesSyncLock;
 };
 
-class SQLiteReadTableMigrationData {
+/** Reads moved from one table to another one by the pack algorithm */
+class SQLiteReadTableMigration {
 public:
-    SQLiteReadTableMigrationData() : readId (-1), oldTable(NULL), newProw(-1){}
-    SQLiteReadTableMigrationData(qint64 oldId, MTASingleTableAdapter* oldT, int newP)
-        : readId(oldId), oldTable(oldT), newProw(newP) {}
+    SQLiteReadTableMigration() : oldTable(NULL), newTable(NULL), nReads(0) {}
+    SQLiteReadTableMigration(MTASingleTableAdapter* oldT, MTASingleTableAdapter* newT)
+        : oldTable(oldT), newTable(newT), nReads(0) {}
 
-    qint64                  readId;
     MTASingleTableAdapter*  oldTable;
-    int                     newProw;
+    MTASingleTableAdapter*  newTable;
+    qint64                  nReads;
 };
 
 class MultiTablePackAlgorithmAdapter : public PackAlgorithmAdapter {
@@ -149,18 +150,24 @@ public:
 
     virtual U2DbiIterator<PackAlgorithmData>* selectAllReads(U2OpStatus& os);
     virtual void assignProw(const U2DataId& readId, qint64 prow, U2OpStatus& os);
+    virtual void assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os);
 
     void releaseDbResources();
     void migrateAll(U2OpStatus& os);
 
 private:
     void ensureGridSize(int nRows);
-    void migrate(MTASingleTableAdapter* newA, const QVector<SQLiteReadTableMigrationData>& data, qint64 migratedBefore, qint64 totalMigrationCount, U2OpStatus& os);
+    int getMigrationIndex(MTASingleTableAdapter* oldA, MTASingleTableAdapter* newA, U2OpStatus& os);
+    void migrate(int migrationIndex, qint64 migratedBefore, qint64 totalMigrationCount, U2OpStatus& os);
+    void dropMigrationData();
 
     MultiTableAssemblyAdapter*                              multiTableAdapter;
     QVector<SingleTablePackAlgorithmAdapter*>               packAdapters;
     QVector< QVector<SingleTablePackAlgorithmAdapter*> >    packAdaptersGrid;
-    QHash<MTASingleTableAdapter*, QVector<SQLiteReadTableMigrationData> > migrations;
+    // ids and new rows of the moved reads are written into a temporary table, only the counters are kept in memory
+    QVector<SQLiteReadTableMigration>                       migrations;
+    QHash<QPair<MTASingleTableAdapter*, MTASingleTableAdapter*>, int> migrationIndexes;
+    SQLiteQuery*                                            insertMigrationQuery;
 };
 
 // Class that multiplexes multiple read iterators into 1
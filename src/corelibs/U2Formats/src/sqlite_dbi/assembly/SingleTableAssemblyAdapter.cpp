@@ -174,16 +174,33 @@ U2DbiIterator<U2AssemblyRead>* SingleTableAssemblyAdapter::getReadsByName(const
         new SQLiteAssemblyNameFilter(name), U2AssemblyRead(), os);
 }
 
+QString SingleTableAssemblyAdapter::getInsertReadQuery() const {
+    return QString("INSERT INTO %1(name, prow, flags, gstart, elen, mq, data) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)").arg(readsTable);
+}
+
+void SingleTableAssemblyAdapter::insertRead(SQLiteQuery& insertQ, const U2AssemblyRead& read, const QByteArray& packedData) {
+    bool dnaExt = false; //TODO:
+    qint64 flags = read->flags;
+    flags = flags | (dnaExt ? DnaExtAlphabet : 0);
+
+    int hash = qHash(read->name);
+    insertQ.reset();
+    insertQ.bindInt64(1, hash);
+    insertQ.bindInt64(2, read->packedViewRow);
+    insertQ.bindInt64(3, flags);
+    insertQ.bindInt64(4, read->leftmostPos);
+    insertQ.bindInt64(5, read->effectiveLen);
+    insertQ.bindInt32(6, read->mappingQuality);
+    insertQ.bindBlob(7, packedData, false);
+
+    insertQ.insert();
+}
+
 void SingleTableAssemblyAdapter::addReads(U2DbiIterator<U2AssemblyRead>* it, U2AssemblyReadsImportInfo& ii, U2OpStatus& os) {
     SQLiteTransaction t(db, os);
-    QString q = "INSERT INTO %1(name, prow, flags, gstart, elen, mq, data) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)";
-    SQLiteQuery insertQ(q.arg(readsTable), db, os);
+    SQLiteQuery insertQ(getInsertReadQuery(), db, os);
     while (it->hasNext() && !os.isCoR()) {
         U2AssemblyRead read = it->next();
-        bool dnaExt = false; //TODO:
-        qint64 flags = read->flags;
-        flags = flags | (dnaExt ? DnaExtAlphabet : 0);
-
         if (rangeMode) { //effective read length must be precomputed in this mode
             assert(read->effectiveLen >= minReadLength && read->effectiveLen < maxReadLength);
         } else {
@@ -192,18 +209,24 @@ void SingleTableAssemblyAdapter::addReads(U2DbiIterator<U2AssemblyRead>* it, U2A
             read->effectiveLen = effectiveReadLength;
         }
 
-        int hash = qHash(read->name);
-        insertQ.reset();
-        insertQ.bindInt64(1, hash);
-        insertQ.bindInt64(2, read->packedViewRow);
-        insertQ.bindInt64(3, flags);
-        insertQ.bindInt64(4, read->leftmostPos);
-        insertQ.bindInt64(5, read->effectiveLen);
-        insertQ.bindInt32(6, read->mappingQuality);
         QByteArray packedData = SQLiteAssemblyUtils::packData(SQLiteAssemblyDataMethod_NSCQ, read, os);
-        insertQ.bindBlob(7, packedData, false);
+        insertRead(insertQ, read, packedData);
+
+        SQLiteAssemblyUtils::addToCoverage(ii.coverageInfo, read);
+
+        ii.nReads++;
+    }
+}
 
-        insertQ.insert();
+void SingleTableAssemblyAdapter::addPackedReads(const QList<U2AssemblyRead>& reads, const QVector<QByteArray>& packedData, U2AssemblyReadsImportInfo& ii, U2OpStatus& os) {
+    SAFE_POINT_EXT(reads.size() == packedData.size(), os.setError("Packed data does not correspond to the reads"), );
+    SQLiteTransaction t(db, os);
+    SQLiteQuery insertQ(getInsertReadQuery(), db, os);
+    CHECK_OP(os, );
+    for (int i = 0, n = reads.size(); i < n && !os.isCoR(); i++) {
+        const U2AssemblyRead& read = reads.at(i);
+        assert(!rangeMode || (read->effectiveLen >= minReadLength && read->effectiveLen < maxReadLength));
+        insertRead(insertQ, read, packedData.at(i));
 
         SQLiteAssemblyUtils::addToCoverage(ii.coverageInfo, read);
 
@@ -273,6 +296,11 @@ void SingleTablePackAlgorithmAdapter::assignProw(const U2DataId& readId, qint64
     updateQuery->execute();
 }
 
+void SingleTablePackAlgorithmAdapter::assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os) {
+    SQLiteTransaction t(db, os);
+    PackAlgorithmAdapter::assignProws(rows, os);
+}
+
 void SingleTablePackAlgorithmAdapter::releaseDbResources() {
     delete updateQuery;
     updateQuery = NULL;
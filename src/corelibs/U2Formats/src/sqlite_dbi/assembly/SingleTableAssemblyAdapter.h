@@ -49,6 +49,8 @@ public:
     virtual U2DbiIterator<U2AssemblyRead>* getReadsByName(const QByteArray& name, U2OpStatus& os);
 
     virtual void addReads(U2DbiIterator<U2AssemblyRead>* it, U2AssemblyReadsImportInfo& ii, U2OpStatus& os);
+    /** Adds reads with data already packed by SQLiteAssemblyUtils::packReadsData. Effective read lengths must be precomputed */
+    void addPackedReads(const QList<U2AssemblyRead>& reads, const QVector<QByteArray>& packedData, U2AssemblyReadsImportInfo& ii, U2OpStatus& os);
     virtual void removeReads(const QList<U2DataId>& readIds, U2OpStatus& os);
     virtual void dropReadsTables(U2OpStatus& os);
 
@@ -69,6 +71,8 @@ public:
 
 protected:
     void bindRegion(SQLiteQuery& q, const U2Region& r, bool forCount = false);
+    QString getInsertReadQuery() const;
+    static void insertRead(SQLiteQuery& insertQ, const U2AssemblyRead& read, const QByteArray& packedData);
 
     SQLiteDbi*  dbi;
     QString     readsTable;
@@ -86,6 +90,7 @@ public:
 
     virtual U2DbiIterator<PackAlgorithmData>* selectAllReads(U2OpStatus& os);
     virtual void assignProw(const U2DataId& readId, qint64 prow, U2OpStatus& os);
+    virtual void assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os);
 
     void releaseDbResources();
 private:
@@ -0,0 +1,105 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <U2Core/U2Dbi.h>
+#include <U2Core/U2DbiPackUtils.h>
+#include <U2Core/U2SafePoints.h>
+#include <U2Core/U2SqlHelpers.h>
+
+#include "SqliteUpgraderFrom_1_13_To_1_23.h"
+#include "../SQLiteDbi.h"
+
+namespace U2 {
+
+SqliteUpgraderFrom_1_13_To_1_23::SqliteUpgraderFrom_1_13_To_1_23(SQLiteDbi *dbi) :
+    SqliteUpgrader(Version::parseVersion("1.13.0"), Version::parseVersion("1.23.0"), dbi)
+{
+}
+
+void SqliteUpgraderFrom_1_13_To_1_23::upgrade(U2OpStatus &os) const {
+    SQLiteTransaction t(dbi->getDbRef(), os);
+    Q_UNUSED(t);
+
+    upgradeMsaDbi(os);
+    CHECK_OP(os, );
+
+    dbi->setProperty(U2DbiOptions::APP_MIN_COMPATIBLE_VERSION, "1.23.0", os);
+}
+
+void SqliteUpgraderFrom_1_13_To_1_23::upgradeMsaDbi(U2OpStatus &os) const {
+    DbRef *db = dbi->getDbRef();
+
+    SQLiteQuery columnsQuery("PRAGMA table_info(MsaRow)", db, os);
+    CHECK_OP(os, );
+
+    bool hasGaps = false;
+    while (columnsQuery.step()) {
+        if ("gaps" == columnsQuery.getString(1)) {
+            hasGaps = true;
+            break;
+        }
+    }
+    CHECK(!hasGaps, );
+
+    SQLiteQuery("ALTER TABLE MsaRow ADD gaps BLOB", db, os).execute();
+    CHECK_OP(os, );
+
+    // Move the gaps from the MsaRowGap table (one record per gap) to the packed gap models of the rows
+    SQLiteQuery gapsQuery("SELECT msa, rowId, gapStart, gapEnd FROM MsaRowGap ORDER BY msa, rowId, gapStart", db, os);
+    CHECK_OP(os, );
+
+    SQLiteQuery updateQuery("UPDATE MsaRow SET gaps = ?1 WHERE msa = ?2 AND rowId = ?3", db, os);
+    CHECK_OP(os, );
+
+    U2DataId msaId;
+    qint64 rowId = 0;
+    QList<U2MsaGap> gaps;
+    while (gapsQuery.step()) {
+        const U2DataId gapMsaId = gapsQuery.getDataId(0, U2Type::Msa);
+        const qint64 gapRowId = gapsQuery.getInt64(1);
+        if (gapMsaId != msaId || gapRowId != rowId) {
+            storeGapModel(updateQuery, msaId, rowId, gaps);
+            CHECK_OP(os, );
+            msaId = gapMsaId;
+            rowId = gapRowId;
+            gaps.clear();
+        }
+        const qint64 gapStart = gapsQuery.getInt64(2);
+        gaps << U2MsaGap(gapStart, gapsQuery.getInt64(3) - gapStart);
+    }
+    CHECK_OP(os, );
+
+    storeGapModel(updateQuery, msaId, rowId, gaps);
+    CHECK_OP(os, );
+
+    SQLiteQuery("DROP TABLE MsaRowGap", db, os).execute();
+}
+
+void SqliteUpgraderFrom_1_13_To_1_23::storeGapModel(SQLiteQuery &updateQuery, const U2DataId &msaId, qint64 rowId, const QList<U2MsaGap> &gaps) const {
+    CHECK(!gaps.isEmpty(), );
+    updateQuery.reset();
+    updateQuery.bindBlob(1, PackUtils::packGapModel(gaps));
+    updateQuery.bindDataId(2, msaId);
+    updateQuery.bindInt64(3, rowId);
+    updateQuery.update(1);
+}
+
+}   // namespace U2
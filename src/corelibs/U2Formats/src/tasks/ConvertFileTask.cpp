@@ -160,10 +160,7 @@ void BamSamConversionTask::run() {
         CHECK_OP(stateInfo, );
 
         QString sortedBamBase = targetUrl + ".sorted";
-        targetUrl = BAMUtils::sortBam(targetUrl, sortedBamBase, stateInfo).getURLString();
-        CHECK_OP(stateInfo, );
-
-        BAMUtils::createBamIndex(targetUrl, stateInfo);
+        targetUrl = BAMUtils::sortBam(targetUrl, sortedBamBase, stateInfo, 0, true).getURLString();
     } else {
         BAMUtils::convertToSamOrBam(targetUrl, sourceURL, options, stateInfo);
     }
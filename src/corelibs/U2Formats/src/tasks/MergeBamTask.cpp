@@ -61,14 +61,10 @@ void MergeBamTask::run(){
         return;
     }
 
-    BAMUtils::mergeBam(bamUrls, workingDir + outputName, stateInfo);
+    //TODO: bam merge assumes that a BAM files is sorted. Otherwise the sorting step can be added here
+    BAMUtils::mergeBam(bamUrls, workingDir + outputName, stateInfo, true);
     CHECK_OP(stateInfo, );
 
     targetUrl = workingDir + outputName;
-
-    //TODO: bam merge assumes that a BAM files is sorted. Otherwise the sorting step can be added here
-
-    BAMUtils::createBamIndex(targetUrl, stateInfo);
-
 }
 } // U2
@@ -0,0 +1,208 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <U2Core/AppResources.h>
+#include <U2Core/DNAInfo.h>
+#include <U2Core/U2AlphabetUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "FastaFormat.h"
+#include "ReadIndexedFastaTask.h"
+
+namespace U2 {
+
+const qint64 ReadIndexedFastaTask::MIN_CHUNK_BASES = 16 * 1024 * 1024;
+
+ReadIndexedFastaTask::ReadIndexedFastaTask(const GUrl &fastaUrl, const QStringList &sequenceNames)
+    : Task(tr("Read indexed FASTA file: %1").arg(fastaUrl.fileName()), TaskFlags_NR_FOSE_COSC),
+      fastaUrl(fastaUrl),
+      sequenceNames(sequenceNames),
+      maxCount(0),
+      indexTask(NULL),
+      memoryLocker(stateInfo, 0)
+{
+    tpm = Progress_SubTasksBased;
+}
+
+void ReadIndexedFastaTask::setHeaderFilter(const QString &pattern, int count) {
+    headerPattern = pattern;
+    maxCount = count;
+}
+
+void ReadIndexedFastaTask::prepare() {
+    indexTask = new GetFastaIndexTask(fastaUrl);
+    indexTask->setHeaderFilter(headerPattern, maxCount);
+    addSubTask(indexTask);
+}
+
+QList<Task *> ReadIndexedFastaTask::onSubTaskFinished(Task *subTask) {
+    QList<Task *> res;
+    CHECK(subTask == indexTask, res);
+    CHECK_OP(stateInfo, res);
+
+    index = indexTask->getResult();
+    res = createReadTasks();
+    CHECK_OP(stateInfo, res);
+    setMaxParallelSubtasks(AppResourcePool::instance()->getIdealThreadCount());
+    return res;
+}
+
+QList<Task *> ReadIndexedFastaTask::createReadTasks() {
+    QList<FastaIndexEntry> entries;
+    qint64 totalLength = 0;
+    if (sequenceNames.isEmpty()) {
+        entries = indexTask->getSelectedEntries();
+    } else {
+        foreach (const QString &name, sequenceNames) {
+            const FastaIndexEntry *entry = index.findEntry(name);
+            CHECK_EXT(NULL != entry, setError(FastaFormat::tr("Sequence is not found in the FASTA index: %1").arg(name)), QList<Task *>());
+            entries << *entry;
+        }
+    }
+    foreach (const FastaIndexEntry &entry, entries) {
+        totalLength += entry.length;
+    }
+    // the sequences are kept in memory until the task is deleted
+    CHECK_EXT(memoryLocker.tryAcquire(totalLength), setError(tr("Not enough memory to read %1 bases of the file: %2").arg(totalLength).arg(fastaUrl.getURLString())), QList<Task *>());
+
+    // several chunks per thread to balance records of different length
+    const int threadsCount = AppResourcePool::instance()->getIdealThreadCount();
+    const qint64 chunkBases = qMax(MIN_CHUNK_BASES, totalLength / qMax(1, 4 * threadsCount));
+
+    QList<Task *> res;
+    QList<FastaIndexEntry> chunk;
+    qint64 chunkLength = 0;
+    foreach (const FastaIndexEntry &entry, entries) {
+        chunk << entry;
+        chunkLength += entry.length;
+        if (chunkLength >= chunkBases) {
+            readTasks << new ReadFastaRecordsTask(fastaUrl, index, chunk);
+            res << readTasks.last();
+            chunk.clear();
+            chunkLength = 0;
+        }
+    }
+    if (!chunk.isEmpty()) {
+        readTasks << new ReadFastaRecordsTask(fastaUrl, index, chunk);
+        res << readTasks.last();
+    }
+    return res;
+}
+
+void ReadIndexedFastaTask::run() {
+    foreach (ReadFastaRecordsTask *readTask, readTasks) {
+        result << readTask->takeResult();
+    }
+}
+
+const FastaIndex & ReadIndexedFastaTask::getIndex() const {
+    return index;
+}
+
+QList<DNASequence> ReadIndexedFastaTask::takeResult() {
+    QList<DNASequence> res = result;
+    result.clear();
+    return res;
+}
+
+/************************************************************************/
+/* GetFastaIndexTask */
+/************************************************************************/
+GetFastaIndexTask::GetFastaIndexTask(const GUrl &fastaUrl)
+    : Task(tr("Index FASTA file: %1").arg(fastaUrl.fileName()), TaskFlag_None),
+      fastaUrl(fastaUrl),
+      maxCount(0)
+{
+
+}
+
+void GetFastaIndexTask::setHeaderFilter(const QString &pattern, int count) {
+    headerPattern = pattern;
+    maxCount = count;
+}
+
+void GetFastaIndexTask::run() {
+    index = FastaIndex::getIndex(fastaUrl, stateInfo);
+    CHECK_OP(stateInfo, );
+
+    const bool filterHeaders = !headerPattern.isEmpty();
+    const QRegExp headerRegExp(headerPattern);
+    FastaIndexedReader reader(fastaUrl, index);
+    foreach (const FastaIndexEntry &entry, index.getEntries()) {
+        CHECK_BREAK(0 == maxCount || selectedEntries.size() < maxCount);
+        CHECK(!isCanceled(), );
+        CHECK_OPERATION(0 != entry.length, continue);
+        if (filterHeaders) {
+            const QString header = reader.readHeader(entry, stateInfo);
+            CHECK_OP(stateInfo, );
+            CHECK_OPERATION(header.contains(headerRegExp), continue);
+        }
+        selectedEntries << entry;
+    }
+}
+
+const FastaIndex & GetFastaIndexTask::getResult() const {
+    return index;
+}
+
+const QList<FastaIndexEntry> & GetFastaIndexTask::getSelectedEntries() const {
+    return selectedEntries;
+}
+
+/************************************************************************/
+/* ReadFastaRecordsTask */
+/************************************************************************/
+ReadFastaRecordsTask::ReadFastaRecordsTask(const GUrl &fastaUrl, const FastaIndex &index, const QList<FastaIndexEntry> &entries)
+    : Task(tr("Read FASTA records"), TaskFlag_None),
+      fastaUrl(fastaUrl),
+      index(index),
+      entries(entries)
+{
+
+}
+
+void ReadFastaRecordsTask::run() {
+    FastaIndexedReader reader(fastaUrl, index);
+    for (int i = 0; i < entries.size() && !isCanceled(); i++) {
+        const FastaIndexEntry &entry = entries[i];
+        CHECK_OPERATION(0 != entry.length, continue);
+        const QString header = reader.readHeader(entry, stateInfo);
+        CHECK_OP(stateInfo, );
+        const QByteArray sequence = reader.read(entry, U2Region(0, entry.length), stateInfo);
+        CHECK_OP(stateInfo, );
+
+        const DNAAlphabet *alphabet = U2AlphabetUtils::findBestAlphabet(sequence);
+        CHECK_EXT(NULL != alphabet, setError(tr("Can't detect the alphabet of the sequence: %1").arg(entry.name)), );
+        DNASequence dnaSequence(header.isEmpty() ? "Sequence" : header, sequence, alphabet);
+        dnaSequence.info.insert(DNAInfo::FASTA_HDR, header);
+        result << dnaSequence;
+        stateInfo.setProgress(100 * (i + 1) / entries.size());
+    }
+}
+
+QList<DNASequence> ReadFastaRecordsTask::takeResult() {
+    QList<DNASequence> res = result;
+    result.clear();
+    return res;
+}
+
+} // U2
@@ -0,0 +1,115 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_READ_INDEXED_FASTA_TASK_H_
+#define _U2_READ_INDEXED_FASTA_TASK_H_
+
+#include <U2Core/AppResources.h>
+#include <U2Core/DNASequence.h>
+#include <U2Core/GUrl.h>
+#include <U2Core/Task.h>
+
+#include "FastaIndex.h"
+
+namespace U2 {
+
+class GetFastaIndexTask;
+class ReadFastaRecordsTask;
+
+/**
+ * Reads sequences of a local FASTA file in parallel: the file is indexed once (or an existing ".fai" is used),
+ * then the records are split into chunks with the similar bases count and each chunk is read by a separate subtask.
+ * Records without bases are skipped like FastaFormat does.
+ * The memory for the read sequences is reserved from the ".fai" lengths before the reading starts.
+ */
+class U2FORMATS_EXPORT ReadIndexedFastaTask : public Task {
+    Q_OBJECT
+public:
+    /* Reads all sequences if @sequenceNames is empty */
+    ReadIndexedFastaTask(const GUrl &fastaUrl, const QStringList &sequenceNames = QStringList());
+
+    /* Reads only records which headers contain @headerPattern, at most @maxCount records (0 means no limit) */
+    void setHeaderFilter(const QString &headerPattern, int maxCount);
+
+    void prepare();
+    QList<Task *> onSubTaskFinished(Task *subTask);
+    void run();
+
+    const FastaIndex & getIndex() const;
+    /* Sequences are in the order of the file or @sequenceNames */
+    QList<DNASequence> takeResult();
+
+private:
+    QList<Task *> createReadTasks();
+
+    const GUrl fastaUrl;
+    const QStringList sequenceNames;
+    QString headerPattern;
+    int maxCount;
+    GetFastaIndexTask *indexTask;
+    QList<ReadFastaRecordsTask *> readTasks;
+    FastaIndex index;
+    QList<DNASequence> result;
+    MemoryLocker memoryLocker;
+
+    static const qint64 MIN_CHUNK_BASES;
+};
+
+class U2FORMATS_EXPORT GetFastaIndexTask : public Task {
+    Q_OBJECT
+public:
+    GetFastaIndexTask(const GUrl &fastaUrl);
+
+    /* Headers are read only if the filter is set, see ReadIndexedFastaTask::setHeaderFilter() */
+    void setHeaderFilter(const QString &headerPattern, int maxCount);
+
+    void run();
+    const FastaIndex & getResult() const;
+    /* Not empty records matching the filter in the order of the file */
+    const QList<FastaIndexEntry> & getSelectedEntries() const;
+
+private:
+    const GUrl fastaUrl;
+    QString headerPattern;
+    int maxCount;
+    FastaIndex index;
+    QList<FastaIndexEntry> selectedEntries;
+};
+
+class U2FORMATS_EXPORT ReadFastaRecordsTask : public Task {
+    Q_OBJECT
+public:
+    ReadFastaRecordsTask(const GUrl &fastaUrl, const FastaIndex &index, const QList<FastaIndexEntry> &entries);
+
+    void run();
+    QList<DNASequence> takeResult();
+
+private:
+    const GUrl fastaUrl;
+    const FastaIndex index;
+    const QList<FastaIndexEntry> entries;
+    QList<DNASequence> result;
+};
+
+} // U2
+
+#endif // _U2_READ_INDEXED_FASTA_TASK_H_
@@ -21,29 +21,27 @@
 
 #include "AssemblyPackAlgorithm.h"
 
+#include <algorithm>
+#include <functional>
+
 #include <U2Core/Timer.h>
-#include <U2Core/GAutoDeleteList.h>
 #include <U2Core/Log.h>
 #include <U2Core/U2Assembly.h>
+#include <U2Core/U2SafePoints.h>
 
 namespace U2 {
 
-static qint64 selectProw(qint64* tails, qint64 start, qint64 end ){
-    for (int i = 0; i < PACK_TAIL_SIZE; i++) {
-        if (tails[i] <= start) {
-            tails[i] = end;
-            return i;
-        }
+void PackAlgorithmAdapter::assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os) {
+    foreach (const PackAlgorithmRow& row, rows) {
+        assignProw(row.readId, row.prow, os);
+        CHECK_OP(os, );
     }
-    return -1;
 }
 
 PackAlgorithmContext::PackAlgorithmContext() {
     maxProw  = 0;
     nReads =  0;
-    peakEnd = -1;
-    peakRow = PACK_TAIL_SIZE;
-    tails.resize(PACK_TAIL_SIZE);
+    nRows = 0;
 }
 
 #define PACK_TRACE_CHECKPOINT 100000
@@ -51,46 +49,66 @@ PackAlgorithmContext::PackAlgorithmContext() {
 void AssemblyPackAlgorithm::pack(PackAlgorithmAdapter& adapter, U2AssemblyPackStat& stat, U2OpStatus& os) {
     //Algorithm idea:
     //  select * reads ordered by start position
-    //  keep tack (tail) of used rows to assign packed row for reads (N elements)
-    //  if all elements are used -> assign -1 to read and postprocess it later
+    //  assign the lowest row that is free at the read start position
+    //  rows are passed to the adapter by blocks as soon as they are computed
 
     GTIMER(c1, t1, "AssemblyPackAlgorithm::pack");
     quint64 t0 = GTimer::currentTimeMicros();
     int nPacked = 0;
 
     stat.maxProw = 0;
-    gauto_array<qint64> tails(new qint64[PACK_TAIL_SIZE]);
-    qFill(tails.get(), tails.get() + PACK_TAIL_SIZE, -1);
 
     QScopedPointer< U2DbiIterator<PackAlgorithmData> > allReadsIterator(adapter.selectAllReads(os));
     PackAlgorithmContext ctx;
+    QVector<PackAlgorithmRow> rowsBlock;
+    rowsBlock.reserve(PACK_ROWS_BLOCK_SIZE);
     while (allReadsIterator->hasNext() && !os.isCoR()) {
         PackAlgorithmData read = allReadsIterator->next();
         int prow = packRead(U2Region(read.leftmostPos, read.effectiveLen), ctx, os);
-        adapter.assignProw(read.readId, prow, os);
+        rowsBlock << PackAlgorithmRow(read.readId, prow);
+        if (rowsBlock.size() == PACK_ROWS_BLOCK_SIZE) {
+            adapter.assignProws(rowsBlock, os);
+            rowsBlock.clear();
+        }
         stat.maxProw = ctx.maxProw;
 
         if ((++nPacked % PACK_TRACE_CHECKPOINT) == 0) {
             perfLog.trace(QString("Assembly: number packed reads so far: %1 of %2 (%3%)").arg(nPacked).arg(stat.readsCount).arg(100*nPacked/stat.readsCount));
         }
     }
-    assert(stat.readsCount == nPacked);
+    if (!rowsBlock.isEmpty() && !os.isCoR()) {
+        adapter.assignProws(rowsBlock, os);
+    }
+    assert(os.isCoR() || stat.readsCount == nPacked);
 
     t1.stop();
     perfLog.trace(QString("Assembly: algorithm pack time: %1 seconds").arg((GTimer::currentTimeMicros() - t0) / float(1000*1000)));
 }
 
 int AssemblyPackAlgorithm::packRead(const U2Region& reg, PackAlgorithmContext& ctx, U2OpStatus& ) {
-    int prow = selectProw(ctx.tails.data(), reg.startPos, reg.endPos());
-    if (prow == -1) {
-        if (reg.startPos > ctx.peakEnd) {
-            ctx.peakRow = PACK_TAIL_SIZE;
-        }
-        prow = ctx.peakRow;
-        ctx.peakRow++;
-        ctx.peakEnd = reg.endPos();
+    typedef QPair<qint64, int> ActiveRow;
+
+    // reads are sorted by start position: a row that is free for this read is free for all next reads
+    while (!ctx.activeRows.isEmpty() && ctx.activeRows.first().first <= reg.startPos) {
+        ctx.freeRows.append(ctx.activeRows.first().second);
+        std::push_heap(ctx.freeRows.begin(), ctx.freeRows.end(), std::greater<int>());
+        std::pop_heap(ctx.activeRows.begin(), ctx.activeRows.end(), std::greater<ActiveRow>());
+        ctx.activeRows.removeLast();
+    }
+
+    int prow = 0;
+    if (ctx.freeRows.isEmpty()) {
+        prow = ctx.nRows++;
+    } else {
+        prow = ctx.freeRows.first();
+        std::pop_heap(ctx.freeRows.begin(), ctx.freeRows.end(), std::greater<int>());
+        ctx.freeRows.removeLast();
     }
+    ctx.activeRows.append(ActiveRow(reg.endPos(), prow));
+    std::push_heap(ctx.activeRows.begin(), ctx.activeRows.end(), std::greater<ActiveRow>());
+
     ctx.maxProw = qMax(prow, ctx.maxProw);
+    ctx.nReads++;
     return prow;
 }
 
@@ -38,29 +38,47 @@ public:
     qint64   effectiveLen;
 };
 
-class PackAlgorithmAdapter {
+/** Packed row computed for a read */
+class PackAlgorithmRow {
+public:
+    PackAlgorithmRow() : prow(-1) {}
+    PackAlgorithmRow(const U2DataId& _readId, qint64 _prow) : readId(_readId), prow(_prow) {}
+
+    U2DataId readId;
+    qint64   prow;
+};
+
+class U2FORMATS_EXPORT PackAlgorithmAdapter {
 public:
     virtual U2DbiIterator<PackAlgorithmData>* selectAllReads(U2OpStatus& os) = 0;
     virtual void assignProw(const U2DataId& readId, qint64 prow, U2OpStatus& os) = 0;
+    /** Assigns rows for a block of reads in the order of selectAllReads. Calls assignProw for every read by default */
+    virtual void assignProws(const QVector<PackAlgorithmRow>& rows, U2OpStatus& os);
     virtual ~PackAlgorithmAdapter(){}
 };
 
-#define PACK_TAIL_SIZE 50000
+#define PACK_ROWS_BLOCK_SIZE 10000
 
+/**
+    The state of the greedy packing of the reads sorted by start position.
+    Only the rows occupied by the reads that can overlap the next read are kept,
+    so the memory depends on the coverage depth and not on the number of reads.
+*/
 class PackAlgorithmContext {
 public:
     PackAlgorithmContext();
 
     int     maxProw;
     qint64  nReads;
+    int     nRows;
 
-    // used to assign prow for reads when TAIL_SIZE is not enough
-    qint64          peakEnd;
-    qint64          peakRow;
-    QVector<qint64> tails;
+    // min-heap of (end position, row) of the last reads in the occupied rows
+    QVector< QPair<qint64, int> > activeRows;
+    // min-heap of the rows that are free for the next read
+    QVector<int> freeRows;
 };
 
-class AssemblyPackAlgorithm {
+class U2FORMATS_EXPORT AssemblyPackAlgorithm {
 public:
     static void pack(PackAlgorithmAdapter& adapter, U2AssemblyPackStat& stat, U2OpStatus& os);
     static int packRead(const U2Region& reg, PackAlgorithmContext& ctx, U2OpStatus& os);
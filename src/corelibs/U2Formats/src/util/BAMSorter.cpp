@@ -0,0 +1,1120 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <QtEndian>
+
+extern "C" {
+#include <bam.h>
+#include <bgzf.h>
+}
+
+#include <3rdparty/zlib/zlib.h>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/AppSettings.h>
+#include <U2Core/GUrlUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+#include <U2Core/UserApplicationsSettings.h>
+
+#include "BAMSorter.h"
+#include "../BAMUtils.h"
+
+namespace U2 {
+
+namespace {
+
+const int BGZF_BLOCK_DATA_SIZE = 0xff00;
+const int BGZF_MAX_BLOCK_SIZE = 0x10000;
+const int BGZF_BLOCK_HEADER_SIZE = 18;
+const int BGZF_BLOCK_FOOTER_SIZE = 8;
+const char BGZF_EOF_BLOCK[] = "\037\213\010\4\0\0\0\0\0\377\6\0\102\103\2\0\033\0\3\0\0\0\0\0\0\0\0\0";
+const int BGZF_EOF_BLOCK_SIZE = 28;
+
+const int RECORD_CORE_SIZE = 32;
+const quint32 BAI_META_BIN = 37450;
+const int BAI_LINEAR_SHIFT = 14;
+const quint32 NO_BIN = 0xffffffffu;
+
+const int PENDING_BLOCKS_PER_THREAD = 4;
+const int CANCEL_CHECK_RECORDS = 10000;
+
+inline quint32 readUInt32(const char *data) {
+    return qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data));
+}
+
+inline void appendUInt32(QByteArray &data, quint32 value) {
+    uchar buffer[4];
+    qToLittleEndian<quint32>(value, buffer);
+    data.append(reinterpret_cast<const char *>(buffer), 4);
+}
+
+inline void appendUInt64(QByteArray &data, quint64 value) {
+    uchar buffer[8];
+    qToLittleEndian<quint64>(value, buffer);
+    data.append(reinterpret_cast<const char *>(buffer), 8);
+}
+
+/************************************************************************/
+/* BamRecord */
+/************************************************************************/
+/**
+ * Records are kept in the on-disk form: the block size followed by the record data.
+ * So they are written as is and do not depend on the platform byte order.
+ */
+class BamRecord {
+public:
+    static int getSize(const char *record) { return 4 + int(readUInt32(record)); }
+    static qint32 getTid(const char *record) { return qint32(readUInt32(record + 4)); }
+    static qint32 getPos(const char *record) { return qint32(readUInt32(record + 8)); }
+    static quint32 getBin(const char *record) { return readUInt32(record + 12) >> 16; }
+    static int getNameLength(const char *record) { return readUInt32(record + 12) & 0xff; }
+    static quint32 getFlag(const char *record) { return readUInt32(record + 16) >> 16; }
+    static int getCigarLength(const char *record) { return readUInt32(record + 16) & 0xffff; }
+
+    /* The same order as samtools sort uses: reads without coordinates are the last, forward reads prior to reverse ones */
+    static quint64 getSortKey(const char *record) {
+        const quint32 strand = (0 != (getFlag(record) & BAM_FREVERSE)) ? 1 : 0;
+        return (quint64(quint32(getTid(record))) << 32) | (quint32(getPos(record) + 1) << 1) | strand;
+    }
+
+    /* The same as bam_calend() */
+    static qint64 getEnd(const char *record) {
+        qint64 end = getPos(record);
+        const char *cigar = record + 4 + RECORD_CORE_SIZE + getNameLength(record);
+        const int cigarLength = getCigarLength(record);
+        for (int i = 0; i < cigarLength; i++) {
+            const quint32 operation = readUInt32(cigar + 4 * i);
+            const int type = operation & BAM_CIGAR_MASK;
+            if (BAM_CMATCH == type || BAM_CDEL == type || BAM_CREF_SKIP == type) {
+                end += operation >> BAM_CIGAR_SHIFT;
+            }
+        }
+        return end;
+    }
+};
+
+/************************************************************************/
+/* BamHeader */
+/************************************************************************/
+class BamHeader {
+public:
+    BamHeader() {}
+
+    BamHeader(const bam_header_t *header)
+        : text(header->text, int(header->l_text))
+    {
+        for (int i = 0; i < header->n_targets; i++) {
+            names << QByteArray(header->target_name[i]);
+            lengths << header->target_len[i];
+        }
+    }
+
+    /* The same as change_SO() from samtools */
+    void setSortOrder(const QByteArray &order) {
+        if (!text.startsWith("@HD")) {
+            text.prepend("@HD\tVN:1.3\tSO:" + order + "\n");
+            return;
+        }
+        const int lineEnd = text.indexOf('\n');
+        CHECK(-1 != lineEnd, );
+        const int orderStart = text.indexOf("\tSO:");
+        if (-1 == orderStart || orderStart > lineEnd) {
+            text.insert(lineEnd, "\tSO:" + order);
+            return;
+        }
+        int orderEnd = orderStart + 4;
+        while (orderEnd < lineEnd && '\t' != text[orderEnd]) {
+            orderEnd++;
+        }
+        text.replace(orderStart + 4, orderEnd - orderStart - 4, order);
+    }
+
+    QByteArray serialize() const {
+        QByteArray result("BAM\1");
+        appendUInt32(result, text.size());
+        result.append(text);
+        appendUInt32(result, names.size());
+        for (int i = 0; i < names.size(); i++) {
+            appendUInt32(result, names[i].size() + 1);
+            result.append(names[i]).append('\0');
+            appendUInt32(result, lengths[i]);
+        }
+        return result;
+    }
+
+    QByteArray text;
+    QList<QByteArray> names;
+    QList<quint32> lengths;
+};
+
+/************************************************************************/
+/* BamRecordReader */
+/************************************************************************/
+/* Reads BAM files and temporary runs, runs have no header */
+class BamRecordReader {
+public:
+    BamRecordReader(const QString &url, bool readHeader, U2OpStatus &os)
+        : url(url), fp(NULL)
+    {
+        fp = bgzf_open(url.toLocal8Bit().constData(), "r");
+        CHECK_EXT(NULL != fp, os.setError(L10N::errorOpeningFileRead(url)), );
+        if (readHeader) {
+            bam_header_t *bamHeader = bam_header_read(fp);
+            CHECK_EXT(NULL != bamHeader, os.setError(BAMUtils::tr("Can't read header from file '%1'").arg(url)), );
+            header = BamHeader(bamHeader);
+            bam_header_destroy(bamHeader);
+        }
+    }
+
+    ~BamRecordReader() {
+        if (NULL != fp) {
+            bgzf_close(fp);
+        }
+    }
+
+    const BamHeader & getHeader() const {
+        return header;
+    }
+
+    /* Appends the next record to @data. Returns false at the end of the file */
+    bool readRecord(QByteArray &data, U2OpStatus &os) {
+        char sizeData[4];
+        const int read = bgzf_read(fp, sizeData, 4);
+        CHECK(0 != read, false);
+        CHECK_EXT(4 == read, os.setError(BAMUtils::tr("The file is truncated: %1").arg(url)), false);
+
+        const int size = int(readUInt32(sizeData));
+        CHECK_EXT(size >= RECORD_CORE_SIZE, os.setError(BAMUtils::tr("Invalid BAM record in file: %1").arg(url)), false);
+        const int start = data.size();
+        data.resize(start + 4 + size);
+        memcpy(data.data() + start, sizeData, 4);
+        CHECK_EXT(size == bgzf_read(fp, data.data() + start + 4, size),
+                  os.setError(BAMUtils::tr("The file is truncated: %1").arg(url)), false);
+        return true;
+    }
+
+private:
+    QString url;
+    BGZF *fp;
+    BamHeader header;
+};
+
+/************************************************************************/
+/* RecordSink */
+/************************************************************************/
+class RecordSink {
+public:
+    virtual ~RecordSink() {}
+    virtual void write(const char *record, int size, U2OpStatus &os) = 0;
+};
+
+/* Temporary runs are compressed with the fastest level */
+class RunSink : public RecordSink {
+public:
+    RunSink(const QString &url, U2OpStatus &os)
+        : url(url), fp(NULL)
+    {
+        fp = bgzf_open(url.toLocal8Bit().constData(), "w1");
+        CHECK_EXT(NULL != fp, os.setError(L10N::errorOpeningFileWrite(url)), );
+    }
+
+    ~RunSink() {
+        if (NULL != fp) {
+            bgzf_close(fp);
+        }
+    }
+
+    void write(const char *record, int size, U2OpStatus &os) {
+        CHECK_EXT(size == bgzf_write(fp, record, size), os.setError(L10N::errorWritingFile(url)), );
+    }
+
+    void close(U2OpStatus &os) {
+        const int result = bgzf_close(fp);
+        fp = NULL;
+        CHECK_EXT(0 == result, os.setError(L10N::errorWritingFile(url)), );
+    }
+
+private:
+    QString url;
+    BGZF *fp;
+};
+
+/************************************************************************/
+/* BgzfWriter */
+/************************************************************************/
+QByteArray compressBgzfBlock(const QByteArray &data, U2OpStatus &os) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    int ret = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    CHECK_EXT(Z_OK == ret, os.setError(BAMUtils::tr("Can't initialize the BGZF compression")), QByteArray());
+
+    QByteArray block(BGZF_MAX_BLOCK_SIZE, Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.constData()));
+    stream.avail_in = uInt(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(block.data() + BGZF_BLOCK_HEADER_SIZE);
+    stream.avail_out = uInt(BGZF_MAX_BLOCK_SIZE - BGZF_BLOCK_HEADER_SIZE - BGZF_BLOCK_FOOTER_SIZE);
+    ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    CHECK_EXT(Z_STREAM_END == ret, os.setError(BAMUtils::tr("BGZF compression error")), QByteArray());
+
+    const int blockSize = BGZF_BLOCK_HEADER_SIZE + int(stream.total_out) + BGZF_BLOCK_FOOTER_SIZE;
+    static const uchar HEADER[] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0};
+    uchar *blockData = reinterpret_cast<uchar *>(block.data());
+    memcpy(blockData, HEADER, sizeof(HEADER));
+    qToLittleEndian<quint16>(quint16(blockSize - 1), blockData + 16);
+    const uLong crc = crc32(crc32(0L, NULL, 0), reinterpret_cast<const Bytef *>(data.constData()), uInt(data.size()));
+    qToLittleEndian<quint32>(quint32(crc), blockData + blockSize - 8);
+    qToLittleEndian<quint32>(quint32(data.size()), blockData + blockSize - 4);
+    block.resize(blockSize);
+    return block;
+}
+
+class BgzfWriter;
+
+class BgzfCompressorThread : public QThread {
+public:
+    BgzfCompressorThread(BgzfWriter *writer)
+        : writer(writer)
+    {
+
+    }
+
+protected:
+    void run();
+
+private:
+    BgzfWriter *writer;
+};
+
+/**
+ * Writes a BGZF file, blocks are compressed by several threads and written in order.
+ * Without threads the blocks are compressed by the writing thread.
+ * The positions in the stream are block indexes with in-block offsets packed like virtual offsets,
+ * they are converted to the real virtual offsets when the file is closed.
+ */
+class BgzfWriter {
+public:
+    BgzfWriter(const QString &url, int threadsCount, U2OpStatus &os)
+        : url(url), file(url), submittedBlocks(0), writtenBlocks(0), fileOffset(0), maxPendingBlocks(PENDING_BLOCKS_PER_THREAD * threadsCount), stopped(false)
+    {
+        CHECK_EXT(file.open(QIODevice::WriteOnly), os.setError(L10N::errorOpeningFileWrite(url)), );
+        currentBlock.reserve(BGZF_BLOCK_DATA_SIZE);
+        for (int i = 0; i < threadsCount; i++) {
+            threads << new BgzfCompressorThread(this);
+            threads.last()->start();
+        }
+    }
+
+    ~BgzfWriter() {
+        stopThreads();
+    }
+
+    void write(const char *data, int length, U2OpStatus &os) {
+        while (length > 0) {
+            const int size = qMin(length, BGZF_BLOCK_DATA_SIZE - currentBlock.size());
+            currentBlock.append(data, size);
+            data += size;
+            length -= size;
+            if (BGZF_BLOCK_DATA_SIZE == currentBlock.size()) {
+                submitBlock(os);
+                CHECK_OP(os, );
+            }
+        }
+    }
+
+    /* The position of the next written byte */
+    quint64 tell() const {
+        return (quint64(submittedBlocks) << 16) | quint64(currentBlock.size());
+    }
+
+    void close(U2OpStatus &os) {
+        if (!currentBlock.isEmpty()) {
+            submitBlock(os);
+        }
+        writeCompressedBlocks(true, os);
+        stopThreads();
+        CHECK_OP(os, );
+
+        blockOffsets << fileOffset;
+        CHECK_EXT(BGZF_EOF_BLOCK_SIZE == file.write(BGZF_EOF_BLOCK, BGZF_EOF_BLOCK_SIZE), os.setError(L10N::errorWritingFile(url)), );
+        file.close();
+    }
+
+    /* Converts a position returned by tell() to the BGZF virtual offset. Valid after close() */
+    quint64 toVirtualOffset(quint64 position) const {
+        return (quint64(blockOffsets[int(position >> 16)]) << 16) | (position & 0xffff);
+    }
+
+    /* Compressors loop */
+    void compressBlocks() {
+        U2OpStatusImpl os;
+        forever {
+            QPair<qint64, QByteArray> block;
+            {
+                QMutexLocker locker(&mutex);
+                while (pendingBlocks.isEmpty() && !stopped) {
+                    blockSubmitted.wait(&mutex);
+                }
+                CHECK_BREAK(!pendingBlocks.isEmpty());
+                block = pendingBlocks.dequeue();
+            }
+
+            const QByteArray compressed = compressBgzfBlock(block.second, os);
+
+            QMutexLocker locker(&mutex);
+            if (os.hasError()) {
+                error = os.getError();
+                blockCompressed.wakeAll();
+                break;
+            }
+            compressedBlocks.insert(block.first, compressed);
+            blockCompressed.wakeAll();
+        }
+    }
+
+private:
+    void submitBlock(U2OpStatus &os) {
+        if (threads.isEmpty()) {
+            const QByteArray compressed = compressBgzfBlock(currentBlock, os);
+            CHECK_OP(os, );
+            QMutexLocker locker(&mutex);
+            compressedBlocks.insert(submittedBlocks, compressed);
+        } else {
+            QMutexLocker locker(&mutex);
+            pendingBlocks.enqueue(qMakePair(submittedBlocks, currentBlock));
+            blockSubmitted.wakeOne();
+        }
+        submittedBlocks++;
+        currentBlock = QByteArray();
+        currentBlock.reserve(BGZF_BLOCK_DATA_SIZE);
+        writeCompressedBlocks(false, os);
+    }
+
+    /* Writes the compressed blocks in order. Waits for all blocks if @waitAll, or while too many blocks are pending */
+    void writeCompressedBlocks(bool waitAll, U2OpStatus &os) {
+        QMutexLocker locker(&mutex);
+        forever {
+            while (compressedBlocks.contains(writtenBlocks)) {
+                const QByteArray block = compressedBlocks.take(writtenBlocks);
+                locker.unlock();
+                const qint64 written = file.write(block);
+                locker.relock();
+                CHECK_EXT(written == block.size(), os.setError(L10N::errorWritingFile(url)), );
+                blockOffsets << fileOffset;
+                fileOffset += block.size();
+                writtenBlocks++;
+            }
+            CHECK_EXT(error.isEmpty(), os.setError(error), );
+            const qint64 pending = submittedBlocks - writtenBlocks;
+            CHECK_BREAK(pending > 0 && (waitAll || pending >= maxPendingBlocks));
+            blockCompressed.wait(&mutex);
+        }
+    }
+
+    void stopThreads() {
+        {
+            QMutexLocker locker(&mutex);
+            stopped = true;
+            blockSubmitted.wakeAll();
+        }
+        foreach (BgzfCompressorThread *thread, threads) {
+            thread->wait();
+        }
+        qDeleteAll(threads);
+        threads.clear();
+    }
+
+    QString url;
+    QFile file;
+    QByteArray currentBlock;
+    qint64 submittedBlocks;
+    qint64 writtenBlocks;
+    qint64 fileOffset;
+    QVector<qint64> blockOffsets;
+    const qint64 maxPendingBlocks;
+    QList<BgzfCompressorThread *> threads;
+
+    QMutex mutex;
+    QWaitCondition blockSubmitted;
+    QWaitCondition blockCompressed;
+    QQueue<QPair<qint64, QByteArray> > pendingBlocks;
+    QMap<qint64, QByteArray> compressedBlocks;
+    bool stopped;
+    QString error;
+};
+
+void BgzfCompressorThread::run() {
+    writer->compressBlocks();
+}
+
+/************************************************************************/
+/* BamIndexBuilder */
+/************************************************************************/
+/**
+ * Builds the BAM index the same way as bam_index_core() from samtools does,
+ * but from the records that are being written.
+ */
+class BamIndexBuilder {
+public:
+    BamIndexBuilder(int referencesCount)
+        : bins(referencesCount), linearIndexes(referencesCount), metas(referencesCount),
+          lastTid(-1), lastBin(NO_BIN), lastCoordinate(-1), saveTid(-1), saveBin(NO_BIN), saveOffset(0),
+          beginOffset(0), endOffset(0), mappedCount(0), unmappedCount(0), noCoordinatesCount(0), noCoordinatesPart(false)
+    {
+
+    }
+
+    void start(quint64 offset) {
+        saveOffset = offset;
+        beginOffset = offset;
+        endOffset = offset;
+    }
+
+    /* @begin and @end are the stream positions of the record */
+    void addRecord(const char *record, quint64 begin, quint64 end, U2OpStatus &os) {
+        const qint32 tid = BamRecord::getTid(record);
+        if (noCoordinatesPart) {
+            noCoordinatesCount++;
+            CHECK_EXT(tid < 0, os.setError(BAMUtils::tr("The alignment is not sorted: reads without coordinates prior to reads with coordinates")), );
+            return;
+        }
+        endOffset = end;
+
+        const qint32 pos = BamRecord::getPos(record);
+        const quint32 bin = BamRecord::getBin(record);
+        const bool unmapped = (0 != (BamRecord::getFlag(record) & BAM_FUNMAP));
+        if (tid < 0) {
+            noCoordinatesCount++;
+        }
+        if (lastTid < tid || (lastTid >= 0 && tid < 0)) {
+            lastTid = tid;
+            lastBin = NO_BIN;
+        } else {
+            CHECK_EXT(quint32(lastTid) <= quint32(tid) && (tid < 0 || lastCoordinate <= pos),
+                      os.setError(BAMUtils::tr("The alignment is not sorted")), );
+        }
+
+        if (tid >= 0 && !unmapped) {
+            addLinearOffset(tid, pos, BamRecord::getEnd(record), begin);
+        }
+        if (bin != lastBin) {
+            if (NO_BIN != saveBin) {
+                bins[saveTid][saveBin] << qMakePair(saveOffset, begin);
+            }
+            if (NO_BIN == lastBin && saveTid >= 0) {
+                addMeta(begin);
+                beginOffset = begin;
+            }
+            saveOffset = begin;
+            saveBin = lastBin = bin;
+            saveTid = tid;
+            if (saveTid < 0) {
+                noCoordinatesPart = true;
+                return;
+            }
+        }
+        if (unmapped) {
+            unmappedCount++;
+        } else {
+            mappedCount++;
+        }
+        lastCoordinate = pos;
+    }
+
+    void finish() {
+        if (saveTid >= 0) {
+            bins[saveTid][saveBin] << qMakePair(saveOffset, endOffset);
+            addMeta(endOffset);
+        }
+        mergeChunks();
+    }
+
+    void save(const QString &url, const BgzfWriter &writer, U2OpStatus &os) const {
+        QByteArray data("BAI\1");
+        appendUInt32(data, bins.size());
+        for (int i = 0; i < bins.size(); i++) {
+            appendUInt32(data, bins[i].size() + (metas[i].present ? 1 : 0));
+            QMap<quint32, QVector<QPair<quint64, quint64> > >::const_iterator it = bins[i].constBegin();
+            for (; it != bins[i].constEnd(); ++it) {
+                const QVector<QPair<quint64, quint64> > &chunks = it.value();
+                appendUInt32(data, it.key());
+                appendUInt32(data, chunks.size());
+                for (int j = 0; j < chunks.size(); j++) {
+                    appendUInt64(data, writer.toVirtualOffset(chunks[j].first));
+                    appendUInt64(data, writer.toVirtualOffset(chunks[j].second));
+                }
+            }
+            if (metas[i].present) {
+                appendUInt32(data, BAI_META_BIN);
+                appendUInt32(data, 2);
+                appendUInt64(data, writer.toVirtualOffset(metas[i].begin));
+                appendUInt64(data, writer.toVirtualOffset(metas[i].end));
+                appendUInt64(data, metas[i].mappedCount);
+                appendUInt64(data, metas[i].unmappedCount);
+            }
+
+            const QVector<quint64> &linearIndex = linearIndexes[i];
+            appendUInt32(data, linearIndex.size());
+            quint64 offset = 0;
+            for (int j = 0; j < linearIndex.size(); j++) {
+                // the missing offsets are filled with the previous ones
+                if (0 != linearIndex[j]) {
+                    offset = writer.toVirtualOffset(linearIndex[j]);
+                }
+                appendUInt64(data, offset);
+            }
+        }
+        appendUInt64(data, noCoordinatesCount);
+
+        QFile file(url);
+        CHECK_EXT(file.open(QIODevice::WriteOnly), os.setError(L10N::errorOpeningFileWrite(url)), );
+        CHECK_EXT(data.size() == file.write(data), os.setError(L10N::errorWritingFile(url)), );
+    }
+
+private:
+    class Meta {
+    public:
+        Meta() : present(false), begin(0), end(0), mappedCount(0), unmappedCount(0) {}
+
+        bool present;
+        quint64 begin;
+        quint64 end;
+        quint64 mappedCount;
+        quint64 unmappedCount;
+    };
+
+    void addMeta(quint64 end) {
+        Meta &meta = metas[saveTid];
+        meta.present = true;
+        meta.begin = beginOffset;
+        meta.end = end;
+        meta.mappedCount = mappedCount;
+        meta.unmappedCount = unmappedCount;
+        mappedCount = 0;
+        unmappedCount = 0;
+    }
+
+    void addLinearOffset(qint32 tid, qint32 pos, qint64 end, quint64 offset) {
+        const int beginWindow = pos >> BAI_LINEAR_SHIFT;
+        const int endWindow = qMax(beginWindow, int((end - 1) >> BAI_LINEAR_SHIFT));
+        QVector<quint64> &linearIndex = linearIndexes[tid];
+        if (linearIndex.size() < endWindow + 1) {
+            linearIndex.resize(endWindow + 1);
+        }
+        for (int i = beginWindow; i <= endWindow; i++) {
+            if (0 == linearIndex[i]) {
+                linearIndex[i] = offset;
+            }
+        }
+    }
+
+    /* Chunks of a bin that are in the same BGZF block are joined */
+    void mergeChunks() {
+        for (int i = 0; i < bins.size(); i++) {
+            QMap<quint32, QVector<QPair<quint64, quint64> > >::iterator it = bins[i].begin();
+            for (; it != bins[i].end(); ++it) {
+                QVector<QPair<quint64, quint64> > &chunks = it.value();
+                int merged = 0;
+                for (int j = 1; j < chunks.size(); j++) {
+                    if (chunks[merged].second >> 16 == chunks[j].first >> 16) {
+                        chunks[merged].second = chunks[j].second;
+                    } else {
+                        chunks[++merged] = chunks[j];
+                    }
+                }
+                chunks.resize(merged + 1);
+            }
+        }
+    }
+
+    QVector<QMap<quint32, QVector<QPair<quint64, quint64> > > > bins;
+    QVector<QVector<quint64> > linearIndexes;
+    QVector<Meta> metas;
+
+    qint32 lastTid;
+    quint32 lastBin;
+    qint32 lastCoordinate;
+    qint32 saveTid;
+    quint32 saveBin;
+    quint64 saveOffset;
+    quint64 beginOffset;
+    quint64 endOffset;
+    quint64 mappedCount;
+    quint64 unmappedCount;
+    quint64 noCoordinatesCount;
+    bool noCoordinatesPart;
+};
+
+/************************************************************************/
+/* OutputSink */
+/************************************************************************/
+class OutputSink : public RecordSink {
+public:
+    OutputSink(const QString &url, const BamHeader &header, bool buildIndex, int threadsCount, U2OpStatus &os)
+        : url(url), writer(url, threadsCount, os)
+    {
+        CHECK_OP(os, );
+        const QByteArray headerData = header.serialize();
+        writer.write(headerData.constData(), headerData.size(), os);
+        if (buildIndex) {
+            indexBuilder.reset(new BamIndexBuilder(header.names.size()));
+            indexBuilder->start(writer.tell());
+        }
+    }
+
+    void write(const char *record, int size, U2OpStatus &os) {
+        const quint64 begin = writer.tell();
+        writer.write(record, size, os);
+        CHECK_OP(os, );
+        if (!indexBuilder.isNull()) {
+            indexBuilder->addRecord(record, begin, writer.tell(), os);
+        }
+    }
+
+    void close(U2OpStatus &os) {
+        writer.close(os);
+        CHECK_OP(os, );
+        CHECK(!indexBuilder.isNull(), );
+        indexBuilder->finish();
+        indexBuilder->save(url + ".bai", writer, os);
+    }
+
+private:
+    QString url;
+    BgzfWriter writer;
+    QScopedPointer<BamIndexBuilder> indexBuilder;
+};
+
+/************************************************************************/
+/* Merging */
+/************************************************************************/
+class MergeSource {
+public:
+    MergeSource() : key(0), index(0) {}
+    MergeSource(quint64 key, int index) : key(key), index(index) {}
+
+    /* For the min-heap: equal records are taken in the sources order */
+    bool operator >(const MergeSource &other) const {
+        return key > other.key || (key == other.key && index > other.index);
+    }
+
+    quint64 key;
+    int index;
+};
+
+void mergeRecords(const QList<BamRecordReader *> &readers, RecordSink &sink, U2OpStatus &os) {
+    QVector<QByteArray> records(readers.size());
+    std::vector<MergeSource> heap;
+    for (int i = 0; i < readers.size(); i++) {
+        records[i].reserve(BGZF_BLOCK_DATA_SIZE);
+        if (readers[i]->readRecord(records[i], os)) {
+            heap.push_back(MergeSource(BamRecord::getSortKey(records[i].constData()), i));
+        }
+        CHECK_OP(os, );
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+
+    qint64 recordsCount = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+        const int index = heap.back().index;
+        heap.pop_back();
+
+        QByteArray &record = records[index];
+        sink.write(record.constData(), record.size(), os);
+        CHECK_OP(os, );
+        record.resize(0);
+        if (readers[index]->readRecord(record, os)) {
+            heap.push_back(MergeSource(BamRecord::getSortKey(record.constData()), index));
+            std::push_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+        }
+        CHECK_OP(os, );
+        if (0 == ++recordsCount % CANCEL_CHECK_RECORDS) {
+            CHECK(!os.isCoR(), );
+        }
+    }
+}
+
+/* Merges @runs into @outputUrl, runs are not removed */
+void mergeRunsToFile(const QStringList &runs, const QString &outputUrl, U2OpStatus &os) {
+    QList<BamRecordReader *> readers;
+    foreach (const QString &run, runs) {
+        readers << new BamRecordReader(run, false, os);
+        CHECK_OP_BREAK(os);
+    }
+    if (!os.isCoR()) {
+        RunSink sink(outputUrl, os);
+        if (!os.isCoR()) {
+            mergeRecords(readers, sink, os);
+            sink.close(os);
+        }
+    }
+    qDeleteAll(readers);
+}
+
+void mergeToOutput(const QList<BamRecordReader *> &readers, const BamHeader &header, const QString &outputUrl,
+                   bool buildIndex, int threadsCount, U2OpStatus &os) {
+    OutputSink sink(outputUrl, header, buildIndex, threadsCount, os);
+    CHECK_OP(os, );
+    mergeRecords(readers, sink, os);
+    CHECK_OP(os, );
+    sink.close(os);
+}
+
+class RunMergerThread : public QThread {
+public:
+    RunMergerThread(const QStringList &runs, const QString &outputUrl)
+        : runs(runs), outputUrl(outputUrl)
+    {
+
+    }
+
+    U2OpStatusImpl os;
+
+protected:
+    void run() {
+        mergeRunsToFile(runs, outputUrl, os);
+    }
+
+private:
+    QStringList runs;
+    QString outputUrl;
+};
+
+/************************************************************************/
+/* Sorting */
+/************************************************************************/
+class SortEntry {
+public:
+    SortEntry() : key(0), offset(0) {}
+    SortEntry(quint64 key, qint64 offset) : key(key), offset(offset) {}
+
+    /* Offsets keep equal records in the input order */
+    bool operator <(const SortEntry &other) const {
+        return key < other.key || (key == other.key && offset < other.offset);
+    }
+
+    quint64 key;
+    qint64 offset;
+};
+
+class SortChunk {
+public:
+    bool isEmpty() const {
+        return entries.isEmpty();
+    }
+
+    qint64 getMemoryUsage() const {
+        return data.size() + qint64(entries.size()) * sizeof(SortEntry);
+    }
+
+    /* Returns false at the end of the file */
+    bool read(BamRecordReader &reader, qint64 maxMemory, U2OpStatus &os) {
+        while (getMemoryUsage() < maxMemory) {
+            const int offset = data.size();
+            CHECK(reader.readRecord(data, os), false);
+            entries << SortEntry(BamRecord::getSortKey(data.constData() + offset), offset);
+            if (0 == entries.size() % CANCEL_CHECK_RECORDS) {
+                CHECK(!os.isCoR(), false);
+            }
+        }
+        return true;
+    }
+
+    void sort() {
+        std::sort(entries.begin(), entries.end());
+    }
+
+    void write(RecordSink &sink, U2OpStatus &os) const {
+        for (int i = 0; i < entries.size(); i++) {
+            const char *record = data.constData() + entries[i].offset;
+            sink.write(record, BamRecord::getSize(record), os);
+            CHECK_OP(os, );
+        }
+    }
+
+private:
+    QByteArray data;
+    QVector<SortEntry> entries;
+};
+
+void sortChunkToRun(SortChunk &chunk, const QString &runUrl, U2OpStatus &os) {
+    chunk.sort();
+    RunSink sink(runUrl, os);
+    CHECK_OP(os, );
+    chunk.write(sink, os);
+    CHECK_OP(os, );
+    sink.close(os);
+}
+
+class ChunkSorterThread : public QThread {
+public:
+    ChunkSorterThread(SortChunk *chunk, const QString &runUrl)
+        : chunk(chunk), runUrl(runUrl)
+    {
+
+    }
+
+    U2OpStatusImpl os;
+
+protected:
+    void run() {
+        sortChunkToRun(*chunk, runUrl, os);
+        chunk.reset();
+    }
+
+private:
+    QScopedPointer<SortChunk> chunk;
+    QString runUrl;
+};
+
+/* Waits for the oldest threads until at most @maxRunning threads are running */
+template <class T>
+void waitForThreads(QList<T *> &threads, int maxRunning, U2OpStatus &os) {
+    while (threads.size() > maxRunning) {
+        QScopedPointer<T> thread(threads.takeFirst());
+        thread->wait();
+        if (thread->os.hasError() && !os.hasError()) {
+            os.setError(thread->os.getError());
+        }
+    }
+}
+
+/**
+ * Acquires up to @maxCount threads of RESOURCE_THREAD that are free at the moment, so the helper
+ * threads of the sorter are taken into account by the task scheduler. The threads are released in the destructor.
+ */
+class ThreadsReservation {
+public:
+    ThreadsReservation(int maxCount)
+        : resource(AppResourcePool::instance()->getResource(RESOURCE_THREAD)), count(0)
+    {
+        SAFE_POINT(NULL != resource, L10N::nullPointerError("threads resource"), );
+        for (count = qMax(0, maxCount); count > 0 && !resource->tryAcquire(count); count--) {
+
+        }
+    }
+
+    ~ThreadsReservation() {
+        if (count > 0) {
+            resource->release(count);
+        }
+    }
+
+    int getCount() const {
+        return count;
+    }
+
+private:
+    AppResource *resource;
+    int count;
+};
+
+QString getTmpDir(U2OpStatus &os) {
+    UserAppsSettings *settings = AppContext::getAppSettings()->getUserAppsSettings();
+    SAFE_POINT_EXT(NULL != settings, os.setError(L10N::nullPointerError("UserAppsSettings")), QString());
+    return settings->getCurrentProcessTemporaryDirPath("bam_sort");
+}
+
+void removeFiles(const QStringList &urls) {
+    foreach (const QString &url, urls) {
+        QFile::remove(url);
+    }
+}
+
+}   // namespace
+
+/************************************************************************/
+/* BAMSorter */
+/************************************************************************/
+const qint64 BAMSorter::MIN_CHUNK_SIZE = 16 * 1024 * 1024;
+// QByteArray can't be larger
+const qint64 BAMSorter::MAX_CHUNK_SIZE = 1024 * 1024 * 1024;
+const int BAMSorter::MAX_OPEN_RUNS = 256;
+
+BAMSorter::BAMSorter(qint64 memoryBudget, bool buildIndex, int threadsCount)
+    : memoryBudget(memoryBudget), buildIndex(buildIndex), threadsCount(threadsCount)
+{
+    if (this->threadsCount <= 0) {
+        this->threadsCount = AppResourcePool::instance()->getIdealThreadCount();
+    }
+    this->threadsCount = qMax(1, this->threadsCount);
+}
+
+void BAMSorter::sort(const QString &bamUrl, const QString &sortedBamUrl, U2OpStatus &os) {
+    BamRecordReader reader(bamUrl, true, os);
+    CHECK_OP(os, );
+    BamHeader header = reader.getHeader();
+    header.setSortOrder("coordinate");
+
+    const QString tmpDir = getTmpDir(os);
+    CHECK_OP(os, );
+    const QString runPrefix = QFileInfo(sortedBamUrl).completeBaseName() + "_run";
+
+    // The calling thread is already counted by the task scheduler
+    ThreadsReservation helpers(threadsCount - 1);
+    const int helpersCount = helpers.getCount();
+
+    // One chunk is being read while the others are being sorted, all of them fit into the budget
+    const qint64 budget = (memoryBudget > 0) ? memoryBudget : MIN_CHUNK_SIZE;
+    const int chunksCount = int(qBound(qint64(1), budget / MIN_CHUNK_SIZE, qint64(helpersCount + 1)));
+    const qint64 chunkSize = qMin(budget / chunksCount, MAX_CHUNK_SIZE);
+    const int maxSorters = chunksCount - 1;
+    QStringList runs;
+    QList<ChunkSorterThread *> sorters;
+    forever {
+        QScopedPointer<SortChunk> chunk(new SortChunk());
+        const bool hasMoreRecords = chunk->read(reader, chunkSize, os);
+        CHECK_OP_BREAK(os);
+
+        if (!hasMoreRecords && runs.isEmpty()) {
+            // the whole file is in memory
+            chunk->sort();
+            OutputSink sink(sortedBamUrl, header, buildIndex, helpersCount, os);
+            CHECK_OP_BREAK(os);
+            chunk->write(sink, os);
+            CHECK_OP_BREAK(os);
+            sink.close(os);
+            break;
+        }
+
+        if (!chunk->isEmpty()) {
+            waitForThreads(sorters, qMax(0, maxSorters - 1), os);
+            CHECK_OP_BREAK(os);
+            runs << GUrlUtils::prepareTmpFileLocation(tmpDir, runPrefix + QString::number(runs.size()), "bam", os);
+            CHECK_OP_BREAK(os);
+            if (0 == maxSorters) {
+                // no memory or threads for another chunk: the chunk is sorted before the next one is read
+                sortChunkToRun(*chunk, runs.last(), os);
+                CHECK_OP_BREAK(os);
+            } else {
+                sorters << new ChunkSorterThread(chunk.take(), runs.last());
+                sorters.last()->start();
+            }
+        }
+        CHECK_BREAK(hasMoreRecords);
+    }
+    waitForThreads(sorters, 0, os);
+
+    if (!os.isCoR() && !runs.isEmpty()) {
+        coreLog.details(BAMUtils::tr("Merging %1 sorted parts of \"%2\"").arg(runs.size()).arg(bamUrl));
+        mergeRuns(runs, tmpDir, runPrefix, helpersCount, os);
+        QList<BamRecordReader *> readers;
+        foreach (const QString &run, runs) {
+            CHECK_OP_BREAK(os);
+            readers << new BamRecordReader(run, false, os);
+        }
+        if (!os.isCoR()) {
+            mergeToOutput(readers, header, sortedBamUrl, buildIndex, helpersCount, os);
+        }
+        qDeleteAll(readers);
+    }
+    removeFiles(runs);
+}
+
+void BAMSorter::mergeRuns(QStringList &runs, const QString &tmpDir, const QString &runPrefix, int helpersCount, U2OpStatus &os) {
+    // Every merger opens up to groupSize files
+    const int groupSize = qMax(2, MAX_OPEN_RUNS / qMax(1, helpersCount));
+    int mergedRunsCount = 0;
+    while (runs.size() > MAX_OPEN_RUNS) {
+        QStringList mergedRuns;
+        QList<RunMergerThread *> mergers;
+        for (int i = 0; i < runs.size() && !os.isCoR(); i += groupSize) {
+            const QStringList group = runs.mid(i, groupSize);
+            if (1 == group.size()) {
+                mergedRuns << group;
+                continue;
+            }
+            waitForThreads(mergers, qMax(0, helpersCount - 1), os);
+            CHECK_OP_BREAK(os);
+            mergedRuns << GUrlUtils::prepareTmpFileLocation(tmpDir, runPrefix + "_merged" + QString::number(mergedRunsCount++), "bam", os);
+            CHECK_OP_BREAK(os);
+            if (0 == helpersCount) {
+                mergeRunsToFile(group, mergedRuns.last(), os);
+            } else {
+                mergers << new RunMergerThread(group, mergedRuns.last());
+                mergers.last()->start();
+            }
+        }
+        waitForThreads(mergers, 0, os);
+
+        // The merged runs are removed at once, the others are replaced by the merged ones
+        QStringList obsoleteRuns = runs;
+        foreach (const QString &run, mergedRuns) {
+            obsoleteRuns.removeAll(run);
+        }
+        removeFiles(obsoleteRuns);
+        runs = mergedRuns;
+        CHECK_OP(os, );
+    }
+}
+
+void BAMSorter::merge(const QStringList &bamUrls, const QString &mergedBamUrl, U2OpStatus &os) {
+    QList<BamRecordReader *> readers;
+    BamHeader header;
+    foreach (const QString &url, bamUrls) {
+        readers << new BamRecordReader(url, true, os);
+        CHECK_OP_BREAK(os);
+
+        // The same as samtools merge: the header is taken from the first file, references list is the longest one
+        const BamHeader &fileHeader = readers.last()->getHeader();
+        if (1 == readers.size()) {
+            header = fileHeader;
+            continue;
+        }
+        const int commonReferences = qMin(header.names.size(), fileHeader.names.size());
+        for (int i = 0; i < commonReferences && !os.hasError(); i++) {
+            CHECK_EXT_BREAK(header.names[i] == fileHeader.names[i],
+                            os.setError(BAMUtils::tr("Different reference sequence names: '%1' != '%2' in file '%3'")
+                                        .arg(QString(header.names[i])).arg(QString(fileHeader.names[i])).arg(url)));
+        }
+        CHECK_OP_BREAK(os);
+        if (fileHeader.names.size() > header.names.size()) {
+            header.names = fileHeader.names;
+            header.lengths = fileHeader.lengths;
+        }
+    }
+
+    if (!os.isCoR()) {
+        ThreadsReservation helpers(threadsCount - 1);
+        mergeToOutput(readers, header, mergedBamUrl, buildIndex, helpers.getCount(), os);
+    }
+    qDeleteAll(readers);
+}
+
+} // U2
@@ -0,0 +1,70 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_BAM_SORTER_H_
+#define _U2_BAM_SORTER_H_
+
+#include <QStringList>
+
+#include <U2Core/U2OpStatus.h>
+
+namespace U2 {
+
+/**
+ * Coordinate sorting and merging of BAM files.
+ *
+ * Sorting: the input is read by chunks that fit into the memory budget together,
+ * the chunks are sorted by several threads at once and spilled to the temporary directory
+ * as fast compressed runs. The runs are k-way merged into the result.
+ * If the whole input fits into one chunk, it is sorted in memory without temporary files.
+ *
+ * The result is BGZF compressed by several threads, the BAM index (.bai)
+ * can be built while the result is written.
+ */
+class BAMSorter {
+public:
+    /**
+     * @memoryBudget limits the memory of all chunks that are sorted at once.
+     * @threadsCount includes the calling thread. If it is not positive, the ideal threads count is used.
+     * The additional threads are taken from RESOURCE_THREAD while they are free, so the sorter
+     * runs in the calling thread only if the other threads are busy.
+     */
+    BAMSorter(qint64 memoryBudget, bool buildIndex, int threadsCount = 0);
+
+    void sort(const QString &bamUrl, const QString &sortedBamUrl, U2OpStatus &os);
+    /* The input files must be sorted by coordinate */
+    void merge(const QStringList &bamUrls, const QString &mergedBamUrl, U2OpStatus &os);
+
+    static const qint64 MIN_CHUNK_SIZE;
+    static const qint64 MAX_CHUNK_SIZE;
+    static const int MAX_OPEN_RUNS;
+
+private:
+    void mergeRuns(QStringList &runs, const QString &tmpDir, const QString &runPrefix, int helpersCount, U2OpStatus &os);
+
+    qint64 memoryBudget;
+    bool buildIndex;
+    int threadsCount;
+};
+
+} // U2
+
+#endif // _U2_BAM_SORTER_H_
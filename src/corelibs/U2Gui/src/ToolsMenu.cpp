@@ -88,6 +88,7 @@ const QString ToolsMenu::HMMER_MENU = "HMMER_MENU";
 const QString ToolsMenu::HMMER_BUILD3 = "HMMER_BUILD3";
 const QString ToolsMenu::HMMER_SEARCH3 = "HMMER_SEARCH3";
 const QString ToolsMenu::HMMER_SEARCH3P = "HMMER_SEARCH3P";
+const QString ToolsMenu::HMMER_SEARCH3_DB = "HMMER_SEARCH3_DB";
 const QString ToolsMenu::HMMER_BUILD2 = "HMMER_BUILD2";
 const QString ToolsMenu::HMMER_CALIBRATE2 = "HMMER_CALIBRATE2";
 const QString ToolsMenu::HMMER_SEARCH2 = "HMMER_SEARCH2";
@@ -197,6 +198,7 @@ void ToolsMenu::init() {
         subMenuAction[HMMER_MENU] << HMMER_BUILD3;
         subMenuAction[HMMER_MENU] << HMMER_SEARCH3;
         subMenuAction[HMMER_MENU] << HMMER_SEARCH3P;
+        subMenuAction[HMMER_MENU] << HMMER_SEARCH3_DB;
         subMenuAction[HMMER_MENU] << LINE;
         subMenuAction[HMMER_MENU] << HMMER_BUILD2;
         subMenuAction[HMMER_MENU] << HMMER_CALIBRATE2;
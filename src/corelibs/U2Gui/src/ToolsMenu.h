@@ -96,6 +96,7 @@ public:
     static const QString HMMER_BUILD3;
     static const QString HMMER_SEARCH3;
     static const QString HMMER_SEARCH3P;
+    static const QString HMMER_SEARCH3_DB;
     static const QString HMMER_BUILD2;
     static const QString HMMER_CALIBRATE2;
     static const QString HMMER_SEARCH2;
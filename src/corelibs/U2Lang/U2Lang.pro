@@ -76,6 +76,7 @@ HEADERS += src/library/BaseActorCategories.h \
            src/support/WorkflowEnvImpl.h \
            src/support/WorkflowInvestigationData.h \
            src/support/WorkflowIOTasks.h \
+           src/support/WorkflowResultCache.h \
            src/support/WorkflowRunTask.h \
            src/support/WorkflowSettings.h \
            src/support/WorkflowUtils.h \
@@ -186,6 +187,7 @@ SOURCES += src/library/BaseActorCategories.cpp \
            src/support/WorkflowDebugStatus.cpp \
            src/support/WorkflowEnvImpl.cpp \
            src/support/WorkflowIOTasks.cpp \
+           src/support/WorkflowResultCache.cpp \
            src/support/WorkflowRunTask.cpp \
            src/support/WorkflowSettings.cpp \
            src/support/WorkflowUtils.cpp \
@@ -84,7 +84,10 @@ inline void LastReadyScheduler::measuredTick() {
     CHECK(NULL != lastWorker, );
     lastWorker->deleteBackupMessagesFromPreviousTick();
 
-    lastTask = lastWorker->tick(canLastTaskBeCanceled);
+    {
+        GTIMER(cvar, tvar, "Workflow::tick");
+        lastTask = lastWorker->tick(canLastTaskBeCanceled);
+    }
 
     delete timeUpdater;
     timeUpdater = NULL;
@@ -19,6 +19,10 @@
  * MA 02110-1301, USA.
  */
 
+#include <U2Core/AppContext.h>
+#include <U2Core/PluginModel.h>
+#include <U2Core/U2SafePoints.h>
+
 #include <U2Lang/ActorPrototypeRegistry.h>
 
 namespace U2 {
@@ -29,6 +33,10 @@ void ActorPrototypeRegistry::registerProto(const Descriptor& group, ActorPrototy
     assert(!id.contains("."));
 
     groups[group].append(proto);
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps) {
+        ps->addCapability(PluginCapability_WorkflowActor, proto->getId());
+    }
     emit si_registryModified();
 }
 
@@ -49,7 +57,7 @@ ActorPrototype * ActorPrototypeRegistry::unregisterProto(const QString &id) {
     return NULL;
 }
 
-ActorPrototype* ActorPrototypeRegistry::getProto(const QString& id) const {
+ActorPrototype* ActorPrototypeRegistry::findProto(const QString& id) const {
     foreach(QList<ActorPrototype*> l, groups.values()) {
         foreach(ActorPrototype* p, l) {
             if (p->getId() == id) {
@@ -60,6 +68,18 @@ ActorPrototype* ActorPrototypeRegistry::getProto(const QString& id) const {
     return NULL;
 }
 
+ActorPrototype* ActorPrototypeRegistry::getProto(const QString& id) const {
+    ActorPrototype* proto = findProto(id);
+    CHECK(NULL == proto, proto);
+
+    // the element can be provided by a plugin that is not loaded yet
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps && ps->loadPluginProviding(PluginCapability_WorkflowActor, id)) {
+        return findProto(id);
+    }
+    return NULL;
+}
+
 ActorPrototypeRegistry::~ActorPrototypeRegistry()
 {
     foreach(QList<ActorPrototype*> l, groups) {
@@ -48,6 +48,9 @@ signals:
     void si_registryModified();
 
 private:
+    // looks for the prototype among the registered ones without loading plugins
+    ActorPrototype* findProto(const QString& id) const;
+
      QMap<Descriptor, QList<ActorPrototype*> > groups;
 
 }; // ActorPrototypeRegistry
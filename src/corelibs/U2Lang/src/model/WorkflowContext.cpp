@@ -53,7 +53,7 @@ static QString getWorkflowId(WorkflowContext *ctx) {
 }
 
 WorkflowContext::WorkflowContext(const QList<Actor*> &procs, WorkflowMonitor *_monitor)
-: monitor(_monitor), storage(NULL), process("")
+: monitor(_monitor), storage(NULL), process(""), cmdLine(AppContext::getCMDLineRegistry())
 {
     foreach (Actor *p, procs) {
         procMap.insert(p->getId(), p);
@@ -157,6 +157,14 @@ QString WorkflowContext::absolutePath(const QString &relative) const {
     return workingDir() + relative;
 }
 
+void WorkflowContext::setWorkingDirRoot(const QString &root) {
+    _workingDirRoot = root;
+}
+
+void WorkflowContext::setCMDLine(const CMDLineRegistry *_cmdLine) {
+    cmdLine = _cmdLine;
+}
+
 MessageMetadataStorage & WorkflowContext::getMetadataStorage() {
     return metadataStorage;
 }
@@ -164,7 +172,7 @@ MessageMetadataStorage & WorkflowContext::getMetadataStorage() {
 bool WorkflowContext::initWorkingDir() {
     U2OpStatus2Log os;
 
-    QString root = WorkflowContextCMDLine::getOutputDirectory(os);
+    QString root = WorkflowContextCMDLine::getOutputDirectory(_workingDirRoot, os);
     CHECK_OP(os, false);
 
     if (!root.endsWith("/")) {
@@ -179,7 +187,7 @@ bool WorkflowContext::initWorkingDir() {
         _workingDir = root;
     }
     if (!AppContext::isGUIMode()) {
-        WorkflowContextCMDLine::saveRunInfo(workingDir());
+        WorkflowContextCMDLine::saveRunInfo(workingDir(), cmdLine);
     }
     monitor->setOutputDir(workingDir());
     coreLog.details("Workflow output directory is: " + workingDir());
@@ -189,13 +197,11 @@ bool WorkflowContext::initWorkingDir() {
 /************************************************************************/
 /* WorkflowContextCMDLine */
 /************************************************************************/
-QString WorkflowContextCMDLine::getOutputDirectory(U2OpStatus &os) {
+QString WorkflowContextCMDLine::getOutputDirectory(const QString &jobRoot, U2OpStatus &os) {
     // 1. Detect directory
-    QString root;
-    if (useOutputDir()) {
-        root = WorkflowSettings::getWorkflowOutputDirectory();
-    } else {
-        root = QDir::currentPath();
+    QString root = jobRoot;
+    if (root.isEmpty()) {
+        root = useOutputDir() ? WorkflowSettings::getWorkflowOutputDirectory() : QDir::currentPath();
     }
 
     // 2. Create directory if it does not exist
@@ -241,14 +247,15 @@ bool WorkflowContextCMDLine::useSubDirs() {
     return useOutputDir();
 }
 
-void WorkflowContextCMDLine::saveRunInfo(const QString &dir) {
+void WorkflowContextCMDLine::saveRunInfo(const QString &dir, const CMDLineRegistry *cmdLine) {
+    CHECK(NULL != cmdLine, );
     QFile runInfo(dir + "run.info");
     bool opened = runInfo.open(QIODevice::WriteOnly);
     CHECK(opened, );
 
     QTextStream stream(&runInfo);
     stream.setCodec("UTF-8");
-    stream << QCoreApplication::arguments().join(" ") + "\n";
+    stream << cmdLine->getArguments().join(" ") + "\n";
     stream.flush();
 
     runInfo.close();
@@ -31,6 +31,9 @@
 #include <U2Lang/MessageMetadata.h>
 
 namespace U2 {
+
+class CMDLineRegistry;
+
 using namespace FileStorage;
 namespace Workflow {
 
@@ -67,6 +70,10 @@ public:
 
     QString workingDir() const;
     QString absolutePath(const QString &relative) const;
+    /** The folder for relative output paths. By default, it is the current folder in the console mode */
+    void setWorkingDirRoot(const QString &root);
+    /** The command line of the run. By default, it is the command line of the current process */
+    void setCMDLine(const CMDLineRegistry *cmdLine);
 
     MessageMetadataStorage & getMetadataStorage();
 
@@ -84,16 +91,19 @@ private:
     bool initWorkingDir();
 
 private:
+    QString _workingDirRoot;
     QString _workingDir;
+    const CMDLineRegistry *cmdLine;
 };
 
-class WorkflowContextCMDLine {
+class U2LANG_EXPORT WorkflowContextCMDLine {
 public:
-    static QString getOutputDirectory(U2OpStatus &os);
+    /** Returns @jobRoot if it is not empty, the default output folder otherwise. The folder is created if it does not exist */
+    static QString getOutputDirectory(const QString &jobRoot, U2OpStatus &os);
     static QString createSubDirectoryForRun(const QString &root, U2OpStatus &os);
     static bool useOutputDir();
     static bool useSubDirs();
-    static void saveRunInfo(const QString &dir);
+    static void saveRunInfo(const QString &dir, const CMDLineRegistry *cmdLine);
 };
 
 } // Workflow
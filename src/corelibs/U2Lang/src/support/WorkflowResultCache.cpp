@@ -0,0 +1,385 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+
+#include <U2Core/L10n.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "WorkflowResultCache.h"
+
+namespace U2 {
+
+namespace {
+
+const int READ_BUFFER_SIZE = 1024 * 1024;
+const QString OUTPUT_FILE_NAME = "output";
+const QString ACCESS_TIME_FILE_NAME = "last_access";
+const QString TMP_ENTRY_SUFFIX = ".tmp";
+
+QMutex fileHashesMutex;
+QHash<QString, QByteArray> fileHashes;
+
+/** Guards the cache settings and the entries renaming and eviction in this process, the files are copied without it */
+QMutex cacheMutex;
+
+QByteArray getFileHash(const QString &url, U2OpStatus &os) {
+    const QFileInfo info(url);
+    CHECK_EXT(info.isFile(), os.setError(L10N::errorOpeningFileRead(url)), QByteArray());
+
+    // the files are not rehashed in the same process until they are modified
+    const QString fileId = QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toTime_t());
+    {
+        QMutexLocker locker(&fileHashesMutex);
+        if (fileHashes.contains(fileId)) {
+            return fileHashes[fileId];
+        }
+    }
+
+    QFile file(url);
+    CHECK_EXT(file.open(QIODevice::ReadOnly), os.setError(L10N::errorOpeningFileRead(url)), QByteArray());
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QByteArray buffer(READ_BUFFER_SIZE, 0);
+    qint64 readBytes = 0;
+    while ((readBytes = file.read(buffer.data(), buffer.size())) > 0) {
+        hash.addData(buffer.constData(), readBytes);
+        CHECK(!os.isCoR(), QByteArray());
+    }
+    CHECK_EXT(0 == readBytes, os.setError(L10N::errorReadingFile(url)), QByteArray());
+
+    const QByteArray result = hash.result();
+    QMutexLocker locker(&fileHashesMutex);
+    fileHashes[fileId] = result;
+    return result;
+}
+
+qint64 getAccessTime(const QString &entryPath) {
+    QFile file(QDir(entryPath).filePath(ACCESS_TIME_FILE_NAME));
+    CHECK(file.open(QIODevice::ReadOnly), 0);
+    return file.readAll().trimmed().toLongLong();
+}
+
+qint64 getEntrySize(const QString &entryPath) {
+    qint64 size = 0;
+    foreach (const QFileInfo &fileInfo, QDir(entryPath).entryInfoList(QDir::Files)) {
+        size += fileInfo.size();
+    }
+    return size;
+}
+
+/** Distinguishes the temporary files of the concurrent stores and restores */
+QString getUniqueSuffix() {
+    static QAtomicInt counter;
+    return QString("%1_%2").arg(QCoreApplication::applicationPid()).arg(counter.fetchAndAddOrdered(1));
+}
+
+void removeFiles(const QStringList &urls) {
+    foreach (const QString &url, urls) {
+        QFile::remove(url);
+    }
+}
+
+bool removeEntry(const QString &entryPath) {
+    QDir entryDir(entryPath);
+    foreach (const QString &fileName, entryDir.entryList(QDir::Files | QDir::Hidden)) {
+        entryDir.remove(fileName);
+    }
+    return QDir().rmdir(entryPath);
+}
+
+}
+
+/************************************************************************/
+/* WorkflowResultCacheKey */
+/************************************************************************/
+WorkflowResultCacheKey::WorkflowResultCacheKey(const QString &stepId, const QString &toolVersion)
+: stepId(stepId), toolVersion(toolVersion)
+{
+
+}
+
+void WorkflowResultCacheKey::addParameter(const QString &name, const QVariant &value) {
+    parameters[name] = value.toString();
+}
+
+void WorkflowResultCacheKey::addInputFile(const QString &url) {
+    inputFiles << url;
+}
+
+QString WorkflowResultCacheKey::computeHash(U2OpStatus &os) const {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(stepId.toUtf8() + '\n');
+    hash.addData(toolVersion.toUtf8() + '\n');
+    foreach (const QString &name, parameters.keys()) {
+        hash.addData(QString("%1=%2\n").arg(name).arg(parameters[name]).toUtf8());
+    }
+    foreach (const QString &url, inputFiles) {
+        hash.addData(getFileHash(url, os));
+        CHECK_OP(os, QString());
+    }
+    return hash.result().toHex();
+}
+
+/************************************************************************/
+/* WorkflowResultCache */
+/************************************************************************/
+const qint64 WorkflowResultCache::DEFAULT_MAX_SIZE_MB = 10 * 1024;
+
+QString WorkflowResultCache::cacheDirPath;
+qint64 WorkflowResultCache::maxSizeMb = WorkflowResultCache::DEFAULT_MAX_SIZE_MB;
+
+bool WorkflowResultCache::isEnabled() {
+    QMutexLocker locker(&cacheMutex);
+    return !cacheDirPath.isEmpty();
+}
+
+void WorkflowResultCache::setCacheDirectory(const QString &dirPath, qint64 sizeLimitMb) {
+    QMutexLocker locker(&cacheMutex);
+    cacheDirPath = dirPath.isEmpty() ? QString() : QFileInfo(dirPath).absoluteFilePath();
+    maxSizeMb = qMax(qint64(0), sizeLimitMb);
+}
+
+bool WorkflowResultCache::restore(const QString &hash, const QString &outputBase, U2OpStatus &os) {
+    QString entryPath;
+    QStringList fileNames;
+    {
+        QMutexLocker locker(&cacheMutex);
+        CHECK(!cacheDirPath.isEmpty(), false);
+
+        QDir entryDir(QDir(cacheDirPath).filePath(hash));
+        CHECK(entryDir.exists(), false);
+        fileNames = entryDir.entryList(QStringList(OUTPUT_FILE_NAME + "*"), QDir::Files);
+        CHECK(!fileNames.isEmpty(), false);
+        entryPath = entryDir.path();
+        // the entry becomes the most recently used one, so the evictions do not pick it during the copying
+        updateAccessTime(entryPath);
+    }
+
+    // the outputs are copied without the lock to temporary files and renamed at the end,
+    // so the outputs are either restored completely or not at all
+    QDir().mkpath(QFileInfo(outputBase).absolutePath());
+    const QString tmpSuffix = TMP_ENTRY_SUFFIX + getUniqueSuffix();
+    QStringList outputUrls;
+    QStringList tmpUrls;
+    foreach (const QString &fileName, fileNames) {
+        const QString outputUrl = outputBase + fileName.mid(OUTPUT_FILE_NAME.length());
+        const QString tmpUrl = outputUrl + tmpSuffix;
+        QFile::remove(tmpUrl);
+        if (!QFile::copy(QDir(entryPath).filePath(fileName), tmpUrl)) {
+            removeFiles(tmpUrls << tmpUrl);
+            os.setError(L10N::errorWritingFile(outputUrl));
+            return false;
+        }
+        outputUrls << outputUrl;
+        tmpUrls << tmpUrl;
+    }
+
+    for (int i = 0; i < outputUrls.size(); i++) {
+        const QString &outputUrl = outputUrls[i];
+        if ((QFile::exists(outputUrl) && !QFile::remove(outputUrl)) || !QFile::rename(tmpUrls[i], outputUrl)) {
+            removeFiles(outputUrls.mid(0, i));
+            removeFiles(tmpUrls.mid(i));
+            os.setError(L10N::errorWritingFile(outputUrl));
+            return false;
+        }
+    }
+    return true;
+}
+
+void WorkflowResultCache::store(const QString &hash, const QString &outputBase, const QStringList &suffixPatterns, U2OpStatus &os) {
+    QString cachePath;
+    qint64 sizeLimitMb = 0;
+    {
+        QMutexLocker locker(&cacheMutex);
+        cachePath = cacheDirPath;
+        sizeLimitMb = maxSizeMb;
+    }
+    CHECK(!cachePath.isEmpty(), );
+
+    const QFileInfo baseInfo(outputBase);
+    const QString baseName = baseInfo.fileName();
+    QStringList nameFilters;
+    foreach (const QString &pattern, suffixPatterns) {
+        nameFilters << baseName + pattern;
+    }
+    const QFileInfoList outputs = baseInfo.absoluteDir().entryInfoList(nameFilters, QDir::Files);
+    CHECK_EXT(!outputs.isEmpty(), os.setError(QObject::tr("There are no output files of the step: %1").arg(outputBase)), );
+
+    qint64 outputsSize = 0;
+    foreach (const QFileInfo &output, outputs) {
+        outputsSize += output.size();
+    }
+    if (outputsSize > sizeLimitMb * 1024 * 1024) {
+        coreLog.details(QObject::tr("The step outputs are bigger than the workflow result cache: %1").arg(outputBase));
+        return;
+    }
+
+    QDir cacheDir(cachePath);
+    CHECK_EXT(cacheDir.mkpath(cachePath), os.setError(L10N::errorWritingFile(cachePath)), );
+    CHECK(!cacheDir.exists(hash), ); // another UGENE process has already stored it
+
+    // the entry is filled without the lock in a temporary folder and renamed at the end,
+    // so other UGENE processes and threads never see an incomplete entry
+    const QString tmpEntryName = hash + TMP_ENTRY_SUFFIX + getUniqueSuffix();
+    const QString tmpEntryPath = cacheDir.filePath(tmpEntryName);
+    removeEntry(tmpEntryPath);
+    CHECK_EXT(cacheDir.mkdir(tmpEntryName), os.setError(L10N::errorWritingFile(tmpEntryPath)), );
+    foreach (const QFileInfo &output, outputs) {
+        const QString entryFilePath = QDir(tmpEntryPath).filePath(OUTPUT_FILE_NAME + output.fileName().mid(baseName.length()));
+        if (!QFile::copy(output.absoluteFilePath(), entryFilePath)) {
+            removeEntry(tmpEntryPath);
+            os.setError(L10N::errorWritingFile(entryFilePath));
+            return;
+        }
+    }
+    updateAccessTime(tmpEntryPath);
+
+    QMutexLocker locker(&cacheMutex);
+    if (cacheDir.exists(hash) || !cacheDir.rename(tmpEntryName, hash)) {
+        removeEntry(tmpEntryPath);
+        return;
+    }
+    evict();
+}
+
+void WorkflowResultCache::updateAccessTime(const QString &entryPath) {
+    QFile file(QDir(entryPath).filePath(ACCESS_TIME_FILE_NAME));
+    CHECK(file.open(QIODevice::WriteOnly | QIODevice::Truncate), );
+    file.write(QByteArray::number(QDateTime::currentMSecsSinceEpoch()));
+}
+
+void WorkflowResultCache::evict() {
+    QDir cacheDir(cacheDirPath);
+    QMultiMap<qint64, QString> entriesByAccessTime;
+    QHash<QString, qint64> entriesSizes;
+    qint64 totalSize = 0;
+    foreach (const QFileInfo &entryInfo, cacheDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        CHECK_OPERATION(!entryInfo.fileName().contains(TMP_ENTRY_SUFFIX), continue);
+        const QString entryPath = entryInfo.absoluteFilePath();
+        entriesByAccessTime.insert(getAccessTime(entryPath), entryPath);
+        entriesSizes[entryPath] = getEntrySize(entryPath);
+        totalSize += entriesSizes[entryPath];
+    }
+
+    const qint64 maxSize = maxSizeMb * 1024 * 1024;
+    QMultiMap<qint64, QString>::ConstIterator i = entriesByAccessTime.constBegin();
+    for (; totalSize > maxSize && i != entriesByAccessTime.constEnd(); ++i) {
+        coreLog.details(QObject::tr("Removing the least recently used workflow result cache entry: %1").arg(i.value()));
+        removeEntry(i.value());
+        totalSize -= entriesSizes[i.value()];
+    }
+}
+
+/************************************************************************/
+/* WorkflowResultCacheLookupTask */
+/************************************************************************/
+WorkflowResultCacheLookupTask::WorkflowResultCacheLookupTask(const WorkflowResultCacheKey &key, const QString &outputBase)
+: Task(tr("Look up the workflow result cache"), TaskFlag_None), key(key), outputBase(outputBase), restored(false)
+{
+
+}
+
+void WorkflowResultCacheLookupTask::run() {
+    // the cache problems must not stop the workflow: the step is just computed then
+    U2OpStatus2Log os(LogLevel_INFO);
+    const QString keyHash = key.computeHash(os);
+    CHECK_OP(os, );
+    CHECK(!isCanceled(), );
+    hash = keyHash;
+    restored = WorkflowResultCache::restore(hash, outputBase, os);
+}
+
+const QString & WorkflowResultCacheLookupTask::getHash() const {
+    return hash;
+}
+
+bool WorkflowResultCacheLookupTask::isRestored() const {
+    return restored;
+}
+
+/************************************************************************/
+/* WorkflowResultCacheTask */
+/************************************************************************/
+WorkflowResultCacheTask::WorkflowResultCacheTask(const WorkflowResultCacheKey &key, const QString &outputBase, const QStringList &suffixPatterns, Task *stepTask)
+: Task(tr("Cached workflow step"), TaskFlags_FOSE_COSC),
+  key(key),
+  outputBase(outputBase),
+  suffixPatterns(suffixPatterns),
+  lookupTask(NULL),
+  stepTask(stepTask),
+  stepTaskStarted(false)
+{
+    SAFE_POINT_EXT(NULL != stepTask, setError("NULL step task"), );
+    setTaskName(tr("Cached workflow step: \"%1\"").arg(stepTask->getTaskName()));
+}
+
+WorkflowResultCacheTask::~WorkflowResultCacheTask() {
+    if (!stepTaskStarted) {
+        delete stepTask;
+    }
+}
+
+void WorkflowResultCacheTask::prepare() {
+    CHECK_OP(stateInfo, );
+    lookupTask = new WorkflowResultCacheLookupTask(key, outputBase);
+    addSubTask(lookupTask);
+}
+
+QList<Task*> WorkflowResultCacheTask::onSubTaskFinished(Task *subTask) {
+    QList<Task*> result;
+    CHECK(subTask == lookupTask && !isCanceled() && !hasError(), result);
+
+    if (lookupTask->isRestored()) {
+        algoLog.info(tr("The result of \"%1\" is taken from the workflow result cache").arg(stepTask->getTaskName()));
+        return result;
+    }
+    stepTaskStarted = true;
+    result << stepTask;
+    return result;
+}
+
+void WorkflowResultCacheTask::run() {
+    CHECK(stepTaskStarted && !lookupTask->getHash().isEmpty() && !isCanceled() && !hasError(), );
+    U2OpStatusImpl os;
+    WorkflowResultCache::store(lookupTask->getHash(), outputBase, suffixPatterns, os);
+    if (os.hasError()) {
+        coreLog.info(tr("The result of \"%1\" is not put into the workflow result cache: %2").arg(stepTask->getTaskName()).arg(os.getError()));
+    }
+}
+
+Task * WorkflowResultCacheTask::getStepTask() const {
+    return stepTask;
+}
+
+bool WorkflowResultCacheTask::isRestoredFromCache() const {
+    return NULL != lookupTask && lookupTask->isRestored();
+}
+
+} // U2
@@ -0,0 +1,127 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_WORKFLOW_RESULT_CACHE_H_
+#define _U2_WORKFLOW_RESULT_CACHE_H_
+
+#include <QtCore/QMap>
+#include <QtCore/QStringList>
+
+#include <U2Core/Task.h>
+
+namespace U2 {
+
+/**
+ * Identifies a result of a workflow step: the step id, the tool version, the parameters values
+ * and the contents of the input files. Equal keys produce the same outputs.
+ */
+class U2LANG_EXPORT WorkflowResultCacheKey {
+public:
+    WorkflowResultCacheKey(const QString &stepId = QString(), const QString &toolVersion = QString());
+
+    void addParameter(const QString &name, const QVariant &value);
+    void addInputFile(const QString &url);
+
+    /** Hashes the contents of the input files, it can take a while for big files */
+    QString computeHash(U2OpStatus &os) const;
+
+private:
+    QString stepId;
+    QString toolVersion;
+    QMap<QString, QString> parameters;
+    QStringList inputFiles;
+};
+
+/**
+ * The persistent cache of the workflow steps results. It is disabled by default.
+ * The outputs of a step are files that share the base path: "<base><suffix>".
+ * An entry keeps them by the suffixes, so they can be restored for another base path.
+ * The least recently used entries are removed when the cache exceeds the size limit.
+ */
+class U2LANG_EXPORT WorkflowResultCache {
+public:
+    static bool isEnabled();
+    static void setCacheDirectory(const QString &dirPath, qint64 maxSizeMb = DEFAULT_MAX_SIZE_MB);
+
+    /** Returns false if there is no entry for the hash or it is not restored, the partially restored outputs are removed then */
+    static bool restore(const QString &hash, const QString &outputBase, U2OpStatus &os);
+    /** @suffixPatterns are wildcards of the output files names after the base file name, e.g. ".*.sarr" */
+    static void store(const QString &hash, const QString &outputBase, const QStringList &suffixPatterns, U2OpStatus &os);
+
+    static const qint64 DEFAULT_MAX_SIZE_MB;
+
+private:
+    static void updateAccessTime(const QString &entryPath);
+    static void evict();
+
+    static QString cacheDirPath;
+    static qint64 maxSizeMb;
+};
+
+/** Computes the key hash and restores the cached outputs if there is an entry for it */
+class U2LANG_EXPORT WorkflowResultCacheLookupTask : public Task {
+    Q_OBJECT
+public:
+    WorkflowResultCacheLookupTask(const WorkflowResultCacheKey &key, const QString &outputBase);
+
+    void run();
+
+    const QString & getHash() const;
+    bool isRestored() const;
+
+private:
+    WorkflowResultCacheKey key;
+    QString outputBase;
+    QString hash;
+    bool restored;
+};
+
+/**
+ * Runs the step task only if its result is not in the cache.
+ * The result of the succeeded step task is put into the cache.
+ * If the cache is not available, the step task is just run.
+ */
+class U2LANG_EXPORT WorkflowResultCacheTask : public Task {
+    Q_OBJECT
+public:
+    /** The task takes the ownership of @stepTask */
+    WorkflowResultCacheTask(const WorkflowResultCacheKey &key, const QString &outputBase, const QStringList &suffixPatterns, Task *stepTask);
+    ~WorkflowResultCacheTask();
+
+    void prepare();
+    void run();
+    QList<Task*> onSubTaskFinished(Task *subTask);
+
+    Task * getStepTask() const;
+    bool isRestoredFromCache() const;
+
+private:
+    WorkflowResultCacheKey key;
+    QString outputBase;
+    QStringList suffixPatterns;
+    WorkflowResultCacheLookupTask *lookupTask;
+    Task *stepTask;
+    bool stepTaskStarted;
+};
+
+} // U2
+
+#endif // _U2_WORKFLOW_RESULT_CACHE_H_
@@ -93,7 +93,8 @@ WorkflowAbstractIterationRunner::WorkflowAbstractIterationRunner(const QString &
  *******************************************/
 WorkflowRunTask::WorkflowRunTask(const Schema& sh, const QMap<ActorId, ActorId>& remap, WorkflowDebugStatus *debugInfo)
     : WorkflowAbstractRunner(tr("Execute workflow"),
-    TaskFlags(TaskFlag_NoRun) | TaskFlag_ReportingIsSupported | TaskFlag_OnlyNotificationReport), rmap(remap), flows(sh.getFlows())
+    TaskFlags(TaskFlag_NoRun) | TaskFlag_ReportingIsSupported | TaskFlag_OnlyNotificationReport), rmap(remap), flows(sh.getFlows()),
+    cmdLine(AppContext::getCMDLineRegistry())
 {
 
     GCOUNTER( cvar, tvar, "WorkflowRunTask" );
@@ -111,7 +112,10 @@ WorkflowRunTask::WorkflowRunTask(const Schema& sh, const QMap<ActorId, ActorId>&
     addSubTask(t);
 
     setMaxParallelSubtasks(MAX_PARALLEL_SUBTASKS_AUTO);
-    if(AppContext::getCMDLineRegistry()->hasParameter(OUTPUT_PROGRESS_OPTION)) {
+}
+
+void WorkflowRunTask::prepare() {
+    if (NULL != cmdLine && cmdLine->hasParameter(OUTPUT_PROGRESS_OPTION)) {
         QTimer * timer = new QTimer(this);
         connect(timer, SIGNAL(timeout()), SLOT(sl_outputProgressAndState()));
         timer->start(UPDATE_PROGRESS_INTERVAL);
@@ -180,12 +184,30 @@ int WorkflowRunTask::getMsgPassed(const Link* l) {
     return ret;
 }
 
+void WorkflowRunTask::setWorkingDirRoot(const QString &root) {
+    foreach(Task* t, getSubtasks()) {
+        WorkflowIterationRunTask* rt = qobject_cast<WorkflowIterationRunTask*>(t);
+        SAFE_POINT(NULL != rt, "Unexpected subtask of the workflow run task", );
+        rt->setWorkingDirRoot(root);
+    }
+}
+
+void WorkflowRunTask::setCMDLine(const CMDLineRegistry *_cmdLine) {
+    cmdLine = _cmdLine;
+    foreach(Task* t, getSubtasks()) {
+        WorkflowIterationRunTask* rt = qobject_cast<WorkflowIterationRunTask*>(t);
+        SAFE_POINT(NULL != rt, "Unexpected subtask of the workflow run task", );
+        rt->setCMDLine(cmdLine);
+    }
+}
+
 Task::ReportResult WorkflowRunTask::report() {
     propagateSubtaskError();
-    if (AppContext::getCMDLineRegistry()->hasParameter(OUTPUT_ERROR_OPTION)) {
+    CHECK(NULL != cmdLine, ReportResult_Finished);
+    if (cmdLine->hasParameter(OUTPUT_ERROR_OPTION)) {
         logErrors();
     }
-    if(AppContext::getCMDLineRegistry()->hasParameter(OUTPUT_PROGRESS_OPTION)) {
+    if(cmdLine->hasParameter(OUTPUT_PROGRESS_OPTION)) {
         sl_outputProgressAndState();
     }
     return ReportResult_Finished;
@@ -458,6 +480,16 @@ WorkflowMonitor * WorkflowIterationRunTask::getMonitor() const {
     return context->getMonitor();
 }
 
+void WorkflowIterationRunTask::setWorkingDirRoot(const QString &root) {
+    CHECK(NULL != context, );
+    context->setWorkingDirRoot(root);
+}
+
+void WorkflowIterationRunTask::setCMDLine(const CMDLineRegistry *cmdLine) {
+    CHECK(NULL != context, );
+    context->setCMDLine(cmdLine);
+}
+
 int WorkflowIterationRunTask::getMsgNum(const Link *l) {
     CommunicationChannel* cc = lmap.value(getKey(l));
     if (cc) {
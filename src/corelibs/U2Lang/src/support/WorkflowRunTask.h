@@ -39,6 +39,8 @@
 
 namespace U2 {
 
+class CMDLineRegistry;
+
 namespace Workflow {
     class CommunicationChannel;
     class WorkflowMonitor;
@@ -82,11 +84,17 @@ class U2LANG_EXPORT WorkflowRunTask : public WorkflowAbstractRunner {
 public:
     WorkflowRunTask(const Schema&, const ActorMap& rmap = ActorMap(),
         WorkflowDebugStatus *debugInfo = new WorkflowDebugStatus());
+    virtual void prepare();
     virtual ReportResult report();
     virtual QList<WorkerState> getState(Actor*);
     virtual int getMsgNum(const Link*);
     virtual int getMsgPassed(const Link*);
 
+    /** Relative output paths are resolved against this folder instead of the current one */
+    void setWorkingDirRoot(const QString &root);
+    /** The options of the run are read from @cmdLine instead of the command line of the current process */
+    void setCMDLine(const CMDLineRegistry *cmdLine);
+
 signals:
     void si_ticked();
 
@@ -100,6 +108,7 @@ private:
 private:
     QMap<ActorId, ActorId> rmap;
     QList<Link*> flows;
+    const CMDLineRegistry *cmdLine;
 
 }; // WorkflowRunTask
 
@@ -117,6 +126,8 @@ public:
     virtual int getDataProduced(const ActorId &actor);
 
     WorkflowMonitor * getMonitor() const;
+    void setWorkingDirRoot(const QString &root);
+    void setCMDLine(const CMDLineRegistry *cmdLine);
 
 signals:
     void si_ticked();
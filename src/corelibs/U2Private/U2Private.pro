@@ -9,6 +9,7 @@ HEADERS += src/AppContextImpl.h \
            src/IOAdapterRegistryImpl.h \
            src/LogSettings.h \
            src/PluginDescriptor.h \
+           src/PluginManifest.h \
            src/PluginSupportImpl.h \
            src/ServiceRegistryImpl.h \
            src/SettingsImpl.h \
@@ -27,6 +28,7 @@ SOURCES += src/AppContextImpl.cpp \
            src/IOAdapterRegistryImpl.cpp \
            src/LogSettings.cpp \
            src/PluginDescriptor.cpp \
+           src/PluginManifest.cpp \
            src/PluginSupportImpl.cpp \
            src/ServiceRegistryImpl.cpp \
            src/SettingsImpl.cpp \
@@ -63,6 +63,7 @@ public:
         rdc = NULL;
         protocolInfoRegistry = NULL;
         remoteMachineMonitor = NULL;
+        localTaskFactoryRegistry = NULL;
         treeGeneratorRegistry = NULL;
         cmdLineRegistry = NULL;
         instance = this;
@@ -181,6 +182,9 @@ public:
     void setRemoteMachineMonitor( RemoteMachineMonitor * rm ) { assert( NULL == remoteMachineMonitor || NULL == rm );
         remoteMachineMonitor = rm; }
 
+    void setLocalTaskFactoryRegistry( LocalTaskFactoryRegistry * ltfr ) { assert( NULL == localTaskFactoryRegistry || NULL == ltfr );
+        localTaskFactoryRegistry = ltfr; }
+
     void setPhyTreeGeneratorRegistry(PhyTreeGeneratorRegistry* genRegistry) {
         assert(NULL == treeGeneratorRegistry || NULL == genRegistry);
         treeGeneratorRegistry = genRegistry;
@@ -378,6 +382,7 @@ protected:
     virtual RecentlyDownloadedCache*     _getRecentlyDownloadedCache() const {return rdc;}
     virtual ProtocolInfoRegistry *          _getProtocolInfoRegistry() const { return protocolInfoRegistry; }
     virtual RemoteMachineMonitor *          _getRemoteMachineMonitor() const { return remoteMachineMonitor; }
+    virtual LocalTaskFactoryRegistry *      _getLocalTaskFactoryRegistry() const { return localTaskFactoryRegistry; }
     virtual CMDLineRegistry*                _getCMDLineRegistry() const {return cmdLineRegistry;}
     virtual MSAConsensusAlgorithmRegistry*  _getMSAConsensusAlgorithmRegistry() const {return msaConsensusAlgoRegistry;}
     virtual MSADistanceAlgorithmRegistry*  _getMSADistanceAlgorithmRegistry() const {return msaDistanceAlgoRegistry;}
@@ -454,6 +459,7 @@ private:
     RecentlyDownloadedCache* rdc;
     ProtocolInfoRegistry * protocolInfoRegistry;
     RemoteMachineMonitor * remoteMachineMonitor;
+    LocalTaskFactoryRegistry * localTaskFactoryRegistry;
     PhyTreeGeneratorRegistry *treeGeneratorRegistry;
     CMDLineRegistry* cmdLineRegistry;
     MSAConsensusAlgorithmRegistry* msaConsensusAlgoRegistry;
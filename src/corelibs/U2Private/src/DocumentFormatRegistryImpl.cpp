@@ -21,6 +21,7 @@
 
 #include <U2Core/AppContext.h>
 #include <U2Core/DbiDocumentFormat.h>
+#include <U2Core/PluginModel.h>
 #include <U2Core/RawDataUdrSchema.h>
 #include <U2Core/U2OpStatusUtils.h>
 #include <U2Core/U2SafePoints.h>
@@ -35,6 +36,7 @@
 #include <U2Formats/DifferentialFormat.h>
 #include <U2Formats/EMBLPlainTextFormat.h>
 #include <U2Formats/FastaFormat.h>
+#include <U2Formats/FastaIndexDbi.h>
 #include <U2Formats/FastqFormat.h>
 #include <U2Formats/FpkmTrackingFormat.h>
 #include <U2Formats/GFFFormat.h>
@@ -66,6 +68,10 @@ namespace U2 {
 bool DocumentFormatRegistryImpl::registerFormat(DocumentFormat* f) {
     assert(getFormatById(f->getFormatId())==NULL);
     formats.push_back(f);
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps) {
+        ps->addCapability(PluginCapability_DocumentFormat, f->getFormatId());
+    }
     emit si_documentFormatRegistered(f);
     if (f->getFormatDescription().isEmpty()) {
         coreLog.trace("Warn! Format has no description: " + f->getFormatName());
@@ -116,6 +122,15 @@ DocumentFormat* DocumentFormatRegistryImpl::getFormatById(DocumentFormatId id) c
             return f;
         }
     }
+    // the format can be provided by a plugin that is not loaded yet
+    PluginSupport* ps = AppContext::getPluginSupport();
+    if (NULL != ps && ps->loadPluginProviding(PluginCapability_DocumentFormat, id)) {
+        foreach (DocumentFormat* f, formats) {
+            if (f->getFormatId() == id) {
+                return f;
+            }
+        }
+    }
     return NULL;
 }
 
@@ -220,6 +235,7 @@ void DocumentFormatRegistryImpl::init() {
 
     AppContext::getDbiRegistry()->registerDbiFactory(new SQLiteDbiFactory());
     AppContext::getDbiRegistry()->registerDbiFactory(new MysqlDbiFactory());
+    AppContext::getDbiRegistry()->registerDbiFactory(new FastaIndexDbiFactory());
 
     DocumentFormatFlags flags(DocumentFormatFlag_SupportWriting);
     DbiDocumentFormat* sdbi = new DbiDocumentFormat(SQLiteDbiFactory::ID, BaseDocumentFormats::UGENEDB, tr("UGENE Database"), QStringList()<<"ugenedb", flags);
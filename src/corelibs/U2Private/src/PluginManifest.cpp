@@ -0,0 +1,143 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/Settings.h>
+
+#include "PluginManifest.h"
+
+namespace U2 {
+
+#define PLUGIN_MANIFEST_SETTINGS QString("plugin_support/manifest/")
+// manifests of the older versions don't list the registries
+#define PLUGIN_MANIFEST_VERSION 2
+
+PluginManifest::PluginManifest()
+: usesStartUpSignal(false)
+{
+}
+
+PluginManifest::PluginManifest(const PluginDesc& desc)
+: usesStartUpSignal(false), pluginId(desc.id), libraryState(getLibraryState(desc))
+{
+}
+
+PluginManifest PluginManifest::read(const PluginDesc& desc) {
+    Settings* settings = AppContext::getSettings();
+    QVariantMap data = settings->getValue(settings->toVersionKey(PLUGIN_MANIFEST_SETTINGS) + desc.id).toMap();
+
+    PluginManifest manifest(desc);
+    if (data.value("library").toString() != manifest.libraryState || data.value("version").toInt() != PLUGIN_MANIFEST_VERSION) {
+        return PluginManifest();
+    }
+    manifest.formats = data.value("formats").toStringList();
+    manifest.actors = data.value("actors").toStringList();
+    manifest.cmdlineOptions = data.value("cmdline").toStringList();
+    manifest.registries = data.value("registries").toStringList();
+    manifest.usesStartUpSignal = data.value("startUpSignal").toBool();
+    return manifest;
+}
+
+void PluginManifest::write() const {
+    if (pluginId.isEmpty() || libraryState.isEmpty()) {
+        return;
+    }
+    QVariantMap data;
+    data["version"] = PLUGIN_MANIFEST_VERSION;
+    data["library"] = libraryState;
+    data["formats"] = formats;
+    data["actors"] = actors;
+    data["cmdline"] = cmdlineOptions;
+    data["registries"] = registries;
+    data["startUpSignal"] = usesStartUpSignal;
+
+    Settings* settings = AppContext::getSettings();
+    settings->setValue(settings->toVersionKey(PLUGIN_MANIFEST_SETTINGS) + pluginId, data);
+}
+
+QString PluginManifest::getLibraryState(const PluginDesc& desc) {
+    QFileInfo library(desc.libraryUrl.getURLString());
+    if (!library.exists()) {
+        return QString();
+    }
+    return QString("%1:%2").arg(library.size()).arg(library.lastModified().toMSecsSinceEpoch());
+}
+
+void PluginManifest::addCapability(PluginCapability type, const QString& id) {
+    switch (type) {
+    case PluginCapability_DocumentFormat:
+        formats << id;
+        break;
+    case PluginCapability_WorkflowActor:
+        actors << id;
+        break;
+    case PluginCapability_CmdlineOption:
+        cmdlineOptions << id;
+        break;
+    case PluginCapability_Registry:
+        if (!registries.contains(id)) {
+            registries << id;
+        }
+        break;
+    }
+}
+
+bool PluginManifest::provides(PluginCapability type, const QString& id) const {
+    switch (type) {
+    case PluginCapability_DocumentFormat:
+        return formats.contains(id);
+    case PluginCapability_WorkflowActor:
+        return actors.contains(id);
+    case PluginCapability_CmdlineOption:
+        return cmdlineOptions.contains(id);
+    case PluginCapability_Registry:
+        return registries.contains(id);
+    }
+    return false;
+}
+
+bool PluginManifest::providesAny(PluginCapability type) const {
+    switch (type) {
+    case PluginCapability_DocumentFormat:
+        return !formats.isEmpty();
+    case PluginCapability_WorkflowActor:
+        return !actors.isEmpty();
+    case PluginCapability_CmdlineOption:
+        return !cmdlineOptions.isEmpty();
+    case PluginCapability_Registry:
+        return !registries.isEmpty();
+    }
+    return false;
+}
+
+bool PluginManifest::canBeDeferred() const {
+    // plugins with command line options read the command line in their constructors
+    return !isEmpty() && cmdlineOptions.isEmpty() && registries.isEmpty() && !usesStartUpSignal;
+}
+
+bool PluginManifest::isEmpty() const {
+    return formats.isEmpty() && actors.isEmpty() && cmdlineOptions.isEmpty() && registries.isEmpty();
+}
+
+} // U2
@@ -0,0 +1,73 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_PLUGIN_MANIFEST_H_
+#define _U2_PLUGIN_MANIFEST_H_
+
+#include <U2Core/PluginModel.h>
+
+#include <QtCore/QStringList>
+
+#include "PluginDescriptor.h"
+
+namespace U2 {
+
+/*
+ * Objects registered by a plugin during its initialization.
+ * The manifest is saved when the plugin is loaded and is used in the next runs
+ * to load the plugin only when one of its objects is requested.
+ */
+class PluginManifest {
+public:
+    PluginManifest();
+    PluginManifest(const PluginDesc& desc);
+
+    // returns an empty manifest if there is no saved one or the plugin library has changed
+    static PluginManifest read(const PluginDesc& desc);
+    void write() const;
+
+    // size and modification time of the plugin library
+    static QString getLibraryState(const PluginDesc& desc);
+
+    void addCapability(PluginCapability type, const QString& id);
+    bool provides(PluginCapability type, const QString& id) const;
+    bool providesAny(PluginCapability type) const;
+
+    // the plugin can be loaded on demand if all the objects it registers are known,
+    // it populates no registry that can't load it and it does not need to be initialized at start-up
+    bool canBeDeferred() const;
+
+    bool isEmpty() const;
+
+    bool        usesStartUpSignal;
+
+private:
+    QString     pluginId;
+    QString     libraryState;
+    QStringList formats;
+    QStringList actors;
+    QStringList cmdlineOptions;
+    QStringList registries;
+};
+
+} // U2
+
+#endif // _U2_PLUGIN_MANIFEST_H_
@@ -23,15 +23,20 @@
 #include "ServiceRegistryImpl.h"
 
 #include <U2Core/AppContext.h>
+#include <U2Core/CMDLineCoreOptions.h>
+#include <U2Core/CMDLineRegistry.h>
 #include <U2Core/Settings.h>
 #include <U2Core/Log.h>
 #include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
 #include <U2Core/U2SafePoints.h>
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 #include <QtCore/QLibrary>
 #include <QtCore/QDir>
 #include <QtCore/QSet>
+#include <QtCore/QThread>
 
 #include <U2Gui/MainWindow.h>
 
@@ -47,6 +52,7 @@ namespace U2 {
 #define PLUGINS_LIST_SETTINGS QString("plugin_support/list/")
 #define SKIP_LIST_SETTINGS QString("plugin_support/skip_list/")
 #define PLUGINS_ACCEPTED_LICENSE_LIST QString("plugin_support/accepted_list/")
+#define VERIFIED_PLUGINS_SETTINGS QString("plugin_support/verified/")
 
 QString PluginSupportImpl::versionAppendix("");
 const QString PluginSupportImpl::OPENCL_CHECKED_SETTINGS("plugin_support/opencl/");
@@ -58,7 +64,7 @@ PluginRef::PluginRef(Plugin* _plugin, QLibrary* _library, const PluginDesc& desc
 {
 }
 
-PluginSupportImpl::PluginSupportImpl(bool testingMode): allLoaded(false) {
+PluginSupportImpl::PluginSupportImpl(bool testingMode): allLoaded(false), deferredLock(QMutex::Recursive), loadingManifest(NULL) {
     //read plugin names from settings
     Settings* settings = AppContext::getSettings();
 
@@ -106,6 +112,190 @@ bool PluginSupportImpl::isAllPluginsLoaded() const {
     return allLoaded;
 }
 
+void PluginSupportImpl::addCapability(PluginCapability type, const QString& id) {
+    CHECK(NULL != loadingManifest, );
+    loadingManifest->addCapability(type, id);
+}
+
+bool PluginSupportImpl::loadPluginProviding(PluginCapability type, const QString& id) {
+    const QString pluginId = findDeferredPluginProviding(type, id);
+    CHECK(!pluginId.isEmpty(), false);
+    return loadDeferredPluginFromAnyThread(pluginId);
+}
+
+void PluginSupportImpl::loadPluginsProviding(PluginCapability type) {
+    QStringList pluginIds;
+    {
+        QMutexLocker locker(&deferredLock);
+        foreach (const PluginDesc& desc, deferredPlugins) {
+            if (deferredManifests.value(desc.id).providesAny(type)) {
+                pluginIds << desc.id;
+            }
+        }
+    }
+    foreach (const QString& pluginId, pluginIds) {
+        loadDeferredPluginFromAnyThread(pluginId);
+    }
+}
+
+bool PluginSupportImpl::loadDeferredPluginFromAnyThread(const QString& pluginId) {
+    if (QThread::currentThread() != thread()) {
+        // formats and workflow elements are requested by tasks too: the worker thread waits for the main thread
+        bool loaded = false;
+        QMetaObject::invokeMethod(this, "loadDeferredPluginInMainThread", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(bool, loaded), Q_ARG(QString, pluginId));
+        return loaded;
+    }
+    return loadDeferredPluginInMainThread(pluginId);
+}
+
+QString PluginSupportImpl::findDeferredPluginProviding(PluginCapability type, const QString& id) const {
+    QMutexLocker locker(&deferredLock);
+    foreach (const PluginDesc& desc, deferredPlugins) {
+        if (deferredManifests.value(desc.id).provides(type, id)) {
+            return desc.id;
+        }
+    }
+    return QString();
+}
+
+bool PluginSupportImpl::loadDeferredPluginInMainThread(const QString& pluginId) {
+    QMutexLocker locker(&deferredLock);
+    // another request could load the plugin while this one was waiting
+    CHECK(NULL == findRefById(pluginId), true);
+
+    U2OpStatusImpl os;
+    loadDeferredPlugin(pluginId, os);
+    if (os.hasError()) {
+        coreLog.error(os.getError());
+        return false;
+    }
+    return NULL != findRefById(pluginId);
+}
+
+QList<PluginDesc> PluginSupportImpl::deferPlugins(const QList<PluginDesc>& orderedPlugins) {
+    QMutexLocker locker(&deferredLock);
+    QList<PluginDesc> result;
+    QSet<QString> requiredIds;
+    // dependencies go first in the ordered list: walk backwards to know which plugins the eager ones need
+    for (int i = orderedPlugins.size() - 1; i >= 0; i--) {
+        const PluginDesc& desc = orderedPlugins[i];
+        PluginManifest manifest = PluginManifest::read(desc);
+        if (!requiredIds.contains(desc.id) && manifest.canBeDeferred()) {
+            deferredPlugins.prepend(desc);
+            deferredManifests[desc.id] = manifest;
+            continue;
+        }
+        result.prepend(desc);
+        foreach (const DependsInfo& di, desc.dependsList) {
+            requiredIds.insert(di.id);
+        }
+    }
+    coreLog.trace(QString("Plugins deferred until first use: %1").arg(deferredPlugins.size()));
+    return result;
+}
+
+void PluginSupportImpl::loadDeferredPlugin(const QString& pluginId, U2OpStatus& os) {
+    QMutexLocker locker(&deferredLock);
+    PluginDesc desc;
+    bool found = false;
+    for (int i = 0; i < deferredPlugins.size(); i++) {
+        if (deferredPlugins[i].id == pluginId) {
+            desc = deferredPlugins.takeAt(i);
+            deferredManifests.remove(pluginId);
+            found = true;
+            break;
+        }
+    }
+    CHECK(found, );
+
+    foreach (const DependsInfo& di, desc.dependsList) {
+        loadDeferredPlugin(di.id, os);
+        CHECK_OP(os, );
+    }
+    coreLog.details(tr("Loading plugin on demand: %1").arg(desc.id));
+    loadPlugin(desc, os);
+}
+
+void PluginSupportImpl::loadPlugin(const PluginDesc& desc, U2OpStatus& os) {
+    PluginRef* ref = findRefById(desc.id);
+    if (ref != NULL) {
+        os.setError(tr("Plugin is already loaded: %1").arg(desc.id));
+        return;
+    }
+
+    //check that plugin we depends on is already loaded
+    foreach (const DependsInfo& di, desc.dependsList) {
+        PluginRef* ref = findRefById(di.id);
+        if (ref == NULL) {
+            os.setError(tr("Plugin %1 depends on %2 which is not loaded").arg(desc.id).arg(di.id));
+            return;
+        }
+        if (ref->pluginDesc.pluginVersion < di.version) {
+            os.setError(tr("Plugin %1 depends on %2 which is available, but the version is too old").arg(desc.id).arg(di.id));
+            return;
+        }
+    }
+
+    //load library
+    QString libUrl = desc.libraryUrl.getURLString();
+    QScopedPointer<QLibrary> lib(new QLibrary(libUrl));
+    bool loadOk = lib->load();
+
+    if (!loadOk) {
+        os.setError(tr("Plugin loading error: %1, Error string %2").arg(libUrl).arg(lib->errorString()));
+        return;
+    }
+
+    //instantiate plugin
+    PLUG_INIT_FUNC init_fn = PLUG_INIT_FUNC((lib->resolve(U2_PLUGIN_INIT_FUNC_NAME)));
+    if (!init_fn) {
+        os.setError(tr("Plugin initialization routine was not found: %1").arg(libUrl));
+        return;
+    }
+
+    // remember what the plugin registers to be able to load it on demand in the next runs
+    PluginManifest manifest(desc);
+    PluginManifest* parentManifest = loadingManifest;
+    loadingManifest = &manifest;
+    int startUpReceivers = receivers(SIGNAL(si_allStartUpPluginsLoaded()));
+
+    Plugin* p = init_fn();
+
+    manifest.usesStartUpSignal = receivers(SIGNAL(si_allStartUpPluginsLoaded())) != startUpReceivers;
+    loadingManifest = parentManifest;
+    if (p == NULL) {
+        os.setError(tr("Plugin initialization failed: %1").arg(libUrl));
+        return;
+    }
+    if (!p->getServices().isEmpty()) {
+        // services are registered at start-up
+        manifest.addCapability(PluginCapability_Registry, "ServiceRegistry");
+    }
+    manifest.write();
+
+    p->setId(desc.id);
+    p->setLicensePath(desc.licenseUrl.getURLString());
+
+    if (!p->isFree()){
+        Settings* settings = AppContext::getSettings();
+        QString pluginAcceptedLicenseSettingsDir = settings->toVersionKey(PLUGINS_ACCEPTED_LICENSE_LIST);
+        if(settings->getValue(pluginAcceptedLicenseSettingsDir + versionAppendix + desc.id + "license",false).toBool()){
+            p->acceptLicense();
+        }
+    }
+
+    ref = new PluginRef(p, lib.take(), desc);
+    registerPlugin(ref);
+}
+
+static bool isLazyLoadingEnabled() {
+    CMDLineRegistry* cmdLineRegistry = AppContext::getCMDLineRegistry();
+    CHECK(NULL != cmdLineRegistry, false);
+    // the GUI plugins connect to the main window at start-up, they are always loaded eagerly
+    return NULL == AppContext::getMainWindow() && cmdLineRegistry->hasParameter(CMDLineCoreOptions::LAZY_PLUGINS);
+}
+
 LoadAllPluginsTask::LoadAllPluginsTask(PluginSupportImpl* _ps, const QStringList& _pluginFiles, const QStringList& verifiedPlugins)
 : Task(tr("Loading start up plugins"), TaskFlag_NoRun), ps(_ps), pluginFiles(_pluginFiles), verifiedPlugins(verifiedPlugins)
 {
@@ -141,6 +331,10 @@ void LoadAllPluginsTask::prepare() {
         }
     }
 
+    if (isLazyLoadingEnabled()) {
+        orderedPlugins = ps->deferPlugins(orderedPlugins);
+    }
+
     foreach(const PluginDesc& desc, orderedPlugins) {
         addSubTask(new AddPluginTask(ps, desc));
     }
@@ -307,6 +501,14 @@ void PluginSupportImpl::registerPlugin(PluginRef* ref) {
     plugins.push_back(ref->plugin);
     updateSavedState(ref);
     emit si_pluginAdded(ref->plugin);
+
+    if (allLoaded) {
+        // the plugin is loaded on demand: services of the start-up plugins are already registered
+        ServiceRegistry* sr = AppContext::getServiceRegistry();
+        foreach(Service* s, ref->plugin->getServices()) {
+            AppContext::getTaskScheduler()->registerTopLevelTask(sr->registerServiceTask(s));
+        }
+    }
 }
 
 
@@ -469,68 +671,7 @@ AddPluginTask::AddPluginTask(PluginSupportImpl* _ps, const PluginDesc& _desc)
 }
 
 Task::ReportResult AddPluginTask::report() {
-    PluginRef* ref = ps->findRefById(desc.id);
-    if (ref != NULL) {
-        stateInfo.setError(  tr("Plugin is already loaded: %1").arg(desc.id) );
-        return ReportResult_Finished;
-    }
-
-    //check that plugin we depends on is already loaded
-    foreach (const DependsInfo& di, desc.dependsList) {
-        PluginRef* ref = ps->findRefById(desc.id);
-        if (ref == NULL) {
-            stateInfo.setError(  tr("Plugin %1 depends on %2 which is not loaded").arg(desc.id).arg(di.id) );
-            return ReportResult_Finished;
-        }
-        if (ref->pluginDesc.pluginVersion < di.version) {
-            stateInfo.setError(  tr("Plugin %1 depends on %2 which is available, but the version is too old").arg(desc.id).arg(di.id) );
-            return ReportResult_Finished;
-        }
-    }
-
-    //load library
-    QString libUrl = desc.libraryUrl.getURLString();
-    QScopedPointer<QLibrary> lib(new QLibrary(libUrl));
-    bool loadOk = lib->load();
-
-    if (!loadOk) {
-        stateInfo.setError(  tr("Plugin loading error: %1, Error string %2").arg(libUrl).arg(lib->errorString()) );
-        return ReportResult_Finished;
-    }
-
-    //instantiate plugin
-    PLUG_INIT_FUNC init_fn = PLUG_INIT_FUNC((lib->resolve(U2_PLUGIN_INIT_FUNC_NAME)));
-    if (!init_fn) {
-        stateInfo.setError(  tr("Plugin initialization routine was not found: %1").arg(libUrl) );
-        return ReportResult_Finished;
-    }
-
-    Plugin* p = init_fn();
-    if (p == NULL) {
-        stateInfo.setError(  tr("Plugin initialization failed: %1").arg(libUrl) );
-        return ReportResult_Finished;
-    }
-    p->setId(desc.id);
-    p->setLicensePath(desc.licenseUrl.getURLString());
-
-    if (!p->isFree()){
-        QString versionAppendix = Version::buildDate;
-        if (!Version::appVersion().isDevVersion){
-            versionAppendix.clear();
-        }else{
-            versionAppendix.replace(" ", ".");
-            versionAppendix.append("-");
-        }
-        Settings* settings = AppContext::getSettings();
-        QString pluginAcceptedLicenseSettingsDir = settings->toVersionKey(PLUGINS_ACCEPTED_LICENSE_LIST);
-        if(settings->getValue(pluginAcceptedLicenseSettingsDir + versionAppendix + desc.id + "license",false).toBool()){
-            p->acceptLicense();
-        }
-    }
-
-    ref = new PluginRef(p, lib.take(), desc);
-    ps->registerPlugin(ref);
-
+    ps->loadPlugin(desc, stateInfo);
     return ReportResult_Finished;
 }
 
@@ -554,23 +695,49 @@ void VerifyPluginTask::run() {
         coreLog.error(QString("Can not find file: \"%1\"").arg(openclCheckerPath));
         return;
     }
+
+    // the checker is not run again while neither the plugin nor the checker has changed
+    QFileInfo checkerInfo(openclCheckerPath);
+    QString state = PluginManifest::getLibraryState(desc) + ";" +
+        QString("%1:%2").arg(checkerInfo.size()).arg(checkerInfo.lastModified().toMSecsSinceEpoch());
+    QString verifiedKey = settings->toVersionKey(VERIFIED_PLUGINS_SETTINGS) + desc.id;
+    QVariantMap verified = settings->getValue(verifiedKey).toMap();
+    if (verified.value("state").toString() == state) {
+        pluginIsCorrect = verified.value("correct").toBool();
+        coreLog.trace(QString("Plugin verification result is taken from the cache: %1").arg(desc.id));
+        return;
+    }
+
     proc = new QProcess();
     proc->start(openclCheckerPath, QStringList());
 
     int elapsedTime = 0;
-    while(!proc->waitForFinished(1000) && elapsedTime < timeOut) {
+    bool finished = false;
+    while(!(finished = proc->waitForFinished(1000)) && elapsedTime < timeOut) {
         if(isCanceled()) {
             proc->kill();
         }
         elapsedTime += 1000;
     }
+    if (!finished) {
+        proc->kill();
+        proc->waitForFinished(1000);
+    }
     QString errorMessage = proc->readAllStandardError();
 
-    if(0 != proc->exitCode() || !errorMessage.isEmpty()) {
+    if(!finished || 0 != proc->exitCode() || !errorMessage.isEmpty()) {
         settings->setValue(settings->toVersionKey(SKIP_LIST_SETTINGS) + desc.id, desc.descriptorUrl.getURLString());
     }
     else {
         pluginIsCorrect = true;
     }
+    delete proc;
+    proc = NULL;
+
+    if (!isCanceled()) {
+        verified["state"] = state;
+        verified["correct"] = pluginIsCorrect;
+        settings->setValue(verifiedKey, verified);
+    }
 }
 }//namespace
@@ -28,8 +28,10 @@
 
 #include <QtCore/QLibrary>
 #include <QtCore/QDir>
+#include <QtCore/QMutex>
 
 #include "PluginDescriptor.h"
+#include "PluginManifest.h"
 #include <QtCore/QProcess>
 
 namespace U2 {
@@ -78,11 +80,26 @@ public:
 
     virtual bool isAllPluginsLoaded() const;
 
+    virtual void addCapability(PluginCapability type, const QString& id);
+    virtual bool loadPluginProviding(PluginCapability type, const QString& id);
+    virtual void loadPluginsProviding(PluginCapability type);
+
+    void loadPlugin(const PluginDesc& desc, U2OpStatus& os);
+
+    // removes the plugins that can be loaded on demand from the list and remembers them
+    QList<PluginDesc> deferPlugins(const QList<PluginDesc>& orderedPlugins);
+
     bool allLoaded;
 
 private slots:
     void sl_registerServices();
 
+private:
+    // plugins are initialized in the main thread only, workers wait for it
+    bool loadDeferredPluginFromAnyThread(const QString& pluginId);
+    Q_INVOKABLE bool loadDeferredPluginInMainThread(const QString& pluginId);
+    QString findDeferredPluginProviding(PluginCapability type, const QString& id) const;
+
 protected:
     void registerPlugin(PluginRef* ref);
     QString getPluginFileURL(Plugin* p) const;
@@ -90,11 +107,19 @@ protected:
     void updateSavedState(PluginRef* ref);
     static QSet<QString> getPluginPaths();
 
+    void loadDeferredPlugin(const QString& pluginId, U2OpStatus& os);
+
 private:
     static QString       versionAppendix;
     static const QString OPENCL_CHECKED_SETTINGS;
     QList<PluginRef*>    plugRefs;
     QList<Plugin*>       plugins;
+
+    // guards the deferred plugins, they are looked up from any thread
+    mutable QMutex                  deferredLock;
+    QList<PluginDesc>               deferredPlugins;
+    QMap<QString, PluginManifest>   deferredManifests;
+    PluginManifest*                 loadingManifest;
 };
 
 
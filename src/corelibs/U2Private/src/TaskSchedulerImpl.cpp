@@ -396,6 +396,11 @@ QString TaskSchedulerImpl::tryLockResources(Task* task, bool prepareStage, bool&
         }
 
         bool resourceAcquired = appRes->tryAcquire(taskRes.resourceUse);
+        if (!resourceAcquired && RESOURCE_MEMORY == taskRes.resourceId) {
+            // the memory can be kept for the data that is not used now, e.g. by caches
+            resourcePool->reclaimMemory(taskRes.resourceUse);
+            resourceAcquired = appRes->tryAcquire(taskRes.resourceUse);
+        }
         if (!resourceAcquired) {
             if (appRes->maxTaskUse() < taskRes.resourceUse) {
                 QString error = tr("Not enough resources for the task, resource name: '%1' max: %2%3 requested: %4%5")
@@ -465,12 +470,16 @@ void TaskSchedulerImpl::releaseResources(TaskInfo* ti, bool prepareStage) {
 
 void TaskSchedulerImpl::update() {
     static bool recursion = false;
+    GGAUGE(topLevelTasksGauge, "TaskScheduler::topLevelTasks", "tasks");
+    GGAUGE(queuedTasksGauge, "TaskScheduler::queuedTasks", "tasks");
+    GGAUGE(newTasksGauge, "TaskScheduler::newTasks", "tasks");
 
     if (recursion) {
         return;
     }
     recursion = true;
     stateChangesObserved = false;
+    GTIMER(cvar, tvar, "TaskScheduler::update");
 
     bool finishedFound = processFinishedTasks();
     if (finishedFound) {
@@ -484,6 +493,10 @@ void TaskSchedulerImpl::update() {
 
     updateOldTasksPriority();
 
+    topLevelTasksGauge.set(topLevelTasks.size());
+    queuedTasksGauge.set(priorityQueue.size());
+    newTasksGauge.set(newTasks.size());
+
     if(priorityQueue.isEmpty() && tasksWithNewSubtasks.isEmpty() && newTasks.isEmpty()){
         emit si_noTasksInScheduler();
     }
@@ -1040,6 +1053,7 @@ void TaskThread::run() {
     updateThreadPriority(ti);
     if(!ti->task->hasFlags(TaskFlag_RunMessageLoopOnly)) {
         try {
+            GTIMER(cvar, tvar, "Task::run");
             ti->task->run();
             assert(ti->task->getState()== Task::State_Running);
         } catch (const std::bad_alloc &) {
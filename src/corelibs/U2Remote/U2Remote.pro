@@ -2,6 +2,8 @@ include (U2Remote.pri)
 
 # Input
 HEADERS += src/DistributedComputingUtil.h \
+           src/LocalTask.h \
+           src/LocalTaskDistribution.h \
            src/PingTask.h \
            src/ProtocolInfo.h \
            src/ProtocolUI.h \
@@ -17,11 +19,14 @@ HEADERS += src/DistributedComputingUtil.h \
            src/Serializable.h \
            src/SerializeUtils.h \
            src/SynchHttp.h \
-           src/TaskDistributor.h
+           src/TaskDistributor.h \
+           src/WorkflowDaemonClient.h
 FORMS += src/RemoteMachineMonitorDialog.ui \
          src/RemoteMachineScanDialog.ui \
          src/RemoteMachineSettingsDialog.ui
 SOURCES += src/DistributedComputingUtil.cpp \
+           src/LocalTask.cpp \
+           src/LocalTaskDistribution.cpp \
            src/PingTask.cpp \
            src/ProtocolInfo.cpp \
            src/ProtocolUI.cpp \
@@ -36,7 +41,8 @@ SOURCES += src/DistributedComputingUtil.cpp \
            src/RemoteWorkflowRunTask.cpp \
            src/Serializable.cpp \
            src/SerializeUtils.cpp \
-           src/SynchHttp.cpp
+           src/SynchHttp.cpp \
+           src/WorkflowDaemonClient.cpp
 
 TRANSLATIONS += transl/english.ts \
                 transl/russian.ts
@@ -36,6 +36,7 @@
 #include <U2Gui/MainWindow.h>
 #include <U2Core/QObjectScopedPointer.h>
 
+#include <U2Remote/LocalTask.h>
 #include <U2Remote/PingTask.h>
 #include <U2Remote/RemoteWorkflowRunTask.h>
 #include <U2Remote/SerializeUtils.h>
@@ -58,6 +59,8 @@ DistributedComputingUtil::DistributedComputingUtil() {
     appContext->setProtocolInfoRegistry( pir );
     rmm = new RemoteMachineMonitor();
     appContext->setRemoteMachineMonitor( rmm );
+    ltfr = new LocalTaskFactoryRegistry();
+    appContext->setLocalTaskFactoryRegistry( ltfr );
 
     if( NULL != AppContext::getMainWindow() ) { /* if not congene */
         QAction * showRemoteMachinesMonitor = new QAction( QIcon( ":core/images/remote_machine_monitor.png" ),
@@ -67,6 +70,8 @@ DistributedComputingUtil::DistributedComputingUtil() {
 }
 
 DistributedComputingUtil::~DistributedComputingUtil() {
+    AppContextImpl::getApplicationContext()->setLocalTaskFactoryRegistry( NULL );
+    delete ltfr;
     delete rmm;
     delete pir;
 }
@@ -29,6 +29,7 @@
 
 namespace U2 {
 
+class LocalTaskFactoryRegistry;
 class PingTask;
 
 class U2REMOTE_EXPORT DistributedComputingUtil : public QObject {
@@ -47,6 +48,7 @@ private:
     /* pointers here to manage object creation order */
     ProtocolInfoRegistry *        pir;
     RemoteMachineMonitor *        rmm;
+    LocalTaskFactoryRegistry *    ltfr;
 
 }; // DistributedComputingUtil
 
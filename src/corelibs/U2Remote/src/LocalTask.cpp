@@ -0,0 +1,86 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "LocalTask.h"
+
+namespace U2 {
+
+/*****************************
+ * LocalTaskSettings
+ *****************************/
+LocalTaskSettings::~LocalTaskSettings() {
+}
+
+/*****************************
+ * LocalTaskResult
+ *****************************/
+LocalTaskResult::~LocalTaskResult() {
+}
+
+/*****************************
+ * LocalTask
+ *****************************/
+LocalTask::LocalTask( const QString &name, TaskFlags flags )
+: Task( name, flags ) {
+}
+
+/*****************************
+ * LocalTaskFactory
+ *****************************/
+LocalTaskFactory::LocalTaskFactory( const QString &id )
+: id( id ) {
+}
+
+LocalTaskFactory::~LocalTaskFactory() {
+}
+
+const QString & LocalTaskFactory::getId() const {
+    return id;
+}
+
+/*****************************
+ * LocalTaskFactoryRegistry
+ *****************************/
+LocalTaskFactoryRegistry::~LocalTaskFactoryRegistry() {
+    qDeleteAll( factories );
+}
+
+bool LocalTaskFactoryRegistry::registerLocalTaskFactory( LocalTaskFactory *factory ) {
+    if( NULL == factory || factories.contains( factory->getId() ) ) {
+        return false;
+    }
+    factories.insert( factory->getId(), factory );
+    return true;
+}
+
+LocalTaskFactory * LocalTaskFactoryRegistry::unregisterLocalTaskFactory( const QString &id ) {
+    return factories.take( id );
+}
+
+LocalTaskFactory * LocalTaskFactoryRegistry::getLocalTaskFactory( const QString &id ) const {
+    return factories.value( id, NULL );
+}
+
+QList< LocalTaskFactory * > LocalTaskFactoryRegistry::getLocalTaskFactories() const {
+    return factories.values();
+}
+
+} // U2
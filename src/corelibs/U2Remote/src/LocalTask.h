@@ -0,0 +1,136 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_LOCAL_TASK_H_
+#define _U2_LOCAL_TASK_H_
+
+#include <QtCore/QMap>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVariant>
+
+#include <U2Core/Task.h>
+
+#include "Serializable.h"
+
+namespace U2 {
+
+class TaskDistributor;
+
+/*
+ * Settings of a task that can be sent to another UGENE process
+ */
+class U2REMOTE_EXPORT LocalTaskSettings : public Serializable {
+public:
+    virtual ~LocalTaskSettings();
+
+}; // LocalTaskSettings
+
+/*
+ * Result of a task that can be sent back from another UGENE process
+ */
+class U2REMOTE_EXPORT LocalTaskResult : public Serializable {
+public:
+    virtual ~LocalTaskResult();
+
+}; // LocalTaskResult
+
+/*
+ * Task created out of the serialized settings in a worker process
+ */
+class U2REMOTE_EXPORT LocalTask : public Task {
+    Q_OBJECT
+public:
+    LocalTask( const QString &name, TaskFlags flags );
+
+    /* NULL if the task has failed */
+    virtual const LocalTaskResult * getResult() const = 0;
+
+}; // LocalTask
+
+class U2REMOTE_EXPORT LocalTaskFactory {
+public:
+    LocalTaskFactory( const QString &id );
+    virtual ~LocalTaskFactory();
+
+    const QString & getId() const;
+
+    /* worker side: returns NULL if the settings can't be deserialized */
+    virtual LocalTask * createInstance( const QVariant &serializedSettings ) const = 0;
+    /* master side: returns NULL if the result can't be deserialized */
+    virtual LocalTaskResult * createResult( const QVariant &serializedResult ) const = 0;
+    virtual const TaskDistributor * getDistributor() const = 0;
+
+private:
+    QString id;
+
+}; // LocalTaskFactory
+
+/*
+ * Template to LocalTaskFactory. TaskT must be constructible from const SettingsT &
+ */
+template<class TaskT, class SettingsT, class ResultT, class DistributorT>
+class LocalTaskFactoryTemplate : public LocalTaskFactory {
+public:
+    LocalTaskFactoryTemplate( const QString &id ) : LocalTaskFactory( id ) {}
+
+    virtual LocalTask * createInstance( const QVariant &serializedSettings ) const {
+        SettingsT settings;
+        if( !settings.deserialize( serializedSettings ) ) {
+            return NULL;
+        }
+        return new TaskT( settings );
+    }
+
+    virtual LocalTaskResult * createResult( const QVariant &serializedResult ) const {
+        QScopedPointer<ResultT> result( new ResultT() );
+        if( !result->deserialize( serializedResult ) ) {
+            return NULL;
+        }
+        return result.take();
+    }
+
+    virtual const TaskDistributor * getDistributor() const {
+        return &distributor;
+    }
+
+private:
+    DistributorT distributor;
+
+}; // LocalTaskFactoryTemplate
+
+class U2REMOTE_EXPORT LocalTaskFactoryRegistry {
+public:
+    ~LocalTaskFactoryRegistry();
+
+    /* the registry takes ownership of the factory */
+    bool registerLocalTaskFactory( LocalTaskFactory *factory );
+    LocalTaskFactory * unregisterLocalTaskFactory( const QString &id );
+    LocalTaskFactory * getLocalTaskFactory( const QString &id ) const;
+    QList< LocalTaskFactory * > getLocalTaskFactories() const;
+
+private:
+    QMap< QString, LocalTaskFactory * > factories;
+
+}; // LocalTaskFactoryRegistry
+
+} // U2
+
+#endif // _U2_LOCAL_TASK_H_
@@ -0,0 +1,339 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/Log.h>
+#include <U2Core/Settings.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Lang/WorkflowSettings.h>
+
+#include "LocalTaskDistribution.h"
+#include "TaskDistributor.h"
+
+namespace U2 {
+
+#define WORKER_CONNECT_TIMEOUT_MS 30000
+#define WORKER_STOP_TIMEOUT_MS 5000
+
+/*****************************
+ * LocalTaskChannel
+ *****************************/
+bool LocalTaskChannel::writeMessage( QIODevice *device, const QVariant &message ) {
+    QByteArray data;
+    {
+        QDataStream stream( &data, QIODevice::WriteOnly );
+        stream << quint32( 0 ) << message;
+        stream.device()->seek( 0 );
+        stream << quint32( data.size() - sizeof( quint32 ) );
+    }
+    return data.size() == device->write( data );
+}
+
+bool LocalTaskChannel::takeMessage( QByteArray &buffer, QVariant &message ) {
+    CHECK( buffer.size() >= (int)sizeof( quint32 ), false );
+    quint32 size = 0;
+    {
+        QDataStream stream( buffer );
+        stream >> size;
+    }
+    CHECK( (quint64)buffer.size() >= sizeof( quint32 ) + size, false );
+
+    QDataStream stream( buffer.mid( sizeof( quint32 ), size ) );
+    stream >> message;
+    if( QDataStream::Ok != stream.status() ) {
+        message = QVariant();
+    }
+    buffer.remove( 0, sizeof( quint32 ) + size );
+    return true;
+}
+
+bool LocalTaskChannel::readMessage( QLocalSocket *socket, QByteArray &buffer, QVariant &message ) {
+    while( !takeMessage( buffer, message ) ) {
+        if( 0 == socket->bytesAvailable() && !socket->waitForReadyRead( -1 ) ) {
+            return false;
+        }
+        buffer.append( socket->readAll() );
+    }
+    return true;
+}
+
+/*****************************
+ * LocalTaskDistributionTask
+ *****************************/
+LocalTaskDistributionTask::LocalTaskDistributionTask( const QString &factoryId, LocalTaskSettings *settings, int processCount )
+: Task( tr( "Run task in %1 processes" ).arg( processCount ), TaskFlag_NoRun ), factoryId( factoryId ), settings( settings ),
+processCount( qMax( 1, processCount ) ), factory( NULL ), server( NULL ), nextPart( 0 ), partsDone( 0 ), result( NULL ) {
+    tpm = Progress_Manual;
+}
+
+LocalTaskDistributionTask::~LocalTaskDistributionTask() {
+    stopWorkers();
+    qDeleteAll( partResults );
+    delete result;
+    delete settings;
+}
+
+int LocalTaskDistributionTask::getDefaultProcessCount() {
+    return AppResourcePool::instance()->getIdealThreadCount();
+}
+
+const LocalTaskResult * LocalTaskDistributionTask::getResult() const {
+    return result;
+}
+
+void LocalTaskDistributionTask::prepare() {
+    factory = AppContext::getLocalTaskFactoryRegistry()->getLocalTaskFactory( factoryId );
+    CHECK_EXT( NULL != factory, setError( tr( "Unknown local task factory: %1" ).arg( factoryId ) ), );
+    const QString ugenePath = WorkflowSettings::getCmdlineUgenePath();
+    CHECK_EXT( !ugenePath.isEmpty(), setError( tr( "Command line UGENE is not found, the task can't be run in separate processes" ) ), );
+
+    QList< LocalTaskSettings * > scatteredSettings = factory->getDistributor()->scatter( settings, processCount );
+    CHECK_EXT( !scatteredSettings.isEmpty(), setError( tr( "The task settings can't be split into parts" ) ), );
+    foreach( LocalTaskSettings *part, scatteredSettings ) {
+        parts << part->serialize();
+    }
+    qDeleteAll( scatteredSettings );
+    partResults.fill( NULL, parts.size() );
+
+    server = new QLocalServer( this );
+    connect( server, SIGNAL( newConnection() ), SLOT( sl_newConnection() ) );
+    const QString serverName = QString( "ugene_local_task_%1_%2" ).arg( QCoreApplication::applicationPid() ).arg( getTaskId() );
+    QLocalServer::removeServer( serverName );
+    // the parts may contain user data, other users must not be able to connect
+    server->setSocketOptions( QLocalServer::UserAccessOption );
+    CHECK_EXT( server->listen( serverName ), setError( tr( "Can't start the local server: %1" ).arg( server->errorString() ) ), );
+
+    const int workersCount = qMin( processCount, parts.size() );
+    for( int i = 0; i < workersCount; i++ ) {
+        startWorker( ugenePath );
+    }
+    stateInfo.setDescription( tr( "Running %1 parts in %2 processes" ).arg( parts.size() ).arg( workersCount ) );
+}
+
+void LocalTaskDistributionTask::startWorker( const QString &ugenePath ) {
+    QStringList args;
+    args << QString( "--%1=%2" ).arg( LocalTaskWorkerTask::SERVER_CMDLINE_OPTION ).arg( server->fullServerName() );
+    args << QString( "--ini-file=%1" ).arg( AppContext::getSettings()->fileName() );
+    args << "--lang=en";
+    args << "--log-level-error";
+
+    // the output is not read, it must not fill the pipe buffers
+    QProcess *process = new QProcess( this );
+    process->setStandardOutputFile( QProcess::nullDevice() );
+    process->setStandardErrorFile( QProcess::nullDevice() );
+    connect( process, SIGNAL( finished( int, QProcess::ExitStatus ) ), SLOT( sl_processFinished( int, QProcess::ExitStatus ) ) );
+    connect( process, SIGNAL( error( QProcess::ProcessError ) ), SLOT( sl_processError( QProcess::ProcessError ) ) );
+    processes << process;
+
+    rsLog.details( tr( "Starting worker process: %1 %2" ).arg( ugenePath ).arg( args.join( " " ) ) );
+    process->start( ugenePath, args );
+}
+
+void LocalTaskDistributionTask::sl_newConnection() {
+    while( server->hasPendingConnections() ) {
+        QLocalSocket *socket = server->nextPendingConnection();
+        connect( socket, SIGNAL( readyRead() ), SLOT( sl_readyRead() ) );
+        buffers.insert( socket, QByteArray() );
+        sendNextPart( socket );
+    }
+}
+
+void LocalTaskDistributionTask::sl_readyRead() {
+    QLocalSocket *socket = qobject_cast< QLocalSocket * >( sender() );
+    SAFE_POINT( NULL != socket && buffers.contains( socket ), "Unexpected sender", );
+
+    QByteArray &buffer = buffers[socket];
+    buffer.append( socket->readAll() );
+    QVariant reply;
+    while( LocalTaskChannel::takeMessage( buffer, reply ) ) {
+        processReply( reply );
+        sendNextPart( socket );
+    }
+}
+
+void LocalTaskDistributionTask::sendNextPart( QLocalSocket *socket ) {
+    // an empty message stops the worker
+    QVariantList message;
+    if( nextPart < parts.size() && !isCanceled() && !hasError() ) {
+        message << factoryId << nextPart << parts[nextPart];
+        parts[nextPart] = QVariant();
+        nextPart++;
+    }
+    LocalTaskChannel::writeMessage( socket, message );
+}
+
+void LocalTaskDistributionTask::processReply( const QVariant &reply ) {
+    const QVariantList message = reply.toList();
+    CHECK_EXT( 3 == message.size(), setError( tr( "Unexpected reply of a worker process" ) ), );
+    bool ok = false;
+    const int part = message[0].toInt( &ok );
+    CHECK_EXT( ok && 0 <= part && part < partResults.size() && NULL == partResults[part],
+        setError( tr( "Unexpected reply of a worker process" ) ), );
+    const QString error = message[1].toString();
+    CHECK_EXT( error.isEmpty(), setError( error ), );
+
+    LocalTaskResult *partResult = factory->createResult( message[2] );
+    CHECK_EXT( NULL != partResult, setError( tr( "Can't read the result of the part %1" ).arg( part + 1 ) ), );
+    partResults[part] = partResult;
+    partsDone++;
+    stateInfo.progress = 100 * partsDone / partResults.size();
+}
+
+void LocalTaskDistributionTask::sl_processFinished( int exitCode, QProcess::ExitStatus exitStatus ) {
+    CHECK( partsDone < partResults.size(), );
+    if( QProcess::NormalExit != exitStatus || 0 != exitCode ) {
+        setError( tr( "A worker process has finished unexpectedly with the exit code %1" ).arg( exitCode ) );
+    }
+}
+
+void LocalTaskDistributionTask::sl_processError( QProcess::ProcessError error ) {
+    CHECK( QProcess::FailedToStart == error, );
+    setError( tr( "The worker process failed to start. Either the invoked program is missing, "
+        "or you may have insufficient permissions to invoke the program" ) );
+}
+
+Task::ReportResult LocalTaskDistributionTask::report() {
+    if( !hasError() && !isCanceled() ) {
+        if( partsDone < partResults.size() ) {
+            foreach( QProcess *process, processes ) {
+                if( QProcess::NotRunning != process->state() ) {
+                    return ReportResult_CallMeAgain;
+                }
+            }
+            setError( tr( "Worker processes have finished before all parts were processed" ) );
+        } else {
+            gatherResults();
+        }
+    }
+    stopWorkers();
+    return ReportResult_Finished;
+}
+
+void LocalTaskDistributionTask::gatherResults() {
+    result = factory->getDistributor()->gather( partResults.toList() );
+    qDeleteAll( partResults );
+    partResults.clear();
+    CHECK_EXT( NULL != result, setError( tr( "Can't gather the results of the parts" ) ), );
+}
+
+void LocalTaskDistributionTask::stopWorkers() {
+    if( NULL != server ) {
+        server->close();
+    }
+    const bool finished = !hasError() && !isCanceled();
+    foreach( QProcess *process, processes ) {
+        process->disconnect( this );
+        if( QProcess::NotRunning == process->state() ) {
+            continue;
+        }
+        // the workers have received the stop messages and are expected to exit by themselves
+        if( !finished || !process->waitForFinished( WORKER_STOP_TIMEOUT_MS ) ) {
+            process->kill();
+            process->waitForFinished();
+        }
+    }
+    qDeleteAll( processes );
+    processes.clear();
+}
+
+/*****************************
+ * LocalTaskWorkerTask
+ *****************************/
+const QString LocalTaskWorkerTask::SERVER_CMDLINE_OPTION( "local-task-server" );
+
+LocalTaskWorkerTask::LocalTaskWorkerTask( const QString &serverName )
+: Task( tr( "Local task worker" ), TaskFlag_NoRun ), serverName( serverName ), socket( NULL ), currentPart( -1 ) {
+}
+
+LocalTaskWorkerTask::~LocalTaskWorkerTask() {
+}
+
+void LocalTaskWorkerTask::prepare() {
+    socket = new QLocalSocket( this );
+    socket->connectToServer( serverName );
+    CHECK_EXT( socket->waitForConnected( WORKER_CONNECT_TIMEOUT_MS ),
+        setError( tr( "Can't connect to the master process: %1" ).arg( socket->errorString() ) ), );
+
+    LocalTask *task = receiveNextPart();
+    CHECK( NULL != task, );
+    addSubTask( task );
+}
+
+QList<Task *> LocalTaskWorkerTask::onSubTaskFinished( Task *subTask ) {
+    QList<Task *> res;
+    LocalTask *localTask = qobject_cast< LocalTask * >( subTask );
+    SAFE_POINT( NULL != localTask, "Unexpected subtask", res );
+
+    if( localTask->hasError() ) {
+        sendReply( localTask->getError(), QVariant() );
+    } else if( localTask->isCanceled() || NULL == localTask->getResult() ) {
+        sendReply( tr( "The task of the part %1 is not finished" ).arg( currentPart + 1 ), QVariant() );
+    } else {
+        sendReply( QString(), localTask->getResult()->serialize() );
+    }
+    CHECK_OP( stateInfo, res );
+
+    LocalTask *next = receiveNextPart();
+    if( NULL != next ) {
+        res << next;
+    }
+    return res;
+}
+
+LocalTask * LocalTaskWorkerTask::receiveNextPart() {
+    QVariant message;
+    CHECK_EXT( LocalTaskChannel::readMessage( socket, buffer, message ),
+        setError( tr( "The connection to the master process is lost" ) ), NULL );
+    const QVariantList parts = message.toList();
+    CHECK( !parts.isEmpty(), NULL ); // no more parts
+    CHECK_EXT( 3 == parts.size(), setError( tr( "Unexpected message of the master process" ) ), NULL );
+
+    const QString factoryId = parts[0].toString();
+    currentPart = parts[1].toInt();
+    LocalTaskFactory *factory = AppContext::getLocalTaskFactoryRegistry()->getLocalTaskFactory( factoryId );
+    if( NULL == factory ) {
+        sendReply( tr( "Unknown local task factory: %1" ).arg( factoryId ), QVariant() );
+        return NULL;
+    }
+    LocalTask *task = factory->createInstance( parts[2] );
+    if( NULL == task ) {
+        sendReply( tr( "Can't read the settings of the part %1" ).arg( currentPart + 1 ), QVariant() );
+    }
+    return task;
+}
+
+void LocalTaskWorkerTask::sendReply( const QString &error, const QVariant &serializedResult ) {
+    QVariantList message;
+    message << currentPart << error << serializedResult;
+    CHECK_EXT( LocalTaskChannel::writeMessage( socket, message ), setError( tr( "The connection to the master process is lost" ) ), );
+    while( socket->bytesToWrite() > 0 ) {
+        CHECK_EXT( socket->waitForBytesWritten( -1 ), setError( tr( "The connection to the master process is lost" ) ), );
+    }
+}
+
+} // U2
@@ -0,0 +1,128 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_LOCAL_TASK_DISTRIBUTION_H_
+#define _U2_LOCAL_TASK_DISTRIBUTION_H_
+
+#include <QtCore/QMap>
+#include <QtCore/QProcess>
+#include <QtCore/QVector>
+
+#include "LocalTask.h"
+
+class QIODevice;
+class QLocalServer;
+class QLocalSocket;
+
+namespace U2 {
+
+class LocalTaskFactory;
+
+/*
+ * Messages exchanged by the master and the worker processes: QVariants prefixed with their size
+ */
+class U2REMOTE_EXPORT LocalTaskChannel {
+public:
+    static bool writeMessage( QIODevice *device, const QVariant &message );
+    /* takes the first complete message out of the buffer, returns false if there is no such one */
+    static bool takeMessage( QByteArray &buffer, QVariant &message );
+    /* blocks until a message is received. returns false if the socket is closed */
+    static bool readMessage( QLocalSocket *socket, QByteArray &buffer, QVariant &message );
+
+}; // LocalTaskChannel
+
+/*
+ * Scatters the settings with the factory's distributor, runs the parts in 'ugenecl' worker processes
+ * started on this machine and gathers the results. This allows to load all cores with algorithms
+ * that are not thread-safe or that need too much memory to be run in threads of one process.
+ */
+class U2REMOTE_EXPORT LocalTaskDistributionTask : public Task {
+    Q_OBJECT
+public:
+    /* the task takes ownership of the settings */
+    LocalTaskDistributionTask( const QString &factoryId, LocalTaskSettings *settings, int processCount = getDefaultProcessCount() );
+    ~LocalTaskDistributionTask();
+
+    virtual void prepare();
+    virtual ReportResult report();
+
+    /* the gathered result, it is owned by the task */
+    const LocalTaskResult * getResult() const;
+
+    static int getDefaultProcessCount();
+
+private slots:
+    void sl_newConnection();
+    void sl_readyRead();
+    void sl_processFinished( int exitCode, QProcess::ExitStatus exitStatus );
+    void sl_processError( QProcess::ProcessError error );
+
+private:
+    void startWorker( const QString &ugenePath );
+    void sendNextPart( QLocalSocket *socket );
+    void processReply( const QVariant &reply );
+    void gatherResults();
+    void stopWorkers();
+
+    QString                         factoryId;
+    LocalTaskSettings *             settings;
+    int                             processCount;
+    const LocalTaskFactory *        factory;
+    QLocalServer *                  server;
+    QList< QProcess * >             processes;
+    QList< QVariant >               parts;
+    int                             nextPart;
+    int                             partsDone;
+    QMap< QLocalSocket *, QByteArray >  buffers;
+    QVector< LocalTaskResult * >    partResults;
+    LocalTaskResult *               result;
+
+}; // LocalTaskDistributionTask
+
+/*
+ * Runs the parts received from the master process one by one and sends their results back
+ */
+class U2REMOTE_EXPORT LocalTaskWorkerTask : public Task {
+    Q_OBJECT
+public:
+    static const QString SERVER_CMDLINE_OPTION;
+
+    LocalTaskWorkerTask( const QString &serverName );
+    ~LocalTaskWorkerTask();
+
+    virtual void prepare();
+    virtual QList<Task *> onSubTaskFinished( Task *subTask );
+
+private:
+    /* returns NULL if there are no more parts */
+    LocalTask * receiveNextPart();
+    void sendReply( const QString &error, const QVariant &serializedResult );
+
+    QString         serverName;
+    QLocalSocket *  socket;
+    QByteArray      buffer;
+    int             currentPart;
+
+}; // LocalTaskWorkerTask
+
+} // U2
+
+#endif // _U2_LOCAL_TASK_DISTRIBUTION_H_
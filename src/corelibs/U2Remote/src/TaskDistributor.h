@@ -34,10 +34,10 @@ namespace U2 {
 class U2REMOTE_EXPORT TaskDistributor {
 public:
     virtual ~TaskDistributor(){}
-    /*scatters task settings to some number of parts
-      returns new allocated settings */
-    virtual QList<LocalTaskSettings *> scatter( const LocalTaskSettings * settings)const = 0;
-    /* returns new allocated results */
+    /*scatters task settings to at most partCount parts
+      returns new allocated settings, an empty list means that the settings can't be scattered */
+    virtual QList<LocalTaskSettings *> scatter( const LocalTaskSettings * settings, int partCount )const = 0;
+    /* results are in the order of the scattered parts. returns new allocated results */
     virtual LocalTaskResult * gather(const QList<LocalTaskResult *> &results)const = 0;
 
 }; // TaskDistributor
@@ -46,17 +46,17 @@ public:
  * Template to TaskDistributor. Makes it easier to write own TaskDistributor implementation.
  */
 template<class SettingsT, class ResultT>
-class U2REMOTE_EXPORT TaskDistributorTemplate : public TaskDistributor {
+class TaskDistributorTemplate : public TaskDistributor {
 public:
-    virtual QList<LocalTaskSettings *> scatter( LocalTaskSettings * settings)const
+    virtual QList<LocalTaskSettings *> scatter( const LocalTaskSettings * settings, int partCount )const
     {
-        SettingsT *castedSettings = dynamic_cast<SettingsT *>(settings);
+        const SettingsT *castedSettings = dynamic_cast<const SettingsT *>(settings);
         if(NULL == castedSettings)
         {
             return QList<LocalTaskSettings *>();
         }
         QList<LocalTaskSettings *> settingsList;
-        foreach(SettingsT *settings, scatter(castedSettings))
+        foreach(SettingsT *settings, scatterParts(castedSettings, partCount))
         {
             settingsList.append(settings);
         }
@@ -64,21 +64,22 @@ public:
     }
     virtual LocalTaskResult *gather(const QList<LocalTaskResult *> &results)const
     {
-        QList<ResultT *> castedResults;
+        QList<const ResultT *> castedResults;
         foreach(LocalTaskResult *result, results)
         {
-            ResultT *castedResult = dynamic_cast<ResultT *>(result);
+            const ResultT *castedResult = dynamic_cast<const ResultT *>(result);
             if(NULL == castedResult)
             {
                 return NULL;
             }
             castedResults.append(castedResult);
         }
-        return gather(castedResults);
+        return gatherParts(castedResults);
     }
 
-    virtual QList<SettingsT *> scatter(const SettingsT *settings)const = 0;
-    virtual ResultT *gather(const QList<const ResultT *> &results)const = 0;
+protected:
+    virtual QList<SettingsT *> scatterParts(const SettingsT *settings, int partCount)const = 0;
+    virtual ResultT *gatherParts(const QList<const ResultT *> &results)const = 0;
 
 }; // TaskDistributorTemplate
 
@@ -0,0 +1,75 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QVariantMap>
+#include <QtNetwork/QLocalSocket>
+
+#include "LocalTaskDistribution.h"
+#include "WorkflowDaemonClient.h"
+
+namespace U2 {
+
+#define DAEMON_CONNECT_TIMEOUT_MS 30000
+
+const QString WorkflowDaemonClient::ARGS( "args" );
+const QString WorkflowDaemonClient::DIR( "dir" );
+const QString WorkflowDaemonClient::PROGRESS( "progress" );
+const QString WorkflowDaemonClient::FINISHED( "finished" );
+const QString WorkflowDaemonClient::ERROR_MESSAGE( "error" );
+
+int WorkflowDaemonClient::submit( const QString &serverName, const QStringList &args, const QString &workingDir ) {
+    QLocalSocket socket;
+    socket.connectToServer( serverName );
+    if( !socket.waitForConnected( DAEMON_CONNECT_TIMEOUT_MS ) ) {
+        fprintf( stderr, "Can't connect to the UGENE server '%s': %s\n", qPrintable( serverName ), qPrintable( socket.errorString() ) );
+        return 1;
+    }
+
+    QVariantMap request;
+    request[ARGS] = args;
+    request[DIR] = workingDir;
+    LocalTaskChannel::writeMessage( &socket, request );
+    socket.flush();
+
+    QByteArray buffer;
+    QVariant message;
+    int progress = -1;
+    while( LocalTaskChannel::readMessage( &socket, buffer, message ) ) {
+        const QVariantMap reply = message.toMap();
+        if( reply.value( FINISHED ).toBool() ) {
+            const QString error = reply.value( ERROR_MESSAGE ).toString();
+            if( !error.isEmpty() ) {
+                fprintf( stderr, "%s\n", qPrintable( error ) );
+                return 1;
+            }
+            return 0;
+        }
+        if( reply.contains( PROGRESS ) && reply.value( PROGRESS ).toInt() != progress ) {
+            progress = reply.value( PROGRESS ).toInt();
+            fprintf( stdout, "task-progress=%d\n", progress );
+            fflush( stdout );
+        }
+    }
+    fprintf( stderr, "The connection to the UGENE server is lost\n" );
+    return 1;
+}
+
+} // U2
@@ -0,0 +1,53 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_WORKFLOW_DAEMON_CLIENT_H_
+#define _U2_WORKFLOW_DAEMON_CLIENT_H_
+
+#include <QtCore/QStringList>
+
+#include <U2Core/global.h>
+
+namespace U2 {
+
+/*
+ * Submits a workflow to the 'ugenecl --daemon' server and waits for its result.
+ * The client does not need the initialized application context: it is run instead of the usual 'ugenecl' start-up.
+ * The messages are sent with LocalTaskChannel:
+ * request - { ARGS: <command line of the workflow run>, DIR: <folder for relative paths> },
+ * replies - { PROGRESS: <percent> } while the workflow is running and { FINISHED: true, ERROR: <error> } in the end.
+ */
+class U2REMOTE_EXPORT WorkflowDaemonClient {
+public:
+    static const QString ARGS;
+    static const QString DIR;
+    static const QString PROGRESS;
+    static const QString FINISHED;
+    static const QString ERROR_MESSAGE;
+
+    /* prints the progress to stdout and the error to stderr, returns the process exit code */
+    static int submit( const QString &serverName, const QStringList &args, const QString &workingDir );
+
+}; // WorkflowDaemonClient
+
+} // U2
+
+#endif // _U2_WORKFLOW_DAEMON_CLIENT_H_
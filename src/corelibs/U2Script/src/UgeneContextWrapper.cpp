@@ -306,7 +306,7 @@ UgeneContextWrapper::UgeneContextWrapper( const QString &workingDirectoryPath )
     appContext->setDataPathRegistry( dpr );
 
     GReportableCounter launchCounter( "U2Script is ready", "", 1 );
-    ++launchCounter.totalCount;
+    launchCounter.add();
 
     t1.stop( );
     QObject::connect( psp, SIGNAL( si_allStartUpPluginsLoaded( ) ), &app, SLOT( quit( ) ) );
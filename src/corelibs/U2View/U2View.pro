@@ -60,6 +60,7 @@ HEADERS += src/LicenseDialog.h \
            src/ov_msa/MSAEditorConsensusCache.h \
            src/ov_msa/MsaEditorSimilarityColumn.h \
            src/ov_msa/MSAEditorFactory.h \
+           src/ov_msa/MSAEditorGlyphCache.h \
            src/ov_msa/MSAEditorNameList.h \
            src/ov_msa/MSAEditorOffsetsView.h \
            src/ov_msa/MSAEditorOverviewArea.h \
@@ -281,6 +282,7 @@ SOURCES += src/LicenseDialog.cpp \
            src/ov_msa/MSAEditorConsensusCache.cpp \
            src/ov_msa/MsaEditorSimilarityColumn.cpp \
            src/ov_msa/MSAEditorFactory.cpp \
+           src/ov_msa/MSAEditorGlyphCache.cpp \
            src/ov_msa/MSAEditorNameList.cpp \
            src/ov_msa/MSAEditorOffsetsView.cpp \
            src/ov_msa/MSAEditorOverviewArea.cpp \
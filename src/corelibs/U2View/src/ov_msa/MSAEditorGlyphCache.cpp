@@ -0,0 +1,75 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtGui/QPainter>
+
+#include "MSAEditorGlyphCache.h"
+
+namespace U2 {
+
+const int MSAEditorGlyphCache::FIRST_GLYPH = ' ';
+const int MSAEditorGlyphCache::LAST_GLYPH = '~';
+const int MSAEditorGlyphCache::ATLAS_COLUMNS = 16;
+
+MSAEditorGlyphCache::MSAEditorGlyphCache()
+    : cellWidth(0), cellHeight(0)
+{
+
+}
+
+void MSAEditorGlyphCache::update(const QFont &newFont, int newCellWidth, int newCellHeight) {
+    if (!atlas.isNull() && font == newFont && cellWidth == newCellWidth && cellHeight == newCellHeight) {
+        return;
+    }
+    font = newFont;
+    cellWidth = newCellWidth;
+    cellHeight = newCellHeight;
+
+    // the sequence area cells overlap by one pixel, the glyphs are laid out in the same rectangles
+    const int glyphsCount = LAST_GLYPH - FIRST_GLYPH + 1;
+    const int rows = (glyphsCount + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    atlas = QPixmap(ATLAS_COLUMNS * (cellWidth + 1), rows * cellHeight);
+    atlas.fill(Qt::transparent);
+
+    QPainter p(&atlas);
+    p.setPen(Qt::black);
+    p.setFont(font);
+    for (int c = FIRST_GLYPH; c <= LAST_GLYPH; c++) {
+        p.drawText(getGlyphRect(c), Qt::AlignCenter, QString(QChar(c)));
+    }
+}
+
+void MSAEditorGlyphCache::drawGlyph(QPainter &p, int x, int y, char c) const {
+    const QRect cell(x, y, cellWidth + 1, cellHeight);
+    if (c < FIRST_GLYPH || c > LAST_GLYPH || atlas.isNull()) {
+        p.drawText(cell, Qt::AlignCenter, QString(c));
+        return;
+    }
+    p.drawPixmap(cell.topLeft(), atlas, getGlyphRect(c));
+}
+
+QRect MSAEditorGlyphCache::getGlyphRect(char c) const {
+    const int index = c - FIRST_GLYPH;
+    return QRect((index % ATLAS_COLUMNS) * (cellWidth + 1), (index / ATLAS_COLUMNS) * cellHeight, cellWidth + 1, cellHeight);
+}
+
+}   // namespace U2
@@ -0,0 +1,64 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_MSA_EDITOR_GLYPH_CACHE_H_
+#define _U2_MSA_EDITOR_GLYPH_CACHE_H_
+
+#include <QtGui/QFont>
+#include <QtGui/QPixmap>
+
+class QPainter;
+
+namespace U2 {
+
+/**
+ * Pre-rendered symbols of the alignment.
+ * All printable symbols are drawn once into an atlas for the current font and cell size,
+ * then the sequence area copies them into cells instead of laying out the text for every cell.
+ * The atlas is rendered with the device pixel ratio 1, so it is used for the on-screen view only.
+ */
+class MSAEditorGlyphCache {
+public:
+    MSAEditorGlyphCache();
+
+    /** Re-renders the atlas if the font or the cell size differ from the cached ones */
+    void update(const QFont &font, int cellWidth, int cellHeight);
+
+    /** Draws the symbol into the cell with the top left corner in (x, y) */
+    void drawGlyph(QPainter &p, int x, int y, char c) const;
+
+private:
+    QRect getGlyphRect(char c) const;
+
+    static const int FIRST_GLYPH;
+    static const int LAST_GLYPH;
+    static const int ATLAS_COLUMNS;
+
+    QFont   font;
+    int     cellWidth;
+    int     cellHeight;
+    QPixmap atlas;
+};
+
+}   // namespace U2
+
+#endif // _U2_MSA_EDITOR_GLYPH_CACHE_H_
@@ -750,55 +750,74 @@ bool MSAEditorSequenceArea::drawContent(QPainter &p, const U2Region &region, con
     QString schemeName = highlightingScheme->metaObject()->className();
     bool isGapsScheme = schemeName == "U2::MSAHighlightingSchemeGaps";
 
-    U2Region baseYRange = U2Region(0, editor->getRowHeight());
-    int columnWidth = editor->getColumnWidth();
-
-    bool isResizeMode = editor->getResizeMode() == MSAEditor::ResizeMode_FontAndContent;
-    for (qint64 iSeq = 0; iSeq < seqIdx.size(); iSeq++) {
-        qint64 seq = seqIdx[iSeq];
-        qint64 regionEnd = region.endPos() - (int)(region.endPos() == editor->getAlignmentLen());
-        for (int pos = region.startPos; pos <= regionEnd; pos++) {
-            U2Region baseXRange = U2Region(columnWidth * (pos - region.startPos), columnWidth);
-            QRect cr(baseXRange.startPos, baseYRange.startPos, baseXRange.length + 1, baseYRange.length);
-            char c = msa.charAt(seq, pos);
-
-            QColor color = colorScheme->getColor(seq, pos, c);
+    const int columnWidth = editor->getColumnWidth();
+    const int rowHeight = editor->getRowHeight();
+    const bool isResizeMode = editor->getResizeMode() == MSAEditor::ResizeMode_FontAndContent;
+    const bool isRefFreeScheme = isGapsScheme || highlightingScheme->getFactory()->isRefFree();
+    // the atlas is pixel exact only for the cached view on a usual screen:
+    // exported images, vector formats and HiDPI screens get the text
+    const bool useGlyphCache = isResizeMode && p.device() == cachedView && 1 == devicePixelRatio();
+    if (useGlyphCache) {
+        glyphCache.update(editor->getFont(), columnWidth, rowHeight);
+    }
+
+    // every visible row is decoded once into a buffer instead of looking up the gap model for each symbol
+    const qint64 regionEnd = region.endPos() - (int)(region.endPos() == editor->getAlignmentLen());
+    const int spanLength = regionEnd - region.startPos + 1;
+    CHECK(spanLength > 0, true);
+    const QByteArray refSpan = (r != NULL) ? r->getRowSpan(region.startPos, spanLength) : QByteArray();
+
+    // position independent schemes are resolved through the lookup table
+    const QVector<QColor> colorsPerChar = colorScheme->getColorsPerChar();
+    const bool useColorsTable = colorsPerChar.size() == 256;
+
+    QVector<QColor> cellColors(spanLength);
+    int y = 0;
+    for (qint64 iSeq = 0; iSeq < seqIdx.size(); iSeq++, y += rowHeight) {
+        const qint64 seq = seqIdx[iSeq];
+        QByteArray rowSpan = msa.getRow(seq).getRowSpan(region.startPos, spanLength);
+        char *rowData = rowSpan.data();
+
+        for (int i = 0; i < spanLength; i++) {
+            const int pos = region.startPos + i;
+            char &c = rowData[i];
+            QColor color = useColorsTable ? colorsPerChar[(quint8)c] : colorScheme->getColor(seq, pos, c);
             bool drawColor = false;
-            if (isGapsScheme || highlightingScheme->getFactory()->isRefFree()){ //schemes which applied without reference
+            if (isRefFreeScheme) { //schemes which applied without reference
                 const char refChar = 'z';
                 highlightingScheme->process(refChar, c, drawColor, pos, seq);
-                if(isGapsScheme){
-                    color = QColor(192, 192, 192);
-                }
-                if (color.isValid() && drawColor) {
-                    p.fillRect(cr, color);
-                }
-                if (editor->getResizeMode() == MSAEditor::ResizeMode_FontAndContent) {
-                    p.drawText(cr, Qt::AlignCenter, QString(c));
-                }
-            }else if(seq == refSeq || refSeqName.isEmpty()){
-                if (color.isValid()) {
-                    p.fillRect(cr, color);
-                }
-                if (isResizeMode) {
-                    p.drawText(cr, Qt::AlignCenter, QString(c));
-                }
-            }else{
-                const char refChar = r->charAt(pos);
-                highlightingScheme->process(refChar, c, drawColor, pos, seq);
+            } else if (seq == refSeq || refSeqName.isEmpty() || refSpan.isEmpty()) {
+                drawColor = true;
+            } else {
+                highlightingScheme->process(refSpan[i], c, drawColor, pos, seq);
+            }
+            if (isGapsScheme) {
+                color = QColor(192, 192, 192);
+            }
+            cellColors[i] = drawColor ? color : QColor();
+        }
 
-                if(isGapsScheme){
-                    color = QColor(192, 192, 192);
-                }
-                if (color.isValid() && drawColor) {
-                    p.fillRect(cr, color);
-                }
-                if (isResizeMode) {
-                    p.drawText(cr, Qt::AlignCenter, QString(c));
-                }
+        // neighbour cells of the same color are filled at once
+        for (int i = 0; i < spanLength;) {
+            int runEnd = i + 1;
+            while (runEnd < spanLength && cellColors[runEnd] == cellColors[i]) {
+                runEnd++;
+            }
+            if (cellColors[i].isValid()) {
+                p.fillRect(QRect(columnWidth * i, y, columnWidth * (runEnd - i) + 1, rowHeight), cellColors[i]);
+            }
+            i = runEnd;
+        }
+
+        if (useGlyphCache) {
+            for (int i = 0; i < spanLength; i++) {
+                glyphCache.drawGlyph(p, columnWidth * i, y, rowData[i]);
+            }
+        } else if (isResizeMode) {
+            for (int i = 0; i < spanLength; i++) {
+                p.drawText(QRect(columnWidth * i, y, columnWidth + 1, rowHeight), Qt::AlignCenter, QString(rowData[i]));
             }
         }
-        baseYRange.startPos += editor->getRowHeight();
     }
 
     return true;
@@ -44,6 +44,7 @@
 
 #include "DeleteGapsDialog.h"
 #include "MSACollapsibleModel.h"
+#include "MSAEditorGlyphCache.h"
 #include "MsaEditorUserModStepController.h"
 #include "SaveSelectedSequenceFromMSADialogController.h"
 #include "ExportHighlightedDialogController.h"
@@ -518,6 +519,7 @@ private:
 
     QPixmap*        cachedView;
     bool            completeRedraw;
+    MSAEditorGlyphCache glyphCache;
 
     MSAColorScheme* colorScheme;
     MSAHighlightingScheme* highlightingScheme;
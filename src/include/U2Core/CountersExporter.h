@@ -0,0 +1 @@
+#include "../../corelibs/U2Core/src/globals/CountersExporter.h"
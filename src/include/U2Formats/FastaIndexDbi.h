@@ -0,0 +1 @@
+#include "../../corelibs/U2Formats/src/FastaIndexDbi.h"
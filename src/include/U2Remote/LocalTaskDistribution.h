@@ -0,0 +1 @@
+#include "../../corelibs/U2Remote/src/LocalTaskDistribution.h"
@@ -21,6 +21,9 @@ HEADERS += \
     src/core/external_script/base_scheme_interface/CInterfaceManualTests.h \
     src/core/external_script/base_scheme_interface/CInterfaceSasTests.h \
     src/core/external_script/base_scheme_interface/SchemeSimilarityUtils.h \
+    src/core/format/bam/BAMSorterUnitTests.h \
+    src/core/format/bam/SamToBamStreamConverterUnitTests.h \
+    src/core/format/fasta/FastaIndexUnitTests.h \
     src/core/format/fastq/FastqUnitTests.h \
     src/core/format/genbank/LocationParserUnitTests.h \
     src/core/format/sqlite_msa_dbi/MsaDbiSQLiteSpecificUnitTests.h \
@@ -33,9 +36,17 @@ HEADERS += \
     src/core/gobjects/TextObjectUnitTests.h \
     src/core/util/MAlignmentImporterExporterUnitTests.h \
     src/UnitTestSuite.h \  
+    src/core/util/CounterUnitTests.h \
+    src/core/util/ExternalToolResourcePlannerUnitTests.h \
     src/core/util/DatatypeSerializeUtilsUnitTest.h \
+    src/core/util/LazyPluginLoadingUnitTests.h \
+    src/core/util/LocalTaskChannelUnitTests.h \
     src/core/util/MsaDbiUtilsUnitTests.h \
     src/core/util/MsaUtilsUnitTests.h \
+    src/core/util/WorkflowResultCacheUnitTests.h \
+    src/core/util/WorkflowRunOptionsUnitTests.h \
+    src/core/format/sqlite_assembly_dbi/AssemblyPackAlgorithmUnitTests.h \
+    src/core/format/sqlite_assembly_dbi/SQLiteAssemblyUtilsUnitTests.h \
     src/core/format/sqlite_mod_dbi/ModDbiSQLiteSpecificUnitTests.h \
     src/core/format/sqlite_sequence_dbi/SequenceDbiSQLiteSpecificUnitTests.h
 SOURCES += \
@@ -57,6 +68,9 @@ SOURCES += \
     src/core/external_script/base_scheme_interface/CInterfaceManualTests.cpp \
     src/core/external_script/base_scheme_interface/CInterfaceSasTests.cpp \
     src/core/external_script/base_scheme_interface/SchemeSimilarityUtils.cpp \
+    src/core/format/bam/BAMSorterUnitTests.cpp \
+    src/core/format/bam/SamToBamStreamConverterUnitTests.cpp \
+    src/core/format/fasta/FastaIndexUnitTests.cpp \
     src/core/format/fastq/FastqUnitTests.cpp \
     src/core/format/genbank/LocationParserUnitTests.cpp \
     src/core/format/sqlite_msa_dbi/MsaDbiSQLiteSpecificUnitTests.cpp \
@@ -69,8 +83,16 @@ SOURCES += \
     src/core/gobjects/TextObjectUnitTests.cpp \
     src/core/util/MAlignmentImporterExporterUnitTests.cpp \
     src/UnitTestSuite.cpp \  
+    src/core/util/CounterUnitTests.cpp \
+    src/core/util/ExternalToolResourcePlannerUnitTests.cpp \
     src/core/util/DatatypeSerializeUtilsUnitTest.cpp \
+    src/core/util/LazyPluginLoadingUnitTests.cpp \
+    src/core/util/LocalTaskChannelUnitTests.cpp \
     src/core/util/MsaDbiUtilsUnitTests.cpp \
     src/core/util/MsaUtilsUnitTests.cpp \
+    src/core/util/WorkflowResultCacheUnitTests.cpp \
+    src/core/util/WorkflowRunOptionsUnitTests.cpp \
+    src/core/format/sqlite_assembly_dbi/AssemblyPackAlgorithmUnitTests.cpp \
+    src/core/format/sqlite_assembly_dbi/SQLiteAssemblyUtilsUnitTests.cpp \
     src/core/format/sqlite_mod_dbi/ModDbiSQLiteSpecificUnitTests.cpp \
     src/core/format/sqlite_sequence_dbi/SequenceDbiSQLiteSpecificUnitTests.cpp
@@ -1075,6 +1075,32 @@ IMPLEMENT_TEST(MAlignmentRowUnitTests, charAt_onlyCharsInRow) {
     CHECK_EQUAL('-', ch, "char 3");
 }
 
+/** Tests getRowSpan */
+IMPLEMENT_TEST(MAlignmentRowUnitTests, getRowSpan_gapsInMiddle) {
+    MAlignment almnt;
+    MAlignmentRow row = MAlignmentRowTestUtils::initTestRowWithGapsInMiddle(almnt);
+    for (int pos = 0; pos < 10; pos++) {
+        for (int count = 0; pos + count <= 10; count++) {
+            QByteArray span = row.getRowSpan(pos, count);
+            CHECK_EQUAL(count, span.length(), "span length");
+            for (int i = 0; i < count; i++) {
+                CHECK_EQUAL(row.charAt(pos + i), span.at(i), QString("char %1 of span at %2").arg(i).arg(pos));
+            }
+        }
+    }
+}
+
+IMPLEMENT_TEST(MAlignmentRowUnitTests, getRowSpan_outOfRow) {
+    U2OpStatusImpl os;
+    MAlignment almnt("Test alignment");
+    almnt.addRow("Test row", "-AC-GT", os);
+    MAlignmentRow row = almnt.getRow(0);
+    CHECK_NO_ERROR(os);
+
+    CHECK_EQUAL("---AC-GT--", QString(row.getRowSpan(-2, 10)), "row span");
+    CHECK_EQUAL("", QString(row.getRowSpan(2, 0)), "empty span");
+}
+
 
 /** Tests rowEqual */
 IMPLEMENT_TEST(MAlignmentRowUnitTests, rowsEqual_sameContent) {
@@ -237,6 +237,14 @@ DECLARE_TEST(MAlignmentRowUnitTests, charAt_allCharsNoOffset);
 DECLARE_TEST(MAlignmentRowUnitTests, charAt_offsetAndTrailing);
 DECLARE_TEST(MAlignmentRowUnitTests, charAt_onlyCharsInRow);
 
+/**
+ * Getting a span of chars at the specified position:
+ *   ^ gapsInMiddle - the span covers gaps and chars in the middle of a row, compared with "charAt"
+ *   ^ outOfRow     - the span starts before the row and ends after it
+ */
+DECLARE_TEST(MAlignmentRowUnitTests, getRowSpan_gapsInMiddle);
+DECLARE_TEST(MAlignmentRowUnitTests, getRowSpan_outOfRow);
+
 /**
  * Checking if rows are equal (method "isRowContentEqual", "operator==", "operator!="):
  *   ^ sameContent         - rows contents are equal
@@ -418,6 +426,8 @@ DECLARE_METATYPE(MAlignmentRowUnitTests, remove_oneCharInGaps)
 DECLARE_METATYPE(MAlignmentRowUnitTests, charAt_allCharsNoOffset)
 DECLARE_METATYPE(MAlignmentRowUnitTests, charAt_offsetAndTrailing)
 DECLARE_METATYPE(MAlignmentRowUnitTests, charAt_onlyCharsInRow)
+DECLARE_METATYPE(MAlignmentRowUnitTests, getRowSpan_gapsInMiddle)
+DECLARE_METATYPE(MAlignmentRowUnitTests, getRowSpan_outOfRow)
 DECLARE_METATYPE(MAlignmentRowUnitTests, rowsEqual_sameContent)
 DECLARE_METATYPE(MAlignmentRowUnitTests, rowsEqual_noGaps)
 DECLARE_METATYPE(MAlignmentRowUnitTests, rowsEqual_trailingInFirst)
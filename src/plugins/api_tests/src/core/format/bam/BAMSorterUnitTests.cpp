@@ -0,0 +1,225 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <bam.h>
+
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Formats/BAMUtils.h>
+
+#include "BAMSorterUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+/* The fixture header has no @HD line, samtools adds it with the sort order */
+const char *FIXTURE_SORTED_HEADER_PREFIX = "@HD\tVN:1.3\tSO:coordinate\n";
+const int REVERSED_BLOCK_SIZE = 1000;
+
+/* Sorted by samtools */
+QString getFixtureUrl() {
+    return QDir::searchPaths(PATH_PREFIX_DATA).first() + "/samples/Assembly/chrM.sorted.bam";
+}
+
+class BamFileData {
+public:
+    BamFileData() : header(NULL) {}
+
+    ~BamFileData() {
+        if (NULL != header) {
+            bam_header_destroy(header);
+        }
+        foreach (bam1_t *read, reads) {
+            bam_destroy1(read);
+        }
+    }
+
+    bam_header_t *header;
+    QList<bam1_t *> reads;
+};
+
+void readBamFile(const QString &url, BamFileData &data, U2OpStatus &os) {
+    bamFile file = bam_open(url.toLocal8Bit().constData(), "r");
+    CHECK_EXT(NULL != file, os.setError(L10N::errorOpeningFileRead(url)), );
+    data.header = bam_header_read(file);
+    if (NULL == data.header) {
+        bam_close(file);
+        os.setError(L10N::errorReadingFile(url));
+        return;
+    }
+
+    bam1_t *read = bam_init1();
+    int result = 0;
+    while ((result = bam_read1(file, read)) >= 0) {
+        data.reads << bam_dup1(read);
+    }
+    bam_destroy1(read);
+    bam_close(file);
+    CHECK_EXT(-1 == result, os.setError(L10N::errorReadingFile(url)), );
+}
+
+void writeBamFile(const QString &url, const bam_header_t *header, const QList<bam1_t *> &reads, U2OpStatus &os) {
+    bamFile file = bam_open(url.toLocal8Bit().constData(), "w");
+    CHECK_EXT(NULL != file, os.setError(L10N::errorOpeningFileWrite(url)), );
+    bam_header_write(file, header);
+    foreach (const bam1_t *read, reads) {
+        CHECK_EXT_BREAK(bam_write1(file, read) >= 0, os.setError(L10N::errorWritingFile(url)));
+    }
+    bam_close(file);
+}
+
+/* The same key as samtools merge uses */
+quint64 getSortKey(const bam1_t *read) {
+    return (quint64(quint32(read->core.tid)) << 32) | (quint32(read->core.pos + 1) << 1) | (bam1_strand(read) ? 1 : 0);
+}
+
+bool isSortedBefore(const bam1_t *first, const bam1_t *second) {
+    return getSortKey(first) < getSortKey(second);
+}
+
+bool haveSamePosition(const bam1_t *first, const bam1_t *second) {
+    return first->core.tid == second->core.tid && first->core.pos == second->core.pos;
+}
+
+/**
+ * Reverses the order of blocks of reads. The blocks are cut between different positions only,
+ * so the stable sorting keeps the input order of reads at the same position.
+ */
+QList<bam1_t *> reverseBlocks(const QList<bam1_t *> &reads) {
+    QList<bam1_t *> result;
+    int blockEnd = reads.size();
+    while (blockEnd > 0) {
+        int blockStart = qMax(0, blockEnd - REVERSED_BLOCK_SIZE);
+        while (blockStart > 0 && haveSamePosition(reads[blockStart - 1], reads[blockStart])) {
+            blockStart--;
+        }
+        result << reads.mid(blockStart, blockEnd - blockStart);
+        blockEnd = blockStart;
+    }
+    return result;
+}
+
+QByteArray toByteArray(const bam1_t *read) {
+    return QByteArray((const char *)&read->core, sizeof(bam1_core_t)) + QByteArray((const char *)read->data, read->data_len);
+}
+
+QByteArray readFile(const QString &url) {
+    QFile file(url);
+    CHECK(file.open(QIODevice::ReadOnly), QByteArray());
+    return file.readAll();
+}
+
+/**
+ * Writes the first @readsCount reads of the fixture in the unsorted order and sorts them with @maxMemoryMb.
+ * @expected gets the reads of the fixture in the order the sorted file must have.
+ */
+QString sortFixture(const QString &name, int readsCount, int maxMemoryMb, BamFileData &expected, U2OpStatus &os) {
+    readBamFile(getFixtureUrl(), expected, os);
+    CHECK_OP(os, QString());
+    CHECK_EXT(readsCount <= expected.reads.size(), os.setError("The fixture has not enough reads"), QString());
+    while (expected.reads.size() > readsCount) {
+        bam_destroy1(expected.reads.takeLast());
+    }
+
+    const QString unsortedUrl = QDir::temp().absoluteFilePath(name + ".unsorted.bam");
+    writeBamFile(unsortedUrl, expected.header, reverseBlocks(expected.reads), os);
+    CHECK_OP(os, QString());
+
+    // samtools places reads at the same position in any strands order within a chunk, the sorter places forward reads first
+    std::stable_sort(expected.reads.begin(), expected.reads.end(), isSortedBefore);
+
+    const QString sortedUrl = BAMUtils::sortBam(unsortedUrl, QDir::temp().absoluteFilePath(name + ".sorted"), os, maxMemoryMb, true).getURLString();
+    QFile::remove(unsortedUrl);
+    return sortedUrl;
+}
+
+void compareSortedFile(const QString &sortedUrl, const BamFileData &expected, U2OpStatus &os) {
+    BamFileData sorted;
+    readBamFile(sortedUrl, sorted, os);
+    CHECK_OP(os, );
+
+    CHECK_EXT(expected.header->n_targets == sorted.header->n_targets, os.setError("Unexpected references count"), );
+    for (int i = 0; i < expected.header->n_targets; i++) {
+        CHECK_EXT(0 == strcmp(expected.header->target_name[i], sorted.header->target_name[i])
+                  && expected.header->target_len[i] == sorted.header->target_len[i],
+                  os.setError(QString("Unexpected reference %1").arg(i)), );
+    }
+    const QByteArray expectedText = FIXTURE_SORTED_HEADER_PREFIX + QByteArray(expected.header->text, expected.header->l_text);
+    CHECK_EXT(expectedText == QByteArray(sorted.header->text, sorted.header->l_text), os.setError("Unexpected header text"), );
+
+    CHECK_EXT(expected.reads.size() == sorted.reads.size(),
+              os.setError(QString("Unexpected reads count: expected %1, got %2").arg(expected.reads.size()).arg(sorted.reads.size())), );
+    for (int i = 0; i < expected.reads.size(); i++) {
+        CHECK_EXT(toByteArray(expected.reads[i]) == toByteArray(sorted.reads[i]),
+                  os.setError(QString("Unexpected read %1: %2").arg(i).arg(bam1_qname(sorted.reads[i]))), );
+    }
+}
+
+/* The index is built while the sorted file is written, it must be the same as samtools builds for the file */
+void compareIndex(const QString &sortedUrl, U2OpStatus &os) {
+    const QString samtoolsIndexUrl = sortedUrl + ".samtools.bai";
+    const int result = bam_index_build2(sortedUrl.toLocal8Bit().constData(), samtoolsIndexUrl.toLocal8Bit().constData());
+    CHECK_EXT(0 == result, os.setError("samtools failed to build the index"), );
+
+    const QByteArray index = readFile(sortedUrl + ".bai");
+    CHECK_EXT(!index.isEmpty(), os.setError("The index is not built"), );
+    CHECK_EXT(readFile(samtoolsIndexUrl) == index, os.setError("The index differs from the samtools one"), );
+}
+
+void checkSortedFixture(const QString &name, int readsCount, int maxMemoryMb, U2OpStatus &os) {
+    BamFileData expected;
+    const QString sortedUrl = sortFixture(name, readsCount, maxMemoryMb, expected, os);
+    if (!os.hasError()) {
+        compareSortedFile(sortedUrl, expected, os);
+    }
+    if (!os.hasError()) {
+        compareIndex(sortedUrl, os);
+    }
+    QFile::remove(sortedUrl);
+    QFile::remove(sortedUrl + ".bai");
+    QFile::remove(sortedUrl + ".samtools.bai");
+}
+
+}   // namespace
+
+IMPLEMENT_TEST(BAMSorterUnitTests, sortBam_inMemory) {
+    // A small file is sorted in memory without temporary files
+    U2OpStatusImpl os;
+    checkSortedFixture("bam_sorter_in_memory", 2000, 0, os);
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(BAMSorterUnitTests, sortBam_runs) {
+    // 1 Mb chunks: the file is spilled to several runs that are merged
+    U2OpStatusImpl os;
+    checkSortedFixture("bam_sorter_runs", 30000, 1, os);
+    CHECK_NO_ERROR(os);
+}
+
+} // U2
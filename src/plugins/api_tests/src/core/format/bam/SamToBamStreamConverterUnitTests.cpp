@@ -0,0 +1,188 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <bam.h>
+#include <sam.h>
+
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Formats/SamToBamStreamConverter.h>
+
+#include "SamToBamStreamConverterUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+const QByteArray SAM_HEADER = "@HD\tVN:1.3\tSO:unsorted\n"
+                              "@SQ\tSN:chr1\tLN:10000\n"
+                              "@SQ\tSN:chr2\tLN:5000\n"
+                              "@PG\tID:test\tPN:test\n";
+
+/* Paired, clipped, spliced and unmapped reads, missed sequence and quality, tags of every type */
+const QByteArray SAM_READS = "read1\t99\tchr1\t100\t60\t10M\t=\t300\t210\tACGTACGTAC\tIIIIIIIIII\tNM:i:0\tAS:i:300\tXS:i:-5\tMD:Z:10\tRG:Z:group\n"
+                             "read2\t147\tchr1\t300\t60\t3S5M1I1D1M\t=\t100\t-210\tNNACGTACGT\t*\tXA:A:x\tXF:f:1.5\tXB:B:s,-3,400,12\tXI:i:-1000\tXL:i:70000\tXH:H:1AE3\n"
+                             "read3\t16\tchr2\t4000\t37\t4M2N4M\t*\t0\t0\tACGTTGCA\tABCDEFGH\n"
+                             "read4\t4\t*\t0\t0\t*\t*\t0\t0\tACGT\t!!!!\n"
+                             "read5\t0\tchr2\t1\t0\t4M2P6M\tchr1\t50\t0\t*\t*\n";
+const int READS_COUNT = 5;
+
+/* The tools print the output by parts that do not match the lines */
+const int CHUNK_SIZE = 7;
+
+class SamFileData {
+public:
+    SamFileData() : file(NULL), header(NULL) {}
+
+    ~SamFileData() {
+        if (NULL != file) {
+            samclose(file);
+        }
+        foreach (bam1_t *read, reads) {
+            bam_destroy1(read);
+        }
+    }
+
+    samfile_t *file;
+    const bam_header_t *header;
+    QList<bam1_t *> reads;
+};
+
+/* Both SAM and BAM files are read by samtools */
+void readAlignments(const QString &url, bool isBam, SamFileData &result, U2OpStatus &os) {
+    result.file = samopen(url.toLocal8Bit().constData(), isBam ? "rb" : "r", NULL);
+    CHECK_EXT(NULL != result.file, os.setError(L10N::errorOpeningFileRead(url)), );
+    result.header = result.file->header;
+
+    bam1_t *read = bam_init1();
+    int status = 0;
+    while ((status = samread(result.file, read)) >= 0) {
+        result.reads << bam_dup1(read);
+    }
+    bam_destroy1(read);
+    CHECK_EXT(-1 == status, os.setError(L10N::errorReadingFile(url)), );
+}
+
+QByteArray toByteArray(const bam1_t *read) {
+    return QByteArray((const char *)&read->core, sizeof(bam1_core_t)) + QByteArray((const char *)read->data, read->data_len);
+}
+
+QString writeSam(const QString &name, const QByteArray &sam, U2OpStatus &os) {
+    const QString url = QDir::temp().absoluteFilePath(name + ".sam");
+    QFile file(url);
+    CHECK_EXT(file.open(QIODevice::WriteOnly), os.setError(L10N::errorOpeningFileWrite(url)), QString());
+    CHECK_EXT(file.write(sam) == sam.size(), os.setError(L10N::errorWritingFile(url)), QString());
+    return url;
+}
+
+/* Passes @sam to the converter by small chunks */
+QString convert(const QString &name, const QByteArray &sam, qint64 &readsCount, U2OpStatus &os) {
+    const QString url = QDir::temp().absoluteFilePath(name + ".bam");
+    SamToBamStreamConverter converter(url);
+    for (int i = 0; i < sam.size(); i += CHUNK_SIZE) {
+        converter.consume(sam.constData() + i, qMin(CHUNK_SIZE, sam.size() - i), os);
+        CHECK_OP(os, url);
+    }
+    converter.finish(os);
+    readsCount = converter.getReadsCount();
+    return url;
+}
+
+void compareAlignments(const SamFileData &expected, const SamFileData &actual, int expectedReadsCount, U2OpStatus &os) {
+    CHECK_EXT(expected.header->l_text == actual.header->l_text && 0 == memcmp(expected.header->text, actual.header->text, expected.header->l_text),
+              os.setError("Unexpected header text"), );
+    CHECK_EXT(expected.header->n_targets == actual.header->n_targets, os.setError("Unexpected references count"), );
+    for (int i = 0; i < expected.header->n_targets; i++) {
+        CHECK_EXT(0 == strcmp(expected.header->target_name[i], actual.header->target_name[i])
+                  && expected.header->target_len[i] == actual.header->target_len[i],
+                  os.setError(QString("Unexpected reference %1").arg(i)), );
+    }
+
+    CHECK_EXT(expectedReadsCount == expected.reads.size() && expectedReadsCount == actual.reads.size(),
+              os.setError(QString("Unexpected reads count: %1").arg(actual.reads.size())), );
+    for (int i = 0; i < expected.reads.size(); i++) {
+        CHECK_EXT(toByteArray(expected.reads[i]) == toByteArray(actual.reads[i]),
+                  os.setError(QString("Unexpected read %1: %2").arg(i).arg(bam1_qname(expected.reads[i]))), );
+    }
+}
+
+/* Encodes @sam to BAM, decodes it and compares the records with the ones samtools reads from @sam */
+void checkRoundTrip(const QString &name, const QByteArray &sam, int expectedReadsCount, U2OpStatus &os) {
+    const QString samUrl = writeSam(name, sam, os);
+    CHECK_OP(os, );
+    qint64 readsCount = 0;
+    const QString bamUrl = convert(name, sam, readsCount, os);
+    if (!os.hasError() && expectedReadsCount != readsCount) {
+        os.setError(QString("Unexpected converted reads count: %1").arg(readsCount));
+    }
+
+    if (!os.hasError()) {
+        SamFileData expected;
+        readAlignments(samUrl, false, expected, os);
+        SamFileData actual;
+        if (!os.hasError()) {
+            readAlignments(bamUrl, true, actual, os);
+        }
+        if (!os.hasError()) {
+            compareAlignments(expected, actual, expectedReadsCount, os);
+        }
+    }
+    QFile::remove(samUrl);
+    QFile::remove(bamUrl);
+}
+
+}   // namespace
+
+IMPLEMENT_TEST(SamToBamStreamConverterUnitTests, roundTrip) {
+    U2OpStatusImpl os;
+    checkRoundTrip("sam_to_bam_round_trip", SAM_HEADER + SAM_READS, READS_COUNT, os);
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(SamToBamStreamConverterUnitTests, roundTrip_lastLineWithoutNewLine) {
+    U2OpStatusImpl os;
+    QByteArray sam = SAM_HEADER + SAM_READS;
+    sam.chop(1);
+    checkRoundTrip("sam_to_bam_last_line", sam, READS_COUNT, os);
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(SamToBamStreamConverterUnitTests, headerOnly) {
+    // an aligner can find no reads, the result must be a valid BAM file without reads
+    U2OpStatusImpl os;
+    checkRoundTrip("sam_to_bam_header_only", SAM_HEADER, 0, os);
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(SamToBamStreamConverterUnitTests, unknownReference) {
+    U2OpStatusImpl os;
+    qint64 readsCount = 0;
+    const QString bamUrl = convert("sam_to_bam_unknown_reference", SAM_HEADER + "read1\t0\tchr3\t1\t60\t4M\t*\t0\t0\tACGT\tIIII\n", readsCount, os);
+    QFile::remove(bamUrl);
+    CHECK_TRUE(os.hasError(), "the read with an unknown reference is converted");
+}
+
+} // U2
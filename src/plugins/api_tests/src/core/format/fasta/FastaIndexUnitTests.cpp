@@ -0,0 +1,264 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/DNASequenceObject.h>
+#include <U2Core/DbiConnection.h>
+#include <U2Core/U2ObjectDbi.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SequenceDbi.h>
+
+#include <U2Formats/FastaIndex.h>
+#include <U2Formats/FastaIndexDbi.h>
+
+#include "FastaIndexUnitTests.h"
+
+namespace U2 {
+
+namespace {
+    QString writeFastaFile(const QString &fileName, const QByteArray &data) {
+        const QString url = QDir::temp().absoluteFilePath(fileName);
+        QFile::remove(url + ".fai");
+        QFile file(url);
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write(data);
+        file.close();
+        return url;
+    }
+
+    const QByteArray REGULAR_DATA = ">seq1 first sequence\nACGTA\nCGTAC\nGT\n>seq2\nTTTTT\nGG\n>empty\n>seq3\nAAAAA\n";
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, buildRegular) {
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(writeFastaFile("fasta_index_regular.fa", REGULAR_DATA), os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(index.isRegular(), "index is not regular");
+    CHECK_EQUAL(4, index.getEntries().size(), "entries count");
+
+    const FastaIndexEntry &seq1 = index.getEntries()[0];
+    CHECK_EQUAL(QString("seq1"), seq1.name, "name");
+    CHECK_EQUAL(12, seq1.length, "length");
+    CHECK_EQUAL(21, seq1.offset, "offset");
+    CHECK_EQUAL(5, seq1.lineBases, "line bases");
+    CHECK_EQUAL(6, seq1.lineWidth, "line width");
+
+    const FastaIndexEntry *seq2 = index.findEntry("seq2");
+    CHECK_TRUE(NULL != seq2, "seq2 is not found");
+    CHECK_EQUAL(7, seq2->length, "length");
+    CHECK_EQUAL(0, index.findEntry("empty")->length, "empty length");
+    CHECK_TRUE(NULL == index.findEntry("seq1 first sequence"), "the name contains the description");
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, buildWhitespacesInLines) {
+    // whitespaces inside lines are not bases: the record can't be read by offsets
+    const QString url = writeFastaFile("fasta_index_whites.fa", ">seq\nAC GT\nACGT\nAC\n>seq2\nAC\n");
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(index.isRegular(), "index is regular");
+    CHECK_EQUAL(10, index.findEntry("seq")->length, "length");
+    CHECK_TRUE(index.findEntry("seq2")->isRegular(), "seq2 is not regular");
+
+    FastaIndexedReader reader(url, index);
+    CHECK_EQUAL(QString("ACGTACGTAC"), QString(reader.read("seq", U2Region(0, 10), os)), "whole sequence");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QString("TACG"), QString(reader.read("seq", U2Region(3, 4), os)), "region");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, buildCrLf) {
+    const QString url = writeFastaFile("fasta_index_crlf.fa", ">seq\r\nACGT\r\nACGT\r\nA\r\n>seq2\r\nCC\r\n");
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(index.isRegular(), "index is not regular");
+    const FastaIndexEntry *entry = index.findEntry("seq");
+    CHECK_EQUAL(9, entry->length, "length");
+    CHECK_EQUAL(4, entry->lineBases, "line bases");
+    CHECK_EQUAL(6, entry->lineWidth, "line width");
+
+    FastaIndexedReader reader(url, index);
+    CHECK_EQUAL(QString("TACGTA"), QString(reader.read(*entry, U2Region(3, 6), os)), "region");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QString("CC"), QString(reader.read("seq2", U2Region(0, 2), os)), "seq2");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, buildIrregular) {
+    const QString url = writeFastaFile("fasta_index_irregular.fa", ">seq\nACG\nACGTT\nA\n");
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(index.isRegular(), "index is regular");
+
+    FastaIndexedReader reader(url, index);
+    CHECK_EQUAL(QString("GACGTTA"), QString(reader.read("seq", U2Region(2, 7), os)), "region");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, saveLoad) {
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(writeFastaFile("fasta_index_save.fa", REGULAR_DATA), os);
+    CHECK_NO_ERROR(os);
+
+    const QString faiUrl = QDir::temp().absoluteFilePath("fasta_index_save.fa.test.fai");
+    index.save(faiUrl, os);
+    CHECK_NO_ERROR(os);
+    FastaIndex loaded = FastaIndex::load(faiUrl, os);
+    CHECK_NO_ERROR(os);
+    QFile::remove(faiUrl);
+
+    CHECK_EQUAL(index.getEntries().size(), loaded.getEntries().size(), "entries count");
+    for (int i = 0; i < index.getEntries().size(); i++) {
+        const FastaIndexEntry &expected = index.getEntries()[i];
+        const FastaIndexEntry &actual = loaded.getEntries()[i];
+        CHECK_EQUAL(expected.name, actual.name, "name");
+        CHECK_EQUAL(expected.length, actual.length, "length");
+        CHECK_EQUAL(expected.offset, actual.offset, "offset");
+        CHECK_EQUAL(expected.lineBases, actual.lineBases, "line bases");
+        CHECK_EQUAL(expected.lineWidth, actual.lineWidth, "line width");
+    }
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, getIndexDoesNotWriteNearFile) {
+    const QString url = writeFastaFile("fasta_index_cache.fa", REGULAR_DATA);
+    const GUrl cachedUrl = FastaIndex::getCachedIndexUrl(url);
+    QFile::remove(cachedUrl.getURLString());
+
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::getIndex(url, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(4, index.getEntries().size(), "entries count");
+    CHECK_FALSE(QFile::exists(FastaIndex::getIndexUrl(url).getURLString()), "the index is written near the file");
+    CHECK_TRUE(QFile::exists(cachedUrl.getURLString()), "the index is not cached");
+
+    FastaIndex cached = FastaIndex::getIndex(url, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(4, cached.getEntries().size(), "cached entries count");
+    QFile::remove(cachedUrl.getURLString());
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, readRegions) {
+    const QString url = writeFastaFile("fasta_index_read.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+
+    FastaIndexedReader reader(url, index);
+    CHECK_EQUAL(QString("ACGTACGTACGT"), QString(reader.read("seq1", U2Region(0, 12), os)), "whole sequence");
+    CHECK_EQUAL(QString("ACG"), QString(reader.read("seq1", U2Region(4, 3), os)), "region across lines");
+    CHECK_EQUAL(QString("GT"), QString(reader.read("seq1", U2Region(10, 2), os)), "last line");
+    CHECK_EQUAL(QString("TTTTTGG"), QString(reader.read("seq2", U2Region(0, 7), os)), "seq2");
+    CHECK_EQUAL(QString("AAAAA"), QString(reader.read("seq3", U2Region(0, 5), os)), "seq3");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, readHeader) {
+    const QString url = writeFastaFile("fasta_index_header.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+
+    FastaIndexedReader reader(url, index);
+    CHECK_EQUAL(QString("seq1 first sequence"), reader.readHeader(*index.findEntry("seq1"), os), "header with description");
+    CHECK_EQUAL(QString("seq2"), reader.readHeader(*index.findEntry("seq2"), os), "header");
+    CHECK_EQUAL(QString("empty"), reader.readHeader(*index.findEntry("empty"), os), "header of empty record");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, readOutOfBounds) {
+    const QString url = writeFastaFile("fasta_index_bounds.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    FastaIndex index = FastaIndex::build(url, os);
+    CHECK_NO_ERROR(os);
+
+    FastaIndexedReader reader(url, index);
+    reader.read("seq2", U2Region(5, 3), os);
+    CHECK_TRUE(os.hasError(), "no error for the region out of bounds");
+
+    U2OpStatusImpl os2;
+    reader.read("unknown", U2Region(0, 1), os2);
+    CHECK_TRUE(os2.hasError(), "no error for the unknown sequence");
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, dbiObjects) {
+    const QString url = writeFastaFile("fasta_index_dbi.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    DbiConnection con(U2DbiRef(FastaIndexDbiFactory::ID, url), os);
+    CHECK_NO_ERROR(os);
+
+    const QList<U2DataId> ids = con.dbi->getObjectDbi()->getObjects(U2Type::Sequence, 0, U2DbiOptions::U2_DBI_NO_LIMIT, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(3, ids.size(), "objects count, the empty record is skipped");
+
+    const U2Sequence seq2 = con.dbi->getSequenceDbi()->getSequenceObject(ids[1], os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QString("seq2"), seq2.visualName, "name");
+    CHECK_EQUAL(7, int(seq2.length), "length");
+    CHECK_EQUAL(BaseDNAAlphabetIds::NUCL_DNA_DEFAULT(), seq2.alphabet.id, "alphabet");
+    CHECK_EQUAL(QString("TTGG"), QString(con.dbi->getSequenceDbi()->getSequenceData(ids[1], U2Region(3, 4), os)), "region");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, dbiIsReadOnly) {
+    const QString url = writeFastaFile("fasta_index_dbi_read_only.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    DbiConnection con(U2DbiRef(FastaIndexDbiFactory::ID, url), os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(con.dbi->isReadOnly(), "the DBI is not read-only");
+    CHECK_TRUE(con.dbi->getFeatures().contains(U2DbiFeature_ReadSequence), "sequences can't be read");
+    CHECK_FALSE(con.dbi->getFeatures().contains(U2DbiFeature_WriteSequence), "sequences can be written");
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, sequenceObjectReadsRegions) {
+    const QString url = writeFastaFile("fasta_index_object.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    QScopedPointer<U2SequenceObject> object(FastaIndexDbi::createSequenceObject(url, "seq1", os));
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(NULL != object.data(), "NULL object");
+
+    CHECK_EQUAL(QString("seq1 first sequence"), object->getSequenceName(), "name");
+    CHECK_EQUAL(12, int(object->getSequenceLength()), "length");
+    CHECK_TRUE(object->getAlphabet()->isNucleic(), "alphabet");
+    CHECK_EQUAL(QString("ACGTACGTACGT"), QString(object->getWholeSequenceData(os)), "whole sequence");
+    CHECK_EQUAL(QString("ACG"), QString(object->getSequenceData(U2Region(4, 3), os)), "region across lines");
+    CHECK_EQUAL(QString("GT"), QString(object->getSequenceData(U2Region(10, 2), os)), "last line");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FastaIndexUnitTests, sequenceObjectNotFound) {
+    const QString url = writeFastaFile("fasta_index_object_not_found.fa", REGULAR_DATA);
+    U2OpStatusImpl os;
+    QScopedPointer<U2SequenceObject> object(FastaIndexDbi::createSequenceObject(url, "unknown", os));
+    CHECK_TRUE(os.hasError(), "no error for the unknown sequence");
+    CHECK_TRUE(NULL == object.data(), "object for the unknown sequence");
+
+    U2OpStatusImpl os2;
+    object.reset(FastaIndexDbi::createSequenceObject(url, "empty", os2));
+    CHECK_TRUE(os2.hasError(), "no error for the empty record");
+    CHECK_TRUE(NULL == object.data(), "object for the empty record");
+}
+
+} // namespace U2
@@ -0,0 +1,59 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_FASTA_INDEX_UNIT_TESTS_H_
+#define _U2_FASTA_INDEX_UNIT_TESTS_H_
+
+#include <unittest.h>
+
+namespace U2 {
+
+DECLARE_TEST(FastaIndexUnitTests, buildRegular);
+DECLARE_TEST(FastaIndexUnitTests, buildWhitespacesInLines);
+DECLARE_TEST(FastaIndexUnitTests, buildCrLf);
+DECLARE_TEST(FastaIndexUnitTests, buildIrregular);
+DECLARE_TEST(FastaIndexUnitTests, saveLoad);
+DECLARE_TEST(FastaIndexUnitTests, getIndexDoesNotWriteNearFile);
+DECLARE_TEST(FastaIndexUnitTests, readRegions);
+DECLARE_TEST(FastaIndexUnitTests, readHeader);
+DECLARE_TEST(FastaIndexUnitTests, readOutOfBounds);
+DECLARE_TEST(FastaIndexUnitTests, dbiObjects);
+DECLARE_TEST(FastaIndexUnitTests, dbiIsReadOnly);
+DECLARE_TEST(FastaIndexUnitTests, sequenceObjectReadsRegions);
+DECLARE_TEST(FastaIndexUnitTests, sequenceObjectNotFound);
+
+}
+
+DECLARE_METATYPE(FastaIndexUnitTests, buildRegular);
+DECLARE_METATYPE(FastaIndexUnitTests, buildWhitespacesInLines);
+DECLARE_METATYPE(FastaIndexUnitTests, buildCrLf);
+DECLARE_METATYPE(FastaIndexUnitTests, buildIrregular);
+DECLARE_METATYPE(FastaIndexUnitTests, saveLoad);
+DECLARE_METATYPE(FastaIndexUnitTests, getIndexDoesNotWriteNearFile);
+DECLARE_METATYPE(FastaIndexUnitTests, readRegions);
+DECLARE_METATYPE(FastaIndexUnitTests, readHeader);
+DECLARE_METATYPE(FastaIndexUnitTests, readOutOfBounds);
+DECLARE_METATYPE(FastaIndexUnitTests, dbiObjects);
+DECLARE_METATYPE(FastaIndexUnitTests, dbiIsReadOnly);
+DECLARE_METATYPE(FastaIndexUnitTests, sequenceObjectReadsRegions);
+DECLARE_METATYPE(FastaIndexUnitTests, sequenceObjectNotFound);
+
+#endif // _U2_FASTA_INDEX_UNIT_TESTS_H_
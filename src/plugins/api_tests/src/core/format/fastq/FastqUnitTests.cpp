@@ -19,13 +19,23 @@
  * MA 02110-1301, USA.
  */
 
+#include <algorithm>
+
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QScopedPointer>
 
 #include <U2Core/AnnotationData.h>
 #include <U2Core/U2SafePoints.h>
 #include <U2Core/U2Region.h>
 #include <U2Core/AppContext.h>
 #include <U2Core/IOAdapter.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/StringAdapter.h>
+#include <U2Formats/FastqBatchProcessor.h>
+#include <U2Formats/FastqBatchReader.h>
 #include <U2Formats/FastqFormat.h>
 #include <U2Core/AppSettings.h>
 #include <U2Test/TestRunnerSettings.h>
@@ -49,6 +59,62 @@ void FastqFormatTestData::init() {
     //CHECK_NOT_EQUAL(NULL, format, "Format is NULL");
 }
 
+namespace {
+
+/** Keeps the reads with the number not divisible by 3 and reverses their sequences */
+class TestFastqTransformer : public FastqBatchTransformer {
+public:
+    int transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &/*os*/) {
+        int count = 0;
+        for (int i = 0; i < batch.size(); i++) {
+            const QByteArray name = batch.getName(i);
+            if (0 == name.mid(4).toInt() % 3) {
+                continue;
+            }
+            QByteArray sequence = batch.getSequence(i);
+            std::reverse(sequence.begin(), sequence.end());
+            FastqBatchProcessor::appendRecord(output, name.constData(), name.length(),
+                sequence.constData(), batch.getQualityData(i), sequence.length());
+            count++;
+        }
+        return count;
+    }
+};
+
+/** Several default batches of reads, so the batches are processed by different threads */
+const int PROCESSOR_READS_COUNT = 35000;
+
+QString writeProcessorInput(U2OpStatus &os) {
+    static const char NUCLEOTIDES[] = "ACGT";
+    QByteArray data;
+    for (int i = 0; i < PROCESSOR_READS_COUNT; i++) {
+        QByteArray sequence;
+        for (int j = 0; j < 10 + i % 20; j++) {
+            sequence.append(NUCLEOTIDES[(i + j * j) % 4]);
+        }
+        data += "@read" + QByteArray::number(i) + " comment\n" + sequence + "\n+\n" + QByteArray(sequence.length(), 'I') + "\n";
+    }
+    const QString url = QDir::temp().absoluteFilePath("fastq_batch_processor_input.fastq");
+    QFile file(url);
+    CHECK_EXT(file.open(QIODevice::WriteOnly), os.setError(L10N::errorOpeningFileWrite(url)), "");
+    CHECK_EXT(data.size() == file.write(data), os.setError(L10N::errorWritingFile(url)), "");
+    return url;
+}
+
+QByteArray getExpectedProcessorOutput(const QString &inputUrl, U2OpStatus &os) {
+    FastqBatchReader reader(inputUrl, os);
+    CHECK_OP(os, QByteArray());
+    FastqRecordBatch batch;
+    TestFastqTransformer transformer;
+    QByteArray result;
+    while (reader.readBatch(batch, os)) {
+        transformer.transform(batch, result, os);
+    }
+    return result;
+}
+
+}
+
 IMPLEMENT_TEST(FasqUnitTests, checkRawData) {
     if (FastqFormatTestData::format == NULL) {
         FastqFormatTestData::init();
@@ -101,4 +167,189 @@ IMPLEMENT_TEST(FasqUnitTests, checkRawDataInvalidQualityHeaderStartWith) {
     CHECK_EQUAL(FormatDetection_NotMatched, res.score, "format is not matched");
 }
 
+IMPLEMENT_TEST(FasqUnitTests, batchReaderRecords) {
+    StringAdapter io("@read1 first comment\nacgt\n+\n!!II\n\n@read2\nGGCC\n+read2\nIIII\n");
+    FastqBatchReader reader(&io);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os), "batch is not read");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(2, batch.size(), "records count");
+    CHECK_EQUAL(QString("read1 first comment"), QString(batch.getHeader(0)), "header");
+    CHECK_EQUAL(QString("read1"), QString(batch.getName(0)), "name");
+    CHECK_EQUAL(QString("first comment"), QString(batch.getComment(0)), "comment");
+    CHECK_EQUAL(QString("ACGT"), QString(batch.getSequence(0)), "sequence");
+    CHECK_EQUAL(QString("!!II"), QString(batch.getQuality(0)), "quality");
+    CHECK_EQUAL(QString("read2"), QString(batch.getName(1)), "name");
+    CHECK_EQUAL(QString(""), QString(batch.getComment(1)), "comment");
+    CHECK_EQUAL(QString("GGCC"), QString(batch.getSequence(1)), "sequence");
+
+    DNASequence sequence = batch.toDNASequence(0);
+    CHECK_EQUAL(QString("read1 first comment"), sequence.getName(), "sequence name");
+    CHECK_EQUAL(QString("!!II"), QString(sequence.quality.qualCodes), "sequence quality");
+
+    CHECK_FALSE(reader.readBatch(batch, os), "unexpected batch");
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(batch.isEmpty(), "batch is not empty");
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderMultilineRecord) {
+    StringAdapter io("@read\r\nACGT\r\nAC\r\n+\r\n@III\r\nII\r\n");
+    FastqBatchReader reader(&io);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os), "batch is not read");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(1, batch.size(), "records count");
+    CHECK_EQUAL(QString("ACGTAC"), QString(batch.getSequence(0)), "sequence");
+    CHECK_EQUAL(QString("@IIIII"), QString(batch.getQuality(0)), "quality");
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderBatchLimit) {
+    QByteArray data;
+    for (int i = 0; i < 5; i++) {
+        data += QString("@read%1\nACGT\n+\nIIII\n").arg(i).toLatin1();
+    }
+    StringAdapter io(data);
+    FastqBatchReader reader(&io);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os, 2), "batch is not read");
+    CHECK_EQUAL(2, batch.size(), "records count");
+    CHECK_TRUE(reader.readBatch(batch, os, 2), "batch is not read");
+    CHECK_EQUAL(2, batch.size(), "records count");
+    CHECK_EQUAL(QString("read2"), QString(batch.getName(0)), "name");
+    CHECK_TRUE(reader.readBatch(batch, os, 2), "batch is not read");
+    CHECK_EQUAL(1, batch.size(), "records count");
+    CHECK_FALSE(reader.readBatch(batch, os, 2), "unexpected batch");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(5, reader.getRecordsCount(), "total records count");
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderInconsistentQuality) {
+    StringAdapter io("@read\nACGT\n+\nIII\n");
+    FastqBatchReader reader(&io);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_FALSE(reader.readBatch(batch, os), "unexpected batch");
+    CHECK_TRUE(os.hasError(), "no error for the incomplete record");
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderSkipBadRecords) {
+    StringAdapter io("@read1\nACGT\n+\nIIII\n"
+                     "@read2\nACGT\n+read3\nIIII\n"
+                     "@read4\nACGT\n+\nIII\n"
+                     "garbage\n"
+                     "@read5\nGG\n+\nII\n");
+    FastqBatchReader reader(&io);
+    reader.setSkipBadRecords(true);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os), "batch is not read");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(2, batch.size(), "records count");
+    CHECK_EQUAL(QString("read1"), QString(batch.getName(0)), "name");
+    CHECK_EQUAL(QString("ACGT"), QString(batch.getSequence(0)), "sequence");
+    CHECK_EQUAL(QString("read5"), QString(batch.getName(1)), "name");
+    CHECK_EQUAL(QString("GG"), QString(batch.getSequence(1)), "sequence");
+    CHECK_EQUAL(QString("II"), QString(batch.getQuality(1)), "quality");
+    CHECK_EQUAL(6, int(batch.getBasesCount()), "bases count");
+    CHECK_EQUAL(2, reader.getRecordsCount(), "total records count");
+
+    const QStringList skipped = reader.getSkippedRecords();
+    CHECK_EQUAL(2, skipped.size(), "skipped records count");
+    CHECK_TRUE(skipped[0].startsWith("read2: "), "the skipped record with the different quality name: " + skipped[0]);
+    CHECK_TRUE(skipped[1].startsWith("read4: "), "the skipped record with the short quality: " + skipped[1]);
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderSkipIncompleteLastRecord) {
+    StringAdapter io("@read1\nACGT\n+\nIIII\n@read2\nACGT\n+\n");
+    FastqBatchReader reader(&io);
+    reader.setSkipBadRecords(true);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os), "batch is not read");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(1, batch.size(), "records count");
+    CHECK_EQUAL(1, reader.getSkippedRecords().size(), "skipped records count");
+    CHECK_FALSE(reader.readBatch(batch, os), "unexpected batch");
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchReaderKeepCase) {
+    StringAdapter io("@read\nacGTn\n+\nIIIII\n");
+    FastqBatchReader reader(&io);
+    reader.setUpperCase(false);
+    FastqRecordBatch batch;
+    U2OpStatusImpl os;
+
+    CHECK_TRUE(reader.readBatch(batch, os), "batch is not read");
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QString("acGTn"), QString(batch.getSequence(0)), "sequence");
+    CHECK_EQUAL(QString("acGTn"), QString(batch.toDNASequence(0).seq), "DNA sequence");
+}
+
+
+IMPLEMENT_TEST(FasqUnitTests, batchProcessorOrder) {
+    U2OpStatusImpl os;
+    const QString inputUrl = writeProcessorInput(os);
+    CHECK_NO_ERROR(os);
+    const QByteArray expected = getExpectedProcessorOutput(inputUrl, os);
+    CHECK_NO_ERROR(os);
+
+    const QString outputUrl = QDir::temp().absoluteFilePath("fastq_batch_processor_output.fastq");
+    QFile::remove(outputUrl);
+    TestFastqTransformer transformer;
+    FastqBatchProcessor processor(&transformer, 4);
+    processor.run(QStringList() << inputUrl, outputUrl, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(PROCESSOR_READS_COUNT, processor.getInputRecordsCount(), "input records count");
+    CHECK_EQUAL(PROCESSOR_READS_COUNT - (PROCESSOR_READS_COUNT + 2) / 3, processor.getOutputRecordsCount(), "output records count");
+
+    QFile output(outputUrl);
+    CHECK_TRUE(output.open(QIODevice::ReadOnly), "output file is not opened");
+    CHECK_TRUE(expected == output.readAll(), "the output differs from the serial result");
+    output.close();
+
+    QFile::remove(outputUrl);
+    QFile::remove(inputUrl);
+}
+
+IMPLEMENT_TEST(FasqUnitTests, batchProcessorGzip) {
+    U2OpStatusImpl os;
+    const QString inputUrl = writeProcessorInput(os);
+    CHECK_NO_ERROR(os);
+    const QByteArray expected = getExpectedProcessorOutput(inputUrl, os);
+    CHECK_NO_ERROR(os);
+
+    const QString outputUrl = QDir::temp().absoluteFilePath("fastq_batch_processor_output.fastq.gz");
+    QFile::remove(outputUrl);
+    TestFastqTransformer transformer;
+    FastqBatchProcessor processor(&transformer, 4);
+    processor.run(QStringList() << inputUrl, outputUrl, os);
+    CHECK_NO_ERROR(os);
+
+    // the members of the batches are read as a single gzip stream
+    QScopedPointer<IOAdapter> io(IOAdapterUtils::open(outputUrl, os, IOAdapterMode_Read));
+    CHECK_NO_ERROR(os);
+    QByteArray actual;
+    QByteArray block(64 * 1024, 0);
+    qint64 read = 0;
+    while ((read = io->readBlock(block.data(), block.size())) > 0) {
+        actual.append(block.constData(), int(read));
+    }
+    CHECK_TRUE(io->isEof(), "the gzipped output is not read to the end");
+    io->close();
+    CHECK_TRUE(expected == actual, "the unpacked output differs from the serial result");
+
+    QFile::remove(outputUrl);
+    QFile::remove(inputUrl);
+}
+
 } //namespace
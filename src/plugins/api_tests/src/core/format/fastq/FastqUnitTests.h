@@ -21,6 +21,15 @@ DECLARE_TEST(FasqUnitTests, checkRawData);
 DECLARE_TEST(FasqUnitTests, checkRawDataInvalidHeaderStartWith);
 DECLARE_TEST(FasqUnitTests, checkRawDataInvalidQualityHeaderStartWith);
 DECLARE_TEST(FasqUnitTests, checkRawDataMultiple);
+DECLARE_TEST(FasqUnitTests, batchReaderRecords);
+DECLARE_TEST(FasqUnitTests, batchReaderMultilineRecord);
+DECLARE_TEST(FasqUnitTests, batchReaderBatchLimit);
+DECLARE_TEST(FasqUnitTests, batchReaderInconsistentQuality);
+DECLARE_TEST(FasqUnitTests, batchReaderSkipBadRecords);
+DECLARE_TEST(FasqUnitTests, batchReaderSkipIncompleteLastRecord);
+DECLARE_TEST(FasqUnitTests, batchReaderKeepCase);
+DECLARE_TEST(FasqUnitTests, batchProcessorOrder);
+DECLARE_TEST(FasqUnitTests, batchProcessorGzip);
 
 }
 
@@ -28,6 +37,15 @@ DECLARE_METATYPE(FasqUnitTests, checkRawData);
 DECLARE_METATYPE(FasqUnitTests, checkRawDataInvalidHeaderStartWith);
 DECLARE_METATYPE(FasqUnitTests, checkRawDataInvalidQualityHeaderStartWith);
 DECLARE_METATYPE(FasqUnitTests, checkRawDataMultiple);
+DECLARE_METATYPE(FasqUnitTests, batchReaderRecords);
+DECLARE_METATYPE(FasqUnitTests, batchReaderMultilineRecord);
+DECLARE_METATYPE(FasqUnitTests, batchReaderBatchLimit);
+DECLARE_METATYPE(FasqUnitTests, batchReaderInconsistentQuality);
+DECLARE_METATYPE(FasqUnitTests, batchReaderSkipBadRecords);
+DECLARE_METATYPE(FasqUnitTests, batchReaderSkipIncompleteLastRecord);
+DECLARE_METATYPE(FasqUnitTests, batchReaderKeepCase);
+DECLARE_METATYPE(FasqUnitTests, batchProcessorOrder);
+DECLARE_METATYPE(FasqUnitTests, batchProcessorGzip);
 
 #endif
 
@@ -0,0 +1,202 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDir>
+
+#include <U2Core/U2Assembly.h>
+#include <U2Core/U2AssemblyDbi.h>
+#include <U2Core/U2DbiUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+
+#include <U2Formats/AssemblyPackAlgorithm.h>
+#include <U2Formats/SQLiteDbi.h>
+
+#include "AssemblyPackAlgorithmUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+class TestPackAlgorithmAdapter : public PackAlgorithmAdapter {
+public:
+    TestPackAlgorithmAdapter(const QList<PackAlgorithmData> &reads) : reads(reads) {}
+
+    U2DbiIterator<PackAlgorithmData> * selectAllReads(U2OpStatus &) {
+        return new BufferedDbiIterator<PackAlgorithmData>(reads);
+    }
+
+    void assignProw(const U2DataId &readId, qint64 prow, U2OpStatus &) {
+        prows[readId] = prow;
+    }
+
+    void assignProws(const QVector<PackAlgorithmRow> &rows, U2OpStatus &os) {
+        blockSizes << rows.size();
+        PackAlgorithmAdapter::assignProws(rows, os);
+    }
+
+    QList<PackAlgorithmData> reads;
+    QHash<U2DataId, qint64> prows;
+    QList<int> blockSizes;
+};
+
+/** The previous packing algorithm: every read takes the first row which tail is not after the read start */
+QHash<U2DataId, qint64> packWithTails(const QList<PackAlgorithmData> &reads) {
+    QHash<U2DataId, qint64> prows;
+    QVector<qint64> tails;
+    foreach (const PackAlgorithmData &read, reads) {
+        int prow = 0;
+        while (prow < tails.size() && tails[prow] > read.leftmostPos) {
+            prow++;
+        }
+        if (prow == tails.size()) {
+            tails << 0;
+        }
+        tails[prow] = read.leftmostPos + read.effectiveLen;
+        prows[read.readId] = prow;
+    }
+    return prows;
+}
+
+U2AssemblyRead createRead(int i, qint64 leftmostPos, int length) {
+    U2AssemblyRead read(new U2AssemblyReadData());
+    read->name = "read_" + QByteArray::number(i);
+    read->leftmostPos = leftmostPos;
+    read->readSequence = QByteArray(length, "ACGT"[i % 4]);
+    read->cigar << U2CigarToken(U2CigarOp_M, length);
+    read->effectiveLen = length;
+    read->packedViewRow = 0;
+    return read;
+}
+
+}
+
+IMPLEMENT_TEST(AssemblyPackAlgorithmUnitTests, sameAsTailScan) {
+    // 2.5 blocks of reads sorted by the start position, every read overlaps several tens of the neighbours
+    const int readsCount = 2 * PACK_ROWS_BLOCK_SIZE + PACK_ROWS_BLOCK_SIZE / 2;
+    QList<PackAlgorithmData> reads;
+    for (int i = 0; i < readsCount; i++) {
+        PackAlgorithmData read;
+        read.readId = QByteArray::number(i);
+        read.leftmostPos = i / 4 * 3;
+        read.effectiveLen = 20 + (i * 37) % 180;
+        reads << read;
+    }
+
+    TestPackAlgorithmAdapter adapter(reads);
+    U2AssemblyPackStat stat;
+    stat.readsCount = readsCount;
+    U2OpStatusImpl os;
+    AssemblyPackAlgorithm::pack(adapter, stat, os);
+    CHECK_NO_ERROR(os);
+
+    const QHash<U2DataId, qint64> expectedProws = packWithTails(reads);
+
+    CHECK_EQUAL(3, adapter.blockSizes.size(), "number of row blocks");
+    CHECK_EQUAL(PACK_ROWS_BLOCK_SIZE, adapter.blockSizes[0], "first block size");
+    CHECK_EQUAL(PACK_ROWS_BLOCK_SIZE, adapter.blockSizes[1], "second block size");
+    CHECK_EQUAL(PACK_ROWS_BLOCK_SIZE / 2, adapter.blockSizes[2], "last block size");
+    CHECK_EQUAL(readsCount, adapter.prows.size(), "number of packed reads");
+
+    qint64 expectedMaxProw = 0;
+    foreach (const PackAlgorithmData &read, reads) {
+        CHECK_EQUAL(expectedProws[read.readId], adapter.prows.value(read.readId, -1), QString("row of the read %1").arg(QString(read.readId)));
+        expectedMaxProw = qMax(expectedMaxProw, expectedProws[read.readId]);
+    }
+    CHECK_EQUAL(expectedMaxProw, stat.maxProw, "max row");
+    CHECK_TRUE(expectedMaxProw > 10, "reads do not overlap");
+}
+
+IMPLEMENT_TEST(AssemblyPackAlgorithmUnitTests, migratedReads) {
+    const QString url = QDir::temp().absoluteFilePath("assembly-pack-migration.ugenedb");
+    QFile::remove(url);
+
+    SQLiteDbi dbi;
+    QHash<QString, QString> initProperties;
+    initProperties[U2DbiOptions::U2_DBI_OPTION_URL] = url;
+    initProperties[U2DbiOptions::U2_DBI_OPTION_CREATE] = U2DbiOptions::U2_DBI_VALUE_ON;
+    U2OpStatusImpl os;
+    dbi.init(initProperties, QVariantMap(), os);
+    CHECK_NO_ERROR(os);
+    U2AssemblyDbi *assemblyDbi = dbi.getAssemblyDbi();
+
+    // All reads are imported to the first row range and overlap each other,
+    // so the reads packed after 5000 rows of the first range are migrated to the next range table
+    const int readsCount = 6000;
+    const int readLength = 200;
+    QList<U2AssemblyRead> reads;
+    for (int i = 0; i < readsCount; i++) {
+        reads << createRead(i, i % 100, readLength);
+    }
+
+    U2Assembly assembly;
+    U2AssemblyReadsImportInfo importInfo;
+    assemblyDbi->createAssemblyObject(assembly, "/", NULL, importInfo, os);
+    CHECK_NO_ERROR(os);
+    BufferedDbiIterator<U2AssemblyRead> it(reads);
+    assemblyDbi->addReads(assembly.id, &it, os);
+    CHECK_NO_ERROR(os);
+
+    U2AssemblyPackStat stat;
+    assemblyDbi->pack(assembly.id, stat, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(readsCount, stat.readsCount, "number of packed reads");
+    CHECK_EQUAL(readsCount - 1, stat.maxProw, "max row");
+
+    const qint64 readsAfterPack = assemblyDbi->countReads(assembly.id, U2_REGION_MAX, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(readsCount, readsAfterPack, "number of reads after the migration");
+
+    QSet<QByteArray> names;
+    QSet<qint64> prows;
+    {
+        QScopedPointer< U2DbiIterator<U2AssemblyRead> > iter(assemblyDbi->getReads(assembly.id, U2_REGION_MAX, os));
+        CHECK_NO_ERROR(os);
+        while (iter->hasNext()) {
+            const U2AssemblyRead read = iter->next();
+            names << read->name;
+            prows << read->packedViewRow;
+            CHECK_EQUAL(readLength, read->readSequence.length(), QString("sequence length of %1").arg(QString(read->name)));
+        }
+    }
+    CHECK_EQUAL(readsCount, names.size(), "number of read names");
+    CHECK_EQUAL(readsCount, prows.size(), "number of read rows");
+
+    {
+        QScopedPointer< U2DbiIterator<U2AssemblyRead> > iter(assemblyDbi->getReadsByRow(assembly.id, U2_REGION_MAX, 5000, readsCount - 1, os));
+        CHECK_NO_ERROR(os);
+        int migratedCount = 0;
+        while (iter->hasNext()) {
+            iter->next();
+            migratedCount++;
+        }
+        CHECK_EQUAL(readsCount - 5000, migratedCount, "number of migrated reads");
+    }
+
+    const qint64 maxProw = assemblyDbi->getMaxPackedRow(assembly.id, U2_REGION_MAX, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(readsCount - 1, maxProw, "max packed row");
+
+    dbi.shutdown(os);
+    CHECK_NO_ERROR(os);
+    QFile::remove(url);
+}
+
+} // U2
@@ -0,0 +1,128 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <U2Core/U2AssemblyUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+
+#include <U2Formats/SQLiteAssemblyDbi.h>
+
+#include "SQLiteAssemblyUtilsUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+U2AssemblyRead createRead(int i) {
+    static const char NUCLEOTIDES[] = "ACGTN";
+    U2AssemblyRead read(new U2AssemblyReadData());
+    read->name = "read_" + QByteArray::number(i);
+    const int length = 20 + i % 50;
+    for (int j = 0; j < length; j++) {
+        read->readSequence.append(NUCLEOTIDES[(i * 7 + j * 3) % 5]);
+        read->quality.append(char('!' + (i + j) % 40));
+    }
+    read->cigar << U2CigarToken(U2CigarOp_M, length - 2) << U2CigarToken(U2CigarOp_S, 2);
+    if (0 == i % 3) {
+        read->rnext = "=";
+        read->pnext = i * 10;
+    }
+    if (0 == i % 4) {
+        U2AuxData aux;
+        aux.tag[0] = 'X';
+        aux.tag[1] = 'N';
+        aux.type = 'Z';
+        aux.value = "note_" + QByteArray::number(i);
+        read->aux << aux;
+    }
+    return read;
+}
+
+QList<U2AssemblyRead> createReads(int count) {
+    QList<U2AssemblyRead> reads;
+    for (int i = 0; i < count; i++) {
+        reads << createRead(i);
+    }
+    return reads;
+}
+
+bool packedAsSingleReads(const QList<U2AssemblyRead> &reads, const QVector<QByteArray> &packed, QString &error) {
+    if (reads.size() != packed.size()) {
+        error = QString("expected %1 records, got %2").arg(reads.size()).arg(packed.size());
+        return false;
+    }
+    for (int i = 0; i < reads.size(); i++) {
+        U2OpStatusImpl os;
+        const QByteArray expected = SQLiteAssemblyUtils::packData(SQLiteAssemblyDataMethod_NSCQ, reads[i], os);
+        if (os.hasError() || expected != packed[i]) {
+            error = QString("unexpected data of the read %1").arg(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+IMPLEMENT_TEST(SQLiteAssemblyUtilsUnitTests, packReadsData_serial) {
+    // the list is too short to be split between threads
+    const QList<U2AssemblyRead> reads = createReads(100);
+    U2OpStatusImpl os;
+    const QVector<QByteArray> packed = SQLiteAssemblyUtils::packReadsData(reads, os);
+    CHECK_NO_ERROR(os);
+
+    QString error;
+    CHECK_TRUE(packedAsSingleReads(reads, packed, error), error);
+}
+
+IMPLEMENT_TEST(SQLiteAssemblyUtilsUnitTests, packReadsData_parallel) {
+    // several jobs of 5000 reads and the last incomplete one
+    const QList<U2AssemblyRead> reads = createReads(5000 * 4 + 123);
+    U2OpStatusImpl os;
+    const QVector<QByteArray> packed = SQLiteAssemblyUtils::packReadsData(reads, os);
+    CHECK_NO_ERROR(os);
+
+    QString error;
+    CHECK_TRUE(packedAsSingleReads(reads, packed, error), error);
+}
+
+IMPLEMENT_TEST(SQLiteAssemblyUtilsUnitTests, packReadsData_unpack) {
+    const QList<U2AssemblyRead> reads = createReads(5000 * 2);
+    U2OpStatusImpl os;
+    const QVector<QByteArray> packed = SQLiteAssemblyUtils::packReadsData(reads, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(reads.size(), packed.size(), "number of packed reads");
+
+    for (int i = 0; i < reads.size(); i += 997) {
+        U2AssemblyRead read(new U2AssemblyReadData());
+        SQLiteAssemblyUtils::unpackData(packed[i], read, os);
+        CHECK_NO_ERROR(os);
+        CHECK_EQUAL(QString(reads[i]->name), QString(read->name), "read name");
+        CHECK_EQUAL(QString(reads[i]->readSequence), QString(read->readSequence), "read sequence");
+        CHECK_EQUAL(QString(reads[i]->quality), QString(read->quality), "read quality");
+        CHECK_EQUAL(QString(U2AssemblyUtils::cigar2String(reads[i]->cigar)), QString(U2AssemblyUtils::cigar2String(read->cigar)), "read cigar");
+        CHECK_EQUAL(QString(reads[i]->rnext), QString(read->rnext), "read rnext");
+        CHECK_EQUAL(reads[i]->pnext, read->pnext, "read pnext");
+        CHECK_EQUAL(reads[i]->aux.size(), read->aux.size(), "read aux count");
+    }
+}
+
+} // U2
@@ -19,6 +19,8 @@
  * MA 02110-1301, USA.
  */
 
+#include <QtCore/QDir>
+
 #include "MsaDbiSQLiteSpecificUnitTests.h"
 #include "core/util/MsaDbiUtilsUnitTests.h"
 
@@ -3392,4 +3394,281 @@ IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, addRows_redo) {
     CHECK_EQUAL(U2ModType::msaLengthChanged, modStep.modType, "mod step type");
 }
 
+IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_packUnpack) {
+    QList<U2MsaGap> gaps;
+    gaps << U2MsaGap(0, 3) << U2MsaGap(5, 1) << U2MsaGap(6, 200) << U2MsaGap(100000, 70000);
+
+    QByteArray blob = PackUtils::packGapModel(gaps);
+    QList<U2MsaGap> unpackedGaps;
+    CHECK_TRUE(PackUtils::unpackGapModel(blob, unpackedGaps), "unpack");
+    CHECK_TRUE(gaps == unpackedGaps, "gaps");
+
+    CHECK_TRUE(PackUtils::packGapModel(QList<U2MsaGap>()).isEmpty(), "empty gap model");
+    QList<U2MsaGap> emptyGaps;
+    CHECK_TRUE(PackUtils::unpackGapModel(QByteArray(), emptyGaps), "unpack empty");
+    CHECK_TRUE(emptyGaps.isEmpty(), "empty gaps");
+
+    QList<U2MsaGap> truncatedGaps;
+    CHECK_FALSE(PackUtils::unpackGapModel(blob.left(blob.size() - 1), truncatedGaps), "truncated blob");
+}
+
+IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_getRows) {
+    U2OpStatusImpl os;
+    SQLiteDbi *sqliteDbi = MsaSQLiteSpecificTestData::getSQLiteDbi();
+    U2DataId msaId = MsaSQLiteSpecificTestData::createNotSoSmallTestMsa(false, os);
+    CHECK_NO_ERROR(os);
+
+    QList<U2MsaRow> rows = sqliteDbi->getMsaDbi()->getRows(msaId, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(7, rows.count(), "number of rows");
+    CHECK_TRUE(rows[2].gaps == (QList<U2MsaGap>() << U2MsaGap(18, 2) << U2MsaGap(28, 2) << U2MsaGap(43, 1) << U2MsaGap(48, 1) << U2MsaGap(52, 1) << U2MsaGap(57, 1)), "gaps of the third row");
+
+    foreach (const U2MsaRow &row, rows) {
+        U2MsaRow actualRow = sqliteDbi->getMsaDbi()->getRow(msaId, row.rowId, os);
+        CHECK_NO_ERROR(os);
+        CHECK_TRUE(row.gaps == actualRow.gaps, "row gaps");
+    }
+
+    // Update and remove the gaps of the row
+    QList<U2MsaGap> newGaps;
+    newGaps << U2MsaGap(0, 4) << U2MsaGap(10, 1);
+    sqliteDbi->getMsaDbi()->updateGapModel(msaId, rows[0].rowId, newGaps, os);
+    CHECK_NO_ERROR(os);
+    U2MsaRow updatedRow = sqliteDbi->getMsaDbi()->getRow(msaId, rows[0].rowId, os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(newGaps == updatedRow.gaps, "updated gaps");
+
+    sqliteDbi->getMsaDbi()->updateGapModel(msaId, rows[0].rowId, QList<U2MsaGap>(), os);
+    CHECK_NO_ERROR(os);
+    updatedRow = sqliteDbi->getMsaDbi()->getRow(msaId, rows[0].rowId, os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(updatedRow.gaps.isEmpty(), "removed gaps");
+    CHECK_EQUAL(updatedRow.gend - updatedRow.gstart, updatedRow.length, "row length without gaps");
+}
+
+IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_blob) {
+    U2OpStatusImpl os;
+    SQLiteDbi *sqliteDbi = MsaSQLiteSpecificTestData::getSQLiteDbi();
+    U2DataId msaId = MsaSQLiteSpecificTestData::createNotSoSmallTestMsa(false, os);
+    CHECK_NO_ERROR(os);
+    QList<U2MsaRow> rows = sqliteDbi->getMsaDbi()->getRows(msaId, os);
+    CHECK_NO_ERROR(os);
+    const qint64 rowId = rows[2].rowId;
+
+    SQLiteQuery q("SELECT gaps IS NULL, gaps FROM MsaRow WHERE msa = ?1 AND rowId = ?2", sqliteDbi->getDbRef(), os);
+    CHECK_NO_ERROR(os);
+
+    // Written gaps are stored as a single packed blob
+    QList<U2MsaGap> newGaps;
+    newGaps << U2MsaGap(0, 4) << U2MsaGap(10, 1) << U2MsaGap(300, 1000);
+    sqliteDbi->getMsaDbi()->updateGapModel(msaId, rowId, newGaps, os);
+    CHECK_NO_ERROR(os);
+    q.bindDataId(1, msaId);
+    q.bindInt64(2, rowId);
+    CHECK_TRUE(q.step(), "row is not found");
+    CHECK_EQUAL(0, q.getInt64(0), "gaps is NULL");
+    CHECK_TRUE(PackUtils::packGapModel(newGaps) == q.getBlob(1), "gaps blob");
+
+    // A row without gaps keeps NULL
+    sqliteDbi->getMsaDbi()->updateGapModel(msaId, rowId, QList<U2MsaGap>(), os);
+    CHECK_NO_ERROR(os);
+    q.reset(true);
+    q.bindDataId(1, msaId);
+    q.bindInt64(2, rowId);
+    CHECK_TRUE(q.step(), "row is not found");
+    CHECK_EQUAL(1, q.getInt64(0), "gaps is NULL");
+    q.reset(true);
+
+    // A blob written directly is read back as the gap model
+    SQLiteQuery update("UPDATE MsaRow SET gaps = ?1 WHERE msa = ?2 AND rowId = ?3", sqliteDbi->getDbRef(), os);
+    CHECK_NO_ERROR(os);
+    update.bindBlob(1, PackUtils::packGapModel(newGaps));
+    update.bindDataId(2, msaId);
+    update.bindInt64(3, rowId);
+    update.update(1);
+    CHECK_NO_ERROR(os);
+    U2MsaRow row = sqliteDbi->getMsaDbi()->getRow(msaId, rowId, os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(newGaps == row.gaps, "gaps read from the blob");
+
+    // A broken blob is reported
+    QByteArray brokenBlob = PackUtils::packGapModel(newGaps);
+    brokenBlob.chop(1);
+    update.reset(true);
+    update.bindBlob(1, brokenBlob);
+    update.bindDataId(2, msaId);
+    update.bindInt64(3, rowId);
+    update.update(1);
+    CHECK_NO_ERROR(os);
+    sqliteDbi->getMsaDbi()->getRow(msaId, rowId, os);
+    CHECK_TRUE(os.hasError(), "broken gaps blob is not reported");
+}
+
+IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_rowsSequences) {
+    U2OpStatusImpl os;
+    SQLiteDbi *sqliteDbi = MsaSQLiteSpecificTestData::getSQLiteDbi();
+    U2DataId msaId = MsaSQLiteSpecificTestData::createTestMsa(false, os);
+    CHECK_NO_ERROR(os);
+
+    U2MsaRow row = MsaSQLiteSpecificTestData::createRow(100, os);
+    CHECK_NO_ERROR(os);
+    sqliteDbi->getMsaDbi()->addRow(msaId, -1, row, os);
+    CHECK_NO_ERROR(os);
+
+    QList<U2MsaRow> rows = sqliteDbi->getMsaDbi()->getRows(msaId, os);
+    CHECK_NO_ERROR(os);
+    QList<DNASequence> sequences = sqliteDbi->getMsaDbi()->getRowsSequences(msaId, rows, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(rows.count(), sequences.count(), "number of sequences");
+
+    for (int i = 0; i < rows.count(); i++) {
+        U2Region region(rows[i].gstart, rows[i].gend - rows[i].gstart);
+        QByteArray expectedData = sqliteDbi->getSequenceDbi()->getSequenceData(rows[i].sequenceId, region, os);
+        CHECK_NO_ERROR(os);
+        U2Sequence seqObj = sqliteDbi->getSequenceDbi()->getSequenceObject(rows[i].sequenceId, os);
+        CHECK_NO_ERROR(os);
+
+        CHECK_EQUAL(QString(expectedData), QString(sequences[i].seq), "sequence data");
+        CHECK_EQUAL(seqObj.visualName, sequences[i].getName(), "sequence name");
+    }
+    CHECK_EQUAL(19, sequences.last().length(), "sequence region length");
+}
+
+namespace {
+
+U2MsaRow addUpgradeTestRow(SQLiteDbi *dbi, const U2DataId &msaId, const QByteArray &seq, U2OpStatus &os) {
+    U2Sequence sequence;
+    sequence.alphabet = BaseDNAAlphabetIds::NUCL_DNA_DEFAULT();
+    dbi->getSequenceDbi()->createSequenceObject(sequence, "", os);
+    CHECK_OP(os, U2MsaRow());
+    if (!seq.isEmpty()) {
+        dbi->getSequenceDbi()->updateSequenceData(sequence.id, U2Region(0, 0), seq, QVariantMap(), os);
+        CHECK_OP(os, U2MsaRow());
+    }
+
+    U2MsaRow row;
+    row.sequenceId = sequence.id;
+    row.gstart = 0;
+    row.gend = seq.length();
+    dbi->getMsaDbi()->addRow(msaId, -1, row, os);
+    return row;
+}
+
+/** Turns the MSA part of the current schema into the 1.13 one: the gaps are moved from MsaRow to the MsaRowGap table */
+void downgradeMsaSchemaTo_1_13(SQLiteDbi *dbi, const QMap<U2DataId, QMap<qint64, QList<U2MsaGap> > > &gapModels, U2OpStatus &os) {
+    DbRef *db = dbi->getDbRef();
+    SQLiteQuery("PRAGMA foreign_keys = OFF", db, os).execute();
+    SQLiteQuery("CREATE TABLE MsaRow_1_13 (msa INTEGER NOT NULL, rowId INTEGER NOT NULL, sequence INTEGER NOT NULL,"
+        " pos INTEGER NOT NULL, gstart INTEGER NOT NULL, gend INTEGER NOT NULL, length INTEGER NOT NULL,"
+        " PRIMARY KEY(msa, rowId),"
+        " FOREIGN KEY(msa) REFERENCES Msa(object) ON DELETE CASCADE, "
+        " FOREIGN KEY(sequence) REFERENCES Sequence(object) ON DELETE CASCADE)", db, os).execute();
+    SQLiteQuery("INSERT INTO MsaRow_1_13 SELECT msa, rowId, sequence, pos, gstart, gend, length FROM MsaRow", db, os).execute();
+    SQLiteQuery("DROP TABLE MsaRow", db, os).execute();
+    SQLiteQuery("ALTER TABLE MsaRow_1_13 RENAME TO MsaRow", db, os).execute();
+    SQLiteQuery("CREATE INDEX MsaRow_msa_rowId ON MsaRow(msa, rowId)", db, os).execute();
+    SQLiteQuery("CREATE INDEX MsaRow_length ON MsaRow(length)", db, os).execute();
+    SQLiteQuery("CREATE INDEX MsaRow_sequence ON MsaRow(sequence)", db, os).execute();
+    SQLiteQuery("CREATE TABLE MsaRowGap (msa INTEGER NOT NULL, rowId INTEGER NOT NULL, "
+        "gapStart INTEGER NOT NULL, gapEnd INTEGER NOT NULL, "
+        "FOREIGN KEY(msa, rowId) REFERENCES MsaRow(msa, rowId) ON DELETE CASCADE)", db, os).execute();
+    SQLiteQuery("CREATE INDEX MsaRowGap_msa_rowId ON MsaRowGap(msa, rowId)", db, os).execute();
+    CHECK_OP(os, );
+
+    // Insert the gaps in the reverse order: the upgrader must not rely on the insertion order
+    SQLiteQuery insertQuery("INSERT INTO MsaRowGap(msa, rowId, gapStart, gapEnd) VALUES(?1, ?2, ?3, ?4)", db, os);
+    CHECK_OP(os, );
+    foreach (const U2DataId &msaId, gapModels.keys()) {
+        foreach (qint64 rowId, gapModels[msaId].keys()) {
+            const QList<U2MsaGap> &gaps = gapModels[msaId][rowId];
+            for (int i = gaps.size() - 1; i >= 0; i--) {
+                insertQuery.reset();
+                insertQuery.bindDataId(1, msaId);
+                insertQuery.bindInt64(2, rowId);
+                insertQuery.bindInt64(3, gaps[i].offset);
+                insertQuery.bindInt64(4, gaps[i].offset + gaps[i].gap);
+                insertQuery.execute();
+                CHECK_OP(os, );
+            }
+        }
+    }
+    SQLiteQuery("PRAGMA foreign_keys = ON", db, os).execute();
+    CHECK_OP(os, );
+
+    dbi->setProperty(U2DbiOptions::APP_MIN_COMPATIBLE_VERSION, "1.13.0", os);
+}
+
+}
+
+IMPLEMENT_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_upgradeFrom_1_13) {
+    const QString url = QDir::temp().absoluteFilePath("sqlite-msa-dbi-1_13.ugenedb");
+    QFile::remove(url);
+
+    U2OpStatusImpl os;
+    QMap<U2DataId, QMap<qint64, QList<U2MsaGap> > > expectedGaps;
+    QList<U2DataId> msaIds;
+    {
+        SQLiteDbi dbi;
+        QHash<QString, QString> initProperties;
+        initProperties[U2DbiOptions::U2_DBI_OPTION_URL] = url;
+        initProperties[U2DbiOptions::U2_DBI_OPTION_CREATE] = U2DbiOptions::U2_DBI_VALUE_ON;
+        dbi.init(initProperties, QVariantMap(), os);
+        CHECK_NO_ERROR(os);
+
+        U2AlphabetId alphabet = BaseDNAAlphabetIds::NUCL_DNA_DEFAULT();
+        msaIds << dbi.getMsaDbi()->createMsaObject("", "First", alphabet, os);
+        msaIds << dbi.getMsaDbi()->createMsaObject("", "Second", alphabet, os);
+        CHECK_NO_ERROR(os);
+
+        // The rows of the first alignment:
+        // ---AC--GTACGT   - leading and middle gaps
+        // ACGT            - no gaps
+        //                 - empty row
+        // TT-GCA----      - a middle and a trailing gap
+        U2MsaRow leading = addUpgradeTestRow(&dbi, msaIds[0], "ACGTACGT", os);
+        addUpgradeTestRow(&dbi, msaIds[0], "ACGT", os);
+        addUpgradeTestRow(&dbi, msaIds[0], "", os);
+        U2MsaRow trailing = addUpgradeTestRow(&dbi, msaIds[0], "TTGCA", os);
+        // The second alignment has a single gapped row only
+        U2MsaRow single = addUpgradeTestRow(&dbi, msaIds[1], "AAAA", os);
+        CHECK_NO_ERROR(os);
+
+        expectedGaps[msaIds[0]][leading.rowId] << U2MsaGap(0, 3) << U2MsaGap(5, 2);
+        expectedGaps[msaIds[0]][trailing.rowId] << U2MsaGap(2, 1) << U2MsaGap(6, 4);
+        expectedGaps[msaIds[1]][single.rowId] << U2MsaGap(1, 1) << U2MsaGap(3, 2) << U2MsaGap(7, 1);
+
+        downgradeMsaSchemaTo_1_13(&dbi, expectedGaps, os);
+        CHECK_NO_ERROR(os);
+        dbi.shutdown(os);
+        CHECK_NO_ERROR(os);
+    }
+
+    SQLiteDbi dbi;
+    QHash<QString, QString> initProperties;
+    initProperties[U2DbiOptions::U2_DBI_OPTION_URL] = url;
+    dbi.init(initProperties, QVariantMap(), os);
+    CHECK_NO_ERROR(os);
+
+    foreach (const U2DataId &msaId, msaIds) {
+        QList<U2MsaRow> rows = dbi.getMsaDbi()->getRows(msaId, os);
+        CHECK_NO_ERROR(os);
+        CHECK_EQUAL(msaId == msaIds[0] ? 4 : 1, rows.size(), "number of rows");
+        foreach (const U2MsaRow &row, rows) {
+            CHECK_TRUE(expectedGaps[msaId].value(row.rowId) == row.gaps, QString("gap model of the row %1").arg(row.rowId));
+        }
+    }
+
+    SQLiteQuery tableQuery("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'MsaRowGap'", dbi.getDbRef(), os);
+    const qint64 gapTables = tableQuery.selectInt64();
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(0, gapTables, "MsaRowGap tables");
+    const QString minVersion = dbi.getProperty(U2DbiOptions::APP_MIN_COMPATIBLE_VERSION, "", os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QString("1.23.0"), minVersion, "min compatible version");
+
+    dbi.shutdown(os);
+    CHECK_NO_ERROR(os);
+    QFile::remove(url);
+}
+
 } // namespace
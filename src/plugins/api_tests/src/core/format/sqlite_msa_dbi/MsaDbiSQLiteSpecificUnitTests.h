@@ -155,6 +155,19 @@ DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, addRows_noModTrack);
 DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, addRows_undo);
 DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, addRows_redo);
 
+/**
+ * Packed gap model storage.
+ *   ^ packUnpack    - the gap model is restored from the packed blob, malformed blobs are rejected.
+ *   ^ getRows       - the gap models of all rows are read back unchanged.
+ *   ^ rowsSequences - the bulk reading of the rows sequences gives the same result as the reading of each row sequence.
+ *   ^ upgradeFrom_1_13 - the gaps of a 1.13 database (the MsaRowGap table) are moved to the packed gap models on opening.
+ */
+DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_packUnpack);
+DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_getRows);
+DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_blob);
+DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_rowsSequences);
+DECLARE_TEST(MsaDbiSQLiteSpecificUnitTests, gapModel_upgradeFrom_1_13);
+
 } // namespace
 
 
@@ -214,5 +227,11 @@ DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, addRows_noModTrack);
 DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, addRows_undo);
 DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, addRows_redo);
 
+DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, gapModel_packUnpack);
+DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, gapModel_getRows);
+DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, gapModel_blob);
+DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, gapModel_rowsSequences);
+DECLARE_METATYPE(MsaDbiSQLiteSpecificUnitTests, gapModel_upgradeFrom_1_13);
+
 
 #endif
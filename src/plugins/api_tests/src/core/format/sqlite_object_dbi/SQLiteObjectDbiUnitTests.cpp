@@ -289,16 +289,21 @@ IMPLEMENT_TEST(SQLiteObjectDbiUnitTests, removeMsaObject) {
     qint64 msa2Rows = qMsaRow.selectInt64();
     CHECK_EQUAL(1, msa2Rows, "number of rows in MSA2");
 
-    // "MsaRowGap"
-    SQLiteQuery qMsaRowGap("SELECT COUNT(*) FROM MsaRowGap WHERE msa = ?1", sqliteDbi->getDbRef(), os);
-    qMsaRowGap.bindDataId(1, msaId);
-    qint64 msa1Gaps = qMsaRowGap.selectInt64();
-    CHECK_EQUAL(0, msa1Gaps, "number of gaps in MSA1 rows");
-
-    qMsaRowGap.reset(true);
-    qMsaRowGap.bindDataId(1, msaId2);
-    qint64 msa2Gaps = qMsaRowGap.selectInt64();
-    CHECK_EQUAL(1, msa2Gaps, "number of gaps in MSA2 rows");
+    // Gap models are packed into MsaRow.gaps, so they are removed with the rows
+    SQLiteQuery qMsaRowGaps("SELECT COUNT(*) FROM MsaRow WHERE msa = ?1 AND gaps IS NOT NULL", sqliteDbi->getDbRef(), os);
+    qMsaRowGaps.bindDataId(1, msaId);
+    qint64 msa1Gaps = qMsaRowGaps.selectInt64();
+    CHECK_EQUAL(0, msa1Gaps, "number of rows with gaps in MSA1");
+
+    qMsaRowGaps.reset(true);
+    qMsaRowGaps.bindDataId(1, msaId2);
+    qint64 msa2Gaps = qMsaRowGaps.selectInt64();
+    CHECK_EQUAL(1, msa2Gaps, "number of rows with gaps in MSA2");
+
+    QList<U2MsaRow> msa2Rows = msaDbi->getRows(msaId2, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(1, msa2Rows.size(), "number of MSA2 rows");
+    CHECK_TRUE(al2RowGaps == msa2Rows.first().gaps, "gaps of the MSA2 row");
 
     // "Sequence"
     SQLiteQuery qSeq("SELECT COUNT(*) FROM Sequence WHERE object = ?1", sqliteDbi->getDbRef(), os);
@@ -0,0 +1,159 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QThread>
+
+#include <U2Core/Counter.h>
+#include <U2Core/CountersExporter.h>
+
+#include "CounterUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+class CounterIncrementThread : public QThread {
+public:
+    CounterIncrementThread(GCounter *counter, int count)
+        : counter(counter), count(count) {}
+
+    void run() {
+        for (int i = 0; i < count; i++) {
+            counter->add();
+        }
+    }
+
+private:
+    GCounter *counter;
+    const int count;
+};
+
+class HistogramObserveThread : public QThread {
+public:
+    HistogramObserveThread(GHistogram *histogram) : histogram(histogram) {}
+
+    void run() {
+        histogram->observe(3);
+    }
+
+private:
+    GHistogram *histogram;
+};
+
+}
+
+IMPLEMENT_TEST(CounterUnitTests, counterSumsThreads) {
+    GCounter counter("CounterUnitTests::counterSumsThreads", "");
+    CounterIncrementThread thread1(&counter, 100000);
+    CounterIncrementThread thread2(&counter, 100000);
+    thread1.start();
+    thread2.start();
+    counter.add(5);
+    thread1.wait();
+    thread2.wait();
+
+    CHECK_EQUAL(200005, counter.getTotal(), "counter total");
+}
+
+IMPLEMENT_TEST(CounterUnitTests, finishedThreadsAreFolded) {
+    // every thread creates its own shard: shards of finished threads must keep their values
+    GCounter counter("CounterUnitTests::finishedThreadsAreFolded", "");
+    GHistogram histogram("CounterUnitTests::finishedThreadsAreFoldedHistogram", "");
+    for (int i = 0; i < 100; i++) {
+        CounterIncrementThread counterThread(&counter, 10);
+        HistogramObserveThread histogramThread(&histogram);
+        counterThread.start();
+        histogramThread.start();
+        counterThread.wait();
+        histogramThread.wait();
+    }
+    counter.add(1);
+
+    CHECK_EQUAL(1001, counter.getTotal(), "counter total");
+    CHECK_EQUAL(100, histogram.getObservationsCount(), "observations count");
+    CHECK_EQUAL(300, histogram.getTotal(), "histogram sum");
+    CHECK_EQUAL(100, histogram.getBuckets()[2], "bucket of the observed value");
+}
+
+IMPLEMENT_TEST(CounterUnitTests, gaugeSet) {
+    GGauge gauge("CounterUnitTests::gaugeSet", "");
+    gauge.add(10);
+    gauge.set(3);
+    CHECK_EQUAL(3, gauge.getTotal(), "gauge value");
+    gauge.add(-1);
+    CHECK_EQUAL(2, gauge.getTotal(), "gauge value");
+}
+
+IMPLEMENT_TEST(CounterUnitTests, histogramPercentiles) {
+    GHistogram histogram("CounterUnitTests::histogramPercentiles", "");
+    for (int i = 0; i < 90; i++) {
+        histogram.observe(3);
+    }
+    for (int i = 0; i < 10; i++) {
+        histogram.observe(1000);
+    }
+
+    CHECK_EQUAL(100, histogram.getObservationsCount(), "observations count");
+    CHECK_EQUAL(90 * 3 + 10 * 1000, histogram.getTotal(), "histogram sum");
+    CHECK_EQUAL(4.0, histogram.getPercentile(50), "median");
+    CHECK_EQUAL(1024.0, histogram.getPercentile(99), "99th percentile");
+}
+
+IMPLEMENT_TEST(CounterUnitTests, histogramBucketBounds) {
+    // the bound of a bucket is inclusive: 2^i is counted in bucket i, 2^i + 1 in bucket i + 1
+    GHistogram histogram("CounterUnitTests::histogramBucketBounds", "");
+    histogram.observe(0);
+    histogram.observe(1);
+    histogram.observe(2);
+    histogram.observe(4);
+    histogram.observe(5);
+    histogram.observe(8);
+
+    const QVector<qint64> buckets = histogram.getBuckets();
+    CHECK_EQUAL(2, buckets[0], "bucket 0 (0 and 1)");
+    CHECK_EQUAL(1, buckets[1], "bucket 1 (2)");
+    CHECK_EQUAL(1, buckets[2], "bucket 2 (4)");
+    CHECK_EQUAL(2, buckets[3], "bucket 3 (5 and 8)");
+    CHECK_EQUAL(0, buckets[4], "bucket 4");
+    CHECK_EQUAL(4.0, histogram.getBucketUpperBound(2), "bound of bucket 2");
+    CHECK_EQUAL(2.0, histogram.getPercentile(50), "median");
+
+    const QString text = CountersExporter::formatCounters();
+    CHECK_TRUE(text.contains("\nugene_counterunittests_histogrambucketbounds_bucket{le=\"1\"} 2\n"), "bucket le=1 is wrong");
+    CHECK_TRUE(text.contains("\nugene_counterunittests_histogrambucketbounds_bucket{le=\"4\"} 4\n"), "bucket le=4 is wrong");
+    CHECK_TRUE(text.contains("\nugene_counterunittests_histogrambucketbounds_bucket{le=\"8\"} 6\n"), "bucket le=8 is wrong");
+}
+
+IMPLEMENT_TEST(CounterUnitTests, exporterFormat) {
+    GCounter counter("CounterUnitTests::exporter counter", "bytes");
+    counter.add(7);
+    GHistogram histogram("CounterUnitTests::exporterHistogram", "");
+    histogram.observe(2);
+
+    const QString text = CountersExporter::formatCounters();
+    CHECK_TRUE(text.contains("# TYPE ugene_counterunittests_exporter_counter_bytes counter\n"), "counter type is not found");
+    CHECK_TRUE(text.contains("\nugene_counterunittests_exporter_counter_bytes 7\n"), "counter value is not found");
+    CHECK_TRUE(text.contains("\nugene_counterunittests_exporterhistogram_bucket{le=\"4\"} 1\n"), "histogram bucket is not found");
+    CHECK_TRUE(text.contains("\nugene_counterunittests_exporterhistogram_count 1\n"), "histogram count is not found");
+}
+
+} // U2
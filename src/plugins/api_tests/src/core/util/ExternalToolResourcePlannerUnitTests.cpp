@@ -0,0 +1,153 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtCore/QDateTime>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
+#include <U2Core/Settings.h>
+
+#include "ExternalToolResourcePlannerUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+const int CPU_COUNT = 8;
+const int MEMORY_MB = 1000;
+
+/* The planner keeps the estimations in the settings, every test uses its own tool */
+class TestTool {
+public:
+    TestTool(const QString &testName)
+        : name(QString("api_tests_%1_%2").arg(testName).arg(QDateTime::currentMSecsSinceEpoch())),
+          cpu(RESOURCE_EXTERNAL_TOOL_CPU, CPU_COUNT, "cpu"),
+          memory(RESOURCE_MEMORY, MEMORY_MB, "memory", "Mb"),
+          planner(&cpu, &memory)
+    {
+    }
+
+    ~TestTool() {
+        Settings *settings = AppContext::getSettings();
+        if (NULL != settings) {
+            settings->remove("external_tool_usage/" + name);
+        }
+    }
+
+    const QString name;
+    AppResourceSemaphore cpu;
+    AppResourceSemaphore memory;
+    ExternalToolResourcePlanner planner;
+};
+
+int getUse(const QList<TaskResourceUsage> &resources, int resourceId) {
+    foreach (const TaskResourceUsage &resource, resources) {
+        if (resource.resourceId == resourceId) {
+            return resource.resourceUse;
+        }
+    }
+    return 0;
+}
+
+const QByteArray STATUS_HEAD = "Name:\tbowtie2-align-s\n"
+                               "State:\tS (sleeping)\n"
+                               "Pid:\t4242\n"
+                               "VmPeak:\t  812344 kB\n"
+                               "VmSize:\t  812340 kB\n";
+const QByteArray STATUS_TAIL = "VmRSS:\t  402112 kB\n"
+                               "Threads:\t4\n";
+
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, threadsQuota) {
+    TestTool tool("threadsQuota");
+    CHECK_EQUAL(1, tool.planner.getThreadsQuota(0), "quota of no threads");
+    CHECK_EQUAL(3, tool.planner.getThreadsQuota(3), "quota of several threads");
+    CHECK_EQUAL(CPU_COUNT, tool.planner.getThreadsQuota(CPU_COUNT * 2), "quota of too many threads");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, planWithoutUsage) {
+    TestTool tool("planWithoutUsage");
+    const QList<TaskResourceUsage> resources = tool.planner.planResources(tool.name, 4);
+    CHECK_EQUAL(1, resources.size(), "resources count");
+    CHECK_EQUAL(4, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores");
+    CHECK_EQUAL(0, getUse(resources, RESOURCE_MEMORY), "memory");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, planByRegisteredUsage) {
+    TestTool tool("planByRegisteredUsage");
+
+    // 4 threads loaded 2 cores: 0.5 cores per thread
+    tool.planner.registerUsage(tool.name, 4, 300, 8, 4);
+    QList<TaskResourceUsage> resources = tool.planner.planResources(tool.name, 4);
+    CHECK_EQUAL(2, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores after the first run");
+    CHECK_EQUAL(300, getUse(resources, RESOURCE_MEMORY), "memory after the first run");
+    resources = tool.planner.planResources(tool.name, 3);
+    CHECK_EQUAL(2, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores are rounded up");
+
+    // the memory goes down by a quarter of the difference, the cores per thread are averaged: (0.5 + 1) / 2
+    tool.planner.registerUsage(tool.name, 4, 100, 16, 4);
+    resources = tool.planner.planResources(tool.name, 4);
+    CHECK_EQUAL(3, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores after the second run");
+    CHECK_EQUAL(250, getUse(resources, RESOURCE_MEMORY), "memory after the second run");
+
+    // a short run changes the memory only
+    tool.planner.registerUsage(tool.name, 4, 400, 100, 0.5);
+    resources = tool.planner.planResources(tool.name, 4);
+    CHECK_EQUAL(3, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores after a short run");
+    CHECK_EQUAL(400, getUse(resources, RESOURCE_MEMORY), "memory after a short run");
+
+    // the estimation is restored by a new planner from the settings
+    ExternalToolResourcePlanner restoredPlanner(&tool.cpu, &tool.memory);
+    resources = restoredPlanner.planResources(tool.name, 4);
+    CHECK_EQUAL(3, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "restored cores");
+    CHECK_EQUAL(400, getUse(resources, RESOURCE_MEMORY), "restored memory");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, planBoundedByBudget) {
+    TestTool tool("planBoundedByBudget");
+    tool.planner.registerUsage(tool.name, 2, 2 * MEMORY_MB, 40, 4);
+    const QList<TaskResourceUsage> resources = tool.planner.planResources(tool.name, 2);
+    CHECK_EQUAL(CPU_COUNT, getUse(resources, RESOURCE_EXTERNAL_TOOL_CPU), "cores");
+    CHECK_EQUAL(MEMORY_MB, getUse(resources, RESOURCE_MEMORY), "memory");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, parsePeakMemory) {
+    const QByteArray status = STATUS_HEAD + "VmHWM:\t  409600 kB\n" + STATUS_TAIL;
+    CHECK_EQUAL(400, ExternalToolUsageMonitor::parsePeakMemoryMb(status), "peak memory");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, parsePeakMemoryMissing) {
+    CHECK_EQUAL(-1, ExternalToolUsageMonitor::parsePeakMemoryMb(STATUS_HEAD + STATUS_TAIL), "peak memory without VmHWM");
+    CHECK_EQUAL(-1, ExternalToolUsageMonitor::parsePeakMemoryMb(STATUS_HEAD + "VmHWM:\n" + STATUS_TAIL), "peak memory without the value");
+    CHECK_EQUAL(-1, ExternalToolUsageMonitor::parsePeakMemoryMb(QByteArray()), "peak memory of empty status");
+}
+
+IMPLEMENT_TEST(ExternalToolResourcePlannerUnitTests, parseCpuTicks) {
+    const QByteArray stat = "4242 (tool (1) x) S 1 4242 4242 0 -1 4194304 120 0 0 0 150 50 0 0 20 0 4 0 100 812340 100528\n";
+    CHECK_EQUAL(200, ExternalToolUsageMonitor::parseCpuTicks(stat), "CPU ticks");
+    CHECK_EQUAL(-1, ExternalToolUsageMonitor::parseCpuTicks("4242 (tool) S 1 4242"), "CPU ticks of a short line");
+    CHECK_EQUAL(-1, ExternalToolUsageMonitor::parseCpuTicks("4242 tool S 1 4242 4242 0 -1 4194304 120 0 0 0 150 50"), "CPU ticks without the name");
+}
+
+} // U2
@@ -0,0 +1,123 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QDir>
+#include <QEventLoop>
+#include <QThread>
+
+#include <U2Algorithm/DnaAssemblyAlgRegistry.h>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/BaseDocumentFormats.h>
+#include <U2Core/DocumentModel.h>
+#include <U2Core/DocumentUtils.h>
+#include <U2Core/PluginModel.h>
+
+#include <U2Lang/ActorPrototypeRegistry.h>
+#include <U2Lang/WorkflowEnv.h>
+
+#include "LazyPluginLoadingUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+// provided by the hmm3 and repeat_finder plugins
+const QString PLUGIN_FORMAT_ID = "hmmer_document_format";
+const QString PLUGIN_ELEMENT_ID = "repeats-search";
+// registered by the genome_aligner plugin, DnaAssemblyAlgRegistry can't load a plugin on demand
+const QString PLUGIN_ASSEMBLY_ALGORITHM_ID = "UGENE Genome Aligner";
+
+class RequestThread : public QThread {
+public:
+    enum Request {
+        Format,
+        WorkflowElement,
+        UnknownCapability
+    };
+
+    RequestThread(Request request)
+        : request(request), found(false) {}
+
+    void run() {
+        switch (request) {
+        case Format:
+            found = NULL != AppContext::getDocumentFormatRegistry()->getFormatById(PLUGIN_FORMAT_ID);
+            break;
+        case WorkflowElement:
+            found = NULL != Workflow::WorkflowEnv::getProtoRegistry()->getProto(PLUGIN_ELEMENT_ID);
+            break;
+        case UnknownCapability:
+            found = AppContext::getPluginSupport()->loadPluginProviding(PluginCapability_DocumentFormat, "unknown_format_id");
+            break;
+        }
+    }
+
+    const Request request;
+    bool found;
+};
+
+// the main thread must process events while the worker waits for a plugin to be loaded
+bool runInWorkerThread(RequestThread::Request request) {
+    RequestThread thread(request);
+    QEventLoop loop;
+    QObject::connect(&thread, SIGNAL(finished()), &loop, SLOT(quit()));
+    thread.start();
+    if (!thread.isFinished()) {
+        loop.exec();
+    }
+    thread.wait();
+    return thread.found;
+}
+
+}
+
+IMPLEMENT_TEST(LazyPluginLoadingUnitTests, formatFromWorkerThread) {
+    CHECK_TRUE(runInWorkerThread(RequestThread::Format), "plugin format is not found from a worker thread");
+    CHECK_TRUE(NULL != AppContext::getDocumentFormatRegistry()->getFormatById(PLUGIN_FORMAT_ID), "plugin format is not registered");
+}
+
+IMPLEMENT_TEST(LazyPluginLoadingUnitTests, workflowElementFromWorkerThread) {
+    CHECK_TRUE(runInWorkerThread(RequestThread::WorkflowElement), "plugin workflow element is not found from a worker thread");
+    CHECK_TRUE(NULL != Workflow::WorkflowEnv::getProtoRegistry()->getProto(PLUGIN_ELEMENT_ID), "plugin workflow element is not registered");
+}
+
+IMPLEMENT_TEST(LazyPluginLoadingUnitTests, unknownCapabilityFromWorkerThread) {
+    CHECK_FALSE(runInWorkerThread(RequestThread::UnknownCapability), "a plugin is loaded for an unknown format");
+}
+
+IMPLEMENT_TEST(LazyPluginLoadingUnitTests, pluginFormatIsDetectedByContent) {
+    // BAM is provided by the dbi_bam plugin
+    const QString bamUrl = QDir::searchPaths(PATH_PREFIX_DATA).first() + "/samples/Assembly/chrM.sorted.bam";
+    FormatDetectionConfig config;
+    config.useExtensionBonus = false;
+    const QList<FormatDetectionResult> results = DocumentUtils::detectFormat(GUrl(bamUrl), config);
+    CHECK_FALSE(results.isEmpty(), "format is not detected");
+    CHECK_TRUE(NULL != results.first().format, "format is not detected");
+    CHECK_EQUAL(BaseDocumentFormats::BAM, results.first().format->getFormatId(), "detected format");
+}
+
+IMPLEMENT_TEST(LazyPluginLoadingUnitTests, registryPluginIsLoaded) {
+    CHECK_TRUE(NULL != AppContext::getDnaAssemblyAlgRegistry()->getAlgorithm(PLUGIN_ASSEMBLY_ALGORITHM_ID), "assembly algorithm of a plugin is not registered");
+}
+
+} // U2
@@ -0,0 +1,47 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_LAZY_PLUGIN_LOADING_UNIT_TESTS_H_
+#define _U2_LAZY_PLUGIN_LOADING_UNIT_TESTS_H_
+
+#include <unittest.h>
+
+namespace U2 {
+
+/* With --lazy-plugins the requests load the deferred plugins, the worker threads wait for the main thread */
+DECLARE_TEST(LazyPluginLoadingUnitTests, formatFromWorkerThread);
+DECLARE_TEST(LazyPluginLoadingUnitTests, workflowElementFromWorkerThread);
+DECLARE_TEST(LazyPluginLoadingUnitTests, unknownCapabilityFromWorkerThread);
+/* Content-based format detection checks the formats of the deferred plugins too */
+DECLARE_TEST(LazyPluginLoadingUnitTests, pluginFormatIsDetectedByContent);
+/* Plugins populating the registries that can't load them on demand are not deferred */
+DECLARE_TEST(LazyPluginLoadingUnitTests, registryPluginIsLoaded);
+
+} // U2
+
+DECLARE_METATYPE(LazyPluginLoadingUnitTests, formatFromWorkerThread);
+DECLARE_METATYPE(LazyPluginLoadingUnitTests, workflowElementFromWorkerThread);
+DECLARE_METATYPE(LazyPluginLoadingUnitTests, unknownCapabilityFromWorkerThread);
+DECLARE_METATYPE(LazyPluginLoadingUnitTests, pluginFormatIsDetectedByContent);
+DECLARE_METATYPE(LazyPluginLoadingUnitTests, registryPluginIsLoaded);
+
+#endif // _U2_LAZY_PLUGIN_LOADING_UNIT_TESTS_H_
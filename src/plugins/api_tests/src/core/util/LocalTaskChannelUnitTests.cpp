@@ -0,0 +1,94 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QBuffer>
+
+#include <U2Remote/LocalTaskDistribution.h>
+
+#include "LocalTaskChannelUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+QByteArray writeMessages(const QVariantList &messages) {
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    foreach (const QVariant &message, messages) {
+        LocalTaskChannel::writeMessage(&device, message);
+    }
+    return device.data();
+}
+
+QVariant getPartMessage() {
+    QVariantMap settings;
+    settings["sequence"] = QByteArray("ACGT\0ACGT", 9);
+    settings["offset"] = qint64(1) << 40;
+    settings["name"] = QString::fromUtf8("part \xd1\x87");
+    settings["regions"] = QVariantList() << 1 << 2 << 3;
+    return QVariantList() << QString("factory") << 7 << QVariant(settings);
+}
+
+}
+
+IMPLEMENT_TEST(LocalTaskChannelUnitTests, messageRoundTrip) {
+    const QVariant message = getPartMessage();
+    QByteArray buffer = writeMessages(QVariantList() << message);
+
+    QVariant received;
+    CHECK_TRUE(LocalTaskChannel::takeMessage(buffer, received), "message is not taken");
+    CHECK_TRUE(message == received, "message is not restored");
+    CHECK_TRUE(buffer.isEmpty(), "buffer is not empty");
+}
+
+IMPLEMENT_TEST(LocalTaskChannelUnitTests, incompleteMessage) {
+    const QVariant message = getPartMessage();
+    const QByteArray data = writeMessages(QVariantList() << message);
+
+    QByteArray buffer;
+    QVariant received;
+    for (int i = 0; i < data.size() - 1; i++) {
+        buffer.append(data[i]);
+        CHECK_FALSE(LocalTaskChannel::takeMessage(buffer, received), QString("message is taken from %1 bytes").arg(buffer.size()));
+        CHECK_EQUAL(i + 1, buffer.size(), "buffer size");
+    }
+    buffer.append(data[data.size() - 1]);
+    CHECK_TRUE(LocalTaskChannel::takeMessage(buffer, received), "complete message is not taken");
+    CHECK_TRUE(message == received, "message is not restored");
+}
+
+IMPLEMENT_TEST(LocalTaskChannelUnitTests, severalMessages) {
+    // an empty list is the stop message of the worker
+    const QVariantList messages = QVariantList() << getPartMessage() << QVariant(QVariantList()) << QVariant(QString("error"));
+    QByteArray buffer = writeMessages(messages);
+
+    foreach (const QVariant &message, messages) {
+        QVariant received;
+        CHECK_TRUE(LocalTaskChannel::takeMessage(buffer, received), "message is not taken");
+        CHECK_TRUE(message == received, "message is not restored");
+    }
+    CHECK_TRUE(buffer.isEmpty(), "buffer is not empty");
+    QVariant received;
+    CHECK_FALSE(LocalTaskChannel::takeMessage(buffer, received), "message is taken from the empty buffer");
+}
+
+} // U2
@@ -0,0 +1,241 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QThread>
+
+#include <U2Core/GUrlUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+
+#include <U2Lang/WorkflowResultCache.h>
+
+#include "WorkflowResultCacheUnitTests.h"
+
+namespace U2 {
+
+namespace {
+
+class SThread : public QThread {
+public:
+    static void msleep(unsigned long msecs) { QThread::msleep(msecs); }
+};
+
+QString getTestDir(const QString &name) {
+    return QDir::temp().absoluteFilePath(QString("workflow_result_cache_%1_%2")
+        .arg(name).arg(QCoreApplication::applicationPid()));
+}
+
+bool writeFile(const QString &url, const QByteArray &data) {
+    QFile file(url);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return data.size() == file.write(data);
+}
+
+QByteArray readFile(const QString &url) {
+    QFile file(url);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+/* The cache is global: every test uses its own directory and disables the cache at the end */
+class TestCache {
+public:
+    TestCache(const QString &name)
+        : dirPath(getTestDir(name))
+    {
+        U2OpStatus2Log os;
+        GUrlUtils::removeDir(dirPath, os);
+        QDir().mkpath(dirPath + "/step");
+        WorkflowResultCache::setCacheDirectory(dirPath + "/cache");
+    }
+
+    ~TestCache() {
+        WorkflowResultCache::setCacheDirectory(QString());
+        U2OpStatus2Log os;
+        GUrlUtils::removeDir(dirPath, os);
+    }
+
+    QString path(const QString &fileName) const {
+        return QDir(dirPath).filePath(fileName);
+    }
+
+    const QString dirPath;
+};
+
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, keyHash) {
+    TestCache cache("key_hash");
+    const QString input = cache.path("input.fa");
+    CHECK_TRUE(writeFile(input, ">seq\nACGT\n"), "input is not written");
+
+    WorkflowResultCacheKey key("align", "1.0");
+    key.addParameter("threads", 4);
+    key.addParameter("mode", "fast");
+    key.addInputFile(input);
+
+    WorkflowResultCacheKey sameKey("align", "1.0");
+    sameKey.addParameter("mode", "fast");
+    sameKey.addParameter("threads", "4");
+    sameKey.addInputFile(input);
+
+    WorkflowResultCacheKey otherParameterKey("align", "1.0");
+    otherParameterKey.addParameter("threads", 4);
+    otherParameterKey.addParameter("mode", "sensitive");
+    otherParameterKey.addInputFile(input);
+
+    WorkflowResultCacheKey otherVersionKey("align", "1.1");
+    otherVersionKey.addParameter("threads", 4);
+    otherVersionKey.addParameter("mode", "fast");
+    otherVersionKey.addInputFile(input);
+
+    U2OpStatusImpl os;
+    const QString hash = key.computeHash(os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(40, hash.length(), "hash length");
+
+    const QString sameHash = sameKey.computeHash(os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(hash, sameHash, "hash of the equal key");
+
+    const QString otherParameterHash = otherParameterKey.computeHash(os);
+    CHECK_NO_ERROR(os);
+    CHECK_NOT_EQUAL(hash, otherParameterHash, "hash of the key with another parameter value");
+
+    const QString otherVersionHash = otherVersionKey.computeHash(os);
+    CHECK_NO_ERROR(os);
+    CHECK_NOT_EQUAL(hash, otherVersionHash, "hash of the key with another tool version");
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, keyHashMissingInput) {
+    TestCache cache("key_hash_missing_input");
+    WorkflowResultCacheKey key("align", "1.0");
+    key.addInputFile(cache.path("missing.fa"));
+
+    U2OpStatusImpl os;
+    const QString hash = key.computeHash(os);
+    CHECK_TRUE(os.hasError(), "no error for the missing input file");
+    CHECK_TRUE(hash.isEmpty(), "hash of the missing input file");
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, cacheHit) {
+    TestCache cache("cache_hit");
+    const QString stepBase = cache.path("step/reads");
+    CHECK_TRUE(writeFile(stepBase + ".idx", "index"), "index output is not written");
+    CHECK_TRUE(writeFile(stepBase + ".data", "data"), "data output is not written");
+    CHECK_TRUE(writeFile(stepBase + "_other", "other"), "unrelated file is not written");
+
+    U2OpStatusImpl os;
+    WorkflowResultCache::store("0123456789abcdef", stepBase, QStringList() << ".idx" << ".data", os);
+    CHECK_NO_ERROR(os);
+
+    const QString restoredBase = cache.path("restored/reads");
+    const bool restored = WorkflowResultCache::restore("0123456789abcdef", restoredBase, os);
+    CHECK_NO_ERROR(os);
+    CHECK_TRUE(restored, "the stored entry is not restored");
+    const QString restoredIndex = readFile(restoredBase + ".idx");
+    CHECK_EQUAL(QString("index"), restoredIndex, "restored index output");
+    const QString restoredData = readFile(restoredBase + ".data");
+    CHECK_EQUAL(QString("data"), restoredData, "restored data output");
+    CHECK_FALSE(QFile::exists(restoredBase + "_other"), "unrelated file is restored");
+
+    const int restoredFilesCount = QDir(cache.path("restored")).entryList(QDir::Files).size();
+    CHECK_EQUAL(2, restoredFilesCount, "restored files count");
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, cacheMiss) {
+    TestCache cache("cache_miss");
+    const QString outputBase = cache.path("step/reads");
+
+    U2OpStatusImpl os;
+    const bool restored = WorkflowResultCache::restore("0123456789abcdef", outputBase, os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(restored, "restored without an entry");
+
+    WorkflowResultCache::setCacheDirectory(QString());
+    CHECK_TRUE(writeFile(outputBase + ".idx", "index"), "output is not written");
+    WorkflowResultCache::store("0123456789abcdef", outputBase, QStringList() << ".idx", os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(QDir(cache.path("cache")).exists(), "the disabled cache stores the outputs");
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, inputModified) {
+    TestCache cache("input_modified");
+    const QString input = cache.path("input.fa");
+    CHECK_TRUE(writeFile(input, ">seq\nACGT\n"), "input is not written");
+
+    WorkflowResultCacheKey key("align", "1.0");
+    key.addInputFile(input);
+
+    U2OpStatusImpl os;
+    const QString hash = key.computeHash(os);
+    CHECK_NO_ERROR(os);
+
+    const QString stepBase = cache.path("step/reads");
+    CHECK_TRUE(writeFile(stepBase + ".idx", "index"), "output is not written");
+    WorkflowResultCache::store(hash, stepBase, QStringList() << ".idx", os);
+    CHECK_NO_ERROR(os);
+
+    // the file hashes are memorized by the size and the modification time with the seconds precision,
+    // so the input is rewritten with the same size in the next second
+    SThread::msleep(1100);
+    CHECK_TRUE(writeFile(input, ">seq\nTTTT\n"), "input is not rewritten");
+
+    const QString modifiedHash = key.computeHash(os);
+    CHECK_NO_ERROR(os);
+    CHECK_NOT_EQUAL(hash, modifiedHash, "hash of the key with the modified input");
+
+    const bool restored = WorkflowResultCache::restore(modifiedHash, cache.path("restored/reads"), os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(restored, "the outdated entry is restored");
+}
+
+IMPLEMENT_TEST(WorkflowResultCacheUnitTests, restoreFailureCleanup) {
+    TestCache cache("restore_failure");
+    const QString stepBase = cache.path("step/reads");
+    CHECK_TRUE(writeFile(stepBase + ".a", "first"), "first output is not written");
+    CHECK_TRUE(writeFile(stepBase + ".b", "second"), "second output is not written");
+
+    U2OpStatusImpl os;
+    WorkflowResultCache::store("0123456789abcdef", stepBase, QStringList() << ".*", os);
+    CHECK_NO_ERROR(os);
+
+    // the second output can not replace a non-empty folder
+    const QString restoredBase = cache.path("restored/reads");
+    CHECK_TRUE(QDir().mkpath(restoredBase + ".b/content"), "blocking folder is not created");
+
+    const bool restored = WorkflowResultCache::restore("0123456789abcdef", restoredBase, os);
+    CHECK_TRUE(os.hasError(), "no error for the failed restoring");
+    CHECK_FALSE(restored, "the failed entry is restored");
+    CHECK_FALSE(QFile::exists(restoredBase + ".a"), "partially restored output is not removed");
+
+    const QStringList leftFiles = QDir(cache.path("restored")).entryList(QDir::Files);
+    CHECK_TRUE(leftFiles.isEmpty(), "temporary files are not removed: " + leftFiles.join(", "));
+}
+
+} // U2
@@ -0,0 +1,103 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+
+#include <U2Core/CMDLineRegistry.h>
+#include <U2Core/GUrlUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+
+#include <U2Lang/WorkflowContext.h>
+
+#include "WorkflowRunOptionsUnitTests.h"
+
+namespace U2 {
+
+using namespace Workflow;
+
+namespace {
+
+QStringList getJobArguments() {
+    return QStringList() << "ugene" << "--task=align.uwl" << "--in=input.aln" << "--ugene-output-error";
+}
+
+QString getJobRoot(const QString &name) {
+    return QDir::temp().absoluteFilePath(QString("workflow_run_options_%1_%2")
+        .arg(name).arg(QCoreApplication::applicationPid()));
+}
+
+}
+
+IMPLEMENT_TEST(WorkflowRunOptionsUnitTests, cmdLineArguments) {
+    const QStringList args = getJobArguments();
+    CMDLineRegistry cmdLine(args);
+
+    CHECK_TRUE(args == cmdLine.getArguments(), "arguments are not kept");
+    CHECK_TRUE(cmdLine.hasParameter("ugene-output-error"), "the error option of the job is not found");
+    CHECK_FALSE(cmdLine.hasParameter("ugene-output-progress-state"), "unexpected progress option");
+    CHECK_EQUAL(QString("input.aln"), cmdLine.getParameterValue("in"), "in parameter");
+}
+
+IMPLEMENT_TEST(WorkflowRunOptionsUnitTests, jobOutputDirectory) {
+    const QString root = getJobRoot("output") + "/job";
+    CHECK_FALSE(QDir(root).exists(), "output directory exists before the test");
+
+    U2OpStatusImpl os;
+    const QString dir = WorkflowContextCMDLine::getOutputDirectory(root, os);
+    CHECK_NO_ERROR(os);
+    CHECK_EQUAL(QDir(root).absolutePath(), dir, "output directory");
+    CHECK_TRUE(QDir(root).exists(), "output directory is not created");
+
+    GUrlUtils::removeDir(getJobRoot("output"), os);
+    CHECK_NO_ERROR(os);
+}
+
+IMPLEMENT_TEST(WorkflowRunOptionsUnitTests, defaultOutputDirectory) {
+    U2OpStatusImpl os;
+    const QString dir = WorkflowContextCMDLine::getOutputDirectory(QString(), os);
+    CHECK_NO_ERROR(os);
+    CHECK_FALSE(dir.isEmpty(), "output directory is empty");
+    CHECK_TRUE(QDir(dir).exists(), "output directory does not exist");
+}
+
+IMPLEMENT_TEST(WorkflowRunOptionsUnitTests, jobRunInfo) {
+    const QString root = getJobRoot("run_info");
+    CHECK_TRUE(QDir().mkpath(root), "can not create the job directory");
+
+    const QStringList args = getJobArguments();
+    CMDLineRegistry cmdLine(args);
+    WorkflowContextCMDLine::saveRunInfo(root + "/", &cmdLine);
+
+    QFile runInfo(root + "/run.info");
+    CHECK_TRUE(runInfo.open(QIODevice::ReadOnly), "run.info is not written");
+    const QString written = QString::fromUtf8(runInfo.readAll());
+    runInfo.close();
+    CHECK_EQUAL(args.join(" ") + "\n", written, "run.info content");
+
+    U2OpStatusImpl os;
+    GUrlUtils::removeDir(root, os);
+    CHECK_NO_ERROR(os);
+}
+
+} // U2
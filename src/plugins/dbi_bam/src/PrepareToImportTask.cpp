@@ -110,7 +110,7 @@ void PrepareToImportTask::run() {
         newURL = true;
         stateInfo.setDescription(LoadInfoTask::tr("Sorting BAM"));
 
-        sortedBamUrl = BAMUtils::sortBam(bamUrl, getSortedBamUrl(bamUrl), stateInfo).getURLString();
+        sortedBamUrl = BAMUtils::sortBam(bamUrl, getSortedBamUrl(bamUrl), stateInfo, 0, true).getURLString();
         CHECK_OP(stateInfo, );
     }
     stateInfo.setProgress( 66 );
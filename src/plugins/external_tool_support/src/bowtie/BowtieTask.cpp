@@ -23,7 +23,9 @@
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/AppResources.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Formats/BgzipTask.h>
+#include <U2Formats/SamToBamStreamConverter.h>
 
 #include "BowtieSupport.h"
 #include "BowtieTask.h"
@@ -219,11 +221,9 @@ void BowtieAssembleTask::prepare() {
     if(settings.getCustomValue(BowtieTask::OPTION_COLORSPACE, false).toBool()) {
         arguments.append("-C");
     }
-    {
-        int threads = settings.getCustomValue(BowtieTask::OPTION_THREADS, 1).toInt();
-        arguments.append(QString("--threads"));
-        arguments.append(QString::number(threads));
-    }
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(BowtieTask::OPTION_THREADS, 1).toInt());
+    arguments.append(QString("--threads"));
+    arguments.append(QString::number(threads));
 
     // We assume all datasets have the same format
     if(!settings.shortReadSets.isEmpty())
@@ -282,9 +282,17 @@ void BowtieAssembleTask::prepare() {
             arguments.append(downstreamReads.join(","));
         }
     }
-    arguments.append(settings.resultFileName.getURLString());
+    const QString resultUrl = settings.resultFileName.getURLString();
+    const bool bamOutput = SamToBamStreamConverter::isBamUrl(resultUrl);
+    if (!bamOutput) {
+        arguments.append(resultUrl);
+    }
     logParser = new LogParser();
     ExternalToolRunTask *task = new ExternalToolRunTask(ET_BOWTIE, arguments, logParser, NULL);
+    task->reserveResources(threads);
+    if (bamOutput) {
+        task->setStandartOutputConsumer(new SamToBamStreamConverter(resultUrl));
+    }
     addSubTask(task);
 }
 
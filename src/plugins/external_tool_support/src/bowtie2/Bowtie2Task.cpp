@@ -23,7 +23,9 @@
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/AppResources.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Formats/BgzipTask.h>
+#include <U2Formats/SamToBamStreamConverter.h>
 
 #include "Bowtie2Support.h"
 #include "Bowtie2Task.h"
@@ -105,11 +107,9 @@ void Bowtie2AlignTask::prepare() {
         }
     }
 
-    {
-        int threads = settings.getCustomValue(Bowtie2Task::OPTION_THREADS, 1).toInt();
-        arguments.append(QString("--threads"));
-        arguments.append(QString::number(threads));
-    }
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(Bowtie2Task::OPTION_THREADS, 1).toInt());
+    arguments.append(QString("--threads"));
+    arguments.append(QString::number(threads));
 
     if (settings.getCustomValue(Bowtie2Task::OPTION_NOMIXED, false).toBool()) {
         arguments.append("--no-mixed");
@@ -190,10 +190,18 @@ void Bowtie2AlignTask::prepare() {
             arguments.append(downstreamReads.join(","));
         }
     }
-    arguments.append("-S");
-    arguments.append(settings.resultFileName.getURLString());
+    const QString resultUrl = settings.resultFileName.getURLString();
+    const bool bamOutput = SamToBamStreamConverter::isBamUrl(resultUrl);
+    if (!bamOutput) {
+        arguments.append("-S");
+        arguments.append(resultUrl);
+    }
 
     ExternalToolRunTask *task = new ExternalToolRunTask(ET_BOWTIE2_ALIGN, arguments, new ExternalToolLogParser());
+    task->reserveResources(threads);
+    if (bamOutput) {
+        task->setStandartOutputConsumer(new SamToBamStreamConverter(resultUrl));
+    }
     addSubTask(task);
 }
 
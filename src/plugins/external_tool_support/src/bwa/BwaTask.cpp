@@ -21,10 +21,17 @@
 
 #include <QtCore/QDir>
 
+#include <U2Core/AppContext.h>
 #include <U2Core/Counter.h>
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/AppResources.h>
+#include <U2Core/ExternalToolRegistry.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
+
+#include <U2Formats/SamToBamStreamConverter.h>
+
+#include <U2Lang/WorkflowResultCache.h>
 
 #include "BwaSupport.h"
 #include "BwaTask.h"
@@ -52,7 +59,14 @@ void BwaBuildIndexTask::prepare() {
     arguments.append("-p");
     arguments.append(indexPath);
     arguments.append(referencePath);
-    ExternalToolRunTask *task = new ExternalToolRunTask(ET_BWA, arguments, new LogParser());
+    Task *task = new ExternalToolRunTask(ET_BWA, arguments, new LogParser());
+    if (WorkflowResultCache::isEnabled()) {
+        ExternalTool *bwa = AppContext::getExternalToolRegistry()->getByName(ET_BWA);
+        WorkflowResultCacheKey key("bwa-index", NULL == bwa ? QString() : bwa->getVersion());
+        key.addParameter(BwaTask::OPTION_INDEX_ALGORITHM, indexAlg);
+        key.addInputFile(referencePath);
+        task = new WorkflowResultCacheTask(key, indexPath, BwaTask::indexSuffixes, task);
+    }
     addSubTask(task);
 }
 
@@ -128,8 +142,9 @@ void BwaAlignTask::prepare() {
         arguments.append("-m");
         arguments.append(settings.getCustomValue(BwaTask::OPTION_MAX_QUEUE_ENTRIES, 2000000).toString());
 
+        const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toInt());
         arguments.append("-t");
-        arguments.append(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toString());
+        arguments.append(QString::number(threads));
 
         arguments.append("-M");
         arguments.append(settings.getCustomValue(BwaTask::OPTION_MISMATCH_PENALTY, 3).toString());
@@ -161,7 +176,8 @@ void BwaAlignTask::prepare() {
         arguments.append( getSAIPath( readSet.url.getURLString()) );
         arguments.append(indexPath);
         arguments.append(readSet.url.getURLString());
-        Task* alignTask = new ExternalToolRunTask(ET_BWA, arguments, new LogParser(), NULL);
+        ExternalToolRunTask* alignTask = new ExternalToolRunTask(ET_BWA, arguments, new LogParser(), NULL);
+        alignTask->reserveResources(threads);
         addSubTask(alignTask);
         alignTasks.append(alignTask);
     }
@@ -177,8 +193,11 @@ QList<Task *> BwaAlignTask::onSubTaskFinished(Task *subTask) {
 
         settings.pairedReads ? arguments.append("sampe") : arguments.append("samse");
 
-        arguments.append("-f");
-        arguments.append(resultPath);
+        const bool bamOutput = SamToBamStreamConverter::isBamUrl(resultPath);
+        if (!bamOutput) {
+            arguments.append("-f");
+            arguments.append(resultPath);
+        }
         arguments.append(indexPath);
 
         foreach (const ShortReadSet& set, readSets) {
@@ -191,6 +210,10 @@ QList<Task *> BwaAlignTask::onSubTaskFinished(Task *subTask) {
 
         alignmentPerformed = true;
         ExternalToolRunTask *task = new ExternalToolRunTask(ET_BWA, arguments, new LogParser(), NULL);
+        task->reserveResources(1);
+        if (bamOutput) {
+            task->setStandartOutputConsumer(new SamToBamStreamConverter(resultPath));
+        }
         result.append(task);
     }
 
@@ -255,8 +278,9 @@ void BwaMemAlignTask::prepare() {
 
     arguments.append("mem");
 
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toInt());
     arguments.append("-t");
-    arguments.append(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toString());
+    arguments.append(QString::number(threads));
 
     arguments.append("-k");
     arguments.append(settings.getCustomValue(BwaTask::OPTION_MIN_SEED, 19).toString());
@@ -319,7 +343,13 @@ void BwaMemAlignTask::prepare() {
     }
 
     ExternalToolRunTask* alignTask = new ExternalToolRunTask(ET_BWA, arguments, new BwaAlignTask::LogParser(), NULL);
-    alignTask->setStandartOutputFile(settings.resultFileName.getURLString() );
+    alignTask->reserveResources(threads);
+    const QString resultUrl = settings.resultFileName.getURLString();
+    if (SamToBamStreamConverter::isBamUrl(resultUrl)) {
+        alignTask->setStandartOutputConsumer(new SamToBamStreamConverter(resultUrl));
+    } else {
+        alignTask->setStandartOutputFile(resultUrl);
+    }
     addSubTask(alignTask);
 }
 
@@ -353,8 +383,12 @@ void BwaSwAlignTask::prepare() {
 
     arguments.append("bwasw");
 
-    arguments.append("-f");
-    arguments.append( settings.resultFileName.getURLString() );
+    const QString resultUrl = settings.resultFileName.getURLString();
+    const bool bamOutput = SamToBamStreamConverter::isBamUrl(resultUrl);
+    if (!bamOutput) {
+        arguments.append("-f");
+        arguments.append(resultUrl);
+    }
 
     arguments.append("-a");
     arguments.append(settings.getCustomValue(BwaTask::OPTION_MATCH_SCORE, 1).toString());
@@ -368,8 +402,9 @@ void BwaSwAlignTask::prepare() {
     arguments.append("-r");
     arguments.append(settings.getCustomValue(BwaTask::OPTION_GAP_EXTENSION_PENALTY, 2).toString());
 
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toInt());
     arguments.append("-t");
-    arguments.append(settings.getCustomValue(BwaTask::OPTION_THREADS, 1).toString());
+    arguments.append(QString::number(threads));
 
     arguments.append("-s");
     arguments.append(settings.getCustomValue(BwaTask::OPTION_CHUNK_SIZE, 10000000).toString());
@@ -397,7 +432,11 @@ void BwaSwAlignTask::prepare() {
     arguments.append( readSet.url.getURLString() );
 
 
-    Task* alignTask = new ExternalToolRunTask(ET_BWA, arguments, new BwaAlignTask::LogParser(), NULL);
+    ExternalToolRunTask* alignTask = new ExternalToolRunTask(ET_BWA, arguments, new BwaAlignTask::LogParser(), NULL);
+    alignTask->reserveResources(threads);
+    if (bamOutput) {
+        alignTask->setStandartOutputConsumer(new SamToBamStreamConverter(resultUrl));
+    }
     addSubTask(alignTask);
 
 }
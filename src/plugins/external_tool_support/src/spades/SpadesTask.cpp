@@ -28,6 +28,7 @@
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/AppResources.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Core/U2SafePoints.h>
 #include <U2Core/FileAndDirectoryUtils.h>
 
@@ -82,8 +83,9 @@ void SpadesTask::prepare() {
     arguments.append("--dataset");
     arguments.append(settings.outDir.getURLString() + QDir::separator() + SpadesTask::YAML_FILE_NAME);
 
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(settings.getCustomValue(SpadesTask::OPTION_THREADS, "16").toInt());
     arguments.append("-t");
-    arguments.append(settings.getCustomValue(SpadesTask::OPTION_THREADS, "16").toString());
+    arguments.append(QString::number(threads));
 
     arguments.append("-m");
     arguments.append(settings.getCustomValue(SpadesTask::OPTION_MEMLIMIT, "250").toString());
@@ -100,7 +102,9 @@ void SpadesTask::prepare() {
     //it uses system call gzip. it might not be installed
     arguments.append("--disable-gzip-output");
 
-    assemblyTask = new ExternalToolRunTask(ET_SPADES, arguments, new SpadesLogParser(), settings.outDir.getURLString());
+    ExternalToolRunTask *runTask = new ExternalToolRunTask(ET_SPADES, arguments, new SpadesLogParser(), settings.outDir.getURLString());
+    runTask->reserveResources(threads);
+    assemblyTask = runTask;
     addSubTask(assemblyTask);
 }
 
@@ -24,9 +24,11 @@
 #include <QCoreApplication>
 
 #include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
 #include <U2Core/AppSettings.h>
 #include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/Counter.h>
+#include <U2Core/ExternalToolResourcePlanner.h>
 #include <U2Core/GUrl.h>
 #include <U2Core/GUrlUtils.h>
 #include <U2Core/IOAdapter.h>
@@ -167,7 +169,8 @@ ExternalToolRunTask * TopHatSupportTask::runTophat() {
     // Init the arguments list
     QStringList arguments;
 
-    arguments << "-p" << QString::number(TopHatSettings::getThreadsCount());
+    const int threads = AppResourcePool::instance()->getExternalToolResourcePlanner()->getThreadsQuota(TopHatSettings::getThreadsCount());
+    arguments << "-p" << QString::number(threads);
     arguments << "--output-dir" << settings.outDir;
     arguments << "--mate-inner-dist" << QString::number(settings.mateInnerDistance);
     arguments << "--mate-std-dev" << QString::number(settings.mateStandardDeviation);
@@ -224,6 +227,7 @@ ExternalToolRunTask * TopHatSupportTask::runTophat() {
         new ExternalToolLogParser(),
         workingDirectory,
         additionalPaths);
+    runTask->reserveResources(threads);
     setListenerForTask(runTask);
     return runTask;
 }
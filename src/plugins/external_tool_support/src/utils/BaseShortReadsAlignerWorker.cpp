@@ -286,7 +286,9 @@ void BaseShortReadsAlignerWorkerFactory::addCommonAttributes(QList<Attribute*>&
 
         Descriptor outName(OUTPUT_NAME,
             BaseShortReadsAlignerWorker::tr("Output file name"),
-            BaseShortReadsAlignerWorker::tr("Base name of the output file. 'out.sam' by default"));
+            BaseShortReadsAlignerWorker::tr("Base name of the output file. 'out.sam' by default. "
+                                            "If the name has the 'bam' extension, the aligner output is converted to BAM on the fly "
+                                            "without an intermediate SAM file"));
 
         attrs << new Attribute(outDir, BaseTypes::STRING_TYPE(), true, QVariant(""));
         attrs << new Attribute(refGenome, BaseTypes::STRING_TYPE(), true, QVariant(""));
@@ -5,6 +5,8 @@ HEADERS += src/BuildSArraySettingsWidget.h \
            src/GenomeAlignerCMDLineTask.h \
            src/GenomeAlignerFindTask.h \
            src/GenomeAlignerIndex.h \
+           src/GenomeAlignerIndexCache.h \
+           src/GenomeAlignerIndexCacheTests.h \
            src/GenomeAlignerIndexPart.h \
            src/GenomeAlignerIndexTask.h \
            src/GenomeAlignerIO.h \
@@ -27,6 +29,8 @@ SOURCES += src/BuildSArraySettingsWidget.cpp \
            src/GenomeAlignerCMDLineTask.cpp \
            src/GenomeAlignerFindTask.cpp \
            src/GenomeAlignerIndex.cpp \
+           src/GenomeAlignerIndexCache.cpp \
+           src/GenomeAlignerIndexCacheTests.cpp \
            src/GenomeAlignerIndexPart.cpp \
            src/GenomeAlignerIndexTask.cpp \
            src/GenomeAlignerIO.cpp \
@@ -22,7 +22,9 @@
 #include "GenomeAlignerIO.h"
 
 #include <U2Core/AppContext.h>
+#include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/Counter.h>
+#include <U2Core/DocumentUtils.h>
 #include <U2Core/U2AssemblyDbi.h>
 #include <U2Core/U2AttributeDbi.h>
 #include <U2Core/U2CoreAttributes.h>
@@ -43,22 +45,88 @@ namespace U2 {
 /* GenomeAlignerUrlReader                                               */
 /************************************************************************/
 
-GenomeAlignerUrlReader::GenomeAlignerUrlReader(const QList<GUrl> &dnaList) {
-    initOk = reader.init(dnaList);
+GenomeAlignerUrlReader::GenomeAlignerUrlReader(const QList<GUrl> &dnaList)
+    : initOk(false), fastqUrlIndex(0), fastqBatch(NULL), fastqBatchPos(0)
+{
+    bool allFastq = !dnaList.isEmpty();
+    foreach (const GUrl &url, dnaList) {
+        QList<FormatDetectionResult> formats = DocumentUtils::detectFormat(url);
+        allFastq = allFastq && !formats.isEmpty() && NULL != formats.first().format
+                && BaseDocumentFormats::FASTQ == formats.first().format->getFormatId();
+    }
+
+    if (allFastq) {
+        fastqUrls = dnaList;
+        initOk = fetchFastqBatch();
+    } else {
+        initOk = reader.init(dnaList);
+    }
+}
+
+GenomeAlignerUrlReader::~GenomeAlignerUrlReader() {
+    if (NULL != fastqBatch) {
+        fastqReader->releaseBatch(fastqBatch);
+    }
+}
+
+bool GenomeAlignerUrlReader::fetchFastqBatch() {
+    if (NULL != fastqBatch) {
+        fastqReader->releaseBatch(fastqBatch);
+        fastqBatch = NULL;
+    }
+    fastqBatchPos = 0;
+
+    while (fastqUrlIndex < fastqUrls.size()) {
+        if (fastqReader.isNull()) {
+            fastqReader.reset(new ThreadedFastqBatchReader(fastqUrls[fastqUrlIndex]));
+        }
+        U2OpStatusImpl os;
+        fastqBatch = fastqReader->takeBatch(os);
+        if (os.hasError()) {
+            fastqError = os.getError();
+            fastqReader.reset();
+            fastqUrlIndex = fastqUrls.size();
+            return false;
+        }
+        if (NULL != fastqBatch) {
+            return true;
+        }
+        fastqReader.reset();
+        fastqUrlIndex++;
+    }
+    return false;
 }
 
 bool GenomeAlignerUrlReader::isEnd() {
     if (!initOk) {
         return true;
     }
+    if (!fastqUrls.isEmpty()) {
+        return (NULL == fastqBatch || fastqBatchPos >= fastqBatch->size()) && !fetchFastqBatch();
+    }
     return !reader.hasNext();
 }
 
 int GenomeAlignerUrlReader::getProgress() {
+    if (!fastqUrls.isEmpty()) {
+        CHECK(!fastqReader.isNull(), 100);
+        return (100 * fastqUrlIndex + fastqReader->getProgress()) / fastqUrls.size();
+    }
     return reader.getProgress();
 }
 
+QString GenomeAlignerUrlReader::getError() {
+    if (!fastqError.isEmpty()) {
+        return fastqError;
+    }
+    return reader.hasError() ? reader.getErrorMessage() : QString();
+}
+
 SearchQuery *GenomeAlignerUrlReader::read() {
+    if (!fastqUrls.isEmpty()) {
+        CHECK(!isEnd(), NULL);
+        return new SearchQuery(*fastqBatch, fastqBatchPos++);
+    }
     return new SearchQuery(reader.getNextSequenceObject());
 }
 
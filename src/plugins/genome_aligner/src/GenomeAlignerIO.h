@@ -32,6 +32,7 @@
 #include <U2Core/U2DbiUtils.h>
 #include <U2Core/U2OpStatusUtils.h>
 
+#include <U2Formats/FastqBatchReader.h>
 #include <U2Formats/StreamSequenceReader.h>
 #include <U2Formats/StreamSequenceWriter.h>
 
@@ -53,6 +54,8 @@ public:
     virtual SearchQuery *read() = 0;
     virtual bool isEnd() = 0;
     virtual int getProgress() = 0;
+    /* Not empty if the reading has failed */
+    virtual QString getError() { return QString(); }
 };
 
 class GenomeAlignerWriter {
@@ -95,12 +98,24 @@ public:
 class GenomeAlignerUrlReader : public GenomeAlignerReader {
 public:
     GenomeAlignerUrlReader(const QList<GUrl> &dnaList);
+    ~GenomeAlignerUrlReader();
     inline SearchQuery *read();
     inline bool isEnd();
     int getProgress();
+    QString getError();
 private:
+    /* FASTQ files are parsed by record batches in a separate thread */
+    bool fetchFastqBatch();
+
     bool initOk;
     StreamSequenceReader reader;
+
+    QList<GUrl> fastqUrls;
+    int fastqUrlIndex;
+    QScopedPointer<ThreadedFastqBatchReader> fastqReader;
+    FastqRecordBatch *fastqBatch;
+    int fastqBatchPos;
+    QString fastqError;
 };
 
 class GenomeAlignerUrlWriter : public GenomeAlignerWriter {
@@ -0,0 +1,209 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <U2Core/AppResources.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "GenomeAlignerIndexCache.h"
+
+namespace U2 {
+
+IndexPartData::IndexPartData(SAType saLength, SAType seqLength)
+: saLength(saLength), seqLength(seqLength), sArray(NULL), bitMask(NULL), seq(NULL)
+{
+    try {
+        sArray = new SAType[saLength];
+        bitMask = new BMType[saLength];
+        seq = new char[seqLength];
+    } catch (...) {
+        delete[] sArray;
+        delete[] bitMask;
+        throw;
+    }
+}
+
+IndexPartData::~IndexPartData() {
+    delete[] sArray;
+    delete[] bitMask;
+    delete[] seq;
+}
+
+qint64 IndexPartData::getMemorySize() const {
+    return qint64(saLength) * (sizeof(SAType) + sizeof(BMType)) + seqLength;
+}
+
+static int getMemorySizeInMb(const IndexPartData &data) {
+    return int((data.getMemorySize() + 1024 * 1024 - 1) / (1024 * 1024));
+}
+
+GenomeAlignerIndexCache::Entry::Entry(const QSharedPointer<IndexPartData> &data)
+: data(data), usersCount(0), reservedMemory(0)
+{
+
+}
+
+static GenomeAlignerIndexCache instance;
+
+GenomeAlignerIndexCache::GenomeAlignerIndexCache()
+: usedMemory(0)
+{
+
+}
+
+GenomeAlignerIndexCache * GenomeAlignerIndexCache::getInstance() {
+    return &instance;
+}
+
+static QString getFileKey(const QString &url) {
+    const QFileInfo info(url);
+    return QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+QString GenomeAlignerIndexCache::getPartKey(const QString &partUrl, const QString &refUrl) {
+    return getFileKey(partUrl) + "|" + getFileKey(refUrl);
+}
+
+QSharedPointer<IndexPartData> GenomeAlignerIndexCache::getPart(const QString &key) {
+    QMutexLocker locker(&mutex);
+    CHECK(parts.contains(key), QSharedPointer<IndexPartData>());
+    markUsed(key);
+    return parts[key].data;
+}
+
+QSharedPointer<IndexPartData> GenomeAlignerIndexCache::putPart(const QString &key, const QSharedPointer<IndexPartData> &data) {
+    QMutexLocker locker(&mutex);
+    if (parts.contains(key)) {
+        markUsed(key);
+        return parts[key].data;
+    }
+
+    const qint64 maxMemorySize = qint64(AppResourcePool::instance()->getMaxMemorySizeInMB()) * 1024 * 1024 / 2;
+    if (data->getMemorySize() > maxMemorySize) {
+        return data;
+    }
+    evictUnused(maxMemorySize - data->getMemorySize());
+
+    parts[key] = Entry(data);
+    usedMemory += data->getMemorySize();
+    markUsed(key);
+    return data;
+}
+
+void GenomeAlignerIndexCache::releasePart(const QString &key, const QSharedPointer<IndexPartData> &data) {
+    QMutexLocker locker(&mutex);
+    // the part is not cached if it is too big
+    CHECK(parts.contains(key) && parts[key].data == data, );
+    Entry &entry = parts[key];
+    SAFE_POINT(entry.usersCount > 0, "The genome aligner index part is released more times than it is taken", );
+    entry.usersCount--;
+    CHECK(0 == entry.usersCount, );
+
+    // the memory of the part is not covered by a task anymore
+    AppResource *memory = AppResourcePool::instance()->getResource(RESOURCE_MEMORY);
+    SAFE_POINT_EXT(NULL != memory, evict(key), );
+    const int memoryMb = getMemorySizeInMb(*entry.data);
+    while (!memory->tryAcquire(memoryMb)) {
+        const QString unusedKey = getUnusedPartKey(key);
+        if (unusedKey.isEmpty()) {
+            evict(key);
+            return;
+        }
+        evict(unusedKey);
+    }
+    parts[key].reservedMemory = memoryMb;
+}
+
+void GenomeAlignerIndexCache::reclaimMemory(int memoryMb) {
+    QMutexLocker locker(&mutex);
+    AppResource *memory = AppResourcePool::instance()->getResource(RESOURCE_MEMORY);
+    SAFE_POINT(NULL != memory, "The memory resource is not found", );
+    while (memory->available() < memoryMb) {
+        const QString unusedKey = getUnusedPartKey();
+        CHECK(!unusedKey.isEmpty(), );
+        evict(unusedKey);
+    }
+}
+
+void GenomeAlignerIndexCache::registerMemoryReclaimer() {
+    AppResourcePool *pool = AppResourcePool::instance();
+    SAFE_POINT(NULL != pool, "The resource pool is not found", );
+    pool->registerMemoryReclaimer(getInstance());
+}
+
+void GenomeAlignerIndexCache::unregisterMemoryReclaimer() {
+    AppResourcePool *pool = AppResourcePool::instance();
+    CHECK(NULL != pool, );
+    pool->unregisterMemoryReclaimer(getInstance());
+}
+
+int GenomeAlignerIndexCache::getReservedMemory() {
+    QMutexLocker locker(&mutex);
+    int result = 0;
+    foreach (const Entry &entry, parts) {
+        result += entry.reservedMemory;
+    }
+    return result;
+}
+
+void GenomeAlignerIndexCache::markUsed(const QString &key) {
+    Entry &entry = parts[key];
+    entry.usersCount++;
+    if (entry.reservedMemory > 0) {
+        // the memory resource of the task that uses the part covers it now
+        AppResourcePool::instance()->getResource(RESOURCE_MEMORY)->release(entry.reservedMemory);
+        entry.reservedMemory = 0;
+    }
+    recentlyUsedKeys.removeOne(key);
+    recentlyUsedKeys.append(key);
+}
+
+void GenomeAlignerIndexCache::evictUnused(qint64 maxMemorySize) {
+    while (usedMemory > maxMemorySize) {
+        const QString key = getUnusedPartKey();
+        CHECK(!key.isEmpty(), );
+        evict(key);
+    }
+}
+
+void GenomeAlignerIndexCache::evict(const QString &key) {
+    const Entry entry = parts.take(key);
+    if (entry.reservedMemory > 0) {
+        AppResourcePool::instance()->getResource(RESOURCE_MEMORY)->release(entry.reservedMemory);
+    }
+    recentlyUsedKeys.removeOne(key);
+    usedMemory -= entry.data->getMemorySize();
+    algoLog.trace(QString("Genome aligner index part is evicted from the cache: %1").arg(key));
+}
+
+QString GenomeAlignerIndexCache::getUnusedPartKey(const QString &exceptKey) const {
+    foreach (const QString &key, recentlyUsedKeys) {
+        if (key != exceptKey && 0 == parts[key].usersCount) {
+            return key;
+        }
+    }
+    return QString();
+}
+
+} // U2
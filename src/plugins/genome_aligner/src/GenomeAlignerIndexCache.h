@@ -0,0 +1,114 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_GENOME_ALIGNER_INDEX_CACHE_H_
+#define _U2_GENOME_ALIGNER_INDEX_CACHE_H_
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <U2Core/AppResources.h>
+
+#include "GenomeAlignerIndexPart.h"
+
+namespace U2 {
+
+/** The loaded data of an index part. It is shared read-only between the aligner tasks */
+class IndexPartData {
+public:
+    /** Throws std::bad_alloc */
+    IndexPartData(SAType saLength, SAType seqLength);
+    ~IndexPartData();
+
+    qint64 getMemorySize() const;
+
+    SAType          saLength;
+    SAType          seqLength;
+    SAType          *sArray;
+    BMType          *bitMask;
+    char            *seq;
+
+private:
+    Q_DISABLE_COPY(IndexPartData)
+};
+
+/**
+ * The process-wide cache of the loaded index parts. The aligner tasks that use the same index
+ * load its parts from the disk only once.
+ * The memory of a used part is covered by the memory resource of the task that uses it.
+ * When a part becomes unused, the cache reserves its memory in the application memory resource.
+ * The least recently used unused parts are evicted when the memory can not be reserved, when the cache
+ * exceeds the half of the UGENE memory limit or when any task can not acquire the memory resource:
+ * the cache is registered in the resource pool as a memory reclaimer.
+ */
+class GenomeAlignerIndexCache : public MemoryReclaimer {
+public:
+    GenomeAlignerIndexCache();
+
+    static GenomeAlignerIndexCache * getInstance();
+
+    /** The key changes if the index files are rebuilt */
+    static QString getPartKey(const QString &partUrl, const QString &refUrl);
+
+    /** Returns NULL if the part is not cached. A returned part must be released with releasePart() */
+    QSharedPointer<IndexPartData> getPart(const QString &key);
+    /**
+     * Returns the cached data: it can differ from @data if the part has been put by another task.
+     * The returned part must be released with releasePart()
+     */
+    QSharedPointer<IndexPartData> putPart(const QString &key, const QSharedPointer<IndexPartData> &data);
+    /** The caller does not use the part anymore. The part is evicted if its memory can not be reserved */
+    void releasePart(const QString &key, const QSharedPointer<IndexPartData> &data);
+    /** Evicts the unused parts until @memoryMb megabytes of the memory resource are available */
+    void reclaimMemory(int memoryMb);
+
+    static void registerMemoryReclaimer();
+    static void unregisterMemoryReclaimer();
+
+    /** The memory (in megabytes) that the cache reserves for the unused parts */
+    int getReservedMemory();
+
+private:
+    class Entry {
+    public:
+        Entry(const QSharedPointer<IndexPartData> &data = QSharedPointer<IndexPartData>());
+
+        QSharedPointer<IndexPartData> data;
+        int usersCount;
+        int reservedMemory;     // megabytes
+    };
+
+    void markUsed(const QString &key);
+    void evictUnused(qint64 maxMemorySize);
+    void evict(const QString &key);
+    QString getUnusedPartKey(const QString &exceptKey = QString()) const;
+
+    QMutex mutex;
+    QHash<QString, Entry> parts;
+    QStringList recentlyUsedKeys;   // the most recently used key is the last one
+    qint64 usedMemory;
+};
+
+} // U2
+
+#endif // _U2_GENOME_ALIGNER_INDEX_CACHE_H_
@@ -0,0 +1,164 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QThread>
+
+#include <U2Core/AppResources.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "GenomeAlignerIndexCache.h"
+#include "GenomeAlignerIndexCacheTests.h"
+
+namespace U2 {
+
+namespace {
+
+class TestThread : public QThread {
+public:
+    static void msleep(unsigned long ms) {
+        QThread::msleep(ms);
+    }
+};
+
+/** Does nothing but occupies the memory resource */
+class MemoryConsumerTask : public Task {
+public:
+    MemoryConsumerTask(int memoryMb)
+    : Task("Memory consumer", TaskFlag_None)
+    {
+        addTaskResource(TaskResourceUsage(RESOURCE_MEMORY, memoryMb));
+    }
+
+    void run() {
+
+    }
+};
+
+bool writeFile(const QString &url, const QByteArray &data) {
+    QFile file(url);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+}
+
+void GTest_GenomeAlignerIndexCacheMemory::init(XMLTestFormat *, const QDomElement &) {
+
+}
+
+void GTest_GenomeAlignerIndexCacheMemory::run() {
+    GenomeAlignerIndexCache *cache = GenomeAlignerIndexCache::getInstance();
+    const QString key = QString("genome-aligner-index-cache-memory|%1").arg(QDateTime::currentMSecsSinceEpoch());
+
+    // 2.5 Mb
+    QSharedPointer<IndexPartData> data(new IndexPartData(200000, 100000));
+    const int memoryMb = 3;
+
+    const int reservedMemory = cache->getReservedMemory();
+    CHECK_EXT(cache->putPart(key, data) == data, setError("The put part is not returned"), );
+    CHECK_EXT(cache->getReservedMemory() == reservedMemory, setError("The cache reserves the memory of a used part"), );
+
+    QSharedPointer<IndexPartData> otherData(new IndexPartData(1, 1));
+    cache->releasePart(key, otherData);
+    CHECK_EXT(cache->getReservedMemory() == reservedMemory, setError("The part is released with the data of another part"), );
+
+    cache->releasePart(key, data);
+    CHECK_EXT(cache->getReservedMemory() == reservedMemory + memoryMb, setError(QString("The cache reserves %1 Mb for an unused part of %2 Mb").arg(cache->getReservedMemory() - reservedMemory).arg(memoryMb)), );
+
+    CHECK_EXT(cache->getPart(key) == data, setError("The unused part is not cached"), );
+    CHECK_EXT(cache->getReservedMemory() == reservedMemory, setError("The cache keeps the memory of a taken part"), );
+    cache->releasePart(key, data);
+
+    AppResource *memory = AppResourcePool::instance()->getResource(RESOURCE_MEMORY);
+    CHECK_EXT(NULL != memory, setError("The memory resource is not found"), );
+    cache->reclaimMemory(memory->maxUse());
+    CHECK_EXT(0 == cache->getReservedMemory(), setError("The cache keeps the memory that a task needs"), );
+    QSharedPointer<IndexPartData> evictedData = cache->getPart(key);
+    CHECK_EXT(evictedData.isNull(), cache->releasePart(key, evictedData); setError("The unused part is not evicted"), );
+}
+
+void GTest_GenomeAlignerIndexCacheReclaim::init(XMLTestFormat *, const QDomElement &) {
+
+}
+
+void GTest_GenomeAlignerIndexCacheReclaim::prepare() {
+    GenomeAlignerIndexCache *cache = GenomeAlignerIndexCache::getInstance();
+    key = QString("genome-aligner-index-cache-reclaim|%1").arg(QDateTime::currentMSecsSinceEpoch());
+
+    QSharedPointer<IndexPartData> data(new IndexPartData(200000, 100000));
+    CHECK_EXT(cache->putPart(key, data) == data, setError("The put part is not returned"), );
+    const int reservedMemory = cache->getReservedMemory();
+    cache->releasePart(key, data);
+    CHECK_EXT(cache->getReservedMemory() > reservedMemory, setError("The cache does not reserve the memory of the unused part"), );
+
+    AppResource *memory = AppResourcePool::instance()->getResource(RESOURCE_MEMORY);
+    CHECK_EXT(NULL != memory, setError("The memory resource is not found"), );
+    // the task waits forever if the cache keeps the memory
+    addSubTask(new MemoryConsumerTask(memory->available() + 1));
+}
+
+Task::ReportResult GTest_GenomeAlignerIndexCacheReclaim::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    GenomeAlignerIndexCache *cache = GenomeAlignerIndexCache::getInstance();
+    QSharedPointer<IndexPartData> evictedData = cache->getPart(key);
+    CHECK_EXT(evictedData.isNull(), cache->releasePart(key, evictedData); setError("The unused part is not evicted for the task"), ReportResult_Finished);
+    return ReportResult_Finished;
+}
+
+void GTest_GenomeAlignerIndexCacheKey::init(XMLTestFormat *, const QDomElement &) {
+
+}
+
+void GTest_GenomeAlignerIndexCacheKey::run() {
+    const QString url = env->getVar("TEMP_DATA_DIR") + "/genome_aligner_index_cache_key.sarr";
+    const QString refUrl = env->getVar("TEMP_DATA_DIR") + "/genome_aligner_index_cache_key.ref";
+    CHECK_EXT(writeFile(url, "AAAA"), setError(L10N::errorWritingFile(url)), );
+    CHECK_EXT(writeFile(refUrl, "CCCC"), setError(L10N::errorWritingFile(refUrl)), );
+    const QString key = GenomeAlignerIndexCache::getPartKey(url, refUrl);
+
+    // the modification time resolution of some file systems is a second or more
+    const QDateTime modified = QFileInfo(url).lastModified();
+    for (int i = 0; i < 300 && QFileInfo(url).lastModified() == modified; i++) {
+        TestThread::msleep(10);
+        CHECK_EXT(writeFile(url, "GGGG"), setError(L10N::errorWritingFile(url)), );
+    }
+    const QString rewrittenKey = GenomeAlignerIndexCache::getPartKey(url, refUrl);
+    CHECK_EXT(writeFile(url, "TTTTT"), setError(L10N::errorWritingFile(url)), );
+    const QString resizedKey = GenomeAlignerIndexCache::getPartKey(url, refUrl);
+    QFile::remove(url);
+    QFile::remove(refUrl);
+
+    CHECK_EXT(key != rewrittenKey, setError("The key does not change when the file is rewritten"), );
+    CHECK_EXT(rewrittenKey != resizedKey, setError("The key does not change when the file size changes"), );
+}
+
+QList<XMLTestFactory*> GenomeAlignerTests::createTestFactories() {
+    QList<XMLTestFactory*> res;
+    res.append(GTest_GenomeAlignerIndexCacheMemory::createFactory());
+    res.append(GTest_GenomeAlignerIndexCacheReclaim::createFactory());
+    res.append(GTest_GenomeAlignerIndexCacheKey::createFactory());
+    return res;
+}
+
+} // U2
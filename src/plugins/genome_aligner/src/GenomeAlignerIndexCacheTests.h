@@ -0,0 +1,76 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_GENOME_ALIGNER_INDEX_CACHE_TESTS_H_
+#define _U2_GENOME_ALIGNER_INDEX_CACHE_TESTS_H_
+
+#include <QtXml/QDomElement>
+
+#include <U2Test/XMLTestUtils.h>
+
+namespace U2 {
+
+/**
+ * Puts a part to the cache, releases it and takes it again.
+ * The cache must reserve the memory of the part only while the part is unused
+ * and must evict the unused part when a task needs its memory.
+ */
+class GTest_GenomeAlignerIndexCacheMemory : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GenomeAlignerIndexCacheMemory, "genome-aligner-index-cache-memory");
+
+    void run();
+};
+
+/**
+ * Puts a part to the cache and releases it, then runs a task that needs more than the available memory.
+ * The task must get the memory that the cache reserves for the unused part.
+ */
+class GTest_GenomeAlignerIndexCacheReclaim : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GenomeAlignerIndexCacheReclaim, "genome-aligner-index-cache-reclaim");
+
+    void prepare();
+    ReportResult report();
+
+private:
+    QString key;
+};
+
+/** The key of a part must change when the part file is rewritten with the same size within a second */
+class GTest_GenomeAlignerIndexCacheKey : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GenomeAlignerIndexCacheKey, "genome-aligner-index-cache-key");
+
+    void run();
+};
+
+class GenomeAlignerTests {
+public:
+    static QList<XMLTestFactory*> createTestFactories();
+};
+
+} // U2
+
+#endif // _U2_GENOME_ALIGNER_INDEX_CACHE_TESTS_H_
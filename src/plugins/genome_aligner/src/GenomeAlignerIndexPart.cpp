@@ -22,8 +22,10 @@
 #include <U2Core/Timer.h>
 #include <U2Algorithm/BitsTable.h>
 #include <QtEndian>
+#include <QScopedPointer>
 #include <U2Algorithm/BitsTable.h>
 
+#include "GenomeAlignerIndexCache.h"
 #include "GenomeAlignerIndexPart.h"
 #include <U2Core/Log.h>
 #include <U2Core/U2SafePoints.h>
@@ -45,9 +47,13 @@ IndexPart::IndexPart() {
 }
 
 IndexPart::~IndexPart() {
-    delete[] sArray;
-    delete[] bitMask;
-    delete[] seq;
+    if (loadedData.isNull()) {
+        delete[] sArray;
+        delete[] bitMask;
+        delete[] seq;
+    } else {
+        GenomeAlignerIndexCache::getInstance()->releasePart(loadedKey, loadedData);
+    }
     delete[] seqStarts;
     delete[] seqLengths;
     delete[] saLengths;
@@ -89,59 +95,83 @@ bool IndexPart::load(int part) {
     if (part == currentPart) {
         return true;
     }
+
+    GenomeAlignerIndexCache *cache = GenomeAlignerIndexCache::getInstance();
+    const QString key = GenomeAlignerIndexCache::getPartKey(partFiles[part]->fileName(), refFile->fileName());
+    QSharedPointer<IndexPartData> data = cache->getPart(key);
+    if (data.isNull()) {
+        data = QSharedPointer<IndexPartData>(readPart(part));
+        CHECK(!data.isNull(), false);
+        data = cache->putPart(key, data);
+    } else {
+        algoLog.trace(QString("IndexPart::load part %1 is taken from the cache").arg(part));
+    }
+
+    if (loadedData.isNull()) {
+        delete[] sArray;
+        delete[] bitMask;
+        delete[] seq;
+    } else {
+        cache->releasePart(loadedKey, loadedData);
+    }
+    loadedKey = key;
+    loadedData = data;
+    sArray = data->sArray;
+    bitMask = data->bitMask;
+    seq = data->seq;
+    saLengths[part] = data->saLength;
     currentPart = part;
+
+    qint64 t1 = GTimer::currentTimeMicros();
+    algoLog.trace(QString("IndexPart::load time %1 ms").arg((t1 - t0) / double(1000), 0, 'f', 3));
+
+    return true;
+}
+
+IndexPartData * IndexPart::readPart(int part) {
     qint64 size = 0;
     if (!partFiles[part]->isOpen()) {
         partFiles[part]->open(QIODevice::ReadOnly);
     }
     partFiles[part]->seek(0);
 
-    char *buff = NULL;
-
-    size_t needRead = 0;
-
-    needRead = 1*sizeof(SAType);
-    buff = (char*)&(saLengths[currentPart]);
-    size = partFiles[part]->read(buff, needRead);
-    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", false);
+    SAType saLength = 0;
+    size_t needRead = 1*sizeof(SAType);
+    size = partFiles[part]->read((char*)&saLength, needRead);
+    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", NULL);
+
+    QScopedPointer<IndexPartData> data;
+    try {
+        data.reset(new IndexPartData(saLength, seqLengths[part]));
+    } catch (std::bad_alloc &) {
+        algoLog.error(QString("Not enough memory to load the index part %1").arg(part));
+        return NULL;
+    }
 
-    needRead = saLengths[currentPart]*sizeof(SAType);
-    buff = (char*)sArray;
-    size = partFiles[part]->read(buff, needRead);
-    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", false);
+    needRead = saLength*sizeof(SAType);
+    size = partFiles[part]->read((char*)data->sArray, needRead);
+    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", NULL);
 
-    needRead = saLengths[currentPart]*sizeof(BMType);
-    buff = (char*)bitMask;
-    size = partFiles[part]->read(buff, needRead);
-    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", false);
+    needRead = saLength*sizeof(BMType);
+    size = partFiles[part]->read((char*)data->bitMask, needRead);
+    SAFE_POINT(static_cast<quint64>(size) == needRead, "Index format error", NULL);
 
-    uchar *bitSeq = new uchar[1 + seqLengths[currentPart]/4];
-    size = partFiles[part]->read((char*)bitSeq, 1 + seqLengths[currentPart]/4);
-    assert(size == 1 + seqLengths[currentPart]/4);
-    if (size != 1 + seqLengths[currentPart]/4) {
-        delete[] bitSeq;
-        return false;
-    }
+    // the packed sequence is not used: the sequence is read from the .ref file
+    const qint64 bitSeqSize = 1 + seqLengths[part]/4;
+    CHECK(partFiles[part]->size() - partFiles[part]->pos() >= bitSeqSize, NULL);
 
-    refFile->seek(seqStarts[currentPart]);
-    size = refFile->read(seq, seqLengths[currentPart]);
-    assert(size == seqLengths[currentPart]);
-    if (size != seqLengths[currentPart]) {
-        delete[] bitSeq;
-        return false;
-    }
+    refFile->seek(seqStarts[part]);
+    size = refFile->read(data->seq, seqLengths[part]);
+    assert(size == seqLengths[part]);
+    CHECK(size == seqLengths[part], NULL);
 
-    for (quint32 i=0; i<saLengths[currentPart]; i++) {
-        if (!isLittleEndian()) {
-            sArray[i] = qFromLittleEndian<quint32>((uchar*)(sArray + i));
+    if (!isLittleEndian()) {
+        for (quint32 i=0; i<saLength; i++) {
+            data->sArray[i] = qFromLittleEndian<quint32>((uchar*)(data->sArray + i));
         }
     }
 
-    qint64 t1 = GTimer::currentTimeMicros();
-    algoLog.trace(QString("IndexPart::load time %1 ms").arg((t1 - t0) / double(1000), 0, 'f', 3));
-
-    delete[] bitSeq;
-    return true;
+    return data.take();
 }
 
 SAType IndexPart::getMaxLength() {
@@ -24,6 +24,8 @@
 
 #include <U2Core/global.h>
 #include <QFile>
+#include <QSharedPointer>
+#include <QString>
 
 typedef quint64 BMType;
 typedef quint32 SAType;
@@ -31,6 +33,7 @@ typedef quint32 SAType;
 
 namespace U2 {
 class GenomeAlignerIndexTask;
+class IndexPartData;
 
 class IndexPart {
     friend class GenomeAlignerIndexTask;
@@ -58,6 +61,12 @@ private:
     QFile           *refFile;
     QFile           **partFiles;
 
+    // if it is set, the arrays above point to the shared data of the loaded part.
+    // Otherwise they are the own buffers of the index building
+    QSharedPointer<IndexPartData> loadedData;
+    QString         loadedKey;
+
+    IndexPartData * readPart(int part);
     BMType getBitValue(uchar *seq, SAType idx);
 };
 
@@ -154,15 +154,19 @@ void GenomeAlignerIndexTask::run() {
     gpuFreeSize = memFreeSize;
     SAType maxLength = index->indexPart.getMaxLength();
 
-    try {
-        assert(0!=maxLength);
-        index->indexPart.bitMask = new BMType[maxLength];
-        index->indexPart.sArray = new SAType[maxLength];
-        index->indexPart.seq = new char[maxLength];
-    } catch(std::bad_alloc &e) {
-        Q_UNUSED(e);
-        setError("Can't allocate this amount of memory. Try to close some of your programs or to decrease \"maxMemorySize\"-option");
-        return;
+    // the built index parts are loaded into the shared memory of the index cache,
+    // so the buffers are needed only for the building
+    if (index->build || settings.justBuildIndex) {
+        try {
+            assert(0!=maxLength);
+            index->indexPart.bitMask = new BMType[maxLength];
+            index->indexPart.sArray = new SAType[maxLength];
+            index->indexPart.seq = new char[maxLength];
+        } catch(std::bad_alloc &e) {
+            Q_UNUSED(e);
+            setError("Can't allocate this amount of memory. Try to close some of your programs or to decrease \"maxMemorySize\"-option");
+            return;
+        }
     }
     if (settings.justBuildIndex) {
         for (int i=0; i<parts; i++) {
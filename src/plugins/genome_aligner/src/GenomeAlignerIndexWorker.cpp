@@ -22,6 +22,7 @@
 #include "GenomeAlignerIndexWorker.h"
 
 #include <U2Core/Log.h>
+#include <U2Core/Version.h>
 #include <U2Lang/IntegralBusModel.h>
 #include <U2Lang/WorkflowEnv.h>
 #include <U2Lang/ActorPrototypeRegistry.h>
@@ -32,8 +33,10 @@
 #include <U2Lang/BaseActorCategories.h>
 #include <U2Designer/DelegateEditors.h>
 #include <U2Lang/CoreLibConstants.h>
+#include <U2Lang/WorkflowResultCache.h>
 #include <U2Gui/DialogUtils.h>
 
+#include "GenomeAlignerIndex.h"
 #include "GenomeAlignerPlugin.h"
 
 namespace U2 {
@@ -118,22 +121,33 @@ Task* GenomeAlignerBuildWorker::tick() {
     settings.refSeqUrl = refSeqUrl;
     settings.indexFileName = indexUrl.getURLString();
     Task* t = new GenomeAlignerTask(settings, true);
+    if (WorkflowResultCache::isEnabled()) {
+        WorkflowResultCacheKey key(actor->getProto()->getId(), Version::appVersion().text);
+        key.addParameter(REF_SIZE_ATTR, actor->getParameter(REF_SIZE_ATTR)->getAttributeValue<int>(context));
+        key.addInputFile(settings.refSeqUrl.getURLString());
+        const QString indexBase = indexUrl.dirPath() + "/" + indexUrl.baseFileName();
+        const QStringList indexSuffixes = QStringList() << "." + GenomeAlignerIndex::HEADER_EXTENSION
+                                                        << "." + GenomeAlignerIndex::REF_INDEX_EXTENSION
+                                                        << ".*." + GenomeAlignerIndex::SARRAY_EXTENSION;
+        t = new WorkflowResultCacheTask(key, indexBase, indexSuffixes, t);
+    }
     connect(t, SIGNAL(si_stateChanged()), SLOT(sl_taskFinished()));
     return t;
 }
 
 void GenomeAlignerBuildWorker::sl_taskFinished() {
-    GenomeAlignerTask* t = qobject_cast<GenomeAlignerTask*>(sender());
+    Task* t = qobject_cast<Task*>(sender());
     if (t->getState() != Task::State_Finished) {
         return;
     }
 
     done = true;
 
-    QVariant v = qVariantFromValue<QString>(t->getIndexPath());
+    const QString indexPath = indexUrl.getURLString();
+    QVariant v = qVariantFromValue<QString>(indexPath);
     output->put(Message(GenomeAlignerPlugin::GENOME_ALIGNER_INDEX_TYPE(), v));
     output->setEnded();
-    algoLog.trace(tr("Genome aligner index building finished. Result name is %1").arg(t->getIndexPath()));
+    algoLog.trace(tr("Genome aligner index building finished. Result name is %1").arg(indexPath));
 }
 
 bool GenomeAlignerBuildWorker::isDone() const {
@@ -28,11 +28,17 @@
 #include <U2Core/AppContext.h>
 #include <U2Core/CMDLineRegistry.h>
 #include <U2Core/CMDLineHelpProvider.h>
+#include <U2Core/GAutoDeleteList.h>
 #include <U2Core/TaskStarter.h>
+#include <U2Core/U2SafePoints.h>
 #include <U2Gui/MainWindow.h>
 #include <U2Algorithm/DnaAssemblyAlgRegistry.h>
 #include <U2Lang/WorkflowEnv.h>
+#include <U2Test/GTestFrameworkComponents.h>
+#include <U2Test/XMLTestFormat.h>
 
+#include "GenomeAlignerIndexCache.h"
+#include "GenomeAlignerIndexCacheTests.h"
 #include "GenomeAlignerSettingsController.h"
 #include "GenomeAlignerTask.h"
 #include "GenomeAlignerWorker.h"
@@ -92,12 +98,26 @@ GenomeAlignerPlugin::GenomeAlignerPlugin() : Plugin( tr("UGENE Genome Aligner"),
     assert(res);
 
     LocalWorkflow::GenomeAlignerWorkerFactory::init();
+    GenomeAlignerIndexCache::registerMemoryReclaimer();
 
     registerCMDLineHelp();
     processCMDLineOptions();
+
+    GTestFormatRegistry* tfr = AppContext::getTestFramework()->getTestFormatRegistry();
+    XMLTestFormat *xmlTestFormat = qobject_cast<XMLTestFormat*>(tfr->findFormat("XML"));
+    SAFE_POINT(NULL != xmlTestFormat, "XML test format is not found", );
+
+    GAutoDeleteList<XMLTestFactory>* l = new GAutoDeleteList<XMLTestFactory>(this);
+    l->qlist = GenomeAlignerTests::createTestFactories();
+    foreach (XMLTestFactory* f, l->qlist) {
+        bool res = xmlTestFormat->registerTestFactory(f);
+        Q_UNUSED(res);
+        assert(res);
+    }
 }
 
 GenomeAlignerPlugin::~GenomeAlignerPlugin() {
+    GenomeAlignerIndexCache::unregisterMemoryReclaimer();
 }
 
 void GenomeAlignerPlugin::processCMDLineOptions()
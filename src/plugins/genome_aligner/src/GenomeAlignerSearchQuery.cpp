@@ -21,6 +21,7 @@
 
 #include "GenomeAlignerSearchQuery.h"
 #include <U2Core/Log.h>
+#include <U2Formats/FastqBatchReader.h>
 #include <limits.h>
 
 namespace U2 {
@@ -46,6 +47,25 @@ SearchQuery::SearchQuery(const DNASequence *shortRead, SearchQuery *revCompl) {
     overlapResults.reserve(2);
 }
 
+SearchQuery::SearchQuery(const FastqRecordBatch &batch, int recordIndex, SearchQuery *revCompl) {
+    dna = true;
+    wroteResult = false;
+    this->revCompl = revCompl;
+    seqLength = batch.getSequenceLength(recordIndex);
+    nameLength = batch.getHeaderLength(recordIndex);
+    seq = new char[seqLength+1];
+    name = new char[nameLength+1];
+    memcpy(seq, batch.getSequenceData(recordIndex), seqLength);
+    seq[seqLength] = '\0';
+    memcpy(name, batch.getHeaderData(recordIndex), nameLength);
+    name[nameLength] = '\0';
+    quality = (seqLength > 0) ? new DNAQuality(batch.getQuality(recordIndex)) : NULL;
+
+    results.reserve(2);
+    mismatchCounts.reserve(2);
+    overlapResults.reserve(2);
+}
+
 qint64 SearchQuery::memoryHint() const {
     qint64 m = sizeof(*this);
 
@@ -30,6 +30,7 @@
 
 namespace U2 {
 
+class FastqRecordBatch;
 class GenomeAlignerIndex;
 
 class CacheResult {
@@ -43,6 +44,7 @@ class SearchQuery {
 public:
     SearchQuery(const DNASequence *shortRead, SearchQuery *revCompl = NULL);
     SearchQuery(const U2AssemblyRead &shortRead, SearchQuery *revCompl = NULL);
+    SearchQuery(const FastqRecordBatch &batch, int recordIndex, SearchQuery *revCompl = NULL);
     ~SearchQuery();
 
     QString getName() const;
@@ -203,7 +203,8 @@ QList<Task*> GenomeAlignerTask::onSubTaskFinished( Task* subTask ) {
 
         if (seqReader->isEnd()) {
             if (!hasError()){
-                setError(tr("Can not init short reads loader."));
+                const QString readError = seqReader->getError();
+                setError(readError.isEmpty() ? tr("Can not init short reads loader.") : readError);
                 if (NULL != pWriteTask) {
                     pWriteTask->setFinished();
                 }
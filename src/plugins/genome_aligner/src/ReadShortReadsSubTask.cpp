@@ -197,6 +197,13 @@ void ReadShortReadsSubTask::run() {
         }
     }
 
+    const QString readError = seqReader->getError();
+    if (!readError.isEmpty()) {
+        setError(readError);
+        readingFinishedWakeAll();
+        return;
+    }
+
     dropToAlignContext();
     readingFinishedWakeAll();
 }
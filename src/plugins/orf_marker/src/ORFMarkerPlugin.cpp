@@ -114,6 +114,7 @@ void ORFViewContext::sl_showDialog() {
 QList<XMLTestFactory*> ORFMarkerTests::createTestFactories() {
     QList<XMLTestFactory*> res;
     res.append(GTest_ORFMarkerTask::createFactory());
+    res.append(GTest_ORFChunkedSearch::createFactory());
     return res;
 }
 
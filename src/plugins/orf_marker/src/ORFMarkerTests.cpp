@@ -30,6 +30,9 @@
 
 #include <U2Core/GObjectTypes.h>
 #include <U2Core/DNASequenceObject.h>
+#include <U2Core/U2DbiRegistry.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SequenceUtils.h>
 
 /* TRANSLATOR U2::GTest */
 
@@ -44,6 +47,9 @@ namespace U2 {
 #define ALT_INIT_ATTR "allow_alt_init_codons"
 #define TRANSLATION_ID_ATTR "translation_id"
 #define EXPECTED_RESULTS_ATTR  "expected_results"
+#define CIRCULAR_ATTR "circular"
+#define ALLOW_OVERLAP_ATTR "allow_overlap"
+#define MAX_RESULTS_ATTR "max_results"
 
 Translator::Translator(const U2SequenceObject *s, const QString& tid) : seq(s), complTransl(NULL), aminoTransl(NULL) {
     const DNAAlphabet* al = seq->getAlphabet();
@@ -208,5 +214,137 @@ Task::ReportResult GTest_ORFMarkerTask::report() {
     return ReportResult_Finished;
 }
 
-} //namespace
+void GTest_ORFChunkedSearch::init(XMLTestFormat *, const QDomElement& el) {
+    chunkedTask = NULL;
+
+    const QString strand = el.attribute(STRAND_ATTR, "both");
+    if (strand == "direct") {
+        settings.strand = ORFAlgorithmStrand_Direct;
+    } else if (strand == "compliment") {
+        settings.strand = ORFAlgorithmStrand_Complement;
+    } else if (strand == "both") {
+        settings.strand = ORFAlgorithmStrand_Both;
+    } else {
+        stateInfo.setError(QString("value not correct %1").arg(STRAND_ATTR));
+        return;
+    }
+
+    bool isOk = true;
+    settings.minLen = el.attribute(MIN_LENGTH_ATTR, "300").toInt(&isOk);
+    if (!isOk) {
+        stateInfo.setError(QString("Unable to convert. Value wrong %1").arg(MIN_LENGTH_ATTR));
+        return;
+    }
+    maxResults = el.attribute(MAX_RESULTS_ATTR, "-1").toInt(&isOk);
+    if (!isOk) {
+        stateInfo.setError(QString("Unable to convert. Value wrong %1").arg(MAX_RESULTS_ATTR));
+        return;
+    }
+    settings.circularSearch = el.attribute(CIRCULAR_ATTR) == "true";
+    settings.allowOverlap = el.attribute(ALLOW_OVERLAP_ATTR) == "true";
+    settings.mustInit = el.attribute(START_WITH_INIT_ATTR, "true") == "true";
+    settings.mustFit = false;
+    settings.allowAltStart = false;
+    settings.includeStopCodon = false;
+    settings.isResultsLimited = maxResults >= 0;
+    settings.maxResult2Search = settings.isResultsLimited ? maxResults : INT_MAX;
+}
+
+void GTest_ORFChunkedSearch::prepare() {
+    const qint64 chunkSize = ORFFindTask::CHUNK_SIZE;
+    const DNAAlphabet* alphabet = AppContext::getDNAAlphabetRegistry()->findById(BaseDNAAlphabetIds::NUCL_DNA_DEFAULT());
+    CHECK_EXT(NULL != alphabet, stateInfo.setError("DNA alphabet is not found"), );
+    DNATranslationRegistry* translationRegistry = AppContext::getDNATranslationRegistry();
+    settings.proteinTT = translationRegistry->lookupTranslation(alphabet, DNATranslationType_NUCL_2_AMINO, "NCBI-GenBank #1");
+    settings.complementTT = translationRegistry->lookupComplementTranslation(alphabet);
+    CHECK_EXT(NULL != settings.proteinTT && NULL != settings.complementTT, stateInfo.setError("DNA translations are not found"), );
+
+    // 4 full chunks and a short last one
+    QByteArray sequence(4 * chunkSize + 12345, Qt::Uninitialized);
+    quint32 seed = 42;
+    for (int i = 0; i < sequence.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        sequence[i] = "ACGT"[(seed >> 16) & 3];
+    }
+
+    // a direct ORF across the first chunk border
+    QByteArray orf = "ATG" + QByteArray("GCC").repeated(2000) + "TAA";
+    sequence.replace(chunkSize - 3001, orf.size(), orf);
+
+    // a stop-free stretch in both strands that covers the third chunk, it starts with an initiator
+    QByteArray stretch = "ATG" + QByteArray("GCC").repeated((chunkSize + 2000) / 3);
+    sequence.replace(2 * chunkSize - 1000, stretch.size(), stretch);
+
+    // a complement ORF across the fourth chunk border
+    QByteArray complementOrf("TTA" + QByteArray("GGC").repeated(2000) + "CAT");
+    sequence.replace(4 * chunkSize - 2999, complementOrf.size(), complementOrf);
+
+    // ORFs that cross the sequence end in the circular mode
+    sequence.replace(sequence.size() - 1502, 1500, QByteArray("GCC").repeated(500));
+    sequence.replace(0, 1500, QByteArray("GCC").repeated(500));
 
+    U2OpStatusImpl os;
+    const U2DbiRef dbiRef = AppContext::getDbiRegistry()->getSessionTmpDbiRef(os);
+    CHECK_OP_EXT(os, stateInfo.setError(os.getError()), );
+    sequenceRef = U2SequenceUtils::import(dbiRef, DNASequence("orf_chunked_search", sequence, alphabet), os);
+    CHECK_OP_EXT(os, stateInfo.setError(os.getError()), );
+
+    settings.searchRegion = U2Region(0, sequence.size());
+    chunkedTask = new ORFFindTask(settings, sequenceRef);
+    addSubTask(chunkedTask);
+}
+
+void GTest_ORFChunkedSearch::run() {
+    CHECK_OP(stateInfo, );
+    ORFAlgorithmSettings singlePassSettings = settings;
+    singlePassSettings.isResultsLimited = false;
+    ORFFindAlgorithm::find(this, singlePassSettings, sequenceRef, stateInfo.cancelFlag, stateInfo.progress);
+}
+
+void GTest_ORFChunkedSearch::onResult(const ORFFindResult& r, U2OpStatus&) {
+    singlePassResults << r;
+}
+
+QStringList GTest_ORFChunkedSearch::toStrings(const QList<ORFFindResult>& results) {
+    QStringList strings;
+    foreach (const ORFFindResult& r, results) {
+        QString string = QString("%1 %2").arg(r.frame).arg(r.region.toString());
+        if (r.isJoined) {
+            string += " " + r.joinedRegion.toString();
+        }
+        strings << string;
+    }
+    strings.sort();
+    return strings;
+}
+
+Task::ReportResult GTest_ORFChunkedSearch::report() {
+    propagateSubtaskError();
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    const QList<ORFFindResult> chunkedResults = chunkedTask->popResults();
+    if (settings.isResultsLimited) {
+        const int expectedCount = qMin(maxResults, singlePassResults.size());
+        CHECK_EXT(chunkedResults.size() == expectedCount,
+            stateInfo.setError(QString("Results limit is not kept: %1 results, expected %2").arg(chunkedResults.size()).arg(expectedCount)), ReportResult_Finished);
+        return ReportResult_Finished;
+    }
+
+    const QStringList expected = toStrings(singlePassResults);
+    const QStringList actual = toStrings(chunkedResults);
+    for (int i = 0; i < qMin(expected.size(), actual.size()); i++) {
+        CHECK_EXT(expected[i] == actual[i],
+            stateInfo.setError(QString("Chunked search result is different: %1, expected %2").arg(actual[i]).arg(expected[i])), ReportResult_Finished);
+    }
+    CHECK_EXT(expected.size() == actual.size(),
+        stateInfo.setError(QString("Chunked search found %1 ORFs, expected %2").arg(actual.size()).arg(expected.size())), ReportResult_Finished);
+
+    bool borderCrossed = false;
+    foreach (const ORFFindResult& r, chunkedResults) {
+        borderCrossed = borderCrossed || r.region.startPos / ORFFindTask::CHUNK_SIZE != (r.region.endPos() - 1) / ORFFindTask::CHUNK_SIZE;
+    }
+    CHECK_EXT(borderCrossed, stateInfo.setError("No ORF crosses a chunk border"), ReportResult_Finished);
+    return ReportResult_Finished;
+}
+
+} //namespace
@@ -50,6 +50,31 @@ private:
     ORFFindTask *task;
 };
 
+/**
+ * Searches ORFs in a generated sequence that is long enough to be split into chunks,
+ * some ORFs cross the chunk borders and a stop-free stretch covers a whole chunk.
+ * The chunked search must find the same ORFs as the single pass search.
+ */
+class GTest_ORFChunkedSearch : public GTest, public ORFFindResultsListener {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY_EXT(GTest_ORFChunkedSearch, "plugin_orf-chunked-search", TaskFlags_FOSCOE);
+
+    void prepare();
+    void run();
+    Task::ReportResult report();
+    void onResult(const ORFFindResult& r, U2OpStatus& os);
+
+private:
+    static QStringList toStrings(const QList<ORFFindResult>& results);
+
+    ORFAlgorithmSettings settings;
+    int maxResults;
+    U2EntityRef sequenceRef;
+    ORFFindTask *chunkedTask;
+    QList<ORFFindResult> singlePassResults;
+};
+
 //FIXME! this class is a partial copy of DetView
 class Translator {
 public:
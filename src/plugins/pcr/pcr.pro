@@ -9,9 +9,12 @@ HEADERS += src/EditPrimerDialog.h \
            src/InSilicoPcrTask.h \
            src/InSilicoPcrWorker.h \
            src/InSilicoPcrWorkflowTask.h \
+           src/MultiplexPcrTask.h \
            src/PcrOptionsPanelSavableTab.h \
            src/PcrPlugin.h \
+           src/PcrTests.h \
            src/Primer.h \
+           src/PrimerBindingSitesFinder.h \
            src/PrimerDimersFinder.h \
            src/PrimerGroupBox.h \
            src/PrimerLibrary.h \
@@ -51,9 +54,12 @@ SOURCES += src/EditPrimerDialog.cpp \
            src/InSilicoPcrTask.cpp \
            src/InSilicoPcrWorker.cpp \
            src/InSilicoPcrWorkflowTask.cpp \
+           src/MultiplexPcrTask.cpp \
            src/PcrOptionsPanelSavableTab.cpp \
            src/PcrPlugin.cpp \
+           src/PcrTests.cpp \
            src/Primer.cpp \
+           src/PrimerBindingSitesFinder.cpp \
            src/PrimerDimersFinder.cpp \
            src/PrimerGroupBox.cpp \
            src/PrimerLibrary.cpp \
@@ -19,6 +19,8 @@
  * MA 02110-1301, USA.
  */
 
+#include <algorithm>
+
 #include <U2Core/AppContext.h>
 #include <U2Core/Counter.h>
 #include <U2Core/DNAAlphabet.h>
@@ -27,6 +29,7 @@
 #include <U2Core/L10n.h>
 
 #include "Primer.h"
+#include "PrimerBindingSitesFinder.h"
 #include "PrimerStatistics.h"
 
 #include "InSilicoPcrTask.h"
@@ -56,12 +59,6 @@ settings(settings), forwardSearch(NULL), reverseSearch(NULL), minProductSize(0)
     minProductSize = qMax(settings.forwardPrimer.length(), settings.reversePrimer.length());
 }
 
-namespace {
-    int getMaxError(const QByteArray &primer, uint mismatches) {
-        return qMin(int(mismatches), primer.length() / 2);
-    }
-}
-
 FindAlgorithmTaskSettings InSilicoPcrTask::getFindPatternSettings(U2Strand::Direction direction) {
     FindAlgorithmTaskSettings result;
     const DNAAlphabet *alphabet = AppContext::getDNAAlphabetRegistry()->findById(BaseDNAAlphabetIds::NUCL_DNA_DEFAULT());
@@ -78,10 +75,10 @@ FindAlgorithmTaskSettings InSilicoPcrTask::getFindPatternSettings(U2Strand::Dire
 
     if (U2Strand::Direct == direction) {
         result.pattern = settings.forwardPrimer;
-        result.maxErr = getMaxError(settings.forwardPrimer, settings.forwardMismatches);
+        result.maxErr = PrimerBindingSitesFinder::getMaxError(settings.forwardPrimer.length(), settings.forwardMismatches);
     } else {
         result.pattern = settings.reversePrimer;
-        result.maxErr = getMaxError(settings.reversePrimer, settings.reverseMismatches);
+        result.maxErr = PrimerBindingSitesFinder::getMaxError(settings.reversePrimer.length(), settings.reverseMismatches);
     }
 
     result.complementTT = translator;
@@ -106,23 +103,56 @@ void InSilicoPcrTask::run() {
     algoLog.details(tr("Forward primers found: %1").arg(forwardResults.size()));
     algoLog.details(tr("Reverse primers found: %1").arg(reverseResults.size()));
 
-    foreach (const FindAlgorithmResult &forward, forwardResults) {
-        foreach (const FindAlgorithmResult &reverse, reverseResults) {
-            CHECK(!isCanceled(), );
-            if (forward.strand == reverse.strand) {
-                continue;
+    // Products are formed by a direct strand hit on the left and a complementary strand hit on the right.
+    // The hits are sorted by position and only the pairs within the product size bounds are enumerated.
+    QList< QPair<int, int> > pairs;
+    const qint64 circularLength = settings.isCircular ? settings.sequence.length() : 0;
+    for (int forwardIsLeft = 1; forwardIsLeft >= 0; forwardIsLeft--) {
+        const QList<FindAlgorithmResult> &leftResults = forwardIsLeft ? forwardResults : reverseResults;
+        const QList<FindAlgorithmResult> &rightResults = forwardIsLeft ? reverseResults : forwardResults;
+        QVector<qint64> leftStarts;
+        QVector<int> leftIndexes;
+        for (int i = 0; i < leftResults.size(); i++) {
+            if (leftResults[i].strand.isDirect()) {
+                leftStarts << leftResults[i].region.startPos;
+                leftIndexes << i;
             }
-            PrimerBind leftBind = getPrimerBind(forward, reverse, U2Strand::Direct);
-            PrimerBind rightBind = getPrimerBind(forward, reverse, U2Strand::Complementary);
-
-            qint64 productSize = getProductSize(leftBind.region, rightBind.region);
-            bool accepted = filter(leftBind, rightBind, productSize);
-            if (accepted) {
-                U2Region productRegion(leftBind.region.startPos, productSize);
-                InSilicoPcrProduct product = createResult(leftBind.region, productRegion, rightBind.region, forward.strand.getDirection());
-                results << product;
+        }
+        QVector<qint64> rightEnds;
+        QVector<int> rightIndexes;
+        for (int i = 0; i < rightResults.size(); i++) {
+            if (rightResults[i].strand.isCompementary()) {
+                rightEnds << rightResults[i].region.endPos();
+                rightIndexes << i;
             }
         }
+
+        typedef QPair<int, int> HitsPair;
+        foreach (const HitsPair &pair, PcrProductSweep::findPairs(leftStarts, rightEnds, minProductSize, settings.maxProductSize, circularLength, stateInfo)) {
+            const int leftIndex = leftIndexes[pair.first];
+            const int rightIndex = rightIndexes[pair.second];
+            pairs << (forwardIsLeft ? qMakePair(leftIndex, rightIndex) : qMakePair(rightIndex, leftIndex));
+        }
+        CHECK_OP(stateInfo, );
+    }
+    // Keep the order of products: forward hits, then reverse hits
+    std::sort(pairs.begin(), pairs.end());
+
+    typedef QPair<int, int> ResultsPair;
+    foreach (const ResultsPair &pair, pairs) {
+        CHECK(!isCanceled(), );
+        const FindAlgorithmResult &forward = forwardResults[pair.first];
+        const FindAlgorithmResult &reverse = reverseResults[pair.second];
+        PrimerBind leftBind = getPrimerBind(forward, reverse, U2Strand::Direct);
+        PrimerBind rightBind = getPrimerBind(forward, reverse, U2Strand::Complementary);
+
+        qint64 productSize = getProductSize(leftBind.region, rightBind.region);
+        bool accepted = filter(leftBind, rightBind, productSize);
+        if (accepted) {
+            U2Region productRegion(leftBind.region.startPos, productSize);
+            InSilicoPcrProduct product = createResult(leftBind.region, productRegion, rightBind.region, forward.strand.getDirection());
+            results << product;
+        }
     }
 }
 
@@ -224,11 +254,7 @@ InSilicoPcrProduct InSilicoPcrTask::createResult(const U2Region &leftPrimer, con
 }
 
 qint64 InSilicoPcrTask::getProductSize(const U2Region &left, const U2Region &right) const {
-    qint64 result = right.endPos() - left.startPos;
-    if (result < 0 && settings.isCircular) {
-        return right.endPos() + (settings.sequence.length() - left.startPos);
-    }
-    return result;
+    return PcrProductSweep::getProductSize(left.startPos, right.endPos(), settings.isCircular ? settings.sequence.length() : 0);
 }
 
 const QList<InSilicoPcrProduct> & InSilicoPcrTask::getResults() const {
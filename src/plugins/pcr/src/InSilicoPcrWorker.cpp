@@ -55,6 +55,7 @@ namespace {
     const QString PERFECT_ATTR_ID = "perfect-match";
     const QString MAX_PRODUCT_ATTR_ID = "max-product";
     const QString EXTRACT_ANNOTATIONS_ATTR_ID = "extract-annotations";
+    const QString MULTIPLEX_ATTR_ID = "multiplex";
 
     const char * PAIR_NUMBER_PROP_ID = "pair-number";
 }
@@ -97,6 +98,7 @@ void InSilicoPcrWorkerFactory::init() {
         Descriptor perfectDesc(PERFECT_ATTR_ID, InSilicoPcrWorker::tr("Min perfect match"), InSilicoPcrWorker::tr("Number of bases that match exactly on 3' end of primers."));
         Descriptor maxProductDesc(MAX_PRODUCT_ATTR_ID, InSilicoPcrWorker::tr("Max product size"), InSilicoPcrWorker::tr("Maximum size of amplified region."));
         Descriptor annotationsDesc(EXTRACT_ANNOTATIONS_ATTR_ID, InSilicoPcrWorker::tr("Extract annotations"), InSilicoPcrWorker::tr("Extract annotations within a product region."));
+        Descriptor multiplexDesc(MULTIPLEX_ATTR_ID, InSilicoPcrWorker::tr("Multiplex"), InSilicoPcrWorker::tr("Use the primers from the file as a panel and find the products of any two primers instead of the listed pairs."));
 
         attributes << new Attribute(primersDesc, BaseTypes::STRING_TYPE(), true);
         attributes << new Attribute(reportDesc, BaseTypes::STRING_TYPE(), true, "report.html");
@@ -104,6 +106,7 @@ void InSilicoPcrWorkerFactory::init() {
         attributes << new Attribute(perfectDesc, BaseTypes::NUM_TYPE(), false, 15);
         attributes << new Attribute(maxProductDesc, BaseTypes::NUM_TYPE(), false, 5000);
         attributes << new Attribute(annotationsDesc, BaseTypes::NUM_TYPE(), false, ExtractProductSettings::Inner);
+        attributes << new Attribute(multiplexDesc, BaseTypes::BOOL_TYPE(), false, false);
     }
     QMap<QString, PropertyDelegate*> delegates;
     {
@@ -134,6 +137,7 @@ void InSilicoPcrWorkerFactory::init() {
             values[InSilicoPcrWorker::tr("None")] = ExtractProductSettings::None;
             delegates[EXTRACT_ANNOTATIONS_ATTR_ID] = new ComboBoxDelegate(values);
         }
+        delegates[MULTIPLEX_ATTR_ID] = new ComboBoxWithBoolsDelegate();
     }
 
     Descriptor desc(ACTOR_ID, InSilicoPcrWorker::tr("In Silico PCR"),
@@ -195,11 +199,42 @@ void InSilicoPcrWorker::onPrepared(Task *task, U2OpStatus &os) {
 
     QList<GObject*> objects = doc->findGObjectByType(GObjectTypes::SEQUENCE);
     CHECK_EXT(!objects.isEmpty(), os.setError(tr("No primer sequences in the file: ") + loadTask->getURLString()), );
+    if (getValue<bool>(MULTIPLEX_ATTR_ID)) {
+        fetchPanel(objects, os);
+        return;
+    }
     CHECK_EXT(0 == objects.size() % 2, os.setError(tr("There is the odd number of primers in the file: ") + loadTask->getURLString()), );
 
     fetchPrimers(objects, os);
 }
 
+void InSilicoPcrWorker::fetchPanel(const QList<GObject*> &objects, U2OpStatus &os) {
+    foreach (GObject *object, objects) {
+        bool skipped = false;
+        Primer primer = createPrimer(object, skipped, os);
+        CHECK_OP(os, );
+        if (!skipped) {
+            panel << primer;
+        }
+    }
+    CHECK_EXT(!panel.isEmpty(), os.setError(tr("No valid primers in the file")), );
+}
+
+int InSilicoPcrWorker::getPairNumber(const MultiplexPcrProduct &product) {
+    const QPair<QString, QString> names(product.forwardPrimerName, product.reversePrimerName);
+    if (!panelPairs.contains(names)) {
+        panelPairs[names] = primers.size();
+        Primer forward;
+        forward.name = product.forwardPrimerName;
+        forward.sequence = QString::fromLocal8Bit(product.forwardPrimer);
+        Primer reverse;
+        reverse.name = product.reversePrimerName;
+        reverse.sequence = QString::fromLocal8Bit(product.reversePrimer);
+        primers << qMakePair(forward, reverse);
+    }
+    return panelPairs[names];
+}
+
 void InSilicoPcrWorker::fetchPrimers(const QList<GObject*> &objects, U2OpStatus &os) {
     for (int i=0; i<objects.size()/2; i++) {
         bool skipped = false;
@@ -243,13 +278,18 @@ QList<Message> InSilicoPcrWorker::fetchResult(Task *task, U2OpStatus &os) {
         return result;
     }
 
+    MultiplexPcrWorkflowTask *multiplexTask = qobject_cast<MultiplexPcrWorkflowTask*>(task);
+    if (NULL != multiplexTask) {
+        return fetchMultiplexResult(multiplexTask);
+    }
+
     MultiTask *multiTask = qobject_cast<MultiTask*>(task);
     CHECK_EXT(NULL != multiTask, os.setError(L10N::nullPointerError("MultiTask")), result);
 
     InSilicoPcrReportTask::TableRow tableRow;
     foreach (Task *t, multiTask->getTasks()) {
         InSilicoPcrWorkflowTask *pcrTask = qobject_cast<InSilicoPcrWorkflowTask*>(t);
-        CHECK_EXT(NULL != multiTask, os.setError(L10N::nullPointerError("InSilicoPcrTask")), result);
+        CHECK_EXT(NULL != pcrTask, os.setError(L10N::nullPointerError("InSilicoPcrTask")), result);
 
         int pairNumber = pcrTask->property(PAIR_NUMBER_PROP_ID).toInt();
         SAFE_POINT_EXT(pairNumber >= 0 && pairNumber < primers.size(), os.setError(L10N::internalError("Out of range")), result);
@@ -260,25 +300,41 @@ QList<Message> InSilicoPcrWorker::fetchResult(Task *task, U2OpStatus &os) {
         tableRow.productsNumber[pairNumber] = pcrResults.size();
 
         foreach (const InSilicoPcrWorkflowTask::Result &pcrResult, pcrResults) {
-            QVariant sequence = fetchSequence(pcrResult.doc);
-            QVariant annotations = fetchAnnotations(pcrResult.doc);
-            pcrResult.doc->setDocumentOwnsDbiResources(false);
-            delete pcrResult.doc;
-            if (sequence.isNull() || annotations.isNull()) {
-                continue;
-            }
-
-            QVariantMap data;
-            data[BaseSlots::DNA_SEQUENCE_SLOT().getId()] = sequence;
-            data[BaseSlots::ANNOTATION_TABLE_SLOT().getId()] = annotations;
-            int metadataId = createMetadata(settings, pcrResult.product.region, pairNumber);
-            result << Message(output->getBusType(), data, metadataId);
+            addProductMessage(result, pcrResult.doc, settings.sequence.length(), pcrResult.product.region, pairNumber);
         }
     }
     table << tableRow;
     return result;
 }
 
+QList<Message> InSilicoPcrWorker::fetchMultiplexResult(MultiplexPcrWorkflowTask *task) {
+    QList<Message> result;
+    const MultiplexPcrTaskSettings &settings = task->getPcrSettings();
+    InSilicoPcrReportTask::TableRow tableRow;
+    tableRow.sequenceName = settings.sequenceName;
+    foreach (const MultiplexPcrWorkflowTask::Result &pcrResult, task->takeResult()) {
+        const int pairNumber = getPairNumber(pcrResult.product);
+        tableRow.productsNumber[pairNumber]++;
+        addProductMessage(result, pcrResult.doc, settings.sequence.length(), pcrResult.product.region, pairNumber);
+    }
+    table << tableRow;
+    return result;
+}
+
+void InSilicoPcrWorker::addProductMessage(QList<Message> &messages, Document *doc, qint64 sequenceLength, const U2Region &productRegion, int pairNumber) {
+    QVariant sequence = fetchSequence(doc);
+    QVariant annotations = fetchAnnotations(doc);
+    doc->setDocumentOwnsDbiResources(false);
+    delete doc;
+    CHECK(!sequence.isNull() && !annotations.isNull(), );
+
+    QVariantMap data;
+    data[BaseSlots::DNA_SEQUENCE_SLOT().getId()] = sequence;
+    data[BaseSlots::ANNOTATION_TABLE_SLOT().getId()] = annotations;
+    int metadataId = createMetadata(sequenceLength, productRegion, pairNumber);
+    messages << Message(output->getBusType(), data, metadataId);
+}
+
 QVariant InSilicoPcrWorker::fetchSequence(Document *doc) {
     QList<GObject*> seqObjects = doc->findGObjectByType(GObjectTypes::SEQUENCE);
     if (1 != seqObjects.size()) {
@@ -299,10 +355,10 @@ QVariant InSilicoPcrWorker::fetchAnnotations(Document *doc) {
     return qVariantFromValue<SharedDbiDataHandler>(annsId);
 }
 
-int InSilicoPcrWorker::createMetadata(const InSilicoPcrTaskSettings &settings, const U2Region &productRegion, int pairNumber) {
+int InSilicoPcrWorker::createMetadata(qint64 sequenceLength, const U2Region &productRegion, int pairNumber) {
     MessageMetadata oldMetadata = context->getMetadataStorage().get(output->getContextMetadataId());
     QString primerName = primers[pairNumber].first.name;
-    QString suffix = "_" + ExtractProductTask::getProductName(primerName, settings.sequence.length(), productRegion, true);
+    QString suffix = "_" + ExtractProductTask::getProductName(primerName, sequenceLength, productRegion, true);
     QString newUrl = GUrlUtils::insertSuffix(oldMetadata.getFileUrl(), suffix);
 
     MessageMetadata metadata(newUrl, oldMetadata.getDatasetName());
@@ -337,6 +393,20 @@ Task * InSilicoPcrWorker::createTask(const Message &message, U2OpStatus &os) {
     productSettings.targetDbiRef = context->getDataStorage()->getDbiRef();
     productSettings.annotationsExtraction = ExtractProductSettings::AnnotationsExtraction(getValue<int>(EXTRACT_ANNOTATIONS_ATTR_ID));
 
+    if (getValue<bool>(MULTIPLEX_ATTR_ID)) {
+        MultiplexPcrTaskSettings pcrSettings;
+        pcrSettings.sequence = seq->getWholeSequenceData(os);
+        CHECK_OP(os, NULL);
+        pcrSettings.isCircular = seq->isCircular();
+        pcrSettings.mismatches = getValue<int>(MISMATCHES_ATTR_ID);
+        pcrSettings.maxProductSize = getValue<int>(MAX_PRODUCT_ATTR_ID);
+        pcrSettings.perfectMatch = getValue<int>(PERFECT_ATTR_ID);
+        pcrSettings.sequenceName = seq->getSequenceName();
+        pcrSettings.primers = panel;
+        sequences << seqId;
+        return new MultiplexPcrWorkflowTask(pcrSettings, productSettings);
+    }
+
     InSilicoPcrTaskSettings pcrSettings;
     pcrSettings.sequence = seq->getWholeSequenceData(os);
     CHECK_OP(os, NULL);
@@ -26,10 +26,14 @@
 #include <U2Lang/WorkflowUtils.h>
 
 #include "InSilicoPcrTask.h"
+#include "MultiplexPcrTask.h"
 
 #include "Primer.h"
 
 namespace U2 {
+
+class MultiplexPcrWorkflowTask;
+
 namespace LocalWorkflow {
 
 class InSilicoPcrPrompter : public PrompterBase<InSilicoPcrPrompter> {
@@ -92,14 +96,21 @@ protected:
 
 private:
     void fetchPrimers(const QList<GObject*> &objects, U2OpStatus &os);
+    void fetchPanel(const QList<GObject*> &objects, U2OpStatus &os);
     Primer createPrimer(GObject *object, bool &skipped, U2OpStatus &os);
-    int createMetadata(const InSilicoPcrTaskSettings &settings, const U2Region &productRegion, int pairNumber);
+    QList<Message> fetchMultiplexResult(MultiplexPcrWorkflowTask *task);
+    /* In the multiplex mode the pairs are registered when their products are found */
+    int getPairNumber(const MultiplexPcrProduct &product);
+    void addProductMessage(QList<Message> &messages, Document *doc, qint64 sequenceLength, const U2Region &productRegion, int pairNumber);
+    int createMetadata(qint64 sequenceLength, const U2Region &productRegion, int pairNumber);
     QByteArray createReport() const;
     QVariant fetchSequence(Document *doc);
     QVariant fetchAnnotations(Document *doc);
 
 private:
     QList< QPair<Primer, Primer> > primers;
+    QList<Primer> panel;
+    QMap<QPair<QString, QString>, int> panelPairs;
     QList<SharedDbiDataHandler> sequences;
     QList<InSilicoPcrReportTask::TableRow> table;
     bool reported;
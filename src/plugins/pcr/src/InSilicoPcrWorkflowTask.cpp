@@ -19,6 +19,9 @@
 * MA 02110-1301, USA.
 */
 
+#include <U2Core/L10n.h>
+#include <U2Core/U2SafePoints.h>
+
 #include "InSilicoPcrWorkflowTask.h"
 
 namespace U2 {
@@ -62,4 +65,48 @@ const InSilicoPcrTaskSettings & InSilicoPcrWorkflowTask::getPcrSettings() const
     return pcrTask->getSettings();
 }
 
+/************************************************************************/
+/* MultiplexPcrWorkflowTask */
+/************************************************************************/
+MultiplexPcrWorkflowTask::MultiplexPcrWorkflowTask(const MultiplexPcrTaskSettings &pcrSettings, const ExtractProductSettings &productSettings)
+: Task(tr("Multiplex in silico PCR workflow task"), TaskFlags_NR_FOSE_COSC), productSettings(productSettings)
+{
+    pcrTask = new MultiplexPcrTask(pcrSettings);
+    addSubTask(pcrTask);
+    pcrTask->setSubtaskProgressWeight(0.7);
+}
+
+QList<Task*> MultiplexPcrWorkflowTask::onSubTaskFinished(Task *subTask) {
+    QList<Task*> result;
+    CHECK(NULL != subTask, result);
+    CHECK(!subTask->getStateInfo().isCoR(), result);
+
+    if (pcrTask == subTask) {
+        foreach (const MultiplexPcrProduct &product, pcrTask->getResults()) {
+            ExtractProductTask *productTask = new ExtractProductTask(product, productSettings);
+            productTask->setSubtaskProgressWeight(0.3 / pcrTask->getResults().size());
+            result << productTask;
+            productTasks << productTask;
+        }
+    }
+    return result;
+}
+
+QList<MultiplexPcrWorkflowTask::Result> MultiplexPcrWorkflowTask::takeResult() {
+    QList<Result> result;
+    const QList<MultiplexPcrProduct> &products = pcrTask->getResults();
+    SAFE_POINT(products.size() == productTasks.size(), L10N::internalError("Wrong products count"), result);
+    for (int i = 0; i < productTasks.size(); i++) {
+        Result pcrResult;
+        pcrResult.doc = productTasks[i]->takeResult();
+        pcrResult.product = products[i];
+        result << pcrResult;
+    }
+    return result;
+}
+
+const MultiplexPcrTaskSettings & MultiplexPcrWorkflowTask::getPcrSettings() const {
+    return pcrTask->getSettings();
+}
+
 } // U2
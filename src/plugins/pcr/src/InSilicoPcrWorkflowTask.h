@@ -23,6 +23,7 @@
 #define _U2_IN_SILICO_PCR_WORKFLOW_TASK_H_
 
 #include "ExtractProductTask.h"
+#include "MultiplexPcrTask.h"
 
 namespace U2 {
 
@@ -48,6 +49,31 @@ private:
     QList<ExtractProductTask*> productTasks;
 };
 
+/**
+ * Finds products of the primer panel and extracts them like InSilicoPcrWorkflowTask.
+ */
+class MultiplexPcrWorkflowTask : public Task {
+    Q_OBJECT
+public:
+    class Result {
+    public:
+        Document *doc;
+        MultiplexPcrProduct product;
+    };
+    MultiplexPcrWorkflowTask(const MultiplexPcrTaskSettings &pcrSettings, const ExtractProductSettings &productSettings);
+
+    QList<Result> takeResult();
+    const MultiplexPcrTaskSettings & getPcrSettings() const;
+
+protected:
+    QList<Task*> onSubTaskFinished(Task *subTask);
+
+private:
+    ExtractProductSettings productSettings;
+    MultiplexPcrTask *pcrTask;
+    QList<ExtractProductTask*> productTasks;
+};
+
 } // U2
 
 #endif // _U2_IN_SILICO_PCR_WORKFLOW_TASK_H_
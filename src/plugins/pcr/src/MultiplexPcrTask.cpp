@@ -0,0 +1,168 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <U2Core/Counter.h>
+#include <U2Core/DNASequenceUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Algorithm/FindAlgorithm.h>
+
+#include "PrimerBindingSitesFinder.h"
+#include "PrimerLibrary.h"
+#include "PrimerStatistics.h"
+
+#include "MultiplexPcrTask.h"
+
+namespace U2 {
+
+MultiplexPcrTaskSettings::MultiplexPcrTaskSettings()
+    : isCircular(false), mismatches(0), maxProductSize(0), perfectMatch(0)
+{
+
+}
+
+MultiplexPcrProduct::MultiplexPcrProduct()
+    : InSilicoPcrProduct()
+{
+
+}
+
+MultiplexPcrTask::MultiplexPcrTask(const MultiplexPcrTaskSettings &settings)
+    : Task(tr("Multiplex In Silico PCR"), TaskFlags(TaskFlag_ReportingIsSupported) | TaskFlag_ReportingIsEnabled),
+      settings(settings)
+{
+    GCOUNTER(cvar, tvar, "MultiplexPcrTask");
+    tpm = Progress_Manual;
+}
+
+void MultiplexPcrTask::prepare() {
+    CHECK_EXT(settings.sequence.length() <= InSilicoPcrTaskSettings::MAX_SEQUENCE_LENGTH,
+              setError(tr("The sequence is too long: %1").arg(settings.sequenceName)), );
+
+    if (settings.primers.isEmpty()) {
+        PrimerLibrary *library = PrimerLibrary::getInstance(stateInfo);
+        CHECK_OP(stateInfo, );
+        SAFE_POINT_EXT(NULL != library, setError(L10N::nullPointerError("Primer Library")), );
+        settings.primers = library->getPrimers(stateInfo);
+        CHECK_OP(stateInfo, );
+    }
+
+    foreach (const Primer &primer, settings.primers) {
+        primerSequences << primer.sequence.toLocal8Bit();
+    }
+}
+
+void MultiplexPcrTask::run() {
+    PrimerBindingSitesFinder finder(primerSequences, settings.mismatches);
+    const QList<PrimerBindingSite> sites = finder.find(settings.sequence, settings.isCircular, stateInfo);
+    CHECK_OP(stateInfo, );
+
+    QList<PrimerBindingSite> leftSites;
+    QList<PrimerBindingSite> rightSites;
+    QVector<qint64> leftStarts;
+    QVector<qint64> rightEnds;
+    foreach (const PrimerBindingSite &site, sites) {
+        if (site.strand.isDirect()) {
+            leftSites << site;
+            leftStarts << site.region.startPos;
+        } else {
+            rightSites << site;
+            rightEnds << site.region.endPos();
+        }
+    }
+    algoLog.details(tr("Primer binding sites found: %1 direct, %2 complementary").arg(leftSites.size()).arg(rightSites.size()));
+
+    const qint64 circularLength = settings.isCircular ? settings.sequence.length() : 0;
+    const QList< QPair<int, int> > pairs = PcrProductSweep::findPairs(leftStarts, rightEnds, finder.getMinPrimerLength(), settings.maxProductSize, circularLength, stateInfo);
+    CHECK_OP(stateInfo, );
+
+    typedef QPair<int, int> SitesPair;
+    foreach (const SitesPair &pair, pairs) {
+        CHECK_OP(stateInfo, );
+        const PrimerBindingSite &leftSite = leftSites[pair.first];
+        const PrimerBindingSite &rightSite = rightSites[pair.second];
+        const QByteArray &forwardPrimer = primerSequences[leftSite.primerIndex];
+        const QByteArray &reversePrimer = primerSequences[rightSite.primerIndex];
+
+        const qint64 productSize = PcrProductSweep::getProductSize(leftSite.region.startPos, rightSite.region.endPos(), circularLength);
+        CHECK_OPERATION(productSize >= qMax(forwardPrimer.length(), reversePrimer.length()), continue);
+        if (settings.perfectMatch > 0) {
+            CHECK_OPERATION(checkPerfectMatch(leftSite, forwardPrimer), continue);
+            CHECK_OPERATION(checkPerfectMatch(rightSite, reversePrimer), continue);
+        }
+        results << createResult(leftSite, rightSite, productSize);
+    }
+    stateInfo.setProgress(100);
+}
+
+bool MultiplexPcrTask::checkPerfectMatch(const PrimerBindingSite &site, const QByteArray &primer) const {
+    CHECK(site.mismatches > 0, true);
+    QByteArray sequence = getSequence(site.region);
+    if (site.strand.isCompementary()) {
+        sequence = DNASequenceUtils::reverseComplement(sequence);
+    }
+    SAFE_POINT(sequence.length() == primer.length(), L10N::internalError("Wrong match length"), false);
+
+    const int perfectMatch = qMin(sequence.length(), int(settings.perfectMatch));
+    for (int i = 0; i < perfectMatch; i++) {
+        if (!FindAlgorithm::cmpAmbiguous(sequence.at(sequence.length() - 1 - i), primer.at(primer.length() - 1 - i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QByteArray MultiplexPcrTask::getSequence(const U2Region &region) const {
+    QByteArray result = settings.sequence.mid(region.startPos, region.length);
+    if (result.length() < region.length && settings.isCircular) {
+        result += settings.sequence.left(region.length - result.length());
+    }
+    return result;
+}
+
+MultiplexPcrProduct MultiplexPcrTask::createResult(const PrimerBindingSite &leftSite, const PrimerBindingSite &rightSite, qint64 productSize) const {
+    MultiplexPcrProduct result;
+    result.region = U2Region(leftSite.region.startPos, productSize);
+    result.forwardPrimer = primerSequences[leftSite.primerIndex];
+    result.reversePrimer = primerSequences[rightSite.primerIndex];
+    result.forwardPrimerName = settings.primers[leftSite.primerIndex].name;
+    result.reversePrimerName = settings.primers[rightSite.primerIndex].name;
+    result.forwardPrimerMatchLength = leftSite.region.length;
+    result.reversePrimerMatchLength = rightSite.region.length;
+    result.ta = PrimerStatistics::getAnnealingTemperature(getSequence(result.region), result.forwardPrimer, result.reversePrimer);
+    return result;
+}
+
+QString MultiplexPcrTask::generateReport() const {
+    return tr("Products found: %1 (primers in the panel: %2)").arg(results.size()).arg(settings.primers.size());
+}
+
+const QList<MultiplexPcrProduct> & MultiplexPcrTask::getResults() const {
+    return results;
+}
+
+const MultiplexPcrTaskSettings & MultiplexPcrTask::getSettings() const {
+    return settings;
+}
+
+} // U2
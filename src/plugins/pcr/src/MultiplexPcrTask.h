@@ -0,0 +1,88 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_MULTIPLEX_PCR_TASK_H_
+#define _U2_MULTIPLEX_PCR_TASK_H_
+
+#include <U2Core/Task.h>
+
+#include "InSilicoPcrTask.h"
+#include "Primer.h"
+
+namespace U2 {
+
+class PrimerBindingSite;
+
+class MultiplexPcrTaskSettings {
+public:
+    MultiplexPcrTaskSettings();
+
+    QByteArray sequence;
+    QString sequenceName;
+    bool isCircular;
+    /* The primers panel. If it is empty then all primers from the primer library are used */
+    QList<Primer> primers;
+    uint mismatches;
+    uint maxProductSize;
+    uint perfectMatch;
+};
+
+class MultiplexPcrProduct : public InSilicoPcrProduct {
+public:
+    MultiplexPcrProduct();
+
+    QString forwardPrimerName;
+    QString reversePrimerName;
+};
+
+/**
+ * Simulates PCR for every combination of primers from the panel.
+ * All primer binding sites are found in one pass over the sequence,
+ * then products are enumerated by a sweep over sites sorted by position.
+ */
+class MultiplexPcrTask : public Task {
+    Q_OBJECT
+public:
+    MultiplexPcrTask(const MultiplexPcrTaskSettings &settings);
+
+    // Task
+    void prepare();
+    void run();
+    QString generateReport() const;
+
+    const QList<MultiplexPcrProduct> & getResults() const;
+    const MultiplexPcrTaskSettings & getSettings() const;
+
+private:
+    bool checkPerfectMatch(const PrimerBindingSite &site, const QByteArray &primer) const;
+    QByteArray getSequence(const U2Region &region) const;
+    MultiplexPcrProduct createResult(const PrimerBindingSite &leftSite, const PrimerBindingSite &rightSite, qint64 productSize) const;
+
+private:
+    MultiplexPcrTaskSettings settings;
+    QList<QByteArray> primerSequences;
+    QList<MultiplexPcrProduct> results;
+};
+
+} // U2
+
+#endif // _U2_MULTIPLEX_PCR_TASK_H_
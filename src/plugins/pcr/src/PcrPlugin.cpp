@@ -21,6 +21,7 @@
 
 #include <QMenu>
 
+#include <U2Core/GAutoDeleteList.h>
 #include <U2Core/L10n.h>
 #include <U2Core/U2OpStatusUtils.h>
 #include <U2Core/U2SafePoints.h>
@@ -29,7 +30,11 @@
 #include <U2Gui/OPWidgetFactoryRegistry.h>
 #include <U2Gui/ToolsMenu.h>
 
+#include <U2Test/GTestFrameworkComponents.h>
+#include <U2Test/XMLTestFormat.h>
+
 #include "InSilicoPcrOPWidgetFactory.h"
+#include "PcrTests.h"
 #include "PrimerLibrary.h"
 #include "PrimerLibraryMdiWindow.h"
 
@@ -68,6 +73,18 @@ PcrPlugin::PcrPlugin()
     LocalWorkflow::FindPrimerPairsWorkerFactory::init();
     LocalWorkflow::PrimersGrouperWorkerFactory::init();
     LocalWorkflow::InSilicoPcrWorkerFactory::init();
+
+    GTestFormatRegistry *tfr = AppContext::getTestFramework()->getTestFormatRegistry();
+    XMLTestFormat *xmlTestFormat = qobject_cast<XMLTestFormat*>(tfr->findFormat("XML"));
+    SAFE_POINT(NULL != xmlTestFormat, L10N::nullPointerError("XML test format"), );
+
+    GAutoDeleteList<XMLTestFactory> *l = new GAutoDeleteList<XMLTestFactory>(this);
+    l->qlist = PcrTests::createTestFactories();
+    foreach (XMLTestFactory *f, l->qlist) {
+        bool res = xmlTestFormat->registerTestFactory(f);
+        Q_UNUSED(res);
+        assert(res);
+    }
 }
 
 PcrPlugin::~PcrPlugin() {
@@ -0,0 +1,316 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+
+#include <U2Algorithm/FindAlgorithm.h>
+
+#include <U2Core/DNASequenceUtils.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "MultiplexPcrTask.h"
+
+#include "PcrTests.h"
+
+namespace U2 {
+
+namespace {
+    const QString SEED_ATTR = "seed";
+    const QString SEQUENCE_LENGTH_ATTR = "sequence-length";
+    const QString PRIMERS_ATTR = "primers";
+    const QString MISMATCHES_ATTR = "mismatches";
+    const QString MAX_PRODUCT_ATTR = "max-product";
+    const QString CIRCULAR_ATTR = "circular";
+    const QString AMBIGUOUS_ATTR = "ambiguous";
+    const QString LOWER_CASE_ATTR = "lower-case";
+
+    const char BASES[] = "ACGT";
+    const char AMBIGUOUS_BASES[] = "NRYKMSW";
+
+    int random(int bound) {
+        return qrand() % bound;
+    }
+
+    bool siteLessThan(const PrimerBindingSite &first, const PrimerBindingSite &second) {
+        if (first.strand.getDirection() != second.strand.getDirection()) {
+            return first.strand.isDirect();
+        }
+        if (first.primerIndex != second.primerIndex) {
+            return first.primerIndex < second.primerIndex;
+        }
+        return first.region.startPos < second.region.startPos;
+    }
+
+    QString toString(const PrimerBindingSite &site) {
+        return QString("primer %1, %2 strand, region %3..%4, %5 mismatches").arg(site.primerIndex)
+            .arg(site.strand.isDirect() ? "direct" : "complementary")
+            .arg(site.region.startPos).arg(site.region.endPos()).arg(site.mismatches);
+    }
+
+    QString toString(const InSilicoPcrProduct &product, const QString &forwardName, const QString &reverseName) {
+        return QString("%1..%2 %3/%4").arg(product.region.startPos).arg(product.region.endPos()).arg(forwardName).arg(reverseName);
+    }
+
+    bool readInt(const QDomElement &el, const QString &attr, int defaultValue, int &result) {
+        const QString value = el.attribute(attr);
+        if (value.isEmpty()) {
+            result = defaultValue;
+            return true;
+        }
+        bool ok = false;
+        result = value.toInt(&ok);
+        return ok;
+    }
+}
+
+/************************************************************************/
+/* GTest_PrimerBindingSitesFinder */
+/************************************************************************/
+void GTest_PrimerBindingSitesFinder::init(XMLTestFormat *, const QDomElement &el) {
+    if (!readInt(el, SEED_ATTR, 1, seed)) {
+        failMissingValue(SEED_ATTR);
+        return;
+    }
+    if (!readInt(el, SEQUENCE_LENGTH_ATTR, 10000, sequenceLength) || sequenceLength < 100) {
+        failMissingValue(SEQUENCE_LENGTH_ATTR);
+        return;
+    }
+    if (!readInt(el, PRIMERS_ATTR, 20, primersCount) || primersCount < 1) {
+        failMissingValue(PRIMERS_ATTR);
+        return;
+    }
+    if (!readInt(el, MISMATCHES_ATTR, 2, mismatches) || mismatches < 0) {
+        failMissingValue(MISMATCHES_ATTR);
+        return;
+    }
+    isCircular = ("true" == el.attribute(CIRCULAR_ATTR));
+    ambiguous = ("true" == el.attribute(AMBIGUOUS_ATTR));
+    lowerCase = ("true" == el.attribute(LOWER_CASE_ATTR));
+}
+
+void GTest_PrimerBindingSitesFinder::run() {
+    qsrand(uint(seed));
+    QByteArray sequence = PcrTests::generateSequence(sequenceLength, ambiguous);
+    QList<QByteArray> primers = PcrTests::generatePrimers(sequence, primersCount, mismatches, ambiguous);
+    if (lowerCase) {
+        sequence = sequence.toLower();
+        for (int i = 0; i < primers.size(); i += 2) {
+            primers[i] = primers[i].toLower();
+        }
+    }
+
+    PrimerBindingSitesFinder finder(primers, uint(mismatches));
+    const QList<PrimerBindingSite> sites = finder.find(sequence, isCircular, stateInfo);
+    CHECK_OP(stateInfo, );
+    const QList<PrimerBindingSite> expected = PcrTests::findSitesNaive(sequence, isCircular, primers, uint(mismatches));
+
+    for (int i = 0; i < qMin(sites.size(), expected.size()); i++) {
+        const PrimerBindingSite &site = sites[i];
+        const PrimerBindingSite &expectedSite = expected[i];
+        if (site.primerIndex != expectedSite.primerIndex || site.strand != expectedSite.strand
+            || site.region != expectedSite.region || site.mismatches != expectedSite.mismatches) {
+            stateInfo.setError(QString("Unexpected binding site: %1, expected: %2").arg(toString(site)).arg(toString(expectedSite)));
+            return;
+        }
+    }
+    CHECK_EXT(sites.size() == expected.size(),
+              stateInfo.setError(QString("Binding sites count: %1, expected: %2").arg(sites.size()).arg(expected.size())), );
+}
+
+/************************************************************************/
+/* GTest_MultiplexPcr */
+/************************************************************************/
+void GTest_MultiplexPcr::init(XMLTestFormat *, const QDomElement &el) {
+    pcrTask = NULL;
+    if (!readInt(el, SEED_ATTR, 1, seed)) {
+        failMissingValue(SEED_ATTR);
+        return;
+    }
+    if (!readInt(el, SEQUENCE_LENGTH_ATTR, 5000, sequenceLength) || sequenceLength < 100) {
+        failMissingValue(SEQUENCE_LENGTH_ATTR);
+        return;
+    }
+    if (!readInt(el, PRIMERS_ATTR, 10, primersCount) || primersCount < 1) {
+        failMissingValue(PRIMERS_ATTR);
+        return;
+    }
+    if (!readInt(el, MISMATCHES_ATTR, 1, mismatches) || mismatches < 0) {
+        failMissingValue(MISMATCHES_ATTR);
+        return;
+    }
+    if (!readInt(el, MAX_PRODUCT_ATTR, 2000, maxProductSize) || maxProductSize < 0) {
+        failMissingValue(MAX_PRODUCT_ATTR);
+        return;
+    }
+    isCircular = ("true" == el.attribute(CIRCULAR_ATTR));
+}
+
+void GTest_MultiplexPcr::prepare() {
+    qsrand(uint(seed));
+    MultiplexPcrTaskSettings settings;
+    settings.sequence = PcrTests::generateSequence(sequenceLength, false);
+    settings.sequenceName = "sequence";
+    settings.isCircular = isCircular;
+    settings.mismatches = uint(mismatches);
+    settings.maxProductSize = uint(maxProductSize);
+
+    const QList<QByteArray> primers = PcrTests::generatePrimers(settings.sequence, primersCount, mismatches, false);
+    for (int i = 0; i < primers.size(); i++) {
+        Primer primer;
+        primer.name = QString("primer_%1").arg(i);
+        primer.sequence = QString::fromLatin1(primers[i]);
+        settings.primers << primer;
+    }
+
+    pcrTask = new MultiplexPcrTask(settings);
+    addSubTask(pcrTask);
+}
+
+Task::ReportResult GTest_MultiplexPcr::report() {
+    propagateSubtaskError();
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    const MultiplexPcrTaskSettings &settings = pcrTask->getSettings();
+    QList<QByteArray> primers;
+    foreach (const Primer &primer, settings.primers) {
+        primers << primer.sequence.toLatin1();
+    }
+
+    QList<PrimerBindingSite> leftSites;
+    QList<PrimerBindingSite> rightSites;
+    foreach (const PrimerBindingSite &site, PcrTests::findSitesNaive(settings.sequence, isCircular, primers, settings.mismatches)) {
+        (site.strand.isDirect() ? leftSites : rightSites) << site;
+    }
+
+    const qint64 length = settings.sequence.length();
+    QStringList expected;
+    foreach (const PrimerBindingSite &left, leftSites) {
+        foreach (const PrimerBindingSite &right, rightSites) {
+            qint64 productSize = right.region.endPos() - left.region.startPos;
+            if (productSize < 0 && isCircular) {
+                productSize += length;
+            }
+            const int minSize = qMax(primers[left.primerIndex].length(), primers[right.primerIndex].length());
+            CHECK_OPERATION(productSize >= minSize && productSize <= maxProductSize, continue);
+            InSilicoPcrProduct product;
+            product.region = U2Region(left.region.startPos, productSize);
+            expected << toString(product, settings.primers[left.primerIndex].name, settings.primers[right.primerIndex].name);
+        }
+    }
+
+    QStringList actual;
+    foreach (const MultiplexPcrProduct &product, pcrTask->getResults()) {
+        actual << toString(product, product.forwardPrimerName, product.reversePrimerName);
+    }
+    expected.sort();
+    actual.sort();
+    CHECK_EXT(!expected.isEmpty(), stateInfo.setError("The generated panel has no products, change the seed"), ReportResult_Finished);
+    CHECK_EXT(expected == actual, stateInfo.setError(QString("Products: [%1], expected: [%2]").arg(actual.join(", ")).arg(expected.join(", "))), ReportResult_Finished);
+    return ReportResult_Finished;
+}
+
+/************************************************************************/
+/* PcrTests */
+/************************************************************************/
+QList<XMLTestFactory*> PcrTests::createTestFactories() {
+    QList<XMLTestFactory*> res;
+    res.append(GTest_PrimerBindingSitesFinder::createFactory());
+    res.append(GTest_MultiplexPcr::createFactory());
+    return res;
+}
+
+QList<PrimerBindingSite> PcrTests::findSitesNaive(const QByteArray &sequence, bool isCircular, const QList<QByteArray> &primers, uint mismatches) {
+    QList<PrimerBindingSite> result;
+    const QByteArray upperSequence = sequence.toUpper();
+    for (int primerIndex = 0; primerIndex < primers.size(); primerIndex++) {
+        const QByteArray primer = primers[primerIndex].toUpper();
+        const int maxErr = PrimerBindingSitesFinder::getMaxError(primer.length(), mismatches);
+        QByteArray extended = upperSequence;
+        if (isCircular) {
+            extended += upperSequence.left(primer.length() - 1);
+        }
+        for (int strand = 0; strand < 2; strand++) {
+            const QByteArray pattern = (0 == strand) ? primer : DNASequenceUtils::reverseComplement(primer);
+            for (qint64 start = 0; start < upperSequence.length() && start + pattern.length() <= extended.length(); start++) {
+                int err = 0;
+                for (int i = 0; i < pattern.length() && err <= maxErr; i++) {
+                    err += FindAlgorithm::cmpAmbiguous(extended[int(start + i)], pattern[i]) ? 0 : 1;
+                }
+                CHECK_OPERATION(err <= maxErr, continue);
+                PrimerBindingSite site;
+                site.primerIndex = primerIndex;
+                site.strand = (0 == strand) ? U2Strand::Direct : U2Strand::Complementary;
+                site.region = U2Region(start, pattern.length());
+                site.mismatches = err;
+                result << site;
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), siteLessThan);
+    return result;
+}
+
+QByteArray PcrTests::generateSequence(int length, bool ambiguous) {
+    QByteArray result(length, 'A');
+    for (int i = 0; i < length; i++) {
+        result[i] = BASES[random(4)];
+    }
+    if (ambiguous) {
+        // Single ambiguous bases and runs of N
+        for (int i = 0; i < length / 500 + 1; i++) {
+            result[random(length)] = AMBIGUOUS_BASES[random(int(sizeof(AMBIGUOUS_BASES)) - 1)];
+            const int runStart = random(length);
+            const int runLength = qMin(length - runStart, 1 + random(30));
+            result.replace(runStart, runLength, QByteArray(runLength, 'N'));
+        }
+    }
+    return result;
+}
+
+QList<QByteArray> PcrTests::generatePrimers(const QByteArray &sequence, int count, int mismatches, bool ambiguous) {
+    QList<QByteArray> result;
+    for (int i = 0; i < count; i++) {
+        const int length = 18 + random(8);
+        QByteArray primer = sequence.mid(random(sequence.length() - length), length);
+        for (int j = 0; j < primer.length(); j++) {
+            // The ambiguous bases of the sequence are replaced to keep the primer mostly unambiguous
+            if (!QByteArray(BASES).contains(primer[j])) {
+                primer[j] = BASES[random(4)];
+            }
+        }
+        if (0 == random(2)) {
+            primer = DNASequenceUtils::reverseComplement(primer);
+        }
+        // Some primers get more mismatches than allowed
+        const int errors = random(mismatches + 2);
+        for (int j = 0; j < errors; j++) {
+            primer[random(primer.length())] = BASES[random(4)];
+        }
+        if (ambiguous && 0 == i % 3) {
+            primer[random(primer.length())] = AMBIGUOUS_BASES[random(int(sizeof(AMBIGUOUS_BASES)) - 1)];
+        }
+        result << primer;
+    }
+    return result;
+}
+
+} // U2
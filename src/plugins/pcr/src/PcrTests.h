@@ -0,0 +1,90 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_PCR_TESTS_H_
+#define _U2_PCR_TESTS_H_
+
+#include <QtXml/QDomElement>
+
+#include <U2Test/XMLTestUtils.h>
+
+#include "PrimerBindingSitesFinder.h"
+
+namespace U2 {
+
+class MultiplexPcrTask;
+
+/**
+ * Generates a random sequence and a primer panel taken from it with random mismatches,
+ * then compares the binding sites found by PrimerBindingSitesFinder with a naive scan.
+ */
+class GTest_PrimerBindingSitesFinder : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_PrimerBindingSitesFinder, "pcr-find-binding-sites");
+
+    void run();
+
+private:
+    int seed;
+    int sequenceLength;
+    int primersCount;
+    int mismatches;
+    bool isCircular;
+    /* Adds ambiguous bases to the sequence and the primers */
+    bool ambiguous;
+    bool lowerCase;
+};
+
+/**
+ * Runs MultiplexPcrTask on a generated panel and compares the products
+ * with all pairs of the naively found binding sites.
+ */
+class GTest_MultiplexPcr : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_MultiplexPcr, "multiplex-pcr");
+
+    void prepare();
+    ReportResult report();
+
+private:
+    int seed;
+    int sequenceLength;
+    int primersCount;
+    int mismatches;
+    int maxProductSize;
+    bool isCircular;
+    MultiplexPcrTask *pcrTask;
+};
+
+class PcrTests {
+public:
+    static QList<XMLTestFactory*> createTestFactories();
+    /* The naive scan that the binding sites search must agree with */
+    static QList<PrimerBindingSite> findSitesNaive(const QByteArray &sequence, bool isCircular, const QList<QByteArray> &primers, uint mismatches);
+    static QByteArray generateSequence(int length, bool ambiguous);
+    static QList<QByteArray> generatePrimers(const QByteArray &sequence, int count, int mismatches, bool ambiguous);
+};
+
+} // U2
+
+#endif // _U2_PCR_TESTS_H_
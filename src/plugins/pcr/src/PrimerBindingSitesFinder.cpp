@@ -0,0 +1,342 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <algorithm>
+
+#include <U2Algorithm/FindAlgorithm.h>
+
+#include <U2Core/DNASequenceUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "PrimerBindingSitesFinder.h"
+
+namespace U2 {
+
+PrimerBindingSite::PrimerBindingSite()
+    : primerIndex(-1), mismatches(0)
+{
+
+}
+
+const int PrimerBindingSitesFinder::MAX_SEED_LENGTH = 12;
+
+namespace {
+    const qint64 CANCEL_CHECK_STEP = 0xFFFF;
+
+    bool siteLessThan(const PrimerBindingSite &first, const PrimerBindingSite &second) {
+        if (first.strand.getDirection() != second.strand.getDirection()) {
+            return first.strand.isDirect();
+        }
+        if (first.primerIndex != second.primerIndex) {
+            return first.primerIndex < second.primerIndex;
+        }
+        return first.region.startPos < second.region.startPos;
+    }
+
+    bool isSameSite(const PrimerBindingSite &first, const PrimerBindingSite &second) {
+        return first.strand == second.strand
+            && first.primerIndex == second.primerIndex
+            && first.region.startPos == second.region.startPos;
+    }
+}
+
+PrimerBindingSitesFinder::PrimerBindingSitesFinder(const QList<QByteArray> &primers, uint mismatches)
+    : seedLength(MAX_SEED_LENGTH), minPrimerLength(0), maxPrimerLength(0)
+{
+    for (int i = 0; i < primers.size(); i++) {
+        const QByteArray primer = primers[i].toUpper();
+        CHECK_OPERATION(!primer.isEmpty(), continue);
+
+        Pattern direct;
+        direct.sequence = primer;
+        direct.primerIndex = i;
+        direct.strand = U2Strand::Direct;
+        direct.maxErr = getMaxError(primer.length(), mismatches);
+
+        Pattern complementary = direct;
+        complementary.sequence = DNASequenceUtils::reverseComplement(primer);
+        complementary.strand = U2Strand::Complementary;
+
+        patterns << direct << complementary;
+
+        minPrimerLength = (0 == minPrimerLength) ? primer.length() : qMin(minPrimerLength, primer.length());
+        maxPrimerLength = qMax(maxPrimerLength, primer.length());
+    }
+    initSeeds();
+}
+
+int PrimerBindingSitesFinder::getMaxError(int primerLength, uint mismatches) {
+    return qMin(int(mismatches), primerLength / 2);
+}
+
+int PrimerBindingSitesFinder::getCode(char c) {
+    switch (c) {
+    case 'A':
+    case 'a':
+        return 0;
+    case 'C':
+    case 'c':
+        return 1;
+    case 'G':
+    case 'g':
+        return 2;
+    case 'T':
+    case 't':
+    case 'U':
+    case 'u':
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+bool PrimerBindingSitesFinder::isUnambiguous(const QByteArray &sequence) {
+    for (int i = 0; i < sequence.length(); i++) {
+        CHECK(getCode(sequence[i]) >= 0, false);
+    }
+    return true;
+}
+
+void PrimerBindingSitesFinder::initSeeds() {
+    foreach (const Pattern &pattern, patterns) {
+        seedLength = qMin(seedLength, pattern.sequence.length() / (pattern.maxErr + 1));
+    }
+    seedLength = qMax(1, seedLength);
+    seedFilter.resize(1 << (2 * seedLength));
+
+    for (int patternIndex = 0; patternIndex < patterns.size(); patternIndex++) {
+        const Pattern &pattern = patterns[patternIndex];
+        // An ambiguous base matches several bases: exact seeds can't be used
+        if (!isUnambiguous(pattern.sequence)) {
+            unseededPatterns << patternIndex;
+            continue;
+        }
+
+        // Every segment gets a seed, otherwise a match with the exact segment without a seed can be missed
+        const int segmentLength = pattern.sequence.length() / (pattern.maxErr + 1);
+        for (int segment = 0; segment <= pattern.maxErr; segment++) {
+            Seed seed;
+            seed.patternIndex = patternIndex;
+            seed.offset = segment * segmentLength;
+
+            quint32 key = 0;
+            for (int i = 0; i < seedLength; i++) {
+                key = (key << 2) | quint32(getCode(pattern.sequence[seed.offset + i]));
+            }
+            seedFilter.setBit(int(key));
+            seeds[key] << seed;
+        }
+    }
+}
+
+QList<PrimerBindingSite> PrimerBindingSitesFinder::find(const QByteArray &sequence, bool isCircular, U2OpStatus &os) const {
+    QList<PrimerBindingSite> sites;
+    const qint64 sequenceLength = sequence.length();
+    CHECK(sequenceLength > 0 && !patterns.isEmpty(), sites);
+
+    // Ambiguous bases are compared by their codes that are defined for upper case only
+    QByteArray extendedSequence = sequence.toUpper();
+    if (isCircular) {
+        extendedSequence += sequence.left(maxPrimerLength - 1);
+    }
+    const qint64 extendedLength = extendedSequence.length();
+    const char *data = extendedSequence.constData();
+    const quint32 mask = (quint32(1) << (2 * seedLength)) - 1;
+
+    quint32 key = 0;
+    int validLength = 0;
+    QVector<U2Region> ambiguousRuns;
+    for (qint64 i = 0; i < extendedLength; i++) {
+        if (0 == (i & CANCEL_CHECK_STEP)) {
+            CHECK_OP(os, sites);
+            os.setProgress(int(100 * i / extendedLength));
+        }
+        const int code = getCode(data[i]);
+        if (code < 0) {
+            if (!ambiguousRuns.isEmpty() && ambiguousRuns.last().endPos() == i) {
+                ambiguousRuns.last().length++;
+            } else {
+                ambiguousRuns << U2Region(i, 1);
+            }
+            validLength = 0;
+            key = 0;
+            continue;
+        }
+        key = ((key << 2) | quint32(code)) & mask;
+        validLength = qMin(validLength + 1, seedLength);
+        if (validLength < seedLength || !seedFilter.testBit(int(key))) {
+            continue;
+        }
+
+        QHash<quint32, QVector<Seed> >::ConstIterator keySeeds = seeds.constFind(key);
+        CHECK_OPERATION(keySeeds != seeds.constEnd(), continue);
+        const qint64 windowStart = i - seedLength + 1;
+        foreach (const Seed &seed, keySeeds.value()) {
+            const Pattern &pattern = patterns[seed.patternIndex];
+            const qint64 start = windowStart - seed.offset;
+            if (start < 0 || start >= sequenceLength || start + pattern.sequence.length() > extendedLength) {
+                continue;
+            }
+            int mismatches = 0;
+            if (verify(data, start, pattern, mismatches)) {
+                addSite(sites, pattern, start, mismatches);
+            }
+        }
+    }
+
+    findAtAmbiguousBases(extendedSequence, sequenceLength, ambiguousRuns, sites, os);
+    CHECK_OP(os, sites);
+
+    foreach (int patternIndex, unseededPatterns) {
+        const Pattern &pattern = patterns[patternIndex];
+        for (qint64 start = 0; start < sequenceLength && start + pattern.sequence.length() <= extendedLength; start++) {
+            if (0 == (start & CANCEL_CHECK_STEP)) {
+                CHECK_OP(os, sites);
+            }
+            int mismatches = 0;
+            if (verify(data, start, pattern, mismatches)) {
+                addSite(sites, pattern, start, mismatches);
+            }
+        }
+    }
+
+    // The same site can be found by several seeds
+    std::sort(sites.begin(), sites.end(), siteLessThan);
+    sites.erase(std::unique(sites.begin(), sites.end(), isSameSite), sites.end());
+    return sites;
+}
+
+void PrimerBindingSitesFinder::findAtAmbiguousBases(const QByteArray &sequence, qint64 sequenceLength, const QVector<U2Region> &ambiguousRuns,
+                                                    QList<PrimerBindingSite> &sites, U2OpStatus &os) const {
+    // A seed can't cover an ambiguous base of the sequence, so the windows with these bases are verified directly
+    CHECK(!ambiguousRuns.isEmpty(), );
+    const char *data = sequence.constData();
+    for (int patternIndex = 0; patternIndex < patterns.size(); patternIndex++) {
+        CHECK_OPERATION(!unseededPatterns.contains(patternIndex), continue);
+        const Pattern &pattern = patterns[patternIndex];
+        const qint64 maxStart = qMin(sequenceLength, qint64(sequence.length()) - pattern.sequence.length() + 1) - 1;
+        qint64 nextStart = 0;
+        foreach (const U2Region &run, ambiguousRuns) {
+            CHECK_OP(os, );
+            const qint64 lastStart = qMin(run.endPos() - 1, maxStart);
+            for (qint64 start = qMax(nextStart, run.startPos - pattern.sequence.length() + 1); start <= lastStart; start++) {
+                int mismatches = 0;
+                if (verify(data, start, pattern, mismatches)) {
+                    addSite(sites, pattern, start, mismatches);
+                }
+            }
+            nextStart = qMax(nextStart, lastStart + 1);
+        }
+    }
+}
+
+bool PrimerBindingSitesFinder::verify(const char *sequence, qint64 start, const Pattern &pattern, int &mismatches) const {
+    const char *patternData = pattern.sequence.constData();
+    const int patternLength = pattern.sequence.length();
+    mismatches = 0;
+    for (int i = 0; i < patternLength; i++) {
+        if (!FindAlgorithm::cmpAmbiguous(sequence[start + i], patternData[i]) && ++mismatches > pattern.maxErr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PrimerBindingSitesFinder::addSite(QList<PrimerBindingSite> &sites, const Pattern &pattern, qint64 start, int mismatches) const {
+    PrimerBindingSite site;
+    site.primerIndex = pattern.primerIndex;
+    site.strand = pattern.strand;
+    site.region = U2Region(start, pattern.sequence.length());
+    site.mismatches = mismatches;
+    sites << site;
+}
+
+int PrimerBindingSitesFinder::getMaxPrimerLength() const {
+    return maxPrimerLength;
+}
+
+int PrimerBindingSitesFinder::getMinPrimerLength() const {
+    return minPrimerLength;
+}
+
+/************************************************************************/
+/* PcrProductSweep */
+/************************************************************************/
+namespace {
+    class StartLessThan {
+    public:
+        StartLessThan(const QVector<qint64> &starts) : starts(starts) {}
+        bool operator()(int first, int second) const {
+            return starts[first] < starts[second];
+        }
+        bool operator()(int index, qint64 value) const {
+            return starts[index] < value;
+        }
+    private:
+        const QVector<qint64> &starts;
+    };
+
+    void addPairs(QList< QPair<int, int> > &pairs, const QVector<int> &order, const QVector<qint64> &starts,
+                  qint64 minStart, qint64 maxStart, int rightIndex) {
+        CHECK(minStart <= maxStart, );
+        QVector<int>::ConstIterator it = std::lower_bound(order.constBegin(), order.constEnd(), minStart, StartLessThan(starts));
+        for (; it != order.constEnd() && starts[*it] <= maxStart; ++it) {
+            pairs << qMakePair(*it, rightIndex);
+        }
+    }
+}
+
+QList< QPair<int, int> > PcrProductSweep::findPairs(const QVector<qint64> &leftStarts, const QVector<qint64> &rightEnds,
+                                                   qint64 minSize, qint64 maxSize, qint64 circularLength, U2OpStatus &os) {
+    QList< QPair<int, int> > pairs;
+    CHECK(!leftStarts.isEmpty() && !rightEnds.isEmpty(), pairs);
+
+    QVector<int> order(leftStarts.size());
+    for (int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), StartLessThan(leftStarts));
+
+    for (int rightIndex = 0; rightIndex < rightEnds.size(); rightIndex++) {
+        CHECK_OP(os, pairs);
+        const qint64 end = rightEnds[rightIndex];
+        // Not wrapped product: end - start is in [minSize, maxSize]
+        addPairs(pairs, order, leftStarts, end - maxSize, qMin(end, end - minSize), rightIndex);
+        if (circularLength > 0) {
+            // Wrapped product: the left start is after the right end
+            addPairs(pairs, order, leftStarts, qMax(end + 1, end + circularLength - maxSize), end + circularLength - minSize, rightIndex);
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+qint64 PcrProductSweep::getProductSize(qint64 leftStart, qint64 rightEnd, qint64 circularLength) {
+    qint64 result = rightEnd - leftStart;
+    if (result < 0 && circularLength > 0) {
+        return rightEnd + (circularLength - leftStart);
+    }
+    return result;
+}
+
+} // U2
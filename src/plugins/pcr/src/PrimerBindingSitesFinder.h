@@ -0,0 +1,123 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _U2_PRIMER_BINDING_SITES_FINDER_H_
+#define _U2_PRIMER_BINDING_SITES_FINDER_H_
+
+#include <QBitArray>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+
+#include <U2Core/U2OpStatus.h>
+#include <U2Core/U2Region.h>
+#include <U2Core/U2Type.h>
+
+namespace U2 {
+
+class PrimerBindingSite {
+public:
+    PrimerBindingSite();
+
+    /* Index of the primer in the list passed to the finder */
+    int primerIndex;
+    /* Direct: the primer matches the sequence; Complementary: the reverse-complement of the primer matches the sequence */
+    U2Strand strand;
+    /* Region within the original sequence. Can go beyond the sequence end for circular sequences */
+    U2Region region;
+    int mismatches;
+};
+
+/**
+ * Finds binding sites of a set of primers in one pass over the sequence.
+ * Mismatches are handled with the pigeonhole principle: a primer with N mismatches
+ * is split into N + 1 segments and at least one of them must match exactly.
+ * The exact segment matches are found with a q-gram hash table and then verified.
+ * Primers with ambiguous bases and sequence windows with ambiguous bases are verified without seeds.
+ */
+class PrimerBindingSitesFinder {
+public:
+    PrimerBindingSitesFinder(const QList<QByteArray> &primers, uint mismatches);
+
+    /* The result is sorted by strand, primer index and position */
+    QList<PrimerBindingSite> find(const QByteArray &sequence, bool isCircular, U2OpStatus &os) const;
+
+    int getMaxPrimerLength() const;
+    int getMinPrimerLength() const;
+
+    /* The number of mismatches is limited by a half of the primer */
+    static int getMaxError(int primerLength, uint mismatches);
+
+    static const int MAX_SEED_LENGTH;
+
+private:
+    class Pattern {
+    public:
+        QByteArray sequence;
+        int primerIndex;
+        U2Strand strand;
+        int maxErr;
+    };
+
+    class Seed {
+    public:
+        int patternIndex;
+        int offset;
+    };
+
+    void initSeeds();
+    void findAtAmbiguousBases(const QByteArray &sequence, qint64 sequenceLength, const QVector<U2Region> &ambiguousRuns, QList<PrimerBindingSite> &sites, U2OpStatus &os) const;
+    bool verify(const char *sequence, qint64 start, const Pattern &pattern, int &mismatches) const;
+    void addSite(QList<PrimerBindingSite> &sites, const Pattern &pattern, qint64 start, int mismatches) const;
+
+    static int getCode(char c);
+    static bool isUnambiguous(const QByteArray &sequence);
+
+private:
+    QList<Pattern> patterns;
+    int seedLength;
+    QHash<quint32, QVector<Seed> > seeds;
+    QBitArray seedFilter;
+    /* Patterns with ambiguous bases: they are checked at every position */
+    QList<int> unseededPatterns;
+    int minPrimerLength;
+    int maxPrimerLength;
+};
+
+/**
+ * Enumerates "left" and "right" binding sites that form a product
+ * with the length in [minSize, maxSize] by a sorted sweep.
+ */
+class PcrProductSweep {
+public:
+    /**
+     * Returns pairs (left index, right index) where the product spans from the left start to the right end.
+     * @circularLength is the sequence length if the sequence is circular and 0 otherwise.
+     */
+    static QList< QPair<int, int> > findPairs(const QVector<qint64> &leftStarts, const QVector<qint64> &rightEnds, qint64 minSize, qint64 maxSize, qint64 circularLength, U2OpStatus &os);
+
+    static qint64 getProductSize(qint64 leftStart, qint64 rightEnd, qint64 circularLength);
+};
+
+} // U2
+
+#endif // _U2_PRIMER_BINDING_SITES_FINDER_H_
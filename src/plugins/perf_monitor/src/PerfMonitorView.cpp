@@ -41,42 +41,44 @@
 
 namespace U2 {
 
-static GCounter updateCounter("PerfMonitor::updateCounters", TimeCounter::getCounterSuffix(), TimeCounter::getCounterScale());
+static GHistogram updateCounter("PerfMonitor::updateCounters", TimeCounter::getCounterSuffix(), TimeCounter::getCounterScale());
 #ifdef Q_OS_LINUX
-static GCounter rssMemoryCounter("PerfMonitor::RSSmemoryUsage", "mbytes", 256);
-static GCounter virtMemoryCounter("PerfMonitor::VIRTmemoryUsage", "mbytes", 1048576);
+static GGauge rssMemoryCounter("PerfMonitor::RSSmemoryUsage", "mbytes", 256);
+static GGauge virtMemoryCounter("PerfMonitor::VIRTmemoryUsage", "mbytes", 1048576);
 #endif
 #ifdef Q_OS_WIN32
-static GCounter memoryCounter("PerfMonitor::memoryUsage", "mbytes", 1048576);
+static GGauge memoryCounter("PerfMonitor::memoryUsage", "mbytes", 1048576);
 #endif
 
 PerfMonitorView::PerfMonitorView() : MWMDIWindow(tr("Application counters")){
     tree = new QTreeWidget();
-    tree->setColumnCount(3);
+    tree->setColumnCount(7);
     tree->setSortingEnabled(true);
     tree->setColumnCount(0);
 
     tree->headerItem()->setText(0, tr("Name"));
     tree->headerItem()->setText(1, tr("Value"));
     tree->headerItem()->setText(2, tr("Scale"));
+    tree->headerItem()->setText(3, tr("Count"));
+    tree->headerItem()->setText(4, tr("Median"));
+    tree->headerItem()->setText(5, tr("95%"));
+    tree->headerItem()->setText(6, tr("99%"));
 
     QVBoxLayout* l = new QVBoxLayout();
     l->setMargin(0);
     l->addWidget(tree);
     setLayout(l);
 
-    updateCounter.totalCount = 0;
-
 #ifdef Q_OS_LINUX
     struct proc_t usage;
     look_up_our_self(&usage);
-    virtMemoryCounter.totalCount = usage.vsize;
-    rssMemoryCounter.totalCount = usage.rss;
+    virtMemoryCounter.set(usage.vsize);
+    rssMemoryCounter.set(usage.rss);
 #endif
 #ifdef Q_OS_WIN32
     PROCESS_MEMORY_COUNTERS memCounter;
     bool result = GetProcessMemoryInfo(GetCurrentProcess(), &memCounter, sizeof( memCounter ));
-    memoryCounter.totalCount = memCounter.WorkingSetSize;
+    memoryCounter.set(memCounter.WorkingSetSize);
 #endif
 
     updateCounters();
@@ -89,13 +91,13 @@ void PerfMonitorView::timerEvent(QTimerEvent *) {
 #ifdef Q_OS_LINUX
     struct proc_t usage;
     look_up_our_self(&usage);
-    virtMemoryCounter.totalCount = usage.vsize;
-    rssMemoryCounter.totalCount = usage.rss;
+    virtMemoryCounter.set(usage.vsize);
+    rssMemoryCounter.set(usage.rss);
 #endif
 #ifdef Q_OS_WIN32
     PROCESS_MEMORY_COUNTERS memCounter;
     bool result = GetProcessMemoryInfo(GetCurrentProcess(), &memCounter, sizeof( memCounter ));
-    memoryCounter.totalCount = memCounter.WorkingSetSize;
+    memoryCounter.set(memCounter.WorkingSetSize);
 #endif
     updateCounters();
 }
@@ -130,5 +132,13 @@ void PerfTreeItem::updateVisual() {
     setText(0, counter->name);
     setText(1, QString::number(counter->scaledTotal()));
     setText(2, counter->suffix);
+
+    const GHistogram *histogram = qobject_cast<const GHistogram *>(counter);
+    if (NULL != histogram) {
+        setText(3, QString::number(histogram->getObservationsCount()));
+        setText(4, QString::number(histogram->getPercentile(50)));
+        setText(5, QString::number(histogram->getPercentile(95)));
+        setText(6, QString::number(histogram->getPercentile(99)));
+    }
 }
 } //namespace
@@ -13,6 +13,8 @@ HEADERS += src/FindRepeatsDialog.h \
            src/RFBase.h \
            src/RFConstants.h \
            src/RFDiagonal.h \
+           src/RFKMer.h \
+           src/RFLocalTask.h \
            src/RFSArray.h \
            src/RFSArrayWK.h \
            src/RFTaskFactory.h \
@@ -29,6 +31,8 @@ SOURCES += src/FindRepeatsDialog.cpp \
            src/RF_SuffixArray.cpp \
            src/RFBase.cpp \
            src/RFDiagonal.cpp \
+           src/RFKMer.cpp \
+           src/RFLocalTask.cpp \
            src/RFSArray.cpp \
            src/RFSArrayWK.cpp \
            src/RFTaskFactory.cpp \
@@ -103,6 +103,7 @@ FindRepeatsDialog::FindRepeatsDialog(ADVSequenceObjectContext* _sc)
     algoCombo->addItem(tr("Auto"), RFAlgorithm_Auto);
     algoCombo->addItem(tr("Suffix index"), RFAlgorithm_Suffix);
     algoCombo->addItem(tr("Diagonals"), RFAlgorithm_Diagonal);
+    algoCombo->addItem(tr("K-mer index"), RFAlgorithm_KMer);
 
     filterAlgorithms->addItem(tr("Disjoint repeats"), DisjointRepeats);
     filterAlgorithms->addItem(tr("No filtering"), NoFiltering);
@@ -29,11 +29,15 @@
 #include <U2Core/TextUtils.h>
 #include <U2Core/Timer.h>
 #include <U2Core/U1AnnotationUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Remote/LocalTaskDistribution.h>
 
 #include "FindRepeatsTask.h"
 #include "RFBase.h"
 #include "RFConstants.h"
 #include "RFDiagonal.h"
+#include "RFLocalTask.h"
 #include "RF_SArray_TandemFinder.h"
 
 namespace U2 {
@@ -80,6 +84,7 @@ seq1(seq), seq2(seq2), tandemTask1(NULL), tandemTask2(NULL)
 
     revComplTask = NULL;
     rfTask = NULL;
+    distributionTask = NULL;
     startTime = GTimer::currentTimeMicros();
 }
 
@@ -111,8 +116,7 @@ Task *FindRepeatsTask::createRepeatFinderTask() {
         revComplTask->setSubtaskProgressWeight(0);
         return revComplTask;
     } else {
-        rfTask = createRFTask();
-        return rfTask;
+        return createSearchTask();
     }
 }
 
@@ -144,12 +148,48 @@ QList<Task*> FindRepeatsTask::onSubTaskFinished(Task* subTask) {
         res << createRepeatFinderTask();
     } else if (subTask == revComplTask) {
         startTime = GTimer::currentTimeMicros();
-        rfTask = createRFTask();
-        res.append(rfTask);
+        res.append(createSearchTask());
+    } else if (subTask == distributionTask) {
+        const RFLocalTaskResult* distributedResult = dynamic_cast<const RFLocalTaskResult*>(distributionTask->getResult());
+        CHECK_EXT(NULL != distributedResult, setError(tr("Repeats have not been received from the worker processes")), res);
+        onResults(distributedResult->results);
     }
     return res;
 }
 
+Task* FindRepeatsTask::createSearchTask() {
+    LocalTaskFactoryRegistry* ltfr = AppContext::getLocalTaskFactoryRegistry();
+    if (settings.nProcesses > 1 && NULL != ltfr && NULL != ltfr->getLocalTaskFactory(RFLocalTaskFactory::ID)) {
+        distributionTask = createDistributionTask();
+        return distributionTask;
+    }
+    rfTask = createRFTask();
+    return rfTask;
+}
+
+LocalTaskDistributionTask* FindRepeatsTask::createDistributionTask() {
+    stateInfo.setDescription(tr("Searching repeats ..."));
+
+    RFLocalTaskSettings* s = new RFLocalTaskSettings();
+    s->seqX = seq1.seq.mid(settings.seqRegion.startPos, settings.seqRegion.length);
+    if (!oneSequence) {
+        s->seqY = seq2.seq;
+    } else if (revComplTask != NULL) {
+        s->seqY = revComplTask->complementSequence.seq;
+    } else {
+        s->seqY = s->seqX;
+    }
+    s->alphabetId = seq1.alphabet->getId();
+    s->minLen = settings.minLen;
+    s->mismatches = settings.mismatches;
+    s->algo = settings.algo;
+    s->reportReflected = settings.reportReflected;
+    s->selfSearch = oneSequence && revComplTask == NULL;
+
+    // the results are returned in the same coordinates as createRFTask() reports them
+    return new LocalTaskDistributionTask(RFLocalTaskFactory::ID, s, settings.nProcesses);
+}
+
 RFAlgorithmBase* FindRepeatsTask::createRFTask() {
     stateInfo.setDescription(tr("Searching repeats ..."));
 
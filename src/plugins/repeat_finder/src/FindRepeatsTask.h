@@ -50,6 +50,7 @@ public:
         algo(RFAlgorithm_Auto),
         filter(DisjointRepeats),
         nThreads(MAX_PARALLEL_SUBTASKS_AUTO),
+        nProcesses(1),
         excludeTandems(false) {}
 
     int                 minLen;
@@ -72,6 +73,7 @@ public:
     RFAlgorithm         algo;
     RepeatsFilterAlgorithm    filter;
     int                 nThreads;
+    int                 nProcesses;     //UGENE processes the search is distributed to, 1 means this process only
     bool                excludeTandems;
 
     void setIdentity(int percent) {mismatches = int((minLen / 100.0) * (100 - percent));}
@@ -84,6 +86,7 @@ public:
 //WARNING: this task is suitable only for a single sequence processing -> check addResults x/y sorting
 class RevComplSequenceTask;
 class FindTandemsToAnnotationsTask;
+class LocalTaskDistributionTask;
 class FindRepeatsTask : public Task, public RFResultsListener {
 Q_OBJECT
 public:
@@ -106,7 +109,9 @@ protected:
     void addResult(const RFResult& r);
     void _addResult(int x, int y, int l, int c);
     bool isFilteredByRegions(const RFResult& r);
+    Task* createSearchTask();
     RFAlgorithmBase* createRFTask();
+    LocalTaskDistributionTask* createDistributionTask();
     void filterNestedRepeats();
     void filterUniqueRepeats();
     Task *createRepeatFinderTask();
@@ -119,6 +124,7 @@ protected:
     QMutex                      resultsLock;
     RevComplSequenceTask*       revComplTask;
     RFAlgorithmBase*            rfTask;
+    LocalTaskDistributionTask*  distributionTask;
     quint64                     startTime;
     FindTandemsToAnnotationsTask *tandemTask1;
     FindTandemsToAnnotationsTask *tandemTask2;
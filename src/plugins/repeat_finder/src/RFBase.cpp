@@ -24,6 +24,7 @@
 #include "RFSArray.h"
 #include "RFSArrayWK.h"
 #include "RFDiagonal.h"
+#include "RFKMer.h"
 
 #include <U2Core/Log.h>
 #include <U2Core/U2SafePoints.h>
@@ -46,6 +47,15 @@ RFAlgorithmBase* RFAlgorithmBase::createTask(RFResultsListener* l, const char *s
         //alg = RFAlgorithm_Diagonal; //the slowest but tested better
         alg = RFAlgorithm_Suffix;
     }
+    if (alg == RFAlgorithm_KMer) {
+        if (RFKMerAlgorithm::getSeedLength(w, mismatches, al->getType()) > 0) {
+            res = new RFKMerAlgorithm(l, seqX, sizeX, seqY, sizeY, al->getType(), w, w - mismatches);
+            res->setMaxParallelSubtasks(nThreads);
+            return res;
+        }
+        algoLog.trace("repeats are too short for k-mer seeds, using suffix or diagonal algorithm");
+        alg = RFAlgorithm_Suffix;
+    }
     if (mismatches == 0) {
         if (alg == RFAlgorithm_Diagonal) {
             res = new RFDiagonalAlgorithmWK(l, seqX, sizeX, seqY, sizeY, al->getType(), w, w);
@@ -0,0 +1,372 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "RFKMer.h"
+
+#include <U2Core/Log.h>
+#include <U2Core/U2SafePoints.h>
+
+namespace U2 {
+
+#define MIN_NUCL_SEED_LEN 8
+#define MAX_NUCL_SEED_LEN 16
+#define MIN_SEED_LEN 4
+#define MAX_SEED_LEN 8
+
+#define SEED_HASH_BASE 0x100000001B3ULL
+#define SEED_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+#define Y_BLOCK_SIZE (4*1000*1000)
+#define RESULTS_BLOCK_SIZE 4096
+
+RFKMerAlgorithm::RFKMerAlgorithm(RFResultsListener* rl, const char* seqX, int sizeX, const char* seqY, int sizeY,
+                                 DNAAlphabetType seqType, int w, int k)
+: RFAlgorithmBase(rl, seqX, sizeX, seqY, sizeY, seqType, w, k),
+nThreads(1), hashBits(1), indexMemory(0), blockStart(0), blockEnd(0), nPendingSubtasks(0), searchPhase(false)
+{
+    SEED_LEN = getSeedLength(w, w - k, seqType);
+    // every run of W/(C+1) matches contains a sampled seed
+    SEED_STEP = SEED_LEN == 0 ? 1 : w / (w - k + 1) - SEED_LEN + 1;
+    tpm = Progress_Manual;
+}
+
+int RFKMerAlgorithm::getSeedLength(int w, int mismatches, DNAAlphabetType seqType) {
+    // a window with C mismatches has a run of at least W/(C+1) matches
+    int maxRun = w / (mismatches + 1);
+    bool nucl = seqType == DNAAlphabet_NUCL;
+    if (maxRun < (nucl ? MIN_NUCL_SEED_LEN : MIN_SEED_LEN)) {
+        return 0;
+    }
+    return qMin(maxRun, nucl ? MAX_NUCL_SEED_LEN : MAX_SEED_LEN);
+}
+
+void RFKMerAlgorithm::prepare() {
+    RFAlgorithmBase::prepare();
+    CHECK(!hasError(), );
+    if (SEED_LEN == 0) {
+        setError(tr("Repeat length is too small for the k-mer index: %1").arg(WINDOW_SIZE));
+        return;
+    }
+    nThreads = qMax(1, getNumParallelSubtasks());
+    diagonalStates.resize(nThreads);
+    algoLog.trace(QString("Repeat finder: k-mer seed length %1, seed step %2, threads %3").arg(SEED_LEN).arg(SEED_STEP).arg(nThreads));
+
+    nPendingSubtasks = 1;
+    addSubTask(new RFKMerIndexSubtask(this));
+}
+
+QList<Task*> RFKMerAlgorithm::onSubTaskFinished(Task* subTask) {
+    QList<Task*> res;
+    CHECK(!subTask->hasError() && !subTask->isCanceled() && !hasError() && !isCanceled(), res);
+    if (--nPendingSubtasks > 0) {
+        return res;
+    }
+    if (searchPhase) {
+        return createExtendSubtasks();
+    }
+
+    // the index is built or the previous block is extended
+    blockHits.clear();
+    blockStart = blockEnd;
+    stateInfo.progress = int(100 * qint64(blockStart) / SIZE_Y);
+    for (int i = 0; i < diagonalStates.size(); i++) {
+        // for the next hits the diagonal scan starts after the seed start - W anyway
+        QHash<int, int>& states = diagonalStates[i];
+        for (QHash<int, int>::iterator it = states.begin(); it != states.end();) {
+            it = it.value() <= blockStart + SEED_LEN - WINDOW_SIZE ? states.erase(it) : it + 1;
+        }
+    }
+    if (blockStart > SIZE_Y - SEED_LEN) {
+        return res;
+    }
+    return createSearchSubtasks();
+}
+
+QList<Task*> RFKMerAlgorithm::createSearchSubtasks() {
+    QList<Task*> res;
+    searchPhase = true;
+    blockEnd = qMin(blockStart + Y_BLOCK_SIZE, SIZE_Y - SEED_LEN + 1);
+    blockHits.resize(nThreads);
+    for (int i = 0; i < nThreads; i++) {
+        blockHits[i].resize(nThreads);
+    }
+
+    int len = (blockEnd - blockStart + nThreads - 1) / nThreads;
+    for (int i = 0; i < nThreads; i++) {
+        int yStart = blockStart + i * len;
+        int yEnd = qMin(yStart + len, blockEnd);
+        if (yStart < yEnd) {
+            res << new RFKMerSearchSubtask(this, yStart, yEnd, blockHits[i]);
+        }
+    }
+    nPendingSubtasks = res.size();
+    return res;
+}
+
+QList<Task*> RFKMerAlgorithm::createExtendSubtasks() {
+    QList<Task*> res;
+    searchPhase = false;
+    for (int i = 0; i < nThreads; i++) {
+        res << new RFKMerExtendSubtask(this, i);
+    }
+    nPendingSubtasks = res.size();
+    return res;
+}
+
+quint64 RFKMerAlgorithm::getSeedHash(const char* seed) const {
+    quint64 hash = 0;
+    for (int i = 0; i < SEED_LEN; i++) {
+        hash = hash * SEED_HASH_BASE + uchar(seed[i]);
+    }
+    return hash;
+}
+
+static inline quint32 getBucket(quint64 hash, int hashBits) {
+    return quint32((hash * SEED_HASH_MULTIPLIER) >> (64 - hashBits));
+}
+
+int RFKMerAlgorithm::getOwner(int diag) const {
+    return int(quint32(diag) % quint32(nThreads));
+}
+
+void RFKMerAlgorithm::buildIndex(TaskStateInfo& si) {
+    int nSeeds = SIZE_X < SEED_LEN ? 0 : (SIZE_X - SEED_LEN) / SEED_STEP + 1;
+    hashBits = 1;
+    while ((qint64(1) << hashBits) < 2 * qint64(nSeeds) && hashBits < 30) {
+        hashBits++;
+    }
+    const qint64 nBuckets = qint64(1) << hashBits;
+    if (!indexMemory.tryAcquire((nBuckets + nSeeds) * qint64(sizeof(int)))) {
+        si.setError(tr("Not enough memory for the k-mer index: %1").arg(indexMemory.getError()));
+        return;
+    }
+    try {
+        buckets.fill(-1, int(nBuckets));
+        chains.fill(-1, nSeeds);
+    } catch (...) {
+        si.setError(tr("Not enough memory"));
+        return;
+    }
+
+    for (int i = 0; i < nSeeds && !si.cancelFlag; i++) {
+        const char* seed = seqX + qint64(i) * SEED_STEP;
+        if (memchr(seed, unknownChar, SEED_LEN) != NULL) {
+            continue;
+        }
+        quint32 bucket = getBucket(getSeedHash(seed), hashBits);
+        chains[i] = buckets[bucket];
+        buckets[bucket] = i;
+    }
+}
+
+void RFKMerAlgorithm::findHits(int yStart, int yEnd, QVector< QVector<RFKMerHit> >& ownerHits, TaskStateInfo& si) {
+    const int q = SEED_LEN;
+    quint64 leadingPower = 1;
+    for (int i = 1; i < q; i++) {
+        leadingPower *= SEED_HASH_BASE;
+    }
+    quint64 hash = getSeedHash(seqY + yStart);
+    int lastUnknown = -1;
+    for (int i = yStart; i < yStart + q; i++) {
+        if (seqY[i] == unknownChar) {
+            lastUnknown = i;
+        }
+    }
+
+    const int* chainsData = chains.constData();
+    const int* bucketsData = buckets.constData();
+    for (int y = yStart; y < yEnd; y++) {
+        if ((y & 0xFFFF) == 0 && si.cancelFlag) {
+            return;
+        }
+        if (lastUnknown < y) {
+            const char* seedY = seqY + y;
+            for (int seed = bucketsData[getBucket(hash, hashBits)]; seed != -1; seed = chainsData[seed]) {
+                int x = seed * SEED_STEP;
+                if ((reflective && x <= y) || memcmp(seqX + x, seedY, q) != 0) {
+                    continue;
+                }
+                ownerHits[getOwner(x - y)].append(RFKMerHit(x, y));
+            }
+        }
+        if (y + q < SIZE_Y) {
+            char c = seqY[y + q];
+            hash = (hash - leadingPower * uchar(seqY[y])) * SEED_HASH_BASE + uchar(c);
+            if (c == unknownChar) {
+                lastUnknown = y + q;
+            }
+        }
+    }
+}
+
+int RFKMerAlgorithm::findWindow(int diag, int from, int to, bool& found) const {
+    int W = WINDOW_SIZE;
+    const char* xseq = seqX + diag + from + W - 1; //point to the last pos in window -> will be checked first
+    const char* yseq = seqY + from + W - 1;
+    const char* xseqMax = seqX + SIZE_X;
+    const char* yseqMax = seqY + SIZE_Y;
+
+    found = false;
+    while (xseq < xseqMax && yseq < yseqMax) {
+        int start = yseq - seqY - W + 1;
+        if (start > to) {
+            return start;
+        }
+        int c = 0; //number of mismatches (temporary)
+        for (const char* s = xseq - W; xseq > s && (c += (PCHAR_MATCHES(xseq, yseq) ? 0 : 1)) <= C; xseq--, yseq--){}
+        if (c > C) {
+            xseq += W;
+            yseq += W;
+            continue;
+        }
+        found = true;
+        return start;
+    }
+    return yseq - seqY - W + 1;
+}
+
+/** Returns the number of matched chars, compares 8 chars at once while there are no mismatches */
+static int matchForward(const char* x, const char* y, int maxLen, char unknownChar) {
+    const quint64 ones = 0x0101010101010101ULL;
+    const quint64 unknownChars = ones * uchar(unknownChar);
+    int len = 0;
+    for (; len + 8 <= maxLen; len += 8) {
+        quint64 wx = 0;
+        quint64 wy = 0;
+        memcpy(&wx, x + len, 8);
+        memcpy(&wy, y + len, 8);
+        quint64 u = wx ^ unknownChars; // has a zero byte if there is an unknown char
+        if (wx != wy || ((u - ones) & ~u & (ones << 7)) != 0) {
+            break;
+        }
+    }
+    for (; len < maxLen && PCHAR_MATCHES(x + len, y + len); len++) {}
+    return len;
+}
+
+int RFKMerAlgorithm::extendWindow(int diag, int windowStart) const {
+    int W = WINDOW_SIZE;
+    const char* x = seqX + diag + windowStart;
+    const char* y = seqY + windowStart;
+    const char* xEnd = seqX + SIZE_X;
+    const char* yEnd = seqY + SIZE_Y;
+    if (C == 0) {
+        return W + matchForward(x + W, y + W, qMin(xEnd - x, yEnd - y) - W, unknownChar);
+    }
+
+    int k = 0;
+    for (int i = 0; i < W; i++) {
+        k += PCHAR_MATCHES(x + i, y + i) ? 1 : 0;
+    }
+    const char *xr = x + W, *yr = y + W;
+    for (; xr < xEnd && yr < yEnd; ++xr, ++yr) {
+        int pushV = PCHAR_MATCHES(xr, yr) ? 1 : 0;
+        int popV = PCHAR_MATCHES(xr-W, yr-W) ? 1 : 0;
+        k += pushV - popV;
+        if (k < K) { //end of the match
+            break;
+        }
+    }
+    return xr - x;
+}
+
+void RFKMerAlgorithm::extendHits(int owner, QVector<RFResult>& results, TaskStateInfo& si) {
+    int W = WINDOW_SIZE;
+    QHash<int, int>& states = diagonalStates[owner];
+    for (int t = 0; t < blockHits.size() && !si.cancelFlag; t++) {
+        // search subtasks cover consecutive ranges of Y, so the hits go in the Y order
+        const QVector<RFKMerHit>& hits = blockHits.at(t).at(owner);
+        for (int i = 0; i < hits.size(); i++) {
+            const RFKMerHit& hit = hits.at(i);
+            int diag = hit.x - hit.y;
+            int nextStart = states.value(diag, qMax(-diag, 0));
+            if (hit.y < nextStart) {
+                continue;
+            }
+            // every window that fits the mismatches limit has a sampled seed inside:
+            // all windows that start before the windows with this seed are checked by the previous hits.
+            // The hit is processed until all windows with this seed are checked
+            while (hit.y >= nextStart) {
+                bool found = false;
+                int windowStart = findWindow(diag, qMax(nextStart, hit.y + SEED_LEN - W), hit.y, found);
+                if (!found) {
+                    nextStart = windowStart;
+                    break;
+                }
+                int len = extendWindow(diag, windowStart);
+                // continue the scan of the diagonal like RFDiagonalWKSubtask::processDiagonal does
+                nextStart = windowStart + len - W + 2;
+
+                const char* xseq = seqX + diag + windowStart;
+                const char* yseq = seqY + windowStart;
+                while (len > W && !PCHAR_MATCHES(xseq, yseq)){len--; xseq++; yseq++;} //ensure that match with len > W starts with hit
+                while (len > W && !PCHAR_MATCHES(xseq + len - 1, yseq + len - 1)){len--;} //ensure that match with len > W ends with hit
+                int allMatches = 0;
+                for (int j = 0; j < len; j++) {
+                    allMatches += PCHAR_MATCHES(xseq + j, yseq + j) ? 1 : 0;
+                }
+                results.append(RFResult(xseq - seqX, yseq - seqY, len, allMatches));
+                if (results.size() >= RESULTS_BLOCK_SIZE) {
+                    addToResults(results);
+                    results.clear();
+                }
+            }
+            states[diag] = nextStart;
+        }
+    }
+    if (!results.isEmpty()) {
+        addToResults(results);
+        results.clear();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// subtasks
+
+RFKMerIndexSubtask::RFKMerIndexSubtask(RFKMerAlgorithm* _owner)
+: Task(tr("Build k-mer index"), TaskFlag_None), owner(_owner)
+{
+}
+
+void RFKMerIndexSubtask::run() {
+    owner->buildIndex(stateInfo);
+}
+
+RFKMerSearchSubtask::RFKMerSearchSubtask(RFKMerAlgorithm* _owner, int _yStart, int _yEnd, QVector< QVector<RFKMerHit> >& _ownerHits)
+: Task(tr("Find k-mer hits"), TaskFlag_None), owner(_owner), yStart(_yStart), yEnd(_yEnd), ownerHits(_ownerHits)
+{
+}
+
+void RFKMerSearchSubtask::run() {
+    owner->findHits(yStart, yEnd, ownerHits, stateInfo);
+}
+
+RFKMerExtendSubtask::RFKMerExtendSubtask(RFKMerAlgorithm* _owner, int _ownerNum)
+: Task(tr("Extend k-mer hits"), TaskFlag_None), owner(_owner), ownerNum(_ownerNum)
+{
+}
+
+void RFKMerExtendSubtask::run() {
+    QVector<RFResult> results;
+    owner->extendHits(ownerNum, results, stateInfo);
+}
+
+} //namespace
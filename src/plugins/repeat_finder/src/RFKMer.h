@@ -0,0 +1,141 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_RF_KMER_ALG_H_
+#define _U2_RF_KMER_ALG_H_
+
+#include "RFBase.h"
+
+#include <QtCore/QHash>
+
+#include <U2Core/AppResources.h>
+
+namespace U2 {
+
+class RFKMerIndexSubtask;
+class RFKMerSearchSubtask;
+class RFKMerExtendSubtask;
+
+class RFKMerHit {
+public:
+    RFKMerHit(int _x = 0, int _y = 0) : x(_x), y(_y) {}
+
+    int x;
+    int y;
+};
+
+/**
+    Finds repeats seeding with a hash index of sampled k-mers of X.
+    Seeds are looked up for all positions of Y, and the hit diagonals are scanned
+    the same way as RFDiagonalAlgorithmWK does it, so the results are the same.
+    Y is processed by blocks: the hits of a block are found in parallel and then
+    extended in parallel, every diagonal is extended by a single subtask.
+*/
+class RFKMerAlgorithm : public RFAlgorithmBase {
+    Q_OBJECT
+    friend class RFKMerIndexSubtask;
+    friend class RFKMerSearchSubtask;
+    friend class RFKMerExtendSubtask;
+public:
+    RFKMerAlgorithm(RFResultsListener* rl, const char* seqX, int sizeX, const char* seqY, int sizeY,
+                    DNAAlphabetType seqType, int w, int k);
+
+    void prepare();
+
+    QList<Task*> onSubTaskFinished(Task* subTask);
+
+    /** Returns the seed length for the given repeat parameters or 0 if seeds are too short to be selective */
+    static int getSeedLength(int w, int mismatches, DNAAlphabetType seqType);
+
+private:
+    void buildIndex(TaskStateInfo& si);
+    void findHits(int yStart, int yEnd, QVector< QVector<RFKMerHit> >& ownerHits, TaskStateInfo& si);
+    void extendHits(int owner, QVector<RFResult>& results, TaskStateInfo& si);
+    /** Finds the first window on the diagonal with start in [from, to] that fits the mismatches limit.
+        Returns the start of the found window or the first window start that is not checked yet */
+    int findWindow(int diag, int from, int to, bool& found) const;
+    /** Returns the length of the match that begins at the window start, like RFDiagonalWKSubtask::processMatch does */
+    int extendWindow(int diag, int windowStart) const;
+    int getOwner(int diag) const;
+    quint64 getSeedHash(const char* seed) const;
+
+    QList<Task*> createSearchSubtasks();
+    QList<Task*> createExtendSubtasks();
+
+    int SEED_LEN;
+    int SEED_STEP;
+    int nThreads;
+
+    // seed index: chains of sampled positions of X by hash buckets
+    int             hashBits;
+    QVector<int>    buckets;
+    QVector<int>    chains;
+    // reserves the index memory for the whole search
+    MemoryLocker    indexMemory;
+
+    int blockStart;
+    int blockEnd;
+    int nPendingSubtasks;
+    bool searchPhase;
+
+    // hits of the current block: [search subtask][owner of the hit diagonal]
+    QVector< QVector< QVector<RFKMerHit> > > blockHits;
+    // the first window start that is not scanned yet by diagonals, separate map for every owner
+    QVector< QHash<int, int> > diagonalStates;
+};
+
+class RFKMerIndexSubtask : public Task {
+    Q_OBJECT
+public:
+    RFKMerIndexSubtask(RFKMerAlgorithm* owner);
+    void run();
+
+private:
+    RFKMerAlgorithm* owner;
+};
+
+class RFKMerSearchSubtask : public Task {
+    Q_OBJECT
+public:
+    RFKMerSearchSubtask(RFKMerAlgorithm* owner, int yStart, int yEnd, QVector< QVector<RFKMerHit> >& ownerHits);
+    void run();
+
+private:
+    RFKMerAlgorithm*                    owner;
+    int                                 yStart;
+    int                                 yEnd;
+    QVector< QVector<RFKMerHit> >&      ownerHits;
+};
+
+class RFKMerExtendSubtask : public Task {
+    Q_OBJECT
+public:
+    RFKMerExtendSubtask(RFKMerAlgorithm* owner, int ownerNum);
+    void run();
+
+private:
+    RFKMerAlgorithm*    owner;
+    int                 ownerNum;
+};
+
+} //namespace
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDataStream>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "RFBase.h"
+#include "RFLocalTask.h"
+
+namespace U2 {
+
+namespace {
+
+/* a part must be several times longer than the overlap, otherwise the same windows are compared twice */
+const int MIN_PART_TO_OVERLAP_RATIO = 4;
+
+bool diagonalLessThan(const RFResult& r1, const RFResult& r2) {
+    int d1 = r1.y - r1.x;
+    int d2 = r2.y - r2.x;
+    return (d1 != d2) ? d1 < d2 : r1.x < r2.x;
+}
+
+// joins the pieces of the same repeat found in the neighbouring parts
+QVector<RFResult> joinPieces(QVector<RFResult>& pieces) {
+    qSort(pieces.begin(), pieces.end(), diagonalLessThan);
+    QVector<RFResult> joined;
+    foreach (const RFResult& r, pieces) {
+        if (!joined.isEmpty()) {
+            RFResult& last = joined.last();
+            if (last.y - last.x == r.y - r.x && r.x <= last.x + last.l) {
+                int end = qMax(last.x + last.l, r.x + r.l);
+                // the mismatches of the overlapped columns are counted twice, so the number of matches is a lower bound
+                int mismatches = (last.l - last.c) + (r.l - r.c);
+                last.l = end - last.x;
+                last.c = qMax(0, last.l - mismatches);
+                continue;
+            }
+        }
+        joined.append(r);
+    }
+    return joined;
+}
+
+}
+
+/************************************************************************/
+/* RFLocalTaskSettings */
+/************************************************************************/
+RFLocalTaskSettings::RFLocalTaskSettings()
+: minLen(0), mismatches(0), algo(RFAlgorithm_Auto), reportReflected(false), selfSearch(false), xOffset(0)
+{
+}
+
+QVariant RFLocalTaskSettings::serialize() const {
+    QVariantMap data;
+    data["seqX"] = seqX;
+    data["seqY"] = seqY;
+    data["alphabet"] = alphabetId;
+    data["minLen"] = minLen;
+    data["mismatches"] = mismatches;
+    data["algorithm"] = int(algo);
+    data["reportReflected"] = reportReflected;
+    data["selfSearch"] = selfSearch;
+    data["xOffset"] = xOffset;
+    return data;
+}
+
+bool RFLocalTaskSettings::deserialize(const QVariant& data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    const QVariantMap map = data.toMap();
+    seqX = map["seqX"].toByteArray();
+    seqY = map["seqY"].toByteArray();
+    alphabetId = map["alphabet"].toString();
+    minLen = map["minLen"].toInt();
+    mismatches = map["mismatches"].toInt();
+    algo = RFAlgorithm(map["algorithm"].toInt());
+    reportReflected = map["reportReflected"].toBool();
+    selfSearch = map["selfSearch"].toBool();
+    xOffset = map["xOffset"].toInt();
+    return minLen > 0 && !seqX.isEmpty() && !seqY.isEmpty();
+}
+
+/************************************************************************/
+/* RFLocalTaskResult */
+/************************************************************************/
+RFLocalTaskResult::RFLocalTaskResult()
+: reportReflected(false), selfSearch(false), seqYLen(0)
+{
+}
+
+QVariant RFLocalTaskResult::serialize() const {
+    QByteArray packedResults;
+    QDataStream out(&packedResults, QIODevice::WriteOnly);
+    out << qint32(results.size());
+    foreach (const RFResult& r, results) {
+        out << qint32(r.x) << qint32(r.y) << qint32(r.l) << qint32(r.c);
+    }
+
+    QVariantMap data;
+    data["results"] = packedResults;
+    data["reportReflected"] = reportReflected;
+    data["selfSearch"] = selfSearch;
+    data["seqYLen"] = seqYLen;
+    return data;
+}
+
+bool RFLocalTaskResult::deserialize(const QVariant& data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    const QVariantMap map = data.toMap();
+    reportReflected = map["reportReflected"].toBool();
+    selfSearch = map["selfSearch"].toBool();
+    seqYLen = map["seqYLen"].toInt();
+
+    QDataStream in(map["results"].toByteArray());
+    qint32 size = 0;
+    in >> size;
+    CHECK(size >= 0, false);
+    results.clear();
+    results.reserve(size);
+    for (qint32 i = 0; i < size; i++) {
+        qint32 x = 0, y = 0, l = 0, c = 0;
+        in >> x >> y >> l >> c;
+        results.append(RFResult(x, y, l, c));
+    }
+    return QDataStream::Ok == in.status();
+}
+
+/************************************************************************/
+/* RFLocalTask */
+/************************************************************************/
+RFLocalTask::RFLocalTask(const RFLocalTaskSettings& s)
+: LocalTask(tr("Find repeats in a sequence part"), TaskFlags_NR_FOSCOE), settings(s)
+{
+    result.reportReflected = settings.reportReflected;
+    result.selfSearch = settings.selfSearch;
+    result.seqYLen = settings.seqY.length();
+}
+
+void RFLocalTask::prepare() {
+    const DNAAlphabet* al = AppContext::getDNAAlphabetRegistry()->findById(settings.alphabetId);
+    CHECK_EXT(NULL != al, setError(tr("Unknown alphabet: %1").arg(settings.alphabetId)), );
+
+    // the process runs one part of the search, other cores are busy with the other parts
+    RFAlgorithmBase* t = RFAlgorithmBase::createTask(this, settings.seqX.constData(), settings.seqX.length(),
+        settings.seqY.constData(), settings.seqY.length(), al, settings.minLen, settings.mismatches, settings.algo, 1);
+    addSubTask(t);
+}
+
+const LocalTaskResult* RFLocalTask::getResult() const {
+    return hasError() ? NULL : &result;
+}
+
+void RFLocalTask::onResult(const RFResult& r) {
+    QMutexLocker ml(&resultsLock);
+    result.results.append(RFResult(r.x + settings.xOffset, r.y, r.l, r.c));
+}
+
+void RFLocalTask::onResults(const QVector<RFResult>& v) {
+    QMutexLocker ml(&resultsLock);
+    foreach (const RFResult& r, v) {
+        result.results.append(RFResult(r.x + settings.xOffset, r.y, r.l, r.c));
+    }
+}
+
+/************************************************************************/
+/* RFTaskDistributor */
+/************************************************************************/
+QList<RFLocalTaskSettings*> RFTaskDistributor::scatterParts(const RFLocalTaskSettings* settings, int partCount) const {
+    const int overlap = settings->minLen;
+    const int seqXLen = settings->seqX.length();
+    int parts = qBound(1, seqXLen / (MIN_PART_TO_OVERLAP_RATIO * overlap), qMax(1, partCount));
+    int partLen = (seqXLen + overlap * (parts - 1) + parts - 1) / parts;
+
+    QList<RFLocalTaskSettings*> res;
+    for (int i = 0; i < parts; i++) {
+        int start = i * (partLen - overlap);
+        int end = (i == parts - 1) ? seqXLen : qMin(seqXLen, start + partLen);
+
+        RFLocalTaskSettings* part = new RFLocalTaskSettings(*settings);
+        part->seqX = settings->seqX.mid(start, end - start);
+        part->xOffset = settings->xOffset + start;
+        res << part;
+    }
+    return res;
+}
+
+RFLocalTaskResult* RFTaskDistributor::gatherParts(const QList<const RFLocalTaskResult*>& results) const {
+    RFLocalTaskResult* gathered = new RFLocalTaskResult();
+    QVector<RFResult> pieces;
+    foreach (const RFLocalTaskResult* part, results) {
+        gathered->reportReflected = part->reportReflected;
+        gathered->selfSearch = part->selfSearch;
+        gathered->seqYLen = part->seqYLen;
+        foreach (const RFResult& r, part->results) {
+            // a sequence part compared to the whole sequence finds every repeat twice and the sequence itself
+            if (!part->selfSearch || r.x < r.y) {
+                pieces.append(r);
+            }
+        }
+    }
+    gathered->results = joinPieces(pieces);
+
+    // report the results as RFAlgorithmBase does for the reflective search
+    if (gathered->selfSearch && gathered->reportReflected) {
+        int size = gathered->results.size();
+        gathered->results.reserve(2 * size + 1);
+        gathered->results.append(RFResult(0, 0, gathered->seqYLen));
+        for (int i = 0; i < size; i++) {
+            RFResult r = gathered->results.at(i);
+            gathered->results.append(RFResult(r.y, r.x, r.l, r.c));
+        }
+    }
+    return gathered;
+}
+
+/************************************************************************/
+/* RFLocalTaskFactory */
+/************************************************************************/
+const QString RFLocalTaskFactory::ID("Repeat finder");
+
+RFLocalTaskFactory::RFLocalTaskFactory()
+: LocalTaskFactoryTemplate<RFLocalTask, RFLocalTaskSettings, RFLocalTaskResult, RFTaskDistributor>(ID)
+{
+}
+
+} //namespace
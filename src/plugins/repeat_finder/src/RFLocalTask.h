@@ -0,0 +1,105 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_RF_LOCAL_TASK_H_
+#define _U2_RF_LOCAL_TASK_H_
+
+#include <QtCore/QMutex>
+
+#include <U2Algorithm/RepeatFinderSettings.h>
+
+#include <U2Remote/LocalTask.h>
+#include <U2Remote/TaskDistributor.h>
+
+namespace U2 {
+
+class RFAlgorithmBase;
+
+/* Search of the repeats between a part of the first sequence and the whole second sequence */
+class RFLocalTaskSettings : public LocalTaskSettings {
+public:
+    RFLocalTaskSettings();
+
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant& data);
+
+    QByteArray  seqX;
+    QByteArray  seqY;
+    QString     alphabetId;
+    int         minLen;
+    int         mismatches;
+    RFAlgorithm algo;
+    bool        reportReflected;
+    // the second sequence is the first one, only the half of the results above the main diagonal is kept
+    bool        selfSearch;
+    // position of seqX in the original first sequence
+    int         xOffset;
+};
+
+/* Raw results of RFAlgorithmBase in the coordinates of the original sequences */
+class RFLocalTaskResult : public LocalTaskResult {
+public:
+    RFLocalTaskResult();
+
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant& data);
+
+    QVector<RFResult>   results;
+    bool                reportReflected;
+    bool                selfSearch;
+    int                 seqYLen;
+};
+
+class RFLocalTask : public LocalTask, public RFResultsListener {
+    Q_OBJECT
+public:
+    RFLocalTask(const RFLocalTaskSettings& settings);
+
+    void prepare();
+    const LocalTaskResult* getResult() const;
+
+    virtual void onResult(const RFResult& r);
+    virtual void onResults(const QVector<RFResult>& v);
+
+private:
+    RFLocalTaskSettings settings;
+    RFLocalTaskResult   result;
+    QMutex              resultsLock;
+};
+
+/* Cuts the first sequence into parts overlapping by the minimal repeat length. The repeats crossing
+   the parts' borders are found in both parts and are joined back on gathering */
+class RFTaskDistributor : public TaskDistributorTemplate<RFLocalTaskSettings, RFLocalTaskResult> {
+protected:
+    QList<RFLocalTaskSettings*> scatterParts(const RFLocalTaskSettings* settings, int partCount) const;
+    RFLocalTaskResult* gatherParts(const QList<const RFLocalTaskResult*>& results) const;
+};
+
+class RFLocalTaskFactory : public LocalTaskFactoryTemplate<RFLocalTask, RFLocalTaskSettings, RFLocalTaskResult, RFTaskDistributor> {
+public:
+    RFLocalTaskFactory();
+
+    static const QString ID;
+};
+
+} //namespace
+
+#endif
@@ -36,6 +36,8 @@
 
 #include <U2Lang/QueryDesignerRegistry.h>
 
+#include <U2Remote/LocalTask.h>
+
 #include <U2Test/GTestFrameworkComponents.h>
 #include <U2Test/XMLTestFormat.h>
 
@@ -47,6 +49,7 @@
 
 #include "FindRepeatsDialog.h"
 #include "FindTandemsDialog.h"
+#include "RFLocalTask.h"
 #include "RFTaskFactory.h"
 #include "RepeatFinderPlugin.h"
 #include "RepeatFinderTests.h"
@@ -88,6 +91,11 @@ RepeatFinderPlugin::RepeatFinderPlugin() : Plugin(tr("Repeats Finder"), tr("Sear
     RepeatFinderTaskFactoryRegistry *rfTfr = AppContext::getRepeatFinderTaskFactoryRegistry();
     Q_ASSERT(rfTfr);
     rfTfr->registerFactory(new RFTaskFactory(), "");
+
+    LocalTaskFactoryRegistry* ltfr = AppContext::getLocalTaskFactoryRegistry();
+    if (NULL != ltfr) {
+        ltfr->registerLocalTaskFactory(new RFLocalTaskFactory());
+    }
 }
 
 RepeatViewContext::RepeatViewContext(QObject* p) :
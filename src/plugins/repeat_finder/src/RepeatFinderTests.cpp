@@ -23,6 +23,7 @@
 
 #include "FindRepeatsTask.h"
 #include "RF_SArray_TandemFinder.h"
+#include "RFLocalTask.h"
 #include <U2Core/DNAAlphabet.h>
 #include <U2Core/AppContext.h>
 #include <U2Core/DNASequenceObject.h>
@@ -34,6 +35,10 @@
 #include <U2Algorithm/SArrayIndex.h>
 #include <U2Algorithm/SArrayBasedFindTask.h>
 
+#include <U2Remote/LocalTaskDistribution.h>
+
+#include <QtCore/QBuffer>
+
 namespace U2 {
 
 #define SEQ_ATTR    "seq"
@@ -98,6 +103,9 @@ void GTest_FindSingleSequenceRepeatsTask::init(XMLTestFormat *tf, const QDomElem
         if (algStr == "diagonal") {
             alg = RFAlgorithm_Diagonal;
         }
+        else if (algStr == "kmer") {
+            alg = RFAlgorithm_KMer;
+        }
         else {
             alg = RFAlgorithm_Auto;
         }
@@ -148,6 +156,7 @@ static QString getAlgName(RFAlgorithm alg) {
     switch(alg) {
         case RFAlgorithm_Diagonal: res = "diagonal"; break;
         case RFAlgorithm_Suffix: res = "suffix"; break;
+        case RFAlgorithm_KMer: res = "kmer"; break;
         default: res = "UNKNOWN"; break;
     }
     return res;
@@ -178,7 +187,7 @@ void GTest_FindSingleSequenceRepeatsTask::prepare() {
 
     QList<RFAlgorithm> algos;
     if (alg == RFAlgorithm_Auto) {
-        algos << RFAlgorithm_Diagonal << RFAlgorithm_Suffix;
+        algos << RFAlgorithm_Diagonal << RFAlgorithm_Suffix << RFAlgorithm_KMer;
     }
     else {
         algos << alg;
@@ -670,6 +679,67 @@ void GTest_SArrayBasedFindTask::run()
 
 
 
+//---------------------------------------------------------------------------------------------------------
+
+void GTest_RFLocalTaskSerialization::init(XMLTestFormat*, const QDomElement&) {
+}
+
+static QVariant sendThroughChannel(const QVariant& message, U2OpStatus& os) {
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    CHECK_EXT(LocalTaskChannel::writeMessage(&device, message), os.setError("Can't write a message"), QVariant());
+    QByteArray buffer = device.data();
+    QVariant received;
+    CHECK_EXT(LocalTaskChannel::takeMessage(buffer, received), os.setError("Can't read the written message"), QVariant());
+    CHECK_EXT(buffer.isEmpty(), os.setError("The message is not read completely"), QVariant());
+    return received;
+}
+
+void GTest_RFLocalTaskSerialization::run() {
+    RFLocalTaskSettings settings;
+    settings.seqX = "ACGTTGCAACGTAC";
+    settings.seqY = "TTGCAACGTACGTTGCAACG";
+    settings.alphabetId = BaseDNAAlphabetIds::NUCL_DNA_DEFAULT();
+    settings.minLen = 5;
+    settings.mismatches = 1;
+    settings.algo = RFAlgorithm_Suffix;
+    settings.reportReflected = true;
+    settings.selfSearch = true;
+    settings.xOffset = 1000;
+
+    RFLocalTaskSettings restoredSettings;
+    CHECK_EXT(restoredSettings.deserialize(sendThroughChannel(settings.serialize(), stateInfo)), setError("Settings are not deserialized"), );
+    CHECK_OP(stateInfo, );
+    CHECK_EXT(restoredSettings.seqX == settings.seqX && restoredSettings.seqY == settings.seqY, setError("Sequences are not restored"), );
+    CHECK_EXT(restoredSettings.alphabetId == settings.alphabetId, setError("Alphabet is not restored"), );
+    CHECK_EXT(restoredSettings.minLen == settings.minLen && restoredSettings.mismatches == settings.mismatches, setError("Repeat length or mismatches are not restored"), );
+    CHECK_EXT(restoredSettings.algo == settings.algo, setError("Algorithm is not restored"), );
+    CHECK_EXT(restoredSettings.reportReflected == settings.reportReflected && restoredSettings.selfSearch == settings.selfSearch, setError("Flags are not restored"), );
+    CHECK_EXT(restoredSettings.xOffset == settings.xOffset, setError("Offset is not restored"), );
+
+    RFLocalTaskResult result;
+    result.results << RFResult(0, 5, 10, 9) << RFResult(1000000, 7, 42, 40) << RFResult(3, 3, 1, 1);
+    result.reportReflected = true;
+    result.selfSearch = false;
+    result.seqYLen = 20;
+
+    RFLocalTaskResult restoredResult;
+    CHECK_EXT(restoredResult.deserialize(sendThroughChannel(result.serialize(), stateInfo)), setError("Result is not deserialized"), );
+    CHECK_OP(stateInfo, );
+    CHECK_EXT(restoredResult.results.size() == result.results.size(), setError(QString("Results count: expected %1, actual %2").arg(result.results.size()).arg(restoredResult.results.size())), );
+    for (int i = 0; i < result.results.size(); i++) {
+        const RFResult& expected = result.results[i];
+        const RFResult& actual = restoredResult.results[i];
+        CHECK_EXT(expected.x == actual.x && expected.y == actual.y && expected.l == actual.l && expected.c == actual.c,
+            setError(QString("Result %1 is not restored").arg(i)), );
+    }
+    CHECK_EXT(restoredResult.reportReflected == result.reportReflected && restoredResult.selfSearch == result.selfSearch, setError("Result flags are not restored"), );
+    CHECK_EXT(restoredResult.seqYLen == result.seqYLen, setError("Sequence length is not restored"), );
+
+    RFLocalTaskSettings emptySettings;
+    CHECK_EXT(!emptySettings.deserialize(QVariant(42)), setError("Invalid data is deserialized"), );
+}
+
 //---------------------------------------------------------------------------------------------------------
 //---------------------------------------------------------------------------------------------------------
 
@@ -679,6 +749,7 @@ QList<XMLTestFactory*> RepeatFinderTests::createTestFactories() {
     res.append(GTest_FindTandemRepeatsTask::createFactory());
     res.append(GTest_FindRealTandemRepeatsTask::createFactory());
     res.append( GTest_SArrayBasedFindTask::createFactory() );
+    res.append(GTest_RFLocalTaskSerialization::createFactory());
     return res;
 }
 
@@ -144,6 +144,15 @@ public:
     QList<int>              expectedResults;
 };
 
+/* Serializes the settings and the results of RFLocalTask, sends them through the local task channel and compares the restored copies */
+class GTest_RFLocalTaskSerialization : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY_EXT(GTest_RFLocalTaskSerialization, "rf-local-task-serialization", TaskFlags_FOSCOE);
+
+    void run();
+};
+
 class RepeatFinderTests {
 public:
     static QList<XMLTestFactory*> createTestFactories();
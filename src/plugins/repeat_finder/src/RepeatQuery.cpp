@@ -55,6 +55,7 @@ QDRepeatActor::QDRepeatActor(QDActorPrototype const* proto) : QDActor(proto) {
 static const QString ALGO_SUFFIX = "suffix";
 static const QString ALGO_DIAG = "diagonals";
 static const QString ALGO_AUTO = "auto";
+static const QString ALGO_KMER = "kmer";
 
 static const QString FA_DISJOINT = "Disjoint repeats";
 static const QString FA_NOFILTERING = "NoFiltering";
@@ -82,6 +83,9 @@ QList< QPair<QString,QString> > QDRepeatActor::saveConfiguration() const
             case RFAlgorithm_Suffix:
                 attr.second = ALGO_SUFFIX;
                 break;
+            case RFAlgorithm_KMer:
+                attr.second = ALGO_KMER;
+                break;
             default:
                 break;
             }
@@ -144,6 +148,10 @@ void QDRepeatActor::loadConfiguration(const QList< QPair<QString,QString> >& str
             {
                 alg = 2;
             }
+            else if (strandVal==ALGO_KMER)
+            {
+                alg = 3;
+            }
             cfg->setParameter(ALGO_ATTR, qVariantFromValue(alg));
         }
         else if (attr.first==NESTED_ATTR)
@@ -329,6 +337,7 @@ QDRepeatActorPrototype::QDRepeatActorPrototype() {
         m["Auto"] = RFAlgorithm_Auto;
         m["Diagonals"] = RFAlgorithm_Diagonal;
         m["Suffix index"] = RFAlgorithm_Suffix;
+        m["K-mer index"] = RFAlgorithm_KMer;
         delegates[ALGO_ATTR] = new ComboBoxDelegate(m);
     }
     {
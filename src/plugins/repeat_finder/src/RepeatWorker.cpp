@@ -43,6 +43,8 @@
 #include <U2Core/FailTask.h>
 #include <U2Core/U2OpStatusUtils.h>
 
+#include <U2Remote/LocalTaskDistribution.h>
+
 //#include <QtGui/QApplication>
 
 /* TRANSLATOR U2::LocalWorkflow::RepeatWorker */
@@ -62,6 +64,7 @@ static const QString INVERT_ATTR("inverted");
 static const QString NESTED_ATTR("filter-algorithm");
 static const QString ALGO_ATTR("algorithm");
 static const QString THREADS_ATTR("threads");
+static const QString PROCESSES_ATTR("processes");
 static const QString TANMEDS_ATTR("exclude-tandems");
 static const QString USE_MAX_DISTANCE_ATTR("use-maxdistance");
 static const QString USE_MIN_DISTANCE_ATTR("use-mindistance");
@@ -93,6 +96,7 @@ void RepeatWorkerFactory::init() {
         Descriptor nsd(NESTED_ATTR, RepeatWorker::tr("Filter algorithm"), RepeatWorker::tr("Filter repeats algorithm."));
         Descriptor ald(ALGO_ATTR, RepeatWorker::tr("Algorithm"), RepeatWorker::tr("Control over variations of algorithm."));
         Descriptor thd(THREADS_ATTR, RepeatWorker::tr("Parallel threads"), RepeatWorker::tr("Number of parallel threads used for the task."));
+        Descriptor prd(PROCESSES_ATTR, RepeatWorker::tr("Parallel processes"), RepeatWorker::tr("Number of UGENE processes the search is distributed to. 1 means that the search runs in this process only."));
         Descriptor tan(TANMEDS_ATTR, RepeatWorker::tr("Exclude tandems"), RepeatWorker::tr("Exclude tandems areas before find repeat task is run."));
         Descriptor umaxd(USE_MAX_DISTANCE_ATTR, RepeatWorker::tr("Apply 'Max distance' attribute"), RepeatWorker::tr("Apply 'Max distance' attribute."));
         Descriptor umind(USE_MIN_DISTANCE_ATTR, RepeatWorker::tr("Apply 'Min distance' attribute"), RepeatWorker::tr("Apply 'Max distance' attribute."));
@@ -128,6 +132,9 @@ void RepeatWorkerFactory::init() {
         aa = new Attribute(thd, BaseTypes::NUM_TYPE(), false);
         aa->setAttributeValue(cfg.nThreads);
         a << aa;
+        aa = new Attribute(prd, BaseTypes::NUM_TYPE(), false);
+        aa->setAttributeValue(cfg.nProcesses);
+        a << aa;
         aa = new Attribute(tan, BaseTypes::BOOL_TYPE(), false);
         aa->setAttributeValue(cfg.excludeTandems);
         a << aa;
@@ -156,11 +163,16 @@ void RepeatWorkerFactory::init() {
         QVariantMap m; m["specialValueText"] = "Auto";
         delegates[THREADS_ATTR] = new SpinBoxDelegate(m);
     }
+    {
+        QVariantMap m; m["minimum"] = 1; m["maximum"] = LocalTaskDistributionTask::getDefaultProcessCount();
+        delegates[PROCESSES_ATTR] = new SpinBoxDelegate(m);
+    }
     {
         QVariantMap m;
         m["Auto"] = RFAlgorithm_Auto;
         m["Diagonals"] = RFAlgorithm_Diagonal;
         m["Suffix index"] = RFAlgorithm_Suffix;
+        m["K-mer index"] = RFAlgorithm_KMer;
         delegates[ALGO_ATTR] = new ComboBoxDelegate(m);
     }
     {
@@ -238,6 +250,7 @@ Task* RepeatWorker::tick() {
         int identity = actor->getParameter(IDENTITY_ATTR)->getAttributeValue<int>(context);
         cfg.setIdentity(identity);
         cfg.nThreads = actor->getParameter(THREADS_ATTR)->getAttributeValue<int>(context);
+        cfg.nProcesses = qMax(1, actor->getParameter(PROCESSES_ATTR)->getAttributeValue<int>(context));
         cfg.inverted = actor->getParameter(INVERT_ATTR)->getAttributeValue<bool>(context);
         cfg.filter = RepeatsFilterAlgorithm(actor->getParameter(NESTED_ATTR)->getAttributeValue<int>(context));
         cfg.excludeTandems = actor->getParameter(TANMEDS_ATTR)->getAttributeValue<bool>(context);
@@ -2,10 +2,13 @@ include (smith_waterman.pri)
 
 # Input
 HEADERS += src/PairAlignSequences.h \
+           src/GlobalAlignmentAlgorithm.h \
+           src/GlobalAlignmentAlgorithmSSE2.h \
            src/SmithWatermanAlgorithm.h \
            src/SmithWatermanAlgorithmSSE2.h \
            src/SWAlgorithmPlugin.h \
            src/SWAlgorithmTask.h \
+           src/SWBulkSearchTask.h \
            src/SmithWatermanAlgorithmCUDA.h \
            src/SmithWatermanAlgorithmOPENCL.h \
            src/sw_cuda_cpp.h \
@@ -13,13 +16,19 @@ HEADERS += src/PairAlignSequences.h \
            src/SmithWatermanTests.h \
            src/SWWorker.h \
            src/SWQuery.h \
-    src/PairwiseAlignmentSmithWatermanGUIExtension.h
+           src/SWLocalTask.h \
+    src/PairwiseAlignmentSmithWatermanGUIExtension.h \
+    src/PairwiseAlignmentNeedlemanWunschGUIExtension.h \
+    src/PairwiseAlignmentNeedlemanWunschTask.h
 
 SOURCES += src/PairAlignSequences.cpp \
+           src/GlobalAlignmentAlgorithm.cpp \
+           src/GlobalAlignmentAlgorithmSSE2.cpp \
            src/SmithWatermanAlgorithm.cpp \
            src/SmithWatermanAlgorithmSSE2.cpp \
            src/SWAlgorithmPlugin.cpp \
            src/SWAlgorithmTask.cpp \
+           src/SWBulkSearchTask.cpp \
            src/SmithWatermanAlgorithmCUDA.cpp \
            src/SmithWatermanAlgorithmOPENCL.cpp \
            src/sw_cuda_cpp.cpp \
@@ -27,7 +36,10 @@ SOURCES += src/PairAlignSequences.cpp \
            src/SmithWatermanTests.cpp \
            src/SWWorker.cpp \
            src/SWQuery.cpp \
-    src/PairwiseAlignmentSmithWatermanGUIExtension.cpp
+           src/SWLocalTask.cpp \
+    src/PairwiseAlignmentSmithWatermanGUIExtension.cpp \
+    src/PairwiseAlignmentNeedlemanWunschGUIExtension.cpp \
+    src/PairwiseAlignmentNeedlemanWunschTask.cpp
 
 RESOURCES += smith_waterman.qrc
 
@@ -0,0 +1,367 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "GlobalAlignmentAlgorithm.h"
+
+#include <U2Core/U2SafePoints.h>
+
+#include <limits.h>
+
+namespace U2 {
+
+const char GlobalAlignmentAlgorithm::UP = 'u';
+const char GlobalAlignmentAlgorithm::LEFT = 'l';
+const char GlobalAlignmentAlgorithm::DIAG = 'd';
+
+const int GlobalAlignmentAlgorithm::MINUS_INF = INT_MIN / 4;
+const qint64 GlobalAlignmentAlgorithm::FULL_MATRIX_SIZE = 4096;
+
+GlobalAlignmentAlgorithm::GlobalAlignmentAlgorithm()
+    : alphabetSize(0), maxSubstScore(0), gapOpen(0), gapExtd(0), score(0)
+{
+
+}
+
+void GlobalAlignmentAlgorithm::launch(const SMatrix &m, const QByteArray &seq1, const QByteArray &seq2, int _gapOpen, int _gapExtd, bool freeEndGaps) {
+    pairAlignment.clear();
+    score = 0;
+    initScores(m, _gapOpen, _gapExtd);
+
+    QByteArray a;
+    QByteArray b;
+    SAFE_POINT(encode(m, seq1, a) && encode(m, seq2, b), "The sequences contain symbols that are not in the matrix alphabet", );
+
+    pairAlignment.reserve(a.size() + b.size());
+    if (freeEndGaps) {
+        alignSemiGlobal(a, b);
+    } else {
+        alignRegion(a.constData(), a.size(), b.constData(), b.size(), gapOpen, gapOpen);
+    }
+    calculateScore(a, b, freeEndGaps);
+}
+
+int GlobalAlignmentAlgorithm::getScore() const {
+    return score;
+}
+
+const QByteArray & GlobalAlignmentAlgorithm::getPairAlignment() const {
+    return pairAlignment;
+}
+
+void GlobalAlignmentAlgorithm::initScores(const SMatrix &m, int _gapOpen, int _gapExtd) {
+    gapOpen = qMax(0, _gapOpen);
+    gapExtd = qMax(0, _gapExtd);
+
+    const QByteArray alphabetChars = m.getAlphabet()->getAlphabetChars();
+    alphabetSize = alphabetChars.size();
+    substScores.resize(alphabetSize * alphabetSize);
+    maxSubstScore = 0;
+    for (int i = 0; i < alphabetSize; i++) {
+        for (int j = 0; j < alphabetSize; j++) {
+            const int value = static_cast<int>(m.getScore(alphabetChars[i], alphabetChars[j]));
+            substScores[i * alphabetSize + j] = value;
+            maxSubstScore = qMax(maxSubstScore, value);
+        }
+    }
+}
+
+bool GlobalAlignmentAlgorithm::encode(const SMatrix &m, const QByteArray &seq, QByteArray &result) const {
+    const QByteArray alphabetChars = m.getAlphabet()->getAlphabetChars();
+    QVector<int> indexes(256, -1);
+    for (int i = 0; i < alphabetChars.size(); i++) {
+        indexes[static_cast<uchar>(alphabetChars[i])] = i;
+    }
+
+    result.resize(seq.size());
+    for (int i = 0; i < seq.size(); i++) {
+        const int index = indexes[static_cast<uchar>(seq[i])];
+        CHECK(-1 != index, false);
+        result[i] = static_cast<char>(index);
+    }
+    return true;
+}
+
+void GlobalAlignmentAlgorithm::alignSemiGlobal(const QByteArray &a, const QByteArray &b) {
+    const int aLen = a.size();
+    const int bLen = b.size();
+    if (0 == aLen || 0 == bLen) {
+        pairAlignment.append(QByteArray(aLen, UP));
+        pairAlignment.append(QByteArray(bLen, LEFT));
+        return;
+    }
+
+    // the end of the alignment is the best cell of the last row or the last column
+    QVector<int> h(bLen + 1);
+    QVector<int> f(bLen + 1);
+    QVector<int> lastColumn(aLen + 1);
+    calculateLastRow(a.constData(), aLen, b.constData(), bLen, gapOpen, true, h.data(), f.data(), lastColumn.data());
+
+    int endA = aLen;
+    int endB = bLen;
+    int best = h[bLen];
+    for (int j = 0; j < bLen; j++) {
+        if (h[j] > best) {
+            best = h[j];
+            endB = j;
+        }
+    }
+    for (int i = 0; i < aLen; i++) {
+        if (lastColumn[i] > best) {
+            best = lastColumn[i];
+            endA = i;
+            endB = bLen;
+        }
+    }
+
+    // the start is found by the same pass from the end backwards
+    const QByteArray aReversed = reversed(a.constData(), endA);
+    const QByteArray bReversed = reversed(b.constData(), endB);
+    h.resize(endB + 1);
+    f.resize(endB + 1);
+    lastColumn.resize(endA + 1);
+    calculateLastRow(aReversed.constData(), endA, bReversed.constData(), endB, gapOpen, false, h.data(), f.data(), lastColumn.data());
+
+    int startA = 0;
+    int startB = 0;
+    best = h[endB];
+    for (int j = 0; j < endB; j++) {
+        if (h[j] > best) {
+            best = h[j];
+            startB = endB - j;
+        }
+    }
+    for (int i = 0; i < endA; i++) {
+        if (lastColumn[i] > best) {
+            best = lastColumn[i];
+            startA = endA - i;
+            startB = 0;
+        }
+    }
+
+    pairAlignment.append(QByteArray(startA, UP));
+    pairAlignment.append(QByteArray(startB, LEFT));
+    alignRegion(a.constData() + startA, endA - startA, b.constData() + startB, endB - startB, gapOpen, gapOpen);
+    pairAlignment.append(QByteArray(aLen - endA, UP));
+    pairAlignment.append(QByteArray(bLen - endB, LEFT));
+}
+
+void GlobalAlignmentAlgorithm::alignRegion(const char *a, int aLen, const char *b, int bLen, int topGapOpen, int bottomGapOpen) {
+    if (aLen <= 1 || 0 == bLen || static_cast<qint64>(aLen) * bLen <= FULL_MATRIX_SIZE) {
+        alignRegionInFullMatrix(a, aLen, b, bLen, topGapOpen, bottomGapOpen);
+        return;
+    }
+
+    // the middle row is crossed either in a cell or inside a gap in b
+    const int middle = aLen / 2;
+    int bestJ = 0;
+    bool gapCrossesMiddle = false;
+    {
+        QVector<int> hForward(bLen + 1);
+        QVector<int> fForward(bLen + 1);
+        calculateLastRow(a, middle, b, bLen, topGapOpen, false, hForward.data(), fForward.data(), NULL);
+
+        const QByteArray aReversed = reversed(a + middle, aLen - middle);
+        const QByteArray bReversed = reversed(b, bLen);
+        QVector<int> hReverse(bLen + 1);
+        QVector<int> fReverse(bLen + 1);
+        calculateLastRow(aReversed.constData(), aLen - middle, bReversed.constData(), bLen, bottomGapOpen, false, hReverse.data(), fReverse.data(), NULL);
+
+        int best = INT_MIN;
+        for (int j = 0; j <= bLen; j++) {
+            const int throughCell = hForward[j] + hReverse[bLen - j];
+            if (throughCell > best) {
+                best = throughCell;
+                bestJ = j;
+                gapCrossesMiddle = false;
+            }
+            // both halves have paid for the opening of the same gap
+            const int throughGap = fForward[j] + fReverse[bLen - j] + gapOpen;
+            if (throughGap > best) {
+                best = throughGap;
+                bestJ = j;
+                gapCrossesMiddle = true;
+            }
+        }
+    }
+
+    if (gapCrossesMiddle) {
+        alignRegion(a, middle - 1, b, bestJ, topGapOpen, 0);
+        pairAlignment.append(UP);
+        pairAlignment.append(UP);
+        alignRegion(a + middle + 1, aLen - middle - 1, b + bestJ, bLen - bestJ, 0, bottomGapOpen);
+    } else {
+        alignRegion(a, middle, b, bestJ, topGapOpen, gapOpen);
+        alignRegion(a + middle, aLen - middle, b + bestJ, bLen - bestJ, gapOpen, bottomGapOpen);
+    }
+}
+
+void GlobalAlignmentAlgorithm::alignRegionInFullMatrix(const char *a, int aLen, const char *b, int bLen, int topGapOpen, int bottomGapOpen) {
+    if (0 == aLen || 0 == bLen) {
+        pairAlignment.append(QByteArray(aLen, UP));
+        pairAlignment.append(QByteArray(bLen, LEFT));
+        return;
+    }
+
+    const int gapOpenExtd = gapOpen + gapExtd;
+    const int w = bLen + 1;
+    QVector<int> h((aLen + 1) * w);
+    QVector<int> e((aLen + 1) * w);
+    QVector<int> f((aLen + 1) * w);
+
+    h[0] = 0;
+    e[0] = MINUS_INF;
+    f[0] = MINUS_INF;
+    for (int j = 1; j <= bLen; j++) {
+        h[j] = e[j] = -(gapOpen + j * gapExtd);
+        f[j] = MINUS_INF;
+    }
+    for (int i = 1; i <= aLen; i++) {
+        h[i * w] = f[i * w] = -(topGapOpen + i * gapExtd);
+        e[i * w] = MINUS_INF;
+    }
+
+    for (int i = 1; i <= aLen; i++) {
+        for (int j = 1; j <= bLen; j++) {
+            const int idx = i * w + j;
+            e[idx] = qMax(h[idx - 1] - gapOpenExtd, e[idx - 1] - gapExtd);
+            f[idx] = qMax(h[idx - w] - gapOpenExtd, f[idx - w] - gapExtd);
+            h[idx] = qMax(h[idx - w - 1] + getSubstScore(a[i - 1], b[j - 1]), qMax(e[idx], f[idx]));
+        }
+    }
+
+    // a trailing gap in b is opened with the bottom penalty: it may continue the gap of the next part
+    enum {STATE_H, STATE_E, STATE_F} state = STATE_H;
+    const int last = aLen * w + bLen;
+    if (f[last] + gapOpen - bottomGapOpen > h[last]) {
+        state = STATE_F;
+    }
+
+    QByteArray path;
+    path.reserve(aLen + bLen);
+    int i = aLen;
+    int j = bLen;
+    while (i > 0 && j > 0) {
+        const int idx = i * w + j;
+        if (STATE_H == state) {
+            if (h[idx] == h[idx - w - 1] + getSubstScore(a[i - 1], b[j - 1])) {
+                path.append(DIAG);
+                i--;
+                j--;
+                continue;
+            }
+            state = (h[idx] == e[idx]) ? STATE_E : STATE_F;
+        }
+        if (STATE_E == state) {
+            path.append(LEFT);
+            state = (e[idx] == h[idx - 1] - gapOpenExtd) ? STATE_H : STATE_E;
+            j--;
+        } else {
+            path.append(UP);
+            state = (f[idx] == h[idx - w] - gapOpenExtd) ? STATE_H : STATE_F;
+            i--;
+        }
+    }
+    path.append(QByteArray(i, UP));
+    path.append(QByteArray(j, LEFT));
+
+    for (int k = path.size() - 1; k >= 0; k--) {
+        pairAlignment.append(path[k]);
+    }
+}
+
+void GlobalAlignmentAlgorithm::calculateLastRow(const char *a, int aLen, const char *b, int bLen, int topGapOpen, bool freeStart,
+                                                int *h, int *f, int *lastColumn) {
+    const int gapOpenExtd = gapOpen + gapExtd;
+    h[0] = 0;
+    f[0] = MINUS_INF;
+    for (int j = 1; j <= bLen; j++) {
+        h[j] = freeStart ? 0 : -(gapOpen + j * gapExtd);
+        f[j] = MINUS_INF;
+    }
+    if (NULL != lastColumn) {
+        lastColumn[0] = h[bLen];
+    }
+
+    for (int i = 1; i <= aLen; i++) {
+        const int *substRow = substScores.constData() + a[i - 1] * alphabetSize;
+        int diag = h[0];
+        h[0] = f[0] = freeStart ? 0 : -(topGapOpen + i * gapExtd);
+        int e = MINUS_INF;
+        for (int j = 1; j <= bLen; j++) {
+            f[j] = qMax(h[j] - gapOpenExtd, f[j] - gapExtd);
+            e = qMax(h[j - 1] - gapOpenExtd, e - gapExtd);
+            const int best = qMax(diag + substRow[static_cast<int>(b[j - 1])], qMax(e, f[j]));
+            diag = h[j];
+            h[j] = best;
+        }
+        if (NULL != lastColumn) {
+            lastColumn[i] = h[bLen];
+        }
+    }
+}
+
+void GlobalAlignmentAlgorithm::calculateScore(const QByteArray &a, const QByteArray &b, bool freeEndGaps) {
+    const int length = pairAlignment.size();
+    int first = 0;
+    int last = length;
+    if (freeEndGaps && length > 0) {
+        // only the first and the last gaps are free
+        const char firstOp = pairAlignment[0];
+        while (first < last && DIAG != firstOp && pairAlignment[first] == firstOp) {
+            first++;
+        }
+        const char lastOp = pairAlignment[length - 1];
+        while (last > first && DIAG != lastOp && pairAlignment[last - 1] == lastOp) {
+            last--;
+        }
+    }
+
+    int i = 0;
+    int j = 0;
+    for (int k = 0; k < first; k++) {
+        (UP == pairAlignment[k]) ? i++ : j++;
+    }
+
+    score = 0;
+    char previousOp = DIAG;
+    for (int k = first; k < last; k++) {
+        const char op = pairAlignment[k];
+        if (DIAG == op) {
+            score += getSubstScore(a[i], b[j]);
+            i++;
+            j++;
+        } else {
+            score -= (op == previousOp) ? gapExtd : gapOpen + gapExtd;
+            (UP == op) ? i++ : j++;
+        }
+        previousOp = op;
+    }
+}
+
+QByteArray GlobalAlignmentAlgorithm::reversed(const char *data, int length) {
+    QByteArray result(length, 0);
+    for (int i = 0; i < length; i++) {
+        result[i] = data[length - 1 - i];
+    }
+    return result;
+}
+
+} // namespace
@@ -0,0 +1,109 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_GLOBAL_ALIGNMENT_ALGORITHM_H_
+#define _U2_GLOBAL_ALIGNMENT_ALGORITHM_H_
+
+#include <U2Core/SMatrix.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+namespace U2 {
+
+/**
+ * Needleman-Wunsch alignment with affine gaps (Gotoh) in linear memory.
+ * The path is restored with the divide and conquer approach of Myers and Miller:
+ * the score passes keep only one row of the matrix, the full matrix is calculated
+ * for small parts only. Realizations override the score pass.
+ */
+class GlobalAlignmentAlgorithm {
+public:
+    GlobalAlignmentAlgorithm();
+    virtual ~GlobalAlignmentAlgorithm() {}
+
+    /**
+     * Aligns @seq1 and @seq2 from end to end. A gap of length k costs @gapOpen + k * @gapExtd, the penalties are not negative.
+     * If @freeEndGaps is set, leading and trailing gaps are not penalized (semi-global alignment).
+     * Both sequences must consist of the matrix alphabet symbols.
+     */
+    void launch(const SMatrix &m, const QByteArray &seq1, const QByteArray &seq2, int gapOpen, int gapExtd, bool freeEndGaps);
+
+    int getScore() const;
+
+    /**
+     * The alignment path from the start: DIAG - both symbols are aligned,
+     * UP - the symbol of seq1 is aligned to a gap, LEFT - the symbol of seq2 is aligned to a gap.
+     */
+    const QByteArray & getPairAlignment() const;
+
+    static const char UP;
+    static const char LEFT;
+    static const char DIAG;
+
+protected:
+    /**
+     * The score pass of the alignment of @a against all prefixes of @b.
+     * Fills @h and @f (@bLen + 1 values) with the scores of the last row: the best ones and the ones ending with a gap in @b.
+     * @lastColumn (@aLen + 1 values, may be NULL) gets the best scores of the last column.
+     * @topGapOpen is the open penalty of a gap in @b that starts in the top left corner.
+     * If @freeStart is set, leading gaps are not penalized.
+     */
+    virtual void calculateLastRow(const char *a, int aLen, const char *b, int bLen, int topGapOpen, bool freeStart,
+                                  int *h, int *f, int *lastColumn);
+
+    /* Sets the substitution scores of the matrix alphabet symbols and the gap penalties */
+    void initScores(const SMatrix &m, int gapOpen, int gapExtd);
+
+    /* @a and @b are encoded: a symbol is its index in the alphabet */
+    int getSubstScore(char a, char b) const;
+
+    int alphabetSize;
+    QVector<int> substScores;
+    int maxSubstScore;
+    int gapOpen;
+    int gapExtd;
+
+    static const int MINUS_INF;
+
+private:
+    void alignRegion(const char *a, int aLen, const char *b, int bLen, int topGapOpen, int bottomGapOpen);
+    void alignRegionInFullMatrix(const char *a, int aLen, const char *b, int bLen, int topGapOpen, int bottomGapOpen);
+    void alignSemiGlobal(const QByteArray &a, const QByteArray &b);
+    bool encode(const SMatrix &m, const QByteArray &seq, QByteArray &result) const;
+    void calculateScore(const QByteArray &a, const QByteArray &b, bool freeEndGaps);
+
+    static QByteArray reversed(const char *data, int length);
+
+    QByteArray pairAlignment;
+    int score;
+
+    /* the parts with less cells are aligned in the full matrix */
+    static const qint64 FULL_MATRIX_SIZE;
+};
+
+inline int GlobalAlignmentAlgorithm::getSubstScore(char a, char b) const {
+    return substScores[a * alphabetSize + b];
+}
+
+} // namespace
+
+#endif // _U2_GLOBAL_ALIGNMENT_ALGORITHM_H_
@@ -0,0 +1,160 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifdef SW2_BUILD_WITH_SSE2
+
+#include "GlobalAlignmentAlgorithmSSE2.h"
+
+#include <emmintrin.h>
+
+namespace U2 {
+
+static qint16 saturateShort(int value) {
+    return static_cast<qint16>(qBound(-32768, value, 32767));
+}
+
+bool GlobalAlignmentAlgorithmSSE2::fitsShort(int aLen, int bLen, int topGapOpen) const {
+    // the best path is not worse than the path of gaps only and not better than the path of matches only
+    const qint64 minScore = -(3 * static_cast<qint64>(gapOpen) + topGapOpen + (static_cast<qint64>(aLen) + bLen + 2) * gapExtd);
+    const qint64 maxScore = static_cast<qint64>(qMin(aLen, bLen)) * maxSubstScore;
+    return minScore > -MAX_SHORT_SCORE && maxScore < MAX_SHORT_SCORE;
+}
+
+void GlobalAlignmentAlgorithmSSE2::calculateLastRow(const char *a, int aLen, const char *b, int bLen, int topGapOpen, bool freeStart,
+                                                    int *h, int *f, int *lastColumn) {
+    if (0 == aLen || bLen < MIN_VECTORIZED_LENGTH || !fitsShort(aLen, bLen, topGapOpen)) {
+        GlobalAlignmentAlgorithm::calculateLastRow(a, aLen, b, bLen, topGapOpen, freeStart, h, f, lastColumn);
+        return;
+    }
+
+    // the element j of the row is in the lane j / segLen of the vector j % segLen
+    const int segLen = (bLen + nElementsInVec - 1) / nElementsInVec;
+    __m128i *buffer = static_cast<__m128i *>(_mm_malloc((alphabetSize + 4) * segLen * sizeof(__m128i), 16));
+    __m128i *profile = buffer;
+    __m128i *pvHLoad = buffer + alphabetSize * segLen;
+    __m128i *pvHStore = pvHLoad + segLen;
+    __m128i *pvE = pvHStore + segLen;
+    __m128i *pvLastE = pvE + segLen;
+
+    for (int c = 0; c < alphabetSize; c++) {
+        const int *substRow = substScores.constData() + c * alphabetSize;
+        qint16 *p = reinterpret_cast<qint16 *>(profile + c * segLen);
+        for (int s = 0; s < segLen; s++) {
+            for (int l = 0; l < nElementsInVec; l++) {
+                const int j = l * segLen + s;
+                *p++ = (j < bLen) ? static_cast<qint16>(substRow[static_cast<int>(b[j])]) : 0;
+            }
+        }
+    }
+
+    // the row 0: the element j holds H(0, j + 1), E holds the vertical gap scores of the next row.
+    // The padding elements (j >= bLen) are out of the fitsShort() bound, they are saturated
+    const qint16 shortMinusInf = -32768;
+    for (int s = 0; s < segLen; s++) {
+        qint16 *hValues = reinterpret_cast<qint16 *>(pvHLoad + s);
+        qint16 *eValues = reinterpret_cast<qint16 *>(pvE + s);
+        for (int l = 0; l < nElementsInVec; l++) {
+            const int j = l * segLen + s;
+            const int hValue = freeStart ? 0 : -(gapOpen + (j + 1) * gapExtd);
+            hValues[l] = saturateShort(hValue);
+            eValues[l] = saturateShort(hValue - gapOpen - gapExtd);
+        }
+    }
+    if (NULL != lastColumn) {
+        lastColumn[0] = freeStart ? 0 : -(gapOpen + bLen * gapExtd);
+    }
+
+    const __m128i vGapOpenExtd = _mm_set1_epi16(static_cast<qint16>(gapOpen + gapExtd));
+    const __m128i vGapExtd = _mm_set1_epi16(static_cast<qint16>(gapExtd));
+    const __m128i vMinusInf = _mm_set1_epi16(shortMinusInf);
+    const int lastLane = (bLen - 1) / segLen;
+    const int lastSeg = (bLen - 1) % segLen;
+
+    int previousColumnH = 0;
+    for (int i = 1; i <= aLen; i++) {
+        const int columnH = freeStart ? 0 : -(topGapOpen + i * gapExtd);
+        if (aLen == i) {
+            for (int s = 0; s < segLen; s++) {
+                pvLastE[s] = pvE[s];
+            }
+        }
+
+        const __m128i *vProfile = profile + a[i - 1] * segLen;
+        __m128i vF = _mm_insert_epi16(vMinusInf, columnH - gapOpen - gapExtd, 0);
+        __m128i vH = _mm_slli_si128(pvHLoad[segLen - 1], 2);
+        vH = _mm_insert_epi16(vH, previousColumnH, 0);
+
+        for (int s = 0; s < segLen; s++) {
+            vH = _mm_adds_epi16(vH, vProfile[s]);
+            __m128i vE = pvE[s];
+            vH = _mm_max_epi16(vH, vE);
+            vH = _mm_max_epi16(vH, vF);
+            pvHStore[s] = vH;
+
+            const __m128i vOpen = _mm_subs_epi16(vH, vGapOpenExtd);
+            pvE[s] = _mm_max_epi16(_mm_subs_epi16(vE, vGapExtd), vOpen);
+            vF = _mm_max_epi16(_mm_subs_epi16(vF, vGapExtd), vOpen);
+            vH = pvHLoad[s];
+        }
+
+        // the lazy loop: the horizontal gaps are carried to the next lanes while they can change the scores
+        vF = _mm_insert_epi16(_mm_slli_si128(vF, 2), shortMinusInf, 0);
+        int s = 0;
+        vH = pvHStore[0];
+        while (0 != _mm_movemask_epi8(_mm_cmpgt_epi16(vF, _mm_subs_epi16(vH, vGapOpenExtd)))) {
+            vH = _mm_max_epi16(vH, vF);
+            pvHStore[s] = vH;
+            pvE[s] = _mm_max_epi16(pvE[s], _mm_subs_epi16(vH, vGapOpenExtd));
+            vF = _mm_subs_epi16(vF, vGapExtd);
+            if (++s >= segLen) {
+                s = 0;
+                vF = _mm_insert_epi16(_mm_slli_si128(vF, 2), shortMinusInf, 0);
+            }
+            vH = pvHStore[s];
+        }
+
+        qSwap(pvHLoad, pvHStore);
+        previousColumnH = columnH;
+        if (NULL != lastColumn) {
+            lastColumn[i] = reinterpret_cast<const qint16 *>(pvHLoad + lastSeg)[lastLane];
+        }
+    }
+
+    h[0] = previousColumnH;
+    f[0] = previousColumnH;
+    for (int s = 0; s < segLen; s++) {
+        const qint16 *hValues = reinterpret_cast<const qint16 *>(pvHLoad + s);
+        const qint16 *eValues = reinterpret_cast<const qint16 *>(pvLastE + s);
+        for (int l = 0; l < nElementsInVec; l++) {
+            const int j = l * segLen + s;
+            if (j < bLen) {
+                h[j + 1] = hValues[l];
+                f[j + 1] = eValues[l];
+            }
+        }
+    }
+
+    _mm_free(buffer);
+}
+
+} // namespace
+
+#endif // SW2_BUILD_WITH_SSE2
@@ -0,0 +1,51 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifdef SW2_BUILD_WITH_SSE2
+
+#ifndef _U2_GLOBAL_ALIGNMENT_ALGORITHM_SSE2_H_
+#define _U2_GLOBAL_ALIGNMENT_ALGORITHM_SSE2_H_
+
+#include "GlobalAlignmentAlgorithm.h"
+
+namespace U2 {
+
+/**
+ * The score pass is calculated with the striped method of Farrar on 16-bit scores (8 cells at once).
+ * If the scores can overflow 16 bits, the 32-bit pass of the base class is used.
+ */
+class GlobalAlignmentAlgorithmSSE2 : public GlobalAlignmentAlgorithm {
+protected:
+    virtual void calculateLastRow(const char *a, int aLen, const char *b, int bLen, int topGapOpen, bool freeStart,
+                                  int *h, int *f, int *lastColumn);
+
+    bool fitsShort(int aLen, int bLen, int topGapOpen) const;
+
+    static const int nElementsInVec = 8;
+    /* shorter rows are not worth the striped layout */
+    static const int MIN_VECTORIZED_LENGTH = 32;
+    static const int MAX_SHORT_SCORE = 32000;
+};
+
+} // namespace
+
+#endif // _U2_GLOBAL_ALIGNMENT_ALGORITHM_SSE2_H_
+#endif // SW2_BUILD_WITH_SSE2
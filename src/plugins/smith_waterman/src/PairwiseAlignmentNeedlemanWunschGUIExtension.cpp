@@ -0,0 +1,133 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "PairwiseAlignmentNeedlemanWunschGUIExtension.h"
+#include "PairwiseAlignmentNeedlemanWunschTask.h"
+
+#include <U2Core/AppContext.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/U2AlphabetUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Algorithm/SubstMatrixRegistry.h>
+#include <U2Algorithm/AlignmentAlgorithmsRegistry.h>
+#include <U2Algorithm/PairwiseAlignmentTask.h>
+
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+
+namespace U2 {
+
+PairwiseAlignmentNeedlemanWunschMainWidget::PairwiseAlignmentNeedlemanWunschMainWidget(QWidget* parent, QVariantMap* s) :
+    AlignmentAlgorithmMainWidget(parent, s) {
+    setupUi(this);
+    freeEndGaps = new QCheckBox(tr("Free end gaps"), this);
+    freeEndGaps->setObjectName("freeEndGaps");
+    freeEndGaps->setToolTip(tr("Do not penalize the gaps at the ends of the sequences"));
+    verticalLayout->addWidget(freeEndGaps);
+    initParameters();
+}
+
+PairwiseAlignmentNeedlemanWunschMainWidget::~PairwiseAlignmentNeedlemanWunschMainWidget() {
+    getAlignmentAlgorithmCustomSettings(true);
+}
+
+void PairwiseAlignmentNeedlemanWunschMainWidget::initParameters() {
+    gapOpen->setMinimum(NW_MIN_GAP_OPEN);
+    gapOpen->setMaximum(NW_MAX_GAP_OPEN);
+
+    gapExtd->setMinimum(NW_MIN_GAP_EXTD);
+    gapExtd->setMaximum(NW_MAX_GAP_EXTD);
+
+    addScoredMatrixes();
+
+    QStringList alg_lst = AppContext::getAlignmentAlgorithmsRegistry()->getAlgorithm("Needleman-Wunsch")->getRealizationsList();
+    algorithmVersion->addItems(alg_lst);
+    if (externSettings->contains(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_REALIZATION_NAME)) {
+        algorithmVersion->setCurrentIndex(algorithmVersion->findText(externSettings->value(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_REALIZATION_NAME, QString()).toString()));
+    }
+
+    const int externGapOpen = -externSettings->value(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_OPEN, 0).toInt();
+    if (externGapOpen >= NW_MIN_GAP_OPEN && externGapOpen <= NW_MAX_GAP_OPEN) {
+        gapOpen->setValue(externGapOpen);
+    } else {
+        gapOpen->setValue(NW_DEFAULT_GAP_OPEN);
+    }
+
+    const int externGapExtd = -externSettings->value(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_EXTD, 0).toInt();
+    if (externGapExtd >= NW_MIN_GAP_EXTD && externGapExtd <= NW_MAX_GAP_EXTD) {
+        gapExtd->setValue(externGapExtd);
+    } else {
+        gapExtd->setValue(NW_DEFAULT_GAP_EXTD);
+    }
+
+    freeEndGaps->setChecked(externSettings->value(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_FREE_END_GAPS, false).toBool());
+
+    fillInnerSettings();
+}
+
+void PairwiseAlignmentNeedlemanWunschMainWidget::addScoredMatrixes() {
+    const DNAAlphabet* al = U2AlphabetUtils::getById(externSettings->value(PairwiseAlignmentTaskSettings::ALPHABET, "").toString());
+    SAFE_POINT(NULL != al, "Alphabet not found.", );
+    SubstMatrixRegistry* matrixReg = AppContext::getSubstMatrixRegistry();
+    SAFE_POINT(matrixReg, "SubstMatrixRegistry is NULL.", );
+    QStringList matrixList = matrixReg->selectMatrixNamesByAlphabet(al);
+    scoringMatrix->addItems(matrixList);
+    if (externSettings->contains(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_SCORING_MATRIX_NAME)) {
+        scoringMatrix->setCurrentIndex(scoringMatrix->findText(externSettings->value(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_SCORING_MATRIX_NAME, QString()).toString()));
+    }
+}
+
+QMap<QString, QVariant> PairwiseAlignmentNeedlemanWunschMainWidget::getAlignmentAlgorithmCustomSettings(bool append = false) {
+    fillInnerSettings();
+    return AlignmentAlgorithmMainWidget::getAlignmentAlgorithmCustomSettings(append);
+}
+
+void PairwiseAlignmentNeedlemanWunschMainWidget::updateWidget() {
+    scoringMatrix->clear();
+    addScoredMatrixes();
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_SCORING_MATRIX_NAME, scoringMatrix->currentText());
+}
+
+void PairwiseAlignmentNeedlemanWunschMainWidget::fillInnerSettings() {
+    innerSettings.insert(PairwiseAlignmentTaskSettings::REALIZATION_NAME, algorithmVersion->currentText());
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_OPEN, -gapOpen->value());
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_EXTD, -gapExtd->value());
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_FREE_END_GAPS, freeEndGaps->isChecked());
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_REALIZATION_NAME, algorithmVersion->currentText());
+    innerSettings.insert(PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_SCORING_MATRIX_NAME, scoringMatrix->currentText());
+}
+
+PairwiseAlignmentNeedlemanWunschGUIExtensionFactory::PairwiseAlignmentNeedlemanWunschGUIExtensionFactory(SW_AlgType _algType) :
+    AlignmentAlgorithmGUIExtensionFactory(), algType(_algType) {
+}
+
+AlignmentAlgorithmMainWidget* PairwiseAlignmentNeedlemanWunschGUIExtensionFactory::createMainWidget(QWidget* parent, QVariantMap* s) {
+    if (mainWidgets.contains(parent)) {
+        return mainWidgets.value(parent, NULL);
+    }
+    PairwiseAlignmentNeedlemanWunschMainWidget* newMainWidget = new PairwiseAlignmentNeedlemanWunschMainWidget(parent, s);
+    connect(newMainWidget, SIGNAL(destroyed(QObject*)), SLOT(sl_widgetDestroyed(QObject*)));
+    mainWidgets.insert(parent, newMainWidget);
+    return newMainWidget;
+}
+
+}   //namespace
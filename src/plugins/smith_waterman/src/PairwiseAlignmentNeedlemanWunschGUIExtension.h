@@ -0,0 +1,82 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_GUI_EXTENSION_H_
+#define _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_GUI_EXTENSION_H_
+
+#include "SWAlgorithmTask.h"
+#include "ui_PairwiseAlignmentSmithWatermanOptionsPanelMainWidget.h"
+
+#include <U2View/AlignmentAlgorithmGUIExtension.h>
+
+#include <QtCore/QVariantMap>
+
+#if (QT_VERSION < 0x050000) //Qt 5
+#include <QtGui/QCheckBox>
+#include <QtGui/QWidget>
+#else
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QWidget>
+#endif
+
+namespace U2 {
+
+/* The options are the same as the Smith-Waterman ones plus the end gaps mode */
+class PairwiseAlignmentNeedlemanWunschMainWidget : public AlignmentAlgorithmMainWidget,
+        public Ui_PairwiseAlignmentSmithWatermanOptionsPanelMainWidget {
+    Q_OBJECT
+
+public:
+    PairwiseAlignmentNeedlemanWunschMainWidget(QWidget* parent, QVariantMap* s);
+    virtual ~PairwiseAlignmentNeedlemanWunschMainWidget();
+    virtual QVariantMap getAlignmentAlgorithmCustomSettings(bool append);
+    virtual void updateWidget();
+
+private:
+    void initParameters();
+    void addScoredMatrixes();
+    virtual void fillInnerSettings();
+
+    QCheckBox* freeEndGaps;
+
+protected:
+    static const qint64 NW_MIN_GAP_OPEN         = 1;
+    static const qint64 NW_MAX_GAP_OPEN         = 65535;
+    static const qint64 NW_DEFAULT_GAP_OPEN     = 10;
+    static const qint64 NW_MIN_GAP_EXTD         = 1;
+    static const qint64 NW_MAX_GAP_EXTD         = 65535;
+    static const qint64 NW_DEFAULT_GAP_EXTD     = 1;
+};
+
+class PairwiseAlignmentNeedlemanWunschGUIExtensionFactory : public AlignmentAlgorithmGUIExtensionFactory {
+    Q_OBJECT
+
+public:
+    PairwiseAlignmentNeedlemanWunschGUIExtensionFactory(SW_AlgType _algType);
+    virtual AlignmentAlgorithmMainWidget* createMainWidget(QWidget* parent, QVariantMap* s);
+
+private:
+    SW_AlgType algType;
+};
+
+}   //namespace
+
+#endif // _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_GUI_EXTENSION_H_
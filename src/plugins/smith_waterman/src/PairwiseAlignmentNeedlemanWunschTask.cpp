@@ -0,0 +1,271 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "PairwiseAlignmentNeedlemanWunschTask.h"
+#include "GlobalAlignmentAlgorithm.h"
+#include "GlobalAlignmentAlgorithmSSE2.h"
+
+#include <U2Core/AppContext.h>
+#include <U2Core/BaseDocumentFormats.h>
+#include <U2Core/Counter.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/Log.h>
+#include <U2Core/MAlignmentImporter.h>
+#include <U2Core/MAlignmentObject.h>
+#include <U2Core/ProjectModel.h>
+#include <U2Core/SaveDocumentTask.h>
+#include <U2Core/U2AlphabetUtils.h>
+#include <U2Core/U2DbiUtils.h>
+#include <U2Core/U2MsaDbi.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+#include <U2Core/U2SequenceDbi.h>
+
+#include <U2Algorithm/SubstMatrixRegistry.h>
+
+#include <QtCore/QRegExp>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVariant>
+
+namespace U2 {
+
+const QString PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_OPEN("NW_gapOpen");
+const QString PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_GAP_EXTD("NW_gapExtd");
+const QString PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_SCORING_MATRIX_NAME("NW_scoringMatrix");
+const QString PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_FREE_END_GAPS("NW_freeEndGaps");
+const QString PairwiseAlignmentNeedlemanWunschTaskSettings::PA_NW_REALIZATION_NAME("NW_realizationName");
+
+PairwiseAlignmentNeedlemanWunschTaskSettings::PairwiseAlignmentNeedlemanWunschTaskSettings(const PairwiseAlignmentTaskSettings &s) :
+    PairwiseAlignmentTaskSettings(s),
+    gapOpen(0),
+    gapExtd(0),
+    freeEndGaps(false) {}
+
+PairwiseAlignmentNeedlemanWunschTaskSettings::~PairwiseAlignmentNeedlemanWunschTaskSettings() {
+    //all dynamic objects will be destroyed by the task
+}
+
+bool PairwiseAlignmentNeedlemanWunschTaskSettings::convertCustomSettings() {
+    if ((customSettings.contains(PA_NW_GAP_OPEN) == false) ||
+            (customSettings.contains(PA_NW_GAP_EXTD) == false) ||
+            (customSettings.contains(PA_NW_SCORING_MATRIX_NAME) == false)) {
+        return false;
+    }
+    gapOpen = customSettings.value(PA_NW_GAP_OPEN).toInt();
+    gapExtd = customSettings.value(PA_NW_GAP_EXTD).toInt();
+    freeEndGaps = customSettings.value(PA_NW_FREE_END_GAPS, false).toBool();
+    sMatrixName = customSettings.value(PA_NW_SCORING_MATRIX_NAME).toString();
+    sMatrix = AppContext::getSubstMatrixRegistry()->getMatrix(sMatrixName);
+    SAFE_POINT(!sMatrix.isEmpty(), "No matrix found", false);
+
+    PairwiseAlignmentTaskSettings::convertCustomSettings();
+    return true;
+}
+
+NeedlemanWunschAlignTask::NeedlemanWunschAlignTask(const QByteArray &_first, const QByteArray &_second, const SMatrix &_sMatrix,
+                                                   int _gapOpen, int _gapExtd, bool _freeEndGaps, SW_AlgType _algType) :
+    Task(tr("Global alignment"), TaskFlag_None),
+    first(_first),
+    second(_second),
+    sMatrix(_sMatrix),
+    gapOpen(_gapOpen),
+    gapExtd(_gapExtd),
+    freeEndGaps(_freeEndGaps),
+    algType(_algType),
+    score(0)
+{
+    tpm = Progress_Manual;
+}
+
+void NeedlemanWunschAlignTask::run() {
+    QScopedPointer<GlobalAlignmentAlgorithm> algorithm;
+#ifdef SW2_BUILD_WITH_SSE2
+    if (SW_sse2 == algType) {
+        algorithm.reset(new GlobalAlignmentAlgorithmSSE2());
+    }
+#endif
+    if (algorithm.isNull()) {
+        algorithm.reset(new GlobalAlignmentAlgorithm());
+    }
+
+    // the first gap symbol costs the open penalty as in Smith-Waterman, the algorithm charges it separately
+    const int extd = qAbs(gapExtd);
+    const int open = qMax(0, qAbs(gapOpen) - extd);
+    algorithm->launch(sMatrix, first, second, open, extd, freeEndGaps);
+
+    pairAlignment = algorithm->getPairAlignment();
+    score = algorithm->getScore();
+    stateInfo.progress = 100;
+}
+
+const QByteArray & NeedlemanWunschAlignTask::getPairAlignment() const {
+    return pairAlignment;
+}
+
+int NeedlemanWunschAlignTask::getScore() const {
+    return score;
+}
+
+PairwiseAlignmentNeedlemanWunschTask::PairwiseAlignmentNeedlemanWunschTask(PairwiseAlignmentNeedlemanWunschTaskSettings *_settings, SW_AlgType algType) :
+    PairwiseAlignmentTask(TaskFlag_NoRun), settings(_settings), alignTask(NULL) {
+    GCOUNTER(cvar, tvar, "NeedlemanWunschTask");
+
+    SAFE_POINT(settings != NULL, "Task settings are not defined.", );
+    SAFE_POINT(settings->convertCustomSettings() && settings->isValid(), "Invalide task settings.", );
+
+    U2OpStatus2Log os;
+    DbiConnection con(settings->msaRef.dbiRef, os);
+    CHECK_OP(os, );
+    U2Sequence sequence = con.dbi->getSequenceDbi()->getSequenceObject(settings->firstSequenceRef.entityId, os);
+    CHECK_OP(os, );
+    first = con.dbi->getSequenceDbi()->getSequenceData(sequence.id, U2Region(0, sequence.length), os);
+    CHECK_OP(os, );
+    firstName = sequence.visualName;
+
+    sequence = con.dbi->getSequenceDbi()->getSequenceObject(settings->secondSequenceRef.entityId, os);
+    CHECK_OP(os, );
+    second = con.dbi->getSequenceDbi()->getSequenceData(sequence.id, U2Region(0, sequence.length), os);
+    CHECK_OP(os, );
+    secondName = sequence.visualName;
+    con.close(os);
+
+    const DNAAlphabet *matrixAlphabet = settings->sMatrix.getAlphabet();
+    SAFE_POINT(NULL != matrixAlphabet, "Matrix alphabet is NULL", );
+    if (!matrixAlphabet->containsAll(first.constData(), first.length()) || !matrixAlphabet->containsAll(second.constData(), second.length())) {
+        setError(tr("The sequences contain symbols that are not supported by the '%1' scoring matrix").arg(settings->sMatrixName));
+        return;
+    }
+
+    alignTask = new NeedlemanWunschAlignTask(first, second, settings->sMatrix, settings->gapOpen, settings->gapExtd, settings->freeEndGaps, algType);
+    addSubTask(alignTask);
+}
+
+PairwiseAlignmentNeedlemanWunschTask::~PairwiseAlignmentNeedlemanWunschTask() {
+    delete settings;
+}
+
+QList<Task*> PairwiseAlignmentNeedlemanWunschTask::onSubTaskFinished(Task *subTask) {
+    QList<Task*> res;
+    if (hasError() || isCanceled()) {
+        return res;
+    }
+    if (subTask->hasError() || subTask->isCanceled()) {
+        return res;
+    }
+    CHECK(subTask == alignTask, res);
+
+    MAlignment resultMa = createResultAlignment(stateInfo);
+    CHECK_OP(stateInfo, res);
+
+    U2OpStatus2Log os;
+
+    if (settings->inNewWindow == true) {
+        Project * currentProject = AppContext::getProject();
+        DocumentFormat * format = AppContext::getDocumentFormatRegistry()->getFormatById(BaseDocumentFormats::CLUSTAL_ALN);
+
+        QString newFileUrl = settings->resultFileName.getURLString();
+        changeGivenUrlIfDocumentExists(newFileUrl, currentProject);
+
+        Document * alignmentDoc = format->createNewLoadedDocument(IOAdapterUtils::get(BaseIOAdapters::LOCAL_FILE), GUrl(newFileUrl), os);
+        CHECK_OP(os, res);
+
+        MAlignmentObject * docObject = MAlignmentImporter::createAlignment(alignmentDoc->getDbiRef(), resultMa, os);
+        CHECK_OP(os, res);
+
+        alignmentDoc->addObject(docObject);
+
+        SaveDocFlags flags = SaveDoc_Overwrite;
+        flags |= SaveDoc_OpenAfter;
+        res << new SaveDocumentTask(alignmentDoc, flags);
+    } else {        //in current window
+        DbiConnection con(settings->msaRef.dbiRef, os);
+        CHECK_OP(os, res);
+
+        QList<U2MsaRow> rows = con.dbi->getMsaDbi()->getRows(settings->msaRef.entityId, os);
+        CHECK_OP(os, res);
+        U2UseCommonUserModStep userModStep(settings->msaRef, os);
+        Q_UNUSED(userModStep);
+        SAFE_POINT_OP(os, res);
+        for (int rowNumber = 0; rowNumber < rows.length(); ++rowNumber) {
+            if (rows[rowNumber].sequenceId == settings->firstSequenceRef.entityId) {
+                con.dbi->getMsaDbi()->updateGapModel(settings->msaRef.entityId, rows[rowNumber].rowId, resultMa.getRow(0).getGapModel(), os);
+                CHECK_OP(os, res);
+            }
+            if (rows[rowNumber].sequenceId == settings->secondSequenceRef.entityId) {
+                con.dbi->getMsaDbi()->updateGapModel(settings->msaRef.entityId, rows[rowNumber].rowId, resultMa.getRow(1).getGapModel(), os);
+                CHECK_OP(os, res);
+            }
+        }
+    }
+    return res;
+}
+
+Task::ReportResult PairwiseAlignmentNeedlemanWunschTask::report() {
+    propagateSubtaskError();
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    SAFE_POINT(NULL != alignTask, "Global alignment task is NULL", ReportResult_Finished);
+
+    algoLog.details(tr("The global alignment score is %1").arg(alignTask->getScore()));
+    return ReportResult_Finished;
+}
+
+MAlignment PairwiseAlignmentNeedlemanWunschTask::createResultAlignment(U2OpStatus &os) const {
+    const DNAAlphabet *alphabet = U2AlphabetUtils::getById(settings->alphabet);
+    SAFE_POINT_EXT(NULL != alphabet, os.setError("Alphabet is invalid"), MAlignment());
+
+    const QByteArray &pairAlignment = alignTask->getPairAlignment();
+    QByteArray firstRow;
+    QByteArray secondRow;
+    firstRow.reserve(pairAlignment.size());
+    secondRow.reserve(pairAlignment.size());
+    int i = 0;
+    int j = 0;
+    foreach (char op, pairAlignment) {
+        firstRow.append(GlobalAlignmentAlgorithm::LEFT == op ? MAlignment_GapChar : first[i++]);
+        secondRow.append(GlobalAlignmentAlgorithm::UP == op ? MAlignment_GapChar : second[j++]);
+    }
+    SAFE_POINT_EXT(first.length() == i && second.length() == j, os.setError("Incorrect global alignment"), MAlignment());
+
+    MAlignment ma(firstName + " vs. " + secondName, alphabet);
+    ma.addRow(firstName, firstRow, os);
+    CHECK_OP(os, MAlignment());
+    ma.addRow(secondName, secondRow, os);
+    CHECK_OP(os, MAlignment());
+    return ma;
+}
+
+void PairwiseAlignmentNeedlemanWunschTask::changeGivenUrlIfDocumentExists(QString & givenUrl, const Project * curProject) {
+    if(NULL != curProject->findDocumentByURL(GUrl(givenUrl))) {
+        for(size_t i = 1; ; i++) {
+            QString tmpUrl = givenUrl;
+            QRegExp dotWithExtensionRegExp ("\\.{1,1}[^\\.]*$|^[^\\.]*$");
+            dotWithExtensionRegExp.lastIndexIn(tmpUrl);
+            tmpUrl.replace(dotWithExtensionRegExp.capturedTexts().last(), "(" + QString::number(i) + ")" + dotWithExtensionRegExp.capturedTexts().last());
+            if(NULL == curProject->findDocumentByURL(GUrl(tmpUrl))) {
+                givenUrl = tmpUrl;
+                break;
+            }
+        }
+    }
+}
+
+}   //namespace
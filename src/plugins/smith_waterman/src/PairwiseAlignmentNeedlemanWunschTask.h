@@ -0,0 +1,107 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_TASK_H_
+#define _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_TASK_H_
+
+#include "SWAlgorithmTask.h"
+
+#include <U2Algorithm/PairwiseAlignmentTask.h>
+
+#include <U2Core/MAlignment.h>
+#include <U2Core/SMatrix.h>
+
+namespace U2 {
+
+class Project;
+
+class PairwiseAlignmentNeedlemanWunschTaskSettings : public PairwiseAlignmentTaskSettings {
+public:
+    PairwiseAlignmentNeedlemanWunschTaskSettings(const PairwiseAlignmentTaskSettings &s);
+    virtual ~PairwiseAlignmentNeedlemanWunschTaskSettings();
+
+    virtual bool convertCustomSettings();
+
+    //all settings except sMatrix must be set up through customSettings and then must be converted by convertCustomSettings().
+    int gapOpen;            //the penalties are negative as in the Smith-Waterman settings
+    int gapExtd;
+    bool freeEndGaps;
+    QString sMatrixName;
+    SMatrix sMatrix;        //initialized by convertCustomSettings()
+
+    static const QString PA_NW_GAP_OPEN;
+    static const QString PA_NW_GAP_EXTD;
+    static const QString PA_NW_SCORING_MATRIX_NAME;
+    static const QString PA_NW_FREE_END_GAPS;
+    static const QString PA_NW_REALIZATION_NAME;
+};
+
+/**
+ * Calculates the global alignment of two sequences.
+ */
+class NeedlemanWunschAlignTask : public Task {
+    Q_OBJECT
+public:
+    NeedlemanWunschAlignTask(const QByteArray &first, const QByteArray &second, const SMatrix &sMatrix,
+                             int gapOpen, int gapExtd, bool freeEndGaps, SW_AlgType algType);
+
+    virtual void run();
+
+    /* see GlobalAlignmentAlgorithm::getPairAlignment() */
+    const QByteArray & getPairAlignment() const;
+    int getScore() const;
+
+private:
+    const QByteArray first;
+    const QByteArray second;
+    const SMatrix sMatrix;
+    const int gapOpen;
+    const int gapExtd;
+    const bool freeEndGaps;
+    const SW_AlgType algType;
+
+    QByteArray pairAlignment;
+    int score;
+};
+
+class PairwiseAlignmentNeedlemanWunschTask : public PairwiseAlignmentTask {
+    Q_OBJECT
+public:
+    PairwiseAlignmentNeedlemanWunschTask(PairwiseAlignmentNeedlemanWunschTaskSettings *settings, SW_AlgType algType);
+    ~PairwiseAlignmentNeedlemanWunschTask();
+
+    virtual QList<Task*> onSubTaskFinished(Task *subTask);
+    virtual ReportResult report();
+
+protected:
+    MAlignment createResultAlignment(U2OpStatus &os) const;
+    void changeGivenUrlIfDocumentExists(QString &givenUrl, const Project *curProject);
+
+protected:
+    PairwiseAlignmentNeedlemanWunschTaskSettings *settings;
+    NeedlemanWunschAlignTask *alignTask;
+    QString firstName;
+    QString secondName;
+};
+
+}   //namespace
+
+#endif // _U2_PAIRWISE_ALIGNMENT_NEEDLEMAN_WUNSCH_TASK_H_
@@ -22,8 +22,10 @@
 #include "SWAlgorithmPlugin.h"
 
 #include "SWAlgorithmTask.h"
+#include "SWLocalTask.h"
 #include "SWTaskFactory.h"
 #include "PairwiseAlignmentSmithWatermanGUIExtension.h"
+#include "PairwiseAlignmentNeedlemanWunschGUIExtension.h"
 #include "SmithWatermanTests.h"
 #include "SWQuery.h"
 #include "SWWorker.h"
@@ -60,6 +62,8 @@
 
 #include <U2Lang/QueryDesignerRegistry.h>
 
+#include <U2Remote/LocalTask.h>
+
 namespace U2 {
 
 extern "C" Q_DECL_EXPORT Plugin* U2_PLUGIN_INIT_FUNC() {
@@ -107,6 +111,7 @@ SWAlgorithmPlugin::SWAlgorithmPlugin()
     coreLog.trace("Registering classic SW implementation");
     swar->registerFactory(new SWTaskFactory(SW_classic), QString("Classic 2"));     //ADV search register
     par->registerAlgorithm(new SWPairwiseAlignmentAlgorithm());
+    par->registerAlgorithm(new NWPairwiseAlignmentAlgorithm());
     regDependedIMPLFromOtherPlugins();
 
 #ifdef SW2_BUILD_WITH_SSE2
@@ -115,8 +120,18 @@ SWAlgorithmPlugin::SWAlgorithmPlugin()
     par->getAlgorithm("Smith-Waterman")->addAlgorithmRealization(new PairwiseAlignmentSmithWatermanTaskFactory(SW_sse2),
                                                                  new PairwiseAlignmentSmithWatermanGUIExtensionFactory(SW_sse2),
                                                                  "SSE2");
+    par->getAlgorithm("Needleman-Wunsch")->addAlgorithmRealization(new PairwiseAlignmentNeedlemanWunschTaskFactory(SW_sse2),
+                                                                   new PairwiseAlignmentNeedlemanWunschGUIExtensionFactory(SW_sse2),
+                                                                   "SSE2");
 #endif
 
+    coreLog.trace("Registering multiprocess SW implementation");
+    swar->registerFactory(new SWMultiProcessTaskFactory(), SWMultiProcessTaskFactory::ID);
+    LocalTaskFactoryRegistry *ltfr = AppContext::getLocalTaskFactoryRegistry();
+    if (NULL != ltfr) {
+        ltfr->registerLocalTaskFactory(new SmithWatermanLocalTaskFactory());
+    }
+
     this->connect(AppContext::getPluginSupport(), SIGNAL(si_allStartUpPluginsLoaded()), SLOT(regDependedIMPLFromOtherPlugins()));
 }
 
@@ -124,6 +139,14 @@ QList<XMLTestFactory*> SWAlgorithmTests::createTestFactories() {
     QList<XMLTestFactory*> res;
     res.append(GTest_SmithWatermnan::createFactory());
     res.append(GTest_SmithWatermnanPerf::createFactory());
+    res.append(GTest_SmithWatermanLocalTaskSerialization::createFactory());
+    res.append(GTest_GlobalAlignmentFullMatrix::createFactory());
+    res.append(GTest_GlobalAlignmentSSE2Rows::createFactory());
+    res.append(GTest_GlobalAlignmentTraceback::createFactory());
+    res.append(GTest_SWBulkResultHeap::createFactory());
+    res.append(GTest_SWBulkSearchMinScore::createFactory());
+    res.append(GTest_SWBulkHitCoordinates::createFactory());
+    res.append(GTest_SWBulkSearch::createFactory());
     return res;
 }
 
@@ -201,4 +224,20 @@ bool SWPairwiseAlignmentAlgorithm::checkAlphabet(const DNAAlphabet *alphabet) co
 
 }
 
+NWPairwiseAlignmentAlgorithm::NWPairwiseAlignmentAlgorithm()
+    : AlignmentAlgorithm(PairwiseAlignment, "Needleman-Wunsch",
+                                 new PairwiseAlignmentNeedlemanWunschTaskFactory(SW_classic),
+                                 new PairwiseAlignmentNeedlemanWunschGUIExtensionFactory(SW_classic),
+                                 "NW_classic")
+{
+}
+
+bool NWPairwiseAlignmentAlgorithm::checkAlphabet(const DNAAlphabet *alphabet) const {
+    SAFE_POINT(NULL != alphabet, "Alphabet is NULL.", false);
+    SubstMatrixRegistry* matrixReg = AppContext::getSubstMatrixRegistry();
+    SAFE_POINT(matrixReg, "SubstMatrixRegistry is NULL.", false);
+    QStringList matrixList = matrixReg->selectMatrixNamesByAlphabet(alphabet);
+    return !matrixList.isEmpty();
+}
+
 } //namespace
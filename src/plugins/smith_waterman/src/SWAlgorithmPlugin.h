@@ -73,6 +73,12 @@ public:
     bool checkAlphabet(const DNAAlphabet *alphabet) const;
 };
 
+class NWPairwiseAlignmentAlgorithm : public AlignmentAlgorithm {
+public:
+    NWPairwiseAlignmentAlgorithm();
+    bool checkAlphabet(const DNAAlphabet *alphabet) const;
+};
+
 } //namespace
 
 #endif  //_U2_SW_ALGORITHM_PLUGIN_H_
@@ -59,12 +59,13 @@ public:
 
     QList<Task*> onSubTaskFinished(Task* subTask);
 
+    static int calculateMatrixLength(int searchSeqLen, int patternLen, int gapOpen, int gapExtension, int maxScore, int minScore);
+    static int calculateMaxScore(const QByteArray & seq, const SMatrix& substitutionMatrix);
+
 private:
 
     void addResult(QList<PairAlignSequences> & res);
-    int calculateMatrixLength(int searchSeqLen, int patternLen, int gapOpen, int gapExtension, int maxScore, int minScore);
     void removeResultFromOverlap(QList<PairAlignSequences> & res);
-    int calculateMaxScore(const QByteArray & seq, const SMatrix& substitutionMatrix);
 
     void setupTask(int maxScore);
 
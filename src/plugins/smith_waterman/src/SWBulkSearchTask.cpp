@@ -0,0 +1,503 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifdef SW2_BUILD_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include "SWBulkSearchTask.h"
+
+#include "SmithWatermanAlgorithmCUDA.h"
+#include "SmithWatermanAlgorithmSSE2.h"
+#include "SmithWatermanAlgorithmOPENCL.h"
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/AppSettings.h>
+#include <U2Core/Counter.h>
+#include <U2Core/DNATranslation.h>
+#include <U2Core/Log.h>
+#include <U2Core/TextUtils.h>
+#include <U2Core/Timer.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Algorithm/CudaGpuRegistry.h>
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QScopedPointer>
+
+namespace U2 {
+
+static const double B_TO_MB_FACTOR = 1048576.0;
+
+/************************************************************************/
+/* SWBulkResultHeap */
+/************************************************************************/
+SWBulkResultHeap::SWBulkResultHeap(int _capacity)
+    : capacity(qMax(0, _capacity))
+{
+
+}
+
+void SWBulkResultHeap::push(const PairAlignSequences &hit) {
+    const HitKey key = getKey(hit);
+    if (hits.contains(key)) {
+        const int oldScore = hits.value(key).score;
+        CHECK(oldScore < hit.score, );
+        scores.remove(oldScore, key);
+    } else if (isFull()) {
+        CHECK(getLowestScore() < hit.score, );
+        QMultiMap<int, HitKey>::iterator lowest = scores.begin();
+        hits.remove(lowest.value());
+        scores.erase(lowest);
+    }
+    hits.insert(key, hit);
+    scores.insert(hit.score, key);
+}
+
+bool SWBulkResultHeap::isFull() const {
+    return capacity > 0 && hits.size() >= capacity;
+}
+
+int SWBulkResultHeap::getLowestScore() const {
+    CHECK(!scores.isEmpty(), 0);
+    return scores.begin().key();
+}
+
+QList<PairAlignSequences> SWBulkResultHeap::getHits() const {
+    QList<PairAlignSequences> result;
+    QMapIterator<int, HitKey> it(scores);
+    it.toBack();
+    while (it.hasPrevious()) {
+        result << hits.value(it.previous().value());
+    }
+    return result;
+}
+
+SWBulkResultHeap::HitKey SWBulkResultHeap::getKey(const PairAlignSequences &hit) {
+    return HitKey(hit.refSubseqInterval.startPos, hit.refSubseqInterval.length * 2 + (hit.isDNAComplemented ? 1 : 0));
+}
+
+/************************************************************************/
+/* SWBulkSearch */
+/************************************************************************/
+SWBulkSearch::SWBulkSearch(const SmithWatermanSettings &_config, int maxResults, SW_AlgType _algType)
+    : config(_config), algType(_algType), maxScore(0), minScore(0), heap(maxResults)
+{
+    if (SW_sse2 == algType && config.ptrn.length() < 8) {
+        algType = SW_classic;
+    }
+
+    maxScore = SWAlgorithmTask::calculateMaxScore(config.ptrn, config.pSm);
+    minScore = (maxScore * config.percentOfScore) / 100;
+    if ((maxScore * (int)config.percentOfScore) % 100 != 0) {
+        minScore += 1;
+    }
+}
+
+int SWBulkSearch::getMinScore() {
+    QMutexLocker locker(&lock);
+    return minScore;
+}
+
+int SWBulkSearch::addHits(const QList<PairAlignSequences> &hits) {
+    QMutexLocker locker(&lock);
+    foreach (const PairAlignSequences &hit, hits) {
+        heap.push(hit);
+    }
+    if (heap.isFull()) {
+        // only hits better than the kept ones are of interest now
+        minScore = qMax(minScore, heap.getLowestScore() + 1);
+    }
+    return minScore;
+}
+
+/************************************************************************/
+/* SWBulkWorkItem */
+/************************************************************************/
+SWBulkWorkItem::SWBulkWorkItem()
+    : searchId(-1), complement(false)
+{
+
+}
+
+SWBulkWorkItem::SWBulkWorkItem(int _searchId, const U2Region &_region, bool _complement)
+    : searchId(_searchId), region(_region), complement(_complement)
+{
+
+}
+
+/************************************************************************/
+/* SWBulkSearchTask */
+/************************************************************************/
+SWBulkSearchTask::SWBulkSearchTask(const QList<SmithWatermanSettings> &configs, int maxResults, const QString &taskName, SW_AlgType _algType)
+    : Task(taskName, TaskFlags_FOSE_COSC), algType(_algType), nThreads(1), computationMatrixSquare(0.0),
+      nextWorkItem(0), maxPartLength(0), longestSearchId(-1), cudaGpu(NULL), openClGpu(NULL)
+{
+    GCOUNTER(cvar, tvar, "SWBulkSearchTask");
+
+    // the same values as SWAlgorithmTask uses for a single search
+    const int idealThreadCount = AppContext::getAppSettings()->getAppResourcePool()->getIdealThreadCount();
+    switch (algType) {
+        case SW_sse2:
+            computationMatrixSquare = 1619582300.0;
+            nThreads = idealThreadCount * 2.5;
+            break;
+        case SW_classic:
+            computationMatrixSquare = 751948900.29;
+            nThreads = idealThreadCount;
+            break;
+        case SW_cuda:
+        case SW_opencl:
+            computationMatrixSquare = 58484916.67;
+            nThreads = 1;
+            break;
+        default:
+            assert(0);
+    }
+    nThreads = qMax(1, nThreads);
+
+    foreach (const SmithWatermanSettings &config, configs) {
+        searches << new SWBulkSearch(config, maxResults, algType);
+        initWorkItems(searches.last(), searches.size() - 1);
+    }
+    nThreads = qMin(nThreads, workItems.size());
+    algoLog.details(tr("%1 searches are cut into %2 parts").arg(searches.size()).arg(workItems.size()));
+
+    //acquiring resources for GPU computations
+    if (SW_cuda == algType) {
+        addTaskResource(TaskResourceUsage(RESOURCE_CUDA_GPU, 1, true /*prepareStage*/));
+    } else if (SW_opencl == algType) {
+        addTaskResource(TaskResourceUsage(RESOURCE_OPENCL_GPU, 1, true /*prepareStage*/));
+    }
+    addMemoryResource();
+}
+
+SWBulkSearchTask::~SWBulkSearchTask() {
+    foreach (SWBulkSearch *search, searches) {
+        delete search->config.resultListener;
+        delete search->config.resultCallback;
+        // we do not delete resultFilter here, because filters are stored in special registry
+    }
+    qDeleteAll(searches);
+}
+
+void SWBulkSearchTask::initWorkItems(SWBulkSearch *search, int searchId) {
+    const SmithWatermanSettings &config = search->config;
+    const U2Region &region = config.globalRegion;
+    const int patternLength = config.ptrn.length() * (NULL == config.aminoTT ? 1 : 3);
+    CHECK(patternLength > 0 && region.length > 0, );
+
+    const qint64 overlapSize = SWAlgorithmTask::calculateMatrixLength(config.sqnc.length(), patternLength,
+        config.gapModel.scoreGapOpen, config.gapModel.scoreGapExtd, search->maxScore, search->minScore);
+
+    // long sequences are cut into several parts even if one part would fit the computation matrix,
+    // so a single search against a long sequence keeps all the threads busy as well
+    qint64 partLength = qMax<qint64>(static_cast<qint64>(computationMatrixSquare / config.ptrn.length()), 1);
+    partLength = qMin(partLength, region.length / nThreads + overlapSize);
+    partLength = qMax(partLength, qMax<qint64>(overlapSize + 1, patternLength));
+    partLength = qMin(partLength, region.length);
+
+    const bool searchComplement = isComplement(config.strand) && NULL != config.complTT;
+    for (qint64 start = region.startPos; ; start += partLength - overlapSize) {
+        const U2Region part(start, qMin(partLength, region.endPos() - start));
+        if (isDirect(config.strand)) {
+            workItems << SWBulkWorkItem(searchId, part, false);
+        }
+        if (searchComplement) {
+            workItems << SWBulkWorkItem(searchId, part, true);
+        }
+        CHECK_OPERATION(part.endPos() < region.endPos(), break);
+    }
+
+    maxPartLength = qMax(maxPartLength, partLength);
+    if (-1 == longestSearchId || searches.at(longestSearchId)->config.ptrn.length() < config.ptrn.length()) {
+        longestSearchId = searchId;
+    }
+}
+
+void SWBulkSearchTask::addMemoryResource() {
+    CHECK(-1 != longestSearchId, );
+    const SWBulkSearch *search = searches.at(longestSearchId);
+    const SmithWatermanSettings &config = search->config;
+    const QByteArray seq = config.sqnc.left(maxPartLength * nThreads);
+
+    //acquiring memory resources for computations
+    switch (search->algType) {
+        case SW_cuda:
+#ifdef SW2_BUILD_WITH_CUDA
+            addTaskResource(TaskResourceUsage(RESOURCE_MEMORY,
+                SmithWatermanAlgorithmCUDA::estimateNeededRamAmount(config.pSm, config.ptrn, seq, config.resultView),
+                true));
+#endif
+            break;
+        case SW_opencl:
+#ifdef SW2_BUILD_WITH_OPENCL
+            addTaskResource(TaskResourceUsage(RESOURCE_MEMORY,
+                SmithWatermanAlgorithmOPENCL::estimateNeededRamAmount(config.pSm, config.ptrn, seq, config.resultView),
+                true));
+#endif
+            break;
+        case SW_classic:
+            addTaskResource(TaskResourceUsage(RESOURCE_MEMORY,
+                SmithWatermanAlgorithm::estimateNeededRamAmount(config.gapModel.scoreGapOpen, config.gapModel.scoreGapExtd,
+                    search->minScore, search->maxScore, config.ptrn, seq, config.resultView),
+                true));
+            break;
+        case SW_sse2:
+#ifdef SW2_BUILD_WITH_SSE2
+            addTaskResource(TaskResourceUsage(RESOURCE_MEMORY,
+                SmithWatermanAlgorithmSSE2::estimateNeededRamAmount(config.ptrn, seq, config.gapModel.scoreGapOpen,
+                    config.gapModel.scoreGapExtd, search->minScore, search->maxScore, config.resultView),
+                true));
+#endif
+            break;
+        default:
+            assert(0);
+    }
+}
+
+void SWBulkSearchTask::prepare() {
+    CHECK(!workItems.isEmpty(), );
+    if (SW_cuda == algType) {
+        cudaGpu = AppContext::getCudaGpuRegistry()->acquireAnyReadyGpu();
+        SAFE_POINT_EXT(NULL != cudaGpu, setError("No ready CUDA device"), );
+#ifdef SW2_BUILD_WITH_CUDA
+        const SmithWatermanSettings &config = searches.at(longestSearchId)->config;
+        const quint64 needMemBytes = SmithWatermanAlgorithmCUDA::estimateNeededGpuMemory(
+            config.pSm, config.ptrn, config.sqnc.left(maxPartLength), config.resultView);
+        const quint64 gpuMemBytes = cudaGpu->getGlobalMemorySizeBytes();
+        CHECK_EXT(needMemBytes <= gpuMemBytes, setError(tr("Not enough memory on CUDA-enabled device. "
+            "The space required is %1 bytes, but only %2 bytes are available. Device id: %3, device name: %4")
+            .arg(QString::number(needMemBytes), QString::number(gpuMemBytes), QString::number(cudaGpu->getId()), QString(cudaGpu->getName()))), );
+        algoLog.details(tr("The Smith-Waterman search allocates ~%1 bytes (%2 Mb) on CUDA device")
+            .arg(QString::number(needMemBytes), QString::number(needMemBytes / B_TO_MB_FACTOR)));
+        coreLog.details(QString("GPU model: %1").arg(cudaGpu->getName()));
+
+        cudaSetDevice(cudaGpu->getId());
+#else
+        assert(false);
+#endif
+    } else if (SW_opencl == algType) {
+#ifdef SW2_BUILD_WITH_OPENCL
+        openClGpu = AppContext::getOpenCLGpuRegistry()->acquireAnyReadyGpu();
+        SAFE_POINT_EXT(NULL != openClGpu, setError("No ready OpenCL device"), );
+        const SmithWatermanSettings &config = searches.at(longestSearchId)->config;
+        const quint64 needMemBytes = SmithWatermanAlgorithmOPENCL::estimateNeededGpuMemory(
+            config.pSm, config.ptrn, config.sqnc.left(maxPartLength));
+        const quint64 gpuMemBytes = openClGpu->getGlobalMemorySizeBytes();
+        CHECK_EXT(needMemBytes <= gpuMemBytes, setError(tr("Not enough memory on OpenCL-enabled device. "
+            "The space required is %1 bytes, but only %2 bytes are available. Device id: %3, device name: %4")
+            .arg(QString::number(needMemBytes), QString::number(gpuMemBytes), QString::number(openClGpu->getId()), QString(openClGpu->getName()))), );
+        algoLog.details(tr("The Smith-Waterman search allocates ~%1 bytes (%2 Mb) on OpenCL device")
+            .arg(QString::number(needMemBytes), QString::number(needMemBytes / B_TO_MB_FACTOR)));
+        coreLog.details(QString("GPU model: %1").arg(openClGpu->getName()));
+#else
+        assert(0);
+#endif
+    }
+
+    setMaxParallelSubtasks(nThreads);
+    for (int i = 0; i < nThreads; i++) {
+        addSubTask(new SWBulkSearchSubtask(this));
+    }
+}
+
+bool SWBulkSearchTask::takeWorkItem(SWBulkWorkItem &item) {
+    QMutexLocker locker(&workItemsLock);
+    CHECK(nextWorkItem < workItems.size(), false);
+    item = workItems.at(nextWorkItem++);
+    return true;
+}
+
+void SWBulkSearchTask::processWorkItem(const SWBulkWorkItem &item, TaskStateInfo &ti) {
+    SWBulkSearch *search = searches.at(item.searchId);
+    const SmithWatermanSettings &config = search->config;
+
+    int minScore = search->getMinScore();
+    // the kept hits already have the best possible score
+    CHECK(minScore <= search->maxScore, );
+
+    QByteArray partSeq(config.sqnc.constData() + item.region.startPos, item.region.length);
+    if (item.complement) {
+        const QByteArray &complementMap = config.complTT->getOne2OneMapper();
+        TextUtils::translate(complementMap, partSeq.data(), partSeq.length());
+        TextUtils::reverse(partSeq.data(), partSeq.length());
+    }
+
+    // this substitution is needed for the case when annotation are required as result
+    // as well as pattern subsequence
+    const SmithWatermanSettings::SWResultView resultView =
+        (SmithWatermanSettings::ANNOTATIONS == config.resultView && config.includePatternContent)
+        ? SmithWatermanSettings::MULTIPLE_ALIGNMENT : config.resultView;
+
+    // a translated part is searched in all three frames
+    const int framesNumber = (NULL == config.aminoTT) ? 1 : 3;
+    for (int frame = 0; frame < framesNumber; frame++) {
+        CHECK(!ti.isCoR(), );
+        QByteArray localSeq = partSeq.mid(frame);
+        if (NULL != config.aminoTT) {
+            const int aminoLength = localSeq.length() / 3;
+            config.aminoTT->translate(localSeq.data(), aminoLength * 3, localSeq.data(), aminoLength);
+            localSeq.resize(aminoLength);
+        }
+        CHECK_OPERATION(!localSeq.isEmpty(), continue);
+
+        QScopedPointer<SmithWatermanAlgorithm> sw(createAlgorithm(search->algType, ti));
+        CHECK_OP(ti, );
+        sw->launch(config.pSm, config.ptrn, localSeq,
+            config.gapModel.scoreGapOpen + config.gapModel.scoreGapExtd,
+            config.gapModel.scoreGapExtd, minScore, resultView);
+
+        QList<PairAlignSequences> hits = sw->getResults();
+        for (int i = 0; i < hits.size(); i++) {
+            PairAlignSequences &hit = hits[i];
+            hit.isDNAComplemented = item.complement;
+            hit.isAminoTranslated = (NULL != config.aminoTT);
+            toSequenceCoordinates(hit, item.region, item.complement, frame, hit.isAminoTranslated);
+        }
+
+        minScore = search->addHits(hits);
+        CHECK(minScore <= search->maxScore, );
+    }
+}
+
+void SWBulkSearchTask::toSequenceCoordinates(PairAlignSequences &hit, const U2Region &part, bool complement, int frame, bool translated) {
+    U2Region &region = hit.refSubseqInterval;
+    if (translated) {
+        region.startPos *= 3;
+        region.length *= 3;
+    }
+    region.startPos += frame;
+    if (complement) {
+        region.startPos = part.endPos() - region.endPos();
+    } else {
+        region.startPos += part.startPos;
+    }
+}
+
+SmithWatermanAlgorithm * SWBulkSearchTask::createAlgorithm(SW_AlgType type, TaskStateInfo &ti) const {
+    SmithWatermanAlgorithm *sw = NULL;
+    QString realizationName;
+    switch (type) {
+        case SW_sse2:
+#ifdef SW2_BUILD_WITH_SSE2
+            sw = new SmithWatermanAlgorithmSSE2;
+#endif
+            realizationName = "SSE2";
+            break;
+        case SW_cuda:
+#ifdef SW2_BUILD_WITH_CUDA
+            sw = new SmithWatermanAlgorithmCUDA;
+#endif
+            realizationName = "CUDA";
+            break;
+        case SW_opencl:
+#ifdef SW2_BUILD_WITH_OPENCL
+            sw = new SmithWatermanAlgorithmOPENCL;
+#endif
+            realizationName = "OPENCL";
+            break;
+        default:
+            assert(SW_classic == type);
+            sw = new SmithWatermanAlgorithm;
+    }
+    CHECK_EXT(NULL != sw, ti.setError(tr("%1 was not enabled in this build").arg(realizationName)), NULL);
+    return sw;
+}
+
+void SWBulkSearchTask::run() {
+    quint64 startTime = GTimer::currentTimeMicros();
+    foreach (SWBulkSearch *search, searches) {
+        CHECK(!stateInfo.isCoR(), );
+        SmithWatermanResultListener *listener = search->config.resultListener;
+        CHECK_OPERATION(NULL != listener, continue);
+
+        QList<SmithWatermanResult> results = toResults(search);
+        if (NULL != search->config.resultFilter) {
+            search->config.resultFilter->applyFilter(&results);
+        }
+        listener->pushResult(results); /* push results after filters */
+    }
+    perfLog.details(QString("\n%1 postprocessing time is %2\n").arg(getTaskName()).arg(GTimer::secsBetween(startTime, GTimer::currentTimeMicros())));
+}
+
+QList<SmithWatermanResult> SWBulkSearchTask::toResults(const SWBulkSearch *search) const {
+    QList<SmithWatermanResult> results;
+    foreach (const PairAlignSequences &hit, search->heap.getHits()) {
+        SmithWatermanResult r;
+        r.strand = hit.isDNAComplemented ? U2Strand::Complementary : U2Strand::Direct;
+        r.trans = hit.isAminoTranslated;
+        r.refSubseq = hit.refSubseqInterval;
+        r.isJoined = false;
+        r.ptrnSubseq = hit.ptrnSubseqInterval;
+        r.score = hit.score;
+        r.pairAlignment = hit.pairAlignment;
+        results << r;
+    }
+    return results;
+}
+
+Task::ReportResult SWBulkSearchTask::report() {
+    if (NULL != cudaGpu) {
+        cudaGpu->setAcquired(false);
+    }
+#ifdef SW2_BUILD_WITH_OPENCL
+    if (NULL != openClGpu) {
+        openClGpu->setAcquired(false);
+    }
+#endif
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    int resultsNum = 0;
+    foreach (SWBulkSearch *search, searches) {
+        SmithWatermanResultListener *listener = search->config.resultListener;
+        CHECK_OPERATION(NULL != listener, continue);
+        const QList<SmithWatermanResult> results = listener->getResults();
+        resultsNum += results.size();
+
+        SmithWatermanReportCallback *rcb = search->config.resultCallback;
+        CHECK_OPERATION(NULL != rcb, continue);
+        const QString error = rcb->report(results);
+        CHECK_EXT(error.isEmpty(), setError(error), ReportResult_Finished);
+    }
+    algoLog.details(tr("%1 results found").arg(resultsNum));
+
+    return ReportResult_Finished;
+}
+
+/************************************************************************/
+/* SWBulkSearchSubtask */
+/************************************************************************/
+SWBulkSearchSubtask::SWBulkSearchSubtask(SWBulkSearchTask *_parentTask)
+    : Task(tr("Smith-Waterman bulk search thread"), TaskFlag_None), parentTask(_parentTask)
+{
+
+}
+
+void SWBulkSearchSubtask::run() {
+    SWBulkWorkItem item;
+    while (!stateInfo.isCoR() && parentTask->takeWorkItem(item)) {
+        parentTask->processWorkItem(item, stateInfo);
+    }
+}
+
+}   // namespace U2
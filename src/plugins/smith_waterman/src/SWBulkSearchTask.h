@@ -0,0 +1,150 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_SW_BULK_SEARCH_TASK_H_
+#define _U2_SW_BULK_SEARCH_TASK_H_
+
+#include <U2Core/Task.h>
+#include <U2Algorithm/SmithWatermanSettings.h>
+
+#include "SWAlgorithmTask.h"
+#include "PairAlignSequences.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+
+namespace U2 {
+
+/* Keeps the best hits of one search. Hits found twice in the overlapping parts of the sequence are stored once */
+class SWBulkResultHeap {
+public:
+    /* @capacity is the number of hits to keep, 0 means all of them */
+    SWBulkResultHeap(int capacity);
+
+    void push(const PairAlignSequences &hit);
+    bool isFull() const;
+    /* the lowest score among the kept hits */
+    int getLowestScore() const;
+    /* kept hits sorted by score, the best first */
+    QList<PairAlignSequences> getHits() const;
+
+private:
+    typedef QPair<qint64, qint64> HitKey;
+    static HitKey getKey(const PairAlignSequences &hit);
+
+    int capacity;
+    QHash<HitKey, PairAlignSequences> hits;
+    QMultiMap<int, HitKey> scores;
+};
+
+/* One pattern searched in one sequence */
+class SWBulkSearch {
+public:
+    SWBulkSearch(const SmithWatermanSettings &config, int maxResults, SW_AlgType algType);
+
+    int getMinScore();
+    /* keeps the hits in the heap and returns the new minimal score */
+    int addHits(const QList<PairAlignSequences> &hits);
+
+    SmithWatermanSettings config;
+    SW_AlgType algType;
+    int maxScore;
+    /* raised to the lowest kept score when the result heap is full */
+    int minScore;
+    SWBulkResultHeap heap;
+    QMutex lock;
+};
+
+/* A part of the sequence to be searched for a pattern */
+class SWBulkWorkItem {
+public:
+    SWBulkWorkItem();
+    SWBulkWorkItem(int searchId, const U2Region &region, bool complement);
+
+    int searchId;
+    U2Region region;
+    bool complement;
+};
+
+/*
+ * Searches several patterns in several sequences with a fixed number of threads.
+ * Every search is cut into parts, the parts of all searches are taken from a shared queue
+ * by SWBulkSearchSubtask. Each search keeps only its best @maxResults hits (0 - all the hits)
+ * and skips weaker hits once it has enough of them.
+ * Result listeners and callbacks of the searches are owned by the task.
+ */
+class SWBulkSearchTask : public Task {
+    Q_OBJECT
+public:
+    SWBulkSearchTask(const QList<SmithWatermanSettings> &configs, int maxResults, const QString &taskName, SW_AlgType algType);
+    ~SWBulkSearchTask();
+
+    void prepare();
+    void run();
+    ReportResult report();
+
+    bool takeWorkItem(SWBulkWorkItem &item);
+    void processWorkItem(const SWBulkWorkItem &item, TaskStateInfo &ti);
+
+    /*
+     * Converts the hit coordinates in the searched part to the sequence coordinates.
+     * A complement part is reversed, a translated part is searched from the @frame nucleotide
+     */
+    static void toSequenceCoordinates(PairAlignSequences &hit, const U2Region &part, bool complement, int frame, bool translated);
+
+private:
+    void initWorkItems(SWBulkSearch *search, int searchId);
+    void addMemoryResource();
+    SmithWatermanAlgorithm * createAlgorithm(SW_AlgType type, TaskStateInfo &ti) const;
+    QList<SmithWatermanResult> toResults(const SWBulkSearch *search) const;
+
+    SW_AlgType algType;
+    int nThreads;
+    double computationMatrixSquare;
+    QList<SWBulkSearch *> searches;
+
+    QList<SWBulkWorkItem> workItems;
+    int nextWorkItem;
+    QMutex workItemsLock;
+
+    /* the longest part and the longest pattern, used to estimate memory */
+    qint64 maxPartLength;
+    int longestSearchId;
+
+    CudaGpuModel *cudaGpu;
+    OpenCLGpuModel *openClGpu;
+};
+
+class SWBulkSearchSubtask : public Task {
+    Q_OBJECT
+public:
+    SWBulkSearchSubtask(SWBulkSearchTask *parentTask);
+
+    void run();
+
+private:
+    SWBulkSearchTask *parentTask;
+};
+
+}   // namespace U2
+
+#endif  // _U2_SW_BULK_SEARCH_TASK_H_
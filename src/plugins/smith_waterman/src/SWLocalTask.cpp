@@ -0,0 +1,367 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <U2Core/AppContext.h>
+#include <U2Core/DNATranslation.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Algorithm/SmithWatermanReportCallback.h>
+#include <U2Algorithm/SmithWatermanTaskFactoryRegistry.h>
+#include <U2Algorithm/SubstMatrixRegistry.h>
+#include <U2Algorithm/SWResultFilterRegistry.h>
+
+#include <U2Remote/LocalTaskDistribution.h>
+
+#include "SWAlgorithmTask.h"
+#include "SWLocalTask.h"
+
+namespace U2 {
+
+namespace {
+
+/* a part must be several times longer than the overlap, otherwise the same columns are computed twice */
+const qint64 MIN_PART_TO_OVERLAP_RATIO = 4;
+
+bool resultPositionLessThan(const SmithWatermanResult &r1, const SmithWatermanResult &r2) {
+    if (r1.refSubseq.startPos != r2.refSubseq.startPos) {
+        return r1.refSubseq.startPos < r2.refSubseq.startPos;
+    }
+    if (r1.refSubseq.length != r2.refSubseq.length) {
+        return r1.refSubseq.length < r2.refSubseq.length;
+    }
+    if (r1.strand.getDirectionValue() != r2.strand.getDirectionValue()) {
+        return r1.strand.getDirectionValue() < r2.strand.getDirectionValue();
+    }
+    if (r1.ptrnSubseq.startPos != r2.ptrnSubseq.startPos) {
+        return r1.ptrnSubseq.startPos < r2.ptrnSubseq.startPos;
+    }
+    if (r1.ptrnSubseq.length != r2.ptrnSubseq.length) {
+        return r1.ptrnSubseq.length < r2.ptrnSubseq.length;
+    }
+    return r1.trans < r2.trans;
+}
+
+bool isSamePosition(const SmithWatermanResult &r1, const SmithWatermanResult &r2) {
+    return !resultPositionLessThan(r1, r2) && !resultPositionLessThan(r2, r1);
+}
+
+QVariant serializeResult(const SmithWatermanResult &r) {
+    QVariantList data;
+    data << r.strand.getDirectionValue() << r.trans << r.score
+         << r.refSubseq.startPos << r.refSubseq.length
+         << r.isJoined << r.refJoinedSubseq.startPos << r.refJoinedSubseq.length
+         << r.ptrnSubseq.startPos << r.ptrnSubseq.length
+         << r.pairAlignment;
+    return data;
+}
+
+bool deserializeResult(const QVariant &data, SmithWatermanResult &r) {
+    CHECK(data.canConvert(QVariant::List), false);
+    const QVariantList list = data.toList();
+    CHECK(11 == list.size(), false);
+    r.strand = U2Strand(static_cast<U2Strand::Direction>(list[0].toInt()));
+    r.trans = list[1].toBool();
+    r.score = list[2].toFloat();
+    r.refSubseq = U2Region(list[3].toLongLong(), list[4].toLongLong());
+    r.isJoined = list[5].toBool();
+    r.refJoinedSubseq = U2Region(list[6].toLongLong(), list[7].toLongLong());
+    r.ptrnSubseq = U2Region(list[8].toLongLong(), list[9].toLongLong());
+    r.pairAlignment = list[10].toByteArray();
+    return true;
+}
+
+}
+
+/************************************************************************/
+/* SmithWatermanLocalTaskSettings */
+/************************************************************************/
+SmithWatermanLocalTaskSettings::SmithWatermanLocalTaskSettings()
+    : sequenceOffset(0)
+{
+
+}
+
+SmithWatermanLocalTaskSettings::SmithWatermanLocalTaskSettings(const SmithWatermanSettings &_settings, const QString &_realizationId)
+    : settings(_settings), realizationId(_realizationId), sequenceOffset(0)
+{
+    if (NULL != settings.resultFilter) {
+        filterId = settings.resultFilter->getId();
+    }
+    settings.resultListener = NULL;
+    settings.resultFilter = NULL;
+    settings.resultCallback = NULL;
+}
+
+QVariant SmithWatermanLocalTaskSettings::serialize() const {
+    QVariantMap data;
+    data["pattern"] = settings.ptrn;
+    data["sequence"] = settings.sqnc;
+    data["circular"] = settings.searchCircular;
+    data["regionStart"] = settings.globalRegion.startPos;
+    data["regionLength"] = settings.globalRegion.length;
+    data["strand"] = static_cast<int>(settings.strand);
+    data["percentOfScore"] = settings.percentOfScore;
+    data["gapOpen"] = settings.gapModel.scoreGapOpen;
+    data["gapExtension"] = settings.gapModel.scoreGapExtd;
+    data["matrix"] = settings.pSm.getName();
+    data["complementTranslation"] = (NULL == settings.complTT) ? QString() : settings.complTT->getTranslationId();
+    data["aminoTranslation"] = (NULL == settings.aminoTT) ? QString() : settings.aminoTT->getTranslationId();
+    data["resultView"] = static_cast<int>(settings.resultView);
+    data["includePatternContent"] = settings.includePatternContent;
+    data["filter"] = filterId;
+    data["realization"] = realizationId;
+    data["sequenceOffset"] = sequenceOffset;
+    return data;
+}
+
+bool SmithWatermanLocalTaskSettings::deserialize(const QVariant &data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    const QVariantMap map = data.toMap();
+
+    settings.ptrn = map["pattern"].toByteArray();
+    settings.sqnc = map["sequence"].toByteArray();
+    settings.searchCircular = map["circular"].toBool();
+    settings.globalRegion = U2Region(map["regionStart"].toLongLong(), map["regionLength"].toLongLong());
+    settings.strand = static_cast<StrandOption>(map["strand"].toInt());
+    settings.percentOfScore = map["percentOfScore"].toFloat();
+    settings.gapModel.scoreGapOpen = map["gapOpen"].toInt();
+    settings.gapModel.scoreGapExtd = map["gapExtension"].toInt();
+    settings.resultView = static_cast<SmithWatermanSettings::SWResultView>(map["resultView"].toInt());
+    settings.includePatternContent = map["includePatternContent"].toBool();
+    filterId = map["filter"].toString();
+    realizationId = map["realization"].toString();
+    sequenceOffset = map["sequenceOffset"].toLongLong();
+
+    settings.pSm = AppContext::getSubstMatrixRegistry()->getMatrix(map["matrix"].toString());
+    CHECK(!settings.pSm.isEmpty(), false);
+
+    DNATranslationRegistry *translationRegistry = AppContext::getDNATranslationRegistry();
+    const QString complementId = map["complementTranslation"].toString();
+    if (!complementId.isEmpty()) {
+        settings.complTT = translationRegistry->lookupTranslation(complementId);
+        CHECK(NULL != settings.complTT, false);
+    }
+    const QString aminoId = map["aminoTranslation"].toString();
+    if (!aminoId.isEmpty()) {
+        settings.aminoTT = translationRegistry->lookupTranslation(aminoId);
+        CHECK(NULL != settings.aminoTT, false);
+    }
+    return true;
+}
+
+/************************************************************************/
+/* SmithWatermanLocalTaskResult */
+/************************************************************************/
+QVariant SmithWatermanLocalTaskResult::serialize() const {
+    QVariantList serializedResults;
+    foreach (const SmithWatermanResult &r, results) {
+        serializedResults << serializeResult(r);
+    }
+    QVariantMap data;
+    data["filter"] = filterId;
+    data["results"] = serializedResults;
+    return data;
+}
+
+bool SmithWatermanLocalTaskResult::deserialize(const QVariant &data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    const QVariantMap map = data.toMap();
+    filterId = map["filter"].toString();
+    results.clear();
+    foreach (const QVariant &serializedResult, map["results"].toList()) {
+        SmithWatermanResult r;
+        CHECK(deserializeResult(serializedResult, r), false);
+        results << r;
+    }
+    return true;
+}
+
+/************************************************************************/
+/* SmithWatermanLocalTask */
+/************************************************************************/
+SmithWatermanLocalTask::SmithWatermanLocalTask(const SmithWatermanLocalTaskSettings &_settings)
+    : LocalTask(tr("Smith-Waterman search in a sequence part"), TaskFlags_NR_FOSE_COSC),
+      settings(_settings), listener(NULL), searchTask(NULL)
+{
+    result.filterId = settings.filterId;
+}
+
+void SmithWatermanLocalTask::prepare() {
+    SmithWatermanTaskFactory *factory = AppContext::getSmithWatermanTaskFactoryRegistry()->getFactory(settings.realizationId);
+    CHECK_EXT(NULL != factory, setError(tr("Unknown Smith-Waterman realization: %1").arg(settings.realizationId)), );
+
+    SmithWatermanSettings searchSettings = settings.settings;
+    listener = new SmithWatermanResultListener();
+    searchSettings.resultListener = listener; // deleted by the search task
+    if (!settings.filterId.isEmpty()) {
+        searchSettings.resultFilter = AppContext::getSWResultFilterRegistry()->getFilter(settings.filterId);
+    }
+    searchTask = factory->getTaskInstance(searchSettings, getTaskName());
+    addSubTask(searchTask);
+}
+
+QList<Task *> SmithWatermanLocalTask::onSubTaskFinished(Task *subTask) {
+    QList<Task *> res;
+    CHECK(subTask == searchTask, res);
+    CHECK_OP(stateInfo, res);
+
+    foreach (SmithWatermanResult r, listener->getResults()) {
+        r.refSubseq.startPos += settings.sequenceOffset;
+        result.results << r;
+    }
+    return res;
+}
+
+const LocalTaskResult * SmithWatermanLocalTask::getResult() const {
+    return hasError() ? NULL : &result;
+}
+
+/************************************************************************/
+/* SmithWatermanTaskDistributor */
+/************************************************************************/
+QList<SmithWatermanLocalTaskSettings *> SmithWatermanTaskDistributor::scatterParts(const SmithWatermanLocalTaskSettings *settings, int partCount) const {
+    const SmithWatermanSettings &s = settings->settings;
+    const U2Region region = s.globalRegion;
+
+    const int maxScore = SWAlgorithmTask::calculateMaxScore(s.ptrn, s.pSm);
+    int minScore = (maxScore * s.percentOfScore) / 100;
+    if ((maxScore * (int)s.percentOfScore) % 100 != 0) {
+        minScore += 1;
+    }
+    const qint64 overlap = SWAlgorithmTask::calculateMatrixLength(s.sqnc.length(),
+        s.ptrn.length() * (NULL == s.aminoTT ? 1 : 3),
+        s.gapModel.scoreGapOpen,
+        s.gapModel.scoreGapExtd,
+        maxScore,
+        minScore);
+
+    qint64 parts = s.searchCircular ? 1 : qMax(1, partCount); // the joined results are not cut
+    parts = qMin(parts, qMax<qint64>(1, region.length / (MIN_PART_TO_OVERLAP_RATIO * overlap)));
+
+    QList<SmithWatermanLocalTaskSettings *> result;
+    if (1 == parts) {
+        result << new SmithWatermanLocalTaskSettings(*settings);
+        return result;
+    }
+
+    const qint64 partLength = (region.length + overlap * (parts - 1) + parts - 1) / parts;
+    for (qint64 i = 0; i < parts; i++) {
+        const qint64 start = region.startPos + i * (partLength - overlap);
+        const qint64 end = (i == parts - 1) ? region.endPos() : qMin(region.endPos(), start + partLength);
+
+        SmithWatermanLocalTaskSettings *part = new SmithWatermanLocalTaskSettings(*settings);
+        part->settings.sqnc = s.sqnc.mid(start, end - start);
+        part->settings.globalRegion = U2Region(0, end - start);
+        part->sequenceOffset = settings->sequenceOffset + start;
+        result << part;
+    }
+    return result;
+}
+
+SmithWatermanLocalTaskResult * SmithWatermanTaskDistributor::gatherParts(const QList<const SmithWatermanLocalTaskResult *> &results) const {
+    SmithWatermanLocalTaskResult *gathered = new SmithWatermanLocalTaskResult();
+    foreach (const SmithWatermanLocalTaskResult *part, results) {
+        gathered->results << part->results;
+        gathered->filterId = part->filterId;
+    }
+
+    // the alignments lying in the overlaps are found by both neighbouring parts
+    QList<SmithWatermanResult> &list = gathered->results;
+    qStableSort(list.begin(), list.end(), resultPositionLessThan);
+    QList<SmithWatermanResult> unique;
+    foreach (const SmithWatermanResult &r, list) {
+        if (unique.isEmpty() || !isSamePosition(unique.last(), r)) {
+            unique << r;
+        }
+    }
+    list = unique;
+
+    // the parts are filtered separately, so the alignments crossing the parts' borders have not been compared yet
+    if (!gathered->filterId.isEmpty()) {
+        SmithWatermanResultFilter *filter = AppContext::getSWResultFilterRegistry()->getFilter(gathered->filterId);
+        if (NULL != filter) {
+            filter->applyFilter(&list);
+        }
+    }
+    return gathered;
+}
+
+/************************************************************************/
+/* SmithWatermanLocalTaskFactory */
+/************************************************************************/
+const QString SmithWatermanLocalTaskFactory::ID("Smith-Waterman");
+
+SmithWatermanLocalTaskFactory::SmithWatermanLocalTaskFactory()
+    : LocalTaskFactoryTemplate<SmithWatermanLocalTask, SmithWatermanLocalTaskSettings, SmithWatermanLocalTaskResult, SmithWatermanTaskDistributor>(ID)
+{
+
+}
+
+/************************************************************************/
+/* SWMultiProcessTask */
+/************************************************************************/
+SWMultiProcessTask::SWMultiProcessTask(const SmithWatermanSettings &_settings, const QString &taskName, const QString &_realizationId)
+    : Task(taskName, TaskFlags_NR_FOSE_COSC), settings(_settings), realizationId(_realizationId), distributionTask(NULL)
+{
+
+}
+
+SWMultiProcessTask::~SWMultiProcessTask() {
+    delete settings.resultListener;
+    delete settings.resultCallback;
+    // we do not delete resultFilter here, because filters are stored in special registry
+}
+
+void SWMultiProcessTask::prepare() {
+    distributionTask = new LocalTaskDistributionTask(SmithWatermanLocalTaskFactory::ID, new SmithWatermanLocalTaskSettings(settings, realizationId));
+    addSubTask(distributionTask);
+}
+
+Task::ReportResult SWMultiProcessTask::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    const SmithWatermanLocalTaskResult *result = dynamic_cast<const SmithWatermanLocalTaskResult *>(distributionTask->getResult());
+    CHECK_EXT(NULL != result, setError(tr("Smith-Waterman search results have not been received from the worker processes")), ReportResult_Finished);
+
+    settings.resultListener->pushResult(result->results);
+    algoLog.details(tr("%1 results found").arg(result->results.size()));
+
+    if (NULL != settings.resultCallback) {
+        const QString error = settings.resultCallback->report(result->results);
+        if (!error.isEmpty()) {
+            stateInfo.setError(error);
+        }
+    }
+    return ReportResult_Finished;
+}
+
+/************************************************************************/
+/* SWMultiProcessTaskFactory */
+/************************************************************************/
+const QString SWMultiProcessTaskFactory::ID("Multiprocess");
+
+Task * SWMultiProcessTaskFactory::getTaskInstance(const SmithWatermanSettings &config, const QString &taskName) const {
+    const QString realizationId = (NULL != AppContext::getSmithWatermanTaskFactoryRegistry()->getFactory("SSE2")) ? "SSE2" : "Classic 2";
+    return new SWMultiProcessTask(config, taskName, realizationId);
+}
+
+} // namespace
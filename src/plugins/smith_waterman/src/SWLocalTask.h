@@ -0,0 +1,118 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_SW_LOCAL_TASK_H_
+#define _U2_SW_LOCAL_TASK_H_
+
+#include <U2Algorithm/SmithWatermanSettings.h>
+#include <U2Algorithm/SmithWatermanTaskFactory.h>
+
+#include <U2Remote/LocalTask.h>
+#include <U2Remote/TaskDistributor.h>
+
+namespace U2 {
+
+class LocalTaskDistributionTask;
+
+/* Settings of a search in a part of the sequence. The sequence is cut to the part */
+class SmithWatermanLocalTaskSettings : public LocalTaskSettings {
+public:
+    SmithWatermanLocalTaskSettings();
+    SmithWatermanLocalTaskSettings(const SmithWatermanSettings &settings, const QString &realizationId);
+
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant &data);
+
+    /* listener, callback and filter are not set */
+    SmithWatermanSettings settings;
+    QString filterId;
+    /* SmithWatermanTaskFactoryRegistry id of the algorithm to run in the worker */
+    QString realizationId;
+    /* position of the part in the original sequence */
+    qint64 sequenceOffset;
+};
+
+class SmithWatermanLocalTaskResult : public LocalTaskResult {
+public:
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant &data);
+
+    QList<SmithWatermanResult> results;
+    QString filterId;
+};
+
+class SmithWatermanLocalTask : public LocalTask {
+    Q_OBJECT
+public:
+    SmithWatermanLocalTask(const SmithWatermanLocalTaskSettings &settings);
+
+    void prepare();
+    QList<Task *> onSubTaskFinished(Task *subTask);
+    const LocalTaskResult * getResult() const;
+
+private:
+    SmithWatermanLocalTaskSettings settings;
+    SmithWatermanResultListener *listener;
+    Task *searchTask;
+    SmithWatermanLocalTaskResult result;
+};
+
+/* Cuts the searched region into overlapping parts. Results found twice in the overlaps are removed by the result filter */
+class SmithWatermanTaskDistributor : public TaskDistributorTemplate<SmithWatermanLocalTaskSettings, SmithWatermanLocalTaskResult> {
+protected:
+    QList<SmithWatermanLocalTaskSettings *> scatterParts(const SmithWatermanLocalTaskSettings *settings, int partCount) const;
+    SmithWatermanLocalTaskResult * gatherParts(const QList<const SmithWatermanLocalTaskResult *> &results) const;
+};
+
+class SmithWatermanLocalTaskFactory : public LocalTaskFactoryTemplate<SmithWatermanLocalTask, SmithWatermanLocalTaskSettings,
+                                                                      SmithWatermanLocalTaskResult, SmithWatermanTaskDistributor> {
+public:
+    SmithWatermanLocalTaskFactory();
+
+    static const QString ID;
+};
+
+/* Search that runs the parts of the sequence in separate UGENE processes, the results are reported as SWAlgorithmTask does */
+class SWMultiProcessTask : public Task {
+    Q_OBJECT
+public:
+    SWMultiProcessTask(const SmithWatermanSettings &settings, const QString &taskName, const QString &realizationId);
+    ~SWMultiProcessTask();
+
+    void prepare();
+    ReportResult report();
+
+private:
+    SmithWatermanSettings settings;
+    QString realizationId;
+    LocalTaskDistributionTask *distributionTask;
+};
+
+class SWMultiProcessTaskFactory : public SmithWatermanTaskFactory {
+public:
+    virtual Task * getTaskInstance(const SmithWatermanSettings &config, const QString &taskName) const;
+
+    static const QString ID;
+};
+
+} // namespace
+
+#endif // _U2_SW_LOCAL_TASK_H_
@@ -21,6 +21,8 @@
 
 #include "SWTaskFactory.h"
 #include "SWAlgorithmTask.h"
+#include "SWBulkSearchTask.h"
+#include "PairwiseAlignmentNeedlemanWunschTask.h"
 
 #include <U2Core/GUrl.h>
 #include <U2Core/AppContext.h>
@@ -44,6 +46,14 @@ Task* SWTaskFactory::getTaskInstance( const SmithWatermanSettings& config, const
     return new SWAlgorithmTask(config, taskName, algType);
 }
 
+Task* SWTaskFactory::getBulkTaskInstance(const QList<SmithWatermanSettings>& configs, int maxResults, const QString& taskName) const {
+    foreach (const SmithWatermanSettings& config, configs) {
+        // circular search is supported by SequenceWalkerTask only
+        CHECK(!config.searchCircular, NULL);
+    }
+    return new SWBulkSearchTask(configs, maxResults, taskName, algType);
+}
+
 bool SWTaskFactory::isValidParameters(const SmithWatermanSettings& sWatermanConfig,  SequenceWalkerSubtask* t) const {
     Q_UNUSED(sWatermanConfig);
     Q_UNUSED(t);
@@ -89,4 +99,25 @@ AbstractAlignmentTask* PairwiseAlignmentSmithWatermanTaskFactory::getTaskInstanc
     return NULL;
 }
 
+PairwiseAlignmentNeedlemanWunschTaskFactory::PairwiseAlignmentNeedlemanWunschTaskFactory(SW_AlgType _algType) :
+    AbstractAlignmentTaskFactory(), algType(_algType) {
+}
+
+PairwiseAlignmentNeedlemanWunschTaskFactory::~PairwiseAlignmentNeedlemanWunschTaskFactory() {
+}
+
+AbstractAlignmentTask* PairwiseAlignmentNeedlemanWunschTaskFactory::getTaskInstance(AbstractAlignmentTaskSettings* _settings) const {
+    PairwiseAlignmentTaskSettings* pairwiseSettings = dynamic_cast<PairwiseAlignmentTaskSettings*>(_settings);
+    SAFE_POINT(pairwiseSettings != NULL,
+        "Pairwise alignment: incorrect settings", NULL);
+    PairwiseAlignmentNeedlemanWunschTaskSettings* settings = new PairwiseAlignmentNeedlemanWunschTaskSettings(*pairwiseSettings);
+    SAFE_POINT(false == settings->inNewWindow || false == settings->resultFileName.isEmpty(),
+               "Pairwise alignment: incorrect settings, empty output file name", NULL);
+    if (settings->convertCustomSettings()) {
+        return new PairwiseAlignmentNeedlemanWunschTask(settings, algType);
+    }
+    delete settings;
+    return NULL;
+}
+
 } // namespace
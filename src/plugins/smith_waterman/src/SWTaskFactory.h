@@ -43,6 +43,7 @@ public:
     SWTaskFactory(SW_AlgType _algType);
     virtual ~SWTaskFactory();
     virtual Task* getTaskInstance(const SmithWatermanSettings& config, const QString& taskName) const;
+    virtual Task* getBulkTaskInstance(const QList<SmithWatermanSettings>& configs, int maxResults, const QString& taskName) const;
 
 private:
     bool isValidParameters(const SmithWatermanSettings& sWatermanConfig,  SequenceWalkerSubtask* t) const;      //not realized
@@ -61,6 +62,17 @@ private:
     SW_AlgType algType;
 };
 
+class PairwiseAlignmentNeedlemanWunschTaskFactory : public AbstractAlignmentTaskFactory {         //for pairwise alignment only
+public:
+    PairwiseAlignmentNeedlemanWunschTaskFactory(SW_AlgType _algType);
+    virtual ~PairwiseAlignmentNeedlemanWunschTaskFactory();
+
+    virtual AbstractAlignmentTask* getTaskInstance(AbstractAlignmentTaskSettings* settings) const;
+
+private:
+    SW_AlgType algType;
+};
+
 } // namespace
 
 #endif // _U2_SMITH_WATERMAN_ALG_IMPL_H_
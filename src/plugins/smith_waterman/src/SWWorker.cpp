@@ -77,6 +77,7 @@ static const QString GAPOPEN_ATTR("gap-open-score");
 static const QString GAPEXT_ATTR("gap-ext-score");
 static const QString USE_PATTERN_NAME_ATTR("use-pattern-names");
 static const QString PATTERN_NAME_QUAL_ATTR("pattern-name-qual");
+static const QString MAX_HITS_ATTR("max-hits");
 
 const QString SWWorkerFactory::ACTOR_ID("ssearch");
 
@@ -178,6 +179,12 @@ void SWWorkerFactory::init() {
                         SWWorker::tr("Name of qualifier in result annotations which is containing "
                         "a pattern name."));
 
+        Descriptor mhd(MAX_HITS_ATTR,
+                       SWWorker::tr("Max Hits per Pattern"),
+                       SWWorker::tr("Keeps only the given number of best scored regions found for each pattern"
+                       " in a sequence. Weaker regions are not searched for once enough regions are found."
+                       " 0 means that all the regions are kept."));
+
         a << new Attribute(mxd, BaseTypes::STRING_TYPE(), true, QString("Auto"));
         a << new Attribute(ald, BaseTypes::STRING_TYPE(), true);
         a << new Attribute(frd, BaseTypes::STRING_TYPE(), false, filterLst.isEmpty() ? QString() : filterLst.first());
@@ -189,6 +196,7 @@ void SWWorkerFactory::init() {
         a << new Attribute(pnd, BaseTypes::BOOL_TYPE(), false, true);
         a << new Attribute(nd, BaseTypes::STRING_TYPE(), false, "misc_feature");
         a << new Attribute(patternNameQualifier, BaseTypes::STRING_TYPE(), false, "pattern_name");
+        a << new Attribute(mhd, BaseTypes::NUM_TYPE(), false, 0);
     }
 
     Descriptor desc(ACTOR_ID,
@@ -205,6 +213,10 @@ void SWWorkerFactory::init() {
         QVariantMap m; m["minimum"] = 1; m["maximum"] = 100; m["suffix"] = "%";
         delegates[SCORE_ATTR] = new SpinBoxDelegate(m);
     }
+    {
+        QVariantMap m; m["minimum"] = 0; m["maximum"] = INT_MAX;
+        delegates[MAX_HITS_ATTR] = new SpinBoxDelegate(m);
+    }
     {
         QVariantMap m; m["maximum"] = -0.; m["minimum"]=-10000000.;
         delegates[GAPOPEN_ATTR] = new DoubleSpinBoxDelegate(m);
@@ -480,7 +492,8 @@ Task* SWWorker::tick() {
             algoLog.error(tr("Incorrect value: search pattern, pattern is empty"));
             return new FailTask(tr("Incorrect value: search pattern, pattern is empty"));
         }
-        QList<Task*> subs;
+        QList<SmithWatermanSettings> configs;
+        QList<SmithWatermanReportCallbackAnnotImpl*> rcbs;
         foreach(QByteArray p, patternList) {
             if(!cfg.pSm.getAlphabet()->containsAll(p.constData(), p.length())) {
                 algoLog.error(tr("Incorrect value: pattern alphabet doesn't match sequence alphabet "));
@@ -499,16 +512,25 @@ Task* SWWorker::tick() {
             config.resultCallback = rcb;
             config.resultListener = new SmithWatermanResultListener();
 
-            Task * swTask = algo->getTaskInstance(config, tr("smith_waterman_task"));
-            callbacks.insert(swTask, rcb);
-            patterns.insert(swTask, config.ptrn);
-            subs << swTask;
+            patterns.insert(rcb, config.ptrn);
+            rcbs << rcb;
+            configs << config;
         }
-        assert(!subs.isEmpty());
-
-        MultiTask * multiSw = new MultiTask(tr("Smith waterman subtasks"), subs);
-        connect(new TaskSignalMapper(multiSw), SIGNAL(si_taskFinished(Task*)), SLOT(sl_taskFinished(Task*)));
-        return multiSw;
+        assert(!configs.isEmpty());
+
+        // all the patterns are searched by a single task if the algorithm supports it
+        const int maxHits = actor->getParameter(MAX_HITS_ATTR)->getAttributeValue<int>(context);
+        Task * swTask = algo->getBulkTaskInstance(configs, maxHits, tr("smith_waterman_task"));
+        if (NULL == swTask) {
+            QList<Task*> subs;
+            foreach(const SmithWatermanSettings &config, configs) {
+                subs << algo->getTaskInstance(config, tr("smith_waterman_task"));
+            }
+            swTask = new MultiTask(tr("Smith waterman subtasks"), subs);
+        }
+        callbacks.insert(swTask, rcbs);
+        connect(new TaskSignalMapper(swTask), SIGNAL(si_taskFinished(Task*)), SLOT(sl_taskFinished(Task*)));
+        return swTask;
     } else if (input->isEnded()) {
         setDone();
         output->setEnded();
@@ -518,31 +540,36 @@ Task* SWWorker::tick() {
 
 void SWWorker::sl_taskFinished(Task* t) {
     QList<SharedAnnotationData> annData;
-    MultiTask * multiSw = qobject_cast<MultiTask*>(t);
     SAFE_POINT(NULL != t, "Invalid task is encountered",);
-    QList<Task*> subs = multiSw->getTasks();
-    SAFE_POINT(!subs.isEmpty(), "Invalid task is encountered",);
+    const QList<SmithWatermanReportCallbackAnnotImpl*> rcbs = callbacks.take(t);
+    SAFE_POINT(!rcbs.isEmpty(), "Invalid task is encountered",);
+    bool canceled = t->isCanceled();
+    // the per-pattern subtasks of the fallback can be canceled without their parent
+    MultiTask * multiSw = qobject_cast<MultiTask*>(t);
+    if (NULL != multiSw) {
+        foreach(Task * sub, multiSw->getTasks()) {
+            SAFE_POINT(NULL != sub, "Invalid task is encountered",);
+            canceled = canceled || sub->isCanceled();
+        }
+    }
     QStringList ptrns;
-    foreach(Task * sub, subs) {
-        SAFE_POINT(NULL != sub, "Invalid task is encountered",);
-        if (sub->isCanceled()) {
-            return;
+    foreach(SmithWatermanReportCallbackAnnotImpl* rcb, rcbs) {
+        SAFE_POINT(NULL != rcb, "Invalid task is encountered",);
+        const QString pattern = patterns.take(rcb);
+        if (canceled) {
+            continue;
         }
-        SmithWatermanReportCallbackAnnotImpl* rcb = callbacks.take(sub);
-        assert(rcb != NULL);
-        if(rcb) {
-            // crop long names
-            const QString qualifierName = actor->getParameter(PATTERN_NAME_QUAL_ATTR)->getAttributeValue<QString>(context);
-            foreach(SharedAnnotationData a, rcb->getAnotations()) {
-                QString pattern = patterns.value(sub);
-                if(!patternNames[pattern].isEmpty()) {
-                    a->qualifiers.push_back(U2Qualifier(qualifierName, patternNames[pattern]));
-                }
-                annData << a;
+        // crop long names
+        const QString qualifierName = actor->getParameter(PATTERN_NAME_QUAL_ATTR)->getAttributeValue<QString>(context);
+        foreach(SharedAnnotationData a, rcb->getAnotations()) {
+            if(!patternNames[pattern].isEmpty()) {
+                a->qualifiers.push_back(U2Qualifier(qualifierName, patternNames[pattern]));
             }
+            annData << a;
         }
-        ptrns << patterns.value(sub);
+        ptrns << pattern;
     }
+    CHECK(!canceled, );
 
     assert(output != NULL);
     if (NULL != output) {
@@ -65,9 +65,9 @@ private slots:
 
 private:
     IntegralBus *input, *patternPort, *output;
-    QMap<Task*, SmithWatermanReportCallbackAnnotImpl*> callbacks;
+    QMap<Task*, QList<SmithWatermanReportCallbackAnnotImpl*> > callbacks;
     QList<QByteArray> patternList;
-    QMap<Task*, QByteArray> patterns;
+    QMap<SmithWatermanReportCallbackAnnotImpl*, QByteArray> patterns;
     QMap<QString, QString> patternNames;
 };
 
@@ -19,19 +19,31 @@
  * MA 02110-1301, USA.
  */
 
+#include "GlobalAlignmentAlgorithm.h"
+#include "GlobalAlignmentAlgorithmSSE2.h"
 #include "SmithWatermanTests.h"
+#include "SWBulkSearchTask.h"
+#include "SWLocalTask.h"
+
+#include <QtCore/QBuffer>
 
 #include <U2Core/DNASequenceObject.h>
 
 #include <U2Algorithm/SmithWatermanTaskFactoryRegistry.h>
 #include <U2Core/AppContext.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/DNATranslation.h>
+#include <U2Core/TextUtils.h>
 #include <U2Algorithm/SubstMatrixRegistry.h>
+#include <U2Algorithm/SWResultFilterRegistry.h>
 
 #include <U2Algorithm/SmithWatermanSettings.h>
 #include <U2Core/SequenceWalkerTask.h>
 #include <U2Core/SMatrix.h>
 #include <U2Core/U2SafePoints.h>
 
+#include <U2Remote/LocalTaskDistribution.h>
+
 
 #define FILE_SUBSTITUTION_MATRIX_ATTR "subst_f"
 #define FILE_FASTA_CONTAIN_SEQUENCE_ATTR "seq_f"
@@ -410,4 +422,653 @@ Task::ReportResult GTest_SmithWatermnanPerf::report() {
     return ReportResult_Finished;
 }
 
+static QVariant sendThroughChannel(const QVariant &message, U2OpStatus &os) {
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    CHECK_EXT(LocalTaskChannel::writeMessage(&device, message), os.setError("Can't write a message"), QVariant());
+    QByteArray buffer = device.data();
+    QVariant received;
+    CHECK_EXT(LocalTaskChannel::takeMessage(buffer, received), os.setError("Can't read the written message"), QVariant());
+    CHECK_EXT(buffer.isEmpty(), os.setError("The message is not read completely"), QVariant());
+    return received;
+}
+
+void GTest_SmithWatermanLocalTaskSerialization::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute("sub");
+}
+
+void GTest_SmithWatermanLocalTaskSerialization::run() {
+    SubstMatrixRegistry *matrixRegistry = AppContext::getSubstMatrixRegistry();
+    if (matrixName.isEmpty() && !matrixRegistry->getMatrixNames().isEmpty()) {
+        matrixName = matrixRegistry->getMatrixNames().first();
+    }
+    SmithWatermanSettings s;
+    s.pSm = matrixRegistry->getMatrix(matrixName);
+    CHECK_EXT(!s.pSm.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+    s.ptrn = "ACGTAC";
+    s.sqnc = "TTACGTACGGACGTTCAAC";
+    s.searchCircular = true;
+    s.globalRegion = U2Region(2, 15);
+    s.strand = StrandOption_Both;
+    s.percentOfScore = 87.5f;
+    s.gapModel.scoreGapOpen = -10;
+    s.gapModel.scoreGapExtd = -2;
+    s.resultView = SmithWatermanSettings::MULTIPLE_ALIGNMENT;
+    s.includePatternContent = true;
+
+    SmithWatermanLocalTaskSettings settings(s, "classic");
+    settings.filterId = "none";
+    settings.sequenceOffset = 100000;
+
+    SmithWatermanLocalTaskSettings restoredSettings;
+    CHECK_EXT(restoredSettings.deserialize(sendThroughChannel(settings.serialize(), stateInfo)), setError("Settings are not deserialized"), );
+    CHECK_OP(stateInfo, );
+    const SmithWatermanSettings &r = restoredSettings.settings;
+    CHECK_EXT(r.ptrn == s.ptrn && r.sqnc == s.sqnc, setError("Sequences are not restored"), );
+    CHECK_EXT(r.searchCircular == s.searchCircular && r.globalRegion == s.globalRegion && r.strand == s.strand, setError("Search region is not restored"), );
+    CHECK_EXT(r.percentOfScore == s.percentOfScore, setError("Score threshold is not restored"), );
+    CHECK_EXT(r.gapModel.scoreGapOpen == s.gapModel.scoreGapOpen && r.gapModel.scoreGapExtd == s.gapModel.scoreGapExtd, setError("Gap model is not restored"), );
+    CHECK_EXT(r.pSm.getName() == s.pSm.getName(), setError("Substitution matrix is not restored"), );
+    CHECK_EXT(NULL == r.complTT && NULL == r.aminoTT, setError("Translations are not restored"), );
+    CHECK_EXT(r.resultView == s.resultView && r.includePatternContent == s.includePatternContent, setError("Result view is not restored"), );
+    CHECK_EXT(restoredSettings.filterId == settings.filterId && restoredSettings.realizationId == settings.realizationId, setError("Filter or realization is not restored"), );
+    CHECK_EXT(restoredSettings.sequenceOffset == settings.sequenceOffset, setError("Sequence offset is not restored"), );
+
+    SmithWatermanLocalTaskResult result;
+    result.filterId = "none";
+    SmithWatermanResult first;
+    first.strand = U2Strand::Complementary;
+    first.trans = false;
+    first.score = 42.5f;
+    first.refSubseq = U2Region(100003, 6);
+    first.isJoined = true;
+    first.refJoinedSubseq = U2Region(0, 2);
+    first.ptrnSubseq = U2Region(0, 6);
+    first.pairAlignment = "dddudl";
+    SmithWatermanResult second = first;
+    second.strand = U2Strand::Direct;
+    second.trans = true;
+    second.isJoined = false;
+    second.refJoinedSubseq = U2Region();
+    second.pairAlignment.clear();
+    result.results << first << second;
+
+    SmithWatermanLocalTaskResult restoredResult;
+    CHECK_EXT(restoredResult.deserialize(sendThroughChannel(result.serialize(), stateInfo)), setError("Result is not deserialized"), );
+    CHECK_OP(stateInfo, );
+    CHECK_EXT(restoredResult.filterId == result.filterId, setError("Result filter is not restored"), );
+    CHECK_EXT(restoredResult.results.size() == result.results.size(), setError(QString("Results count: expected %1, actual %2").arg(result.results.size()).arg(restoredResult.results.size())), );
+    for (int i = 0; i < result.results.size(); i++) {
+        const SmithWatermanResult &expected = result.results[i];
+        const SmithWatermanResult &actual = restoredResult.results[i];
+        CHECK_EXT(expected.strand == actual.strand && expected.trans == actual.trans && expected.score == actual.score
+            && expected.refSubseq == actual.refSubseq && expected.isJoined == actual.isJoined && expected.refJoinedSubseq == actual.refJoinedSubseq
+            && expected.ptrnSubseq == actual.ptrnSubseq && expected.pairAlignment == actual.pairAlignment,
+            setError(QString("Result %1 is not restored").arg(i)), );
+    }
+}
+
+#define GLOBAL_ALIGNMENT_MATRIX_ATTR "sub"
+
+static const QString DEFAULT_GLOBAL_ALIGNMENT_MATRIX = "dna";
+
+namespace {
+
+/* The last row, the vertical gap scores of the last row and the last column of a global alignment score pass */
+class GlobalAlignmentRows {
+public:
+    bool operator==(const GlobalAlignmentRows &other) const {
+        return h == other.h && f == other.f && lastColumn == other.lastColumn;
+    }
+
+    QVector<int> h;
+    QVector<int> f;
+    QVector<int> lastColumn;
+};
+
+/* Opens the score pass of a global alignment realization. The sequences are encoded: a symbol is its index in the alphabet */
+template<class Algorithm>
+class GlobalAlignmentRowsCalculator : public Algorithm {
+public:
+    GlobalAlignmentRowsCalculator(const SMatrix &m, int gapOpen, int gapExtd) {
+        this->initScores(m, gapOpen, gapExtd);
+    }
+
+    QByteArray getRandomSequence(int length) const {
+        QByteArray result(length, 0);
+        for (int i = 0; i < length; i++) {
+            result[i] = static_cast<char>(qrand() % this->alphabetSize);
+        }
+        return result;
+    }
+
+    /* The sequence of the symbol with the best match score */
+    QByteArray getBestMatchingSequence(int length) const {
+        char best = 0;
+        for (int c = 1; c < this->alphabetSize; c++) {
+            if (this->getSubstScore(c, c) > this->getSubstScore(best, best)) {
+                best = static_cast<char>(c);
+            }
+        }
+        return QByteArray(length, best);
+    }
+
+    GlobalAlignmentRows calculateRows(const QByteArray &a, const QByteArray &b, int topGapOpen, bool freeStart) {
+        GlobalAlignmentRows rows;
+        rows.h.resize(b.size() + 1);
+        rows.f.resize(b.size() + 1);
+        rows.lastColumn.resize(a.size() + 1);
+        Algorithm::calculateLastRow(a.constData(), a.size(), b.constData(), b.size(), topGapOpen, freeStart,
+                                    rows.h.data(), rows.f.data(), rows.lastColumn.data());
+        return rows;
+    }
+
+    /* The same rows taken from the full matrix of the Gotoh recurrences */
+    GlobalAlignmentRows calculateRowsInFullMatrix(const QByteArray &a, const QByteArray &b, int topGapOpen, bool freeStart) const {
+        const int aLen = a.size();
+        const int bLen = b.size();
+        const int gapOpenExtd = this->gapOpen + this->gapExtd;
+        const int w = bLen + 1;
+        QVector<int> h((aLen + 1) * w);
+        QVector<int> e((aLen + 1) * w);
+        QVector<int> f((aLen + 1) * w);
+
+        for (int j = 0; j <= bLen; j++) {
+            h[j] = (freeStart || 0 == j) ? 0 : -(this->gapOpen + j * this->gapExtd);
+            f[j] = Algorithm::MINUS_INF;
+        }
+        for (int i = 1; i <= aLen; i++) {
+            h[i * w] = f[i * w] = freeStart ? 0 : -(topGapOpen + i * this->gapExtd);
+            e[i * w] = Algorithm::MINUS_INF;
+            for (int j = 1; j <= bLen; j++) {
+                const int idx = i * w + j;
+                e[idx] = qMax(h[idx - 1] - gapOpenExtd, e[idx - 1] - this->gapExtd);
+                f[idx] = qMax(h[idx - w] - gapOpenExtd, f[idx - w] - this->gapExtd);
+                h[idx] = qMax(h[idx - w - 1] + this->getSubstScore(a[i - 1], b[j - 1]), qMax(e[idx], f[idx]));
+            }
+        }
+
+        GlobalAlignmentRows rows;
+        rows.h = h.mid(aLen * w, w);
+        rows.f = f.mid(aLen * w, w);
+        for (int i = 0; i <= aLen; i++) {
+            rows.lastColumn.append(h[i * w + bLen]);
+        }
+        return rows;
+    }
+
+    int getMaxSubstScore() const {
+        return this->maxSubstScore;
+    }
+
+    static int getMinVectorizedLength() {
+        return Algorithm::MIN_VECTORIZED_LENGTH;
+    }
+
+    static int getMaxShortScore() {
+        return Algorithm::MAX_SHORT_SCORE;
+    }
+
+    bool isVectorized(int aLen, int bLen, int topGapOpen) const {
+        return aLen > 0 && bLen >= Algorithm::MIN_VECTORIZED_LENGTH && this->fitsShort(aLen, bLen, topGapOpen);
+    }
+};
+
+class RowsCase {
+public:
+    RowsCase(const QByteArray &a, const QByteArray &b, int gapOpen, int gapExtd, int topGapOpen)
+        : a(a), b(b), gapOpen(gapOpen), gapExtd(gapExtd), topGapOpen(topGapOpen) {}
+
+    QByteArray a;
+    QByteArray b;
+    int gapOpen;
+    int gapExtd;
+    int topGapOpen;
+};
+
+QString getRowsCaseDescription(int aLen, int bLen, int gapOpen, int gapExtd, int topGapOpen, bool freeStart) {
+    return QString("lengths %1 and %2, gap open %3, gap extension %4, top gap open %5, free start %6")
+        .arg(aLen).arg(bLen).arg(gapOpen).arg(gapExtd).arg(topGapOpen).arg(freeStart);
+}
+
+template<class Algorithm>
+QString compareWithFullMatrix(const SMatrix &m, int gapOpen, int gapExtd) {
+    static const int bLengths[] = {1, 2, 7, 31, 32, 33, 40, 47};
+    GlobalAlignmentRowsCalculator<Algorithm> calculator(m, gapOpen, gapExtd);
+    for (int aLen = 1; aLen <= 8; aLen++) {
+        for (int k = 0; k < int(sizeof(bLengths) / sizeof(bLengths[0])); k++) {
+            const QByteArray a = calculator.getRandomSequence(aLen);
+            const QByteArray b = calculator.getRandomSequence(bLengths[k]);
+            for (int topGapOpen = 0; topGapOpen <= gapOpen; topGapOpen += qMax(1, gapOpen)) {
+                for (int freeStart = 0; freeStart <= 1; freeStart++) {
+                    const GlobalAlignmentRows expected = calculator.calculateRowsInFullMatrix(a, b, topGapOpen, freeStart);
+                    CHECK(calculator.calculateRows(a, b, topGapOpen, freeStart) == expected,
+                          getRowsCaseDescription(aLen, bLengths[k], gapOpen, gapExtd, topGapOpen, freeStart));
+                }
+            }
+        }
+    }
+    return QString();
+}
+
+QByteArray decode(const QByteArray &encoded, const QByteArray &alphabetChars) {
+    QByteArray result(encoded.size(), 0);
+    for (int i = 0; i < encoded.size(); i++) {
+        result[i] = alphabetChars[static_cast<int>(encoded[i])];
+    }
+    return result;
+}
+
+template<class Algorithm>
+QString checkTraceback(const SMatrix &m, const QByteArray &a, const QByteArray &b, int gapOpen, int gapExtd, bool freeEndGaps) {
+    GlobalAlignmentRowsCalculator<Algorithm> algorithm(m, gapOpen, gapExtd);
+    const GlobalAlignmentRows rows = algorithm.calculateRowsInFullMatrix(a, b, gapOpen, freeEndGaps);
+    int expectedScore = rows.h.last();
+    if (freeEndGaps) {
+        foreach (int value, rows.h + rows.lastColumn) {
+            expectedScore = qMax(expectedScore, value);
+        }
+    }
+
+    const QByteArray alphabetChars = m.getAlphabet()->getAlphabetChars();
+    algorithm.launch(m, decode(a, alphabetChars), decode(b, alphabetChars), gapOpen, gapExtd, freeEndGaps);
+    const QByteArray &path = algorithm.getPairAlignment();
+    const int aSymbolsCount = path.count(GlobalAlignmentAlgorithm::DIAG) + path.count(GlobalAlignmentAlgorithm::UP);
+    const int bSymbolsCount = path.count(GlobalAlignmentAlgorithm::DIAG) + path.count(GlobalAlignmentAlgorithm::LEFT);
+    CHECK(aSymbolsCount == a.size() && bSymbolsCount == b.size(),
+          QString("the path covers %1 of %2 and %3 of %4 symbols").arg(aSymbolsCount).arg(a.size()).arg(bSymbolsCount).arg(b.size()));
+    CHECK(algorithm.getScore() == expectedScore, QString("the path score is %1, the matrix score is %2").arg(algorithm.getScore()).arg(expectedScore));
+    return QString();
+}
+
+template<class Algorithm>
+QString checkTracebacks(const SMatrix &m) {
+    const int gapOpen = 10;
+    const int gapExtd = 1;
+    GlobalAlignmentRowsCalculator<Algorithm> calculator(m, gapOpen, gapExtd);
+    const QByteArray x = calculator.getRandomSequence(60);
+    const QByteArray y = calculator.getRandomSequence(60);
+    const QByteArray insertion = calculator.getRandomSequence(40);
+    const QByteArray core = calculator.getRandomSequence(150);
+
+    QList<QPair<QByteArray, QByteArray> > pairs;
+    // the parts are aligned in the full matrix
+    pairs << qMakePair(calculator.getRandomSequence(20), calculator.getRandomSequence(30));
+    // the middle row is crossed in a cell
+    pairs << qMakePair(calculator.getRandomSequence(300), calculator.getRandomSequence(250));
+    // the middle row is crossed inside the gap in the second sequence
+    pairs << qMakePair(x + insertion + y, x + y);
+    pairs << qMakePair(x + y, x + insertion + y);
+    // the ends of the first sequence are not aligned with free end gaps
+    pairs << qMakePair(calculator.getRandomSequence(50) + core + calculator.getRandomSequence(30), core);
+    pairs << qMakePair(core, calculator.getRandomSequence(30) + core + calculator.getRandomSequence(50));
+
+    for (int i = 0; i < pairs.size(); i++) {
+        for (int freeEndGaps = 0; freeEndGaps <= 1; freeEndGaps++) {
+            const QString error = checkTraceback<Algorithm>(m, pairs[i].first, pairs[i].second, gapOpen, gapExtd, freeEndGaps);
+            CHECK(error.isEmpty(), QString("Pair %1, free end gaps %2: %3").arg(i).arg(freeEndGaps).arg(error));
+        }
+    }
+    return QString();
+}
+
+}
+
+void GTest_GlobalAlignmentFullMatrix::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute(GLOBAL_ALIGNMENT_MATRIX_ATTR, DEFAULT_GLOBAL_ALIGNMENT_MATRIX);
+}
+
+void GTest_GlobalAlignmentFullMatrix::run() {
+    const SMatrix m = AppContext::getSubstMatrixRegistry()->getMatrix(matrixName);
+    CHECK_EXT(!m.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+    qsrand(1);
+
+    for (int gapOpen = 0; gapOpen <= 10; gapOpen += 10) {
+        const int gapExtd = (0 == gapOpen) ? 3 : 1;
+        QString error = compareWithFullMatrix<GlobalAlignmentAlgorithm>(m, gapOpen, gapExtd);
+        CHECK_EXT(error.isEmpty(), setError("The scalar rows differ from the full matrix: " + error), );
+#ifdef SW2_BUILD_WITH_SSE2
+        error = compareWithFullMatrix<GlobalAlignmentAlgorithmSSE2>(m, gapOpen, gapExtd);
+        CHECK_EXT(error.isEmpty(), setError("The SSE2 rows differ from the full matrix: " + error), );
+#endif
+    }
+}
+
+void GTest_GlobalAlignmentSSE2Rows::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute(GLOBAL_ALIGNMENT_MATRIX_ATTR, DEFAULT_GLOBAL_ALIGNMENT_MATRIX);
+}
+
+void GTest_GlobalAlignmentSSE2Rows::run() {
+#ifdef SW2_BUILD_WITH_SSE2
+    const SMatrix m = AppContext::getSubstMatrixRegistry()->getMatrix(matrixName);
+    CHECK_EXT(!m.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+    qsrand(1);
+
+    typedef GlobalAlignmentRowsCalculator<GlobalAlignmentAlgorithm> ScalarCalculator;
+    typedef GlobalAlignmentRowsCalculator<GlobalAlignmentAlgorithmSSE2> SSE2Calculator;
+    const int minLength = SSE2Calculator::getMinVectorizedLength();
+    const int maxScore = SSE2Calculator::getMaxShortScore();
+
+    QList<RowsCase> cases;
+
+    ScalarCalculator random(m, 0, 0);
+    // every count of the padding elements
+    for (int bLen = minLength + 1; bLen <= minLength + 8; bLen++) {
+        cases << RowsCase(random.getRandomSequence(40), random.getRandomSequence(bLen), 10, 1, 10);
+        cases << RowsCase(random.getRandomSequence(40), random.getRandomSequence(bLen), 10, 1, 0);
+    }
+    cases << RowsCase(random.getRandomSequence(300), random.getRandomSequence(1000), 10, 1, 10);
+    // the gap scores are near the lower bound: the row 0 of the padding elements does not fit 16 bits
+    const int aLen = 2;
+    const int bLen = minLength + 1;
+    cases << RowsCase(random.getRandomSequence(aLen), random.getRandomSequence(bLen), 0, (maxScore - 1) / (aLen + bLen + 2), 0);
+    // the match scores are near the upper bound
+    const QByteArray bestMatching = random.getBestMatchingSequence((maxScore - 1) / random.getMaxSubstScore());
+    cases << RowsCase(bestMatching, bestMatching, 10, 1, 10);
+
+    foreach (const RowsCase &c, cases) {
+        ScalarCalculator scalar(m, c.gapOpen, c.gapExtd);
+        SSE2Calculator sse2(m, c.gapOpen, c.gapExtd);
+        for (int freeStart = 0; freeStart <= 1; freeStart++) {
+            const QString description = getRowsCaseDescription(c.a.size(), c.b.size(), c.gapOpen, c.gapExtd, c.topGapOpen, freeStart);
+            CHECK_EXT(sse2.isVectorized(c.a.size(), c.b.size(), c.topGapOpen), setError("The SSE2 pass is not used: " + description), );
+            CHECK_EXT(sse2.calculateRows(c.a, c.b, c.topGapOpen, freeStart) == scalar.calculateRows(c.a, c.b, c.topGapOpen, freeStart),
+                      setError("The SSE2 rows differ from the scalar rows: " + description), );
+        }
+    }
+#endif
+}
+
+void GTest_GlobalAlignmentTraceback::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute(GLOBAL_ALIGNMENT_MATRIX_ATTR, DEFAULT_GLOBAL_ALIGNMENT_MATRIX);
+}
+
+void GTest_GlobalAlignmentTraceback::run() {
+    const SMatrix m = AppContext::getSubstMatrixRegistry()->getMatrix(matrixName);
+    CHECK_EXT(!m.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+
+    qsrand(1);
+    QString error = checkTracebacks<GlobalAlignmentAlgorithm>(m);
+    CHECK_EXT(error.isEmpty(), setError("The scalar path is not optimal: " + error), );
+#ifdef SW2_BUILD_WITH_SSE2
+    qsrand(1);
+    error = checkTracebacks<GlobalAlignmentAlgorithmSSE2>(m);
+    CHECK_EXT(error.isEmpty(), setError("The SSE2 path is not optimal: " + error), );
+#endif
+}
+
+#define BULK_SEARCH_MAX_HITS_ATTR "max_hits"
+
+static const QString DEFAULT_BULK_SEARCH_IMPL = "Classic 2";
+
+namespace {
+
+PairAlignSequences createHit(qint64 startPos, qint64 length, int score, bool complement) {
+    PairAlignSequences hit;
+    hit.refSubseqInterval = U2Region(startPos, length);
+    hit.ptrnSubseqInterval = U2Region(0, length);
+    hit.score = score;
+    hit.isDNAComplemented = complement;
+    return hit;
+}
+
+QString regionToString(const U2Region &region, bool complement, int score) {
+    return QString("%1%2..%3:%4").arg(complement ? "c" : "").arg(region.startPos).arg(region.endPos()).arg(score);
+}
+
+QString hitsToString(const QList<PairAlignSequences> &hits) {
+    QStringList result;
+    foreach (const PairAlignSequences &hit, hits) {
+        result << regionToString(hit.refSubseqInterval, hit.isDNAComplemented, hit.score);
+    }
+    return result.join(", ");
+}
+
+QString resultsToString(const QList<SmithWatermanResult> &results) {
+    QStringList result;
+    foreach (const SmithWatermanResult &r, results) {
+        result << regionToString(r.refSubseq, r.strand.isCompementary(), r.score);
+    }
+    return result.join(", ");
+}
+
+QByteArray getRandomNucleotides(int length) {
+    static const QByteArray NUCLEOTIDES("ACGT");
+    QByteArray result(length, 0);
+    for (int i = 0; i < length; i++) {
+        result[i] = NUCLEOTIDES[qrand() % NUCLEOTIDES.size()];
+    }
+    return result;
+}
+
+}
+
+void GTest_SWBulkResultHeap::init(XMLTestFormat *, const QDomElement &) {
+
+}
+
+void GTest_SWBulkResultHeap::run() {
+    SWBulkResultHeap heap(3);
+    heap.push(createHit(10, 20, 50, false));
+    // the same hit is found in the overlap of the next part
+    heap.push(createHit(10, 20, 50, false));
+    heap.push(createHit(10, 20, 40, false));
+    // the same region on the other strand is another hit
+    heap.push(createHit(10, 20, 45, true));
+    CHECK_EXT(!heap.isFull(), setError("The heap of 3 hits is full: " + hitsToString(heap.getHits())), );
+
+    heap.push(createHit(100, 20, 30, false));
+    CHECK_EXT(heap.isFull(), setError("The heap of 3 hits is not full: " + hitsToString(heap.getHits())), );
+    CHECK_EXT(30 == heap.getLowestScore(), setError(QString("Unexpected lowest score: %1").arg(heap.getLowestScore())), );
+
+    // a weaker hit is not kept, a better one replaces the weakest one
+    heap.push(createHit(200, 20, 20, false));
+    heap.push(createHit(300, 20, 60, false));
+    // a better score of a kept hit replaces its score
+    heap.push(createHit(10, 20, 55, true));
+
+    QList<PairAlignSequences> expected;
+    expected << createHit(300, 20, 60, false) << createHit(10, 20, 55, true) << createHit(10, 20, 50, false);
+    const QString actualHits = hitsToString(heap.getHits());
+    CHECK_EXT(hitsToString(expected) == actualHits, setError(QString("Unexpected hits: expected %1, got %2").arg(hitsToString(expected)).arg(actualHits)), );
+    CHECK_EXT(50 == heap.getLowestScore(), setError(QString("Unexpected lowest score: %1").arg(heap.getLowestScore())), );
+
+    SWBulkResultHeap unlimitedHeap(0);
+    for (int i = 0; i < 100; i++) {
+        unlimitedHeap.push(createHit(i, 20, i % 7, false));
+        unlimitedHeap.push(createHit(i, 20, i % 7, false));
+    }
+    CHECK_EXT(!unlimitedHeap.isFull(), setError("The unlimited heap is full"), );
+    CHECK_EXT(100 == unlimitedHeap.getHits().size(), setError(QString("Unexpected hits count in the unlimited heap: %1").arg(unlimitedHeap.getHits().size())), );
+}
+
+void GTest_SWBulkSearchMinScore::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute(GLOBAL_ALIGNMENT_MATRIX_ATTR, DEFAULT_GLOBAL_ALIGNMENT_MATRIX);
+}
+
+void GTest_SWBulkSearchMinScore::run() {
+    SmithWatermanSettings config;
+    config.pSm = AppContext::getSubstMatrixRegistry()->getMatrix(matrixName);
+    CHECK_EXT(!config.pSm.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+    config.ptrn = "ACGTTGCAACGTTGCA";
+    config.percentOfScore = 50;
+
+    SWBulkSearch search(config, 2, SW_classic);
+    const int initialMinScore = search.getMinScore();
+    CHECK_EXT(0 < initialMinScore && initialMinScore + 5 < search.maxScore,
+              setError(QString("Unexpected scores: min %1, max %2").arg(initialMinScore).arg(search.maxScore)), );
+
+    int minScore = search.addHits(QList<PairAlignSequences>() << createHit(0, 16, initialMinScore + 2, false));
+    CHECK_EXT(initialMinScore == minScore, setError(QString("The min score is raised before the heap is full: %1").arg(minScore)), );
+
+    // the duplicate does not fill the heap
+    minScore = search.addHits(QList<PairAlignSequences>() << createHit(0, 16, initialMinScore + 2, false));
+    CHECK_EXT(initialMinScore == minScore, setError(QString("The min score is raised by a duplicate: %1").arg(minScore)), );
+
+    minScore = search.addHits(QList<PairAlignSequences>() << createHit(100, 16, initialMinScore + 5, false));
+    CHECK_EXT(initialMinScore + 3 == minScore, setError(QString("The min score is not raised above the weakest kept hit: %1").arg(minScore)), );
+
+    minScore = search.addHits(QList<PairAlignSequences>() << createHit(200, 16, initialMinScore + 4, true));
+    CHECK_EXT(initialMinScore + 5 == minScore, setError(QString("The min score is not raised after the weakest hit is replaced: %1").arg(minScore)), );
+
+    // the hits found before the min score is raised do not lower it
+    minScore = search.addHits(QList<PairAlignSequences>() << createHit(300, 16, initialMinScore + 1, false));
+    CHECK_EXT(initialMinScore + 5 == minScore, setError(QString("The min score is lowered: %1").arg(minScore)), );
+
+    // nothing better is possible: the rest parts of the search are skipped
+    minScore = search.addHits(QList<PairAlignSequences>() << createHit(400, 16, search.maxScore, false) << createHit(500, 16, search.maxScore, false));
+    CHECK_EXT(search.maxScore < minScore, setError(QString("The min score %1 is not above the max score %2").arg(minScore).arg(search.maxScore)), );
+}
+
+void GTest_SWBulkHitCoordinates::init(XMLTestFormat *, const QDomElement &) {
+
+}
+
+void GTest_SWBulkHitCoordinates::run() {
+    const U2Region part(100, 50);
+
+    PairAlignSequences hit = createHit(5, 10, 1, false);
+    SWBulkSearchTask::toSequenceCoordinates(hit, part, false, 0, false);
+    CHECK_EXT(U2Region(105, 10) == hit.refSubseqInterval, setError("Unexpected direct hit region: " + hit.refSubseqInterval.toString()), );
+
+    // the complement part is reversed: its first symbol is the last symbol of the part
+    hit = createHit(5, 10, 1, true);
+    SWBulkSearchTask::toSequenceCoordinates(hit, part, true, 0, false);
+    CHECK_EXT(U2Region(135, 10) == hit.refSubseqInterval, setError("Unexpected complement hit region: " + hit.refSubseqInterval.toString()), );
+
+    hit = createHit(0, 50, 1, true);
+    SWBulkSearchTask::toSequenceCoordinates(hit, part, true, 0, false);
+    CHECK_EXT(part == hit.refSubseqInterval, setError("Unexpected region of the complement hit of the whole part: " + hit.refSubseqInterval.toString()), );
+
+    // the amino acids hit in the frame 1: the nucleotides 7..15 of the part
+    hit = createHit(2, 3, 1, false);
+    SWBulkSearchTask::toSequenceCoordinates(hit, part, false, 1, true);
+    CHECK_EXT(U2Region(107, 9) == hit.refSubseqInterval, setError("Unexpected translated hit region: " + hit.refSubseqInterval.toString()), );
+
+    // the amino acids hit in the frame 2 of the reversed part: the nucleotides 8..16 from the part end
+    hit = createHit(2, 3, 1, true);
+    SWBulkSearchTask::toSequenceCoordinates(hit, part, true, 2, true);
+    CHECK_EXT(U2Region(133, 9) == hit.refSubseqInterval, setError("Unexpected translated complement hit region: " + hit.refSubseqInterval.toString()), );
+}
+
+void GTest_SWBulkSearch::init(XMLTestFormat *, const QDomElement &el) {
+    matrixName = el.attribute(GLOBAL_ALIGNMENT_MATRIX_ATTR, DEFAULT_GLOBAL_ALIGNMENT_MATRIX);
+    impl = el.attribute(IMPL_ATTR, DEFAULT_BULK_SEARCH_IMPL);
+    maxHits = el.attribute(BULK_SEARCH_MAX_HITS_ATTR, "2").toInt();
+}
+
+void GTest_SWBulkSearch::prepare() {
+    const SMatrix matrix = AppContext::getSubstMatrixRegistry()->getMatrix(matrixName);
+    CHECK_EXT(!matrix.isEmpty(), setError(QString("Unknown substitution matrix: %1").arg(matrixName)), );
+    SmithWatermanTaskFactory *factory = AppContext::getSmithWatermanTaskFactoryRegistry()->getFactory(impl);
+    CHECK_EXT(NULL != factory, setError(QString("Not known impl of Smith-Waterman: %1").arg(impl)), );
+    DNATranslation *complTT = AppContext::getDNATranslationRegistry()->lookupComplementTranslation(matrix.getAlphabet());
+    CHECK_EXT(NULL != complTT, setError(QString("No complement translation for the matrix alphabet: %1").arg(matrixName)), );
+
+    qsrand(1);
+    const int patternLength = 24;
+    QList<QByteArray> patterns;
+    for (int i = 0; i < 3; i++) {
+        patterns << getRandomNucleotides(patternLength);
+    }
+
+    // the copies are planted every 1500 symbols: the pattern index and the strand of every copy
+    QList<QPair<int, bool> > copies;
+    copies << qMakePair(0, false) << qMakePair(0, false) << qMakePair(0, false) << qMakePair(0, true);
+    copies << qMakePair(1, false) << qMakePair(1, true) << qMakePair(1, true);
+    copies << qMakePair(2, false) << qMakePair(2, true);
+    QByteArray sequence = getRandomNucleotides(20000);
+    for (int i = 0; i < copies.size(); i++) {
+        const int patternIndex = copies[i].first;
+        const U2Region region(1000 + i * 1500, patternLength);
+        QByteArray copy = patterns[patternIndex];
+        if (copies[i].second) {
+            TextUtils::translate(complTT->getOne2OneMapper(), copy.data(), copy.length());
+            TextUtils::reverse(copy.data(), copy.length());
+            complementCopies << qMakePair(patternIndex, region);
+        } else if (2 == patternIndex) {
+            // the direct copy of the last pattern has a mismatch
+            copy[patternLength / 2] = ('A' == copy[patternLength / 2]) ? 'C' : 'A';
+        }
+        sequence.replace(region.startPos, region.length, copy);
+    }
+
+    SmithWatermanSettings config;
+    config.pSm = matrix;
+    config.sqnc = sequence;
+    config.globalRegion = U2Region(0, sequence.length());
+    config.gapModel.scoreGapOpen = -10;
+    config.gapModel.scoreGapExtd = -1;
+    config.percentOfScore = 90;
+    config.strand = StrandOption_Both;
+    config.complTT = complTT;
+    // the searches cut the sequence into different parts: the weaker hits of the parts ends are filtered out
+    config.resultFilter = AppContext::getSWResultFilterRegistry()->getFilter(AppContext::getSWResultFilterRegistry()->getDefaultFilterId());
+
+    QList<SmithWatermanSettings> bulkConfigs;
+    QList<SmithWatermanSettings> limitedConfigs;
+    foreach (const QByteArray &pattern, patterns) {
+        config.ptrn = pattern;
+        config.resultListener = new SmithWatermanResultListener();
+        bulkListeners << config.resultListener;
+        bulkConfigs << config;
+        config.resultListener = new SmithWatermanResultListener();
+        limitedListeners << config.resultListener;
+        limitedConfigs << config;
+    }
+    Task *bulkTask = factory->getBulkTaskInstance(bulkConfigs, 0, "tests SmithWaterman bulk");
+    if (NULL == bulkTask) {
+        qDeleteAll(bulkListeners);
+        qDeleteAll(limitedListeners);
+        bulkListeners.clear();
+        limitedListeners.clear();
+        setError(QString("The Smith-Waterman impl has no bulk mode: %1").arg(impl));
+        return;
+    }
+    addSubTask(bulkTask);
+    addSubTask(factory->getBulkTaskInstance(limitedConfigs, maxHits, "tests SmithWaterman bulk with hits limit"));
+
+    foreach (const QByteArray &pattern, patterns) {
+        config.ptrn = pattern;
+        config.resultListener = new SmithWatermanResultListener();
+        singleListeners << config.resultListener;
+        addSubTask(factory->getTaskInstance(config, "tests SmithWaterman"));
+    }
+}
+
+Task::ReportResult GTest_SWBulkSearch::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    for (int i = 0; i < singleListeners.size(); i++) {
+        QList<SmithWatermanResult> expected = singleListeners[i]->getResults();
+        QList<SmithWatermanResult> actual = bulkListeners[i]->getResults();
+        QList<SmithWatermanResult> limited = limitedListeners[i]->getResults();
+        GTest_SmithWatermnan::sortByScore(expected);
+        GTest_SmithWatermnan::sortByScore(actual);
+        GTest_SmithWatermnan::sortByScore(limited);
+
+        CHECK_EXT(!expected.isEmpty(), setError(QString("Pattern %1 is not found").arg(i)), ReportResult_Finished);
+        CHECK_EXT(resultsToString(expected) == resultsToString(actual),
+                  setError(QString("Pattern %1, the bulk search results differ: expected %2, got %3").arg(i).arg(resultsToString(expected)).arg(resultsToString(actual))), ReportResult_Finished);
+
+        const QList<SmithWatermanResult> expectedLimited = expected.mid(0, maxHits);
+        CHECK_EXT(expectedLimited.size() == limited.size(),
+                  setError(QString("Pattern %1, unexpected results count with the hits limit: expected %2, got %3").arg(i).arg(expectedLimited.size()).arg(limited.size())), ReportResult_Finished);
+        for (int j = 0; j < limited.size(); j++) {
+            CHECK_EXT(expectedLimited[j].score == limited[j].score,
+                      setError(QString("Pattern %1, the results with the hits limit are not the best ones: expected %2, got %3").arg(i).arg(resultsToString(expectedLimited)).arg(resultsToString(limited))), ReportResult_Finished);
+        }
+    }
+
+    typedef QPair<int, U2Region> Copy;
+    foreach (const Copy &copy, complementCopies) {
+        bool found = false;
+        foreach (const SmithWatermanResult &r, bulkListeners[copy.first]->getResults()) {
+            found = found || (r.strand.isCompementary() && r.refSubseq == copy.second);
+        }
+        CHECK_EXT(found, setError(QString("Pattern %1, the complement copy %2 is not found").arg(copy.first).arg(copy.second.toString())), ReportResult_Finished);
+    }
+    return ReportResult_Finished;
+}
+
 }
@@ -75,6 +75,111 @@ private:
     QString machinePath;
 };
 
+/* Serializes the settings and the results of SmithWatermanLocalTask, sends them through the local task channel and compares the restored copies */
+class GTest_SmithWatermanLocalTaskSerialization : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_SmithWatermanLocalTaskSerialization, "sw-local-task-serialization");
+
+    void run();
+
+private:
+    QString matrixName;
+};
+
+/* Compares the score rows of the global alignment passes with the rows of the full matrix on small random sequences */
+class GTest_GlobalAlignmentFullMatrix : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GlobalAlignmentFullMatrix, "global-alignment-full-matrix");
+
+    void run();
+
+private:
+    QString matrixName;
+};
+
+/*
+ * Compares the score rows of the SSE2 global alignment pass with the rows of the scalar pass:
+ * the rows a little longer than the vectorized minimum, long rows and the lengths near the 16-bit bound
+ */
+class GTest_GlobalAlignmentSSE2Rows : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GlobalAlignmentSSE2Rows, "global-alignment-sse2-rows");
+
+    void run();
+
+private:
+    QString matrixName;
+};
+
+/* The score of the restored global alignment path must be equal to the best score of the full matrix */
+class GTest_GlobalAlignmentTraceback : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_GlobalAlignmentTraceback, "global-alignment-traceback");
+
+    void run();
+
+private:
+    QString matrixName;
+};
+
+/* Hits found twice in the overlaps are kept once, the full heap keeps the best hits only */
+class GTest_SWBulkResultHeap : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_SWBulkResultHeap, "sw-bulk-result-heap");
+
+    void run();
+};
+
+/* The minimal score of a bulk search is raised above the weakest kept hit once the heap is full */
+class GTest_SWBulkSearchMinScore : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_SWBulkSearchMinScore, "sw-bulk-search-min-score");
+
+    void run();
+
+private:
+    QString matrixName;
+};
+
+/* The hits in the complement and translated parts are converted to the sequence coordinates */
+class GTest_SWBulkHitCoordinates : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_SWBulkHitCoordinates, "sw-bulk-hit-coordinates");
+
+    void run();
+};
+
+/*
+ * Searches the patterns planted to a random sequence on both strands with the bulk task and with
+ * a task per pattern. The results must be equal, the bulk task with the hits limit must find the best of them
+ */
+class GTest_SWBulkSearch : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_SWBulkSearch, "sw-bulk-search");
+
+    void prepare();
+    ReportResult report();
+
+private:
+    QString matrixName;
+    QString impl;
+    int maxHits;
+
+    QList<SmithWatermanResultListener *> bulkListeners;
+    QList<SmithWatermanResultListener *> limitedListeners;
+    QList<SmithWatermanResultListener *> singleListeners;
+    /* the reverse complement copies of the patterns: the pattern index and the copy region */
+    QList<QPair<int, U2Region> > complementCopies;
+};
+
 class GTest_SmithWatermnanPerf : public GTest {
     Q_OBJECT
 public:
@@ -36,6 +36,7 @@
 
 #include <U2Lang/IncludedProtoFactory.h>
 #include <U2Lang/WorkflowEnv.h>
+#include <U2Lang/WorkflowResultCache.h>
 #include <U2Lang/WorkflowTasksRegistry.h>
 
 #include <U2Core/AppContext.h>
@@ -44,10 +45,12 @@
 #include <U2Core/Task.h>
 #include <U2Core/ServiceTypes.h>
 
+#include <U2Core/CMDLineCoreOptions.h>
 #include <U2Core/CMDLineRegistry.h>
 #include <U2Core/CMDLineHelpProvider.h>
 #include <U2Core/CMDLineUtils.h>
 #include <cmdline/WorkflowCMDLineTasks.h>
+#include <cmdline/WorkflowDaemonTask.h>
 #include <cmdline/GalaxyConfigTask.h>
 
 #include <U2Gui/ToolsMenu.h>
@@ -79,6 +82,8 @@ extern "C" Q_DECL_EXPORT Plugin* U2_PLUGIN_INIT_FUNC() {
 const QString WorkflowDesignerPlugin::RUN_WORKFLOW              = "task";
 const QString WorkflowDesignerPlugin::REMOTE_MACHINE            = "task-remote-machine";
 const QString WorkflowDesignerPlugin::PRINT                     = "print";
+const QString WorkflowDesignerPlugin::RESULT_CACHE              = "result-cache";
+const QString WorkflowDesignerPlugin::RESULT_CACHE_SIZE         = "result-cache-size";
 
 WorkflowDesignerPlugin::WorkflowDesignerPlugin()
 : Plugin(tr("Workflow Designer"), tr("Workflow Designer allows to create complex computational workflows.")){
@@ -118,7 +123,26 @@ void WorkflowDesignerPlugin::processCMDLineOptions() {
     CMDLineRegistry * cmdlineReg = AppContext::getCMDLineRegistry();
     assert(cmdlineReg != NULL);
 
+    if (cmdlineReg->hasParameter(RESULT_CACHE)) {
+        qint64 cacheSizeMb = WorkflowResultCache::DEFAULT_MAX_SIZE_MB;
+        if (cmdlineReg->hasParameter(RESULT_CACHE_SIZE)) {
+            bool ok = false;
+            const qint64 value = cmdlineReg->getParameterValue(RESULT_CACHE_SIZE).toLongLong(&ok);
+            if (ok && value > 0) {
+                cacheSizeMb = value;
+            } else {
+                coreLog.error(tr("Incorrect workflow result cache size: %1").arg(cmdlineReg->getParameterValue(RESULT_CACHE_SIZE)));
+            }
+        }
+        WorkflowResultCache::setCacheDirectory(cmdlineReg->getParameterValue(RESULT_CACHE), cacheSizeMb);
+    }
+
     bool consoleMode = !AppContext::isGUIMode(); // only in console mode we run workflows by default. Otherwise we show them
+    if (consoleMode && cmdlineReg->hasParameter(CMDLineCoreOptions::DAEMON)) {
+        Task * t = new WorkflowDaemonTask(cmdlineReg->getParameterValue(CMDLineCoreOptions::DAEMON));
+        connect(AppContext::getPluginSupport(), SIGNAL(si_allStartUpPluginsLoaded()), new TaskStarter(t), SLOT(registerTask()));
+        return;
+    }
     if (cmdlineReg->hasParameter( RUN_WORKFLOW ) || (consoleMode && !CMDLineRegistryUtils::getPureValues().isEmpty()) ) {
         Task * t = NULL;
         if( cmdlineReg->hasParameter(REMOTE_MACHINE) ) {
@@ -192,6 +216,24 @@ void WorkflowDesignerPlugin::registerCMDLineHelp() {
 
     cmdLineRegistry->registerCMDLineHelpProvider( galaxyConfigSection );
 
+    CMDLineHelpProvider * resultCacheSection = new CMDLineHelpProvider(
+        RESULT_CACHE,
+        tr("Reuses the results of the unchanged workflow steps."),
+        tr("The results of the supported workflow steps (e.g. building of a reference index) are stored"
+        " in the specified folder. A step is skipped and its stored result is used"
+        " if the step parameters, the tool version and the input files contents are not changed."),
+        tr("<path_to_folder>"));
+
+    CMDLineHelpProvider * resultCacheSizeSection = new CMDLineHelpProvider(
+        RESULT_CACHE_SIZE,
+        tr("The size limit of the workflow result cache, in megabytes."),
+        tr("The least recently used results are removed from the cache when it exceeds the limit."
+        " The default limit is %1 megabytes.").arg(WorkflowResultCache::DEFAULT_MAX_SIZE_MB),
+        tr("<megabytes>"));
+
+    cmdLineRegistry->registerCMDLineHelpProvider( resultCacheSection );
+    cmdLineRegistry->registerCMDLineHelpProvider( resultCacheSizeSection );
+
     //CMDLineHelpProvider * remoteMachineSectionArguments = new CMDLineHelpProvider( REMOTE_MACHINE, "<path-to-machine-file>");
     //CMDLineHelpProvider * remoteMachineSection = new CMDLineHelpProvider( REMOTE_MACHINE, tr("run provided tasks on given remote machine") );
     //TODO: bug UGENE-23
@@ -43,6 +43,8 @@ public:
     static const QString RUN_WORKFLOW;
     static const QString REMOTE_MACHINE;
     static const QString PRINT;
+    static const QString RESULT_CACHE;
+    static const QString RESULT_CACHE_SIZE;
 
 public:
     WorkflowDesignerPlugin ();
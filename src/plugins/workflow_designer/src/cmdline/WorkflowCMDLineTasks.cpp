@@ -19,7 +19,9 @@
  * MA 02110-1301, USA.
  */
 
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 
 #include <U2Core/AppContext.h>
 #include <U2Core/Log.h>
@@ -46,14 +48,23 @@ namespace U2 {
 /*******************************************
 * WorkflowRunFromCMDLineBase
 *******************************************/
-WorkflowRunFromCMDLineBase::WorkflowRunFromCMDLineBase()
-: Task( tr( "Workflow run from cmdline" ), TaskFlag_NoRun ), schema(NULL), optionsStartAt(-1), loadTask(NULL) {
+static QString resolvePath( const QString & path, const QString & workingDir ) {
+    if( workingDir.isEmpty() || path.isEmpty() || path.contains( "://" ) || !QFileInfo( path ).isRelative() ) {
+        return path;
+    }
+    return QDir( workingDir ).absoluteFilePath( path );
+}
+
+WorkflowRunFromCMDLineBase::WorkflowRunFromCMDLineBase(const CMDLineRegistry *_cmdLine, const QString &_workingDir)
+: Task( tr( "Workflow run from cmdline" ), TaskFlag_NoRun ), cmdLine(_cmdLine), workingDir(_workingDir), schema(NULL), optionsStartAt(-1), loadTask(NULL) {
     GCOUNTER(cvar,tvar,"workflow_run_from_cmdline");
 
-    CMDLineRegistry * cmdLineRegistry = AppContext::getCMDLineRegistry();
+    if( cmdLine == NULL ) {
+        cmdLine = AppContext::getCMDLineRegistry();
+    }
 
     // try to process schema without 'task' option (it can only be the first one)
-    QStringList pureValues = CMDLineRegistryUtils::getPureValues();
+    QStringList pureValues = CMDLineRegistryUtils::getPureValues( cmdLine );
     if( !pureValues.isEmpty() ) {
         QString schemaName = pureValues.first();
         processLoadSchemaTask( schemaName, 1 ); // because after program name
@@ -64,9 +75,9 @@ WorkflowRunFromCMDLineBase::WorkflowRunFromCMDLineBase()
     }
 
     // process schema with 'task' option
-    int taskOptionIdx = CMDLineRegistryUtils::getParameterIndex( WorkflowDesignerPlugin::RUN_WORKFLOW );
+    int taskOptionIdx = CMDLineRegistryUtils::getParameterIndex( cmdLine, WorkflowDesignerPlugin::RUN_WORKFLOW );
     if(taskOptionIdx != -1) {
-        processLoadSchemaTask( cmdLineRegistry->getParameterValue( WorkflowDesignerPlugin::RUN_WORKFLOW, taskOptionIdx ), taskOptionIdx );
+        processLoadSchemaTask( cmdLine->getParameterValue( WorkflowDesignerPlugin::RUN_WORKFLOW, taskOptionIdx ), taskOptionIdx );
     }
     if( loadTask == NULL ) {
         setError( tr( "no task to run" ) );
@@ -84,7 +95,12 @@ void WorkflowRunFromCMDLineBase::processLoadSchemaTask( const QString & schemaNa
 }
 
 LoadWorkflowTask * WorkflowRunFromCMDLineBase::prepareLoadSchemaTask( const QString & schemaName ) {
-    QString pathToSchema = WorkflowUtils::findPathToSchemaFile( schemaName );
+    // the name can be a path relative to the working folder or a name of a sample
+    QString schemaFile = resolvePath( schemaName, workingDir );
+    if( !QFileInfo( schemaFile ).exists() ) {
+        schemaFile = schemaName;
+    }
+    QString pathToSchema = WorkflowUtils::findPathToSchemaFile( schemaFile );
     if( pathToSchema.isEmpty() ) {
         coreLog.error( tr( "Cannot find workflow: %1" ).arg( schemaName ) );
         return NULL;
@@ -99,10 +115,10 @@ WorkflowRunFromCMDLineBase::~WorkflowRunFromCMDLineBase() {
     delete schema;
 }
 
-static void setSchemaCMDLineOptions( Schema * schema, int optionsStartAtIdx ) {
+static void setSchemaCMDLineOptions( Schema * schema, int optionsStartAtIdx, const CMDLineRegistry * cmdLine, const QString & workingDir ) {
     assert( schema != NULL && optionsStartAtIdx > 0 );
 
-    QList<StringPair> parameters = AppContext::getCMDLineRegistry()->getParameters();
+    QList<StringPair> parameters = cmdLine->getParameters();
     int sz = parameters.size();
     for( int i = optionsStartAtIdx; i < sz; ++i ) {
         const StringPair & param = parameters.at(i);
@@ -132,9 +148,18 @@ static void setSchemaCMDLineOptions( Schema * schema, int optionsStartAtIdx ) {
             continue;
         }
 
+        QString valueStr = param.second;
+        if( !workingDir.isEmpty() && NotAnUrl != WorkflowUtils::isUrlAttribute( attr, actor ) ) {
+            QStringList urls = valueStr.split( ";" );
+            for( int j = 0; j < urls.size(); j++ ) {
+                urls[j] = resolvePath( urls[j], workingDir );
+            }
+            valueStr = urls.join( ";" );
+        }
+
         ActorId id = actor->getId();
         bool isOk;
-        QVariant value = valueFactory->getValueFromString( param.second, &isOk );
+        QVariant value = valueFactory->getValueFromString( valueStr, &isOk );
         if(!isOk){
             coreLog.error( WorkflowRunFromCMDLineBase::tr( "Incorrect value for '%1', null or default value passed to workflow" ).
                 arg( param.first ));
@@ -159,7 +184,7 @@ QList<Task*> WorkflowRunFromCMDLineBase::onSubTaskFinished( Task* subTask ) {
         assert( schema != NULL );
         remapping = loadTask->getRemapping();
 
-        setSchemaCMDLineOptions( schema, optionsStartAt );
+        setSchemaCMDLineOptions( schema, optionsStartAt, cmdLine, workingDir );
         if( schema->getDomain().isEmpty() ) {
             QList<QString> domainsId = WorkflowEnv::getDomainRegistry()->getAllIds();
             assert(!domainsId.isEmpty());
@@ -182,8 +207,17 @@ QList<Task*> WorkflowRunFromCMDLineBase::onSubTaskFinished( Task* subTask ) {
 /*******************************************
 * WorkflowRunFromCMDLineTask
 *******************************************/
+WorkflowRunFromCMDLineTask::WorkflowRunFromCMDLineTask(const CMDLineRegistry *cmdLine, const QString &workingDir)
+: WorkflowRunFromCMDLineBase(cmdLine, workingDir) {
+}
+
 Task * WorkflowRunFromCMDLineTask::getWorkflowRunTask() const {
-    return new WorkflowRunTask(*schema, remapping);
+    WorkflowRunTask *task = new WorkflowRunTask(*schema, remapping);
+    task->setCMDLine( cmdLine );
+    if( !workingDir.isEmpty() ) {
+        task->setWorkingDirRoot( workingDir );
+    }
+    return task;
 }
 
 /*******************************************
@@ -28,10 +28,14 @@
 
 namespace U2 {
 
+class CMDLineRegistry;
+
 class WorkflowRunFromCMDLineBase : public Task {
     Q_OBJECT
 public:
-    WorkflowRunFromCMDLineBase();
+    // @cmdLine is the command line of the current process by default
+    // @workingDir is used for relative paths instead of the current folder if it is not empty
+    WorkflowRunFromCMDLineBase(const CMDLineRegistry *cmdLine = NULL, const QString &workingDir = QString());
     virtual ~WorkflowRunFromCMDLineBase();
     QList<Task*> onSubTaskFinished( Task* subTask );
 
@@ -43,6 +47,8 @@ private:
     void processLoadSchemaTask( const QString & schemaName, int optionIdx );
 
 protected:
+    const CMDLineRegistry * cmdLine;
+    QString             workingDir;
     Schema*             schema;
     int                 optionsStartAt;
     LoadWorkflowTask *  loadTask;
@@ -54,6 +60,7 @@ protected:
 class WorkflowRunFromCMDLineTask : public WorkflowRunFromCMDLineBase {
     Q_OBJECT
 public:
+    WorkflowRunFromCMDLineTask(const CMDLineRegistry *cmdLine = NULL, const QString &workingDir = QString());
     virtual Task * getWorkflowRunTask() const;
 }; // WorkflowRunFromCMDLineTask
 
@@ -0,0 +1,192 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QTimer>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/CMDLineRegistry.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Remote/LocalTaskDistribution.h>
+#include <U2Remote/WorkflowDaemonClient.h>
+
+#include "WorkflowCMDLineTasks.h"
+#include "WorkflowDaemonTask.h"
+
+namespace U2 {
+
+#define PROGRESS_INTERVAL_MS 500
+
+/*******************************************
+* WorkflowDaemonJobTask
+*******************************************/
+WorkflowDaemonJobTask::WorkflowDaemonJobTask( const QStringList &args, const QString &workingDir )
+: Task( tr( "Workflow daemon job" ), TaskFlag_NoRun ), cmdLine( new CMDLineRegistry( args ) ) {
+    addSubTask( new WorkflowRunFromCMDLineTask( cmdLine.data(), workingDir ) );
+}
+
+WorkflowDaemonJobTask::~WorkflowDaemonJobTask() {
+}
+
+Task::ReportResult WorkflowDaemonJobTask::report() {
+    propagateSubtaskError();
+    return ReportResult_Finished;
+}
+
+/*******************************************
+* WorkflowDaemonTask
+*******************************************/
+WorkflowDaemonTask::WorkflowDaemonTask( const QString &serverName )
+: Task( tr( "Workflow daemon" ), TaskFlag_NoRun ), serverName( serverName ), server( NULL ), progressTimer( NULL ) {
+}
+
+WorkflowDaemonTask::~WorkflowDaemonTask() {
+    foreach( Task *job, jobs ) {
+        job->disconnect( this );
+        job->cancel();
+    }
+}
+
+void WorkflowDaemonTask::prepare() {
+    server = new QLocalServer( this );
+    connect( server, SIGNAL( newConnection() ), SLOT( sl_newConnection() ) );
+    QLocalServer::removeServer( serverName );
+    // only the user who started the server may submit workflows
+    server->setSocketOptions( QLocalServer::UserAccessOption );
+    CHECK_EXT( server->listen( serverName ), setError( tr( "Can't start the workflow server: %1" ).arg( server->errorString() ) ), );
+
+    progressTimer = new QTimer( this );
+    connect( progressTimer, SIGNAL( timeout() ), SLOT( sl_sendProgress() ) );
+    progressTimer->start( PROGRESS_INTERVAL_MS );
+    coreLog.info( tr( "The workflow server is waiting for workflows: %1" ).arg( server->fullServerName() ) );
+}
+
+Task::ReportResult WorkflowDaemonTask::report() {
+    // the server works until the application is closed
+    if( !hasError() && !isCanceled() ) {
+        return ReportResult_CallMeAgain;
+    }
+    if( NULL != server ) {
+        server->close();
+    }
+    return ReportResult_Finished;
+}
+
+void WorkflowDaemonTask::sl_newConnection() {
+    while( server->hasPendingConnections() ) {
+        QLocalSocket *socket = server->nextPendingConnection();
+        connect( socket, SIGNAL( readyRead() ), SLOT( sl_readyRead() ) );
+        connect( socket, SIGNAL( disconnected() ), SLOT( sl_disconnected() ) );
+        buffers.insert( socket, QByteArray() );
+    }
+}
+
+void WorkflowDaemonTask::sl_readyRead() {
+    QLocalSocket *socket = qobject_cast< QLocalSocket * >( sender() );
+    SAFE_POINT( NULL != socket && buffers.contains( socket ), "Unexpected sender", );
+
+    QByteArray &buffer = buffers[socket];
+    buffer.append( socket->readAll() );
+    QVariant request;
+    if( LocalTaskChannel::takeMessage( buffer, request ) ) {
+        // one workflow per connection
+        disconnect( socket, SIGNAL( readyRead() ), this, SLOT( sl_readyRead() ) );
+        startJob( socket, request );
+    }
+}
+
+void WorkflowDaemonTask::startJob( QLocalSocket *socket, const QVariant &request ) {
+    const QVariantMap message = request.toMap();
+    const QStringList args = message.value( WorkflowDaemonClient::ARGS ).toStringList();
+    if( args.isEmpty() ) {
+        QVariantMap reply;
+        reply[WorkflowDaemonClient::FINISHED] = true;
+        reply[WorkflowDaemonClient::ERROR_MESSAGE] = tr( "Unexpected request of the client" );
+        sendReply( socket, reply );
+        return;
+    }
+
+    Task *job = new WorkflowDaemonJobTask( args, message.value( WorkflowDaemonClient::DIR ).toString() );
+    connect( job, SIGNAL( si_stateChanged() ), SLOT( sl_jobStateChanged() ) );
+    jobs.insert( socket, job );
+    sentProgress.insert( socket, -1 );
+    coreLog.details( tr( "Workflow is submitted: %1" ).arg( args.mid( 1 ).join( " " ) ) );
+    AppContext::getTaskScheduler()->registerTopLevelTask( job );
+}
+
+void WorkflowDaemonTask::sl_jobStateChanged() {
+    Task *job = qobject_cast< Task * >( sender() );
+    CHECK( NULL != job && job->isFinished(), );
+    QLocalSocket *socket = jobs.key( job, NULL );
+    CHECK( NULL != socket, );
+    jobs.remove( socket );
+    sentProgress.remove( socket );
+
+    QVariantMap reply;
+    reply[WorkflowDaemonClient::FINISHED] = true;
+    if( job->hasError() ) {
+        reply[WorkflowDaemonClient::ERROR_MESSAGE] = job->getError();
+    } else if( job->isCanceled() ) {
+        reply[WorkflowDaemonClient::ERROR_MESSAGE] = tr( "The workflow is canceled" );
+    }
+    sendReply( socket, reply );
+}
+
+void WorkflowDaemonTask::sl_sendProgress() {
+    foreach( QLocalSocket *socket, jobs.keys() ) {
+        const int progress = jobs[socket]->getProgress();
+        if( progress == sentProgress.value( socket ) ) {
+            continue;
+        }
+        sentProgress[socket] = progress;
+        QVariantMap reply;
+        reply[WorkflowDaemonClient::PROGRESS] = progress;
+        LocalTaskChannel::writeMessage( socket, reply );
+    }
+}
+
+void WorkflowDaemonTask::sendReply( QLocalSocket *socket, const QVariantMap &reply ) {
+    buffers.remove( socket );
+    socket->disconnect( this );
+    LocalTaskChannel::writeMessage( socket, reply );
+    socket->flush();
+    socket->disconnectFromServer();
+    socket->deleteLater();
+}
+
+void WorkflowDaemonTask::sl_disconnected() {
+    QLocalSocket *socket = qobject_cast< QLocalSocket * >( sender() );
+    SAFE_POINT( NULL != socket, "Unexpected sender", );
+    buffers.remove( socket );
+    sentProgress.remove( socket );
+    Task *job = jobs.take( socket );
+    if( NULL != job ) {
+        // nobody waits for the result
+        job->disconnect( this );
+        job->cancel();
+    }
+    socket->deleteLater();
+}
+
+} // U2
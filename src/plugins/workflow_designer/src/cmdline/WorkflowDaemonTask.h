@@ -0,0 +1,89 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_WORKFLOW_DAEMON_TASK_H_
+#define _U2_WORKFLOW_DAEMON_TASK_H_
+
+#include <QtCore/QMap>
+#include <QtCore/QScopedPointer>
+
+#include <U2Core/Task.h>
+
+class QLocalServer;
+class QLocalSocket;
+class QTimer;
+
+namespace U2 {
+
+class CMDLineRegistry;
+
+/*
+ * Runs the workflow submitted to the daemon. The arguments are the same as for the 'ugenecl' run
+ */
+class WorkflowDaemonJobTask : public Task {
+    Q_OBJECT
+public:
+    WorkflowDaemonJobTask( const QStringList &args, const QString &workingDir );
+    ~WorkflowDaemonJobTask();
+
+    virtual ReportResult report();
+
+private:
+    QScopedPointer<CMDLineRegistry> cmdLine;
+
+}; // WorkflowDaemonJobTask
+
+/*
+ * Keeps the initialized UGENE and runs the workflows submitted by WorkflowDaemonClient concurrently.
+ * If the client disconnects, its workflow is canceled.
+ */
+class WorkflowDaemonTask : public Task {
+    Q_OBJECT
+public:
+    WorkflowDaemonTask( const QString &serverName );
+    ~WorkflowDaemonTask();
+
+    virtual void prepare();
+    virtual ReportResult report();
+
+private slots:
+    void sl_newConnection();
+    void sl_readyRead();
+    void sl_disconnected();
+    void sl_jobStateChanged();
+    void sl_sendProgress();
+
+private:
+    void startJob( QLocalSocket *socket, const QVariant &request );
+    void sendReply( QLocalSocket *socket, const QVariantMap &reply );
+
+    QString                                 serverName;
+    QLocalServer *                          server;
+    QTimer *                                progressTimer;
+    QMap< QLocalSocket *, QByteArray >      buffers;
+    QMap< QLocalSocket *, Task * >          jobs;
+    QMap< QLocalSocket *, int >             sentProgress;
+
+}; // WorkflowDaemonTask
+
+} // U2
+
+#endif // _U2_WORKFLOW_DAEMON_TASK_H_
@@ -20,13 +20,16 @@
  */
 
 #include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
 #include <U2Core/Counter.h>
 #include <U2Core/IOAdapter.h>
 #include <U2Core/IOAdapterUtils.h>
 #include <U2Core/GUrlUtils.h>
 #include <U2Core/FileAndDirectoryUtils.h>
 #include <U2Core/TaskSignalMapper.h>
+#include <U2Core/U2SafePoints.h>
 #include <U2Formats/BAMUtils.h>
+#include <U2Formats/FastqBatchReader.h>
 #include <U2Formats/FastqFormat.h>
 #include <U2Designer/DelegateEditors.h>
 #include <U2Lang/ActorPrototypeRegistry.h>
@@ -43,6 +46,29 @@
 namespace U2 {
 namespace LocalWorkflow {
 
+//////////////////////////////////////////////////////
+//BaseFastqBatchTask
+BaseFastqBatchTask::BaseFastqBatchTask(const BaseNGSSetting &settings)
+    :BaseNGSTask(settings), threadsCount(qMax(1, AppResourcePool::instance()->getIdealThreadCount() - 1)){
+    // the task thread writes the output, the batches are transformed by the reserved threads
+    addTaskResource(TaskResourceUsage(RESOURCE_THREAD, threadsCount));
+}
+
+void BaseFastqBatchTask::runStep(){
+    FastqBatchProcessor processor(this, threadsCount);
+    processor.run(getInputUrls(), settings.outDir + settings.outName, stateInfo);
+    CHECK_OP(stateInfo, );
+    reportResult(processor.getInputRecordsCount(), processor.getOutputRecordsCount());
+}
+
+QStringList BaseFastqBatchTask::getParameters(U2OpStatus &/*os*/){
+    return QStringList();
+}
+
+QStringList BaseFastqBatchTask::getInputUrls() const {
+    return QStringList() << settings.inputUrl;
+}
+
 ///////////////////////////////////////////////////////////////
 //CASAVAFilter
 const QString CASAVAFilterWorkerFactory::ACTOR_ID("CASAVAFilter");
@@ -160,41 +186,39 @@ Task *CASAVAFilterWorker::getTask(const BaseNGSSetting &settings) const {
 //////////////////////////////////////////////////////
 //CASAVAFilterTask
 CASAVAFilterTask::CASAVAFilterTask(const BaseNGSSetting &settings)
-    :BaseNGSTask(settings){
+    :BaseFastqBatchTask(settings){
     GCOUNTER(cvar, tvar, "NGS:CASAVAFilterTask");
 }
 
-void CASAVAFilterTask::runStep(){
-    int ncount = 0;
-    int ycount = 0;
-
-    QScopedPointer<IOAdapter> io  (IOAdapterUtils::open(settings.outDir + settings.outName, stateInfo, IOAdapterMode_Append));
-
-    //1:N:0:TAAGGG
-    QRegExp pattern (":Y:[^:]:");
-    FASTQIterator iter(settings.inputUrl);
-    while(iter.hasNext()){
-        if(stateInfo.isCoR()){
-            return;
-        }
-        DNASequence seq = iter.next();
-        QString comment = DNAInfo::getFastqComment(seq.info);
-        if(pattern.indexIn(comment) != -1){
-            ycount++;
-        }else{
-            FastqFormat::writeEntry(seq.getName() + " " + comment, seq, io.data(), "Writing error", stateInfo, false);
-            ncount++;
+namespace {
+    /* CASAVA 1.8 marks the filtered reads with 'Y' in the comment, e.g. "1:Y:0:TAAGGG" */
+    bool isFilteredByCasava(const QByteArray &comment) {
+        for (int pos = comment.indexOf(":Y:"); -1 != pos; pos = comment.indexOf(":Y:", pos + 1)) {
+            if (pos + 4 < comment.size() && ':' != comment[pos + 3] && ':' == comment[pos + 4]) {
+                return true;
+            }
         }
+        return false;
     }
+}
 
-    algoLog.info(QString("Discarded by CASAVA filter %1").arg(ycount));
-    algoLog.info(QString("Accepted by CASAVA filter %1").arg(ncount));
-    algoLog.info(QString("Total by CASAVA FILTER: %1").arg(ncount + ycount));
+int CASAVAFilterTask::transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &/*os*/) {
+    int accepted = 0;
+    for (int i = 0; i < batch.size(); i++) {
+        if (isFilteredByCasava(batch.getComment(i))) {
+            continue;
+        }
+        FastqBatchProcessor::appendRecord(output, batch.getHeaderData(i), batch.getHeaderLength(i),
+                                          batch.getSequenceData(i), batch.getQualityData(i), batch.getSequenceLength(i));
+        accepted++;
+    }
+    return accepted;
 }
 
-QStringList CASAVAFilterTask::getParameters(U2OpStatus &/*os*/) {
-    QStringList res;
-    return res;
+void CASAVAFilterTask::reportResult(qint64 inputCount, qint64 outputCount) {
+    algoLog.info(QString("Discarded by CASAVA filter %1").arg(inputCount - outputCount));
+    algoLog.info(QString("Accepted by CASAVA filter %1").arg(outputCount));
+    algoLog.info(QString("Total by CASAVA FILTER: %1").arg(inputCount));
 }
 
 
@@ -331,68 +355,48 @@ Task *QualityTrimWorker::getTask(const BaseNGSSetting &settings) const {
 //////////////////////////////////////////////////////
 //QualityTrimTask
 QualityTrimTask::QualityTrimTask(const BaseNGSSetting &settings)
-    :BaseNGSTask(settings){
+    :BaseFastqBatchTask(settings){
 
     GCOUNTER(cvar, tvar, "NGS:FASTQQualityTrimmerTask");
+    quality = settings.customParameters.value(QUALITY_ID, 20).toInt();
+    minLen = settings.customParameters.value(LEN_ID, 0).toInt();
+    bothEnds = settings.customParameters.value(BOTH_ID, false).toInt();
 }
 
-void QualityTrimTask::runStep(){
-    int ncount = 0;
-    int ycount = 0;
-
-    QScopedPointer<IOAdapter> io  (IOAdapterUtils::open(settings.outDir + settings.outName, stateInfo, IOAdapterMode_Append));
-
-    int quality = settings.customParameters.value(QUALITY_ID, 20).toInt();
-    int minLen = settings.customParameters.value(LEN_ID, 0).toInt();
-    bool bothEnds = settings.customParameters.value(BOTH_ID, false).toInt();
-
-    FASTQIterator iter(settings.inputUrl);
-    while(iter.hasNext()){
-        if(stateInfo.isCoR()){
-            return;
+int QualityTrimTask::transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &/*os*/) {
+    // the same as DNAQuality::getValue() for the Sanger quality the FASTQ reader creates
+    const int minCode = quality + 33;
+    int accepted = 0;
+    for (int i = 0; i < batch.size(); i++) {
+        const uchar *qualities = reinterpret_cast<const uchar *>(batch.getQualityData(i));
+        int endPosition = batch.getSequenceLength(i) - 1;
+        for (; endPosition>=0; endPosition--){
+            if(qualities[endPosition] >= minCode){
+                break;
+            }
         }
-        DNASequence dna = iter.next();
-        QString comment = DNAInfo::getFastqComment(dna.info);
-        int seqLen = dna.length();
-        if(seqLen > dna.quality.qualCodes.length()){
-            ncount++;
-            continue;
-        }else{
-            int endPosition = seqLen-1;
-            for (; endPosition>=0; endPosition--){
-                if(dna.quality.getValue(endPosition) >= quality){
+        int beginPosition = 0;
+        if (bothEnds) {
+            for (; beginPosition<=endPosition; beginPosition++) {
+                if (qualities[beginPosition] >= minCode) {
                     break;
                 }
             }
-            int beginPosition = 0;
-            if (bothEnds) {
-                for (; beginPosition<=endPosition; beginPosition++) {
-                    if (dna.quality.getValue(beginPosition) >= quality) {
-                        break;
-                    }
-                }
-            }
-            if(endPosition>=beginPosition && endPosition-beginPosition+1 >= minLen){
-                DNASequence trimmed(dna.getName(), dna.seq.left(endPosition+1).mid(beginPosition), dna.alphabet);
-                trimmed.quality = dna.quality;
-                trimmed.quality.qualCodes = trimmed.quality.qualCodes.left(endPosition+1).mid(beginPosition);
-                FastqFormat::writeEntry(trimmed.getName(), trimmed, io.data(), "Writing error", stateInfo, false);
-                ycount++;
-            }else{
-                ncount++;
-                continue;
-            }
+        }
+        const int trimmedLength = endPosition - beginPosition + 1;
+        if (endPosition >= beginPosition && trimmedLength >= minLen) {
+            FastqBatchProcessor::appendRecord(output, batch.getHeaderData(i), batch.getNameLength(i),
+                                              batch.getSequenceData(i) + beginPosition, batch.getQualityData(i) + beginPosition, trimmedLength);
+            accepted++;
         }
     }
-
-    algoLog.info(QString("Discarded by trimmer %1").arg(ncount));
-    algoLog.info(QString("Accepted by trimmer %1").arg(ycount));
-    algoLog.info(QString("Total by trimmer %1").arg(ncount + ycount));
+    return accepted;
 }
 
-QStringList QualityTrimTask::getParameters(U2OpStatus &/*os*/){
-    QStringList res;
-    return res;
+void QualityTrimTask::reportResult(qint64 inputCount, qint64 outputCount) {
+    algoLog.info(QString("Discarded by trimmer %1").arg(inputCount - outputCount));
+    algoLog.info(QString("Accepted by trimmer %1").arg(outputCount));
+    algoLog.info(QString("Total by trimmer %1").arg(inputCount));
 }
 
 ///////////////////////////////////////////////////////////////
@@ -540,38 +544,26 @@ Task *MergeFastqWorker::getTask(const BaseNGSSetting &settings) const {
 //////////////////////////////////////////////////////
 //MergeFastqTask
 MergeFastqTask::MergeFastqTask(const BaseNGSSetting &settings)
-    :BaseNGSTask(settings){
+    :BaseFastqBatchTask(settings){
 
     GCOUNTER(cvar, tvar, "NGS:FASTQMergeFastqmerTask");
 }
 
-void MergeFastqTask::runStep(){
-    QScopedPointer<IOAdapter> io  (IOAdapterUtils::open(settings.outDir + settings.outName, stateInfo, IOAdapterMode_Append));
-
-    QStringList urls = settings.customParameters.value(INPUT_URLS_ID, "").toString().split(",");
-    qint64 numberOfSeqs = 0;
-    qint64 numberOfFiles = 0;
-
-    foreach (QString url, urls){
-        FASTQIterator iter(url);
-        while(iter.hasNext()){
-            if(stateInfo.isCoR()){
-                return;
-            }
-            DNASequence dna = iter.next();
-            FastqFormat::writeEntry(dna.getName(), dna, io.data(), "Writing error", stateInfo, false);
-            numberOfSeqs++;
-        }
-        numberOfFiles++;
-
+int MergeFastqTask::transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &/*os*/) {
+    for (int i = 0; i < batch.size(); i++) {
+        FastqBatchProcessor::appendRecord(output, batch.getHeaderData(i), batch.getNameLength(i),
+                                          batch.getSequenceData(i), batch.getQualityData(i), batch.getSequenceLength(i));
     }
-    algoLog.info(QString("Sequences merged %1").arg(numberOfSeqs));
-    algoLog.info(QString("Files merged %1").arg(numberOfFiles));
+    return batch.size();
 }
 
-QStringList MergeFastqTask::getParameters(U2OpStatus &/*os*/){
-    QStringList res;
-    return res;
+QStringList MergeFastqTask::getInputUrls() const {
+    return settings.customParameters.value(INPUT_URLS_ID, "").toString().split(",");
+}
+
+void MergeFastqTask::reportResult(qint64 inputCount, qint64 /*outputCount*/) {
+    algoLog.info(QString("Sequences merged %1").arg(inputCount));
+    algoLog.info(QString("Files merged %1").arg(getInputUrls().size()));
 }
 
 } //LocalWorkflow
@@ -26,10 +26,32 @@
 #include <U2Lang/WorkflowUtils.h>
 #include <U2Lang/BaseNGSWorker.h>
 #include <U2Core/GUrl.h>
+#include <U2Formats/FastqBatchProcessor.h>
 
 namespace U2 {
 namespace LocalWorkflow {
 
+/**
+ * Base task for the FASTQ workers that process reads one by one.
+ * Reads are processed by batches in parallel with FastqBatchProcessor,
+ * the output keeps the input order.
+ */
+class BaseFastqBatchTask : public BaseNGSTask, public FastqBatchTransformer {
+    Q_OBJECT
+public:
+    BaseFastqBatchTask(const BaseNGSSetting &settings);
+
+protected:
+    void runStep();
+    QStringList getParameters(U2OpStatus& os);
+
+    virtual QStringList getInputUrls() const;
+    virtual void reportResult(qint64 inputCount, qint64 outputCount) = 0;
+
+private:
+    const int threadsCount;
+};
+
 //////////////////////////////////////////////////
 //CASAVAFilter
 class CASAVAFilterPrompter;
@@ -61,14 +83,15 @@ public:
     Worker* createWorker(Actor* a) { return new CASAVAFilterWorker(a); }
 }; //CASAVAFilterWorkerFactory
 
-class CASAVAFilterTask : public BaseNGSTask{
+class CASAVAFilterTask : public BaseFastqBatchTask {
     Q_OBJECT
 public:
     CASAVAFilterTask (const BaseNGSSetting &settings);
 
+    int transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &os);
+
 protected:
-    void runStep();
-    QStringList getParameters(U2OpStatus& os);
+    void reportResult(qint64 inputCount, qint64 outputCount);
 };
 
 //////////////////////////////////////////////////
@@ -102,14 +125,20 @@ public:
     Worker* createWorker(Actor* a) { return new QualityTrimWorker(a); }
 }; //QualityTrimWorkerFactory
 
-class QualityTrimTask : public BaseNGSTask{
+class QualityTrimTask : public BaseFastqBatchTask {
     Q_OBJECT
 public:
     QualityTrimTask (const BaseNGSSetting &settings);
 
+    int transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &os);
+
 protected:
-    void runStep();
-    QStringList getParameters(U2OpStatus& os);
+    void reportResult(qint64 inputCount, qint64 outputCount);
+
+private:
+    int quality;
+    int minLen;
+    bool bothEnds;
 };
 
 //////////////////////////////////////////////////
@@ -146,14 +175,16 @@ public:
     Worker* createWorker(Actor* a) { return new MergeFastqWorker(a); }
 }; //MergeFastqWorkerFactory
 
-class MergeFastqTask : public BaseNGSTask{
+class MergeFastqTask : public BaseFastqBatchTask {
     Q_OBJECT
 public:
     MergeFastqTask (const BaseNGSSetting &settings);
 
+    int transform(const FastqRecordBatch &batch, QByteArray &output, U2OpStatus &os);
+
 protected:
-    void runStep();
-    QStringList getParameters(U2OpStatus& os);
+    QStringList getInputUrls() const;
+    void reportResult(qint64 inputCount, qint64 outputCount);
 };
 
 } //LocalWorkflow
@@ -25,6 +25,7 @@
 
 #include <U2Core/AppContext.h>
 #include <U2Core/AppResources.h>
+#include <U2Core/BaseDocumentFormats.h>
 #include <U2Core/DocumentModel.h>
 #include <U2Core/IOAdapter.h>
 #include <U2Core/IOAdapterUtils.h>
@@ -55,6 +56,9 @@
 #include <U2Lang/WorkflowMonitor.h>
 
 #include <U2Formats/DocumentFormatUtils.h>
+#include <U2Formats/FastaIndex.h>
+#include <U2Formats/FastqBatchReader.h>
+#include <U2Formats/ReadIndexedFastaTask.h>
 
 namespace U2 {
 using namespace Workflow;
@@ -340,11 +344,26 @@ void LoadSeqTask::prepare() {
         stateInfo.setError(tr("Unsupported document format: %1").arg(url));
         return;
     }
+
+    if (canReadIndexedFasta()) {
+        indexedReadTask = new ReadIndexedFastaTask(url);
+        indexedReadTask->setHeaderFilter(selector->accExpr, cfg.value(GenericSeqActorProto::LIMIT_ATTR, 0).toInt());
+        addSubTask(indexedReadTask);
+    }
 }
 
 void LoadSeqTask::run() {
     CHECK(NULL != format,);
+    CHECK_OP(stateInfo, );
     ioLog.info(tr("Reading sequences from %1 [%2]").arg(url).arg(format->getFormatName()));
+    if (NULL != indexedReadTask) {
+        importIndexedFasta();
+        return;
+    }
+    if (BaseDocumentFormats::FASTQ == format->getFormatId() && !cfg.contains(DocumentReadingMode_SequenceMergeGapSize) && !cfg.contains(GObjectHint_CaseAnns)) {
+        readFastq();
+        return;
+    }
     IOAdapterFactory* iof = AppContext::getIOAdapterRegistry()->getIOAdapterFactoryById(IOAdapterUtils::url2io(url));
     cfg[DocumentFormat::DBI_REF_HINT] = qVariantFromValue(storage->getDbiRef());
     cfg[DocumentReadingMode_DontMakeUniqueNames] = true;
@@ -426,6 +445,74 @@ void LoadSeqTask::run() {
     }
 }
 
+void LoadSeqTask::readFastq() {
+    FastqBatchReader reader(url, stateInfo);
+    CHECK_OP(stateInfo, );
+    // the same as FastqFormat does: the reads keep their case, malformed records are skipped and reported
+    reader.setUpperCase(false);
+    reader.setSkipBadRecords(true);
+    const int limit = cfg.value(GenericSeqActorProto::LIMIT_ATTR, 0).toInt();
+    const QVariant datasetName = cfg.value(BaseSlots::DATASET_SLOT().getId(), "");
+
+    DbiOperationsBlock opBlock(storage->getDbiRef(), stateInfo);
+    FastqRecordBatch batch;
+    while (reader.readBatch(batch, stateInfo)) {
+        for (int i = 0; i < batch.size(); i++) {
+            CHECK(!isCanceled(), );
+            DNASequence sequence = batch.toDNASequence(i);
+            if (sequence.getName().isEmpty()) {
+                sequence.setName("Sequence");
+            }
+            if (!selector->matches(sequence)) {
+                continue;
+            }
+            U2EntityRef seqRef = U2SequenceUtils::import(storage->getDbiRef(), sequence, stateInfo);
+            CHECK_OP(stateInfo, );
+            QVariantMap m;
+            m[BaseSlots::URL_SLOT().getId()] = url;
+            m[BaseSlots::DATASET_SLOT().getId()] = datasetName;
+            SharedDbiDataHandler handler = storage->getDataHandler(seqRef);
+            m[BaseSlots::DNA_SEQUENCE_SLOT().getId()] = qVariantFromValue<SharedDbiDataHandler>(handler);
+            results.append(m);
+            // The rest is dropped by the reader anyway
+            CHECK(0 == limit || results.size() < limit, );
+        }
+        stateInfo.setProgress(reader.getProgress());
+    }
+    CHECK_OP(stateInfo, );
+
+    const QStringList &skippedRecords = reader.getSkippedRecords();
+    CHECK(!skippedRecords.isEmpty(), );
+    if (0 == reader.getRecordsCount()) {
+        stateInfo.setError(skippedRecords.join("\n"));
+        return;
+    }
+    stateInfo.addWarnings(skippedRecords);
+}
+
+bool LoadSeqTask::canReadIndexedFasta() const {
+    CHECK(BaseDocumentFormats::FASTA == format->getFormatId() && FastaIndex::canBeIndexed(url), false);
+    CHECK(!cfg.contains(DocumentReadingMode_SequenceMergeGapSize) && !cfg.contains(GObjectHint_CaseAnns), false);
+    // Reading all records by the index is not faster than parsing the file
+    return !selector->accExpr.isEmpty() || cfg.value(GenericSeqActorProto::LIMIT_ATTR, 0).toInt() > 0;
+}
+
+void LoadSeqTask::importIndexedFasta() {
+    const QVariant datasetName = cfg.value(BaseSlots::DATASET_SLOT().getId(), "");
+    DbiOperationsBlock opBlock(storage->getDbiRef(), stateInfo);
+    foreach (const DNASequence &sequence, indexedReadTask->takeResult()) {
+        CHECK(!isCanceled(), );
+        U2EntityRef seqRef = U2SequenceUtils::import(storage->getDbiRef(), sequence, stateInfo);
+        CHECK_OP(stateInfo, );
+        QVariantMap m;
+        m[BaseSlots::URL_SLOT().getId()] = url;
+        m[BaseSlots::DATASET_SLOT().getId()] = datasetName;
+        SharedDbiDataHandler handler = storage->getDataHandler(seqRef);
+        m[BaseSlots::DNA_SEQUENCE_SLOT().getId()] = qVariantFromValue<SharedDbiDataHandler>(handler);
+        results.append(m);
+    }
+}
+
 /**************************
  * DNASelector
  **************************/
@@ -31,6 +31,7 @@
 namespace U2 {
 
 class DatasetFilesIterator;
+class ReadIndexedFastaTask;
 
 namespace LocalWorkflow {
 
@@ -84,8 +85,8 @@ class LoadSeqTask : public Task {
     Q_OBJECT
 public:
     LoadSeqTask(QString url, const QVariantMap &cfg, DNASelector *sel, DbiDataStorage *storage)
-        : Task(tr("Read sequences from %1").arg(url), TaskFlag_None),
-        url(url), selector(sel), cfg(cfg), storage(storage), format(NULL) {}
+        : Task(tr("Read sequences from %1").arg(url), TaskFlags_FOSE_COSC),
+        url(url), selector(sel), cfg(cfg), storage(storage), format(NULL), indexedReadTask(NULL) {}
     virtual void prepare();
     virtual void run();
 
@@ -95,6 +96,15 @@ public:
     QList<QVariantMap> results;
     DbiDataStorage *storage;
     DocumentFormat *format;
+
+private:
+    /* FASTQ records are read by batches without creating a document */
+    void readFastq();
+    /* Only some FASTA records are needed: they are found by the index, other records are not parsed */
+    bool canReadIndexedFasta() const;
+    void importIndexedFasta();
+
+    ReadIndexedFastaTask *indexedReadTask;
 };
 
 class LoadMSATask : public Task {
@@ -56,6 +56,7 @@ static const QString OUT_MODE_ID( "out-mode" );
 static const QString CUSTOM_DIR_ID( "custom-dir" );
 static const QString OUT_NAME_ID( "out-name" );
 static const QString INDEX_ID( "index" );
+static const QString MEMORY_ID( "max-memory" );
 
 /************************************************************************/
 /* SortBamPrompter */
@@ -113,12 +114,16 @@ void SortBamWorkerFactory::init() {
         Descriptor index(INDEX_ID, SortBamWorker::tr("Build index"),
             SortBamWorker::tr("Build index for the sorted file with SAMTools index."));
 
+        Descriptor memory(MEMORY_ID, SortBamWorker::tr("Memory limit"),
+            SortBamWorker::tr("The maximum memory used for sorting. The input is sorted by parts that fit into the limit and then merged."));
+
         a << new Attribute(outDir, BaseTypes::NUM_TYPE(), false, QVariant(FileAndDirectoryUtils::WORKFLOW_INTERNAL));
         Attribute* customDirAttr = new Attribute(customDir, BaseTypes::STRING_TYPE(), false, QVariant(""));
         customDirAttr->addRelation(new VisibilityRelation(OUT_MODE_ID, FileAndDirectoryUtils::CUSTOM));
         a << customDirAttr;
         a << new Attribute( outName, BaseTypes::STRING_TYPE(), false, QVariant(DEFAULT_NAME));
         a << new Attribute( index, BaseTypes::BOOL_TYPE(), false, QVariant(true));
+        a << new Attribute( memory, BaseTypes::NUM_TYPE(), false, QVariant(500));
     }
 
     QMap<QString, PropertyDelegate*> delegates;
@@ -133,6 +138,12 @@ void SortBamWorkerFactory::init() {
         delegates[OUT_MODE_ID] = new ComboBoxDelegate(directoryMap);
 
         delegates[CUSTOM_DIR_ID] = new URLDelegate("", "", false, true);
+
+        QVariantMap memoryMap;
+        memoryMap["minimum"] = 16;
+        memoryMap["maximum"] = INT_MAX;
+        memoryMap["suffix"] = " Mb";
+        delegates[MEMORY_ID] = new SpinBoxDelegate(memoryMap);
     }
 
     ActorPrototype* proto = new IntegralBusActorPrototype(desc, p, a);
@@ -180,6 +191,7 @@ Task * SortBamWorker::tick() {
             setting.outName = getTargetName(url, outputDir);
             setting.inputUrl = url;
             setting.index = getValue<bool>(INDEX_ID);
+            setting.maxMemoryMb = getValue<int>(MEMORY_ID);
 
             Task *t = new SamtoolsSortTask(setting);
             connect(new TaskSignalMapper(t), SIGNAL(si_taskFinished(Task*)), SLOT(sl_taskFinished(Task*)));
@@ -273,10 +285,7 @@ void SamtoolsSortTask::prepare(){
 }
 
 void SamtoolsSortTask::run(){
-    resultUrl = BAMUtils::sortBam(settings.inputUrl, settings.outDir + settings.outName, stateInfo).getURLString();
-    CHECK_OP(stateInfo, );
-
-    BAMUtils::createBamIndex(resultUrl, stateInfo);
+    resultUrl = BAMUtils::sortBam(settings.inputUrl, settings.outDir + settings.outName, stateInfo, settings.maxMemoryMb, settings.index).getURLString();
 }
 
 } //LocalWorkflow
@@ -71,12 +71,13 @@ public:
 
 class BamSortSetting{
 public:
-    BamSortSetting(): outDir(""), outName(""),inputUrl(""), index(true){}
+    BamSortSetting(): outDir(""), outName(""),inputUrl(""), index(true), maxMemoryMb(0){}
 
     QString outDir;
     QString outName;
     QString inputUrl;
     bool    index;
+    int     maxMemoryMb;
 };
 
 class SamtoolsSortTask : public Task {
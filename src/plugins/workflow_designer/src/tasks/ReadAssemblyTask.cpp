@@ -109,12 +109,13 @@ void ConvertToIndexedBamTask::run() {
             baseName = dir + "/" + bamUrl.fileName();
         }
         baseName +=  ".sorted";
-        sortedBamUrl = BAMUtils::sortBam(bamUrl, baseName, stateInfo);
+        sortedBamUrl = BAMUtils::sortBam(bamUrl, baseName, stateInfo, 0, true);
         CHECK_OP(stateInfo, );
         addConvertedFile(sortedBamUrl);
     }
 
-    bool indexed = sorted && BAMUtils::hasValidBamIndex(sortedBamUrl);
+    // the index is built during sorting
+    bool indexed = !sorted || BAMUtils::hasValidBamIndex(sortedBamUrl);
     if (!indexed) {
         BAMUtils::createBamIndex(sortedBamUrl, stateInfo);
         CHECK_OP(stateInfo, );
@@ -33,6 +33,7 @@ HEADERS += src/ActorCfgFilterProxyModel.h \
            src/WorkflowViewItems.h \
            src/cmdline/GalaxyConfigTask.h \
            src/cmdline/WorkflowCMDLineTasks.h \
+           src/cmdline/WorkflowDaemonTask.h \
            src/debug_messages_translation/AnnotationsMessageTranslator.h \
            src/debug_messages_translation/AssemblyMessageTranslator.h \
            src/debug_messages_translation/BaseMessageTranslator.h \
@@ -142,6 +143,7 @@ SOURCES += src/ActorCfgFilterProxyModel.cpp \
            src/WorkflowViewItems.cpp \
            src/cmdline/GalaxyConfigTask.cpp \
            src/cmdline/WorkflowCMDLineTasks.cpp \
+           src/cmdline/WorkflowDaemonTask.cpp \
            src/debug_messages_translation/AnnotationsMessageTranslator.cpp \
            src/debug_messages_translation/AssemblyMessageTranslator.cpp \
            src/debug_messages_translation/BaseMessageTranslator.cpp \
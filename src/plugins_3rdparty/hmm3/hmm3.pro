@@ -14,6 +14,9 @@ HEADERS += src/uHMM3Plugin.h \
            src/phmmer/uhmm3phmmer.h \
            src/phmmer/uHMM3PhmmerDialogImpl.h \
            src/phmmer/uhmm3PhmmerTask.h \
+           src/search/uhmm3DatabaseSearch.h \
+           src/search/uHMM3DatabaseSearchTask.h \
+           src/search/uHMM3LocalSearchTask.h \
            src/search/uhmm3search.h \
            src/search/uHMM3SearchDialogImpl.h \
            src/search/uhmm3SearchResult.h \
@@ -95,6 +98,9 @@ SOURCES += src/uHMM3Plugin.cpp \
            src/phmmer/uhmm3phmmer.cpp \
            src/phmmer/uHMM3PhmmerDialogImpl.cpp \
            src/phmmer/uhmm3PhmmerTask.cpp \
+           src/search/uhmm3DatabaseSearch.cpp \
+           src/search/uHMM3DatabaseSearchTask.cpp \
+           src/search/uHMM3LocalSearchTask.cpp \
            src/search/uhmm3search.cpp \
            src/search/uHMM3SearchDialogImpl.cpp \
            src/search/uhmm3SearchResult.cpp \
@@ -0,0 +1,243 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTextStream>
+
+#include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/GUrl.h>
+#include <U2Core/IOAdapter.h>
+#include <U2Core/IOAdapterUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/LoadDocumentTask.h>
+#include <U2Core/Log.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Formats/StreamSequenceReader.h>
+
+#include <format/uHMMFormat.h>
+#include <task_local_storage/uHMMSearchTaskLocalStorage.h>
+#include <util/uhmm3Utilities.h>
+
+#include "uHMM3DatabaseSearchTask.h"
+
+namespace U2 {
+
+/*****************************************************
+* UHMM3DatabaseSearchTask
+*****************************************************/
+
+UHMM3DatabaseSearchTask::UHMM3DatabaseSearchTask( const UHMM3SearchTaskSettings& _settings, const QList<const P7_HMM*>& _hmms, const QString& _dbUrl )
+: Task( tr( "HMM search with %1 profiles in '%2'" ).arg( _hmms.size() ).arg( _dbUrl ), TaskFlags_NR_FOSE_COSC ),
+  settings( _settings ), hmms( _hmms ), isPhmmer( false ), dbUrl( _dbUrl ),
+  passIndex( 0 ), passCount( 0 ), activeWorkers( 0 ), sequencesRead( 0 ) {
+    passCount = ( hmms.size() + PROFILES_PER_PASS - 1 ) / PROFILES_PER_PASS;
+    tpm = Progress_Manual;
+}
+
+UHMM3DatabaseSearchTask::UHMM3DatabaseSearchTask( const UHMM3PhmmerSettings& _settings, const DNASequence& _query, const QString& _dbUrl )
+: Task( tr( "PHMMER search of '%1' in '%2'" ).arg( _query.getName() ).arg( _dbUrl ), TaskFlags_NR_FOSE_COSC ),
+  phmmerSettings( _settings ), query( _query ), isPhmmer( true ), dbUrl( _dbUrl ),
+  passIndex( 0 ), passCount( 1 ), activeWorkers( 0 ), sequencesRead( 0 ) {
+    tpm = Progress_Manual;
+}
+
+UHMM3DatabaseSearchTask::~UHMM3DatabaseSearchTask() {
+    qDeleteAll( passProfiles );
+}
+
+void UHMM3DatabaseSearchTask::prepare() {
+    if( isPhmmer ) {
+        CHECK_EXT( !query.seq.isEmpty(), setError( tr( "No input query sequence given" ) ), );
+        CHECK_EXT( phmmerSettings.isValid(), setError( tr( "Invalid PHMMER settings given" ) ), );
+    } else {
+        CHECK_EXT( !hmms.isEmpty(), setError( tr( "Bad HMM profile given" ) ), );
+    }
+
+    setMaxParallelSubtasks( AppResourcePool::instance()->getIdealThreadCount() );
+    foreach( Task* worker, startPass() ) {
+        addSubTask( worker );
+    }
+}
+
+QList<Task*> UHMM3DatabaseSearchTask::startPass() {
+    QList<Task*> workers;
+    if( isPhmmer ) {
+        passProfiles << new UHMM3DatabaseSearchProfile( query.seq, query.getName(), phmmerSettings );
+    } else {
+        foreach( const P7_HMM* hmm, hmms.mid( passIndex * PROFILES_PER_PASS, PROFILES_PER_PASS ) ) {
+            passProfiles << new UHMM3DatabaseSearchProfile( hmm, settings.inner );
+        }
+    }
+
+    reader.reset( new StreamSequenceReader() );
+    sequencesRead = 0;
+    if( !reader->init( QList<GUrl>() << dbUrl ) ) {
+        setError( tr( "Can not read the sequence database '%1': %2" ).arg( dbUrl ).arg( reader->getErrorMessage() ) );
+        return workers;
+    }
+
+    int threads = AppResourcePool::instance()->getIdealThreadCount();
+    for( int i = 0; i < threads; i++ ) {
+        workers << new UHMM3DatabaseSearchWorker( this );
+    }
+    activeWorkers = workers.size();
+    return workers;
+}
+
+void UHMM3DatabaseSearchTask::finishPass() {
+    foreach( UHMM3DatabaseSearchProfile* profile, passProfiles ) {
+        results << profile->takeResult( stateInfo );
+    }
+    qDeleteAll( passProfiles );
+    passProfiles.clear();
+    reader.reset();
+    algoLog.trace( QString( "%1: pass %2 of %3 finished, %4 sequences searched" ).arg( getTaskName() ).arg( passIndex + 1 ).arg( passCount ).arg( sequencesRead ) );
+}
+
+QList<Task*> UHMM3DatabaseSearchTask::onSubTaskFinished( Task* subTask ) {
+    Q_UNUSED( subTask );
+    QList<Task*> res;
+    CHECK_OP( stateInfo, res );
+
+    activeWorkers--;
+    CHECK( 0 == activeWorkers, res );
+
+    finishPass();
+    CHECK_OP( stateInfo, res );
+    passIndex++;
+    if( passIndex < passCount ) {
+        res << startPass();
+    }
+    return res;
+}
+
+QList<UHMM3DatabaseSearchResult> UHMM3DatabaseSearchTask::getResult() const {
+    assert( isFinished() );
+    return results;
+}
+
+bool UHMM3DatabaseSearchTask::readBatch( QList<DNASequence>& batch, TaskStateInfo& ti ) {
+    batch.clear();
+    QMutexLocker locker( &readLock );
+    CHECK( !reader.isNull(), false );
+
+    qint64 residues = 0;
+    while( batch.size() < BATCH_SEQUENCES && residues < BATCH_RESIDUES && reader->hasNext() ) {
+        const DNASequence* seq = reader->getNextSequenceObject();
+        CHECK_BREAK( NULL != seq );
+        batch << *seq;
+        residues += seq->length();
+    }
+    if( reader->hasError() ) {
+        ti.setError( tr( "Error reading the sequence database '%1': %2" ).arg( dbUrl ).arg( reader->getErrorMessage() ) );
+        return false;
+    }
+    sequencesRead += batch.size();
+    // the progress is cumulative over all passes, workers show the same value
+    stateInfo.progress = ( 100 * passIndex + reader->getProgress() ) / passCount;
+    ti.progress = stateInfo.progress;
+    return !batch.isEmpty();
+}
+
+/*****************************************************
+* UHMM3DatabaseSearchWorker
+*****************************************************/
+
+UHMM3DatabaseSearchWorker::UHMM3DatabaseSearchWorker( UHMM3DatabaseSearchTask* _dbTask )
+: Task( tr( "HMM database search worker" ), TaskFlag_None ), dbTask( _dbTask ) {
+    SAFE_POINT( NULL != dbTask, "Database search task is NULL", );
+}
+
+void UHMM3DatabaseSearchWorker::run() {
+    UHMM3SearchTaskLocalStorage::createTaskContext( getTaskId() );
+    QList<DNASequence> batch;
+    while( !stateInfo.isCoR() && dbTask->readBatch( batch, stateInfo ) ) {
+        foreach( UHMM3DatabaseSearchProfile* profile, dbTask->getPassProfiles() ) {
+            profile->searchBatch( batch, stateInfo );
+            CHECK_OP_BREAK( stateInfo );
+        }
+    }
+    UHMM3SearchTaskLocalStorage::freeTaskContext( getTaskId() );
+}
+
+/*****************************************************
+* UHMM3DatabaseSearchToFileTask
+*****************************************************/
+
+UHMM3DatabaseSearchToFileTask::UHMM3DatabaseSearchToFileTask( const UHMM3SearchTaskSettings& _settings, const QString& hmmUrl,
+                                                              const QString& _dbUrl, const QString& _outUrl )
+: Task( tr( "HMM search with '%1' in '%2'" ).arg( hmmUrl ).arg( _dbUrl ), TaskFlags_NR_FOSE_COSC | TaskFlag_ReportingIsSupported ),
+  settings( _settings ), dbUrl( _dbUrl ), outUrl( _outUrl ), loadHmmTask( NULL ), searchTask( NULL ), hitsCount( 0 ) {
+    IOAdapterFactory* iof = AppContext::getIOAdapterRegistry()->getIOAdapterFactoryById( IOAdapterUtils::url2io( hmmUrl ) );
+    SAFE_POINT_EXT( NULL != iof, setError( L10N::nullPointerError( "IOAdapterFactory" ) ), );
+    loadHmmTask = new LoadDocumentTask( UHMMFormat::UHHMER_FORMAT_ID, hmmUrl, iof );
+    addSubTask( loadHmmTask );
+}
+
+QList<Task*> UHMM3DatabaseSearchToFileTask::onSubTaskFinished( Task* subTask ) {
+    QList<Task*> res;
+    CHECK_OP( stateInfo, res );
+    CHECK( subTask == loadHmmTask, res );
+
+    QList<const P7_HMM*> hmms = UHMM3Utilities::getHmmsFromDocument( loadHmmTask->getDocument(), stateInfo );
+    CHECK_OP( stateInfo, res );
+    CHECK_EXT( !hmms.isEmpty(), setError( tr( "No HMM profiles found in the file" ) ), res );
+
+    searchTask = new UHMM3DatabaseSearchTask( settings, hmms, dbUrl );
+    res << searchTask;
+    return res;
+}
+
+void UHMM3DatabaseSearchToFileTask::run() {
+    SAFE_POINT_EXT( NULL != searchTask, setError( L10N::nullPointerError( "UHMM3DatabaseSearchTask" ) ), );
+    QFile file( outUrl );
+    CHECK_EXT( file.open( QIODevice::WriteOnly | QIODevice::Truncate ), setError( L10N::errorOpeningFileWrite( outUrl ) ), );
+
+    QTextStream out( &file );
+    out << "# target name\tquery name\tE-value\tscore\tbias\treported domains\n";
+    foreach( const UHMM3DatabaseSearchResult& profileResult, searchTask->getResult() ) {
+        foreach( const UHMM3DatabaseSearchHit& hit, profileResult.hits ) {
+            const UHMM3SearchCompleteSeqResult& seqResult = hit.result.fullSeqResult;
+            out << hit.sequenceName << '\t' << profileResult.profileName << '\t' << seqResult.eval << '\t'
+                << seqResult.score << '\t' << seqResult.bias << '\t' << seqResult.reportedDomainsNum << '\n';
+            hitsCount++;
+        }
+    }
+    out.flush();
+    CHECK_EXT( QFile::NoError == file.error(), setError( L10N::errorWritingFile( outUrl ) ), );
+}
+
+QString UHMM3DatabaseSearchToFileTask::generateReport() const {
+    QString res;
+    if( hasError() || isCanceled() ) {
+        return res;
+    }
+    res += "<b>" + tr( "Sequence database:" ) + "</b> " + dbUrl + "<br>";
+    res += "<b>" + tr( "Hits found:" ) + "</b> " + QString::number( hitsCount ) + "<br>";
+    res += "<b>" + tr( "Hits table:" ) + "</b> " + outUrl + "<br>";
+    return res;
+}
+
+} // U2
@@ -0,0 +1,130 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _GB2_UHMM3_DATABASE_SEARCH_TASK_H_
+#define _GB2_UHMM3_DATABASE_SEARCH_TASK_H_
+
+#include <QtCore/QMutex>
+#include <QtCore/QScopedPointer>
+
+#include <U2Core/DNASequence.h>
+#include <U2Core/Task.h>
+
+#include <phmmer/uhmm3phmmer.h>
+
+#include "uHMM3SearchTask.h"
+#include "uhmm3DatabaseSearch.h"
+
+namespace U2 {
+
+class LoadDocumentTask;
+class StreamSequenceReader;
+
+/**************************************
+* Search of profiles in a sequence database (multi-FASTA or other sequence file).
+* The database is streamed by batches, the batches are searched by several workers.
+**************************************/
+class UHMM3DatabaseSearchTask : public Task {
+    Q_OBJECT
+public:
+    /* hmmsearch: every profile is searched in every database sequence */
+    UHMM3DatabaseSearchTask( const UHMM3SearchTaskSettings& settings, const QList<const P7_HMM*>& hmms, const QString& dbUrl );
+    /* phmmer: the query sequence is searched in every database sequence */
+    UHMM3DatabaseSearchTask( const UHMM3PhmmerSettings& settings, const DNASequence& query, const QString& dbUrl );
+    ~UHMM3DatabaseSearchTask();
+
+    virtual void prepare();
+    virtual QList<Task*> onSubTaskFinished( Task* subTask );
+
+    /* one result per profile */
+    QList<UHMM3DatabaseSearchResult> getResult() const;
+
+    /* thread-safe: reads the next batch of the database, returns false when the database is over */
+    bool readBatch( QList<DNASequence>& batch, TaskStateInfo& ti );
+    /* profiles searched during the current pass over the database */
+    const QList<UHMM3DatabaseSearchProfile*>& getPassProfiles() const { return passProfiles; }
+
+    /* profiles searched in one pass over the database, limits the memory used for Pfam-sized sets */
+    static const int PROFILES_PER_PASS = 256;
+    static const int BATCH_SEQUENCES = 512;
+    static const int BATCH_RESIDUES = 1024 * 1024;
+
+private:
+    QList<Task*> startPass();
+    void finishPass();
+
+    UHMM3SearchTaskSettings                 settings;
+    QList<const P7_HMM*>                    hmms;
+    UHMM3PhmmerSettings                     phmmerSettings;
+    DNASequence                             query;
+    bool                                    isPhmmer;
+    QString                                 dbUrl;
+
+    int                                     passIndex;
+    int                                     passCount;
+    int                                     activeWorkers;
+    QList<UHMM3DatabaseSearchProfile*>      passProfiles;
+    QList<UHMM3DatabaseSearchResult>        results;
+
+    QMutex                                  readLock;
+    QScopedPointer<StreamSequenceReader>    reader;
+    qint64                                  sequencesRead;
+
+}; // UHMM3DatabaseSearchTask
+
+class UHMM3DatabaseSearchWorker : public Task {
+    Q_OBJECT
+public:
+    UHMM3DatabaseSearchWorker( UHMM3DatabaseSearchTask* dbTask );
+    virtual void run();
+
+private:
+    UHMM3DatabaseSearchTask* dbTask;
+
+}; // UHMM3DatabaseSearchWorker
+
+/**************************************
+* Loads profiles from an HMM file, searches them in a sequence database
+* and writes the reported hits into a tab-delimited file.
+**************************************/
+class UHMM3DatabaseSearchToFileTask : public Task {
+    Q_OBJECT
+public:
+    UHMM3DatabaseSearchToFileTask( const UHMM3SearchTaskSettings& settings, const QString& hmmUrl, const QString& dbUrl, const QString& outUrl );
+
+    virtual QList<Task*> onSubTaskFinished( Task* subTask );
+    virtual void run();
+    virtual QString generateReport() const;
+
+private:
+    UHMM3SearchTaskSettings     settings;
+    QString                     dbUrl;
+    QString                     outUrl;
+    LoadDocumentTask*           loadHmmTask;
+    UHMM3DatabaseSearchTask*    searchTask;
+    int                         hitsCount;
+
+}; // UHMM3DatabaseSearchToFileTask
+
+} // U2
+
+#endif // _GB2_UHMM3_DATABASE_SEARCH_TASK_H_
@@ -0,0 +1,310 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <U2Core/AppContext.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "uHMM3LocalSearchTask.h"
+
+namespace U2 {
+
+static const int MIN_PART_TO_OVERLAP_RATIO = 4;
+
+static QVariant serializeRegion(const U2Region& region) {
+    return QVariantList() << region.startPos << region.length;
+}
+
+static U2Region deserializeRegion(const QVariant& data) {
+    QVariantList list = data.toList();
+    CHECK(2 == list.size(), U2Region());
+    return U2Region(list[0].toLongLong(), list[1].toLongLong());
+}
+
+static QVariant serializeSearchSettings(const UHMM3SearchSettings& s) {
+    QVariantMap data;
+    data["e"] = s.e;
+    data["t"] = s.t;
+    data["z"] = s.z;
+    data["domE"] = s.domE;
+    data["domT"] = s.domT;
+    data["domZ"] = s.domZ;
+    data["useBitCutoffs"] = s.useBitCutoffs;
+    data["incE"] = s.incE;
+    data["incT"] = s.incT;
+    data["incDomE"] = s.incDomE;
+    data["incDomT"] = s.incDomT;
+    data["f1"] = s.f1;
+    data["f2"] = s.f2;
+    data["f3"] = s.f3;
+    data["doMax"] = s.doMax;
+    data["noBiasFilter"] = s.noBiasFilter;
+    data["noNull2"] = s.noNull2;
+    data["seed"] = s.seed;
+    return data;
+}
+
+static void deserializeSearchSettings(const QVariantMap& data, UHMM3SearchSettings& s) {
+    s.e = data.value("e", s.e).toDouble();
+    s.t = data.value("t", s.t).toDouble();
+    s.z = data.value("z", s.z).toDouble();
+    s.domE = data.value("domE", s.domE).toDouble();
+    s.domT = data.value("domT", s.domT).toDouble();
+    s.domZ = data.value("domZ", s.domZ).toDouble();
+    s.useBitCutoffs = data.value("useBitCutoffs", s.useBitCutoffs).toInt();
+    s.incE = data.value("incE", s.incE).toDouble();
+    s.incT = data.value("incT", s.incT).toDouble();
+    s.incDomE = data.value("incDomE", s.incDomE).toDouble();
+    s.incDomT = data.value("incDomT", s.incDomT).toDouble();
+    s.f1 = data.value("f1", s.f1).toDouble();
+    s.f2 = data.value("f2", s.f2).toDouble();
+    s.f3 = data.value("f3", s.f3).toDouble();
+    s.doMax = data.value("doMax", s.doMax).toInt();
+    s.noBiasFilter = data.value("noBiasFilter", s.noBiasFilter).toInt();
+    s.noNull2 = data.value("noNull2", s.noNull2).toInt();
+    s.seed = data.value("seed", s.seed).toInt();
+}
+
+static QVariant serializeDomainResult(const UHMM3SWSearchTaskDomainResult& r) {
+    const UHMM3SearchSeqDomainResult& g = r.generalResult;
+    return QVariantList() << g.score << g.bias << g.ival << g.cval
+                          << serializeRegion(g.queryRegion) << serializeRegion(g.seqRegion) << serializeRegion(g.envRegion)
+                          << g.acc << g.isSignificant << r.onCompl << r.onAmino << r.borderResult;
+}
+
+static bool deserializeDomainResult(const QVariant& data, UHMM3SWSearchTaskDomainResult& r) {
+    QVariantList list = data.toList();
+    CHECK(12 == list.size(), false);
+    UHMM3SearchSeqDomainResult& g = r.generalResult;
+    g.score = list[0].toFloat();
+    g.bias = list[1].toFloat();
+    g.ival = list[2].toDouble();
+    g.cval = list[3].toDouble();
+    g.queryRegion = deserializeRegion(list[4]);
+    g.seqRegion = deserializeRegion(list[5]);
+    g.envRegion = deserializeRegion(list[6]);
+    g.acc = list[7].toDouble();
+    g.isSignificant = list[8].toBool();
+    r.onCompl = list[9].toBool();
+    r.onAmino = list[10].toBool();
+    r.borderResult = list[11].toBool();
+    return true;
+}
+
+static bool isSameDomain(const UHMM3SWSearchTaskDomainResult& r1, const UHMM3SWSearchTaskDomainResult& r2) {
+    return r1.onCompl == r2.onCompl && r1.generalResult.seqRegion == r2.generalResult.seqRegion
+        && r1.generalResult.score == r2.generalResult.score;
+}
+
+/*****************************************************
+* UHMM3LocalSearchTaskSettings
+*****************************************************/
+
+UHMM3LocalSearchTaskSettings::UHMM3LocalSearchTaskSettings() : searchSpaceLength(0), overlap(0), offset(0) {
+}
+
+QVariant UHMM3LocalSearchTaskSettings::serialize() const {
+    QVariantMap data;
+    data["hmmFile"] = hmmFilename;
+    data["sequence"] = sequence;
+    data["alphabet"] = alphabetId;
+    data["settings"] = serializeSearchSettings(settings.inner);
+    data["searchSpaceLength"] = searchSpaceLength;
+    data["overlap"] = overlap;
+    data["offset"] = offset;
+    return data;
+}
+
+bool UHMM3LocalSearchTaskSettings::deserialize(const QVariant& data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    QVariantMap map = data.toMap();
+    hmmFilename = map["hmmFile"].toString();
+    sequence = map["sequence"].toByteArray();
+    alphabetId = map["alphabet"].toString();
+    deserializeSearchSettings(map["settings"].toMap(), settings.inner);
+    searchSpaceLength = map["searchSpaceLength"].toInt();
+    overlap = map["overlap"].toInt();
+    offset = map["offset"].toInt();
+    return !hmmFilename.isEmpty() && !sequence.isEmpty();
+}
+
+/*****************************************************
+* UHMM3LocalSearchTaskResult
+*****************************************************/
+
+QVariant UHMM3LocalSearchTaskResult::serialize() const {
+    QVariantList serializedResults;
+    foreach(const QList<UHMM3SWSearchTaskDomainResult>& hmmResults, results) {
+        QVariantList serializedHmmResults;
+        foreach(const UHMM3SWSearchTaskDomainResult& r, hmmResults) {
+            serializedHmmResults << serializeDomainResult(r);
+        }
+        serializedResults << QVariant(serializedHmmResults);
+    }
+    QVariantList serializedLengths;
+    foreach(int length, hmmLengths) {
+        serializedLengths << length;
+    }
+
+    QVariantMap data;
+    data["results"] = serializedResults;
+    data["hmmLengths"] = serializedLengths;
+    data["partRegion"] = serializeRegion(partRegion);
+    return data;
+}
+
+bool UHMM3LocalSearchTaskResult::deserialize(const QVariant& data) {
+    CHECK(data.canConvert(QVariant::Map), false);
+    QVariantMap map = data.toMap();
+    results.clear();
+    foreach(const QVariant& serializedHmmResults, map["results"].toList()) {
+        QList<UHMM3SWSearchTaskDomainResult> hmmResults;
+        foreach(const QVariant& serializedResult, serializedHmmResults.toList()) {
+            UHMM3SWSearchTaskDomainResult r;
+            CHECK(deserializeDomainResult(serializedResult, r), false);
+            hmmResults << r;
+        }
+        results << hmmResults;
+    }
+    hmmLengths.clear();
+    foreach(const QVariant& length, map["hmmLengths"].toList()) {
+        hmmLengths << length.toInt();
+    }
+    partRegion = deserializeRegion(map["partRegion"]);
+    return results.size() == hmmLengths.size();
+}
+
+/*****************************************************
+* UHMM3LocalSearchTask
+*****************************************************/
+
+UHMM3LocalSearchTask::UHMM3LocalSearchTask(const UHMM3LocalSearchTaskSettings& s)
+: LocalTask(tr("HMM search in a sequence part"), TaskFlags_NR_FOSCOE), settings(s), searchTask(NULL) {
+    result.partRegion = U2Region(settings.offset, settings.sequence.length());
+}
+
+void UHMM3LocalSearchTask::prepare() {
+    const DNAAlphabet* alphabet = AppContext::getDNAAlphabetRegistry()->findById(settings.alphabetId);
+    CHECK_EXT(NULL != alphabet, stateInfo.setError(tr("Unknown alphabet: %1").arg(settings.alphabetId)), );
+
+    UHMM3SearchTaskSettings searchSettings = settings.settings;
+    searchSettings.nProcesses = 1;
+    DNASequence part(QString("part %1").arg(settings.offset), settings.sequence, alphabet);
+    searchTask = new UHMM3SWSearchTask(settings.hmmFilename, part, searchSettings);
+    searchTask->setSearchSpaceLength(settings.searchSpaceLength);
+    addSubTask(searchTask);
+}
+
+QList<Task*> UHMM3LocalSearchTask::onSubTaskFinished(Task* subTask) {
+    QList<Task*> res;
+    CHECK(searchTask == subTask, res);
+    CHECK_OP(stateInfo, res);
+
+    for(int i = 0; i < searchTask->getHmmCount(); i++) {
+        QList<UHMM3SWSearchTaskDomainResult> hmmResults = searchTask->getResults(i);
+        for(int j = 0; j < hmmResults.size(); j++) {
+            hmmResults[j].generalResult.seqRegion.startPos += settings.offset;
+            hmmResults[j].generalResult.envRegion.startPos += settings.offset;
+        }
+        result.results << hmmResults;
+        result.hmmLengths << searchTask->getHmmLength(i);
+    }
+    return res;
+}
+
+const LocalTaskResult* UHMM3LocalSearchTask::getResult() const {
+    return hasError() ? NULL : &result;
+}
+
+/*****************************************************
+* UHMM3SearchTaskDistributor
+*****************************************************/
+
+QList<UHMM3LocalSearchTaskSettings*> UHMM3SearchTaskDistributor::scatterParts(const UHMM3LocalSearchTaskSettings* settings, int partCount) const {
+    int seqLen = settings->sequence.length();
+    int overlap = qMax(1, settings->overlap);
+    int parts = qBound(1, seqLen / (MIN_PART_TO_OVERLAP_RATIO * overlap), qMax(1, partCount));
+    int partLen = (seqLen + overlap * (parts - 1) + parts - 1) / parts;
+
+    QList<UHMM3LocalSearchTaskSettings*> res;
+    for(int i = 0; i < parts; i++) {
+        int start = i * (partLen - overlap);
+        int end = (i == parts - 1) ? seqLen : qMin(seqLen, start + partLen);
+
+        UHMM3LocalSearchTaskSettings* part = new UHMM3LocalSearchTaskSettings(*settings);
+        part->sequence = settings->sequence.mid(start, end - start);
+        part->offset = settings->offset + start;
+        res << part;
+    }
+    return res;
+}
+
+UHMM3LocalSearchTaskResult* UHMM3SearchTaskDistributor::gatherParts(const QList<const UHMM3LocalSearchTaskResult*>& parts) const {
+    UHMM3LocalSearchTaskResult* gathered = new UHMM3LocalSearchTaskResult();
+    CHECK(!parts.isEmpty(), gathered);
+    gathered->hmmLengths = parts.first()->hmmLengths;
+
+    QVector<U2Region> partOverlaps;
+    for(int i = 0; i + 1 < parts.size(); i++) {
+        partOverlaps << parts[i]->partRegion.intersect(parts[i + 1]->partRegion);
+    }
+
+    for(int hmmIndex = 0; hmmIndex < gathered->hmmLengths.size(); hmmIndex++) {
+        QList<UHMM3SWSearchTaskDomainResult> results;
+        QList<UHMM3SWSearchTaskDomainResult> overlaps;
+        foreach(const UHMM3LocalSearchTaskResult* part, parts) {
+            foreach(const UHMM3SWSearchTaskDomainResult& r, part->results.value(hmmIndex)) {
+                bool inOverlap = false;
+                foreach(const U2Region& partOverlap, partOverlaps) {
+                    inOverlap = inOverlap || partOverlap.intersects(r.generalResult.seqRegion);
+                }
+                if(!inOverlap) {
+                    results << r;
+                    continue;
+                }
+                // short domains lying entirely in an overlap are found twice
+                bool duplicate = false;
+                foreach(const UHMM3SWSearchTaskDomainResult& o, overlaps) {
+                    duplicate = duplicate || isSameDomain(o, r);
+                }
+                if(!duplicate) {
+                    overlaps << r;
+                }
+            }
+        }
+        UHMM3SWSearchTask::processOverlaps(overlaps, results, gathered->hmmLengths[hmmIndex] / 2);
+        qSort(results.begin(), results.end(), UHMM3SWSearchTask::uhmm3SearchDomainResultLessThan);
+        gathered->results << results;
+    }
+    return gathered;
+}
+
+/*****************************************************
+* UHMM3LocalSearchTaskFactory
+*****************************************************/
+
+const QString UHMM3LocalSearchTaskFactory::ID("HMM3 search");
+
+UHMM3LocalSearchTaskFactory::UHMM3LocalSearchTaskFactory()
+: LocalTaskFactoryTemplate<UHMM3LocalSearchTask, UHMM3LocalSearchTaskSettings, UHMM3LocalSearchTaskResult, UHMM3SearchTaskDistributor>(ID) {
+}
+
+} // U2
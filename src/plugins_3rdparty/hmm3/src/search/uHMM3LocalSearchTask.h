@@ -0,0 +1,103 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _GB2_UHMM3_LOCAL_SEARCH_TASK_H_
+#define _GB2_UHMM3_LOCAL_SEARCH_TASK_H_
+
+#include <U2Remote/LocalTask.h>
+#include <U2Remote/TaskDistributor.h>
+
+#include "uHMM3SearchTask.h"
+
+namespace U2 {
+
+/**************************************
+* Sequence walker search of the profiles of a file in a part of the sequence.
+* Used to distribute UHMM3SWSearchTask to several UGENE processes.
+**************************************/
+class UHMM3LocalSearchTaskSettings : public LocalTaskSettings {
+public:
+    UHMM3LocalSearchTaskSettings();
+
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant& data);
+
+    QString                 hmmFilename;
+    QByteArray              sequence;
+    QString                 alphabetId;
+    UHMM3SearchTaskSettings settings;
+    /* length of the whole sequence, e-values are calculated for it */
+    int                     searchSpaceLength;
+    /* neighbouring parts share this number of positions */
+    int                     overlap;
+    /* position of the part in the whole sequence */
+    int                     offset;
+    
+}; // UHMM3LocalSearchTaskSettings
+
+class UHMM3LocalSearchTaskResult : public LocalTaskResult {
+public:
+    virtual QVariant serialize() const;
+    virtual bool deserialize(const QVariant& data);
+
+    /* results of every profile in the whole sequence coordinates */
+    QList< QList<UHMM3SWSearchTaskDomainResult> > results;
+    QList<int>  hmmLengths;
+    U2Region    partRegion;
+    
+}; // UHMM3LocalSearchTaskResult
+
+class UHMM3LocalSearchTask : public LocalTask {
+    Q_OBJECT
+public:
+    UHMM3LocalSearchTask(const UHMM3LocalSearchTaskSettings& settings);
+
+    virtual void prepare();
+    QList<Task*> onSubTaskFinished(Task* subTask);
+    const LocalTaskResult* getResult() const;
+
+private:
+    UHMM3LocalSearchTaskSettings    settings;
+    UHMM3SWSearchTask*              searchTask;
+    UHMM3LocalSearchTaskResult      result;
+    
+}; // UHMM3LocalSearchTask
+
+/* The domains found in the overlaps of the parts are processed as UHMM3SWSearchTask processes the overlaps of its chunks */
+class UHMM3SearchTaskDistributor : public TaskDistributorTemplate<UHMM3LocalSearchTaskSettings, UHMM3LocalSearchTaskResult> {
+protected:
+    QList<UHMM3LocalSearchTaskSettings*> scatterParts(const UHMM3LocalSearchTaskSettings* settings, int partCount) const;
+    UHMM3LocalSearchTaskResult* gatherParts(const QList<const UHMM3LocalSearchTaskResult*>& results) const;
+    
+}; // UHMM3SearchTaskDistributor
+
+class UHMM3LocalSearchTaskFactory : public LocalTaskFactoryTemplate<UHMM3LocalSearchTask, UHMM3LocalSearchTaskSettings,
+                                                                    UHMM3LocalSearchTaskResult, UHMM3SearchTaskDistributor> {
+public:
+    UHMM3LocalSearchTaskFactory();
+
+    static const QString ID;
+    
+}; // UHMM3LocalSearchTaskFactory
+
+} // U2
+
+#endif // _GB2_UHMM3_LOCAL_SEARCH_TASK_H_
@@ -37,6 +37,7 @@
 #include <U2Gui/U2FileDialog.h>
 
 #include <U2Remote/DistributedComputingUtil.h>
+#include <U2Remote/LocalTaskDistribution.h>
 
 #include "uHMM3SearchDialogImpl.h"
 #include "gobject/uHMMObject.h"
@@ -109,6 +110,8 @@ void UHMM3SearchDialogImpl::setModelValues() {
     f2DoubleSpinBox->setValue(settings.f2);
     f3DoubleSpinBox->setValue(settings.f3);
     seedSpinBox->setValue(settings.seed);
+    processesSpinBox->setMaximum(LocalTaskDistributionTask::getDefaultProcessCount());
+    processesSpinBox->setValue(model.searchSettings.nProcesses);
 }
 
 void UHMM3SearchDialogImpl::getModelValues() {
@@ -148,6 +151,7 @@ void UHMM3SearchDialogImpl::getModelValues() {
     settings.f3 = f3DoubleSpinBox->value();
 
     settings.seed = seedSpinBox->value();
+    model.searchSettings.nProcesses = processesSpinBox->value();
 
     model.hmmfile = queryHmmFileEdit->text();
 }
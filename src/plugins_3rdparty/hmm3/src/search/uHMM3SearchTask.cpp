@@ -37,11 +37,14 @@
 #include <U2Core/U1AnnotationUtils.h>
 #include <U2Core/U2SafePoints.h>
 
+#include <U2Remote/LocalTaskDistribution.h>
+
 #include <format/uHMMFormat.h>
 #include <gobject/uHMMObject.h>
 #include <task_local_storage/uHMMSearchTaskLocalStorage.h>
 #include <util/uhmm3Utilities.h>
 
+#include "uHMM3LocalSearchTask.h"
 #include "uHMM3SearchTask.h"
 
 #define UHMM3_SEARCH_LOG_CAT "hmm3_search_log_category"
@@ -76,7 +79,8 @@ static void recountUHMM3SWSearchRegions(UHMM3SearchSeqDomainResult& res, bool is
 
 UHMM3SWSearchTask::UHMM3SWSearchTask(const P7_HMM* h, const DNASequence& s, const UHMM3SearchTaskSettings& set, int ch)
 : Task("", TaskFlag_NoRun), sequence(s), settings(set),
-  complTranslation(NULL), aminoTranslation(NULL), swTask(NULL), loadHmmTask(NULL), searchChunkSize(ch) {
+  complTranslation(NULL), aminoTranslation(NULL), swTask(NULL), loadHmmTask(NULL), searchChunkSize(ch),
+  searchSpaceLength(0), distributionTask(NULL) {
     GCOUNTER(cvar, tvar, "UHMM3SWSearchTask");
 
 
@@ -99,7 +103,8 @@ UHMM3SWSearchTask::UHMM3SWSearchTask(const P7_HMM* h, const DNASequence& s, cons
 
 UHMM3SWSearchTask::UHMM3SWSearchTask(const QString& hF, const DNASequence& seq, const UHMM3SearchTaskSettings& s, int ch)
 : Task("", TaskFlag_NoRun), sequence(seq), settings(s),
-  complTranslation(NULL), aminoTranslation(NULL), swTask(NULL), loadHmmTask(NULL), hmmFilename(hF), searchChunkSize(ch) {
+  complTranslation(NULL), aminoTranslation(NULL), swTask(NULL), loadHmmTask(NULL), hmmFilename(hF), searchChunkSize(ch),
+  searchSpaceLength(0), distributionTask(NULL) {
 
     assert(searchChunkSize > 0);
     if(hmmFilename.isEmpty()) {
@@ -147,6 +152,28 @@ SequenceWalkerTask* UHMM3SWSearchTask::getSWSubtask() {
     return new SequenceWalkerTask(config, this, tr("HMM search task with amino and complement translations"));
 }
 
+LocalTaskDistributionTask* UHMM3SWSearchTask::getDistributionSubtask() {
+    LocalTaskFactoryRegistry* ltfr = AppContext::getLocalTaskFactoryRegistry();
+    CHECK(settings.nProcesses > 1 && NULL != ltfr && NULL != ltfr->getLocalTaskFactory(UHMM3LocalSearchTaskFactory::ID), NULL);
+    SAFE_POINT(!hmms.isEmpty(), "UHMM3SWSearchTask::getDistributionSubtask:: No HMM profiles", NULL);
+    CHECK(checkAlphabets(hmms.first()->abc->type, sequence.alphabet), NULL);
+
+    int maxHmmLength = 0;
+    foreach(const P7_HMM* hmm, hmms) {
+        maxHmmLength = qMax(maxHmmLength, hmm->M);
+    }
+
+    UHMM3LocalSearchTaskSettings* localSettings = new UHMM3LocalSearchTaskSettings();
+    localSettings->hmmFilename = QFileInfo(hmmFilename).absoluteFilePath();
+    localSettings->sequence = sequence.seq;
+    localSettings->alphabetId = sequence.alphabet->getId();
+    localSettings->settings = settings;
+    localSettings->searchSpaceLength = sequence.length();
+    // a domain of an amino profile takes 3 nucleotides per a profile position
+    localSettings->overlap = 2 * 3 * maxHmmLength;
+    return new LocalTaskDistributionTask(UHMM3LocalSearchTaskFactory::ID, localSettings, settings.nProcesses);
+}
+
 void UHMM3SWSearchTask::prepare() {
     if(hasError()) {
         return;
@@ -182,12 +209,27 @@ QList< Task* > UHMM3SWSearchTask::onSubTaskFinished(Task* subTask) {
             results[i] = QList<UHMM3SWSearchTaskDomainResult>();
             overlaps[i] = QList<UHMM3SWSearchTaskDomainResult>();
         }
+        if(hasError()) {
+            return res;
+        }
+        distributionTask = getDistributionSubtask();
+        if(NULL != distributionTask) {
+            res << distributionTask;
+            return res;
+        }
+        CHECK_OP(stateInfo, res);
         swTask = getSWSubtask();
         if(NULL == swTask) {
             assert(hasError());
             return res;
         }
         res << swTask;
+    } else if(distributionTask == subTask) {
+        const UHMM3LocalSearchTaskResult* distributedResult = dynamic_cast<const UHMM3LocalSearchTaskResult*>(distributionTask->getResult());
+        CHECK_EXT(NULL != distributedResult, stateInfo.setError(tr("HMM search results have not been received from the worker processes")), res);
+        for(int i = 0; i < hmms.size(); i++) {
+            results[i] = distributedResult->results.value(i);
+        }
     } else {
         if(swTask != subTask) {
             assert(0 && "undefined_subtask_finished");
@@ -207,7 +249,7 @@ void UHMM3SWSearchTask::onRegion(SequenceWalkerSubtask* t, TaskStateInfo& ti) {
     int seqLen      = t->getRegionSequenceLen();
 
     UHMM3SearchTaskLocalStorage::createTaskContext(t->getTaskId());
-    int wholeSeqSz = t->getGlobalConfig().seqSize;
+    int wholeSeqSz = searchSpaceLength > 0 ? searchSpaceLength : t->getGlobalConfig().seqSize;
     wholeSeqSz = t->isAminoTranslated() ? (wholeSeqSz / 3) : wholeSeqSz;
     QList<UHMM3SearchResult > generalResults;
     foreach(const P7_HMM* hmm, hmms){
@@ -407,6 +449,23 @@ bool UHMM3SWSearchTask::setTranslations(int hmmAl, const DNAAlphabet* seqAl) {
     return true;
 }
 
+int UHMM3SWSearchTask::getHmmCount() const {
+    return hmms.size();
+}
+
+QList<UHMM3SWSearchTaskDomainResult> UHMM3SWSearchTask::getResults(int hmmIndex) const {
+    return results.value(hmmIndex);
+}
+
+int UHMM3SWSearchTask::getHmmLength(int hmmIndex) const {
+    SAFE_POINT(0 <= hmmIndex && hmmIndex < hmms.size(), "Invalid HMM index", 0);
+    return hmms.at(hmmIndex)->M;
+}
+
+void UHMM3SWSearchTask::setSearchSpaceLength(int length) {
+    searchSpaceLength = length;
+}
+
 QList<UHMM3SWSearchTaskDomainResult> UHMM3SWSearchTask::getResults() const {
     QList<UHMM3SWSearchTaskDomainResult> res;
     for(int i = 0; i<hmms.size(); i++){
@@ -457,7 +516,7 @@ QList<SharedAnnotationData> UHMM3SWSearchTask::getResultsAsAnnotations(U2Feature
  * UHMM3SearchTaskSettings
  *****************************************************/
 
-UHMM3SearchTaskSettings::UHMM3SearchTaskSettings() {
+UHMM3SearchTaskSettings::UHMM3SearchTaskSettings() : nProcesses(1) {
     setDefaultUHMM3SearchSettings(&inner);
 }
 
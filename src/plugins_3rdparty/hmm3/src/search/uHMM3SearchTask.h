@@ -45,6 +45,8 @@ class LoadDocumentTask;
 class UHMM3SearchTaskSettings {
 public:
     UHMM3SearchSettings inner;
+    /* UGENE processes the sequence walker search with a profile file is distributed to */
+    int                 nProcesses;
     UHMM3SearchTaskSettings();
 }; // UHMMER3SearchTaskSettings
 
@@ -98,6 +100,8 @@ private:
 * Sequence walker version of hmmer3 search task.
 **************************************/
 /* we cover only domains results here */
+class LocalTaskDistributionTask;
+
 class UHMM3SWSearchTaskDomainResult {
 public:
     UHMM3SWSearchTaskDomainResult() : onCompl(false), onAmino(false), borderResult(false), filtered(false) {}
@@ -131,6 +135,13 @@ public:
     virtual void prepare();
     
     QList<UHMM3SWSearchTaskDomainResult> getResults() const;
+    /* results of the hmmIndex-th profile of the file */
+    int getHmmCount() const;
+    QList<UHMM3SWSearchTaskDomainResult> getResults(int hmmIndex) const;
+    int getHmmLength(int hmmIndex) const;
+    
+    /* the sequence is a part of a longer one: e-values are calculated for the whole sequence length */
+    void setSearchSpaceLength(int length);
     
     static QList< SharedAnnotationData > getResultsAsAnnotations(const QList<UHMM3SWSearchTaskDomainResult> & results,
         const P7_HMM * hmm, U2FeatureType type, const QString & name);
@@ -149,6 +160,7 @@ private:
     bool setTranslations(int hmmAl, const DNAAlphabet* seqAl);
     bool checkAlphabets(int hmmAl, const DNAAlphabet* seqAl);
     SequenceWalkerTask* getSWSubtask();
+    LocalTaskDistributionTask* getDistributionSubtask();
     
 private:
     QList<const P7_HMM*>                hmms;
@@ -163,6 +175,8 @@ private:
     LoadDocumentTask*                   loadHmmTask;
     QString                             hmmFilename;
     int                                 searchChunkSize;
+    int                                 searchSpaceLength;
+    LocalTaskDistributionTask*          distributionTask;
     
 }; // UHMM3SWSearchTask
 
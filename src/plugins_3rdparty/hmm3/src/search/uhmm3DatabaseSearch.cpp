@@ -0,0 +1,273 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#include <QtCore/QMutexLocker>
+
+#include <U2Core/Log.h>
+
+#include <util/uhmm3Utilities.h>
+
+#include "uhmm3DatabaseSearch.h"
+
+namespace U2 {
+
+const int DB_SEARCH_PERCENT_PER_FILTERS = 20;
+const int DB_PHMMER_SINGLE_BUILDER_PROGRESS = 15;
+
+UHMM3DatabaseSearchProfile::UHMM3DatabaseSearchProfile( const P7_HMM* _hmm, const UHMM3SearchSettings& _settings )
+: hmm( _hmm ), settings( _settings ), prepared( false ), abc( NULL ), bg( NULL ), om( NULL ), pli( NULL ), th( NULL ) {
+    assert( NULL != hmm );
+    name = QString::fromLatin1( hmm->name );
+}
+
+UHMM3DatabaseSearchProfile::UHMM3DatabaseSearchProfile( const QByteArray& _querySeq, const QString& queryName, const UHMM3PhmmerSettings& _settings )
+: hmm( NULL ), querySeq( _querySeq ), phmmerSettings( _settings ), settings( _settings.getSearchSettings() ), name( queryName ),
+  prepared( false ), abc( NULL ), bg( NULL ), om( NULL ), pli( NULL ), th( NULL ) {
+}
+
+UHMM3DatabaseSearchProfile::~UHMM3DatabaseSearchProfile() {
+    destroyAll();
+}
+
+void UHMM3DatabaseSearchProfile::destroyAll() {
+    if( NULL != th )    { p7_tophits_Destroy( th );      th = NULL; }
+    if( NULL != pli )   { p7_pipeline_Destroy( pli );    pli = NULL; }
+    if( NULL != om )    { p7_oprofile_Destroy( om );     om = NULL; }
+    if( NULL != bg )    { p7_bg_Destroy( bg );           bg = NULL; }
+    if( NULL != abc )   { esl_alphabet_Destroy( abc );   abc = NULL; }
+}
+
+void UHMM3DatabaseSearchProfile::prepare( TaskStateInfo& ti ) {
+    QMutexLocker locker( &prepareLock );
+    if( prepared ) {
+        if( !prepareError.isEmpty() ) {
+            ti.setError( prepareError );
+        }
+        return;
+    }
+
+    QByteArray errStr;
+    try {
+        if( NULL != hmm ) {
+            configureFromHmm();
+        } else {
+            buildFromQuery( ti );
+        }
+
+        pli = p7_pipeline_Create( &settings, om->M, 100, p7_SEARCH_SEQS );
+        th  = p7_tophits_Create();
+        if( NULL == pli || NULL == th ) {
+            errStr = tr( "Run out of memory" ).toLatin1();
+            throwUHMMER3Exception( errStr.data() );
+        }
+        if( eslOK != p7_pli_NewModel( pli, om, bg ) ) {
+            errStr = tr( "Profile '%1' has no bit score thresholds required by the settings" ).arg( name ).toLatin1();
+            throwUHMMER3Exception( errStr.data() );
+        }
+    } catch( const UHMMER3Exception& ex ) {
+        prepareError = ex.msg;
+    } catch(...) {
+        prepareError = tr( HMMER3_UNKNOWN_ERROR );
+    }
+
+    if( prepareError.isEmpty() && ti.hasError() ) {
+        prepareError = ti.getError();
+    }
+    if( !prepareError.isEmpty() ) {
+        destroyAll();
+        ti.setError( prepareError );
+    }
+    prepared = true;
+}
+
+void UHMM3DatabaseSearchProfile::configureFromHmm() {
+    QByteArray errStr;
+    abc = esl_alphabet_Create( hmm->abc->type );
+    if( NULL == abc ) {
+        errStr = tr( "Run out of memory (creation of alphabet failed)" ).toLatin1();
+        throwUHMMER3Exception( errStr.data() );
+    }
+    bg = p7_bg_Create( abc );
+    if( NULL == bg ) {
+        errStr = tr( "Run out of memory (creation of null model failed)" ).toLatin1();
+        throwUHMMER3Exception( errStr.data() );
+    }
+    P7_PROFILE* gm = p7_profile_Create( hmm->M, abc );
+    om = p7_oprofile_Create( hmm->M, abc );
+    if( NULL == gm || NULL == om ) {
+        if( NULL != gm ) { p7_profile_Destroy( gm ); }
+        errStr = tr( "Run out of memory (creation of optimized profile failed)" ).toLatin1();
+        throwUHMMER3Exception( errStr.data() );
+    }
+    p7_ProfileConfig( hmm, bg, gm, 100, p7_LOCAL ); /* 100 is a dummy length for now; and MSVFilter requires local mode */
+    p7_oprofile_Convert( gm, om );                  /* <om> is now p7_LOCAL, multihit */
+    p7_profile_Destroy( gm );
+}
+
+void UHMM3DatabaseSearchProfile::buildFromQuery( TaskStateInfo& ti ) {
+    QByteArray errStr;
+    abc = esl_alphabet_Create( eslAMINO );
+    if( NULL == abc ) {
+        errStr = tr( "Run out of memory (creating alphabet failed)" ).toLatin1();
+        throwUHMMER3Exception( errStr.data() );
+    }
+    bg = p7_bg_Create( abc );
+    if( NULL == bg ) {
+        errStr = tr( "Run out of memory (creating null model failed)" ).toLatin1();
+        throwUHMMER3Exception( errStr.data() );
+    }
+
+    UHMM3BuildSettings bldSettings = phmmerSettings.getBuildSettings();
+    P7_BUILDER* bld = p7_builder_Create( &bldSettings, abc );
+    ESL_SQ* query = esl_sq_CreateFrom( NULL, querySeq.constData(), querySeq.length(), NULL, NULL, NULL );
+    int status = eslOK;
+    if( NULL == bld || NULL == query ) {
+        errStr = tr( "Run out of memory (creating builder failed)" ).toLatin1();
+    } else if( eslOK != ( status = p7_builder_SetScoreSystem( bld, UHMM3Utilities::convertScoreMatrix( phmmerSettings.substMatr ),
+                                                              phmmerSettings.popen, phmmerSettings.pextend ) ) ) {
+        errStr = tr( "Setting scoring system failed with error: '%1'" ).arg( bld->errbuf ).toLatin1();
+    } else if( eslOK != esl_sq_Digitize( abc, query ) ) {
+        errStr = tr( "Error digitizing query sequence" ).toLatin1();
+    } else {
+        status = p7_SingleBuilder( bld, query, bg, NULL, NULL, NULL, &om, DB_PHMMER_SINGLE_BUILDER_PROGRESS, ti );
+        if( eslCANCELED == status ) {
+            errStr = tr( HMMER3_CANCELED_ERROR ).toLatin1();
+        } else if( eslOK != status ) {
+            errStr = tr( "Error with creating HMM profile for query sequence" ).toLatin1();
+        }
+    }
+    if( NULL != query ) { esl_sq_Destroy( query ); }
+    if( NULL != bld )   { p7_builder_Destroy( bld ); }
+    if( !errStr.isEmpty() ) {
+        throwUHMMER3Exception( errStr.data() );
+    }
+}
+
+void UHMM3DatabaseSearchProfile::searchBatch( const QList<DNASequence>& batch, TaskStateInfo& ti ) {
+    prepare( ti );
+    if( ti.hasError() || ti.cancelFlag ) {
+        return;
+    }
+
+    ESL_SQ        *dbsq     = NULL;
+    P7_BG         *localBg  = NULL;
+    P7_OPROFILE   *localOm  = NULL;
+    P7_PIPELINE   *localPli = NULL;
+    P7_TOPHITS    *localTh  = NULL;
+    int            skipped  = 0;
+    QByteArray     errStr;
+
+    try {
+        localBg  = p7_bg_Create( abc );
+        localOm  = p7_oprofile_Clone( om );
+        localPli = p7_pipeline_Create( &settings, om->M, 100, p7_SEARCH_SEQS );
+        localTh  = p7_tophits_Create();
+        if( NULL == localBg || NULL == localOm || NULL == localPli || NULL == localTh ) {
+            errStr = tr( "Run out of memory" ).toLatin1();
+            throwUHMMER3Exception( errStr.data() );
+        }
+        p7_pli_NewModel( localPli, localOm, localBg );
+
+        foreach( const DNASequence& seq, batch ) {
+            if( ti.cancelFlag ) {
+                break;
+            }
+            QByteArray seqName = seq.getName().toLatin1();
+            dbsq = esl_sq_CreateFrom( seqName.constData(), seq.seq.constData(), seq.length(), NULL, NULL, NULL );
+            if( NULL == dbsq ) {
+                errStr = tr( "Run out of memory (creation of sequence failed)" ).toLatin1();
+                throwUHMMER3Exception( errStr.data() );
+            }
+            if( eslOK != esl_sq_Digitize( abc, dbsq ) ) {
+                skipped++;
+            } else {
+                p7_pli_NewSeq( localPli, dbsq );
+                p7_bg_SetLength( localBg, dbsq->n );
+                p7_oprofile_ReconfigLength( localOm, dbsq->n, dbsq->n );
+
+                // the pipeline reports the progress of one sequence, the caller keeps the progress of the whole database
+                const int dbProgress = ti.progress;
+                int ret = p7_Pipeline( localPli, localOm, localBg, dbsq, localTh, DB_SEARCH_PERCENT_PER_FILTERS, ti, dbsq->n );
+                ti.progress = dbProgress;
+                if( eslCANCELED == ret ) {
+                    errStr = tr( HMMER3_CANCELED_ERROR ).toLatin1();
+                    throwUHMMER3Exception( errStr.data() );
+                }
+                p7_pipeline_Reuse( localPli );
+            }
+            esl_sq_Destroy( dbsq );
+            dbsq = NULL;
+        }
+
+        QMutexLocker locker( &mergeLock );
+        p7_pipeline_Merge( pli, localPli );
+        if( eslOK != p7_tophits_Merge( th, localTh ) ) {
+            errStr = tr( "Run out of memory (merging of top hits lists failed)" ).toLatin1();
+            throwUHMMER3Exception( errStr.data() );
+        }
+    } catch( const UHMMER3Exception& ex ) {
+        ti.setError( ex.msg );
+    } catch(...) {
+        ti.setError( tr( HMMER3_UNKNOWN_ERROR ) );
+    }
+
+    if( 0 < skipped ) {
+        algoLog.info( tr( "%1 sequences with symbols not matching the alphabet of '%2' were skipped" ).arg( skipped ).arg( name ) );
+    }
+    if( NULL != dbsq )     { esl_sq_Destroy( dbsq ); }
+    if( NULL != localTh )  { p7_tophits_Destroy( localTh ); }
+    if( NULL != localPli ) { p7_pipeline_Destroy( localPli ); }
+    if( NULL != localOm )  { p7_oprofile_Destroy( localOm ); }
+    if( NULL != localBg )  { p7_bg_Destroy( localBg ); }
+}
+
+UHMM3DatabaseSearchResult UHMM3DatabaseSearchProfile::takeResult( TaskStateInfo& ti ) {
+    UHMM3DatabaseSearchResult res;
+    res.profileName = name;
+
+    QMutexLocker locker( &mergeLock );
+    if( NULL == th || NULL == pli ) {
+        return res;
+    }
+    try {
+        p7_tophits_Sort( th );
+        p7_tophits_Threshold( th, pli );
+        for( int h = 0; h < th->N; h++ ) {
+            const P7_HIT* hit = th->hit[h];
+            if( !( hit->flags & p7_IS_REPORTED ) ) {
+                continue;
+            }
+            UHMM3DatabaseSearchHit dbHit;
+            dbHit.sequenceName = QString::fromLatin1( hit->name );
+            dbHit.result.fillResults( hit, pli );
+            res.hits << dbHit;
+        }
+    } catch( const UHMMER3Exception& ex ) {
+        ti.setError( ex.msg );
+    } catch(...) {
+        ti.setError( tr( HMMER3_UNKNOWN_ERROR ) );
+    }
+    destroyAll();
+    return res;
+}
+
+} // U2
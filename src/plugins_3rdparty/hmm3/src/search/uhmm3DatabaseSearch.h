@@ -0,0 +1,108 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+
+#ifndef _GB2_UHMM3_DATABASE_SEARCH_H_
+#define _GB2_UHMM3_DATABASE_SEARCH_H_
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include <U2Core/DNASequence.h>
+#include <U2Core/Task.h>
+
+#include <hmmer3/hmmer.h>
+
+#include <phmmer/uhmm3phmmer.h>
+
+#include "uhmm3SearchResult.h"
+
+namespace U2 {
+
+/* hit of one profile in one sequence of a database */
+class UHMM3DatabaseSearchHit {
+public:
+    QString             sequenceName;
+    UHMM3SearchResult   result;
+}; // UHMM3DatabaseSearchHit
+
+/* all reported hits of one profile in a database, E-values are computed for the whole database */
+class UHMM3DatabaseSearchResult {
+public:
+    QString                         profileName;
+    QList<UHMM3DatabaseSearchHit>   hits;
+}; // UHMM3DatabaseSearchResult
+
+/*
+ * Profile of a database search.
+ * The optimized profile is configured once and shared by all threads: every batch of sequences
+ * is searched with a clone of it, its own null model and pipeline, then the pipeline counters and
+ * the hits are merged into the global ones. Thresholds are applied after the whole database is searched,
+ * so the number of targets used for E-values is the number of sequences in the database.
+ */
+class UHMM3DatabaseSearchProfile : public QObject {
+    Q_OBJECT
+public:
+    /* hmmsearch: profile is configured from the HMM */
+    UHMM3DatabaseSearchProfile( const P7_HMM* hmm, const UHMM3SearchSettings& settings );
+    /* phmmer: profile is built from the query sequence */
+    UHMM3DatabaseSearchProfile( const QByteArray& querySeq, const QString& queryName, const UHMM3PhmmerSettings& settings );
+    ~UHMM3DatabaseSearchProfile();
+
+    QString getName() const { return name; }
+
+    /* thread-safe, the profile is prepared by the first call */
+    void searchBatch( const QList<DNASequence>& batch, TaskStateInfo& ti );
+
+    /* thresholds the hits collected from all batches */
+    UHMM3DatabaseSearchResult takeResult( TaskStateInfo& ti );
+
+private:
+    void prepare( TaskStateInfo& ti );
+    void configureFromHmm();
+    void buildFromQuery( TaskStateInfo& ti );
+    void destroyAll();
+
+    const P7_HMM*       hmm;
+    QByteArray          querySeq;
+    UHMM3PhmmerSettings phmmerSettings;
+    UHMM3SearchSettings settings;
+    QString             name;
+
+    QMutex              prepareLock;
+    bool                prepared;
+    QString             prepareError;
+
+    ESL_ALPHABET*       abc;
+    P7_BG*              bg;
+    P7_OPROFILE*        om;
+
+    QMutex              mergeLock;
+    P7_PIPELINE*        pli;
+    P7_TOPHITS*         th;
+
+}; // UHMM3DatabaseSearchProfile
+
+} // U2
+
+#endif // _GB2_UHMM3_DATABASE_SEARCH_H_
@@ -66,8 +66,11 @@ void UHMM3SearchResult::fillDomainsResult( const P7_TOPHITS* th, const P7_PIPELI
         return;
     }
     
-    P7_HIT* hit = th->hit[0];
-    
+    fillDomainsResult( th->hit[0], pli );
+}
+
+void UHMM3SearchResult::fillDomainsResult( const P7_HIT* hit, const P7_PIPELINE* pli ) {
+    assert( NULL != hit );
     int d = 0;
     for( d = 0; d < hit->ndom; d++ ) {
         if( hit->dcl[d].is_reported ) {
@@ -84,11 +87,16 @@ void UHMM3SearchResult::fillFullSeqResults( const P7_TOPHITS* th, const P7_PIPEL
         assert( !fullSeqResult.isReported );
         return;
     }
-    P7_HIT* hit = th->hit[0];
+    fillFullSeqResults( th->hit[0], pli );
+}
+
+void UHMM3SearchResult::fillFullSeqResults( const P7_HIT* hit, const P7_PIPELINE* pli ) {
+    assert( NULL != hit );
     if( !(hit->flags & p7_IS_REPORTED) ) {
         return;
     }
     
+    fullSeqResult.isReported = true;
     fullSeqResult.eval     = hit->pvalue * pli->Z;
     fullSeqResult.score    = hit->score;
     fullSeqResult.bias     = hit->pre_score - hit->score;
@@ -103,4 +111,11 @@ void UHMM3SearchResult::fillResults( const P7_TOPHITS* th, const P7_PIPELINE* pl
     fillDomainsResult(  th, pli );
 }
 
+void UHMM3SearchResult::fillResults( const P7_HIT* hit, const P7_PIPELINE* pli ) {
+    assert( NULL != hit );
+    assert( NULL != pli );
+    fillFullSeqResults( hit, pli );
+    fillDomainsResult(  hit, pli );
+}
+
 } // U2
@@ -67,10 +67,14 @@ public:
     QList< UHMM3SearchSeqDomainResult >    domainResList;
     
     void fillResults( const P7_TOPHITS* th, const P7_PIPELINE* pli );
+    /* results for one hit of a top hits list with many target sequences */
+    void fillResults( const P7_HIT* hit, const P7_PIPELINE* pli );
     
 private:
     void fillFullSeqResults( const P7_TOPHITS* th, const P7_PIPELINE* pli );
     void fillDomainsResult(  const P7_TOPHITS* th, const P7_PIPELINE* pli );
+    void fillFullSeqResults( const P7_HIT* hit, const P7_PIPELINE* pli );
+    void fillDomainsResult(  const P7_HIT* hit, const P7_PIPELINE* pli );
     
 }; // UHMM3SearchResult
 
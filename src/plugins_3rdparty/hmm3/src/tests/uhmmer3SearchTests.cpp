@@ -21,6 +21,8 @@
 
 #include "uhmmer3SearchTests.h"
 #include <gobject/uHMMObject.h>
+#include <search/uHMM3LocalSearchTask.h>
+#include <util/uhmm3Utilities.h>
 
 #include <U2Core/DocumentModel.h>
 #include <U2Core/IOAdapter.h>
@@ -28,10 +30,15 @@
 #include <U2Core/LoadDocumentTask.h>
 #include <U2Core/AppContext.h>
 #include <U2Core/DNASequenceObject.h>
+#include <U2Core/GObjectTypes.h>
 #include <U2Core/TextUtils.h>
 #include <U2Core/U2SafePoints.h>
 
+#include <U2Remote/LocalTaskDistribution.h>
+
+#include <QtCore/QBuffer>
 #include <QtCore/QList>
+#include <QtCore/QMap>
 
 namespace U2 {
 
@@ -749,4 +756,206 @@ Task::ReportResult GTest_UHMM3SearchCompare::report() {
     return ReportResult_Finished;
 }
 
+/**************************
+* GTest_UHMM3DatabaseSearch
+**************************/
+
+const QString GTest_UHMM3DatabaseSearch::HMM_FILENAME_TAG   = "hmm";
+const QString GTest_UHMM3DatabaseSearch::DB_FILENAME_TAG    = "db";
+
+const double DB_SEARCH_SCORE_ACCURACY = 0.01;
+
+void GTest_UHMM3DatabaseSearch::init( XMLTestFormat *tf, const QDomElement& el ) {
+    Q_UNUSED( tf );
+    loadHmmTask = NULL;
+    loadDbTask = NULL;
+    dbSearchTask = NULL;
+
+    hmmFilename = el.attribute( HMM_FILENAME_TAG );
+    dbFilename = el.attribute( DB_FILENAME_TAG );
+    GTest_UHMM3Search::setSearchTaskSettings( settings.inner, el, stateInfo );
+}
+
+void GTest_UHMM3DatabaseSearch::prepare() {
+    CHECK_EXT( !hmmFilename.isEmpty(), setError( "hmm_filename_is_empty" ), );
+    CHECK_EXT( !dbFilename.isEmpty(), setError( "db_filename_is_empty" ), );
+    CHECK_OP( stateInfo, );
+
+    loadHmmTask = LoadDocumentTask::getDefaultLoadDocTask( env->getVar( "COMMON_DATA_DIR" ) + "/" + hmmFilename );
+    CHECK_EXT( NULL != loadHmmTask, setError( QString( "cannot_load_hmm_file %1" ).arg( hmmFilename ) ), );
+    loadDbTask = LoadDocumentTask::getDefaultLoadDocTask( env->getVar( "COMMON_DATA_DIR" ) + "/" + dbFilename );
+    CHECK_EXT( NULL != loadDbTask, setError( QString( "cannot_load_db_file %1" ).arg( dbFilename ) ), );
+    addSubTask( loadHmmTask );
+    addSubTask( loadDbTask );
+}
+
+QList<Task*> GTest_UHMM3DatabaseSearch::onSubTaskFinished( Task* sub ) {
+    QList<Task*> res;
+    CHECK_OP( stateInfo, res );
+    CHECK( sub == loadHmmTask || sub == loadDbTask, res );
+    CHECK( loadHmmTask->isFinished() && loadDbTask->isFinished(), res );
+
+    QList<const P7_HMM*> hmms = UHMM3Utilities::getHmmsFromDocument( loadHmmTask->getDocument(), stateInfo );
+    CHECK_OP( stateInfo, res );
+    CHECK_EXT( !hmms.isEmpty(), setError( "no_hmm_profiles_found" ), res );
+
+    QList<QByteArray> dbSequences;
+    foreach( GObject* obj, loadDbTask->getDocument()->findGObjectByType( GObjectTypes::SEQUENCE ) ) {
+        U2SequenceObject* seqObj = qobject_cast<U2SequenceObject*>( obj );
+        CHECK_EXT( NULL != seqObj, setError( "invalid_sequence_object" ), res );
+        seqNames << seqObj->getSequenceName();
+        dbSequences << seqObj->getWholeSequenceData( stateInfo );
+        CHECK_OP( stateInfo, res );
+    }
+    CHECK_EXT( !dbSequences.isEmpty(), setError( "no_sequences_in_db" ), res );
+
+    dbSearchTask = new UHMM3DatabaseSearchTask( settings, hmms, loadDbTask->getURL().getURLString() );
+    res << dbSearchTask;
+
+    // the database search computes E-values for the whole database
+    UHMM3SearchTaskSettings seqSettings = settings;
+    if( OPTION_NOT_SET == seqSettings.inner.z ) {
+        seqSettings.inner.z = dbSequences.size();
+    }
+    foreach( const QByteArray& seq, dbSequences ) {
+        UHMM3SearchTask* seqTask = new UHMM3SearchTask( seqSettings, hmms, seq );
+        seqSearchTasks << seqTask;
+        res << seqTask;
+    }
+    return res;
+}
+
+Task::ReportResult GTest_UHMM3DatabaseSearch::report() {
+    CHECK_OP( stateInfo, ReportResult_Finished );
+    CHECK_EXT( NULL != dbSearchTask, setError( "database_search_is_not_started" ), ReportResult_Finished );
+
+    QList<UHMM3DatabaseSearchResult> dbResult = dbSearchTask->getResult();
+    for( int profile = 0; profile < dbResult.size(); profile++ ) {
+        QMap<QString, float> dbScores;
+        foreach( const UHMM3DatabaseSearchHit& hit, dbResult[profile].hits ) {
+            dbScores[hit.sequenceName] = hit.result.fullSeqResult.score;
+        }
+
+        int reportedCount = 0;
+        for( int seq = 0; seq < seqSearchTasks.size(); seq++ ) {
+            QList<UHMM3SearchResult> seqResult = seqSearchTasks[seq]->getResult();
+            CHECK_EXT( profile < seqResult.size(), setError( QString( "no_result_for_profile %1" ).arg( profile ) ), ReportResult_Finished );
+            const UHMM3SearchCompleteSeqResult& expected = seqResult[profile].fullSeqResult;
+            if( !expected.isReported ) {
+                continue;
+            }
+            reportedCount++;
+            const QString& name = seqNames[seq];
+            CHECK_EXT( dbScores.contains( name ), setError( QString( "sequence %1 is not reported by the database search" ).arg( name ) ), ReportResult_Finished );
+            CHECK_EXT( qAbs( dbScores[name] - expected.score ) < DB_SEARCH_SCORE_ACCURACY,
+                       setError( QString( "scores_not_matched for %1: expected %2, actual %3" ).arg( name ).arg( expected.score ).arg( dbScores[name] ) ),
+                       ReportResult_Finished );
+        }
+        CHECK_EXT( reportedCount == dbScores.size(),
+                   setError( QString( "reported_sequences_count_not_matched: expected %1, actual %2" ).arg( reportedCount ).arg( dbScores.size() ) ),
+                   ReportResult_Finished );
+    }
+    return ReportResult_Finished;
+}
+
+/**************************
+* GTest_UHMM3LocalSearchSerialization
+**************************/
+
+static QVariant sendThroughChannel( const QVariant& message, U2OpStatus& os ) {
+    QBuffer device;
+    device.open( QIODevice::WriteOnly );
+    CHECK_EXT( LocalTaskChannel::writeMessage( &device, message ), os.setError( "Can't write a message" ), QVariant() );
+    QByteArray buffer = device.data();
+    QVariant received;
+    CHECK_EXT( LocalTaskChannel::takeMessage( buffer, received ), os.setError( "Can't read the written message" ), QVariant() );
+    CHECK_EXT( buffer.isEmpty(), os.setError( "The message is not read completely" ), QVariant() );
+    return received;
+}
+
+static bool isSameDomainResult( const UHMM3SWSearchTaskDomainResult& r1, const UHMM3SWSearchTaskDomainResult& r2 ) {
+    const UHMM3SearchSeqDomainResult& g1 = r1.generalResult;
+    const UHMM3SearchSeqDomainResult& g2 = r2.generalResult;
+    return g1.score == g2.score && g1.bias == g2.bias && g1.ival == g2.ival && g1.cval == g2.cval
+        && g1.queryRegion == g2.queryRegion && g1.seqRegion == g2.seqRegion && g1.envRegion == g2.envRegion
+        && g1.acc == g2.acc && g1.isSignificant == g2.isSignificant
+        && r1.onCompl == r2.onCompl && r1.onAmino == r2.onAmino && r1.borderResult == r2.borderResult;
+}
+
+void GTest_UHMM3LocalSearchSerialization::init( XMLTestFormat *tf, const QDomElement& el ) {
+    Q_UNUSED( tf );
+    Q_UNUSED( el );
+}
+
+void GTest_UHMM3LocalSearchSerialization::run() {
+    UHMM3LocalSearchTaskSettings settings;
+    settings.hmmFilename = "/data/profiles/Pfam.hmm";
+    settings.sequence = "MKVLAAGIVGLLLAACSSKEETPAV";
+    settings.alphabetId = "AMINO_DEFAULT_ALPHABET";
+    settings.settings.inner.e = 0.5;
+    settings.settings.inner.z = 12345;
+    settings.settings.inner.domT = 7.25;
+    settings.settings.inner.useBitCutoffs = p7H_GA;
+    settings.settings.inner.f1 = 0.05;
+    settings.settings.inner.doMax = TRUE;
+    settings.settings.inner.noNull2 = TRUE;
+    settings.settings.inner.seed = 17;
+    settings.searchSpaceLength = 1000000;
+    settings.overlap = 600;
+    settings.offset = 250000;
+
+    UHMM3LocalSearchTaskSettings restored;
+    CHECK_EXT( restored.deserialize( sendThroughChannel( settings.serialize(), stateInfo ) ), setError( "settings_are_not_deserialized" ), );
+    CHECK_OP( stateInfo, );
+    const UHMM3SearchSettings& expected = settings.settings.inner;
+    const UHMM3SearchSettings& actual = restored.settings.inner;
+    CHECK_EXT( restored.hmmFilename == settings.hmmFilename && restored.sequence == settings.sequence && restored.alphabetId == settings.alphabetId,
+               setError( "input_is_not_restored" ), );
+    CHECK_EXT( expected.e == actual.e && expected.t == actual.t && expected.z == actual.z
+               && expected.domE == actual.domE && expected.domT == actual.domT && expected.domZ == actual.domZ
+               && expected.useBitCutoffs == actual.useBitCutoffs
+               && expected.incE == actual.incE && expected.incT == actual.incT && expected.incDomE == actual.incDomE && expected.incDomT == actual.incDomT
+               && expected.f1 == actual.f1 && expected.f2 == actual.f2 && expected.f3 == actual.f3
+               && expected.doMax == actual.doMax && expected.noBiasFilter == actual.noBiasFilter && expected.noNull2 == actual.noNull2
+               && expected.seed == actual.seed, setError( "search_settings_are_not_restored" ), );
+    CHECK_EXT( restored.searchSpaceLength == settings.searchSpaceLength && restored.overlap == settings.overlap && restored.offset == settings.offset,
+               setError( "part_is_not_restored" ), );
+
+    UHMM3SWSearchTaskDomainResult domain;
+    domain.generalResult.score = 35.5f;
+    domain.generalResult.bias = 0.25f;
+    domain.generalResult.ival = 1.5e-12;
+    domain.generalResult.cval = 3.25e-13;
+    domain.generalResult.queryRegion = U2Region( 1, 120 );
+    domain.generalResult.seqRegion = U2Region( 250100, 360 );
+    domain.generalResult.envRegion = U2Region( 250090, 380 );
+    domain.generalResult.acc = 0.97;
+    domain.generalResult.isSignificant = true;
+    domain.onCompl = true;
+    domain.onAmino = true;
+    domain.borderResult = false;
+    UHMM3SWSearchTaskDomainResult borderDomain = domain;
+    borderDomain.onCompl = false;
+    borderDomain.generalResult.isSignificant = false;
+    borderDomain.borderResult = true;
+
+    UHMM3LocalSearchTaskResult result;
+    result.results << ( QList<UHMM3SWSearchTaskDomainResult>() << domain << borderDomain ) << QList<UHMM3SWSearchTaskDomainResult>();
+    result.hmmLengths << 120 << 45;
+    result.partRegion = U2Region( 250000, 50000 );
+
+    UHMM3LocalSearchTaskResult restoredResult;
+    CHECK_EXT( restoredResult.deserialize( sendThroughChannel( result.serialize(), stateInfo ) ), setError( "result_is_not_deserialized" ), );
+    CHECK_OP( stateInfo, );
+    CHECK_EXT( restoredResult.hmmLengths == result.hmmLengths && restoredResult.partRegion == result.partRegion, setError( "part_result_is_not_restored" ), );
+    CHECK_EXT( restoredResult.results.size() == result.results.size(), setError( "profiles_count_not_matched" ), );
+    for( int i = 0; i < result.results.size(); i++ ) {
+        CHECK_EXT( restoredResult.results[i].size() == result.results[i].size(), setError( QString( "domains_count_not_matched for profile %1" ).arg( i ) ), );
+        for( int j = 0; j < result.results[i].size(); j++ ) {
+            CHECK_EXT( isSameDomainResult( result.results[i][j], restoredResult.results[i][j] ),
+                       setError( QString( "domain %1 of profile %2 is not restored" ).arg( j ).arg( i ) ), );
+        }
+    }
+}
+
 } // U2
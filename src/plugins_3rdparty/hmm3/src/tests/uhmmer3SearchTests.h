@@ -25,6 +25,7 @@
 #include <QtXml/QDomElement>
 
 #include <U2Test/XMLTestUtils.h>
+#include <search/uHMM3DatabaseSearchTask.h>
 #include <search/uHMM3SearchTask.h>
 
 namespace U2 {
@@ -141,6 +142,48 @@ private:
 
 }; // GTest_GeneralUHMM3SearchCompare
 
+/*****************************************
+* Test compares the search in a sequence database with separate searches in every sequence of the database.
+* The separate searches use the database size as Z, so the reported sequences and their scores should be the same.
+*****************************************/
+class GTest_UHMM3DatabaseSearch : public GTest {
+    Q_OBJECT
+public:
+    static const QString HMM_FILENAME_TAG;
+    static const QString DB_FILENAME_TAG;
+
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY( GTest_UHMM3DatabaseSearch, "hmm3-db-search" );
+
+    void prepare();
+    QList<Task*> onSubTaskFinished( Task* sub );
+    ReportResult report();
+
+private:
+    UHMM3SearchTaskSettings     settings;
+    QString                     hmmFilename;
+    QString                     dbFilename;
+    LoadDocumentTask*           loadHmmTask;
+    LoadDocumentTask*           loadDbTask;
+    UHMM3DatabaseSearchTask*    dbSearchTask;
+    QList<UHMM3SearchTask*>     seqSearchTasks;
+    QStringList                 seqNames;
+
+}; // GTest_UHMM3DatabaseSearch
+
+/*****************************************
+* Serializes the settings and the results of UHMM3LocalSearchTask, sends them through the local task channel
+* and compares the restored copies
+*****************************************/
+class GTest_UHMM3LocalSearchSerialization : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY( GTest_UHMM3LocalSearchSerialization, "hmm3-local-search-serialization" );
+
+    void run();
+
+}; // GTest_UHMM3LocalSearchSerialization
+
 }
 
 #endif // _GB2_UHMMER3_SEARCH_TESTS_H_
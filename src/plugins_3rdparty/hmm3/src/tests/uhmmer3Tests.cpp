@@ -33,6 +33,8 @@ QList< XMLTestFactory* > UHMMER3Tests::createTestFactories() {
     res << GTest_UHMMER3Build::createFactory();
     res << GTest_UHMM3Search::createFactory();
     res << GTest_UHMM3SearchCompare::createFactory();
+    res << GTest_UHMM3DatabaseSearch::createFactory();
+    res << GTest_UHMM3LocalSearchSerialization::createFactory();
     res << GTest_UHMM3Phmmer::createFactory();
     res << GTest_UHMM3PhmmerCompare::createFactory();
     return res;
@@ -26,13 +26,17 @@
 #include <U2Core/AppContext.h>
 #include <U2Core/GAutoDeleteList.h>
 #include <U2Core/GObjectSelection.h>
+#include <U2Core/GObjectTypes.h>
 #include <U2Core/MAlignmentObject.h>
 
+#include <U2Gui/DialogUtils.h>
 #include <U2Gui/GUIUtils.h>
+#include <U2Gui/LastUsedDirHelper.h>
 #include <U2Gui/MainWindow.h>
 #include <U2Gui/ObjectViewModel.h>
 #include <U2Gui/ProjectView.h>
 #include <U2Gui/ToolsMenu.h>
+#include <U2Gui/U2FileDialog.h>
 #include <U2Core/QObjectScopedPointer.h>
 
 #include <U2View/ADVConstants.h>
@@ -45,10 +49,15 @@
 #include <U2Test/GTestFrameworkComponents.h>
 #include <U2Test/XMLTestFormat.h>
 
+#include <U2Remote/LocalTask.h>
+
 #include "uHMM3Plugin.h"
 #include "build/uHMM3BuildDialogImpl.h"
 #include "format/uHMMFormat.h"
+#include "gobject/uHMMObject.h"
 #include "phmmer/uHMM3PhmmerDialogImpl.h"
+#include "search/uHMM3DatabaseSearchTask.h"
+#include "search/uHMM3LocalSearchTask.h"
 #include "search/uHMM3SearchDialogImpl.h"
 #include "search/uhmm3QDActor.h"
 #include "tests/uhmmer3Tests.h"
@@ -78,6 +87,11 @@ UHMM3Plugin::UHMM3Plugin() : Plugin( tr( "HMM3" ), tr( "HMM profile tools. Plugi
 
     QDActorPrototypeRegistry* qdpr = AppContext::getQDActorProtoRegistry();
     qdpr->registerProto(new UHMM3QDActorPrototype());
+
+    LocalTaskFactoryRegistry* ltfr = AppContext::getLocalTaskFactoryRegistry();
+    if( NULL != ltfr ) {
+        ltfr->registerLocalTaskFactory( new UHMM3LocalSearchTaskFactory() );
+    }
     
     // Tests
     GTestFormatRegistry* tfr = AppContext::getTestFramework()->getTestFormatRegistry();
@@ -111,6 +125,11 @@ UHMM3Plugin::UHMM3Plugin() : Plugin( tr( "HMM3" ), tr( "HMM profile tools. Plugi
         phmmerAction->setObjectName(ToolsMenu::HMMER_SEARCH3P);
         connect( phmmerAction, SIGNAL( triggered() ), SLOT( sl_phmmerSearch() ) );
         ToolsMenu::addAction(ToolsMenu::HMMER_MENU, phmmerAction);
+
+        QAction * dbSearchAction = new QAction( tr( "Search HMM3 profiles in sequence database..." ), this );
+        dbSearchAction->setObjectName(ToolsMenu::HMMER_SEARCH3_DB);
+        connect( dbSearchAction, SIGNAL( triggered() ), SLOT( sl_databaseSearch() ) );
+        ToolsMenu::addAction(ToolsMenu::HMMER_MENU, dbSearchAction);
         
         // contexts
         msaEditorCtx = new UHMM3MSAEditorContext( this );
@@ -183,6 +202,33 @@ void UHMM3Plugin::sl_phmmerSearch() {
     phmmerDlg->exec();
 }
 
+void UHMM3Plugin::sl_databaseSearch() {
+    QWidget *p = (QWidget*)AppContext::getMainWindow()->getQMainWindow();
+
+    LastUsedDirHelper hmmHelper( UHMM3SearchDialogImpl::HMM_FILES_DIR_ID );
+    hmmHelper.url = U2FileDialog::getOpenFileName( p, tr( "Select HMM profiles file" ), hmmHelper,
+        DialogUtils::prepareDocumentsFileFilterByObjType( UHMMObject::UHMM_OT, true ) );
+    if( hmmHelper.url.isEmpty() ) {
+        return;
+    }
+
+    LastUsedDirHelper dbHelper;
+    dbHelper.url = U2FileDialog::getOpenFileName( p, tr( "Select sequence database" ), dbHelper,
+        DialogUtils::prepareDocumentsFileFilterByObjType( GObjectTypes::SEQUENCE, true ) );
+    if( dbHelper.url.isEmpty() ) {
+        return;
+    }
+
+    LastUsedDirHelper outHelper;
+    outHelper.url = U2FileDialog::getSaveFileName( p, tr( "Save hits table to" ), outHelper );
+    if( outHelper.url.isEmpty() ) {
+        return;
+    }
+
+    UHMM3SearchTaskSettings settings;
+    AppContext::getTaskScheduler()->registerTopLevelTask( new UHMM3DatabaseSearchToFileTask( settings, hmmHelper.url, dbHelper.url, outHelper.url ) );
+}
+
 UHMM3Plugin::~UHMM3Plugin() {
 }
 
@@ -45,6 +45,7 @@ private slots:
     void sl_buildProfile();
     void sl_searchHMMSignals();
     void sl_phmmerSearch();
+    void sl_databaseSearch();
 
 private:
     UHMM3MSAEditorContext *     msaEditorCtx;
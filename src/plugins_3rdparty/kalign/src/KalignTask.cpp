@@ -67,6 +67,8 @@ void KalignTaskSettings::reset() {
     termGapPenalty = -1;
     secret = -1;
     inputFilePath="";
+    threadsCount = 0;
+    useSse = true;
 }
 
 KalignTask::KalignTask(const MAlignment& ma, const KalignTaskSettings& _config)
@@ -81,7 +83,29 @@ KalignTask::KalignTask(const MAlignment& ma, const KalignTaskSettings& _config)
     tpm = Task::Progress_Manual;
     quint64 mem = inputMA.getNumRows() * sizeof(float);
     quint64 profileMem = (ma.getLength() + 2)*22*sizeof(float); // the size of profile that is built during kalign
-    addTaskResource(TaskResourceUsage(RESOURCE_MEMORY, (profileMem + (mem * mem + 3 * mem)) / (1024 * 1024)));
+    quint64 serialMem = profileMem + (mem * mem + 3 * mem);
+    // every concurrent guide tree step keeps its own result profile, hirschberg states and SSE buffers
+    quint64 stepMem = (ma.getLength() + 2) * (64 + 2 * 4 + 28 + 1) * sizeof(float);
+
+    AppResourcePool* pool = AppResourcePool::instance();
+    threadsCount = config.threadsCount > 0 ? config.threadsCount : pool->getIdealThreadCount();
+    AppResource* threads = pool->getResource(RESOURCE_THREAD);
+    if (NULL != threads) {
+        threadsCount = qMin(threadsCount, threads->maxTaskUse());
+    }
+    AppResource* memory = pool->getResource(RESOURCE_MEMORY);
+    if (NULL != memory) {
+        const quint64 maxTaskMem = quint64(memory->maxTaskUse()) * 1024 * 1024;
+        const quint64 maxThreads = maxTaskMem > serialMem ? 1 + (maxTaskMem - serialMem) / stepMem : 1;
+        threadsCount = int(qMin(quint64(threadsCount), maxThreads));
+    }
+    threadsCount = qMax(1, threadsCount);
+
+    addTaskResource(TaskResourceUsage(RESOURCE_MEMORY, (serialMem + (threadsCount - 1) * stepMem) / (1024 * 1024)));
+    if (threadsCount > 1) {
+        // the scheduler reserves the thread of the task itself
+        addTaskResource(TaskResourceUsage(RESOURCE_THREAD, threadsCount - 1));
+    }
 }
 
 void KalignTask::_run() {
@@ -132,6 +156,8 @@ TLSContext* KalignTask::createContextInstance()
     if(config.secret != -1) {
         ctx->secret = config.secret;
     }
+    ctx->threads_count = threadsCount;
+    ctx->pp_sse = config.useSse ? 1 : 0;
     return new KalignContext(ctx);
 }
 
@@ -58,6 +58,10 @@ public:
     float   secret;
     QString inputFilePath;
     QString outputFilePath;
+    // the number of threads of the parallel stages, 0 means the ideal thread count
+    int     threadsCount;
+    // the profile-profile passes use SSE if it is available
+    bool    useSse;
 };
 
 class KalignTask : public TLSTask {
@@ -78,6 +82,9 @@ public:
     
 protected:
     TLSContext* createContextInstance();
+
+private:
+    int                         threadsCount;
 };
 
 //locks MAlignment object and propagate KalignTask results to it
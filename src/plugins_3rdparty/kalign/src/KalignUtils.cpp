@@ -20,7 +20,15 @@
  */
 
 #include "KalignUtils.h"
+#include "KalignException.h"
+#include "KalignTask.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+
 #include <U2Core/Task.h>
+#include <U2Core/U2SafePoints.h>
 
 extern "C" {
 
@@ -49,6 +57,10 @@ void set_task_progress(int percent) {
 int check_task_canceled(kalign_context *ctx) {
 	return U2::isCanceled(ctx);
 }
+
+void run_parallel_jobs(int n, kalign_job job, void* data, int progress_from, int progress_to) {
+	U2::runParallelJobs(n, job, data, progress_from, progress_to);
+}
 };
 
 namespace U2 {
@@ -68,5 +80,113 @@ bool isCanceled(struct kalign_context* ctx) {
 	return ((TaskStateInfo*)ctx->ptask_state)->cancelFlag;
 }
 
+namespace {
+
+class KalignJobs {
+public:
+	KalignJobs(int _n, kalign_job _job, void* _data, kalign_context* _ctx)
+		: n(_n), job(_job), data(_data), ctx(_ctx), nextJob(0), finishedJobs(0), failed(false) {}
+
+	// takes the jobs one by one until all of them are taken, the task is canceled or some job fails
+	void run(bool reportProgress, int progressFrom, int progressTo) {
+		forever {
+			{
+				QMutexLocker locker(&errorLock);
+				if (failed) {
+					return;
+				}
+			}
+			if (isCanceled(ctx)) {
+				return;
+			}
+			const int index = nextJob.fetchAndAddOrdered(1);
+			if (index >= n) {
+				return;
+			}
+			try {
+				job(index, data);
+			} catch (const KalignException &e) {
+				setError(e.str);
+				return;
+			} catch (...) {
+				setError("Not enough memory to finish KAlign task");
+				return;
+			}
+			const int finished = finishedJobs.fetchAndAddOrdered(1) + 1;
+			if (reportProgress) {
+				setTaskProgress(ctx, progressFrom + (progressTo - progressFrom) * finished / n);
+			}
+		}
+	}
+
+	// is called by the thread that started the jobs
+	void rethrowError() {
+		QMutexLocker locker(&errorLock);
+		if (failed) {
+			throw KalignException(error.constData());
+		}
+	}
+
+private:
+	void setError(const char* message) {
+		QMutexLocker locker(&errorLock);
+		if (!failed) {
+			failed = true;
+			error = message;
+		}
+	}
+
+	const int n;
+	const kalign_job job;
+	void* const data;
+	kalign_context* const ctx;
+	QAtomicInt nextJob;
+	QAtomicInt finishedJobs;
+	QMutex errorLock;
+	bool failed;
+	QByteArray error;
+};
+
+class KalignJobsThread : public QThread {
+public:
+	KalignJobsThread(KalignJobs& _jobs, TLSContext* _context) : jobs(_jobs), context(_context) {}
+
+protected:
+	void run() {
+		// kalign reads its settings from the task local context
+		TLSUtils::bindToTLSContext(context);
+		jobs.run(false, 0, 0);
+		TLSUtils::detachTLSContext();
+	}
+
+private:
+	KalignJobs& jobs;
+	TLSContext* context;
+};
+
+}
+
+void runParallelJobs(int n, kalign_job job, void* data, int progressFrom, int progressTo) {
+	CHECK(n > 0, );
+	kalign_context* ctx = get_kalign_context();
+	KalignJobs jobs(n, job, data, ctx);
+
+	const int threadCount = qMin(n, ctx->threads_count);
+	QList<KalignJobsThread*> threads;
+	for (int i = 1; i < threadCount; i++) {
+		KalignJobsThread* thread = new KalignJobsThread(jobs, TLSUtils::current(KALIGN_CONTEXT_ID));
+		threads << thread;
+		thread->start();
+	}
+	jobs.run(true, progressFrom, progressTo);
+	foreach (KalignJobsThread* thread, threads) {
+		thread->wait();
+	}
+	qDeleteAll(threads);
+
+	jobs.rethrowError();
+	setTaskProgress(ctx, progressTo);
+}
+
 } //namespace U2
 
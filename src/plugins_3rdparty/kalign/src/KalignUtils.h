@@ -31,6 +31,9 @@ void setTaskProgress(struct kalign_context* ctx, int percent);
 void setTaskDesc(struct kalign_context* ctx, const char *str);
 
 bool isCanceled(struct kalign_context* ctx);
+
+// runs the jobs on the threads reserved by the task, the first KalignException of a job is rethrown here
+void runParallelJobs(int n, void (*job)(int, void*), void* data, int progressFrom, int progressTo);
 } // namespace U2
 
 #endif // _KALIGN_UTILS_H_
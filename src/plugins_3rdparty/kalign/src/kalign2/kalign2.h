@@ -158,6 +158,13 @@ struct hirsch_mem{
 	int size;
 	int len_a;
 	int len_b;
+	/* prof2 of the running hirsch_pp_dyn stored by feature, see pp_mem_alloc() */
+	int pp_depth;
+	int pp_stride;
+	float* pp_mem;
+	float* pp_features;
+	float* pp_gpo_f;
+	float* pp_gpo_b;
 };
 
 struct dp_matrix{
@@ -208,6 +215,7 @@ struct alignment* sort_sequences(struct alignment* aln,int* tree,char* sort);
 struct aln_tree_node* real_upgma(float **dm,int ntree);
 
 int* readtree(struct aln_tree_node* p,int* tree);
+int tree_levels(int* tree,int* steps,int* level_start,unsigned int numseq,unsigned int numprofiles);
 
 struct parameters* interface(struct parameters* param,int argc,char **argv);
 void parameter_message(struct parameters* param);
@@ -8,6 +8,8 @@ kalign_context *init_context(kalign_context *ctx, void *ptsi) {
 	ctx->tgpe = -1;
 	ctx->secret = -1;
 	ctx->ptask_state = ptsi;
+	ctx->threads_count = 1;
+	ctx->pp_sse = 1;
 }
 
 extern kalign_context* getKalignContext();
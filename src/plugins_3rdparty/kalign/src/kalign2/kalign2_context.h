@@ -15,6 +15,10 @@ typedef struct kalign_context {
 	float tgpe;
 	float secret;
 	void* ptask_state;
+	/* the number of threads of the parallel stages, the task has reserved them */
+	int threads_count;
+	/* the profile-profile passes score four cells at once if SSE is available */
+	int pp_sse;
 } kalign_context;
 
 struct kalign_context* init_context(kalign_context *ctx, void* ptsi);
@@ -27,4 +31,10 @@ void set_task_progress(int percents);
 
 int check_task_canceled(struct kalign_context* ctx);
 
+typedef void (*kalign_job)(int job, void* data);
+
+/* runs job(0, data) ... job(n - 1, data) on several threads of the current task and waits for all of them.
+   The jobs must not print messages or set progress: the progress goes from progress_from to progress_to as they finish. */
+void run_parallel_jobs(int n, kalign_job job, void* data, int progress_from, int progress_to);
+
 #endif //_KALIGN_CONTEXT_
@@ -701,25 +701,82 @@ float protein_wu_distance_calculation3(struct node* hash[],int* seq,int seqlen,i
 	return dlen;
 }
 
-float** protein_wu_distance(struct alignment* si,float** dm,struct parameters* param, int nj)
+struct distance_jobs{
+	struct alignment* si;
+	float** dm;
+	struct parameters* param;
+	unsigned int numseq;
+};
+
+/* fills the row i of the distance matrix (and the column i): every row has its own hash */
+static void protein_wu_distance_row(int i,void* data)
 {
+	struct distance_jobs* jobs = data;
+	struct alignment* si = jobs->si;
 	struct bignode* hash[1024];
 	int*p =0;
-	int i,j,a,b;
+	int j;
+	int overflow = 0;
 	unsigned int hv;
 	float min;
 	float cutoff;
 
+	for (j = 0;j < 1024;j++){
+		hash[j] = 0;
+	}
+	p = si->s[i];
+
+	for (j = si->sl[i]-2;j--;){
+		//hv = (p[j+1] << 5) + p[j+2];
+		//hash[hv] = big_insert_hash(hash[hv],j);
+		long tmp = (p[j] << 5) + p[j+1];
+		if (tmp < 0) {
+			overflow = 1;
+			break;
+		}
+		hv = tmp;
+		hash[hv] = big_insert_hash(hash[hv],j);
+		tmp = (p[j] << 5) + p[j+2];
+		if (tmp < 0) {
+			overflow = 1;
+			break;
+		}
+		hv = tmp;
+		hash[hv] = big_insert_hash(hash[hv],j);
+	}
+	if (!overflow){
+		for (j = i+1; j < jobs->numseq;j++){
+			min =  (si->sl[i] > si->sl[j]) ? si->sl[j] :si->sl[i];
+			cutoff = jobs->param->internal_gap_weight *min + jobs->param->zlevel;
+			//cutoff = param->zlevel;
+			p = si->s[j];
+			jobs->dm[i][j] = protein_wu_distance_calculation(hash,p,si->sl[j],si->sl[j]+si->sl[i],cutoff);
+			jobs->dm[j][i] = jobs->dm[i][j];
+		}
+	}
+
+	for (j = 1024;j--;){
+		if (hash[j]){
+			big_remove_nodes(hash[j]);
+			hash[j] = 0;
+		}
+	}
+	if (overflow){
+		throwKalignException("Sequences are too long for alignment");
+	}
+}
+
+float** protein_wu_distance(struct alignment* si,float** dm,struct parameters* param, int nj)
+{
+	struct distance_jobs jobs;
+	int i,j;
+
 	unsigned int numseq;
 	unsigned int numprofiles;
 	
 	struct kalign_context *ctx = get_kalign_context();
 	numseq = ctx->numseq;
 	numprofiles = ctx->numprofiles;
-	
-	for (i = 0;i < 1024;i++){
-		hash[i] = 0;
-	}	
 
 	if (nj){
 		dm = malloc (sizeof(float*)*numprofiles);
@@ -739,56 +796,12 @@ float** protein_wu_distance(struct alignment* si,float** dm,struct parameters* p
 		}
 	}
 	k_printf("Distance Calculation:\n");
-	b = (numseq*(numseq-1))/2;
-	a = 1;	
-	
-	for (i = 0; i < numseq-1;i++){
-		if(check_task_canceled(ctx)) {
-			break;
-		}
-		p = si->s[i];
-				
-		for (j = si->sl[i]-2;j--;){
-		//for(j = 0; j < si->sl[i]-2;j++){
-			//hv = (p[j+1] << 5) + p[j+2];
-			//hash[hv] = big_insert_hash(hash[hv],j);
-            long tmp = (p[j] << 5) + p[j+1];
-            if (tmp < 0) {
-                throwKalignException("Sequences are too long for alignment");
-            }
-			hv = tmp;
-			hash[hv] = big_insert_hash(hash[hv],j);
-            tmp = (p[j] << 5) + p[j+2];
-            if (tmp < 0) {
-                throwKalignException("Sequences are too long for alignment");
-            }
-			hv = tmp;
-			hash[hv] = big_insert_hash(hash[hv],j);
-		}
-		for (j = i+1; j < numseq;j++){
-			min =  (si->sl[i] > si->sl[j]) ? si->sl[j] :si->sl[i];
-			cutoff = param->internal_gap_weight *min + param->zlevel;
-			//cutoff = param->zlevel;
-			p = si->s[j];
-			dm[i][j] = protein_wu_distance_calculation(hash,p,si->sl[j],si->sl[j]+si->sl[i],cutoff);
-			//k_printf("%d-%d:%f\n",i,j,dm[i][j]);
-			//exit(0);
-			//dm[i][j] /= min;
-			//dm[i][j] /= (si->sl[i] > si->sl[j]) ? si->sl[j] :si->sl[i];
-			dm[j][i] = dm[i][j];
-			k_printf("Distance Calculation: %8.0f percent done",(float)a /(float)b * 100);
-			set_task_progress((float)a /(float)b * 50);
-			a++;
-		}
-		
-		
-		for (j = 1024;j--;){
-			if (hash[j]){
-				big_remove_nodes(hash[j]);
-				hash[j] = 0;
-			}
-		}	
-	}
+
+	jobs.si = si;
+	jobs.dm = dm;
+	jobs.param = param;
+	jobs.numseq = numseq;
+	run_parallel_jobs(numseq-1,protein_wu_distance_row,&jobs,0,50);
 	return dm;
 }
 
@@ -867,14 +880,51 @@ float protein_wu_distance_calculation(struct bignode* hash[],const int* seq,cons
 	return out;
 }
 
-float** dna_distance(struct alignment* si,float** dm,struct parameters* param, int nj)
+static void dna_distance_row(int i,void* data)
 {
+	struct distance_jobs* jobs = data;
+	struct alignment* si = jobs->si;
 	struct bignode* hash[1024];
-		
 	int *p = 0;
-	int i,j,a,b;
+	int j;
 	unsigned int hv;
 
+	for (j = 0;j < 1024;j++){
+		hash[j] = 0;
+	}
+	p = si->s[i];
+	for (j = si->sl[i]-5;j--;){
+		hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+3]&3)<<2) + (p[j+4]&3);//ABCDE
+		hash[hv] = big_insert_hash(hash[hv],j);
+		hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+3]&3)<<2) + (p[j+5]&3);//ABCDF
+		hash[hv] = big_insert_hash(hash[hv],j);
+		hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+4]&3)<<2) + (p[j+5]&3);//ABCEF
+		hash[hv] = big_insert_hash(hash[hv],j);
+		hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+3]&3)<<4)  + ((p[j+4]&3)<<2) + (p[j+5]&3);//ABDEF
+		hash[hv] = big_insert_hash(hash[hv],j);
+		hv = ((p[j]&3)<<8) + ((p[j+2]&3)<<6) + ((p[j+3]&3)<<4) + ((p[j+4]&3)<<2) + (p[j+5]&3);//ACDEF
+		hash[hv] = big_insert_hash(hash[hv],j);
+	}
+	for (j = i+1; j < jobs->numseq;j++){
+		//min =  (si->sl[i] > si->sl[j]) ?si->sl[j] :si->sl[i];
+		jobs->dm[i][j] = dna_distance_calculation(hash,si->s[j],si->sl[j],si->sl[j]+si->sl[i],jobs->param->zlevel);
+		jobs->dm[i][j] /= (si->sl[i] > si->sl[j]) ?si->sl[j] :si->sl[i];
+		jobs->dm[j][i] = jobs->dm[i][j];
+	}
+
+	for (j = 1024;j--;){
+		if (hash[j]){
+			big_remove_nodes(hash[j]);
+			hash[j] = 0;
+		}
+	}
+}
+
+float** dna_distance(struct alignment* si,float** dm,struct parameters* param, int nj)
+{
+	struct distance_jobs jobs;
+	int i,j;
+
 	unsigned int numseq;
 	unsigned int numprofiles;
 
@@ -885,11 +935,6 @@ float** dna_distance(struct alignment* si,float** dm,struct parameters* param, i
 	assert(nj==0);
 	
 	k_printf("Distance Calculation:\n");
-	
-	
-	for (i = 0;i < 1024;i++){
-		hash[i] = 0;
-	}	
 
 	if (nj){
 		dm = malloc (sizeof(float*)*numprofiles);
@@ -909,47 +954,11 @@ float** dna_distance(struct alignment* si,float** dm,struct parameters* param, i
 		}
 	}
 
-	b = (numseq*(numseq-1))/2;
-	a = 1;	
-	
-	for (i = 0; i < numseq-1;i++){
-		if(check_task_canceled(ctx)) {
-			break;
-		}
-		p = si->s[i];
-		for (j = si->sl[i]-5;j--;){
-			hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+3]&3)<<2) + (p[j+4]&3);//ABCDE
-			hash[hv] = big_insert_hash(hash[hv],j);
-			hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+3]&3)<<2) + (p[j+5]&3);//ABCDF
-			hash[hv] = big_insert_hash(hash[hv],j);
-			hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+2]&3)<<4)  + ((p[j+4]&3)<<2) + (p[j+5]&3);//ABCEF
-			hash[hv] = big_insert_hash(hash[hv],j);
-			hv = ((p[j]&3)<<8) + ((p[j+1]&3)<<6) + ((p[j+3]&3)<<4)  + ((p[j+4]&3)<<2) + (p[j+5]&3);//ABDEF
-			hash[hv] = big_insert_hash(hash[hv],j);
-			hv = ((p[j]&3)<<8) + ((p[j+2]&3)<<6) + ((p[j+3]&3)<<4) + ((p[j+4]&3)<<2) + (p[j+5]&3);//ACDEF
-			hash[hv] = big_insert_hash(hash[hv],j);
-		}
-		for (j = i+1; j < numseq;j++){
-			if(check_task_canceled(ctx)) {
-				break;
-			}
-		
-			//min =  (si->sl[i] > si->sl[j]) ?si->sl[j] :si->sl[i];
-			dm[i][j] = dna_distance_calculation(hash,si->s[j],si->sl[j],si->sl[j]+si->sl[i],param->zlevel);
-			dm[i][j] /= (si->sl[i] > si->sl[j]) ?si->sl[j] :si->sl[i];
-			dm[j][i] = dm[i][j];
-			k_printf("Distance Calculation: %8.0f percent done",(float)a /(float)b * 100);
-			set_task_progress((float)a /(float)b * 50);
-			a++;
-		}
-		
-		for (j = 1024;j--;){
-			if (hash[j]){
-				big_remove_nodes(hash[j]);
-				hash[j] = 0;
-			}
-		}
-	}
+	jobs.si = si;
+	jobs.dm = dm;
+	jobs.param = param;
+	jobs.numseq = numseq;
+	run_parallel_jobs(numseq-1,dna_distance_row,&jobs,0,50);
 	return dm;
 }
 
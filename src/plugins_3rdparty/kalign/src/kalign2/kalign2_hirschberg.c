@@ -27,14 +27,145 @@
 #include "kalign2_hirschberg.h"
 #define MAX(a, b) (a > b ? a : b)
 #define MAX3(a,b,c) MAX(MAX(a,b),c)
-//#include <emmintrin.h>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define KALIGN_PP_SSE
+#include <xmmintrin.h>
+static void pp_mem_alloc(const float* prof2,struct hirsch_mem* hm);
+#endif
+
+struct hirsch_alignment_jobs{
+	struct alignment* aln;
+	int* tree;
+	float** submatrix;
+	int** map;
+	float** profile;
+	int* steps;
+	float strength;
+	unsigned int numseq;
+};
 
-int** hirschberg_alignment(struct alignment* aln,int* tree,float**submatrix, int** map,int window,float strength)
+/* aligns the two nodes of one step of the tree: the step uses only its own nodes and own memory */
+static void hirschberg_alignment_step(int job,void* data)
 {
+	struct hirsch_alignment_jobs* jobs = data;
+	struct alignment* aln = jobs->aln;
+	float** submatrix = jobs->submatrix;
+	int** map = jobs->map;
+	float** profile = jobs->profile;
+	float strength = jobs->strength;
+	unsigned int numseq = jobs->numseq;
 	struct hirsch_mem* hm = 0;
 	int i,j,g,a,b,c;
 	int len_a;
 	int len_b;
+
+	i = jobs->steps[job];
+	a = jobs->tree[i*3];
+	b = jobs->tree[i*3+1];
+	c = jobs->tree[i*3+2];
+	//k_printf("Aligning:%d %d->%d	done:%f\n",a,b,c,((float)(i+1)/(float)numseq)*100);
+	len_a = aln->sl[a];
+	len_b = aln->sl[b];
+
+	
+	g = (len_a > len_b)? len_a:len_b;
+	map[c] = malloc(sizeof(int) * (g+2));
+	hm = hirsch_mem_alloc(hm,g);
+
+	for (j = 0; j < (g+2);j++){
+		map[c][j] = -1;
+	}
+
+	if (a < numseq){
+		profile[a] = make_profile(profile[a],aln->s[a],len_a,submatrix);
+	}else{
+		set_gap_penalties(profile[a],len_a,aln->nsip[b],strength,aln->nsip[a]);
+		//smooth_gaps(profile[a],len_a,window,strength);
+		
+		//increase_gaps(profile[a],len_a,window,strength);
+	}
+	if (b < numseq){
+		profile[b] = make_profile(profile[b],aln->s[b],len_b,submatrix);
+	}else{		
+		set_gap_penalties(profile[b],len_b,aln->nsip[a],strength,aln->nsip[b]);
+		//smooth_gaps(profile[b],len_b,window,strength);
+		//increase_gaps(profile[b],len_b,window,strength);
+	}
+	
+	hm->starta = 0;
+	hm->startb = 0;
+	hm->enda = len_a;
+	hm->endb = len_b;
+	hm->len_a = len_a;
+	hm->len_b = len_b;
+	
+	hm->f[0].a = 0.0;
+	hm->f[0].ga =  -FLOATINFTY;
+	hm->f[0].gb = -FLOATINFTY;
+	hm->b[0].a = 0.0;
+	hm->b[0].ga =  -FLOATINFTY;
+	hm->b[0].gb =  -FLOATINFTY;
+//	k_printf("LENA:%d	LENB:%d	numseq:%d\n",len_a,len_b,numseq);
+	if(a < numseq){
+		if(b < numseq){
+			map[c] = hirsch_ss_dyn(submatrix,aln->s[a],aln->s[b],hm,map[c]);
+		}else{
+			hm->enda = len_b;
+			hm->endb = len_a;
+			hm->len_a = len_b;
+			hm->len_b = len_a;
+			map[c] = hirsch_ps_dyn(profile[b],aln->s[a],hm,map[c],aln->nsip[b]);
+			map[c] = mirror_hirsch_path(map[c],len_a,len_b);
+		}
+	}else{
+		if(b < numseq){
+			map[c] = hirsch_ps_dyn(profile[a],aln->s[b],hm,map[c],aln->nsip[a]);
+		}else{
+			if(len_a < len_b){
+				map[c] = hirsch_pp_dyn(profile[a],profile[b],hm,map[c]);
+			}else{
+				hm->enda = len_b;
+				hm->endb = len_a;
+				hm->len_a = len_b;
+				hm->len_b = len_a;
+				map[c] = hirsch_pp_dyn(profile[b],profile[a],hm,map[c]);
+				map[c] = mirror_hirsch_path(map[c],len_a,len_b);
+			}
+		}
+	}
+	
+	map[c] = add_gap_info_to_hirsch_path(map[c],len_a,len_b);
+
+	if(i != numseq-2){
+		profile[c] = malloc(sizeof(float)*64*(map[c][0]+2));
+		profile[c] = update(profile[a],profile[b],profile[c],map[c],aln->nsip[a],aln->nsip[b]);
+	}
+		
+	aln->sl[c] = map[c][0];
+
+	aln->nsip[c] = aln->nsip[a] + aln->nsip[b];
+	aln->sip[c] = malloc(sizeof(int)*(aln->nsip[a] + aln->nsip[b]));
+	g =0;
+	for (j = aln->nsip[a];j--;){
+		aln->sip[c][g] = aln->sip[a][j];
+		g++;
+	}
+	for (j = aln->nsip[b];j--;){
+		aln->sip[c][g] = aln->sip[b][j];
+		g++;
+	}
+
+	free(profile[a]);
+	free(profile[b]);
+	hirsch_mem_free(hm);
+}
+
+int** hirschberg_alignment(struct alignment* aln,int* tree,float**submatrix, int** map,int window,float strength)
+{
+	struct hirsch_alignment_jobs jobs;
+	int* steps = 0;
+	int* level_start = 0;
+	int i,levels;
 	float** profile = 0;
 
 	unsigned int numseq;
@@ -53,121 +184,36 @@ int** hirschberg_alignment(struct alignment* aln,int* tree,float**submatrix, int
 	for ( i = 0;i < numprofiles;i++){
 		map[i] = 0;
 	}
-	
-	hm = hirsch_mem_alloc(hm,1024);
+
+	steps = malloc(sizeof(int)*(numseq-1));
+	level_start = malloc(sizeof(int)*numseq);
+	levels = tree_levels(tree,steps,level_start,numseq,numprofiles);
+
+	jobs.aln = aln;
+	jobs.tree = tree;
+	jobs.submatrix = submatrix;
+	jobs.map = map;
+	jobs.profile = profile;
+	jobs.strength = strength;
+	jobs.numseq = numseq;
 
 	//k_printf("\nAlignment:\n");
 
-	for (i = 0; i < (numseq-1);i++){
+	// the steps of one level are independent, so they are aligned in parallel
+	for (i = 0; i < levels;i++){
 		if(check_task_canceled(ctx)) {
 			break;
 		}
-		a = tree[i*3];
-		b = tree[i*3+1];
-		c = tree[i*3+2];
-		k_printf("Alignment: %8.0f percent done",(float)(i) /(float)numseq * 100);
-		set_task_progress(50+(float)(i) /(float)numseq * 50);
-		//k_printf("Aligning:%d %d->%d	done:%f\n",a,b,c,((float)(i+1)/(float)numseq)*100);
-		len_a = aln->sl[a];
-		len_b = aln->sl[b];
-
-		
-		g = (len_a > len_b)? len_a:len_b;
-		map[c] = malloc(sizeof(int) * (g+2));
-		if(g > hm->size){
-			hm = hirsch_mem_realloc(hm,g);
-		}
-
-		for (j = 0; j < (g+2);j++){
-			map[c][j] = -1;
-		}
-
-		if (a < numseq){
-			profile[a] = make_profile(profile[a],aln->s[a],len_a,submatrix);
-		}else{
-			set_gap_penalties(profile[a],len_a,aln->nsip[b],strength,aln->nsip[a]);
-			//smooth_gaps(profile[a],len_a,window,strength);
-			
-			//increase_gaps(profile[a],len_a,window,strength);
-		}
-		if (b < numseq){
-			profile[b] = make_profile(profile[b],aln->s[b],len_b,submatrix);
-		}else{		
-			set_gap_penalties(profile[b],len_b,aln->nsip[a],strength,aln->nsip[b]);
-			//smooth_gaps(profile[b],len_b,window,strength);
-			//increase_gaps(profile[b],len_b,window,strength);
-		}
-		
-		hm->starta = 0;
-		hm->startb = 0;
-		hm->enda = len_a;
-		hm->endb = len_b;
-		hm->len_a = len_a;
-		hm->len_b = len_b;
-		
-		hm->f[0].a = 0.0;
-		hm->f[0].ga =  -FLOATINFTY;
-		hm->f[0].gb = -FLOATINFTY;
-		hm->b[0].a = 0.0;
-		hm->b[0].ga =  -FLOATINFTY;
-		hm->b[0].gb =  -FLOATINFTY;
-	//	k_printf("LENA:%d	LENB:%d	numseq:%d\n",len_a,len_b,numseq);
-		if(a < numseq){
-			if(b < numseq){
-				map[c] = hirsch_ss_dyn(submatrix,aln->s[a],aln->s[b],hm,map[c]);
-			}else{
-				hm->enda = len_b;
-				hm->endb = len_a;
-				hm->len_a = len_b;
-				hm->len_b = len_a;
-				map[c] = hirsch_ps_dyn(profile[b],aln->s[a],hm,map[c],aln->nsip[b]);
-				map[c] = mirror_hirsch_path(map[c],len_a,len_b);
-			}
-		}else{
-			if(b < numseq){
-				map[c] = hirsch_ps_dyn(profile[a],aln->s[b],hm,map[c],aln->nsip[a]);
-			}else{
-				if(len_a < len_b){
-					map[c] = hirsch_pp_dyn(profile[a],profile[b],hm,map[c]);
-				}else{
-					hm->enda = len_b;
-					hm->endb = len_a;
-					hm->len_a = len_b;
-					hm->len_b = len_a;
-					map[c] = hirsch_pp_dyn(profile[b],profile[a],hm,map[c]);
-					map[c] = mirror_hirsch_path(map[c],len_a,len_b);
-				}
-			}
-		}
-		
-		map[c] = add_gap_info_to_hirsch_path(map[c],len_a,len_b);
-
-		if(i != numseq-2){
-			profile[c] = malloc(sizeof(float)*64*(map[c][0]+2));
-			profile[c] = update(profile[a],profile[b],profile[c],map[c],aln->nsip[a],aln->nsip[b]);
-		}
-			
-		aln->sl[c] = map[c][0];
-	
-		aln->nsip[c] = aln->nsip[a] + aln->nsip[b];
-		aln->sip[c] = malloc(sizeof(int)*(aln->nsip[a] + aln->nsip[b]));
-		g =0;
-		for (j = aln->nsip[a];j--;){
-			aln->sip[c][g] = aln->sip[a][j];
-			g++;
-		}
-		for (j = aln->nsip[b];j--;){
-			aln->sip[c][g] = aln->sip[b][j];
-			g++;
-		}
-
-		free(profile[a]);
-		free(profile[b]);
+		k_printf("Alignment: %8.0f percent done",(float)(level_start[i]) /(float)numseq * 100);
+		jobs.steps = steps + level_start[i];
+		run_parallel_jobs(level_start[i+1]-level_start[i],hirschberg_alignment_step,&jobs,
+			50+(float)(level_start[i]) /(float)numseq * 50,50+(float)(level_start[i+1]) /(float)numseq * 50);
 	}
 	k_printf("Alignment: %8.0f percent done\n",100.0);
 	set_task_progress(100);
+	free(steps);
+	free(level_start);
 	free(profile);
-	hirsch_mem_free(hm);
 	for (i = 32;i--;){
 		free(submatrix[i]);
 	}
@@ -1526,6 +1572,13 @@ int* hirsch_pp_dyn(const float* prof1,const float* prof2,struct hirsch_mem* hm,
 	if(hm->startb  >= hm->endb){
 		return hirsch_path;
 	}
+#ifdef KALIGN_PP_SSE
+	// the vectorized passes are used if the buffers are allocated
+	if(!hm->pp_depth && get_kalign_context()->pp_sse){
+		pp_mem_alloc(prof2,hm);
+	}
+	hm->pp_depth++;
+#endif
 
 	hm->enda = mid;
 	hm->f = foward_hirsch_pp_dyn(prof1,prof2,hm);
@@ -1545,6 +1598,14 @@ int* hirsch_pp_dyn(const float* prof1,const float* prof2,struct hirsch_mem* hm,
 	}*/
 
 	hirsch_path = hirsch_align_two_pp_vector(prof1,prof2,hm,hirsch_path,input_states,old_cor);
+
+#ifdef KALIGN_PP_SSE
+	hm->pp_depth--;
+	if(!hm->pp_depth){
+		free(hm->pp_mem);
+		hm->pp_mem = 0;
+	}
+#endif
 	return hirsch_path;
 }
 
@@ -1889,6 +1950,31 @@ int* hirsch_align_two_pp_vector(const float* prof1,const float* prof2,struct hir
 	return hirsch_path;
 }
 
+#ifdef KALIGN_PP_SSE
+/* stores the match features and the gap open penalties of prof2 by position:
+   foward_hirsch_pp_dyn and backward_hirsch_pp_dyn load them for four neighbour cells at once */
+static void pp_mem_alloc(const float* prof2,struct hirsch_mem* hm)
+{
+	int stride = hm->len_b+2;
+	int i,j;
+
+	hm->pp_stride = stride;
+	hm->pp_mem = malloc(sizeof(float)*28*stride);
+	checkAllocatedMemory(hm->pp_mem);
+	hm->pp_features = hm->pp_mem;
+	hm->pp_gpo_f = hm->pp_features + 26*stride;
+	hm->pp_gpo_b = hm->pp_gpo_f + stride;
+
+	for (i = 0; i < stride;i++){
+		for (j = 0; j < 26;j++){
+			hm->pp_features[j*stride+i] = prof2[(i<<6)+32+j];
+		}
+		hm->pp_gpo_f[i] = (i) ? prof2[((i-1)<<6)+27] : 0.0f;
+		hm->pp_gpo_b[i] = (i+1 < stride) ? prof2[((i+1)<<6)+27] : 0.0f;
+	}
+}
+#endif
+
 struct states* foward_hirsch_pp_dyn(const float* prof1,const float* prof2,struct hirsch_mem* hm)
 {
 	unsigned int freq[26];
@@ -1905,6 +1991,10 @@ struct states* foward_hirsch_pp_dyn(const float* prof1,const float* prof2,struct
 	register int i = 0;
 	register int j = 0;
 	register int c = 0;
+#ifdef KALIGN_PP_SSE
+	float match[4];
+	__m128 a4,ga4,gb4,x4,carry;
+#endif
 	
 	prof1 += (hm->starta) << 6;
 	prof2 +=  (hm->startb) << 6;
@@ -1962,7 +2052,43 @@ struct states* foward_hirsch_pp_dyn(const float* prof1,const float* prof2,struct
 		}else{
 			s[hm->startb].gb = MAX(pgb,pa)+ prof1[29];
 		}
-		for (j = hm->startb+1; j < hm->endb;j++){
+		j = hm->startb+1;
+#ifdef KALIGN_PP_SSE
+		// the match moves into four cells need the previous row only: they are scored at once
+		if(hm->pp_mem){
+			carry = _mm_setr_ps(pa,pga,pgb,0.0f);
+			for (; j+3 < hm->endb;j+=4){
+				a4 = carry;
+				ga4 = _mm_loadu_ps(&s[j].a);
+				gb4 = _mm_loadu_ps(&s[j+1].a);
+				x4 = _mm_loadu_ps(&s[j+2].a);
+				carry = _mm_loadu_ps(&s[j+3].a);
+				_MM_TRANSPOSE4_PS(a4,ga4,gb4,x4);
+
+				a4 = _mm_max_ps(a4,_mm_add_ps(ga4,_mm_loadu_ps(hm->pp_gpo_f+j)));
+				a4 = _mm_max_ps(a4,_mm_add_ps(gb4,_mm_set1_ps(prof1[-37])));
+				for (c = 1;c < freq[0];c++){
+					a4 = _mm_add_ps(a4,_mm_mul_ps(_mm_set1_ps(prof1[freq[c]]),_mm_loadu_ps(hm->pp_features+freq[c]*hm->pp_stride+j)));
+				}
+				_mm_storeu_ps(match,a4);
+
+				for (c = 0;c < 4;c++){
+					prof2 += 64;
+					ca = s[j+c].a;
+					s[j+c].a = match[c];
+					s[j+c].ga = MAX(xga+prof2[28],xa+prof2[27]);
+					s[j+c].gb = MAX(s[j+c].gb+prof1[28] ,ca+prof1[27]);
+					xa = s[j+c].a;
+					xga = s[j+c].ga;
+				}
+			}
+			_mm_storeu_ps(match,carry);
+			pa = match[0];
+			pga = match[1];
+			pgb = match[2];
+		}
+#endif
+		for (; j < hm->endb;j++){
 			prof2 += 64;
 			ca = s[j].a;
 			
@@ -2033,6 +2159,10 @@ struct states* backward_hirsch_pp_dyn(const float* prof1,const float* prof2,stru
 	register int i = 0;
 	register int j = 0;
 	register int c = 0;
+#ifdef KALIGN_PP_SSE
+	float match[4];
+	__m128 a4,ga4,gb4,x4,carry;
+#endif
 
 	prof1 += (hm->enda+1) << 6;
 	prof2 += (hm->endb+1) << 6;
@@ -2090,7 +2220,43 @@ struct states* backward_hirsch_pp_dyn(const float* prof1,const float* prof2,stru
 		}
 
 		prof2 += (hm->endb-hm->startb) << 6;
-		for(j = hm->endb-1;j > hm->startb;j--){
+		j = hm->endb-1;
+#ifdef KALIGN_PP_SSE
+		// the cells j-3 ... j are scored at once, their match moves come from the cells j-2 ... j+1 of the previous row
+		if(hm->pp_mem){
+			carry = _mm_setr_ps(pa,pga,pgb,0.0f);
+			for (; j-3 > hm->startb;j-=4){
+				a4 = _mm_loadu_ps(&s[j-2].a);
+				ga4 = _mm_loadu_ps(&s[j-1].a);
+				gb4 = _mm_loadu_ps(&s[j].a);
+				x4 = carry;
+				carry = _mm_loadu_ps(&s[j-3].a);
+				_MM_TRANSPOSE4_PS(a4,ga4,gb4,x4);
+
+				a4 = _mm_max_ps(a4,_mm_add_ps(ga4,_mm_loadu_ps(hm->pp_gpo_b+j-2)));
+				a4 = _mm_max_ps(a4,_mm_add_ps(gb4,_mm_set1_ps(prof1[91])));
+				for (c = 1;c < freq[0];c++){
+					a4 = _mm_add_ps(a4,_mm_mul_ps(_mm_set1_ps(prof1[freq[c]]),_mm_loadu_ps(hm->pp_features+freq[c]*hm->pp_stride+j-2)));
+				}
+				_mm_storeu_ps(match,a4);
+
+				for (c = 3;c >= 0;c--){
+					prof2 -= 64;
+					ca = s[j-3+c].a;
+					s[j-3+c].a = match[c];
+					s[j-3+c].ga = MAX(xga+prof2[28], xa+prof2[27]);
+					s[j-3+c].gb = MAX(s[j-3+c].gb+prof1[28], ca+prof1[27]);
+					xa = s[j-3+c].a;
+					xga = s[j-3+c].ga;
+				}
+			}
+			_mm_storeu_ps(match,carry);
+			pa = match[0];
+			pga = match[1];
+			pgb = match[2];
+		}
+#endif
+		for(;j > hm->startb;j--){
 			prof2 -= 64;
 			ca = s[j].a;
 
@@ -31,12 +31,134 @@
 
 
 
-int** dna_alignment(struct alignment* aln,int* tree,float**submatrix, int** map,float strength)
+struct dna_alignment_jobs{
+    struct alignment* aln;
+    int* tree;
+    float** submatrix;
+    int** map;
+    float** profile;
+    int* steps;
+    float strength;
+    unsigned int numseq;
+};
+
+/* aligns the two nodes of one step of the tree: the step uses only its own nodes and own memory */
+static void dna_alignment_step(int job,void* data)
 {
+    struct dna_alignment_jobs* jobs = data;
+    struct alignment* aln = jobs->aln;
+    float** submatrix = jobs->submatrix;
+    int** map = jobs->map;
+    float** profile = jobs->profile;
+    float strength = jobs->strength;
+    unsigned int numseq = jobs->numseq;
     struct hirsch_mem* hm = 0;
-    int i,j,g,a,b,c,pos;
+    int i,j,g,a,b,c;
     int len_a;
     int len_b;
+
+    i = jobs->steps[job];
+    a = jobs->tree[i*3];
+    b = jobs->tree[i*3+1];
+    c = jobs->tree[i*3+2];
+    //k_printf("Aligning:%d %d->%d	done:%0.2f\n",a,b,c,((float)(i+1)/(float)numseq)*100);
+    len_a = aln->sl[a];
+    len_b = aln->sl[b];
+
+    g = (len_a > len_b)? len_a:len_b;
+    map[c] = malloc(sizeof(int) * (g+2));
+    checkAllocatedMemory(map[c]);
+    hm = hirsch_mem_alloc(hm,g);
+
+    for (j = 0; j < (g+2);j++){
+        map[c][j] = -1;
+    }
+
+    if (a < numseq){
+        profile[a] = dna_make_profile(profile[a],aln->s[a],len_a,submatrix);
+        checkAllocatedMemory(profile[a]);
+    }
+    if (b < numseq){
+        profile[b] = dna_make_profile(profile[b],aln->s[b],len_b,submatrix);
+        checkAllocatedMemory(profile[b]);
+    }
+    dna_set_gap_penalties(profile[a],len_a,aln->nsip[b],strength,aln->nsip[a]);
+    dna_set_gap_penalties(profile[b],len_b,aln->nsip[a],strength,aln->nsip[b]);
+
+    hm->starta = 0;
+    hm->startb = 0;
+    hm->enda = len_a;
+    hm->endb = len_b;
+    hm->len_a = len_a;
+    hm->len_b = len_b;
+
+    hm->f[0].a = 0.0;
+    hm->f[0].ga =  -FLOATINFTY;
+    hm->f[0].gb = -FLOATINFTY;
+    hm->b[0].a = 0.0;
+    hm->b[0].ga =  -FLOATINFTY;
+    hm->b[0].gb =  -FLOATINFTY;
+//	k_printf("LENA:%d	LENB:%d	numseq:%d\n",len_a,len_b,numseq);
+    if(a < numseq){
+        if(b < numseq){
+            map[c] = hirsch_dna_ss_dyn(submatrix,aln->s[a],aln->s[b],hm,map[c]);
+        }else{
+            hm->enda = len_b;
+            hm->endb = len_a;
+            hm->len_a = len_b;
+            hm->len_b = len_a;
+            map[c] = hirsch_dna_ps_dyn(profile[b],aln->s[a],hm,map[c],aln->nsip[b]);
+            map[c] = mirror_hirsch_path(map[c],len_a,len_b);
+        }
+    }else{
+        if(b < numseq){
+            map[c] = hirsch_dna_ps_dyn(profile[a],aln->s[b],hm,map[c],aln->nsip[a]);
+        }else{
+            if(len_a < len_b){
+                map[c] = hirsch_dna_pp_dyn(profile[a],profile[b],hm,map[c]);
+            }else{
+                hm->enda = len_b;
+                hm->endb = len_a;
+                hm->len_a = len_b;
+                hm->len_b = len_a;
+                map[c] = hirsch_dna_pp_dyn(profile[b],profile[a],hm,map[c]);
+                map[c] = mirror_hirsch_path(map[c],len_a,len_b);
+            }
+        }
+    }
+    map[c] = add_gap_info_to_hirsch_path(map[c],len_a,len_b);
+
+    if(i != numseq-2){
+        profile[c] = malloc(sizeof(float)*22*(map[c][0]+2));
+        checkAllocatedMemory(profile[c]);
+        profile[c] = dna_update(profile[a],profile[b],profile[c],map[c],aln->nsip[a],aln->nsip[b]);
+    }
+
+    aln->sl[c] = map[c][0];
+
+    aln->nsip[c] = aln->nsip[a] + aln->nsip[b];
+    aln->sip[c] = malloc(sizeof(int)*(aln->nsip[a] + aln->nsip[b]));
+    g =0;
+    for (j = aln->nsip[a];j--;){
+        aln->sip[c][g] = aln->sip[a][j];
+        g++;
+    }
+    for (j = aln->nsip[b];j--;){
+        aln->sip[c][g] = aln->sip[b][j];
+        g++;
+    }
+
+    free(profile[a]);
+    free(profile[b]);
+    hirsch_mem_free(hm);
+}
+
+int** dna_alignment(struct alignment* aln,int* tree,float**submatrix, int** map,float strength)
+{
+    struct dna_alignment_jobs jobs;
+    int* steps = 0;
+    int* level_start = 0;
+    int i,levels;
     float** profile = 0;
 
     unsigned int numseq;
@@ -55,131 +177,37 @@ int** dna_alignment(struct alignment* aln,int* tree,float**submatrix, int** map,
         map[i] = 0;
     }
 
-    hm = hirsch_mem_alloc(hm,1024);
-    //k_printf("\nAlignment:\n");
-    for (i = 0; i < (numseq-1);i++){
-        if(check_task_canceled(ctx)) {
-            break;
-        }
-        a = tree[i*3];
-        b = tree[i*3+1];
-        c = tree[i*3+2];
-        k_printf("Alignment: %8.0f percent done",(float)(i) /(float)numseq * 100);
-        set_task_progress(50+(float)(i) /(float)numseq * 50);
-        //k_printf("Aligning:%d %d->%d	done:%0.2f\n",a,b,c,((float)(i+1)/(float)numseq)*100);
-        len_a = aln->sl[a];
-        len_b = aln->sl[b];
-
-        g = (len_a > len_b)? len_a:len_b;
-        map[c] = malloc(sizeof(int) * (g+2));
-        if (NULL == map[c]) {
-            for (pos = 0; pos < numprofiles; pos++){
-                free(map[pos]);
-                free(profile[pos]);
-            }
-            free(map);
-            free(profile);
-            checkAllocatedMemory(NULL);
-        }
-        if(g > hm->size){
-            hm = hirsch_mem_realloc(hm,g);
-        }
-
-        for (j = 0; j < (g+2);j++){
-            map[c][j] = -1;
-        }
-
-        if (a < numseq){
-            profile[a] = dna_make_profile(profile[a],aln->s[a],len_a,submatrix);
-            if (profile[a] == NULL) {
-                return NULL;
-            }
-        }
-        if (b < numseq){
-            profile[b] = dna_make_profile(profile[b],aln->s[b],len_b,submatrix);
-            if (profile[b] == NULL) {
-                return NULL;
-            }
-        }
-        k_printf("Saving mem...\n");
-
-        dna_set_gap_penalties(profile[a],len_a,aln->nsip[b],strength,aln->nsip[a]);
-        dna_set_gap_penalties(profile[b],len_b,aln->nsip[a],strength,aln->nsip[b]);
+    steps = malloc(sizeof(int)*(numseq-1));
+    level_start = malloc(sizeof(int)*numseq);
+    levels = tree_levels(tree,steps,level_start,numseq,numprofiles);
 
-        hm->starta = 0;
-        hm->startb = 0;
-        hm->enda = len_a;
-        hm->endb = len_b;
-        hm->len_a = len_a;
-        hm->len_b = len_b;
+    jobs.aln = aln;
+    jobs.tree = tree;
+    jobs.submatrix = submatrix;
+    jobs.map = map;
+    jobs.profile = profile;
+    jobs.strength = strength;
+    jobs.numseq = numseq;
 
-        hm->f[0].a = 0.0;
-        hm->f[0].ga =  -FLOATINFTY;
-        hm->f[0].gb = -FLOATINFTY;
-        hm->b[0].a = 0.0;
-        hm->b[0].ga =  -FLOATINFTY;
-        hm->b[0].gb =  -FLOATINFTY;
-    //	k_printf("LENA:%d	LENB:%d	numseq:%d\n",len_a,len_b,numseq);
-        if(a < numseq){
-            if(b < numseq){
-                map[c] = hirsch_dna_ss_dyn(submatrix,aln->s[a],aln->s[b],hm,map[c]);
-            }else{
-                hm->enda = len_b;
-                hm->endb = len_a;
-                hm->len_a = len_b;
-                hm->len_b = len_a;
-                map[c] = hirsch_dna_ps_dyn(profile[b],aln->s[a],hm,map[c],aln->nsip[b]);
-                map[c] = mirror_hirsch_path(map[c],len_a,len_b);
-            }
-        }else{
-            if(b < numseq){
-                map[c] = hirsch_dna_ps_dyn(profile[a],aln->s[b],hm,map[c],aln->nsip[a]);
-            }else{
-                if(len_a < len_b){
-                    map[c] = hirsch_dna_pp_dyn(profile[a],profile[b],hm,map[c]);
-                }else{
-                    hm->enda = len_b;
-                    hm->endb = len_a;
-                    hm->len_a = len_b;
-                    hm->len_b = len_a;
-                    map[c] = hirsch_dna_pp_dyn(profile[b],profile[a],hm,map[c]);
-                    map[c] = mirror_hirsch_path(map[c],len_a,len_b);
-                }
-            }
-        }
-        map[c] = add_gap_info_to_hirsch_path(map[c],len_a,len_b);
-
-        if(i != numseq-2){
-            profile[c] = malloc(sizeof(float)*22*(map[c][0]+2));
-            if (profile[c] == NULL) {
-                return NULL;
-            }
-            profile[c] = dna_update(profile[a],profile[b],profile[c],map[c],aln->nsip[a],aln->nsip[b]);
-        }
-
-        aln->sl[c] = map[c][0];
+    //k_printf("\nAlignment:\n");
 
-        aln->nsip[c] = aln->nsip[a] + aln->nsip[b];
-        aln->sip[c] = malloc(sizeof(int)*(aln->nsip[a] + aln->nsip[b]));
-        g =0;
-        for (j = aln->nsip[a];j--;){
-            aln->sip[c][g] = aln->sip[a][j];
-            g++;
-        }
-        for (j = aln->nsip[b];j--;){
-            aln->sip[c][g] = aln->sip[b][j];
-            g++;
+    // the steps of one level are independent, so they are aligned in parallel
+    for (i = 0; i < levels;i++){
+        if(check_task_canceled(ctx)) {
+            break;
         }
-
-        free(profile[a]);
-        free(profile[b]);
+        k_printf("Alignment: %8.0f percent done",(float)(level_start[i]) /(float)numseq * 100);
+        jobs.steps = steps + level_start[i];
+        run_parallel_jobs(level_start[i+1]-level_start[i],dna_alignment_step,&jobs,
+            50+(float)(level_start[i]) /(float)numseq * 50,50+(float)(level_start[i+1]) /(float)numseq * 50);
     }
 
     k_printf("Alignment: %8.0f percent done\n",100.0);
     set_task_progress(100);
     //free(profile[numprofiles-1]);
+    free(steps);
+    free(level_start);
     free(profile);
-    hirsch_mem_free(hm);
     for (i = 32;i--;){
         free(submatrix[i]);
     }
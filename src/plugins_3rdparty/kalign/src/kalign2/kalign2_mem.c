@@ -211,6 +211,12 @@ struct hirsch_mem* hirsch_mem_alloc(struct hirsch_mem* hm,int x)
 	hm->size = x;
 	hm->len_a = 0;
 	hm->len_b = 0;
+	hm->pp_depth = 0;
+	hm->pp_stride = 0;
+	hm->pp_mem = 0;
+	hm->pp_features = 0;
+	hm->pp_gpo_f = 0;
+	hm->pp_gpo_b = 0;
 	hm->f = malloc(sizeof(struct states)* (x+1));
 	hm->b = malloc(sizeof(struct states)* (x+1));
 	return hm;
@@ -232,6 +238,7 @@ struct hirsch_mem* hirsch_mem_realloc(struct hirsch_mem* hm,int x)
 
 void hirsch_mem_free(struct hirsch_mem* hm)
 {
+	free(hm->pp_mem);
 	free(hm->f);
 	free(hm->b);
 	free(hm);
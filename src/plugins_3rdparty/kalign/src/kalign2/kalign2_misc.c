@@ -308,6 +308,53 @@ int* readtree(struct aln_tree_node* p,int* tree)
 	return tree;
 }
 
+/* groups the alignment steps of the tree by their depth: the steps of one level depend only on the lower levels.
+   steps gets the step numbers level by level, level l starts at steps[level_start[l]] (numseq-1 steps, numseq level starts).
+   Returns the number of levels. */
+int tree_levels(int* tree,int* steps,int* level_start,unsigned int numseq,unsigned int numprofiles)
+{
+	int* node_level = 0;
+	int* step_level = 0;
+	int levels = 0;
+	int i,a,b;
+
+	node_level = malloc(sizeof(int)*numprofiles);
+	checkAllocatedMemory(node_level);
+	step_level = malloc(sizeof(int)*numseq);
+	checkAllocatedMemory(step_level);
+
+	for (i = 0; i < numprofiles;i++){
+		node_level[i] = 0;
+	}
+	for (i = 0; i < numseq-1;i++){
+		a = node_level[tree[i*3]];
+		b = node_level[tree[i*3+1]];
+		step_level[i] = (a > b) ? a : b;
+		node_level[tree[i*3+2]] = step_level[i] + 1;
+		if (step_level[i] >= levels){
+			levels = step_level[i] + 1;
+		}
+	}
+
+	for (i = 0; i <= levels;i++){
+		level_start[i] = 0;
+	}
+	for (i = 0; i < numseq-1;i++){
+		level_start[step_level[i]+1]++;
+	}
+	for (i = 0; i < levels;i++){
+		level_start[i+1] += level_start[i];
+		node_level[i] = level_start[i];
+	}
+	for (i = 0; i < numseq-1;i++){
+		steps[node_level[step_level[i]]++] = i;
+	}
+
+	free(node_level);
+	free(step_level);
+	return levels;
+}
+
 struct alignment* make_dna(struct alignment* aln)
 {
 
@@ -38,6 +38,9 @@
 #include <U2Core/MAlignmentImporter.h>
 #include <U2Core/MAlignmentObject.h>
 #include <U2Core/DNASequenceObject.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
 
 #include <QtCore/QDir>
 
@@ -58,6 +61,9 @@ extern double QScore(const MAlignment& maTest, const MAlignment& maRef, TaskStat
 #define IN_DIR_ATTR "indir"
 #define PAT_DIR_ATTR "refdir"
 #define PARALLEL_FLAG_ATTR "parallel"
+#define ALPHABET_ATTR "alphabet"
+#define SEQUENCES_COUNT_ATTR "sequences"
+#define SEQUENCE_LENGTH_ATTR "length"
 #define MAX_ITERS_ATTR "maxiters"
 #define REFINE_ONLY_ATTR "refine"
 #define REGION_ATTR "region"
@@ -480,11 +486,101 @@ Task::ReportResult GTest_Kalign_Load_Align_QScore::report() {
 GTest_Kalign_Load_Align_QScore::~GTest_Kalign_Load_Align_QScore() {
 }
 
+void GTest_Kalign_Parallel_Serial::init(XMLTestFormat*, const QDomElement& el) {
+    serialTask = NULL;
+    alphabetId = el.attribute(ALPHABET_ATTR, "amino") == "dna" ? BaseDNAAlphabetIds::NUCL_DNA_DEFAULT() : BaseDNAAlphabetIds::AMINO_DEFAULT();
+
+    bool ok = true;
+    sequencesCount = el.attribute(SEQUENCES_COUNT_ATTR, "40").toInt(&ok);
+    if (!ok || sequencesCount < 2) {
+        stateInfo.setError(QString("Invalid value of %1: %2").arg(SEQUENCES_COUNT_ATTR).arg(el.attribute(SEQUENCES_COUNT_ATTR)));
+        return;
+    }
+    sequenceLength = el.attribute(SEQUENCE_LENGTH_ATTR, "200").toInt(&ok);
+    if (!ok || sequenceLength < 1) {
+        stateInfo.setError(QString("Invalid value of %1: %2").arg(SEQUENCE_LENGTH_ATTR).arg(el.attribute(SEQUENCE_LENGTH_ATTR)));
+        return;
+    }
+}
+
+void GTest_Kalign_Parallel_Serial::prepare() {
+    const DNAAlphabet* alphabet = AppContext::getDNAAlphabetRegistry()->findById(alphabetId);
+    CHECK_EXT(NULL != alphabet, stateInfo.setError(QString("Alphabet is not found: %1").arg(alphabetId)), );
+    const QByteArray symbols = alphabetId == BaseDNAAlphabetIds::AMINO_DEFAULT() ? "ACDEFGHIKLMNPQRSTVWY" : "ACGT";
+
+    // the sequences are mutated copies of one root to give the guide tree some structure
+    qsrand(42);
+    QByteArray root;
+    for (int i = 0; i < sequenceLength; i++) {
+        root.append(symbols.at(qrand() % symbols.size()));
+    }
+    inputMA = MAlignment("kalign_parallel_serial", alphabet);
+    for (int i = 0; i < sequencesCount; i++) {
+        QByteArray sequence;
+        foreach (char c, root) {
+            const int mutation = qrand() % 20;
+            if (mutation == 0) {
+                // deletion
+                continue;
+            }
+            if (mutation == 1) {
+                // insertion
+                sequence.append(symbols.at(qrand() % symbols.size()));
+            }
+            // substitution
+            sequence.append(mutation == 2 ? symbols.at(qrand() % symbols.size()) : c);
+        }
+        U2OpStatusImpl os;
+        inputMA.addRow(QString("seq_%1").arg(i), sequence, os);
+        CHECK_OP_EXT(os, stateInfo.setError(os.getError()), );
+    }
+
+    serialTask = createKalignTask(1, false);
+    checkTasks << createKalignTask(1, true);
+    checkTasks << createKalignTask(4, false);
+    checkTasks << createKalignTask(4, true);
+}
+
+KalignTask* GTest_Kalign_Parallel_Serial::createKalignTask(int threadsCount, bool useSse) {
+    KalignTaskSettings settings;
+    settings.threadsCount = threadsCount;
+    settings.useSse = useSse;
+    KalignTask* task = new KalignTask(inputMA, settings);
+    addSubTask(task);
+    return task;
+}
+
+Task::ReportResult GTest_Kalign_Parallel_Serial::report() {
+    propagateSubtaskError();
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    foreach (const KalignTask* task, checkTasks) {
+        compareResults(task);
+        CHECK_OP(stateInfo, ReportResult_Finished);
+    }
+    return ReportResult_Finished;
+}
+
+void GTest_Kalign_Parallel_Serial::compareResults(const KalignTask* task) {
+    const MAlignment& expected = serialTask->resultMA;
+    const MAlignment& actual = task->resultMA;
+    const QString settings = QString("threads: %1, SSE: %2").arg(task->config.threadsCount).arg(task->config.useSse);
+    CHECK_EXT(expected.getNumRows() == actual.getNumRows(),
+        stateInfo.setError(QString("Rows count not matched (%1): %2, expected %3").arg(settings).arg(actual.getNumRows()).arg(expected.getNumRows())), );
+    for (int i = 0; i < expected.getNumRows(); i++) {
+        const MAlignmentRow& expectedRow = expected.getRow(i);
+        const MAlignmentRow& actualRow = actual.getRow(i);
+        CHECK_EXT(expectedRow.getName() == actualRow.getName(),
+            stateInfo.setError(QString("Row names not matched (%1): %2, expected %3").arg(settings).arg(actualRow.getName()).arg(expectedRow.getName())), );
+        CHECK_EXT(expectedRow == actualRow,
+            stateInfo.setError(QString("Row %1 is aligned differently than on one thread without SSE (%2)").arg(expectedRow.getName()).arg(settings)), );
+    }
+}
 
 QList<XMLTestFactory*> KalignTests::createTestFactories() {
     QList<XMLTestFactory*> res;
     res.append(GTest_Kalign_Load_Align_Compare::createFactory());
     res.append(GTest_Kalign_Load_Align_QScore::createFactory());
+    res.append(GTest_Kalign_Parallel_Serial::createFactory());
     return res;
 }
 
@@ -105,6 +105,29 @@ private:
 	MAlignmentObject*           ma2;
 };
 
+/**
+ * Aligns the same generated sequences on one thread with the scalar profile-profile passes
+ * and on several threads with the SSE passes, the alignments must be identical
+ */
+class GTest_Kalign_Parallel_Serial : public GTest {
+	Q_OBJECT
+public:
+	SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_Kalign_Parallel_Serial, "kalign-parallel-serial");
+	void prepare();
+	Task::ReportResult report();
+
+private:
+	KalignTask* createKalignTask(int threadsCount, bool useSse);
+	void compareResults(const KalignTask* task);
+
+	QString alphabetId;
+	int sequencesCount;
+	int sequenceLength;
+	MAlignment inputMA;
+	KalignTask* serialTask;
+	QList<KalignTask*> checkTasks;
+};
+
 class KalignTests {
 public:
 	static QList<XMLTestFactory*> createTestFactories();
@@ -5,6 +5,7 @@ HEADERS += src/SeqBootAdapter.h \
            src/cons.h \
            src/seqboot.h \
            src/DistanceMatrix.h \
+           src/FastNeighborJoin.h \
            src/NeighborJoinAdapter.h \
            src/NeighborJoinWidget.h \
            src/PhylipPlugin.h \
@@ -20,6 +21,7 @@ SOURCES += src/SeqBootAdapter.cpp \
            src/cons.cpp \
            src/seqboot.cpp \
            src/DistanceMatrix.cpp \
+           src/FastNeighborJoin.cpp \
            src/NeighborJoinAdapter.cpp \
            src/NeighborJoinWidget.cpp \
            src/PhylipPlugin.cpp \
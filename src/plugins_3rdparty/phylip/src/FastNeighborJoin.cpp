@@ -0,0 +1,276 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <U2Core/MAlignment.h>
+#include <U2Core/PhyTree.h>
+#include <U2Core/U2OpStatus.h>
+#include <U2Core/U2SafePoints.h>
+
+#include "FastNeighborJoin.h"
+
+namespace U2 {
+
+FastNeighborJoin::FastNeighborJoin(const matrix &distances)
+    : taxaCount(distances.size()), nextNodeId(distances.size())
+{
+    const int nodeCount = qMax(2 * taxaCount - 2, taxaCount);
+    d.resize(taxaCount);
+    r.fill(0, taxaCount);
+    rows.resize(taxaCount);
+    slotNode.resize(taxaCount);
+    nodeSlot.fill(-1, nodeCount);
+    nodeActive.fill(false, nodeCount);
+    adjacency.resize(nodeCount);
+
+    // the matrix is symmetrized the same way 'neighbor' does it
+    for (int i = 0; i < taxaCount; i++) {
+        d[i].resize(taxaCount);
+        for (int j = 0; j < taxaCount; j++) {
+            d[i][j] = (i == j) ? 0 : (distances[i][j] + distances[j][i]) / 2;
+        }
+    }
+
+    for (int i = 0; i < taxaCount; i++) {
+        slotNode[i] = i;
+        nodeSlot[i] = i;
+        nodeActive[i] = true;
+        activeSlots.append(i);
+        for (int j = 0; j < taxaCount; j++) {
+            r[i] += d[i][j];
+        }
+        // the pair (i, j) is looked up in the row of the smaller index only
+        rows[i].reserve(taxaCount - i - 1);
+        for (int j = i + 1; j < taxaCount; j++) {
+            rows[i].append(RowItem(d[i][j], j));
+        }
+        qSort(rows[i]);
+    }
+}
+
+void FastNeighborJoin::calculateTree(U2OpStatus &os) {
+    CHECK_EXT(taxaCount >= 3, os.setError("Neighbor-Joining runs must have at least 3 species"), );
+
+    int lastCompactionCount = taxaCount;
+    while (activeSlots.size() > 3) {
+        CHECK_OP(os, );
+        const int activeCount = activeSlots.size();
+
+        double maxR = r[activeSlots.first()];
+        foreach (int slot, activeSlots) {
+            maxR = qMax(maxR, r[slot]);
+        }
+
+        double bestQ = 0;
+        int bestA = -1;
+        int bestB = -1;
+        foreach (int slotA, activeSlots) {
+            const double rA = r[slotA];
+            const QVector<RowItem> &row = rows[slotA];
+            for (int i = 0; i < row.size(); i++) {
+                const RowItem &item = row[i];
+                if (bestA != -1 && (activeCount - 2) * (double)item.distance - rA - maxR >= bestQ) {
+                    break;
+                }
+                if (!nodeActive[item.node]) {
+                    continue;
+                }
+                const int slotB = nodeSlot[item.node];
+                const double q = (activeCount - 2) * (double)item.distance - rA - r[slotB];
+                if (bestA == -1 || q < bestQ) {
+                    bestQ = q;
+                    bestA = slotA;
+                    bestB = slotB;
+                }
+            }
+        }
+        SAFE_POINT_EXT(bestA != -1 && bestB != -1, os.setError("Neighbor-Joining failed to find a pair of nodes to join"), );
+
+        join(bestA, bestB, activeCount);
+
+        if (activeSlots.size() * 2 < lastCompactionCount) {
+            compactRows();
+            lastCompactionCount = activeSlots.size();
+        }
+        os.setProgress(100 * (taxaCount - activeSlots.size()) / taxaCount);
+    }
+    CHECK_OP(os, );
+    joinLastThree();
+}
+
+qint64 FastNeighborJoin::getMemoryUsage(int taxaCount) {
+    return (qint64)taxaCount * taxaCount * (sizeof(float) + sizeof(RowItem));
+}
+
+void FastNeighborJoin::join(int slotA, int slotB, int activeCount) {
+    const double dAB = d[slotA][slotB];
+    const double lengthA = 0.5 * dAB + (r[slotA] - r[slotB]) / (2.0 * (activeCount - 2));
+    const double lengthB = dAB - lengthA;
+
+    const int nodeA = slotNode[slotA];
+    const int nodeB = slotNode[slotB];
+    const int newNode = nextNodeId++;
+    addEdge(newNode, nodeA, lengthA);
+    addEdge(newNode, nodeB, lengthB);
+
+    nodeActive[nodeA] = false;
+    nodeActive[nodeB] = false;
+    nodeSlot[nodeA] = -1;
+    nodeSlot[nodeB] = -1;
+    activeSlots.remove(activeSlots.indexOf(slotB));
+
+    // the new node takes the slot of the first joined node
+    double newR = 0;
+    QVector<RowItem> newRow;
+    newRow.reserve(activeSlots.size() - 1);
+    foreach (int slotK, activeSlots) {
+        if (slotK == slotA) {
+            continue;
+        }
+        const float dK = (float)(0.5 * (d[slotA][slotK] + d[slotB][slotK] - dAB));
+        r[slotK] += dK - d[slotA][slotK] - d[slotB][slotK];
+        d[slotA][slotK] = dK;
+        d[slotK][slotA] = dK;
+        newR += dK;
+        newRow.append(RowItem(dK, slotNode[slotK]));
+    }
+    qSort(newRow);
+
+    slotNode[slotA] = newNode;
+    nodeSlot[newNode] = slotA;
+    nodeActive[newNode] = true;
+    r[slotA] = newR;
+    rows[slotA] = newRow;
+    rows[slotB].clear();
+}
+
+void FastNeighborJoin::joinLastThree() {
+    SAFE_POINT(activeSlots.size() == 3, "Unexpected count of nodes for the final join", );
+    const int a = activeSlots[0];
+    const int b = activeSlots[1];
+    const int c = activeSlots[2];
+    const double dAB = d[a][b];
+    const double dAC = d[a][c];
+    const double dBC = d[b][c];
+
+    const int newNode = nextNodeId++;
+    addEdge(newNode, slotNode[a], (dAB + dAC - dBC) / 2);
+    addEdge(newNode, slotNode[b], (dAB + dBC - dAC) / 2);
+    addEdge(newNode, slotNode[c], (dAC + dBC - dAB) / 2);
+    activeSlots.clear();
+}
+
+void FastNeighborJoin::compactRows() {
+    foreach (int slot, activeSlots) {
+        QVector<RowItem> &row = rows[slot];
+        int size = 0;
+        for (int i = 0; i < row.size(); i++) {
+            if (nodeActive[row[i].node]) {
+                row[size++] = row[i];
+            }
+        }
+        row.resize(size);
+        row.squeeze();
+    }
+}
+
+void FastNeighborJoin::addEdge(int node1, int node2, double length) {
+    adjacency[node1].append(Neighbor(node2, length));
+    adjacency[node2].append(Neighbor(node1, length));
+}
+
+int FastNeighborJoin::getRootNode() const {
+    // 'neighbor' roots the tree at the internal node the first species is attached to
+    SAFE_POINT(taxaCount >= 3 && adjacency[0].size() == 1, "Neighbor-Joining tree is not calculated", -1);
+    return adjacency[0].first().node;
+}
+
+QByteArray FastNeighborJoin::getNewickTree(const QList<QByteArray> &names) const {
+    QByteArray result;
+    const int root = getRootNode();
+    CHECK(root != -1, result);
+    SAFE_POINT(names.size() == taxaCount, "Unexpected count of species names", result);
+
+    result.append('(');
+    foreach (const Neighbor &child, adjacency[root]) {
+        if (child.node != 0) {
+            writeNewickSubtree(result, child.node, root, child.length, names);
+            result.append(',');
+        }
+    }
+    writeNewickSubtree(result, 0, root, adjacency[0].first().length, names);
+    result.append(");\n");
+    return result;
+}
+
+void FastNeighborJoin::writeNewickSubtree(QByteArray &out, int node, int parent, double length, const QList<QByteArray> &names) const {
+    if (node < taxaCount) {
+        out.append(names[node]);
+    } else {
+        out.append('(');
+        bool first = true;
+        foreach (const Neighbor &child, adjacency[node]) {
+            if (child.node == parent) {
+                continue;
+            }
+            if (!first) {
+                out.append(',');
+            }
+            first = false;
+            writeNewickSubtree(out, child.node, node, child.length, names);
+        }
+        out.append(')');
+    }
+    out.append(':');
+    out.append(QByteArray::number(length, 'f', 5));
+}
+
+PhyNode * FastNeighborJoin::createPhyTree(const MAlignment &ma) const {
+    const int root = getRootNode();
+    CHECK(root != -1, NULL);
+
+    int counter = 0;
+    PhyNode *rootNode = new PhyNode();
+    rootNode->setName(QString("node %1").arg(counter++));
+    foreach (const Neighbor &child, adjacency[root]) {
+        if (child.node != 0) {
+            createPhySubtree(rootNode, child.node, root, child.length, ma, counter);
+        }
+    }
+    createPhySubtree(rootNode, 0, root, adjacency[0].first().length, ma, counter);
+    return rootNode;
+}
+
+void FastNeighborJoin::createPhySubtree(PhyNode *parentNode, int node, int parent, double length, const MAlignment &ma, int &counter) const {
+    PhyNode *current = new PhyNode();
+    if (node < taxaCount) {
+        current->setName(ma.getRow(node).getName());
+    } else {
+        current->setName(QString("node %1").arg(counter++));
+        foreach (const Neighbor &child, adjacency[node]) {
+            if (child.node != parent) {
+                createPhySubtree(current, child.node, node, child.length, ma, counter);
+            }
+        }
+    }
+    PhyTreeData::addBranch(parentNode, current, length);
+}
+
+}   // namespace U2
@@ -0,0 +1,104 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_FAST_NEIGHBOR_JOIN_H_
+#define _U2_FAST_NEIGHBOR_JOIN_H_
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "DistanceMatrix.h"
+
+namespace U2 {
+
+class MAlignment;
+class PhyNode;
+class U2OpStatus;
+
+/**
+ * Re-entrant neighbor-joining over a precomputed distance matrix.
+ *
+ * Produces the same topology and branch lengths as the PHYLIP 'neighbor' program
+ * (up to the choice between equally good pairs), but keeps no global state and
+ * avoids the O(n^3) full scan: every row keeps its distances sorted, so the search
+ * for the next pair to join stops as soon as the lower bound of Q for the rest
+ * of the row exceeds the best value found so far (RapidNJ-like search).
+ */
+class FastNeighborJoin {
+public:
+    FastNeighborJoin(const matrix &distances);
+
+    void calculateTree(U2OpStatus &os);
+
+    /** Upper bound of the memory required for the calculation, in bytes */
+    static qint64 getMemoryUsage(int taxaCount);
+
+    /** Newick text in the format the PHYLIP programs write to 'outtree'. Names are written as is */
+    QByteArray getNewickTree(const QList<QByteArray> &names) const;
+
+    /** Returns the root of a new tree with the same layout as the one created out of the PHYLIP 'neighbor' tree */
+    PhyNode * createPhyTree(const MAlignment &ma) const;
+
+private:
+    struct Neighbor {
+        Neighbor() : node(-1), length(0) {}
+        Neighbor(int node, double length) : node(node), length(length) {}
+        int node;
+        double length;
+    };
+
+    struct RowItem {
+        RowItem() : distance(0), node(-1) {}
+        RowItem(float distance, int node) : distance(distance), node(node) {}
+        bool operator<(const RowItem &other) const { return distance < other.distance; }
+        float distance;
+        int node;
+    };
+
+    void join(int slotA, int slotB, int activeCount);
+    void joinLastThree();
+    void compactRows();
+    void addEdge(int node1, int node2, double length);
+    int getRootNode() const;
+    void writeNewickSubtree(QByteArray &out, int node, int parent, double length, const QList<QByteArray> &names) const;
+    void createPhySubtree(PhyNode *parentNode, int node, int parent, double length, const MAlignment &ma, int &counter) const;
+
+    int taxaCount;
+    int nextNodeId;
+
+    /* distances between the nodes placed in the slots */
+    QVector< QVector<float> > d;
+    /* sum of distances to the other active nodes, per slot */
+    QVector<double> r;
+    /* distances from the node in the slot sorted in ascending order, may contain joined nodes */
+    QVector< QVector<RowItem> > rows;
+    QVector<int> slotNode;
+    QVector<int> nodeSlot;
+    QVector<bool> nodeActive;
+    QVector<int> activeSlots;
+
+    QVector< QList<Neighbor> > adjacency;
+};
+
+}   // namespace U2
+
+#endif // _U2_FAST_NEIGHBOR_JOIN_H_
@@ -26,8 +26,10 @@
 #include <U2Core/Counter.h>
 #include <U2Core/DNAAlphabet.h>
 #include <U2Core/Task.h>
+#include <U2Core/U2SafePoints.h>
 
 #include "DistanceMatrix.h"
+#include "FastNeighborJoin.h"
 #include "NeighborJoinAdapter.h"
 #include "NeighborJoinWidget.h"
 #include "SeqBootAdapter.h"
@@ -40,6 +42,9 @@ namespace U2 {
 
 QMutex NeighborJoinCalculateTreeTask::runLock;
 
+/* Starting from this count of species the tree is built by FastNeighborJoin instead of 'neighbor' */
+#define FAST_NJ_MIN_TAXA 256
+
 void createPhyTreeFromPhylipTree(const MAlignment &ma, node *p, double m, boolean njoin, node *start, PhyNode* root, int bootstrap_repl)
 {
     /* used in fitch & neighbor */
@@ -105,197 +110,330 @@ CreatePhyTreeWidget * NeighborJoinAdapter::createPhyTreeSettingsWidget(const MAl
 }
 
 NeighborJoinCalculateTreeTask::NeighborJoinCalculateTreeTask(const MAlignment& ma, const CreatePhyTreeSettings& s)
-:PhyTreeGeneratorTask(ma, s), memLocker(stateInfo){
+:PhyTreeGeneratorTask(ma, s), memLocker(stateInfo), seqBootTask(NULL), replicatesDone(0){
     setTaskName("NeighborJoin algorithm");
 }
 
-void NeighborJoinCalculateTreeTask::run(){
-    QMutexLocker runLocker( &runLock );
+NeighborJoinCalculateTreeTask::~NeighborJoinCalculateTreeTask() {
+}
 
-    GCOUNTER(cvar,tvar, "PhylipNeigborJoin" );
+void NeighborJoinCalculateTreeTask::prepare() {
+    CHECK(settings.bootstrap && inputMA.getNumRows() >= 3, );
+
+    // the names are written the same way 'neighbor' writes them to the trees file
+    for (int i = 0; i < inputMA.getNumRows(); ++i) {
+        QByteArray name = inputMA.getRow(i).getName().toLatin1();
+        replacePhylipRestrictedSymbols(name);
+        name = name.left(nmlngth);
+        while (name.endsWith(' ')) {
+            name.chop(1);
+        }
+        phylipNames << name.replace(' ', '_');
+    }
+
+    stateInfo.setDescription("Generating sequences");
+    replicateTrees.resize(settings.replicates);
+    setMaxParallelSubtasks(AppResourcePool::instance()->getIdealThreadCount());
+    seqBootTask = new NeighborJoinSeqBootTask(this);
+    addSubTask(seqBootTask);
+}
+
+QList<Task*> NeighborJoinCalculateTreeTask::onSubTaskFinished(Task *subTask) {
+    QList<Task*> res;
+    CHECK(subTask == seqBootTask && !subTask->isCanceled() && !subTask->hasError(), res);
+
+    stateInfo.setDescription("Calculating trees");
+    for (int i = 0; i < settings.replicates; i++) {
+        res << new NeighborJoinReplicateTask(this, i);
+    }
+    return res;
+}
 
+void NeighborJoinCalculateTreeTask::run(){
+    CHECK_OP(stateInfo, );
+    GCOUNTER(cvar,tvar, "PhylipNeigborJoin" );
 
-    PhyTree phyTree(NULL);
+    result = PhyTree(NULL);
 
     if (inputMA.getNumRows() < 3) {
         setError("Neighbor-Joining runs must have at least 3 species");
-        result = phyTree;
         return;
     }
 
     try {
-        if(settings.bootstrap){ //bootstrapping and creating a consensus tree
-            setTaskInfo(&stateInfo);
-            setBootstr(true);
-            stateInfo.setDescription("Generating sequences");
+        if (settings.bootstrap) { //bootstrapping and creating a consensus tree
+            calculateConsensusTree();
+        } else {
+            calculateTree();
+        }
+    }
+    catch (const std::bad_alloc &) {
+        setError(QString("Not enough memory to calculate tree for alignment \"%1\"").arg(inputMA.getName()));
+    }
+    catch (const char* message) {
+        stateInfo.setError(QString("Phylip error %1").arg(message));
+    }
+}
 
-            QScopedPointer<SeqBoot> seqBoot(new SeqBoot);
+bool NeighborJoinCalculateTreeTask::calculateDistanceMatrix(const MAlignment &ma, TaskStateInfo &ti, matrix &distances) {
+    QScopedPointer<DistanceMatrix> distanceMatrix(new DistanceMatrix);
+    distanceMatrix->calculateOutOfAlignment(ma, settings);
 
-            QTemporaryFile tmpFile;
-            QString path = seqBoot->getTmpFileTemplate();
-            if(!path.isEmpty()){
-                tmpFile.setFileTemplate(path);
-            }
-            if(!tmpFile.open()){
-                setError("Can't create temporary file");
-                result = phyTree;
-                return;
-            }
+    if (!distanceMatrix->getErrorMessage().isEmpty()) {
+        ti.setError(distanceMatrix->getErrorMessage());
+        return false;
+    }
+    if (!distanceMatrix->isValid()) {
+        ti.setError("Calculated distance matrix is invalid");
+        return false;
+    }
+    distances = distanceMatrix->rawMatrix;
+    return true;
+}
 
-            seqBoot->generateSequencesFromAlignment(inputMA,settings);
+void NeighborJoinCalculateTreeTask::generateSequences(TaskStateInfo &ti) {
+    try {
+        // Exceptions are used to avoid phylip exit(-1) error handling and canceling task
+        QMutexLocker runLocker(&runLock);
+        setTaskInfo(&ti);
+        setBootstr(true);
+        seqBoot.reset(new SeqBoot);
+        seqBoot->generateSequencesFromAlignment(inputMA, settings);
+    }
+    catch (const std::bad_alloc &) {
+        ti.setError(QString("Not enough memory to calculate tree for alignment \"%1\"").arg(inputMA.getName()));
+    }
+    catch (const char* message) {
+        ti.setError(QString("Phylip error %1").arg(message));
+    }
+}
 
-            stateInfo.setDescription("Calculating trees");
+void NeighborJoinCalculateTreeTask::calculateReplicateTree(int replicate, TaskStateInfo &ti) {
+    try {
+        matrix distances;
+        {
+            // Exceptions are used to avoid phylip exit(-1) error handling and canceling task
+            QMutexLocker runLocker(&runLock);
+            setTaskInfo(&ti);
+            setBootstr(true);
+            SAFE_POINT_EXT(!seqBoot.isNull(), ti.setError("Bootstrap sequences are not generated"), );
+            CHECK(calculateDistanceMatrix(seqBoot->getMSA(replicate), ti, distances), );
+        }
 
-            bool initial = true;
-            for (int i = 0; i < settings.replicates; i++){
-                stateInfo.progress = (int)(i/(float)settings.replicates * 100);
+        if (distances.size() < FAST_NJ_MIN_TAXA) {
+            // the same gate as without bootstrap: small inputs keep going through 'neighbor'
+            replicateTrees[replicate] = calculateNeighborNewickTree(distances, ti);
+        } else {
+            MemoryLocker replicateMemLocker(ti);
+            CHECK(replicateMemLocker.tryAcquire(FastNeighborJoin::getMemoryUsage(distances.size())), );
 
-                const MAlignment& curMSA = seqBoot->getMSA(i);
-                QScopedPointer<DistanceMatrix> distanceMatrix(new DistanceMatrix);
-                distanceMatrix->calculateOutOfAlignment(curMSA,settings);
+            FastNeighborJoin neighborJoin(distances);
+            neighborJoin.calculateTree(ti);
+            CHECK_OP(ti, );
+            replicateTrees[replicate] = neighborJoin.getNewickTree(phylipNames);
+        }
+    }
+    catch (const std::bad_alloc &) {
+        ti.setError(QString("Not enough memory to calculate tree for alignment \"%1\"").arg(inputMA.getName()));
+    }
+    catch (const char* message) {
+        ti.setError(QString("Phylip error %1").arg(message));
+    }
 
-                if(!distanceMatrix->getErrorMessage().isEmpty()) {
-                    stateInfo.setError(distanceMatrix->getErrorMessage());
-                    result = phyTree;
-                    return;
-                }
-                if (!distanceMatrix->isValid()) {
-                    setError("Calculated distance matrix is invalid");
-                    result = phyTree;
-                    return;
-                }
+    const int done = replicatesDone.fetchAndAddOrdered(1) + 1;
+    stateInfo.progress = qMin(99, (int)(done / (float)settings.replicates * 100));
+}
 
-                int sz = distanceMatrix->rawMatrix.count();
+QByteArray NeighborJoinCalculateTreeTask::calculateNeighborNewickTree(const matrix &distances, TaskStateInfo &ti) {
+    // 'neighbor' appends the tree to the file, every replicate gets its own one
+    QTemporaryFile treeFile;
+    const QString path = seqBoot->getTmpFileTemplate();
+    if (!path.isEmpty()) {
+        treeFile.setFileTemplate(path);
+    }
+    CHECK_EXT(treeFile.open(), ti.setError("Can't create temporary file"), QByteArray());
+    treeFile.close();
+
+    {
+        QMutexLocker runLocker(&runLock);
+        setTaskInfo(&ti);
+        setBootstr(true);
+
+        const int sz = distances.size();
+        MemoryLocker replicateMemLocker(ti);
+        neighbour_init(sz, replicateMemLocker, treeFile.fileName());
+        CHECK_EXT(!replicateMemLocker.hasError(), ti.setError(replicateMemLocker.getError()), QByteArray());
+
+        vector* m = getMtx();
+        for (int i = 0; i < sz; ++i) {
+            for (int j = 0; j < sz; ++j) {
+                m[i][j] = distances[i][j];
+            }
+        }
+        naym* nayme = getNayme();
+        for (int i = 0; i < sz; ++i) {
+            QByteArray name = inputMA.getRow(i).getName().toLatin1();
+            replacePhylipRestrictedSymbols(name);
+            qstrncpy(nayme[i], name.constData(), sizeof(naym));
+            for (int j = name.length(); j < nmlngth; j++) {
+                nayme[i][j] = ' ';
+            }
+        }
+        neighbour_calc_tree();
+        neighbour_free_resources();
+    }
 
-                // Allocate memory resources
-                neighbour_init(sz, memLocker, tmpFile.fileName());
-                if(memLocker.hasError()) {
-                    stateInfo.setError(memLocker.getError());
-                    return;
-                }
+    CHECK_EXT(treeFile.open(), ti.setError("Can't read the tree of a bootstrap replicate"), QByteArray());
+    return treeFile.readAll();
+}
 
-                // Fill data
-                vector* m = getMtx();
-                for (int i = 0; i < sz; ++i) {
-                    for (int j = 0; j < sz; ++j) {
-                        m[i][j] = distanceMatrix->rawMatrix[i][j];
-                    }
-                }
+void NeighborJoinCalculateTreeTask::calculateConsensusTree() {
+    QMutexLocker runLocker(&runLock);
+    setTaskInfo(&stateInfo);
+    setBootstr(true);
 
-                naym* nayme = getNayme();
-                for (int i = 0; i < sz; ++i) {
-                    const MAlignmentRow& row = inputMA.getRow(i);
-                    QByteArray name = row.getName().toLatin1();
-                    replacePhylipRestrictedSymbols(name);
-                    qstrncpy(nayme[i], name.constData(), sizeof(naym));
+    CHECK_EXT(!seqBoot.isNull(), setError("Bootstrap sequences are not generated"), );
+    QTemporaryFile tmpFile;
+    QString path = seqBoot->getTmpFileTemplate();
+    if(!path.isEmpty()){
+        tmpFile.setFileTemplate(path);
+    }
+    if(!tmpFile.open()){
+        setError("Can't create temporary file");
+        return;
+    }
+    seqBoot.reset();
 
-                    for(int j = name.length(); j < nmlngth; j++){
-                        nayme[i][j] = ' ';
-                    }
-                }
+    // the replicate trees are written in the order 'neighbor' would have written them
+    foreach (const QByteArray &tree, replicateTrees) {
+        CHECK_EXT(!tree.isEmpty(), setError("A bootstrap replicate tree is not calculated"), );
+        tmpFile.write(tree);
+    }
+    tmpFile.close();
+
+    progress = 99;
+    stateInfo.setDescription("Calculating consensus tree");
+
+    if(settings.consensusID == ConsensusModelTypes::Strict){
+        consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, true, false, false, false);
+    }else if(settings.consensusID == ConsensusModelTypes::MajorityRuleExt){
+        consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, true, false, false);
+    }else if(settings.consensusID == ConsensusModelTypes::MajorityRule){
+        consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, false, true, false);
+    }else if(settings.consensusID == ConsensusModelTypes::M1){
+        consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, false, false, true);
+    }else{
+        assert(0);
+    }
 
-                // Calculate tree
-                const tree* curTree = neighbour_calc_tree(); 
+    PhyNode* rootPhy = new PhyNode();
+    bool njoin = true;
 
-                neighbour_free_resources();
-            }
-            progress = 99;
-            stateInfo.setDescription("Calculating consensus tree");
-
-            if(settings.consensusID == ConsensusModelTypes::Strict){
-                consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, true, false, false, false);
-            }else if(settings.consensusID == ConsensusModelTypes::MajorityRuleExt){
-                consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, true, false, false);
-            }else if(settings.consensusID == ConsensusModelTypes::MajorityRule){
-                consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, false, true, false);
-            }else if(settings.consensusID == ConsensusModelTypes::M1){
-                consens_starter(tmpFile.fileName().toStdString().c_str(), settings.fraction, false, false, false, true);
-            }else{
-                assert(0);
-            }
+    createPhyTreeFromPhylipTree(inputMA, root, 0.43429448222, njoin, root, rootPhy, settings.replicates);
 
-            PhyNode* rootPhy = new PhyNode();
-            bool njoin = true;
+    consens_free_res();
 
-            createPhyTreeFromPhylipTree(inputMA, root, 0.43429448222, njoin, root, rootPhy, settings.replicates);
+    PhyTreeData* data = new PhyTreeData();
+    data->setRootNode(rootPhy);
 
-            consens_free_res();
+    result = data;
+}
 
-            PhyTreeData* data = new PhyTreeData();
-            data->setRootNode(rootPhy);
+void NeighborJoinCalculateTreeTask::calculateTree() {
+    matrix distances;
+    {
+        QMutexLocker runLocker(&runLock);
 
-            phyTree = data;
-        }else{
+        // Exceptions are used to avoid phylip exit(-1) error handling and canceling task
+        setTaskInfo(&stateInfo);
+        setBootstr(false);
+        CHECK(calculateDistanceMatrix(inputMA, stateInfo, distances), );
+    }
 
-        // Exceptions are used to avoid phylip exit(-1) error handling and canceling task 
-            setTaskInfo(&stateInfo);
-            setBootstr(false);
+    int sz = distances.count();
+    PhyNode* root = NULL;
+    if (sz >= FAST_NJ_MIN_TAXA) {
+        CHECK(memLocker.tryAcquire(FastNeighborJoin::getMemoryUsage(sz)), );
+        FastNeighborJoin neighborJoin(distances);
+        distances.clear();
+        neighborJoin.calculateTree(stateInfo);
+        CHECK_OP(stateInfo, );
+
+        stateInfo.progress = 99;
+        root = neighborJoin.createPhyTree(inputMA);
+    } else {
+        root = calculateNeighborTree(inputMA, distances, memLocker, stateInfo);
+        CHECK_OP(stateInfo, );
+    }
 
-            QScopedPointer<DistanceMatrix> distanceMatrix(new DistanceMatrix);
-            distanceMatrix->calculateOutOfAlignment(inputMA,settings);
+    PhyTreeData* data = new PhyTreeData();
+    data->setRootNode(root);
 
-            if(!distanceMatrix->getErrorMessage().isEmpty()) {
-                stateInfo.setError(distanceMatrix->getErrorMessage());
-                result = phyTree;
-                return;
-            }
-            if (!distanceMatrix->isValid()) {
-                stateInfo.setError("Calculated distance matrix is invalid");
-                result = phyTree;
-                return;
-            }
+    result = data;
+}
 
-            int sz = distanceMatrix->rawMatrix.count();
+PhyNode * NeighborJoinCalculateTreeTask::calculateNeighborTree(const MAlignment &ma, const matrix &distances, MemoryLocker &memLocker, TaskStateInfo &ti) {
+    QMutexLocker runLocker(&runLock);
 
-            // Allocate memory resources
-            neighbour_init(sz, memLocker);
-            if(memLocker.hasError()) {
-                stateInfo.setError(memLocker.getError());
-                return;
-            }
+    // Exceptions are used to avoid phylip exit(-1) error handling and canceling task
+    setTaskInfo(&ti);
+    setBootstr(false);
 
-            // Fill data
-            vector* m = getMtx();
-            for (int i = 0; i < sz; ++i) {
-                for (int j = 0; j < sz; ++j) {
-                    m[i][j] = distanceMatrix->rawMatrix[i][j];
-                }
-            }
+    // Allocate memory resources
+    int sz = distances.count();
+    neighbour_init(sz, memLocker);
+    if(memLocker.hasError()) {
+        ti.setError(memLocker.getError());
+        return NULL;
+    }
 
-            naym* nayme = getNayme();
-            for (int i = 0; i < sz; ++i) {
-                const MAlignmentRow& row = inputMA.getRow(i);
-                QByteArray name = row.getName().toLatin1();
-                replacePhylipRestrictedSymbols(name);
-                qstrncpy(nayme[i], name.constData(), sizeof(naym));
-            }
+    // Fill data
+    vector* m = getMtx();
+    for (int i = 0; i < sz; ++i) {
+        for (int j = 0; j < sz; ++j) {
+            m[i][j] = distances[i][j];
+        }
+    }
 
-            // Calculate tree
-            const tree* curTree = neighbour_calc_tree();
+    naym* nayme = getNayme();
+    for (int i = 0; i < sz; ++i) {
+        const MAlignmentRow& row = ma.getRow(i);
+        QByteArray name = row.getName().toLatin1();
+        replacePhylipRestrictedSymbols(name);
+        qstrncpy(nayme[i], name.constData(), sizeof(naym));
+    }
 
+    // Calculate tree
+    const tree* curTree = neighbour_calc_tree();
 
-            PhyNode* root = new PhyNode();
-            bool njoin = true;
+    PhyNode* root = new PhyNode();
+    bool njoin = true;
 
-            stateInfo.progress = 99;
-            createPhyTreeFromPhylipTree(inputMA, curTree->start, 0.43429448222, njoin, curTree->start, root, 0);
+    ti.progress = 99;
+    createPhyTreeFromPhylipTree(ma, curTree->start, 0.43429448222, njoin, curTree->start, root, 0);
 
-            neighbour_free_resources();
+    neighbour_free_resources();
+    return root;
+}
 
-            PhyTreeData* data = new PhyTreeData();
-            data->setRootNode(root);
+NeighborJoinSeqBootTask::NeighborJoinSeqBootTask(NeighborJoinCalculateTreeTask *parentTask)
+    : Task(tr("NeighborJoin bootstrap sequences"), TaskFlag_None), parentTask(parentTask)
+{
+    tpm = Progress_Manual;
+}
 
-            phyTree = data;
-        }
-    }
-    catch (const std::bad_alloc &) {
-        setError(QString("Not enough memory to calculate tree for alignment \"%1\"").arg(inputMA.getName()));
-    }
-    catch (const char* message) {
-        stateInfo.setError(QString("Phylip error %1").arg(message));
-    }
+void NeighborJoinSeqBootTask::run() {
+    parentTask->generateSequences(stateInfo);
+}
+
+NeighborJoinReplicateTask::NeighborJoinReplicateTask(NeighborJoinCalculateTreeTask *parentTask, int replicate)
+    : Task(tr("NeighborJoin bootstrap replicate %1").arg(replicate + 1), TaskFlag_None), parentTask(parentTask), replicate(replicate)
+{
+    tpm = Progress_Manual;
+}
 
-    result = phyTree;
+void NeighborJoinReplicateTask::run() {
+    parentTask->calculateReplicateTree(replicate, stateInfo);
 }
 
-} 
+}
@@ -31,13 +31,17 @@
 #include <U2Core/AppResources.h>
 //#include <U2Core/PhyTree.h>
 
+#include "DistanceMatrix.h"
+
 //#include <U2View/CreatePhyTreeDialogController.h>
 
 namespace U2 { 
 
 class MAlignment;
+class PhyNode;
 class TaskStateInfo;
 class PhyTreeGeneratorTask;
+class SeqBoot;
 
 class NeighborJoinAdapter : public PhyTreeGenerator {
 public:
@@ -48,11 +52,54 @@ public:
 class NeighborJoinCalculateTreeTask: public PhyTreeGeneratorTask {
 public:
     NeighborJoinCalculateTreeTask(const MAlignment &ma, const CreatePhyTreeSettings &s);
+    ~NeighborJoinCalculateTreeTask();
+    void prepare();
     void run();
+    QList<Task*> onSubTaskFinished(Task *subTask);
+
+    /** Called by the seqboot subtask: generates the bootstrap alignments */
+    void generateSequences(TaskStateInfo &ti);
+    /** Called by the replicate subtasks concurrently: bootstrap replicate trees are built in parallel */
+    void calculateReplicateTree(int replicate, TaskStateInfo &ti);
+
+    /** Builds the tree of @distances by PHYLIP 'neighbor', the names are taken from the rows of @ma */
+    static PhyNode * calculateNeighborTree(const MAlignment &ma, const matrix &distances, MemoryLocker &memLocker, TaskStateInfo &ti);
 
 private:
+    void calculateConsensusTree();
+    void calculateTree();
+    bool calculateDistanceMatrix(const MAlignment &ma, TaskStateInfo &ti, matrix &distances);
+    QByteArray calculateNeighborNewickTree(const matrix &distances, TaskStateInfo &ti);
+
+    /* PHYLIP keeps its state in globals, every call of it must be done under this lock */
     static QMutex runLock;
     MemoryLocker memLocker;
+    QScopedPointer<SeqBoot> seqBoot;
+    Task *seqBootTask;
+    QList<QByteArray> phylipNames;
+    QVector<QByteArray> replicateTrees;
+    QAtomicInt replicatesDone;
+};
+
+class NeighborJoinSeqBootTask : public Task {
+    Q_OBJECT
+public:
+    NeighborJoinSeqBootTask(NeighborJoinCalculateTreeTask *parentTask);
+    void run();
+
+private:
+    NeighborJoinCalculateTreeTask *parentTask;
+};
+
+class NeighborJoinReplicateTask : public Task {
+    Q_OBJECT
+public:
+    NeighborJoinReplicateTask(NeighborJoinCalculateTreeTask *parentTask, int replicate);
+    void run();
+
+private:
+    NeighborJoinCalculateTreeTask *parentTask;
+    int replicate;
 };
 
 }   // namespace U2
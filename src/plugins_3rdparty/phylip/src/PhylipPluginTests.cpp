@@ -37,7 +37,13 @@
 
 #include <QtCore/QDir>
 #include <U2Core/AppContext.h>
+#include <U2Core/AppResources.h>
+#include <U2Core/DNAAlphabet.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
 #include "DistanceMatrix.h"
+#include "FastNeighborJoin.h"
+#include "NeighborJoinAdapter.h"
 #include <U2Algorithm/CreatePhyTreeSettings.h>
 #include <U2Algorithm/PhyTreeGeneratorRegistry.h>
 
@@ -46,6 +52,7 @@ namespace U2{
 QList<XMLTestFactory*> PhylipPluginTests::createTestFactories(){
 	QList<XMLTestFactory* > res;
 	res.append(GTest_NeighborJoin::createFactory());
+	res.append(GTest_FastNeighborJoin::createFactory());
     return res;
 }
 
@@ -154,4 +161,117 @@ void GTest_NeighborJoin::cleanup() {
 	
 }
 
+namespace {
+
+/* Collects the leaves under @node and the splits of the branches below it: the sorted leaves of the side without the first taxon -> branch length */
+QStringList collectSplits(const PhyNode *node, const PhyNode *from, const QStringList &taxa, QMap<QString, double> &splits) {
+    QStringList leaves;
+    if (taxa.contains(node->getName())) {
+        leaves << node->getName();
+    }
+    for (int i = 0; i < node->branchCount(); i++) {
+        const PhyBranch *branch = node->getBranch(i);
+        const PhyNode *next = branch->node1 == node ? branch->node2 : branch->node1;
+        if (next == from) {
+            continue;
+        }
+        const QStringList nextLeaves = collectSplits(next, node, taxa, splits);
+        QStringList side = nextLeaves;
+        if (side.contains(taxa.first())) {
+            side = taxa;
+            foreach (const QString &leaf, nextLeaves) {
+                side.removeOne(leaf);
+            }
+        }
+        side.sort();
+        splits[side.join(",")] += branch->distance;
+        leaves << nextLeaves;
+    }
+    return leaves;
+}
+
+}
+
+void GTest_FastNeighborJoin::init(XMLTestFormat *, const QDomElement& el) {
+    bool ok = true;
+    taxaCount = el.attribute("taxa", "40").toInt(&ok);
+    if (!ok || taxaCount < 3) {
+        stateInfo.setError(QString("Invalid value of taxa: %1").arg(el.attribute("taxa")));
+        return;
+    }
+}
+
+void GTest_FastNeighborJoin::run() {
+    // an additive matrix of a random tree: the clusters are joined in random pairs with random branch lengths
+    matrix distances(taxaCount, matrixrow(taxaCount, 0));
+    QVector<double> height(taxaCount, 0);
+    QList< QList<int> > clusters;
+    QStringList taxa;
+    for (int i = 0; i < taxaCount; i++) {
+        clusters << (QList<int>() << i);
+        taxa << QString("taxon_%1").arg(i);
+    }
+    quint32 seed = 42;
+    while (clusters.size() > 1) {
+        seed = seed * 1103515245 + 12345;
+        const QList<int> a = clusters.takeAt((seed >> 16) % clusters.size());
+        seed = seed * 1103515245 + 12345;
+        const QList<int> b = clusters.takeAt((seed >> 16) % clusters.size());
+        seed = seed * 1103515245 + 12345;
+        const double lengthA = 0.05 + ((seed >> 16) % 1000) / 1000.0;
+        seed = seed * 1103515245 + 12345;
+        const double lengthB = 0.05 + ((seed >> 16) % 1000) / 1000.0;
+        foreach (int x, a) {
+            height[x] += lengthA;
+        }
+        foreach (int y, b) {
+            height[y] += lengthB;
+        }
+        foreach (int x, a) {
+            foreach (int y, b) {
+                distances[x][y] = distances[y][x] = height[x] + height[y];
+            }
+        }
+        clusters << (a + b);
+    }
+
+    MAlignment ma("fast_neighbor_join", AppContext::getDNAAlphabetRegistry()->findById(BaseDNAAlphabetIds::NUCL_DNA_DEFAULT()));
+    for (int i = 0; i < taxaCount; i++) {
+        U2OpStatusImpl os;
+        ma.addRow(taxa[i], "A", os);
+        CHECK_OP_EXT(os, stateInfo.setError(os.getError()), );
+    }
+
+    PhyTree classicTree;
+    try {
+        MemoryLocker memLocker(stateInfo);
+        PhyNode *root = NeighborJoinCalculateTreeTask::calculateNeighborTree(ma, distances, memLocker, stateInfo);
+        CHECK_OP(stateInfo, );
+        PhyTreeData *data = new PhyTreeData();
+        data->setRootNode(root);
+        classicTree = data;
+    }
+    catch (const char *message) {
+        stateInfo.setError(QString("Phylip error %1").arg(message));
+        return;
+    }
+
+    FastNeighborJoin neighborJoin(distances);
+    neighborJoin.calculateTree(stateInfo);
+    CHECK_OP(stateInfo, );
+    PhyTreeData *data = new PhyTreeData();
+    data->setRootNode(neighborJoin.createPhyTree(ma));
+    PhyTree fastTree(data);
+
+    QMap<QString, double> classicSplits;
+    QMap<QString, double> fastSplits;
+    collectSplits(classicTree->getRootNode(), NULL, taxa, classicSplits);
+    collectSplits(fastTree->getRootNode(), NULL, taxa, fastSplits);
+    CHECK_EXT(classicSplits.keys() == fastSplits.keys(), stateInfo.setError("FastNeighborJoin tree topology differs from the 'neighbor' one"), );
+    foreach (const QString &split, classicSplits.keys()) {
+        CHECK_EXT(qAbs(classicSplits[split] - fastSplits[split]) < 1e-3,
+            stateInfo.setError(QString("Branch length of split {%1} differs: %2, 'neighbor' gives %3").arg(split).arg(fastSplits[split]).arg(classicSplits[split])), );
+    }
+}
+
 }
@@ -54,6 +54,20 @@ private:
     PhyTreeObject* treeObjFromDoc;
 };
 
+/**
+ * Builds the tree of a fixed additive distance matrix by FastNeighborJoin and by PHYLIP 'neighbor',
+ * the trees must have the same splits with the same branch lengths
+ */
+class GTest_FastNeighborJoin : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY_EXT(GTest_FastNeighborJoin, "test-fast-neighbor-join", TaskFlags_FOSCOE);
+
+    void run();
+
+private:
+    int taxaCount;
+};
 
 class  PhylipPluginTests {
 public:
@@ -21,7 +21,11 @@
 
 #include "AssemblySamtoolsMpileup.h"
 
+#include <QtCore/QMutexLocker>
+#include <QtCore/QtEndian>
+
 #include <U2Core/Timer.h>
+#include <U2Core/AppResources.h>
 #include <U2Core/Counter.h>
 #include <U2Core/GUrlUtils.h>
 #include <U2Core/AppContext.h>
@@ -34,6 +38,7 @@
 #include <U2Core/IOAdapterUtils.h>
 #include <U2Core/DocumentUtils.h>
 #include <U2Core/LoadDocumentTask.h>
+#include <U2Core/L10n.h>
 
 #include <U2Lang/DbiDataHandler.h>
 #include <U2Lang/BasePorts.h>
@@ -41,22 +46,60 @@
 #include <U2Lang/BaseTypes.h>
 #include <U2Lang/WorkflowEnv.h>
 
+#include <bam.h>
+#include <faidx.h>
+
 #define CALL_VARIANTS_DIR "variants"
+#define SHARDS_PER_THREAD 4
 
 namespace U2 {
 namespace LocalWorkflow{
 
+namespace {
+
+/**
+ * The shard pipelines run at once, their messages are passed to the listener of the whole task one by one.
+ * Every shard has its own listeners because the tool name is set to a listener when a tool is started.
+ */
+class ShardListener : public ExternalToolListener {
+public:
+    ShardListener(ExternalToolListener *listener, QMutex &mutex)
+        : listener(listener), mutex(mutex)
+    {
+
+    }
+
+    void addNewLogMessage(const QString &message, int messageType) {
+        QMutexLocker locker(&mutex);
+        listener->setToolName(getToolName());
+        listener->addNewLogMessage(message, messageType);
+    }
+
+private:
+    ExternalToolListener *listener;
+    QMutex &mutex;
+};
+
+}
+
 CallVariantsTask::CallVariantsTask( const CallVariantsTaskSettings& _settings, DbiDataStorage* _store )
 :ExternalToolSupportTask(tr("Call variants for %1").arg(_settings.refSeqUrl), TaskFlag_NoRun)
 ,settings(_settings)
+,shardingTask(NULL)
 ,loadTask(NULL)
 ,mpileupTask(NULL)
+,finishedShardsCount(0)
+,mergeTask(NULL)
 ,storage(_store)
 {
     GCOUNTER(cvar, tvar, "NGS:CallVariantsTask");
     setMaxParallelSubtasks(1);
 }
 
+CallVariantsTask::~CallVariantsTask() {
+    qDeleteAll(shardListeners);
+}
+
 QString CallVariantsTask::toString(FileType type) {
     switch (type) {
         case Reference:
@@ -96,9 +139,67 @@ void CallVariantsTask::prepare(){
         return;
     }
 
-    mpileupTask = new SamtoolsMpileupTask(settings);
-    mpileupTask->addListeners(getListeners());
-    addSubTask(mpileupTask );
+    const int threadsCount = AppResourcePool::instance()->getIdealThreadCount();
+    if (settings.reg.isEmpty() && threadsCount > 1) {
+        shardingTask = new CallVariantsShardingTask(settings, threadsCount * SHARDS_PER_THREAD);
+        addSubTask(shardingTask);
+        return;
+    }
+
+    foreach (Task *task, createMpileupTasks()) {
+        addSubTask(task);
+    }
+}
+
+QList<Task*> CallVariantsTask::createMpileupTasks() {
+    QList<Task*> res;
+    if (NULL == shardingTask || shardingTask->getRegions().size() < 2) {
+        mpileupTask = new SamtoolsMpileupTask(settings);
+        mpileupTask->addListeners(getListeners());
+        res << mpileupTask;
+        return res;
+    }
+
+    foreach (const QByteArray &region, shardingTask->getRegions()) {
+        CallVariantsTaskSettings shardSettings = settings;
+        shardSettings.reg = region;
+        shardSettings.variationsUrl = tmpFilePath("shard", "vcf", stateInfo);
+        CHECK_OP_EXT(stateInfo, qDeleteAll(shardTasks); shardTasks.clear(), QList<Task*>());
+        shardUrls << shardSettings.variationsUrl;
+
+        SamtoolsMpileupTask *shardTask = new SamtoolsMpileupTask(shardSettings);
+        shardTask->addListeners(createShardListeners());
+        shardTasks << shardTask;
+    }
+    algoLog.details(tr("Variants are called in %1 regions").arg(shardTasks.size()));
+    setMaxParallelSubtasks(AppResourcePool::instance()->getIdealThreadCount());
+    return shardTasks;
+}
+
+QList<ExternalToolListener*> CallVariantsTask::createShardListeners() {
+    QList<ExternalToolListener*> result;
+    foreach (ExternalToolListener *listener, getListeners()) {
+        result << new ShardListener(listener, shardListenersMutex);
+    }
+    shardListeners << result;
+    return result;
+}
+
+Task * CallVariantsTask::createLoadTask() {
+    const GUrl url(settings.variationsUrl);
+    IOAdapterFactory * iof = AppContext::getIOAdapterRegistry()->getIOAdapterFactoryById( IOAdapterUtils::url2io( url ) );
+    if ( iof == NULL ) {
+        return NULL;
+    }
+    QList<FormatDetectionResult> dfs = DocumentUtils::detectFormat(url);
+    if( dfs.isEmpty() ) {
+        return NULL;
+    }
+    DocumentFormat * df = dfs.first().format;
+    QVariantMap cfg;
+    cfg.insert(DocumentFormat::DBI_REF_HINT, qVariantFromValue(storage->getDbiRef()));
+    loadTask =  new LoadDocumentTask( df->getFormatId(), url, iof, cfg );
+    return loadTask;
 }
 
 QList<Task*> CallVariantsTask::onSubTaskFinished( Task* subTask ){
@@ -112,22 +213,19 @@ QList<Task*> CallVariantsTask::onSubTaskFinished( Task* subTask ){
         return res;
     }
 
-    if (subTask == mpileupTask) {
-        const GUrl url(settings.variationsUrl);
-        IOAdapterFactory * iof = AppContext::getIOAdapterRegistry()->getIOAdapterFactoryById( IOAdapterUtils::url2io( url ) );
-        if ( iof == NULL ) {
-            return res;
+    if (subTask == shardingTask) {
+        res << createMpileupTasks();
+    } else if (shardTasks.contains(subTask)) {
+        finishedShardsCount++;
+        if (finishedShardsCount == shardTasks.size()) {
+            mergeTask = new MergeVcfShardsTask(shardUrls, settings.variationsUrl);
+            res << mergeTask;
         }
-        QList<FormatDetectionResult> dfs = DocumentUtils::detectFormat(url);
-        if( dfs.isEmpty() ) {
-            return res;
+    } else if (subTask == mpileupTask || subTask == mergeTask) {
+        Task *task = createLoadTask();
+        if (NULL != task) {
+            res << task;
         }
-        DocumentFormat * df = dfs.first().format;
-        QVariantMap cfg;
-        cfg.insert(DocumentFormat::DBI_REF_HINT, qVariantFromValue(storage->getDbiRef()));
-        loadTask =  new LoadDocumentTask( df->getFormatId(), url, iof, cfg );
-        res.append(loadTask);
-
     } else if(subTask == loadTask){
         QScopedPointer<Document> doc (loadTask->takeDocument(false));
         SAFE_POINT(doc!=NULL, tr("No document loaded"), res);
@@ -147,11 +245,287 @@ QList<Task*> CallVariantsTask::onSubTaskFinished( Task* subTask ){
     return res;
 }
 
+Task::ReportResult CallVariantsTask::report() {
+    if (hasError() || isCanceled()) {
+        // the merge task removes the shards only if it succeeds
+        foreach (const QString &url, shardUrls) {
+            QFile::remove(url);
+        }
+    }
+    return ReportResult_Finished;
+}
+
 QString CallVariantsTask::tmpFilePath(const QString &baseName, const QString &ext, U2OpStatus &os) {
     QString tmpDirPath = AppContext::getAppSettings()->getUserAppsSettings()->getCurrentProcessTemporaryDirPath(CALL_VARIANTS_DIR);
     return GUrlUtils::prepareTmpFileLocation(tmpDirPath, baseName, ext, os);
 }
 
+/************************************************************************/
+/* CallVariantsShardingTask */
+/************************************************************************/
+namespace {
+
+// the size of a window of the BAM linear index
+const int LINEAR_INDEX_WINDOW = 1 << 14;
+// the number of the BAM index pseudo-bin which contains the reference statistics
+const quint32 META_BIN = 37450;
+// the weight of a reference window without reads, bytes of the compressed data
+const qint64 EMPTY_WINDOW_WEIGHT = 256;
+
+class BaiReader {
+public:
+    BaiReader(const QByteArray &data) : data(data), pos(0) {}
+
+    bool canRead(qint64 size) const {
+        return size >= 0 && pos + size <= data.size();
+    }
+
+    qint32 readInt32() {
+        const qint32 result = qFromLittleEndian<qint32>((const uchar *)data.constData() + pos);
+        pos += sizeof(qint32);
+        return result;
+    }
+
+    quint64 readUInt64() {
+        const quint64 result = qFromLittleEndian<quint64>((const uchar *)data.constData() + pos);
+        pos += sizeof(quint64);
+        return result;
+    }
+
+    void skip(qint64 size) {
+        pos += size;
+    }
+
+private:
+    const QByteArray &data;
+    qint64 pos;
+};
+
+QString findBamIndex(const QString &bamUrl) {
+    if (QFile::exists(bamUrl + ".bai")) {
+        return bamUrl + ".bai";
+    }
+    const QFileInfo info(bamUrl);
+    const QString url = info.dir().filePath(info.completeBaseName() + ".bai");
+    if (QFile::exists(url)) {
+        return url;
+    }
+    return "";
+}
+
+QByteArray regionString(const QByteArray &name, qint64 start, qint64 end) {
+    return name + ":" + QByteArray::number(start + 1) + "-" + QByteArray::number(end);
+}
+
+}
+
+const int CallVariantsShardingTask::MAX_SHARDS_COUNT = 1024;
+
+CallVariantsShardingTask::CallVariantsShardingTask(const CallVariantsTaskSettings &settings, int shardsCount)
+: Task(tr("Split the reference into regions"), TaskFlag_None), settings(settings), shardsCount(shardsCount)
+{
+
+}
+
+void CallVariantsShardingTask::run() {
+    CHECK(prepareReferenceIndex(), );
+    foreach (const QString &url, settings.assemblyUrls) {
+        CHECK(estimateRegionWeights(url), );
+        CHECK(!isCanceled(), );
+    }
+    splitToRegions();
+}
+
+const QList<QByteArray> & CallVariantsShardingTask::getRegions() const {
+    return regions;
+}
+
+bool CallVariantsShardingTask::prepareReferenceIndex() {
+    // samtools builds the missing index itself but the concurrent runs must not do it at the same time
+    if (QFile::exists(settings.refSeqUrl + ".fai")) {
+        return true;
+    }
+    if (0 != fai_build(settings.refSeqUrl.toLocal8Bit().constData())) {
+        taskLog.details(tr("Can not index the reference sequence, variants are called for the whole assembly: %1").arg(settings.refSeqUrl));
+        return false;
+    }
+    return true;
+}
+
+bool CallVariantsShardingTask::estimateRegionWeights(const QString &assemblyUrl) {
+    const QString indexUrl = findBamIndex(assemblyUrl);
+    if (indexUrl.isEmpty()) {
+        taskLog.details(tr("There is no BAM index, variants are called for the whole assembly: %1").arg(assemblyUrl));
+        contigs.clear();
+        return false;
+    }
+
+    bamFile bamHandle = bam_open(assemblyUrl.toLocal8Bit().constData(), "r");
+    CHECK(NULL != bamHandle, false);
+    bam_header_t *header = bam_header_read(bamHandle);
+    bam_close(bamHandle);
+    CHECK(NULL != header, false);
+
+    bool headersMatch = true;
+    if (contigs.isEmpty()) {
+        for (int i = 0; i < header->n_targets; i++) {
+            Contig contig;
+            contig.name = header->target_name[i];
+            contig.length = header->target_len[i];
+            contig.windowWeights.fill(EMPTY_WINDOW_WEIGHT, (contig.length + LINEAR_INDEX_WINDOW - 1) / LINEAR_INDEX_WINDOW);
+            // samtools can not parse a region if the name contains a colon
+            headersMatch = headersMatch && !contig.name.contains(':');
+            contigs << contig;
+        }
+    } else {
+        headersMatch = (header->n_targets == contigs.size());
+        for (int i = 0; headersMatch && i < header->n_targets; i++) {
+            headersMatch = (contigs[i].name == header->target_name[i]);
+        }
+    }
+    bam_header_destroy(header);
+    if (!headersMatch) {
+        taskLog.details(tr("The assemblies have different references, variants are called for the whole assemblies"));
+        contigs.clear();
+        return false;
+    }
+
+    QFile indexFile(indexUrl);
+    CHECK_EXT(indexFile.open(QIODevice::ReadOnly), contigs.clear(), false);
+    const QByteArray data = indexFile.readAll();
+    indexFile.close();
+
+    BaiReader reader(data);
+    CHECK_EXT(reader.canRead(8) && data.startsWith(QByteArray("BAI\1", 4)), contigs.clear(), false);
+    reader.skip(4);
+    CHECK_EXT(reader.readInt32() == contigs.size(), contigs.clear(), false);
+
+    for (int i = 0; i < contigs.size(); i++) {
+        quint64 refEnd = 0;
+        CHECK_EXT(reader.canRead(4), contigs.clear(), false);
+        const qint32 binsCount = reader.readInt32();
+        for (qint32 b = 0; b < binsCount; b++) {
+            CHECK_EXT(reader.canRead(8), contigs.clear(), false);
+            const quint32 bin = reader.readInt32();
+            const qint32 chunksCount = reader.readInt32();
+            CHECK_EXT(reader.canRead(16 * qint64(chunksCount)), contigs.clear(), false);
+            if (META_BIN == bin && 2 == chunksCount) {
+                reader.skip(8);
+                refEnd = reader.readUInt64();
+                reader.skip(16);
+            } else {
+                reader.skip(16 * qint64(chunksCount));
+            }
+        }
+
+        CHECK_EXT(reader.canRead(4), contigs.clear(), false);
+        const qint32 windowsCount = reader.readInt32();
+        CHECK_EXT(reader.canRead(8 * qint64(windowsCount)), contigs.clear(), false);
+        QVector<quint64> offsets(windowsCount + 1);
+        for (qint32 w = 0; w < windowsCount; w++) {
+            offsets[w] = reader.readUInt64() >> 16;
+        }
+        offsets[windowsCount] = (refEnd >> 16) > 0 ? (refEnd >> 16) : (windowsCount > 0 ? offsets[windowsCount - 1] : 0);
+
+        // the compressed data size between the linear index offsets is the coverage estimation
+        Contig &contig = contigs[i];
+        for (qint32 w = 0; w < windowsCount && w < contig.windowWeights.size(); w++) {
+            if (0 != offsets[w] && offsets[w + 1] > offsets[w]) {
+                contig.windowWeights[w] += offsets[w + 1] - offsets[w];
+            }
+        }
+    }
+    return true;
+}
+
+void CallVariantsShardingTask::splitToRegions() {
+    CHECK(!contigs.isEmpty(), );
+    qint64 totalWeight = 0;
+    for (int i = 0; i < contigs.size(); i++) {
+        contigs[i].weight = 0;
+        foreach (qint64 weight, contigs[i].windowWeights) {
+            contigs[i].weight += weight;
+        }
+        totalWeight += contigs[i].weight;
+    }
+    const qint64 shardWeight = qMax(qint64(1), totalWeight / shardsCount);
+
+    foreach (const Contig &contig, contigs) {
+        if (contig.weight <= shardWeight + shardWeight / 2) {
+            regions << contig.name;
+            continue;
+        }
+
+        qint64 start = 0;
+        qint64 weight = 0;
+        QList<qint64> ends;
+        for (int w = 0; w < contig.windowWeights.size(); w++) {
+            weight += contig.windowWeights[w];
+            if (weight >= shardWeight) {
+                ends << qMin(contig.length, qint64(w + 1) * LINEAR_INDEX_WINDOW);
+                weight = 0;
+            }
+        }
+        // a small tail is joined with the previous region
+        if (ends.isEmpty() || weight >= shardWeight / 2) {
+            ends << contig.length;
+        } else {
+            ends.last() = contig.length;
+        }
+        foreach (qint64 end, ends) {
+            if (end > start) {
+                regions << regionString(contig.name, start, end);
+            }
+            start = end;
+        }
+    }
+
+    if (regions.size() > MAX_SHARDS_COUNT) {
+        taskLog.details(tr("The reference consists of too many sequences, variants are called for the whole assembly"));
+        regions.clear();
+    }
+}
+
+/************************************************************************/
+/* MergeVcfShardsTask */
+/************************************************************************/
+MergeVcfShardsTask::MergeVcfShardsTask(const QStringList &shardUrls, const QString &resultUrl)
+: Task(tr("Merge variants of regions"), TaskFlag_None), shardUrls(shardUrls), resultUrl(resultUrl)
+{
+
+}
+
+void MergeVcfShardsTask::run() {
+    static const qint64 BUFFER_SIZE = 1024 * 1024;
+
+    QFile result(resultUrl);
+    CHECK_EXT(result.open(QIODevice::WriteOnly), setError(L10N::errorOpeningFileWrite(resultUrl)), );
+
+    for (int i = 0; i < shardUrls.size(); i++) {
+        QFile shard(shardUrls[i]);
+        CHECK_EXT(shard.open(QIODevice::ReadOnly), setError(L10N::errorOpeningFileRead(shardUrls[i])), );
+
+        QByteArray data;
+        // the header is written only once
+        while (!shard.atEnd()) {
+            data = shard.readLine();
+            if (0 == i || !data.startsWith('#')) {
+                break;
+            }
+            data.clear();
+        }
+        while (!data.isEmpty()) {
+            CHECK_EXT(result.write(data) == data.size(), setError(L10N::errorWritingFile(resultUrl)), );
+            data = shard.read(BUFFER_SIZE);
+        }
+        shard.close();
+        QFile::remove(shardUrls[i]);
+
+        CHECK(!isCanceled(), );
+        stateInfo.progress = 100 * (i + 1) / shardUrls.size();
+    }
+}
+
 /************************************************************************/
 /* SamtoolsMpileupTask */
 /************************************************************************/
@@ -26,6 +26,9 @@
 #include <U2Core/ExternalToolRunTask.h>
 #include <U2Core/Task.h>
 
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+
 #include <U2Lang/LocalDomain.h>
 
 namespace U2 {
@@ -113,13 +116,69 @@ private:
     CallVariantsTaskSettings settings;
 };
 
+/**
+ * Splits the reference into regions of a similar calling cost.
+ * The cost of a region is estimated by the reference length and by the amount
+ * of the compressed alignment data which is referenced by the BAM index.
+ * The result is empty if the assemblies can not be processed by regions.
+ */
+class CallVariantsShardingTask : public Task {
+    Q_OBJECT
+public:
+    CallVariantsShardingTask(const CallVariantsTaskSettings &settings, int shardsCount);
+
+    void run();
+
+    const QList<QByteArray> & getRegions() const;
+
+private:
+    bool prepareReferenceIndex();
+    bool estimateRegionWeights(const QString &assemblyUrl);
+    void splitToRegions();
+
+private:
+    class Contig {
+    public:
+        Contig() : length(0), weight(0) {}
+        QByteArray name;
+        qint64 length;
+        qint64 weight;
+        QVector<qint64> windowWeights;
+    };
+
+    const CallVariantsTaskSettings settings;
+    const int shardsCount;
+    QList<Contig> contigs;
+    QList<QByteArray> regions;
+
+    static const int MAX_SHARDS_COUNT;
+};
+
+/**
+ * Concatenates the shard VCF files in the given order.
+ * The header is taken from the first file.
+ */
+class MergeVcfShardsTask : public Task {
+    Q_OBJECT
+public:
+    MergeVcfShardsTask(const QStringList &shardUrls, const QString &resultUrl);
+
+    void run();
+
+private:
+    const QStringList shardUrls;
+    const QString resultUrl;
+};
+
 class CallVariantsTask : public ExternalToolSupportTask {
     Q_OBJECT
 public:
     CallVariantsTask(const CallVariantsTaskSettings& _settings, DbiDataStorage* _store);
+    ~CallVariantsTask();
 
     void prepare();
     QList<Task*> onSubTaskFinished(Task* subTask);
+    ReportResult report();
 
     const QList<QVariantMap>& getResults(){return results;}
     QString getResultUrl(){return settings.variationsUrl;}
@@ -131,11 +190,21 @@ private:
     enum FileType {Reference, Assembly};
     static QString toString(FileType type);
     bool ensureFileExists(const QString &url, FileType type);
+    QList<Task*> createMpileupTasks();
+    QList<ExternalToolListener*> createShardListeners();
+    Task * createLoadTask();
 
 private:
     CallVariantsTaskSettings    settings;
+    CallVariantsShardingTask*   shardingTask;
     LoadDocumentTask*       loadTask;
     SamtoolsMpileupTask*    mpileupTask;
+    QList<Task*>            shardTasks;
+    QStringList             shardUrls;
+    QList<ExternalToolListener*> shardListeners;
+    QMutex                  shardListenersMutex;
+    int                     finishedShardsCount;
+    MergeVcfShardsTask*     mergeTask;
     DbiDataStorage*         storage;
     QList<QVariantMap>      results;
 };
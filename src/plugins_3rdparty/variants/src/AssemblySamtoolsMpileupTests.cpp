@@ -0,0 +1,334 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <U2Core/GUrlUtils.h>
+#include <U2Core/L10n.h>
+#include <U2Core/U2OpStatusUtils.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <bam.h>
+
+#include "AssemblySamtoolsMpileup.h"
+#include "AssemblySamtoolsMpileupTests.h"
+
+namespace U2 {
+
+namespace {
+
+const QByteArray VCF_HEADER = "##fileformat=VCFv4.1\n"
+                              "##source=test\n"
+                              "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+
+/* The regions are numbered in the reference order, every region has a different number of variants, some regions have no variants */
+QByteArray getShardVariants(int shard) {
+    QByteArray result;
+    for (int i = 0; i < shard % 4; i++) {
+        result += "chr" + QByteArray::number(shard / 2) + "\t" + QByteArray::number((shard % 2) * 1000 + i + 1) + "\t.\tA\tC\t30\t.\tDP=10\n";
+    }
+    return result;
+}
+
+const QString SAMPLE_ASSEMBLY = "chrM.sorted.bam";
+const QString SAMPLE_REFERENCE = "chrM.fa";
+
+/* Copies the chrM sample assembly and its reference to the directory, so the indexes are built next to the copies */
+LocalWorkflow::CallVariantsTaskSettings prepareSample(const QString &dir, bool index, U2OpStatus &os) {
+    LocalWorkflow::CallVariantsTaskSettings settings;
+    const QString samplesDir = QDir::searchPaths(PATH_PREFIX_DATA).first() + "/samples/Assembly/";
+    CHECK_EXT(QDir().mkpath(dir), os.setError(L10N::errorWritingFile(dir)), settings);
+    foreach (const QString &fileName, QStringList() << SAMPLE_ASSEMBLY << SAMPLE_REFERENCE) {
+        QFile::remove(dir + "/" + fileName);
+        CHECK_EXT(QFile::copy(samplesDir + fileName, dir + "/" + fileName), os.setError(L10N::errorOpeningFileRead(samplesDir + fileName)), settings);
+    }
+    settings.assemblyUrls << dir + "/" + SAMPLE_ASSEMBLY;
+    settings.refSeqUrl = dir + "/" + SAMPLE_REFERENCE;
+    if (index) {
+        CHECK_EXT(0 == bam_index_build(settings.assemblyUrls.first().toLocal8Bit().constData()),
+                  os.setError(QString("Can not build the BAM index: %1").arg(settings.assemblyUrls.first())), settings);
+    }
+
+    // the defaults of the "Call Variants" workflow element
+    settings.illumina13 = false;
+    settings.use_orphan = false;
+    settings.disable_baq = false;
+    settings.capq_thres = 0;
+    settings.max_depth = 250;
+    settings.ext_baq = false;
+    settings.min_mq = 0;
+    settings.min_baseq = 13;
+    settings.extq = 20;
+    settings.tandemq = 100;
+    settings.no_indel = false;
+    settings.max_indel_depth = 250;
+    settings.openq = 40;
+    settings.keepalt = false;
+    settings.fix_pl = false;
+    settings.no_geno = false;
+    settings.acgt_only = false;
+    settings.qcall = false;
+    settings.min_smpl_frac = 0;
+    settings.call_gt = true;
+    settings.indel_frac = -1.0;
+    settings.pref = 0.5;
+    settings.ptype = "full";
+    settings.theta = 0.001f;
+    settings.n1 = 0;
+    settings.n_perm = 0;
+    settings.min_perm_p = 0.01f;
+    settings.minQual = 10;
+    settings.minDep = 2;
+    settings.maxDep = 10000000;
+    settings.minAlt = 2;
+    settings.gapSize = 3;
+    settings.window = 10;
+    settings.pvalue1 = 0.0001f;
+    settings.pvalue2 = 1e-100;
+    settings.pvalue3 = 0;
+    settings.pvalue4 = 0.0001f;
+    settings.pvalueHwe = 0.0001f;
+    settings.printFiltered = false;
+    return settings;
+}
+
+QList<QByteArray> readVcfRecords(const QString &url, U2OpStatus &os) {
+    QList<QByteArray> records;
+    QFile file(url);
+    CHECK_EXT(file.open(QIODevice::ReadOnly), os.setError(L10N::errorOpeningFileRead(url)), records);
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (!line.startsWith('#')) {
+            records << line;
+        }
+    }
+    return records;
+}
+
+QString regionsText(const QList<QByteArray> &regions) {
+    QStringList result;
+    foreach (const QByteArray &region, regions) {
+        result << region;
+    }
+    return result.join(", ");
+}
+
+void removeTestDir(const QString &dir) {
+    CHECK(!dir.isEmpty(), );
+    U2OpStatus2Log os;
+    GUrlUtils::removeDir(dir, os);
+}
+
+}
+
+const QString GTest_MergeVcfShards::SHARDS_COUNT_ATTR = "shards";
+
+void GTest_MergeVcfShards::init(XMLTestFormat *, const QDomElement &el) {
+    mergeTask = NULL;
+    bool ok = false;
+    shardsCount = el.attribute(SHARDS_COUNT_ATTR).toInt(&ok);
+    CHECK_EXT(ok && shardsCount > 0, failMissingValue(SHARDS_COUNT_ATTR), );
+}
+
+void GTest_MergeVcfShards::prepare() {
+    const QString dir = env->getVar("TEMP_DATA_DIR");
+    resultUrl = dir + "/merge_vcf_shards.vcf";
+    expectedResult = VCF_HEADER;
+    for (int i = 0; i < shardsCount; i++) {
+        const QByteArray variants = getShardVariants(i);
+        expectedResult += variants;
+
+        shardUrls << dir + QString("/merge_vcf_shards_%1.vcf").arg(i);
+        QFile shard(shardUrls.last());
+        CHECK_EXT(shard.open(QIODevice::WriteOnly), setError(L10N::errorOpeningFileWrite(shardUrls.last())), );
+        CHECK_EXT(shard.write(VCF_HEADER + variants) == VCF_HEADER.size() + variants.size(), setError(L10N::errorWritingFile(shardUrls.last())), );
+    }
+
+    mergeTask = new LocalWorkflow::MergeVcfShardsTask(shardUrls, resultUrl);
+    addSubTask(mergeTask);
+}
+
+Task::ReportResult GTest_MergeVcfShards::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    foreach (const QString &url, shardUrls) {
+        CHECK_EXT(!QFile::exists(url), setError(QString("The region file is not removed: %1").arg(url)), ReportResult_Finished);
+    }
+
+    QFile result(resultUrl);
+    CHECK_EXT(result.open(QIODevice::ReadOnly), setError(L10N::errorOpeningFileRead(resultUrl)), ReportResult_Finished);
+    const QByteArray data = result.readAll();
+    result.close();
+    QFile::remove(resultUrl);
+    CHECK_EXT(expectedResult == data, setError(QString("Unexpected merged VCF, expected:\n%1\ngot:\n%2").arg(QString(expectedResult)).arg(QString(data))), ReportResult_Finished);
+    return ReportResult_Finished;
+}
+
+const QString GTest_CallVariantsSharding::SHARDS_COUNT_ATTR = "shards";
+const QString GTest_CallVariantsSharding::INDEX_ATTR = "index";
+
+void GTest_CallVariantsSharding::init(XMLTestFormat *, const QDomElement &el) {
+    shardingTask = NULL;
+    bool ok = false;
+    shardsCount = el.attribute(SHARDS_COUNT_ATTR).toInt(&ok);
+    CHECK_EXT(ok && shardsCount > 0, failMissingValue(SHARDS_COUNT_ATTR), );
+    index = "false" != el.attribute(INDEX_ATTR);
+}
+
+void GTest_CallVariantsSharding::prepare() {
+    dir = env->getVar("TEMP_DATA_DIR") + "/call_variants_sharding_" + QString::number(getTaskId());
+    const LocalWorkflow::CallVariantsTaskSettings settings = prepareSample(dir, index, stateInfo);
+    CHECK_OP(stateInfo, );
+
+    shardingTask = new LocalWorkflow::CallVariantsShardingTask(settings, shardsCount);
+    addSubTask(shardingTask);
+}
+
+Task::ReportResult GTest_CallVariantsSharding::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    const QList<QByteArray> &regions = shardingTask->getRegions();
+    if (!index) {
+        CHECK_EXT(regions.isEmpty(), setError(QString("Regions without the BAM index: %1").arg(regionsText(regions))), ReportResult_Finished);
+        return ReportResult_Finished;
+    }
+
+    bamFile bamHandle = bam_open((dir + "/" + SAMPLE_ASSEMBLY).toLocal8Bit().constData(), "r");
+    CHECK_EXT(NULL != bamHandle, setError(L10N::errorOpeningFileRead(dir + "/" + SAMPLE_ASSEMBLY)), ReportResult_Finished);
+    bam_header_t *header = bam_header_read(bamHandle);
+    bam_close(bamHandle);
+    CHECK_EXT(NULL != header, setError(QString("Can not read the BAM header")), ReportResult_Finished);
+    QList< QPair<QByteArray, qint64> > references;
+    for (int i = 0; i < header->n_targets; i++) {
+        references << qMakePair(QByteArray(header->target_name[i]), qint64(header->target_len[i]));
+    }
+    bam_header_destroy(header);
+
+    // every reference is either a single region or consecutive "name:start-end" regions from 1 to the reference length
+    int regionIdx = 0;
+    for (int i = 0; i < references.size(); i++) {
+        const QByteArray &name = references[i].first;
+        CHECK_EXT(regionIdx < regions.size(), setError(QString("No region for %1").arg(QString(name))), ReportResult_Finished);
+        if (regions[regionIdx] == name) {
+            regionIdx++;
+            continue;
+        }
+        qint64 nextStart = 1;
+        while (nextStart <= references[i].second) {
+            CHECK_EXT(regionIdx < regions.size(), setError(QString("%1 is not covered after %2").arg(QString(name)).arg(nextStart)), ReportResult_Finished);
+            const QByteArray &region = regions[regionIdx++];
+            CHECK_EXT(region.startsWith(name + ":"), setError(QString("Unexpected region: %1, expected a region of %2").arg(QString(region)).arg(QString(name))), ReportResult_Finished);
+            const QList<QByteArray> bounds = region.mid(name.size() + 1).split('-');
+            CHECK_EXT(2 == bounds.size(), setError(QString("Incorrect region: %1").arg(QString(region))), ReportResult_Finished);
+            CHECK_EXT(bounds[0].toLongLong() == nextStart, setError(QString("Region %1 must start at %2").arg(QString(region)).arg(nextStart)), ReportResult_Finished);
+            const qint64 end = bounds[1].toLongLong();
+            CHECK_EXT(end >= nextStart && end <= references[i].second, setError(QString("Incorrect region end: %1").arg(QString(region))), ReportResult_Finished);
+            nextStart = end + 1;
+        }
+    }
+    CHECK_EXT(regionIdx == regions.size(), setError(QString("Unexpected regions after the last reference: %1").arg(regions.size() - regionIdx)), ReportResult_Finished);
+    if (1 == shardsCount) {
+        CHECK_EXT(regions.size() == references.size(), setError(QString("A single shard must not split the references: %1").arg(regionsText(regions))), ReportResult_Finished);
+    }
+    return ReportResult_Finished;
+}
+
+void GTest_CallVariantsSharding::cleanup() {
+    removeTestDir(dir);
+    GTest::cleanup();
+}
+
+const QString GTest_CallVariantsByRegions::REGIONS_ATTR = "regions";
+
+void GTest_CallVariantsByRegions::init(XMLTestFormat *, const QDomElement &el) {
+    finishedRegionsCount = 0;
+    wholeTask = NULL;
+    mergeTask = NULL;
+    regions = el.attribute(REGIONS_ATTR).toLatin1().split(',');
+    regions.removeAll(QByteArray());
+    CHECK_EXT(regions.size() > 1, failMissingValue(REGIONS_ATTR), );
+}
+
+void GTest_CallVariantsByRegions::prepare() {
+    dir = env->getVar("TEMP_DATA_DIR") + "/call_variants_by_regions_" + QString::number(getTaskId());
+    LocalWorkflow::CallVariantsTaskSettings settings = prepareSample(dir, true, stateInfo);
+    CHECK_OP(stateInfo, );
+
+    wholeUrl = dir + "/whole.vcf";
+    mergedUrl = dir + "/merged.vcf";
+    settings.variationsUrl = wholeUrl;
+    wholeTask = new LocalWorkflow::SamtoolsMpileupTask(settings);
+    addSubTask(wholeTask);
+
+    for (int i = 0; i < regions.size(); i++) {
+        LocalWorkflow::CallVariantsTaskSettings regionSettings = settings;
+        regionSettings.reg = regions[i];
+        regionSettings.variationsUrl = dir + QString("/region_%1.vcf").arg(i);
+        regionUrls << regionSettings.variationsUrl;
+        regionTasks << new LocalWorkflow::SamtoolsMpileupTask(regionSettings);
+        addSubTask(regionTasks.last());
+    }
+}
+
+QList<Task*> GTest_CallVariantsByRegions::onSubTaskFinished(Task *subTask) {
+    QList<Task*> res;
+    CHECK(!hasError() && !isCanceled(), res);
+    if (regionTasks.contains(subTask)) {
+        finishedRegionsCount++;
+        if (finishedRegionsCount == regionTasks.size()) {
+            mergeTask = new LocalWorkflow::MergeVcfShardsTask(regionUrls, mergedUrl);
+            res << mergeTask;
+        }
+    }
+    return res;
+}
+
+Task::ReportResult GTest_CallVariantsByRegions::report() {
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    CHECK_EXT(NULL != mergeTask, setError("The region variants are not merged"), ReportResult_Finished);
+
+    const QList<QByteArray> expected = readVcfRecords(wholeUrl, stateInfo);
+    CHECK_OP(stateInfo, ReportResult_Finished);
+    const QList<QByteArray> actual = readVcfRecords(mergedUrl, stateInfo);
+    CHECK_OP(stateInfo, ReportResult_Finished);
+
+    CHECK_EXT(!expected.isEmpty(), setError("No variants are called for the whole reference"), ReportResult_Finished);
+    CHECK_EXT(expected.size() == actual.size(), setError(QString("Unexpected variants count: expected %1, got %2").arg(expected.size()).arg(actual.size())), ReportResult_Finished);
+    for (int i = 0; i < expected.size(); i++) {
+        CHECK_EXT(expected[i] == actual[i], setError(QString("Unexpected variant, expected:\n%1got:\n%2").arg(QString(expected[i])).arg(QString(actual[i]))), ReportResult_Finished);
+    }
+    return ReportResult_Finished;
+}
+
+void GTest_CallVariantsByRegions::cleanup() {
+    removeTestDir(dir);
+    GTest::cleanup();
+}
+
+QList<XMLTestFactory*> VariantsTests::createTestFactories() {
+    QList<XMLTestFactory*> res;
+    res.append(GTest_MergeVcfShards::createFactory());
+    res.append(GTest_CallVariantsSharding::createFactory());
+    res.append(GTest_CallVariantsByRegions::createFactory());
+    return res;
+}
+
+} // U2
@@ -0,0 +1,119 @@
+/**
+ * UGENE - Integrated Bioinformatics Tools.
+ * Copyright (C) 2008-2016 UniPro <ugene@unipro.ru>
+ * http://ugene.unipro.ru
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#ifndef _U2_ASSEMBLY_SAMTOOLS_MPILEUP_TESTS_H_
+#define _U2_ASSEMBLY_SAMTOOLS_MPILEUP_TESTS_H_
+
+#include <QtXml/QDomElement>
+
+#include <U2Test/XMLTestUtils.h>
+
+namespace U2 {
+
+namespace LocalWorkflow {
+class CallVariantsShardingTask;
+class MergeVcfShardsTask;
+class SamtoolsMpileupTask;
+}
+
+/**
+ * Writes the VCF files of several regions and merges them.
+ * The result must have one header and the variants of the regions in the order of the regions,
+ * the region files must be removed.
+ */
+class GTest_MergeVcfShards : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_MergeVcfShards, "merge-vcf-shards");
+
+    void prepare();
+    ReportResult report();
+
+    static const QString SHARDS_COUNT_ATTR;
+
+private:
+    int shardsCount;
+    QStringList shardUrls;
+    QString resultUrl;
+    QByteArray expectedResult;
+    LocalWorkflow::MergeVcfShardsTask *mergeTask;
+};
+
+/**
+ * Splits the reference of the chrM sample assembly into regions.
+ * The regions must cover every reference sequence in the order without gaps and overlaps.
+ * The result must be empty if the assembly has no BAM index.
+ */
+class GTest_CallVariantsSharding : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_CallVariantsSharding, "call-variants-sharding");
+
+    void prepare();
+    ReportResult report();
+    void cleanup();
+
+    static const QString SHARDS_COUNT_ATTR;
+    static const QString INDEX_ATTR;
+
+private:
+    int shardsCount;
+    bool index;
+    QString dir;
+    LocalWorkflow::CallVariantsShardingTask *shardingTask;
+};
+
+/**
+ * Calls the variants of the chrM sample assembly by the given regions and for the whole reference.
+ * The merged variants of the regions must be the same as the variants of the whole reference.
+ */
+class GTest_CallVariantsByRegions : public GTest {
+    Q_OBJECT
+public:
+    SIMPLE_XML_TEST_BODY_WITH_FACTORY(GTest_CallVariantsByRegions, "call-variants-by-regions");
+
+    void prepare();
+    QList<Task*> onSubTaskFinished(Task *subTask);
+    ReportResult report();
+    void cleanup();
+
+    static const QString REGIONS_ATTR;
+
+private:
+    QList<QByteArray> regions;
+    QString dir;
+    QString wholeUrl;
+    QString mergedUrl;
+    QStringList regionUrls;
+    int finishedRegionsCount;
+    LocalWorkflow::SamtoolsMpileupTask *wholeTask;
+    QList<Task*> regionTasks;
+    LocalWorkflow::MergeVcfShardsTask *mergeTask;
+};
+
+class VariantsTests {
+public:
+    static QList<XMLTestFactory*> createTestFactories();
+};
+
+} // U2
+
+#endif // _U2_ASSEMBLY_SAMTOOLS_MPILEUP_TESTS_H_
@@ -19,10 +19,16 @@
  * MA 02110-1301, USA.
  */
 
+#include "AssemblySamtoolsMpileupTests.h"
 #include "SamtoolsPlugin.h"
 #include "SamtoolMpileupWorker.h"
 
 #include <U2Core/AppContext.h>
+#include <U2Core/GAutoDeleteList.h>
+#include <U2Core/U2SafePoints.h>
+
+#include <U2Test/GTestFrameworkComponents.h>
+#include <U2Test/XMLTestFormat.h>
 
 namespace U2 {
 
@@ -35,6 +41,18 @@ extern "C" Q_DECL_EXPORT Plugin* U2_PLUGIN_INIT_FUNC() {
 SamtoolsPlugin::SamtoolsPlugin()
 : Plugin(tr("Samtools plugin"), tr("Samtools plugin for NGS data analysis")){
     LocalWorkflow::CallVariantsWorkerFactory::init();
+
+    GTestFormatRegistry* tfr = AppContext::getTestFramework()->getTestFormatRegistry();
+    XMLTestFormat *xmlTestFormat = qobject_cast<XMLTestFormat*>(tfr->findFormat("XML"));
+    SAFE_POINT(NULL != xmlTestFormat, "XML test format is not found", );
+
+    GAutoDeleteList<XMLTestFactory>* l = new GAutoDeleteList<XMLTestFactory>(this);
+    l->qlist = VariantsTests::createTestFactories();
+    foreach (XMLTestFactory* f, l->qlist) {
+        bool res = xmlTestFormat->registerTestFactory(f);
+        Q_UNUSED(res);
+        assert(res);
+    }
 }
 
 }//namespace
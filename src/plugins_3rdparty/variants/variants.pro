@@ -3,10 +3,12 @@ include(variants.pri)
 # Input
 HEADERS += src/SamtoolMpileupWorker.h \
 		   src/AssemblySamtoolsMpileup.h \
+		   src/AssemblySamtoolsMpileupTests.h \
 		   src/SamtoolsPlugin.h 
            
 SOURCES += src/SamtoolMpileupWorker.cpp \
 		   src/AssemblySamtoolsMpileup.cpp \
+		   src/AssemblySamtoolsMpileupTests.cpp \
 		   src/SamtoolsPlugin.cpp 
 
 TRANSLATIONS += transl/english.ts transl/russian.ts
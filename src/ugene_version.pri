@@ -4,7 +4,7 @@
 UGENE_VERSION=1.23.0-dev
 
 # minimum UGENE version whose SQLite databases are compatible with this version
-UGENE_MIN_VERSION_SQLITE=1.13.0
+UGENE_MIN_VERSION_SQLITE=1.23.0
 
 # minimum UGENE version whose MySQL databases are compatible with this version
 UGENE_MIN_VERSION_MYSQL=1.16.0
@@ -47,6 +47,7 @@
 #include <U2Core/CMDLineCoreOptions.h>
 #include <U2Core/CMDLineRegistry.h>
 #include <U2Core/CMDLineUtils.h>
+#include <U2Core/CountersExporter.h>
 #include <U2Core/ConsoleShutdownTask.h>
 #include <U2Core/Counter.h>
 #include <U2Core/DBXRefRegistry.h>
@@ -79,6 +80,8 @@
 #include <U2Lang/WorkflowRunTask.h>
 
 #include <U2Remote/DistributedComputingUtil.h>
+#include <U2Remote/LocalTaskDistribution.h>
+#include <U2Remote/WorkflowDaemonClient.h>
 
 #include <U2Test/GTestFrameworkComponents.h>
 #include <U2Test/TestRunnerTask.h>
@@ -232,6 +235,22 @@ int main(int argc, char **argv)
     CMDLineRegistry* cmdLineRegistry = new CMDLineRegistry(app.arguments());
     appContext->setCMDLineRegistry(cmdLineRegistry);
 
+    // the workflow is run by the UGENE server, nothing has to be initialized here
+    if (cmdLineRegistry->hasParameter(CMDLineCoreOptions::DAEMON_SUBMIT)) {
+        QString serverName = cmdLineRegistry->getParameterValue(CMDLineCoreOptions::DAEMON_SUBMIT);
+        QStringList workflowArgs;
+        foreach (const QString& arg, app.arguments()) {
+            if (!arg.startsWith("--" + CMDLineCoreOptions::DAEMON_SUBMIT)) {
+                workflowArgs << arg;
+            }
+        }
+        int rc = WorkflowDaemonClient::submit(serverName, workflowArgs, QDir::currentPath());
+        appContext->setCMDLineRegistry(NULL);
+        delete cmdLineRegistry;
+        CrashHandler::shutdown();
+        return rc;
+    }
+
     //1 create settings
     SettingsImpl* globalSettings = new SettingsImpl(QSettings::SystemScope);
     appContext->setGlobalSettings(globalSettings);
@@ -469,11 +488,28 @@ int main(int argc, char **argv)
         QObject::connect(psp, SIGNAL(si_allStartUpPluginsLoaded()), new TaskStarter(new TmpDirChecker()), SLOT(registerTask()));
     }
 
+    // the process is started by LocalTaskDistributionTask to run parts of a task
+    if (cmdLineRegistry->hasParameter(LocalTaskWorkerTask::SERVER_CMDLINE_OPTION)) {
+        QString serverName = cmdLineRegistry->getParameterValue(LocalTaskWorkerTask::SERVER_CMDLINE_OPTION);
+        QObject::connect(psp, SIGNAL(si_allStartUpPluginsLoaded()), new TaskStarter(new LocalTaskWorkerTask(serverName)), SLOT(registerTask()));
+    }
+
     openDocs();
     registerCoreServices();
 
     GReportableCounter launchCounter("ugenecl launch", "", 1);
-    ++launchCounter.totalCount;
+    launchCounter.add();
+
+    CountersExporter *countersExporter = NULL;
+    if (cmdLineRegistry->hasParameter(CMDLineCoreOptions::METRICS_FILE)) {
+        const QString metricsUrl = cmdLineRegistry->getParameterValue(CMDLineCoreOptions::METRICS_FILE);
+        bool intervalOk = false;
+        int metricsInterval = cmdLineRegistry->getParameterValue(CMDLineCoreOptions::METRICS_INTERVAL).toInt(&intervalOk);
+        if (!intervalOk || metricsInterval <= 0) {
+            metricsInterval = CountersExporter::DEFAULT_INTERVAL_SECONDS;
+        }
+        countersExporter = new CountersExporter(metricsUrl, metricsInterval);
+    }
 
     //3 run QT
     t1.stop();
@@ -483,6 +519,12 @@ int main(int argc, char **argv)
     int rc = app.exec();
 
     //4 deallocate resources
+    if (NULL != countersExporter) {
+        U2OpStatus2Log os;
+        countersExporter->dump(os);
+        delete countersExporter;
+    }
+
     Workflow::WorkflowEnv::shutdown();
 
     delete tsbc;
@@ -724,7 +724,7 @@ int main(int argc, char **argv)
 #endif //HI_EXCLUDED
 
     GReportableCounter launchCounter("ugeneui launch", "", 1);
-    ++launchCounter.totalCount;
+    launchCounter.add();
 
     //3 run QT GUI
     t1.stop();